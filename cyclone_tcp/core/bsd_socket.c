@@ -49,6 +49,13 @@ const struct in6_addr in6addr_any =
 const struct in6_addr in6addr_loopback =
    {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01}};
 
+#if (SOCKET_EPOLL_SUPPORT == ENABLED)
+
+//Epoll instances
+BsdEpoll bsdEpollTable[BSD_SOCKET_MAX_EPOLL_COUNT];
+
+#endif
+
 
 /**
  * @brief Create a socket that is bound to a specific transport service provider
@@ -661,7 +668,6 @@ int_t sendmsg(int_t s, struct msghdr *msg, int_t flags)
    uint_t socketFlags;
    Socket *sock;
    SocketMsg message;
-   SOCKADDR *addr;
 
    //Make sure the socket descriptor is valid
    if(s < 0 || s >= SOCKET_MAX_COUNT)
@@ -684,188 +690,85 @@ int_t sendmsg(int_t s, struct msghdr *msg, int_t flags)
    message.data = msg->msg_iov[0].iov_base;
    message.length = msg->msg_iov[0].iov_len;
 
-   //Check the length of the address
-   if(msg->msg_namelen < (socklen_t) sizeof(SOCKADDR))
+   //Retrieve the destination address and the ancillary data
+   error = socketParseMsgHdr(msg, &message);
+   //Any error to report?
+   if(error)
    {
-      //Report an error
       socketSetErrnoCode(sock, EINVAL);
       return SOCKET_ERROR;
    }
 
-   //Point to the destination address
-   addr = (SOCKADDR *) msg->msg_name;
+   //The flags parameter can be used to influence the behavior of the function
+   socketFlags = 0;
 
-#if (IPV4_SUPPORT == ENABLED)
-   //IPv4 address?
-   if(addr->sa_family == AF_INET &&
-      msg->msg_namelen >= (socklen_t) sizeof(SOCKADDR_IN))
+   //The MSG_DONTROUTE flag specifies that the data should not be subject
+   //to routing
+   if((flags & MSG_DONTROUTE) != 0)
    {
-      //Point to the IPv4 address information
-      SOCKADDR_IN *sa = (SOCKADDR_IN *) addr;
-
-      //Get port number
-      message.destPort = ntohs(sa->sin_port);
-
-      //Copy IPv4 address
-      message.destIpAddr.length = sizeof(Ipv4Addr);
-      message.destIpAddr.ipv4Addr = sa->sin_addr.s_addr;
+      socketFlags |= SOCKET_FLAG_DONT_ROUTE;
    }
-   else
-#endif
-#if (IPV6_SUPPORT == ENABLED)
-   //IPv6 address?
-   if(addr->sa_family == AF_INET6 &&
-      msg->msg_namelen >= (socklen_t) sizeof(SOCKADDR_IN6))
+
+   //The TCP_NODELAY option disables the Nagle algorithm for TCP sockets
+   if((sock->options & SOCKET_OPTION_TCP_NO_DELAY) != 0)
    {
-      //Point to the IPv6 address information
-      SOCKADDR_IN6 *sa = (SOCKADDR_IN6 *) addr;
+      socketFlags |= SOCKET_FLAG_NO_DELAY;
+   }
 
-      //Get port number
-      message.destPort = ntohs(sa->sin6_port);
+   //Send message
+   error = socketSendMsg(sock, &message, socketFlags);
 
-      //Copy IPv6 address
-      message.destIpAddr.length = sizeof(Ipv6Addr);
-      ipv6CopyAddr(&message.destIpAddr.ipv6Addr, sa->sin6_addr.s6_addr);
-   }
-   else
-#endif
-   //Invalid address?
+   //Any error to report?
+   if(error != NO_ERROR)
    {
-      //Report an error
-      socketSetErrnoCode(sock, EINVAL);
+      //Otherwise, a value of SOCKET_ERROR is returned
+      socketTranslateErrorCode(sock, error);
       return SOCKET_ERROR;
    }
 
-   //The ancillary data buffer parameter is optional
-   if(msg->msg_control != NULL)
-   {
-      uint_t n;
-      int_t *val;
-      CMSGHDR *cmsg;
+   //Return the number of bytes transferred so far
+   return message.length;
+}
 
-      //Point to the first control message
-      n = 0;
 
-      //Loop through control messages
-      while((n + sizeof(CMSGHDR)) <= msg->msg_controllen)
-      {
-         //Point to the ancillary data header
-         cmsg = (CMSGHDR *) ((uint8_t *) msg->msg_control + n);
+#if (SOCKET_MSG_BATCH_SUPPORT == ENABLED)
 
-         //Check the length of the control message
-         if(cmsg->cmsg_len >= sizeof(CMSGHDR) &&
-            cmsg->cmsg_len <= (msg->msg_controllen - n))
-         {
-#if (IPV4_SUPPORT == ENABLED)
-            //IPv4 protocol?
-            if(addr->sa_family == AF_INET && cmsg->cmsg_level == IPPROTO_IP)
-            {
-               //Check control message type
-               if(cmsg->cmsg_type == IP_PKTINFO &&
-                  cmsg->cmsg_len >= CMSG_LEN(sizeof(IN_PKTINFO)))
-               {
-                  //Point to the ancillary data value
-                  IN_PKTINFO *pktInfo = (IN_PKTINFO *) CMSG_DATA(cmsg);
-
-                  //Specify source IPv4 address
-                  message.srcIpAddr.length = sizeof(Ipv4Addr);
-                  message.srcIpAddr.ipv4Addr = pktInfo->ipi_addr.s_addr;
-               }
-               else if(cmsg->cmsg_type == IP_TOS &&
-                  cmsg->cmsg_len >= CMSG_LEN(sizeof(int_t)))
-               {
-                  //Point to the ancillary data value
-                  val = (int_t *) CMSG_DATA(cmsg);
-                  //Specify ToS value
-                  message.tos = (uint8_t) *val;
-               }
-               else if(cmsg->cmsg_type == IP_TTL &&
-                  cmsg->cmsg_len >= CMSG_LEN(sizeof(int_t)))
-               {
-                  //Point to the ancillary data value
-                  val = (int_t *) CMSG_DATA(cmsg);
-                  //Specify TTL value
-                  message.ttl = (uint8_t) *val;
-               }
-               else if(cmsg->cmsg_type == IP_DONTFRAG &&
-                  cmsg->cmsg_len >= CMSG_LEN(sizeof(int_t)))
-               {
-                  //Point to the ancillary data value
-                  val = (int_t *) CMSG_DATA(cmsg);
-
-                  //This option can be used to set the "don't fragment" flag
-                  //on IP packets
-                  message.dontFrag = (*val != 0) ? TRUE : FALSE;
-               }
-               else
-               {
-                  //Unknown control message type
-               }
-            }
-            else
-#endif
-#if (IPV6_SUPPORT == ENABLED)
-            //IPv6 protocol?
-            if(addr->sa_family == AF_INET6 && cmsg->cmsg_level == IPPROTO_IPV6)
-            {
-               //Check control message type
-               if(cmsg->cmsg_type == IPV6_PKTINFO &&
-                  cmsg->cmsg_len >= CMSG_LEN(sizeof(IN_PKTINFO)))
-               {
-                  //Point to the ancillary data value
-                  IN6_PKTINFO *pktInfo = (IN6_PKTINFO *) CMSG_DATA(cmsg);
-
-                  //Specify source IPv6 address
-                  message.srcIpAddr.length = sizeof(Ipv6Addr);
-                  ipv6CopyAddr(&message.srcIpAddr.ipv6Addr, pktInfo->ipi6_addr.s6_addr);
-               }
-               else if(cmsg->cmsg_type == IPV6_TCLASS &&
-                  cmsg->cmsg_len >= CMSG_LEN(sizeof(int_t)))
-               {
-                  //Point to the ancillary data value
-                  val = (int_t *) CMSG_DATA(cmsg);
-                  //Specify Traffic Class value
-                  message.tos = (uint8_t) *val;
-               }
-               else if(cmsg->cmsg_type == IPV6_HOPLIMIT &&
-                  cmsg->cmsg_len >= CMSG_LEN(sizeof(int_t)))
-               {
-                  //Point to the ancillary data value
-                  val = (int_t *) CMSG_DATA(cmsg);
-                  //Specify Hop Limit value
-                  message.ttl = (uint8_t) *val;
-               }
-               else if(cmsg->cmsg_type == IPV6_DONTFRAG &&
-                  cmsg->cmsg_len >= CMSG_LEN(sizeof(int_t)))
-               {
-                  //Point to the ancillary data value
-                  val = (int_t *) CMSG_DATA(cmsg);
-
-                  //This option be used to turn off the automatic inserting
-                  //of a fragment header for UDP and raw sockets
-                  message.dontFrag = (*val != 0) ? TRUE : FALSE;
-               }
-               else
-               {
-                  //Unknown control message type
-               }
-            }
-            //Unknown protocol?
-            else
-#endif
-            {
-               //Discard control message
-            }
+/**
+ * @brief Send multiple messages
+ * @param[in] s Descriptor that identifies a socket
+ * @param[in,out] msgvec Array of structures describing the messages
+ * @param[in] vlen Number of entries in the array
+ * @param[in] flags Set of flags that influences the behavior of this function
+ * @return If no error occurs, sendmmsg returns the number of messages sent.
+ *   Otherwise, a value of SOCKET_ERROR is returned
+ **/
 
-            //Next control message
-            n += cmsg->cmsg_len;
-         }
-         else
-         {
-            //Malformed control message
-            break;
-         }
-      }
+int_t sendmmsg(int_t s, struct mmsghdr *msgvec, uint_t vlen, int_t flags)
+{
+   error_t error;
+   uint_t i;
+   uint_t n;
+   uint_t sent;
+   uint_t total;
+   uint_t socketFlags;
+   Socket *sock;
+   struct msghdr *msg;
+   SocketMsg messages[BSD_SOCKET_MMSG_BATCH_SIZE];
+
+   //Make sure the socket descriptor is valid
+   if(s < 0 || s >= SOCKET_MAX_COUNT)
+   {
+      return SOCKET_ERROR;
+   }
+
+   //Point to the socket structure
+   sock = &socketTable[s];
+
+   //Check parameters
+   if(msgvec == NULL)
+   {
+      socketSetErrnoCode(sock, EINVAL);
+      return SOCKET_ERROR;
    }
 
    //The flags parameter can be used to influence the behavior of the function
@@ -878,27 +781,69 @@ int_t sendmsg(int_t s, struct msghdr *msg, int_t flags)
       socketFlags |= SOCKET_FLAG_DONT_ROUTE;
    }
 
-   //The TCP_NODELAY option disables the Nagle algorithm for TCP sockets
-   if((sock->options & SOCKET_OPTION_TCP_NO_DELAY) != 0)
+   //Initialize status code
+   error = NO_ERROR;
+   //Number of messages sent so far
+   total = 0;
+
+   //Process the messages batch by batch
+   while(total < vlen && !error)
    {
-      socketFlags |= SOCKET_FLAG_NO_DELAY;
-   }
+      //Format as many messages as possible
+      for(n = 0; n < BSD_SOCKET_MMSG_BATCH_SIZE && (total + n) < vlen; n++)
+      {
+         //Point to the current message header
+         msg = &msgvec[total + n].msg_hdr;
 
-   //Send message
-   error = socketSendMsg(sock, &message, socketFlags);
+         //Check parameters
+         if(msg->msg_iov == NULL || msg->msg_iovlen != 1)
+         {
+            error = ERROR_INVALID_PARAMETER;
+            break;
+         }
 
-   //Any error to report?
-   if(error != NO_ERROR)
+         //Point to the message to be transmitted
+         messages[n] = SOCKET_DEFAULT_MSG;
+         messages[n].data = msg->msg_iov[0].iov_base;
+         messages[n].length = msg->msg_iov[0].iov_len;
+
+         //Retrieve the destination address and the ancillary data
+         error = socketParseMsgHdr(msg, &messages[n]);
+         //Any error to report?
+         if(error)
+            break;
+      }
+
+      //Any message to send?
+      if(n > 0)
+      {
+         //Send the messages under a single lock
+         error = socketSendMsgBatch(sock, messages, n, &sent, socketFlags);
+
+         //Save the number of bytes transferred for each message
+         for(i = 0; i < sent; i++)
+         {
+            msgvec[total + i].msg_len = messages[i].length;
+         }
+
+         //Number of messages sent so far
+         total += sent;
+      }
+   }
+
+   //No message could be sent?
+   if(total == 0 && error)
    {
-      //Otherwise, a value of SOCKET_ERROR is returned
       socketTranslateErrorCode(sock, error);
       return SOCKET_ERROR;
    }
 
-   //Return the number of bytes transferred so far
-   return message.length;
+   //Return the number of messages sent
+   return total;
 }
 
+#endif
+
 
 /**
  * @brief Receive data from a connected socket
@@ -1116,6 +1061,13 @@ int_t recvmsg(int_t s, struct msghdr *msg, int_t flags)
    uint_t socketFlags;
    Socket *sock;
    SocketMsg message;
+#if (SOCKET_ZERO_COPY_RX_SUPPORT == ENABLED)
+   uint_t i;
+   int_t k;
+   size_t offset;
+   CMSGHDR *cmsg;
+   NetBuffer *buffer;
+#endif
 
    //Make sure the socket descriptor is valid
    if(s < 0 || s >= SOCKET_MAX_COUNT)
@@ -1126,11 +1078,31 @@ int_t recvmsg(int_t s, struct msghdr *msg, int_t flags)
    //Point to the socket structure
    sock = &socketTable[s];
 
-   //Check parameters
-   if(msg == NULL || msg->msg_iov == NULL || msg->msg_iovlen != 1)
+#if (SOCKET_ZERO_COPY_RX_SUPPORT == ENABLED)
+   //The MSG_ZEROCOPY flag causes the payload to be loaned to the application
+   //rather than copied
+   if((flags & MSG_ZEROCOPY) != 0)
+   {
+      //The scatter/gather array receives the location of the data, while the
+      //first control message carries the handle of the loaned buffer
+      if(msg == NULL || msg->msg_iov == NULL || msg->msg_iovlen < 1 ||
+         msg->msg_control == NULL ||
+         msg->msg_controllen < CMSG_SPACE(sizeof(NetBuffer *)) ||
+         (flags & MSG_PEEK) != 0)
+      {
+         socketSetErrnoCode(sock, EINVAL);
+         return SOCKET_ERROR;
+      }
+   }
+   else
+#endif
    {
-      socketSetErrnoCode(sock, EINVAL);
-      return SOCKET_ERROR;
+      //Check parameters
+      if(msg == NULL || msg->msg_iov == NULL || msg->msg_iovlen != 1)
+      {
+         socketSetErrnoCode(sock, EINVAL);
+         return SOCKET_ERROR;
+      }
    }
 
    //Point to the receive buffer
@@ -1161,8 +1133,20 @@ int_t recvmsg(int_t s, struct msghdr *msg, int_t flags)
       socketFlags |= SOCKET_FLAG_DONT_WAIT;
    }
 
-   //Receive message
-   error = socketReceiveMsg(sock, &message, socketFlags);
+#if (SOCKET_ZERO_COPY_RX_SUPPORT == ENABLED)
+   //Zero-copy operation?
+   if((flags & MSG_ZEROCOPY) != 0)
+   {
+      //Take ownership of the buffer that holds the message
+      error = socketReceiveBuffer(sock, &message, &buffer, &offset,
+         socketFlags);
+   }
+   else
+#endif
+   {
+      //Receive message
+      error = socketReceiveMsg(sock, &message, socketFlags);
+   }
 
    //Any error to report?
    if(error)
@@ -1171,295 +1155,225 @@ int_t recvmsg(int_t s, struct msghdr *msg, int_t flags)
       return SOCKET_ERROR;
    }
 
-   //The source address parameter is optional
-   if(msg->msg_name != NULL)
-   {
-#if (IPV4_SUPPORT == ENABLED)
-      //IPv4 address?
-      if(message.srcIpAddr.length == sizeof(Ipv4Addr) &&
-         msg->msg_namelen >= (socklen_t) sizeof(SOCKADDR_IN))
-      {
-         //Point to the IPv4 address information
-         SOCKADDR_IN *sa = (SOCKADDR_IN *) msg->msg_name;
-
-         //Set address family and port number
-         sa->sin_family = AF_INET;
-         sa->sin_port = htons(message.srcPort);
-
-         //Copy IPv4 address
-         sa->sin_addr.s_addr = message.srcIpAddr.ipv4Addr;
+   //Length of the ancillary data buffer
+   n = 0;
 
-         //Return the actual length of the address
-         msg->msg_namelen = sizeof(SOCKADDR_IN);
-      }
-      else
+#if (SOCKET_ZERO_COPY_RX_SUPPORT == ENABLED)
+   //The first control message is reserved for the handle of the buffer
+   if((flags & MSG_ZEROCOPY) != 0)
+   {
+      n = CMSG_SPACE(sizeof(NetBuffer *));
+   }
 #endif
-#if (IPV6_SUPPORT == ENABLED)
-      //IPv6 address?
-      if(message.srcIpAddr.length == sizeof(Ipv6Addr) &&
-         msg->msg_namelen >= (socklen_t) sizeof(SOCKADDR_IN6))
-      {
-         //Point to the IPv6 address information
-         SOCKADDR_IN6 *sa = (SOCKADDR_IN6 *) msg->msg_name;
 
-         //Set address family and port number
-         sa->sin6_family = AF_INET6;
-         sa->sin6_port = htons(message.srcPort);
-         sa->sin6_flowinfo = 0;
-         sa->sin6_scope_id = 0;
+   //Report the source address and the ancillary data
+   error = socketFormatMsgHdr(sock, &message, msg, n);
 
-         //Copy IPv6 address
-         ipv6CopyAddr(sa->sin6_addr.s6_addr, &message.srcIpAddr.ipv6Addr);
-
-         //Return the actual length of the address
-         msg->msg_namelen = sizeof(SOCKADDR_IN6);
-      }
-      else
-#endif
-      //Invalid address?
+   //Any error to report?
+   if(error)
+   {
+#if (SOCKET_ZERO_COPY_RX_SUPPORT == ENABLED)
+      //Zero-copy operation?
+      if((flags & MSG_ZEROCOPY) != 0)
       {
-         //Report an error
-         socketSetErrnoCode(sock, EINVAL);
-         return SOCKET_ERROR;
+         //The buffer cannot be handed over to the application
+         socketReleaseBuffer(buffer);
       }
+#endif
+      //Report an error
+      socketSetErrnoCode(sock, EINVAL);
+      return SOCKET_ERROR;
    }
-   else
+
+#if (SOCKET_ZERO_COPY_RX_SUPPORT == ENABLED)
+   //Zero-copy operation?
+   if((flags & MSG_ZEROCOPY) != 0)
    {
-      msg->msg_namelen = 0;
-   }
+      //Point to the ancillary data header
+      cmsg = (CMSGHDR *) msg->msg_control;
 
-   //Clear flags
-   msg->msg_flags = 0;
+      //Format ancillary data header
+      cmsg->cmsg_len = CMSG_LEN(sizeof(NetBuffer *));
+      cmsg->cmsg_level = SOL_SOCKET;
+      cmsg->cmsg_type = SCM_NET_BUFFER;
 
-   //Length of the ancillary data buffer
-   n = 0;
+      //The application must return the buffer by calling socketReleaseBuffer
+      osMemcpy(CMSG_DATA(cmsg), &buffer, sizeof(NetBuffer *));
 
-   //The ancillary data buffer parameter is optional
-   if(msg->msg_control != NULL)
-   {
-#if (IPV4_SUPPORT == ENABLED)
-      //IPv4 address?
-      if(message.destIpAddr.length == sizeof(Ipv4Addr))
+      //Loop through data chunks
+      for(i = 0, k = 0; i < buffer->chunkCount; i++)
       {
-         int_t *val;
-         CMSGHDR *cmsg;
-         IN_PKTINFO *pktInfo;
+         //Skip the descriptor that precedes the payload
+         if(offset >= buffer->chunk[i].length)
+         {
+            offset -= buffer->chunk[i].length;
+            continue;
+         }
 
-         //The IP_PKTINFO option allows an application to enable or disable
-         //the return of IPv4 packet information
-         if((sock->options & SOCKET_OPTION_IPV4_PKT_INFO) != 0)
+         //The scatter/gather array is too short to describe the whole
+         //payload?
+         if(k >= msg->msg_iovlen)
          {
-            //Make sure there is enough room to add the control message
-            if((n + CMSG_SPACE(sizeof(IN_PKTINFO))) <= msg->msg_controllen)
-            {
-               //Point to the ancillary data header
-               cmsg = (CMSGHDR *) ((uint8_t *) msg->msg_control + n);
+            //The remaining data can still be accessed through the buffer
+            msg->msg_flags |= MSG_TRUNC;
+            break;
+         }
 
-               //Format ancillary data header
-               cmsg->cmsg_len = CMSG_LEN(sizeof(IN_PKTINFO));
-               cmsg->cmsg_level = IPPROTO_IP;
-               cmsg->cmsg_type = IP_PKTINFO;
+         //Point to the data residing in the current chunk
+         msg->msg_iov[k].iov_base = (uint8_t *) buffer->chunk[i].address +
+            offset;
+         msg->msg_iov[k].iov_len = buffer->chunk[i].length - offset;
 
-               //Point to the ancillary data value
-               pktInfo = (IN_PKTINFO *) CMSG_DATA(cmsg);
+         //Process the next chunk from the start
+         offset = 0;
+         k++;
+      }
 
-               //Format packet information
-               pktInfo->ipi_ifindex = message.interface->index;
-               pktInfo->ipi_addr.s_addr = message.destIpAddr.ipv4Addr;
+      //Number of entries actually used
+      msg->msg_iovlen = k;
+   }
+#endif
 
-               //Adjust the actual length of the ancillary data buffer
-               n += CMSG_SPACE(sizeof(IN_PKTINFO));
-            }
-            else
-            {
-               //When the control message buffer is too short to store all
-               //messages, the MSG_CTRUNC flag must be set
-               msg->msg_flags |= MSG_CTRUNC;
-            }
-         }
+   //Return the number of bytes received
+   return message.length;
+}
 
-         //The IP_RECVTOS option allows an application to enable or disable
-         //the return of ToS header field on received datagrams
-         if((sock->options & SOCKET_OPTION_IPV4_RECV_TOS) != 0)
-         {
-            //Make sure there is enough room to add the control message
-            if((n + CMSG_SPACE(sizeof(int_t))) <= msg->msg_controllen)
-            {
-               //Point to the ancillary data header
-               cmsg = (CMSGHDR *) ((uint8_t *) msg->msg_control + n);
 
-               //Format ancillary data header
-               cmsg->cmsg_len = CMSG_LEN(sizeof(int_t));
-               cmsg->cmsg_level = IPPROTO_IP;
-               cmsg->cmsg_type = IP_TOS;
+#if (SOCKET_MSG_BATCH_SUPPORT == ENABLED)
 
-               //Point to the ancillary data value
-               val = (int_t *) CMSG_DATA(cmsg);
-               //Set ancillary data value
-               *val = message.tos;
+/**
+ * @brief Receive multiple messages
+ *
+ * The function blocks until at least one message is available, then returns
+ * the messages that are already queued
+ *
+ * @param[in] s Descriptor that identifies a socket
+ * @param[in,out] msgvec Array of structures describing the messages
+ * @param[in] vlen Number of entries in the array
+ * @param[in] flags Set of flags that influences the behavior of this function
+ * @param[in] timeout Not supported, must be NULL
+ * @return If no error occurs, recvmmsg returns the number of messages
+ *   received. Otherwise, a value of SOCKET_ERROR is returned
+ **/
 
-               //Adjust the actual length of the ancillary data buffer
-               n += CMSG_SPACE(sizeof(int_t));
-            }
-            else
-            {
-               //When the control message buffer is too short to store all
-               //messages, the MSG_CTRUNC flag must be set
-               msg->msg_flags |= MSG_CTRUNC;
-            }
-         }
+int_t recvmmsg(int_t s, struct mmsghdr *msgvec, uint_t vlen, int_t flags,
+   struct timeval *timeout)
+{
+   error_t error;
+   uint_t i;
+   uint_t n;
+   uint_t received;
+   uint_t total;
+   uint_t socketFlags;
+   Socket *sock;
+   struct msghdr *msg;
+   SocketMsg messages[BSD_SOCKET_MMSG_BATCH_SIZE];
 
-         //The IP_RECVTTL option allows an application to enable or disable
-         //the return of TTL header field on received datagrams
-         if((sock->options & SOCKET_OPTION_IPV4_RECV_TTL) != 0)
-         {
-            //Make sure there is enough room to add the control message
-            if((n + CMSG_SPACE(sizeof(int_t))) <= msg->msg_controllen)
-            {
-               //Point to the ancillary data header
-               cmsg = (CMSGHDR *) ((uint8_t *) msg->msg_control + n);
+   //Make sure the socket descriptor is valid
+   if(s < 0 || s >= SOCKET_MAX_COUNT)
+   {
+      return SOCKET_ERROR;
+   }
 
-               //Format ancillary data header
-               cmsg->cmsg_len = CMSG_LEN(sizeof(int_t));
-               cmsg->cmsg_level = IPPROTO_IP;
-               cmsg->cmsg_type = IP_TTL;
+   //Point to the socket structure
+   sock = &socketTable[s];
 
-               //Point to the ancillary data value
-               val = (int_t *) CMSG_DATA(cmsg);
-               //Set ancillary data value
-               *val = message.ttl;
+   //Check parameters
+   if(msgvec == NULL || vlen == 0 || timeout != NULL ||
+      (flags & MSG_PEEK) != 0)
+   {
+      socketSetErrnoCode(sock, EINVAL);
+      return SOCKET_ERROR;
+   }
 
-               //Adjust the actual length of the ancillary data buffer
-               n += CMSG_SPACE(sizeof(int_t));
-            }
-            else
-            {
-               //When the control message buffer is too short to store all
-               //messages, the MSG_CTRUNC flag must be set
-               msg->msg_flags |= MSG_CTRUNC;
-            }
-         }
-      }
-      else
-#endif
-#if (IPV6_SUPPORT == ENABLED)
-      //IPv6 address?
-      if(message.destIpAddr.length == sizeof(Ipv6Addr))
-      {
-         int_t *val;
-         CMSGHDR *cmsg;
-         IN6_PKTINFO *pktInfo;
+   //The flags parameter can be used to influence the behavior of the function
+   socketFlags = 0;
 
-         //The IPV6_PKTINFO option allows an application to enable or disable
-         //the return of IPv6 packet information
-         if((sock->options & SOCKET_OPTION_IPV6_PKT_INFO) != 0)
-         {
-            //Make sure there is enough room to add the control message
-            if((n + CMSG_SPACE(sizeof(IN6_PKTINFO))) <= msg->msg_controllen)
-            {
-               //Point to the ancillary data header
-               cmsg = (CMSGHDR *) ((uint8_t *) msg->msg_control + n);
+   //The MSG_DONTWAIT flag enables non-blocking operation
+   if((flags & MSG_DONTWAIT) != 0)
+   {
+      socketFlags |= SOCKET_FLAG_DONT_WAIT;
+   }
 
-               //Format ancillary data header
-               cmsg->cmsg_len = CMSG_LEN(sizeof(IN6_PKTINFO));
-               cmsg->cmsg_level = IPPROTO_IPV6;
-               cmsg->cmsg_type = IPV6_PKTINFO;
+   //Initialize status code
+   error = NO_ERROR;
+   //Number of messages received so far
+   total = 0;
 
-               //Point to the ancillary data value
-               pktInfo = (IN6_PKTINFO *) CMSG_DATA(cmsg);
+   //Process the messages batch by batch
+   while(total < vlen && !error)
+   {
+      //Number of messages to receive at a time
+      n = MIN(vlen - total, BSD_SOCKET_MMSG_BATCH_SIZE);
 
-               //Format packet information
-               pktInfo->ipi6_ifindex = message.interface->index;
-               ipv6CopyAddr(pktInfo->ipi6_addr.s6_addr, &message.destIpAddr.ipv6Addr);
+      //Point to the receive buffers
+      for(i = 0; i < n; i++)
+      {
+         //Point to the current message header
+         msg = &msgvec[total + i].msg_hdr;
 
-               //Adjust the actual length of the ancillary data buffer
-               n += CMSG_SPACE(sizeof(IN6_PKTINFO));
-            }
-            else
-            {
-               //When the control message buffer is too short to store all
-               //messages, the MSG_CTRUNC flag must be set
-               msg->msg_flags |= MSG_CTRUNC;
-            }
+         //Check parameters
+         if(msg->msg_iov == NULL || msg->msg_iovlen != 1)
+         {
+            socketSetErrnoCode(sock, EINVAL);
+            return (total > 0) ? (int_t) total : SOCKET_ERROR;
          }
 
-         //The IPV6_RECVTCLASS option allows an application to enable or disable
-         //the return of Traffic Class header field on received datagrams
-         if((sock->options & SOCKET_OPTION_IPV6_RECV_TRAFFIC_CLASS) != 0)
-         {
-            //Make sure there is enough room to add the control message
-            if((n + CMSG_SPACE(sizeof(int_t))) <= msg->msg_controllen)
-            {
-               //Point to the ancillary data header
-               cmsg = (CMSGHDR *) ((uint8_t *) msg->msg_control + n);
+         //Point to the receive buffer
+         messages[i] = SOCKET_DEFAULT_MSG;
+         messages[i].data = msg->msg_iov[0].iov_base;
+         messages[i].size = msg->msg_iov[0].iov_len;
+      }
 
-               //Format ancillary data header
-               cmsg->cmsg_len = CMSG_LEN(sizeof(int_t));
-               cmsg->cmsg_level = IPPROTO_IPV6;
-               cmsg->cmsg_type = IPV6_TCLASS;
+      //Receive the messages under a single lock
+      error = socketReceiveMsgBatch(sock, messages, n, &received, socketFlags);
 
-               //Point to the ancillary data value
-               val = (int_t *) CMSG_DATA(cmsg);
-               //Set ancillary data value
-               *val = message.tos;
+      //Report the messages that have been received
+      for(i = 0; i < received; i++)
+      {
+         //Point to the current message header
+         msg = &msgvec[total + i].msg_hdr;
 
-               //Adjust the actual length of the ancillary data buffer
-               n += CMSG_SPACE(sizeof(int_t));
-            }
-            else
-            {
-               //When the control message buffer is too short to store all
-               //messages, the MSG_CTRUNC flag must be set
-               msg->msg_flags |= MSG_CTRUNC;
-            }
-         }
+         //Report the source address and the ancillary data
+         error = socketFormatMsgHdr(sock, &messages[i], msg, 0);
 
-         //The IPV6_RECVHOPLIMIT option allows an application to enable or
-         //disable the return of Hop Limit header field on received datagrams
-         if((sock->options & SOCKET_OPTION_IPV6_RECV_HOP_LIMIT) != 0)
+         //Any error to report?
+         if(error)
          {
-            //Make sure there is enough room to add the control message
-            if((n + CMSG_SPACE(sizeof(int_t))) <= msg->msg_controllen)
-            {
-               //Point to the ancillary data header
-               cmsg = (CMSGHDR *) ((uint8_t *) msg->msg_control + n);
+            //Report an error
+            socketSetErrnoCode(sock, EINVAL);
+            //Return the number of messages that have been reported so far
+            return (total + i > 0) ? (int_t) (total + i) : SOCKET_ERROR;
+         }
 
-               //Format ancillary data header
-               cmsg->cmsg_len = CMSG_LEN(sizeof(int_t));
-               cmsg->cmsg_level = IPPROTO_IPV6;
-               cmsg->cmsg_type = IPV6_HOPLIMIT;
+         //Save the number of bytes received
+         msgvec[total + i].msg_len = messages[i].length;
+      }
 
-               //Point to the ancillary data value
-               val = (int_t *) CMSG_DATA(cmsg);
-               //Set ancillary data value
-               *val = message.ttl;
+      //Number of messages received so far
+      total += received;
 
-               //Adjust the actual length of the ancillary data buffer
-               n += CMSG_SPACE(sizeof(int_t));
-            }
-            else
-            {
-               //When the control message buffer is too short to store all
-               //messages, the MSG_CTRUNC flag must be set
-               msg->msg_flags |= MSG_CTRUNC;
-            }
-         }
-      }
-      else
-#endif
-      //Invalid address?
-      {
-         //Just for sanity
-      }
+      //The receive queue is empty?
+      if(received < n)
+         break;
+
+      //Do not wait for subsequent messages
+      socketFlags |= SOCKET_FLAG_DONT_WAIT;
    }
 
-   //Length of the actual length of the ancillary data buffer
-   msg->msg_controllen = n;
+   //No message could be received?
+   if(total == 0)
+   {
+      socketTranslateErrorCode(sock, error);
+      return SOCKET_ERROR;
+   }
 
-   //Return the number of bytes received
-   return message.length;
+   //Return the number of messages received
+   return total;
 }
 
+#endif
+
 
 /**
  * @brief Retrieves the local name for a socket
@@ -1894,6 +1808,11 @@ int_t setsockopt(int_t s, int_t level, int_t optname, const void *optval,
             //Set TCP_KEEPCNT option
             ret = socketSetTcpKeepCntOption(sock, optval, optlen);
          }
+         else if(optname == TCP_CONGESTION)
+         {
+            //Set TCP_CONGESTION option
+            ret = socketSetTcpCongestionOption(sock, optval, optlen);
+         }
          else
          {
             //Unknown option
@@ -2143,6 +2062,11 @@ int_t getsockopt(int_t s, int_t level, int_t optname, void *optval,
             //Get TCP_KEEPCNT option
             ret = socketGetTcpKeepCntOption(sock, optval, optlen);
          }
+         else if(optname == TCP_CONGESTION)
+         {
+            //Get TCP_CONGESTION option
+            ret = socketGetTcpCongestionOption(sock, optval, optlen);
+         }
          else
          {
             //Unknown option
@@ -2396,6 +2320,37 @@ int_t closesocket(int_t s)
 {
    Socket *sock;
 
+#if (SOCKET_EPOLL_SUPPORT == ENABLED)
+   //Epoll descriptor?
+   if(s >= SOCKET_MAX_COUNT && s < (SOCKET_MAX_COUNT + BSD_SOCKET_MAX_EPOLL_COUNT))
+   {
+      BsdEpoll *entry;
+
+      //Point to the epoll instance
+      entry = &bsdEpollTable[s - SOCKET_MAX_COUNT];
+
+      //Make sure the epoll instance is in use
+      if(!entry->used)
+      {
+         BSD_SOCKET_SET_ERRNO(EBADF);
+         return SOCKET_ERROR;
+      }
+
+      //Release the epoll instance
+      socketEpollDelete(&entry->epoll);
+
+      //Get exclusive access
+      osAcquireMutex(&netMutex);
+      //The entry can now be reused
+      entry->used = FALSE;
+      //Release exclusive access
+      osReleaseMutex(&netMutex);
+
+      //Successful processing
+      return SOCKET_SUCCESS;
+   }
+#endif
+
    //Make sure the socket descriptor is valid
    if(s < 0 || s >= SOCKET_MAX_COUNT)
    {
@@ -2609,6 +2564,279 @@ int_t select(int_t nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds,
 }
 
 
+#if (SOCKET_EPOLL_SUPPORT == ENABLED)
+
+/**
+ * @brief Open an epoll instance
+ * @param[in] size Ignored, but must be greater than zero
+ * @return On success, a file descriptor for the epoll instance is returned.
+ *   On failure, SOCKET_ERROR is returned
+ **/
+
+int_t epoll_create(int_t size)
+{
+   //The size argument must be greater than zero
+   if(size <= 0)
+   {
+      BSD_SOCKET_SET_ERRNO(EINVAL);
+      return SOCKET_ERROR;
+   }
+
+   //Open an epoll instance
+   return epoll_create1(0);
+}
+
+
+/**
+ * @brief Open an epoll instance
+ * @param[in] flags Ignored (the only flag defined by POSIX is EPOLL_CLOEXEC)
+ * @return On success, a file descriptor for the epoll instance is returned.
+ *   On failure, SOCKET_ERROR is returned
+ **/
+
+int_t epoll_create1(int_t flags)
+{
+   error_t error;
+   int_t i;
+   BsdEpoll *entry;
+
+   //Get exclusive access
+   osAcquireMutex(&netMutex);
+
+   //Loop through the epoll table
+   for(entry = NULL, i = 0; i < BSD_SOCKET_MAX_EPOLL_COUNT; i++)
+   {
+      //Unused epoll instance found?
+      if(!bsdEpollTable[i].used)
+      {
+         entry = &bsdEpollTable[i];
+         entry->used = TRUE;
+         break;
+      }
+   }
+
+   //Release exclusive access
+   osReleaseMutex(&netMutex);
+
+   //The epoll table runs out of space?
+   if(entry == NULL)
+   {
+      BSD_SOCKET_SET_ERRNO(EMFILE);
+      return SOCKET_ERROR;
+   }
+
+   //Initialize the epoll instance
+   error = socketEpollCreate(&entry->epoll);
+
+   //Any error to report?
+   if(error)
+   {
+      //Get exclusive access
+      osAcquireMutex(&netMutex);
+      //Give the entry back to the epoll table
+      entry->used = FALSE;
+      //Release exclusive access
+      osReleaseMutex(&netMutex);
+
+      BSD_SOCKET_SET_ERRNO(EMFILE);
+      return SOCKET_ERROR;
+   }
+
+   //Epoll descriptors are numbered after socket descriptors
+   return SOCKET_MAX_COUNT + i;
+}
+
+
+/**
+ * @brief Add, modify or remove an entry in the interest list of an epoll instance
+ * @param[in] epfd Descriptor that identifies the epoll instance
+ * @param[in] op Operation to be performed (EPOLL_CTL_ADD, EPOLL_CTL_MOD or
+ *   EPOLL_CTL_DEL)
+ * @param[in] fd Descriptor that identifies the target socket
+ * @param[in] event Events to monitor and user data to report (ignored for
+ *   EPOLL_CTL_DEL)
+ * @return If no error occurs, epoll_ctl returns SOCKET_SUCCESS
+ *   Otherwise, it returns SOCKET_ERROR
+ **/
+
+int_t epoll_ctl(int_t epfd, int_t op, int_t fd, struct epoll_event *event)
+{
+   error_t error;
+   uint_t eventMask;
+   BsdEpoll *entry;
+
+   //Make sure the epoll descriptor is valid
+   if(epfd < SOCKET_MAX_COUNT ||
+      epfd >= (SOCKET_MAX_COUNT + BSD_SOCKET_MAX_EPOLL_COUNT))
+   {
+      BSD_SOCKET_SET_ERRNO(EBADF);
+      return SOCKET_ERROR;
+   }
+
+   //Make sure the socket descriptor is valid
+   if(fd < 0 || fd >= SOCKET_MAX_COUNT)
+   {
+      BSD_SOCKET_SET_ERRNO(EBADF);
+      return SOCKET_ERROR;
+   }
+
+   //Point to the epoll instance
+   entry = &bsdEpollTable[epfd - SOCKET_MAX_COUNT];
+
+   //Make sure the epoll instance is in use
+   if(!entry->used)
+   {
+      BSD_SOCKET_SET_ERRNO(EBADF);
+      return SOCKET_ERROR;
+   }
+
+   //The event parameter is required for EPOLL_CTL_ADD and EPOLL_CTL_MOD
+   if(op != EPOLL_CTL_DEL && event == NULL)
+   {
+      BSD_SOCKET_SET_ERRNO(EFAULT);
+      return SOCKET_ERROR;
+   }
+
+   //Check operation
+   if(op == EPOLL_CTL_ADD || op == EPOLL_CTL_MOD)
+   {
+      //Convert epoll events to socket events
+      eventMask = socketEpollEventsToMask(event->events);
+   }
+   else if(op == EPOLL_CTL_DEL)
+   {
+      //No events to monitor
+      eventMask = 0;
+   }
+   else
+   {
+      //Invalid operation
+      BSD_SOCKET_SET_ERRNO(EINVAL);
+      return SOCKET_ERROR;
+   }
+
+   //Update the interest list
+   error = socketEpollCtl(&entry->epoll, (SocketEpollOp) op, &socketTable[fd],
+      eventMask);
+
+   //Any error to report?
+   if(error == ERROR_ALREADY_CONNECTED)
+   {
+      //The socket is already registered with an epoll instance
+      BSD_SOCKET_SET_ERRNO(EEXIST);
+      return SOCKET_ERROR;
+   }
+   else if(error == ERROR_NOT_FOUND)
+   {
+      //The socket is not registered with this epoll instance
+      BSD_SOCKET_SET_ERRNO(ENOENT);
+      return SOCKET_ERROR;
+   }
+   else if(error)
+   {
+      BSD_SOCKET_SET_ERRNO(EINVAL);
+      return SOCKET_ERROR;
+   }
+
+   //The user data must not be altered if the operation fails
+   if(op == EPOLL_CTL_ADD || op == EPOLL_CTL_MOD)
+   {
+      //Save the user data attached to the socket
+      entry->data[fd] = event->data;
+   }
+
+   //Successful processing
+   return SOCKET_SUCCESS;
+}
+
+
+/**
+ * @brief Wait for I/O events on an epoll instance
+ * @param[in] epfd Descriptor that identifies the epoll instance
+ * @param[out] events Array where to store the events that are available
+ * @param[in] maxevents Maximum number of events to return
+ * @param[in] timeout Maximum time to wait, in milliseconds. A value of -1
+ *   causes epoll_wait to block indefinitely
+ * @return The number of sockets ready for the requested I/O, zero if the
+ *   time limit expired, or SOCKET_ERROR if an error occurred
+ **/
+
+int_t epoll_wait(int_t epfd, struct epoll_event *events, int_t maxevents,
+   int_t timeout)
+{
+   error_t error;
+   uint_t i;
+   uint_t n;
+   systime_t time;
+   BsdEpoll *entry;
+   SocketEventDesc eventDesc[SOCKET_MAX_COUNT];
+
+   //Make sure the epoll descriptor is valid
+   if(epfd < SOCKET_MAX_COUNT ||
+      epfd >= (SOCKET_MAX_COUNT + BSD_SOCKET_MAX_EPOLL_COUNT))
+   {
+      BSD_SOCKET_SET_ERRNO(EBADF);
+      return SOCKET_ERROR;
+   }
+
+   //Check parameters
+   if(events == NULL || maxevents <= 0)
+   {
+      BSD_SOCKET_SET_ERRNO(EINVAL);
+      return SOCKET_ERROR;
+   }
+
+   //Point to the epoll instance
+   entry = &bsdEpollTable[epfd - SOCKET_MAX_COUNT];
+
+   //Make sure the epoll instance is in use
+   if(!entry->used)
+   {
+      BSD_SOCKET_SET_ERRNO(EBADF);
+      return SOCKET_ERROR;
+   }
+
+   //Retrieve timeout value
+   if(timeout >= 0)
+   {
+      time = timeout;
+   }
+   else
+   {
+      time = INFINITE_DELAY;
+   }
+
+   //A socket can be reported at most once per call
+   n = MIN((uint_t) maxevents, SOCKET_MAX_COUNT);
+
+   //Wait for events
+   error = socketEpollWait(&entry->epoll, eventDesc, n, &n, time);
+
+   //Timeout error?
+   if(error == ERROR_TIMEOUT)
+   {
+      return 0;
+   }
+   else if(error)
+   {
+      BSD_SOCKET_SET_ERRNO(EINVAL);
+      return SOCKET_ERROR;
+   }
+
+   //Convert socket events to epoll events
+   for(i = 0; i < n; i++)
+   {
+      events[i].events = socketMaskToEpollEvents(eventDesc[i].eventFlags);
+      events[i].data = entry->data[eventDesc[i].socket->descriptor];
+   }
+
+   //Return the number of sockets ready for the requested I/O
+   return n;
+}
+
+#endif
+
+
 /**
  * @brief Get system host name
  * @param[out] name Output buffer where to store the system host name
@@ -42,6 +42,20 @@
    #error FD_SETSIZE parameter is not valid
 #endif
 
+//Maximum number of epoll instances
+#ifndef BSD_SOCKET_MAX_EPOLL_COUNT
+   #define BSD_SOCKET_MAX_EPOLL_COUNT 1
+#elif (BSD_SOCKET_MAX_EPOLL_COUNT < 1)
+   #error BSD_SOCKET_MAX_EPOLL_COUNT parameter is not valid
+#endif
+
+//Number of messages processed at a time by sendmmsg and recvmmsg
+#ifndef BSD_SOCKET_MMSG_BATCH_SIZE
+   #define BSD_SOCKET_MMSG_BATCH_SIZE 8
+#elif (BSD_SOCKET_MMSG_BATCH_SIZE < 1)
+   #error BSD_SOCKET_MMSG_BATCH_SIZE parameter is not valid
+#endif
+
 //Set errno variable
 #ifndef BSD_SOCKET_SET_ERRNO
    #define BSD_SOCKET_SET_ERRNO(e)
@@ -117,8 +131,13 @@
 #define MSG_PEEK             0x0002
 #define MSG_DONTROUTE        0x0004
 #define MSG_CTRUNC           0x0008
+#define MSG_TRUNC            0x0020
 #define MSG_DONTWAIT         0x0040
 #define MSG_WAITALL          0x0100
+#define MSG_ZEROCOPY         0x4000
+
+//Socket level control messages
+#define SCM_NET_BUFFER       0x4001
 
 //Flags used by shutdown function
 #define SD_RECEIVE           0
@@ -180,6 +199,10 @@
 #define TCP_KEEPIDLE         0x0004
 #define TCP_KEEPINTVL        0x0005
 #define TCP_KEEPCNT          0x0006
+#define TCP_CONGESTION       0x000D
+
+//Maximum length of a congestion control algorithm name
+#define TCP_CA_NAME_MAX      16
 
 //IP TOS option
 #define IPTOS_LOWDELAY       0x10
@@ -215,6 +238,18 @@
 #define NI_NUMERICSERV       0x08
 #define NI_DGRAM             0x10
 
+//Epoll events
+#define EPOLLIN              0x0001
+#define EPOLLOUT             0x0004
+#define EPOLLERR             0x0008
+#define EPOLLHUP             0x0010
+#define EPOLLRDHUP           0x2000
+
+//Epoll control operations
+#define EPOLL_CTL_ADD        1
+#define EPOLL_CTL_DEL        2
+#define EPOLL_CTL_MOD        3
+
 //Return values
 #define SOCKET_SUCCESS       0
 #define SOCKET_ERROR         (-1)
@@ -234,11 +269,15 @@
 #define EAI_OVERFLOW         12
 
 //Error codes
+#define ENOENT               2
 #define EINTR                4
+#define EBADF                9
 #define EAGAIN               11
 #define EWOULDBLOCK          11
 #define EFAULT               14
+#define EEXIST               17
 #define EINVAL               22
+#define EMFILE               24
 #define EINPROGRESS          36
 #define ETIMEDOUT            60
 #define ENAMETOOLONG         63
@@ -415,6 +454,17 @@ typedef struct msghdr
 } MSGHDR, *PMSGHDR;
 
 
+/**
+ * @brief Message header used by sendmmsg and recvmmsg
+ **/
+
+typedef struct mmsghdr
+{
+   struct msghdr msg_hdr;
+   uint_t msg_len;
+} MMSGHDR, *PMMSGHDR;
+
+
 /**
  * @brief Ancillary data header
  **/
@@ -460,6 +510,30 @@ typedef struct fd_set
 } fd_set, FD_SET, *PFD_SET;
 
 
+/**
+ * @brief User data attached to an epoll event
+ **/
+
+typedef union epoll_data
+{
+   void *ptr;
+   int_t fd;
+   uint32_t u32;
+   uint64_t u64;
+} epoll_data_t;
+
+
+/**
+ * @brief Epoll event
+ **/
+
+struct epoll_event
+{
+   uint32_t events;
+   epoll_data_t data;
+};
+
+
 /**
  * @brief Information about a given host
  **/
@@ -544,6 +618,7 @@ int_t sendto(int_t s, const void *data, size_t length, int_t flags,
    const struct sockaddr *addr, socklen_t addrlen);
 
 int_t sendmsg(int_t s, struct msghdr *msg, int_t flags);
+int_t sendmmsg(int_t s, struct mmsghdr *msgvec, uint_t vlen, int_t flags);
 
 int_t recv(int_t s, void *data, size_t size, int_t flags);
 
@@ -552,6 +627,9 @@ int_t recvfrom(int_t s, void *data, size_t size, int_t flags,
 
 int_t recvmsg(int_t s, struct msghdr *msg, int_t flags);
 
+int_t recvmmsg(int_t s, struct mmsghdr *msgvec, uint_t vlen, int_t flags,
+   struct timeval *timeout);
+
 int_t getsockname(int_t s, struct sockaddr *addr, socklen_t *addrlen);
 int_t getpeername(int_t s, struct sockaddr *addr, socklen_t *addrlen);
 
@@ -570,6 +648,13 @@ int_t closesocket(int_t s);
 int_t select(int_t nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds,
    const struct timeval *timeout);
 
+int_t epoll_create(int_t size);
+int_t epoll_create1(int_t flags);
+int_t epoll_ctl(int_t epfd, int_t op, int_t fd, struct epoll_event *event);
+
+int_t epoll_wait(int_t epfd, struct epoll_event *events, int_t maxevents,
+   int_t timeout);
+
 int_t gethostname(char_t *name, size_t len);
 struct hostent *gethostbyname(const char_t *name);
 
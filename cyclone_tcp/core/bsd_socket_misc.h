@@ -37,10 +37,41 @@
 extern "C" {
 #endif
 
+#if (BSD_SOCKET_SUPPORT == ENABLED && SOCKET_EPOLL_SUPPORT == ENABLED)
+
+/**
+ * @brief Epoll instance (BSD socket layer)
+ **/
+
+typedef struct
+{
+   bool_t used;                         ///<The epoll instance is in use
+   SocketEpoll epoll;                   ///<Underlying epoll instance
+   epoll_data_t data[SOCKET_MAX_COUNT]; ///<User data attached to each descriptor
+} BsdEpoll;
+
+
+//Global variables
+extern BsdEpoll bsdEpollTable[BSD_SOCKET_MAX_EPOLL_COUNT];
+
+#endif
+
 //BSD socket related functions
 void socketSetErrnoCode(Socket *socket, uint_t errnoCode);
 void socketTranslateErrorCode(Socket *socket, error_t errorCode);
 
+#if (BSD_SOCKET_SUPPORT == ENABLED)
+
+error_t socketParseMsgHdr(const struct msghdr *msg, SocketMsg *message);
+
+error_t socketFormatMsgHdr(Socket *socket, const SocketMsg *message,
+   struct msghdr *msg, size_t offset);
+
+uint_t socketEpollEventsToMask(uint32_t events);
+uint32_t socketMaskToEpollEvents(uint_t eventFlags);
+
+#endif
+
 //C++ guard
 #ifdef __cplusplus
 }
@@ -1705,6 +1705,72 @@ int_t socketSetTcpKeepCntOption(Socket *socket, const int_t *optval,
 }
 
 
+/**
+ * @brief Set TCP_CONGESTION option
+ * @param[in] socket Handle referencing the socket
+ * @param[in] optval A pointer to the buffer in which the value for the
+ *   requested option is specified
+ * @param[in] optlen The size, in bytes, of the buffer pointed to by the optval
+ *   parameter
+ * @return Error code (SOCKET_SUCCESS or SOCKET_ERROR)
+ **/
+
+int_t socketSetTcpCongestionOption(Socket *socket, const char_t *optval,
+   socklen_t optlen)
+{
+   int_t ret;
+
+#if (TCP_SUPPORT == ENABLED && TCP_CONGEST_CONTROL_SUPPORT == ENABLED)
+   error_t error;
+   size_t n;
+   char_t name[TCP_CA_NAME_MAX];
+
+   //The name of the algorithm is not necessarily NULL-terminated
+   for(n = 0; n < (size_t) optlen && n < (TCP_CA_NAME_MAX - 1); n++)
+   {
+      //End of string?
+      if(optval[n] == '\0')
+         break;
+
+      //Copy current character
+      name[n] = optval[n];
+   }
+
+   //Properly terminate the string with a NULL character
+   name[n] = '\0';
+
+   //Select the specified congestion control algorithm
+   error = socketSetCongestionAlgo(socket, name);
+
+   //Check status code
+   if(!error)
+   {
+      //Successful processing
+      ret = SOCKET_SUCCESS;
+   }
+   else if(error == ERROR_UNSUPPORTED_ALGO)
+   {
+      //The requested algorithm is not available
+      socketSetErrnoCode(socket, ENOENT);
+      ret = SOCKET_ERROR;
+   }
+   else
+   {
+      //The option is not valid for this socket
+      socketSetErrnoCode(socket, ENOPROTOOPT);
+      ret = SOCKET_ERROR;
+   }
+#else
+   //TCP congestion control is not supported
+   socketSetErrnoCode(socket, ENOPROTOOPT);
+   ret = SOCKET_ERROR;
+#endif
+
+   //Return status code
+   return ret;
+}
+
+
 /**
  * @brief Get SO_REUSEADDR option
  * @param[in] socket Handle referencing the socket
@@ -3195,4 +3261,57 @@ int_t socketGetTcpKeepCntOption(Socket *socket, int_t *optval,
    return ret;
 }
 
+
+/**
+ * @brief Get TCP_CONGESTION option
+ * @param[in] socket Handle referencing the socket
+ * @param[out] optval A pointer to the buffer in which the value for the
+ *   requested option is to be returned
+ * @param[in,out] optlen The size, in bytes, of the buffer pointed to by the
+ *   optval parameter
+ * @return Error code (SOCKET_SUCCESS or SOCKET_ERROR)
+ **/
+
+int_t socketGetTcpCongestionOption(Socket *socket, char_t *optval,
+   socklen_t *optlen)
+{
+   int_t ret;
+
+#if (TCP_SUPPORT == ENABLED && TCP_CONGEST_CONTROL_SUPPORT == ENABLED)
+   size_t n;
+
+   //Get exclusive access
+   osAcquireMutex(&netMutex);
+
+   //Retrieve the length of the algorithm name
+   n = osStrlen(socket->congestAlgo->name);
+   //Limit the number of bytes to copy
+   n = MIN(n, (size_t) *optlen);
+
+   //Return the name of the congestion control algorithm
+   osMemcpy(optval, socket->congestAlgo->name, n);
+
+   //Pad the buffer with a NULL character if space permits
+   if(n < (size_t) *optlen)
+   {
+      optval[n++] = '\0';
+   }
+
+   //Release exclusive access
+   osReleaseMutex(&netMutex);
+
+   //Return the actual length of the option
+   *optlen = n;
+   //Successful processing
+   ret = SOCKET_SUCCESS;
+#else
+   //TCP congestion control is not supported
+   socketSetErrnoCode(socket, ENOPROTOOPT);
+   ret = SOCKET_ERROR;
+#endif
+
+   //Return status code
+   return ret;
+}
+
 #endif
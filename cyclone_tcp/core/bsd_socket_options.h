@@ -143,6 +143,9 @@ int_t socketSetTcpKeepIntvlOption(Socket *socket, const int_t *optval,
 int_t socketSetTcpKeepCntOption(Socket *socket, const int_t *optval,
    socklen_t optlen);
 
+int_t socketSetTcpCongestionOption(Socket *socket, const char_t *optval,
+   socklen_t optlen);
+
 int_t socketGetSoReuseAddrOption(Socket *socket, int_t *optval,
    socklen_t *optlen);
 
@@ -236,6 +239,9 @@ int_t socketGetTcpKeepIntvlOption(Socket *socket, int_t *optval,
 int_t socketGetTcpKeepCntOption(Socket *socket, int_t *optval,
    socklen_t *optlen);
 
+int_t socketGetTcpCongestionOption(Socket *socket, char_t *optval,
+   socklen_t *optlen);
+
 //C++ guard
 #ifdef __cplusplus
 }
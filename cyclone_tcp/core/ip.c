@@ -44,6 +44,13 @@
    #include "ah/ah.h"
 #endif
 
+//SIMD accelerated checksum calculation?
+#if (IP_CHECKSUM_SSE2_SUPPORT == ENABLED)
+   #include <emmintrin.h>
+#elif (IP_CHECKSUM_NEON_SUPPORT == ENABLED)
+   #include <arm_neon.h>
+#endif
+
 //Special IP addresses
 const IpAddr IP_ADDR_ANY = {0};
 const IpAddr IP_ADDR_UNSPECIFIED = {0};
@@ -495,8 +502,8 @@ error_t ipLeaveMulticastGroup(NetInterface *interface, const IpAddr *groupAddr)
 
 uint16_t ipCalcChecksum(const void *data, size_t length)
 {
-   uint32_t temp;
-   uint32_t checksum;
+   size_t n;
+   uint64_t checksum;
    const uint8_t *p;
 
    //Checksum preset value
@@ -540,45 +547,279 @@ uint16_t ipCalcChecksum(const void *data, size_t length)
    }
 
    //Process the data 4 bytes at a time
+   n = length & ~((size_t) 3);
+   checksum += ipCalcChecksumWords(p, n);
+
+   //Point to the remaining bytes
+   p += n;
+   //Number of bytes left to process
+   length -= n;
+
+   //Fold 64-bit sum to 16 bits
+   checksum = (checksum & 0xFFFF) + ((checksum >> 16) & 0xFFFF) +
+      ((checksum >> 32) & 0xFFFF) + (checksum >> 48);
+
+   //Add left-over 16-bit word, if any
+   if(length >= 2)
+   {
+      //Update checksum value
+      checksum += (uint32_t) *((uint16_t *) p);
+
+      //Point to the next byte
+      p += 2;
+      //Number of bytes left to process
+      length -= 2;
+   }
+
+   //Add left-over byte, if any
+   if(length >= 1)
+   {
+#ifdef _CPU_BIG_ENDIAN
+      //Update checksum value
+      checksum += (uint32_t) *p << 8;
+#else
+      //Update checksum value
+      checksum += (uint32_t) *p;
+#endif
+   }
+
+   //Fold 32-bit sum to 16 bits (first pass)
+   checksum = (checksum & 0xFFFF) + (checksum >> 16);
+   //Fold 32-bit sum to 16 bits (second pass)
+   checksum = (checksum & 0xFFFF) + (checksum >> 16);
+
+   //Restore checksum endianness
+   if(((uintptr_t) data & 1) != 0)
+   {
+      //Swap checksum value
+      checksum = ((checksum >> 8) | (checksum << 8)) & 0xFFFF;
+   }
+
+   //Return 1's complement value
+   return (uint16_t) (checksum ^ 0xFFFF);
+}
+
+
+/**
+ * @brief Sum 32-bit words using a 64-bit accumulator
+ *
+ * The 64-bit accumulator absorbs the carries, so that no carry has to be
+ * propagated after each addition. The caller folds the result to 16 bits
+ *
+ * @param[in] data Pointer to the data (aligned on a 32-bit boundary)
+ * @param[in] length Number of bytes to process (multiple of 4)
+ * @return 64-bit sum of the 32-bit words
+ **/
+
+uint64_t ipCalcChecksumWords(const void *data, size_t length)
+{
+   uint64_t checksum;
+   const uint32_t *p;
+
+   //Point to the data over which to calculate the sum
+   p = (const uint32_t *) data;
+   //Preset value
+   checksum = 0;
+
+#if (IP_CHECKSUM_SSE2_SUPPORT == ENABLED)
+   //Process the data 16 bytes at a time using SSE2 instructions
+   if(length >= 16)
+   {
+      __m128i v;
+      __m128i zero;
+      __m128i acc;
+      uint64_t lanes[2];
+
+      //Clear accumulator
+      zero = _mm_setzero_si128();
+      acc = zero;
+
+      //Each 32-bit lane is widened to 64 bits before being accumulated
+      while(length >= 16)
+      {
+         v = _mm_loadu_si128((const __m128i *) p);
+         acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(v, zero));
+         acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(v, zero));
+
+         //Point to the next block
+         p += 4;
+         //Number of bytes left to process
+         length -= 16;
+      }
+
+      //Sum the two 64-bit lanes
+      _mm_storeu_si128((__m128i *) lanes, acc);
+      checksum += lanes[0] + lanes[1];
+   }
+#elif (IP_CHECKSUM_NEON_SUPPORT == ENABLED)
+   //Process the data 16 bytes at a time using NEON instructions
+   if(length >= 16)
+   {
+      uint64x2_t acc;
+
+      //Clear accumulator
+      acc = vdupq_n_u64(0);
+
+      //Pairwise add the 32-bit lanes into the 64-bit lanes of the accumulator
+      while(length >= 16)
+      {
+         acc = vpadalq_u32(acc, vld1q_u32(p));
+
+         //Point to the next block
+         p += 4;
+         //Number of bytes left to process
+         length -= 16;
+      }
+
+      //Sum the two 64-bit lanes
+      checksum += vgetq_lane_u64(acc, 0) + vgetq_lane_u64(acc, 1);
+   }
+#endif
+
+   //Process the data 16 bytes at a time
+   while(length >= 16)
+   {
+      //Update checksum value
+      checksum += (uint64_t) p[0] + p[1];
+      checksum += (uint64_t) p[2] + p[3];
+
+      //Point to the next block
+      p += 4;
+      //Number of bytes left to process
+      length -= 16;
+   }
+
+   //Process the remaining 32-bit words
    while(length >= 4)
    {
       //Update checksum value
-      temp = checksum + *((uint32_t *) p);
+      checksum += *p;
+
+      //Point to the next 32-bit word
+      p++;
+      //Number of bytes left to process
+      length -= 4;
+   }
+
+   //Return the 64-bit sum
+   return checksum;
+}
+
+
+/**
+ * @brief Copy data and calculate the IP checksum in a single pass
+ * @param[out] dest Destination buffer
+ * @param[in] src Source buffer
+ * @param[in] length Number of bytes to copy
+ * @return Checksum value
+ **/
+
+uint16_t ipCalcChecksumCopy(void *dest, const void *src, size_t length)
+{
+   uint64_t checksum;
+   uint32_t value;
+   uint8_t *q;
+   const uint8_t *p;
+
+   //Source and destination buffers must share the same alignment
+   if((((uintptr_t) dest ^ (uintptr_t) src) & 3) != 0)
+   {
+      //Copy the data, then calculate the checksum while the data is cached
+      osMemcpy(dest, src, length);
+      //Return checksum value
+      return ipCalcChecksum(dest, length);
+   }
+
+   //Checksum preset value
+   checksum = 0x0000;
+
+   //Point to the source and destination buffers
+   p = (const uint8_t *) src;
+   q = (uint8_t *) dest;
 
-      //Add carry bit, if any
-      if(temp < checksum)
+   //Pointer not aligned on a 16-bit boundary?
+   if(((uintptr_t) p & 1) != 0)
+   {
+      if(length >= 1)
       {
-         checksum = temp + 1;
+         //Copy the first byte
+         *q = *p;
+
+#ifdef _CPU_BIG_ENDIAN
+         //Update checksum value
+         checksum += (uint32_t) *p;
+#else
+         //Update checksum value
+         checksum += (uint32_t) *p << 8;
+#endif
+         //Restore the alignment on 16-bit boundaries
+         p++;
+         q++;
+         //Number of bytes left to process
+         length--;
       }
-      else
+   }
+
+   //Pointer not aligned on a 32-bit boundary?
+   if(((uintptr_t) p & 2) != 0)
+   {
+      if(length >= 2)
       {
-         checksum = temp;
+         //Copy the 16-bit word
+         *((uint16_t *) q) = *((uint16_t *) p);
+         //Update checksum value
+         checksum += (uint32_t) *((uint16_t *) p);
+
+         //Restore the alignment on 32-bit boundaries
+         p += 2;
+         q += 2;
+         //Number of bytes left to process
+         length -= 2;
       }
+   }
+
+   //Copy the data 4 bytes at a time
+   while(length >= 4)
+   {
+      //Load the current 32-bit word
+      value = *((uint32_t *) p);
+      //Store the 32-bit word
+      *((uint32_t *) q) = value;
+      //Update checksum value
+      checksum += value;
 
       //Point to the next 32-bit word
       p += 4;
+      q += 4;
       //Number of bytes left to process
       length -= 4;
    }
 
-   //Fold 32-bit sum to 16 bits
-   checksum = (checksum & 0xFFFF) + (checksum >> 16);
+   //Fold 64-bit sum to 16 bits
+   checksum = (checksum & 0xFFFF) + ((checksum >> 16) & 0xFFFF) +
+      ((checksum >> 32) & 0xFFFF) + (checksum >> 48);
 
-   //Add left-over 16-bit word, if any
+   //Copy left-over 16-bit word, if any
    if(length >= 2)
    {
+      //Copy the 16-bit word
+      *((uint16_t *) q) = *((uint16_t *) p);
       //Update checksum value
       checksum += (uint32_t) *((uint16_t *) p);
 
       //Point to the next byte
       p += 2;
+      q += 2;
       //Number of bytes left to process
       length -= 2;
    }
 
-   //Add left-over byte, if any
+   //Copy left-over byte, if any
    if(length >= 1)
    {
+      //Copy the last byte
+      *q = *p;
+
 #ifdef _CPU_BIG_ENDIAN
       //Update checksum value
       checksum += (uint32_t) *p << 8;
@@ -594,14 +835,14 @@ uint16_t ipCalcChecksum(const void *data, size_t length)
    checksum = (checksum & 0xFFFF) + (checksum >> 16);
 
    //Restore checksum endianness
-   if(((uintptr_t) data & 1) != 0)
+   if(((uintptr_t) src & 1) != 0)
    {
       //Swap checksum value
       checksum = ((checksum >> 8) | (checksum << 8)) & 0xFFFF;
    }
 
    //Return 1's complement value
-   return checksum ^ 0xFFFF;
+   return (uint16_t) (checksum ^ 0xFFFF);
 }
 
 
@@ -39,6 +39,20 @@
    #error IP_DEFAULT_DF parameter is not valid
 #endif
 
+//SSE2 accelerated checksum calculation
+#ifndef IP_CHECKSUM_SSE2_SUPPORT
+   #define IP_CHECKSUM_SSE2_SUPPORT DISABLED
+#elif (IP_CHECKSUM_SSE2_SUPPORT != ENABLED && IP_CHECKSUM_SSE2_SUPPORT != DISABLED)
+   #error IP_CHECKSUM_SSE2_SUPPORT parameter is not valid
+#endif
+
+//NEON accelerated checksum calculation
+#ifndef IP_CHECKSUM_NEON_SUPPORT
+   #define IP_CHECKSUM_NEON_SUPPORT DISABLED
+#elif (IP_CHECKSUM_NEON_SUPPORT != ENABLED && IP_CHECKSUM_NEON_SUPPORT != DISABLED)
+   #error IP_CHECKSUM_NEON_SUPPORT parameter is not valid
+#endif
+
 //C++ guard
 #ifdef __cplusplus
 extern "C" {
@@ -133,6 +147,8 @@ error_t ipJoinMulticastGroup(NetInterface *interface, const IpAddr *groupAddr);
 error_t ipLeaveMulticastGroup(NetInterface *interface, const IpAddr *groupAddr);
 
 uint16_t ipCalcChecksum(const void *data, size_t length);
+uint64_t ipCalcChecksumWords(const void *data, size_t length);
+uint16_t ipCalcChecksumCopy(void *dest, const void *src, size_t length);
 uint16_t ipCalcChecksumEx(const NetBuffer *buffer, size_t offset, size_t length);
 
 uint16_t ipCalcUpperLayerChecksum(const void *pseudoHeader,
@@ -0,0 +1,664 @@
+/**
+ * @file ip_reasm.c
+ * @brief IP datagram reassembly engine
+ *
+ * @section License
+ *
+ * Copyright (C) 2010-2023 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneTCP Eval.
+ *
+ * This software is provided in source form for a short-term evaluation only. The
+ * evaluation license expires 90 days after the date you first download the software.
+ *
+ * If you plan to use this software in a commercial product, you are required to
+ * purchase a commercial license from Oryx Embedded SARL.
+ *
+ * After the 90-day evaluation period, you agree to either purchase a commercial
+ * license or delete all copies of this software. If you wish to extend the
+ * evaluation period, you must contact sales@oryx-embedded.com.
+ *
+ * This evaluation software is provided "as is" without warranty of any kind.
+ * Technical support is available as an option during the evaluation period.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.3.2
+ **/
+
+
+//Switch to the appropriate trace level
+#define TRACE_LEVEL IP_TRACE_LEVEL
+
+//Dependencies
+#include "core/net.h"
+#include "core/ip_reasm.h"
+#include "ipv4/ipv4_frag.h"
+#include "ipv6/ipv6_frag.h"
+#include "debug.h"
+
+//Check TCP/IP stack configuration
+#if ((IPV4_SUPPORT == ENABLED && IPV4_FRAG_SUPPORT == ENABLED) || \
+   (IPV6_SUPPORT == ENABLED && IPV6_FRAG_SUPPORT == ENABLED))
+
+
+/**
+ * @brief Initialize a reassembly queue
+ * @param[in] queue Pointer to the reassembly queue
+ * @param[in] table Datagram descriptors
+ * @param[in] bitmaps Storage for the coverage bitmaps. Each descriptor
+ *   requires IP_REASM_BITMAP_SIZE(maxDatagramSize) words
+ * @param[in] blocks Storage for the block tables. Each descriptor requires
+ *   IP_REASM_BLOCK_COUNT(maxDatagramSize) entries
+ * @param[in] buffer Buffer describing the reassembled datagram. It must hold
+ *   at least IP_REASM_CHUNK_COUNT(maxDatagramSize) chunks
+ * @param[in] size Number of descriptors
+ * @param[in] maxDatagramSize Maximum size of a reassembled datagram
+ * @param[in] maxMemSize Maximum amount of memory the queue may hold, in bytes
+ * @param[in] overlapAllowed Accept overlapping fragments
+ **/
+
+void ipReasmInit(IpReasmQueue *queue, IpReasmDesc *table, uint32_t *bitmaps,
+   uint8_t **blocks, NetBuffer *buffer, uint_t size, size_t maxDatagramSize,
+   size_t maxMemSize, bool_t overlapAllowed)
+{
+   uint_t i;
+
+   //Clear the reassembly queue
+   osMemset(queue, 0, sizeof(IpReasmQueue));
+
+   //Attach the datagram descriptors
+   queue->table = table;
+   queue->size = size;
+
+   //Save parameters
+   queue->maxDatagramSize = maxDatagramSize;
+   queue->bitmapSize = IP_REASM_BITMAP_SIZE(maxDatagramSize);
+   queue->blockTableSize = IP_REASM_BLOCK_COUNT(maxDatagramSize);
+   queue->maxMemSize = maxMemSize;
+   queue->overlapAllowed = overlapAllowed;
+
+   //Attach the buffer describing the reassembled datagram
+   queue->buffer = buffer;
+   queue->buffer->maxChunkCount = IP_REASM_CHUNK_COUNT(maxDatagramSize);
+
+   //Initialize datagram descriptors
+   for(i = 0; i < size; i++)
+   {
+      //Clear current entry
+      osMemset(&table[i], 0, sizeof(IpReasmDesc));
+      //Attach the coverage bitmap
+      table[i].bitmap = bitmaps + i * queue->bitmapSize;
+      //Attach the block table
+      table[i].blocks = blocks + i * queue->blockTableSize;
+      //No memory block is allocated yet
+      osMemset(table[i].blocks, 0, queue->blockTableSize * sizeof(uint8_t *));
+   }
+}
+
+
+/**
+ * @brief Drop all the datagrams being reassembled
+ * @param[in] queue Pointer to the reassembly queue
+ **/
+
+void ipReasmFlush(IpReasmQueue *queue)
+{
+   uint_t i;
+
+   //Loop through the datagram descriptors
+   for(i = 0; i < queue->size; i++)
+   {
+      //Drop any partially reconstructed datagram
+      if(queue->table[i].used)
+      {
+         ipReasmDeleteDesc(queue, &queue->table[i]);
+      }
+   }
+}
+
+
+/**
+ * @brief Search the reassembly queue for a given datagram
+ *
+ * If no datagram matches the specified identifier, a new entry is created.
+ * When the queue is full, the oldest datagram is dropped to make room for
+ * the new one
+ *
+ * @param[in] queue Pointer to the reassembly queue
+ * @param[in] key Datagram identifier
+ * @return Pointer to the matching datagram descriptor
+ **/
+
+IpReasmDesc *ipReasmFindDesc(IpReasmQueue *queue, const IpReasmKey *key)
+{
+   uint_t i;
+   uint_t index;
+   IpReasmDesc *desc;
+   IpReasmDesc *oldestDesc;
+
+   //Compute the index of the hash bucket
+   index = ipReasmHashKey(key);
+
+   //Walk through the hash chain
+   for(desc = queue->hashTable[index]; desc != NULL; desc = desc->next)
+   {
+      //Matching datagram?
+      if(!osMemcmp(&desc->key, key, sizeof(IpReasmKey)))
+         return desc;
+   }
+
+   //Keep track of the oldest entry
+   oldestDesc = NULL;
+
+   //Search the table for a free entry
+   for(i = 0; i < queue->size; i++)
+   {
+      //Point to the current entry
+      desc = &queue->table[i];
+
+      //Check whether the entry is free
+      if(!desc->used)
+         break;
+
+      //Keep track of the oldest entry
+      if(oldestDesc == NULL ||
+         timeCompare(desc->timestamp, oldestDesc->timestamp) < 0)
+      {
+         oldestDesc = desc;
+      }
+   }
+
+   //The reassembly queue is full?
+   if(i >= queue->size)
+   {
+      //Sanity check
+      if(oldestDesc == NULL)
+         return NULL;
+
+      //Debug message
+      TRACE_INFO("Reassembly queue full, dropping oldest datagram...\r\n");
+
+      //Drop the oldest datagram
+      ipReasmDeleteDesc(queue, oldestDesc);
+      //Reuse the corresponding entry
+      desc = oldestDesc;
+   }
+
+   //Initialize the new entry
+   desc->used = TRUE;
+   desc->timestamp = osGetSystemTime();
+   desc->header = NULL;
+   desc->headerLen = 0;
+   desc->dataLen = 0;
+   desc->lastReceived = FALSE;
+   desc->blockCount = 0;
+   desc->memSize = 0;
+
+   //Save the datagram identifier
+   osMemcpy(&desc->key, key, sizeof(IpReasmKey));
+   //The datagram is initially completely missing
+   osMemset(desc->bitmap, 0, queue->bitmapSize * sizeof(uint32_t));
+
+   //Insert the entry at the head of the hash chain
+   desc->next = queue->hashTable[index];
+   queue->hashTable[index] = desc;
+
+   //Return a pointer to the newly created entry
+   return desc;
+}
+
+
+/**
+ * @brief Drop a datagram being reassembled
+ * @param[in] queue Pointer to the reassembly queue
+ * @param[in] desc Pointer to the datagram descriptor
+ **/
+
+void ipReasmDeleteDesc(IpReasmQueue *queue, IpReasmDesc *desc)
+{
+   uint_t i;
+   IpReasmDesc **p;
+
+   //Release the memory blocks holding the payload
+   for(i = 0; i < queue->blockTableSize; i++)
+   {
+      //Blocks are only allocated when data is received
+      if(desc->blocks[i] != NULL)
+      {
+         memPoolFree(desc->blocks[i]);
+         desc->blocks[i] = NULL;
+      }
+   }
+
+   //Release the memory block holding the header
+   if(desc->header != NULL)
+   {
+      memPoolFree(desc->header);
+   }
+
+   //Update the memory usage of the queue
+   queue->memSize -= desc->memSize;
+
+   //Point to the head of the hash chain
+   p = &queue->hashTable[ipReasmHashKey(&desc->key)];
+
+   //Search the hash chain for the entry
+   while(*p != NULL && *p != desc)
+   {
+      p = &(*p)->next;
+   }
+
+   //Remove the entry from the hash chain
+   if(*p != NULL)
+   {
+      *p = desc->next;
+   }
+
+   //The entry is now free
+   desc->used = FALSE;
+   desc->header = NULL;
+   desc->memSize = 0;
+   desc->next = NULL;
+}
+
+
+/**
+ * @brief Add a fragment to a datagram being reassembled
+ *
+ * The data of the fragment is copied once into the memory blocks that cover
+ * its offset range. Those blocks are chained together, without further copy,
+ * when the datagram is delivered. Any error other than ERROR_MESSAGE_DISCARDED
+ * means that the whole datagram must be dropped
+ *
+ * @param[in] queue Pointer to the reassembly queue
+ * @param[in] desc Pointer to the datagram descriptor
+ * @param[in] buffer Multi-part buffer containing the fragment
+ * @param[in] headerOffset Offset to the header to be used for the reassembled
+ *   datagram
+ * @param[in] headerLen Length of the header (zero unless the fragment is the
+ *   one at offset zero)
+ * @param[in] dataOffset Offset to the data of the fragment
+ * @param[in] first Index of the first byte of the fragment
+ * @param[in] last Index immediately following the last byte of the fragment
+ * @param[in] more More fragments follow this one
+ * @return Error code
+ **/
+
+error_t ipReasmAddFragment(IpReasmQueue *queue, IpReasmDesc *desc,
+   const NetBuffer *buffer, size_t headerOffset, size_t headerLen,
+   size_t dataOffset, uint16_t first, uint16_t last, bool_t more)
+{
+   error_t error;
+   uint_t i;
+   uint_t n;
+   uint_t k;
+   size_t size;
+   size_t length;
+   uint16_t pos;
+
+   //The header is taken from the first copy of the fragment at offset zero
+   if(first != 0 || desc->header != NULL)
+   {
+      headerLen = 0;
+   }
+
+   //The size of the reconstructed datagram must not exceed the maximum value
+   if(last > queue->maxDatagramSize ||
+      (MAX(last, desc->dataLen) + desc->headerLen + headerLen) > queue->maxDatagramSize)
+   {
+      return ERROR_INVALID_LENGTH;
+   }
+
+   //The header must fit in a single memory block
+   if(headerLen > NET_MEM_POOL_BUFFER_SIZE)
+      return ERROR_INVALID_LENGTH;
+
+   //Check the consistency of the total length of the datagram
+   if(!more)
+   {
+      //The last fragment determines the length of the datagram
+      if(desc->lastReceived && last != desc->dataLen)
+         return ERROR_INVALID_PACKET;
+
+      //Some data has already been received beyond the end of the datagram?
+      if(last < desc->dataLen)
+         return ERROR_INVALID_PACKET;
+   }
+   else
+   {
+      //No data can follow the last fragment
+      if(desc->lastReceived && last > desc->dataLen)
+         return ERROR_INVALID_PACKET;
+   }
+
+   //Number of 8-byte blocks covered by the fragment
+   n = (last + 7) / 8 - first / 8;
+   //Number of those blocks that have already been received
+   k = ipReasmUpdateBitmap(desc, first, last, FALSE);
+
+   //Duplicate fragment?
+   if(k == n && (more || desc->lastReceived))
+      return ERROR_MESSAGE_DISCARDED;
+
+   //Overlapping fragments are not allowed by the upper protocol?
+   if(k > 0 && !queue->overlapAllowed)
+      return ERROR_INVALID_PACKET;
+
+   //Number of additional bytes held by the datagram
+   size = headerLen + (n - k) * 8;
+
+   //Evict older datagrams if necessary
+   error = ipReasmReserveMem(queue, desc, size);
+   //Not enough memory?
+   if(error)
+      return error;
+
+   //The very first fragment carries the header
+   if(headerLen > 0)
+   {
+      //Allocate a memory block to hold the header
+      desc->header = memPoolAlloc(NET_MEM_POOL_BUFFER_SIZE);
+      //Failed to allocate memory?
+      if(desc->header == NULL)
+         return ERROR_OUT_OF_MEMORY;
+
+      //Copy the header
+      netBufferRead(desc->header, buffer, headerOffset, headerLen);
+      desc->headerLen = headerLen;
+   }
+
+   //Copy the data of the fragment
+   for(pos = first; pos < last; pos += length)
+   {
+      //Index of the memory block that holds the current byte
+      i = pos / NET_MEM_POOL_BUFFER_SIZE;
+      //Number of bytes to copy in the current block
+      length = MIN(last - pos, (i + 1) * NET_MEM_POOL_BUFFER_SIZE - pos);
+
+      //The block may already have been allocated by another fragment
+      if(desc->blocks[i] == NULL)
+      {
+         //Allocate a memory block
+         desc->blocks[i] = memPoolAlloc(NET_MEM_POOL_BUFFER_SIZE);
+         //Failed to allocate memory?
+         if(desc->blocks[i] == NULL)
+            return ERROR_OUT_OF_MEMORY;
+      }
+
+      //Copy data
+      netBufferRead(desc->blocks[i] + pos % NET_MEM_POOL_BUFFER_SIZE,
+         buffer, dataOffset, length);
+
+      //Advance data pointer
+      dataOffset += length;
+   }
+
+   //Update the memory usage
+   desc->memSize += size;
+   queue->memSize += size;
+
+   //Mark the corresponding blocks as received
+   ipReasmUpdateBitmap(desc, first, last, TRUE);
+   //Update the number of blocks received so far
+   desc->blockCount += n - k;
+
+   //It may be necessary to increase the length of the payload
+   if(last > desc->dataLen)
+   {
+      desc->dataLen = last;
+   }
+
+   //The last fragment determines the length of the datagram
+   if(!more)
+   {
+      desc->lastReceived = TRUE;
+   }
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Check whether a datagram has been completely received
+ * @param[in] desc Pointer to the datagram descriptor
+ * @return TRUE if the reassembly process is complete, else FALSE
+ **/
+
+bool_t ipReasmIsComplete(const IpReasmDesc *desc)
+{
+   bool_t complete;
+
+   //The header, the last fragment and every block in between must have
+   //been received
+   if(desc->used && desc->header != NULL && desc->lastReceived &&
+      desc->blockCount == (desc->dataLen + 7) / 8)
+   {
+      complete = TRUE;
+   }
+   else
+   {
+      complete = FALSE;
+   }
+
+   //Return TRUE if the reassembly process is complete
+   return complete;
+}
+
+
+/**
+ * @brief Retrieve the reassembled datagram
+ *
+ * The memory blocks are chained together without copying them. If the
+ * datagram is not complete, the returned buffer contains the header followed
+ * by the data received contiguously from offset zero
+ *
+ * @param[in] queue Pointer to the reassembly queue
+ * @param[in] desc Pointer to the datagram descriptor
+ * @return Multi-part buffer describing the datagram, or NULL if the fragment
+ *   at offset zero has not been received yet
+ **/
+
+NetBuffer *ipReasmGetDatagram(IpReasmQueue *queue, IpReasmDesc *desc)
+{
+   uint_t i;
+   size_t n;
+   size_t pos;
+   size_t length;
+   NetBuffer *buffer;
+
+   //The header is taken from the fragment at offset zero
+   if(desc->header == NULL)
+      return NULL;
+
+   //Count the 8-byte blocks received contiguously from offset zero
+   for(i = 0; i < (desc->dataLen + 7) / 8; i++)
+   {
+      //Stop at the first hole
+      if((desc->bitmap[i / 32] & (1UL << (i % 32))) == 0)
+         break;
+   }
+
+   //Length of the data that can be chained
+   length = MIN(i * 8, desc->dataLen);
+
+   //Point to the buffer describing the reassembled datagram
+   buffer = queue->buffer;
+
+   //The first chunk contains the header
+   buffer->chunkCount = 1;
+   buffer->chunk[0].address = desc->header;
+   buffer->chunk[0].length = (uint16_t) desc->headerLen;
+   buffer->chunk[0].size = 0;
+
+   //Chain the memory blocks holding the payload
+   for(pos = 0; pos < length; pos += n)
+   {
+      //Index of the current memory block
+      i = pos / NET_MEM_POOL_BUFFER_SIZE;
+      //Number of bytes held by the current block
+      n = MIN(length - pos, NET_MEM_POOL_BUFFER_SIZE);
+
+      //Make sure the buffer can hold one more chunk
+      if(buffer->chunkCount >= buffer->maxChunkCount)
+         return NULL;
+
+      //Chain the block
+      buffer->chunk[buffer->chunkCount].address = desc->blocks[i];
+      buffer->chunk[buffer->chunkCount].length = (uint16_t) n;
+      buffer->chunk[buffer->chunkCount].size = 0;
+
+      //Update the number of chunks
+      buffer->chunkCount++;
+   }
+
+   //Return a pointer to the reassembled datagram
+   return buffer;
+}
+
+
+/**
+ * @brief Make sure the reassembly queue can hold additional data
+ *
+ * The oldest datagrams are dropped until the memory usage of the queue is
+ * below the limit
+ *
+ * @param[in] queue Pointer to the reassembly queue
+ * @param[in] desc Datagram that requires the memory
+ * @param[in] size Number of bytes
+ * @return Error code
+ **/
+
+error_t ipReasmReserveMem(IpReasmQueue *queue, IpReasmDesc *desc,
+   size_t size)
+{
+   uint_t i;
+   IpReasmDesc *oldestDesc;
+
+   //The datagram on its own cannot exceed the limit
+   if((desc->memSize + size) > queue->maxMemSize)
+      return ERROR_OUT_OF_MEMORY;
+
+   //Evict older datagrams as long as the limit is exceeded
+   while((queue->memSize + size) > queue->maxMemSize)
+   {
+      //Keep track of the oldest entry
+      oldestDesc = NULL;
+
+      //Loop through the datagram descriptors
+      for(i = 0; i < queue->size; i++)
+      {
+         //Only consider datagrams that hold memory
+         if(queue->table[i].used && queue->table[i].memSize > 0 &&
+            &queue->table[i] != desc)
+         {
+            //Keep track of the oldest entry
+            if(oldestDesc == NULL || timeCompare(queue->table[i].timestamp,
+               oldestDesc->timestamp) < 0)
+            {
+               oldestDesc = &queue->table[i];
+            }
+         }
+      }
+
+      //Sanity check
+      if(oldestDesc == NULL)
+         return ERROR_OUT_OF_MEMORY;
+
+      //Debug message
+      TRACE_INFO("Reassembly memory limit reached, dropping oldest datagram...\r\n");
+
+      //Drop the oldest datagram
+      ipReasmDeleteDesc(queue, oldestDesc);
+   }
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Compute the hash table index of a datagram identifier
+ * @param[in] key Datagram identifier
+ * @return Index of the hash bucket
+ **/
+
+uint_t ipReasmHashKey(const IpReasmKey *key)
+{
+   uint_t i;
+   uint32_t h;
+
+   //Start with the fields that vary the most between datagrams
+   h = key->identification ^ key->protocol;
+
+   //Mix the source and destination addresses
+   for(i = 0; i < 16; i++)
+   {
+      h = (h * 31) + (key->srcAddr[i] ^ key->destAddr[i]);
+   }
+
+   //Spread the bits evenly
+   h ^= h >> 16;
+   h *= 0x45D9F3BUL;
+   h ^= h >> 16;
+
+   //Return the index of the hash bucket
+   return h % IP_REASM_HASH_TABLE_SIZE;
+}
+
+
+/**
+ * @brief Update the coverage bitmap of a datagram
+ * @param[in] desc Pointer to the datagram descriptor
+ * @param[in] first Index of the first byte
+ * @param[in] last Index immediately following the last byte
+ * @param[in] update Mark the corresponding blocks as received
+ * @return Number of blocks that had already been received
+ **/
+
+uint_t ipReasmUpdateBitmap(IpReasmDesc *desc, uint16_t first, uint16_t last,
+   bool_t update)
+{
+   uint_t i;
+   uint_t n;
+   uint32_t mask;
+
+   //Number of blocks already received
+   n = 0;
+
+   //Each bit of the bitmap represents an 8-byte block
+   for(i = first / 8; i < (uint_t) (last + 7) / 8; i++)
+   {
+      //Compute the mask for the current block
+      mask = 1UL << (i % 32);
+
+      //Check whether the block has already been received
+      if((desc->bitmap[i / 32] & mask) != 0)
+      {
+         n++;
+      }
+      else if(update)
+      {
+         desc->bitmap[i / 32] |= mask;
+      }
+   }
+
+   //Return the number of blocks already received
+   return n;
+}
+
+
+/**
+ * @brief Dump the state of a datagram being reassembled
+ * @param[in] desc Pointer to the datagram descriptor
+ **/
+
+void ipReasmDumpDesc(const IpReasmDesc *desc)
+{
+   //Debug message
+   TRACE_DEBUG("Reassembly state (%" PRIuSIZE " bytes, %u blocks received, "
+      "%" PRIuSIZE " bytes held)\r\n", desc->dataLen, desc->blockCount,
+      desc->memSize);
+}
+
+#endif
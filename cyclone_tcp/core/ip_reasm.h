@@ -0,0 +1,144 @@
+/**
+ * @file ip_reasm.h
+ * @brief IP datagram reassembly engine
+ *
+ * @section License
+ *
+ * Copyright (C) 2010-2023 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneTCP Eval.
+ *
+ * This software is provided in source form for a short-term evaluation only. The
+ * evaluation license expires 90 days after the date you first download the software.
+ *
+ * If you plan to use this software in a commercial product, you are required to
+ * purchase a commercial license from Oryx Embedded SARL.
+ *
+ * After the 90-day evaluation period, you agree to either purchase a commercial
+ * license or delete all copies of this software. If you wish to extend the
+ * evaluation period, you must contact sales@oryx-embedded.com.
+ *
+ * This evaluation software is provided "as is" without warranty of any kind.
+ * Technical support is available as an option during the evaluation period.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.3.2
+ **/
+
+
+#ifndef _IP_REASM_H
+#define _IP_REASM_H
+
+//Dependencies
+#include "core/net.h"
+
+//Size of the hash table used to locate datagrams being reassembled
+#ifndef IP_REASM_HASH_TABLE_SIZE
+   #define IP_REASM_HASH_TABLE_SIZE 16
+#elif (IP_REASM_HASH_TABLE_SIZE < 1)
+   #error IP_REASM_HASH_TABLE_SIZE parameter is not valid
+#endif
+
+//Size of the coverage bitmap, in 32-bit words (one bit per 8-byte block)
+#define IP_REASM_BITMAP_SIZE(size) (((size) + 255) / 256)
+//Number of memory blocks spanned by the payload of a datagram
+#define IP_REASM_BLOCK_COUNT(size) N(size)
+//Number of chunks of a reassembled datagram (header and payload blocks)
+#define IP_REASM_CHUNK_COUNT(size) (N(size) + 1)
+
+//C++ guard
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * @brief Datagram identifier
+ **/
+
+typedef struct
+{
+   uint8_t srcAddr[16];     ///<Source address (network byte order)
+   uint8_t destAddr[16];    ///<Destination address (network byte order)
+   uint32_t identification; ///<Fragment identification field
+   uint8_t protocol;        ///<Protocol field (IPv4 only)
+} IpReasmKey;
+
+
+/**
+ * @brief Datagram being reassembled
+ *
+ * The payload is stored in memory blocks taken from the memory pool. The
+ * byte at a given offset always lands in block (offset / block size), so
+ * that small fragments share the same blocks
+ *
+ **/
+
+typedef struct _IpReasmDesc
+{
+   bool_t used;               ///<The entry is in use
+   IpReasmKey key;            ///<Datagram identifier
+   systime_t timestamp;       ///<Time at which the first fragment was received
+   uint8_t *header;           ///<Header taken from the fragment at offset zero
+   size_t headerLen;          ///<Length of the header
+   size_t dataLen;            ///<Length of the payload (known once the last fragment is received)
+   bool_t lastReceived;       ///<The last fragment has been received
+   uint_t blockCount;         ///<Number of 8-byte blocks received so far
+   size_t memSize;            ///<Number of bytes held by the datagram
+   uint32_t *bitmap;          ///<Coverage bitmap
+   uint8_t **blocks;          ///<Memory blocks holding the payload
+   struct _IpReasmDesc *next; ///<Next entry in the hash chain
+} IpReasmDesc;
+
+
+/**
+ * @brief Reassembly queue
+ **/
+
+typedef struct
+{
+   IpReasmDesc *table;                               ///<Datagram descriptors
+   uint_t size;                                      ///<Number of descriptors
+   size_t maxDatagramSize;                           ///<Maximum size of a reassembled datagram
+   uint_t bitmapSize;                                ///<Size of the coverage bitmaps, in 32-bit words
+   uint_t blockTableSize;                            ///<Number of memory blocks a datagram can span
+   size_t maxMemSize;                                ///<Maximum number of bytes held by the queue
+   size_t memSize;                                   ///<Number of bytes currently held
+   bool_t overlapAllowed;                            ///<Accept overlapping fragments
+   IpReasmDesc *hashTable[IP_REASM_HASH_TABLE_SIZE]; ///<Hash table
+   NetBuffer *buffer;                                ///<Buffer describing the reassembled datagram
+} IpReasmQueue;
+
+
+//IP reassembly related functions
+void ipReasmInit(IpReasmQueue *queue, IpReasmDesc *table, uint32_t *bitmaps,
+   uint8_t **blocks, NetBuffer *buffer, uint_t size, size_t maxDatagramSize,
+   size_t maxMemSize, bool_t overlapAllowed);
+
+void ipReasmFlush(IpReasmQueue *queue);
+
+IpReasmDesc *ipReasmFindDesc(IpReasmQueue *queue, const IpReasmKey *key);
+void ipReasmDeleteDesc(IpReasmQueue *queue, IpReasmDesc *desc);
+
+error_t ipReasmAddFragment(IpReasmQueue *queue, IpReasmDesc *desc,
+   const NetBuffer *buffer, size_t headerOffset, size_t headerLen,
+   size_t dataOffset, uint16_t first, uint16_t last, bool_t more);
+
+bool_t ipReasmIsComplete(const IpReasmDesc *desc);
+NetBuffer *ipReasmGetDatagram(IpReasmQueue *queue, IpReasmDesc *desc);
+
+error_t ipReasmReserveMem(IpReasmQueue *queue, IpReasmDesc *desc,
+   size_t size);
+
+uint_t ipReasmHashKey(const IpReasmKey *key);
+uint_t ipReasmUpdateBitmap(IpReasmDesc *desc, uint16_t first, uint16_t last,
+   bool_t update);
+
+void ipReasmDumpDesc(const IpReasmDesc *desc);
+
+//C++ guard
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,456 @@
+/**
+ * @file ip_trie.c
+ * @brief Path-compressed binary trie for longest prefix match
+ *
+ * @section License
+ *
+ * Copyright (C) 2010-2023 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneTCP Eval.
+ *
+ * This software is provided in source form for a short-term evaluation only. The
+ * evaluation license expires 90 days after the date you first download the software.
+ *
+ * If you plan to use this software in a commercial product, you are required to
+ * purchase a commercial license from Oryx Embedded SARL.
+ *
+ * After the 90-day evaluation period, you agree to either purchase a commercial
+ * license or delete all copies of this software. If you wish to extend the
+ * evaluation period, you must contact sales@oryx-embedded.com.
+ *
+ * This evaluation software is provided "as is" without warranty of any kind.
+ * Technical support is available as an option during the evaluation period.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.3.2
+ **/
+
+
+//Switch to the appropriate trace level
+#define TRACE_LEVEL IP_TRACE_LEVEL
+
+//Dependencies
+#include "core/net.h"
+#include "core/ip_trie.h"
+#include "ipv4/ipv4_routing.h"
+#include "ipv6/ipv6_routing.h"
+#include "debug.h"
+
+//Check TCP/IP stack configuration
+#if ((IPV4_SUPPORT == ENABLED && IPV4_ROUTING_SUPPORT == ENABLED) || \
+   (IPV6_SUPPORT == ENABLED && IPV6_ROUTING_SUPPORT == ENABLED))
+
+
+/**
+ * @brief Initialize a trie
+ * @param[in] trie Pointer to the trie
+ * @param[in] nodes Pool of nodes used by the trie. A trie holding N prefixes
+ *   requires at most 2N - 1 nodes
+ * @param[in] numNodes Number of nodes in the pool
+ **/
+
+void ipTrieInit(IpTrie *trie, IpTrieNode *nodes, uint_t numNodes)
+{
+   //Attach the pool of nodes
+   trie->nodes = nodes;
+   trie->numNodes = numNodes;
+
+   //The trie is initially empty
+   ipTrieFlush(trie);
+}
+
+
+/**
+ * @brief Remove all the prefixes from a trie
+ * @param[in] trie Pointer to the trie
+ **/
+
+void ipTrieFlush(IpTrie *trie)
+{
+   //Release all the nodes
+   osMemset(trie->nodes, 0, trie->numNodes * sizeof(IpTrieNode));
+   //Empty trie
+   trie->root = NULL;
+}
+
+
+/**
+ * @brief Bind a value to the specified prefix
+ * @param[in] trie Pointer to the trie
+ * @param[in] prefix Prefix (network byte order)
+ * @param[in] prefixLen Length of the prefix, in bits
+ * @param[in] value Value to be bound to the prefix
+ * @return Error code
+ **/
+
+error_t ipTrieInsert(IpTrie *trie, const uint8_t *prefix, uint_t prefixLen,
+   void *value)
+{
+   uint_t n;
+   IpTrieNode *node;
+   IpTrieNode *leaf;
+   IpTrieNode *branch;
+   IpTrieNode **p;
+
+   //Check parameters
+   if(prefix == NULL || prefixLen > (IP_TRIE_MAX_KEY_SIZE * 8) || value == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Start from the root node
+   p = &trie->root;
+
+   //Walk down the trie
+   while(*p != NULL)
+   {
+      //Point to the current node
+      node = *p;
+
+      //Determine the number of leading bits shared by the prefix and the
+      //current node
+      n = ipTrieCompKeys(prefix, node->key, MIN(prefixLen, node->keyLen));
+
+      //The current node is not a prefix of the specified prefix?
+      if(n < node->keyLen)
+      {
+         //Create a new node for the specified prefix
+         leaf = ipTrieAllocNode(trie, prefix, prefixLen, value);
+         //Failed to allocate a node?
+         if(leaf == NULL)
+            return ERROR_OUT_OF_RESOURCES;
+
+         //Check whether the specified prefix is a prefix of the current node
+         if(n == prefixLen)
+         {
+            //The current node becomes a child of the new node
+            leaf->child[ipTrieGetBit(node->key, n)] = node;
+         }
+         else
+         {
+            //Both prefixes diverge at bit n, so a branching node is required
+            branch = ipTrieAllocNode(trie, prefix, n, NULL);
+
+            //Failed to allocate a node?
+            if(branch == NULL)
+            {
+               //Clean up side effects
+               ipTrieFreeNode(leaf);
+               //Report an error
+               return ERROR_OUT_OF_RESOURCES;
+            }
+
+            //Attach both nodes to the branching node
+            branch->child[ipTrieGetBit(prefix, n)] = leaf;
+            branch->child[ipTrieGetBit(node->key, n)] = node;
+
+            //The branching node replaces the current node
+            leaf = branch;
+         }
+
+         //Link the new node to its parent
+         *p = leaf;
+
+         //Successful processing
+         return NO_ERROR;
+      }
+
+      //Exact match?
+      if(node->keyLen == prefixLen)
+      {
+         //Bind the value to the prefix
+         node->value = value;
+
+         //Successful processing
+         return NO_ERROR;
+      }
+
+      //Select the child node according to the next bit of the prefix
+      p = &node->child[ipTrieGetBit(prefix, node->keyLen)];
+   }
+
+   //Create a new node for the specified prefix
+   leaf = ipTrieAllocNode(trie, prefix, prefixLen, value);
+   //Failed to allocate a node?
+   if(leaf == NULL)
+      return ERROR_OUT_OF_RESOURCES;
+
+   //Link the new node to its parent
+   *p = leaf;
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Remove the value bound to the specified prefix
+ * @param[in] trie Pointer to the trie
+ * @param[in] prefix Prefix (network byte order)
+ * @param[in] prefixLen Length of the prefix, in bits
+ * @return Error code
+ **/
+
+error_t ipTrieDelete(IpTrie *trie, const uint8_t *prefix, uint_t prefixLen)
+{
+   uint_t n;
+   IpTrieNode *node;
+   IpTrieNode *parent;
+   IpTrieNode **p;
+   IpTrieNode **q;
+
+   //Check parameters
+   if(prefix == NULL || prefixLen > (IP_TRIE_MAX_KEY_SIZE * 8))
+      return ERROR_INVALID_PARAMETER;
+
+   //Start from the root node
+   parent = NULL;
+   p = &trie->root;
+   q = NULL;
+
+   //Walk down the trie
+   while(*p != NULL)
+   {
+      //Point to the current node
+      node = *p;
+
+      //Check whether the current node is a prefix of the specified prefix
+      if(node->keyLen > prefixLen)
+         break;
+
+      //Compare the leading bits
+      n = ipTrieCompKeys(prefix, node->key, node->keyLen);
+      //Mismatch?
+      if(n < node->keyLen)
+         break;
+
+      //Exact match?
+      if(node->keyLen == prefixLen)
+      {
+         //Branching nodes do not hold any prefix
+         if(node->value == NULL)
+            break;
+
+         //Unbind the value
+         node->value = NULL;
+
+         //Check the number of child nodes
+         if(node->child[0] != NULL && node->child[1] != NULL)
+         {
+            //The node is kept as a branching node
+         }
+         else if(node->child[0] != NULL || node->child[1] != NULL)
+         {
+            //The single child node replaces the current node
+            *p = (node->child[0] != NULL) ? node->child[0] : node->child[1];
+            //Release the current node
+            ipTrieFreeNode(node);
+         }
+         else
+         {
+            //Remove the leaf node
+            *p = NULL;
+            ipTrieFreeNode(node);
+
+            //A branching node with a single child node is no longer required
+            if(parent != NULL && parent->value == NULL)
+            {
+               //The remaining child node replaces its parent
+               *q = (parent->child[0] != NULL) ? parent->child[0] :
+                  parent->child[1];
+
+               //Release the branching node
+               ipTrieFreeNode(parent);
+            }
+         }
+
+         //Successful processing
+         return NO_ERROR;
+      }
+
+      //Keep track of the parent node
+      parent = node;
+      q = p;
+
+      //Select the child node according to the next bit of the prefix
+      p = &node->child[ipTrieGetBit(prefix, node->keyLen)];
+   }
+
+   //The specified prefix does not exist
+   return ERROR_NOT_FOUND;
+}
+
+
+/**
+ * @brief Longest prefix match
+ * @param[in] trie Pointer to the trie
+ * @param[in] addr Address to look up (network byte order)
+ * @param[in] addrLen Length of the address, in bits
+ * @param[in] filter Optional callback used to discard unusable entries
+ * @return Value bound to the longest matching prefix, if any
+ **/
+
+void *ipTrieLookup(const IpTrie *trie, const uint8_t *addr, uint_t addrLen,
+   IpTrieFilter filter)
+{
+   void *value;
+   const IpTrieNode *node;
+
+   //Initialize value
+   value = NULL;
+
+   //Walk down the trie from the root node
+   for(node = trie->root; node != NULL; )
+   {
+      //Path compression skips bits, so make sure the prefix of the current
+      //node actually matches the address
+      if(node->keyLen > addrLen ||
+         ipTrieCompKeys(addr, node->key, node->keyLen) < node->keyLen)
+      {
+         break;
+      }
+
+      //Any value bound to the current prefix?
+      if(node->value != NULL)
+      {
+         //The deeper the node, the more specific the route
+         if(filter == NULL || filter(node->value))
+            value = node->value;
+      }
+
+      //End of the address?
+      if(node->keyLen >= addrLen)
+         break;
+
+      //Select the child node according to the next bit of the address
+      node = node->child[ipTrieGetBit(addr, node->keyLen)];
+   }
+
+   //Return the value bound to the longest matching prefix
+   return value;
+}
+
+
+/**
+ * @brief Allocate a new node
+ * @param[in] trie Pointer to the trie
+ * @param[in] prefix Prefix (network byte order)
+ * @param[in] prefixLen Length of the prefix, in bits
+ * @param[in] value Value to be bound to the prefix
+ * @return Pointer to the newly allocated node
+ **/
+
+IpTrieNode *ipTrieAllocNode(IpTrie *trie, const uint8_t *prefix,
+   uint_t prefixLen, void *value)
+{
+   uint_t i;
+   uint_t n;
+   IpTrieNode *node;
+
+   //Loop through the pool of nodes
+   for(i = 0; i < trie->numNodes; i++)
+   {
+      //Point to the current node
+      node = &trie->nodes[i];
+
+      //Free node?
+      if(!node->used)
+      {
+         //Clear node
+         osMemset(node, 0, sizeof(IpTrieNode));
+
+         //Number of bytes spanned by the prefix
+         n = (prefixLen + 7) / 8;
+         //Copy the prefix
+         osMemcpy(node->key, prefix, n);
+
+         //Clear the trailing bits of the last byte
+         if((prefixLen % 8) != 0)
+         {
+            node->key[n - 1] &= (uint8_t) (0xFF << (8 - (prefixLen % 8)));
+         }
+
+         //Save the length of the prefix
+         node->keyLen = prefixLen;
+         //Bind the value to the prefix
+         node->value = value;
+         //The node is now in use
+         node->used = TRUE;
+
+         //Return a pointer to the node
+         return node;
+      }
+   }
+
+   //The pool of nodes is exhausted
+   return NULL;
+}
+
+
+/**
+ * @brief Release a node
+ * @param[in] node Pointer to the node
+ **/
+
+void ipTrieFreeNode(IpTrieNode *node)
+{
+   //Mark the node as free
+   node->used = FALSE;
+   node->value = NULL;
+   node->child[0] = NULL;
+   node->child[1] = NULL;
+}
+
+
+/**
+ * @brief Get the value of a given bit
+ * @param[in] key Pointer to the key (network byte order)
+ * @param[in] n Bit position (0 is the most significant bit)
+ * @return Bit value
+ **/
+
+uint_t ipTrieGetBit(const uint8_t *key, uint_t n)
+{
+   //Extract the specified bit
+   return (key[n / 8] >> (7 - (n % 8))) & 0x01;
+}
+
+
+/**
+ * @brief Determine the number of leading bits shared by two keys
+ * @param[in] key1 Pointer to the first key
+ * @param[in] key2 Pointer to the second key
+ * @param[in] length Maximum number of bits to compare
+ * @return Length of the common prefix, in bits
+ **/
+
+uint_t ipTrieCompKeys(const uint8_t *key1, const uint8_t *key2, uint_t length)
+{
+   uint_t i;
+   uint_t n;
+   uint8_t x;
+
+   //Compare whole bytes first
+   for(i = 0, n = 0; n < length; i++, n += 8)
+   {
+      //Compare the current bytes
+      x = key1[i] ^ key2[i];
+
+      //Mismatch?
+      if(x != 0)
+      {
+         //Count the leading bits that match
+         while((x & 0x80) == 0)
+         {
+            x <<= 1;
+            n++;
+         }
+
+         //Exit immediately
+         break;
+      }
+   }
+
+   //The common prefix cannot exceed the specified length
+   return MIN(n, length);
+}
+
+#endif
@@ -0,0 +1,106 @@
+/**
+ * @file ip_trie.h
+ * @brief Path-compressed binary trie for longest prefix match
+ *
+ * @section License
+ *
+ * Copyright (C) 2010-2023 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneTCP Eval.
+ *
+ * This software is provided in source form for a short-term evaluation only. The
+ * evaluation license expires 90 days after the date you first download the software.
+ *
+ * If you plan to use this software in a commercial product, you are required to
+ * purchase a commercial license from Oryx Embedded SARL.
+ *
+ * After the 90-day evaluation period, you agree to either purchase a commercial
+ * license or delete all copies of this software. If you wish to extend the
+ * evaluation period, you must contact sales@oryx-embedded.com.
+ *
+ * This evaluation software is provided "as is" without warranty of any kind.
+ * Technical support is available as an option during the evaluation period.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.3.2
+ **/
+
+
+#ifndef _IP_TRIE_H
+#define _IP_TRIE_H
+
+//Dependencies
+#include "core/net.h"
+
+//Maximum length of the keys stored in a trie, in bytes
+#if (IPV6_SUPPORT == ENABLED)
+   #define IP_TRIE_MAX_KEY_SIZE 16
+#else
+   #define IP_TRIE_MAX_KEY_SIZE 4
+#endif
+
+//C++ guard
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * @brief Route filtering callback
+ **/
+
+typedef bool_t (*IpTrieFilter)(const void *value);
+
+
+/**
+ * @brief Trie node
+ **/
+
+typedef struct _IpTrieNode
+{
+   bool_t used;                           ///<The node is in use
+   uint8_t key[IP_TRIE_MAX_KEY_SIZE];     ///<Prefix (network byte order)
+   uint_t keyLen;                         ///<Length of the prefix, in bits
+   void *value;                           ///<Value bound to the prefix (NULL for branching nodes)
+   struct _IpTrieNode *child[2];          ///<Child nodes
+} IpTrieNode;
+
+
+/**
+ * @brief Trie
+ **/
+
+typedef struct
+{
+   IpTrieNode *root;   ///<Root node
+   IpTrieNode *nodes;  ///<Pool of nodes
+   uint_t numNodes;    ///<Number of nodes in the pool
+} IpTrie;
+
+
+//Trie related functions
+void ipTrieInit(IpTrie *trie, IpTrieNode *nodes, uint_t numNodes);
+void ipTrieFlush(IpTrie *trie);
+
+error_t ipTrieInsert(IpTrie *trie, const uint8_t *prefix, uint_t prefixLen,
+   void *value);
+
+error_t ipTrieDelete(IpTrie *trie, const uint8_t *prefix, uint_t prefixLen);
+
+void *ipTrieLookup(const IpTrie *trie, const uint8_t *addr, uint_t addrLen,
+   IpTrieFilter filter);
+
+IpTrieNode *ipTrieAllocNode(IpTrie *trie, const uint8_t *prefix,
+   uint_t prefixLen, void *value);
+
+void ipTrieFreeNode(IpTrieNode *node);
+
+uint_t ipTrieGetBit(const uint8_t *key, uint_t n);
+uint_t ipTrieCompKeys(const uint8_t *key1, const uint8_t *key2, uint_t length);
+
+//C++ guard
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -185,6 +185,10 @@ error_t netInitEx(NetContext *context, const NetSettings *settings)
 #if (TCP_SUPPORT == ENABLED)
       //Default TCP initial retransmission timeout
       interface->initialRto = TCP_INITIAL_RTO;
+#endif
+#if (NET_IF_CONTEXT_SUPPORT == ENABLED)
+      //The per-interface task is not running yet
+      interface->ifContext.taskId = OS_INVALID_TASK_ID;
 #endif
    }
 
@@ -1208,6 +1212,11 @@ error_t netConfigInterface(NetInterface *interface)
    //Get exclusive access
    osAcquireMutex(&netMutex);
 
+#if (NET_IF_CONTEXT_SUPPORT == ENABLED)
+   //Get exclusive access to the NIC driver
+   netIfContextLock(interface);
+#endif
+
    //Disable hardware interrupts
    if(interface->nicDriver != NULL)
       interface->nicDriver->disableIrq(interface);
@@ -1215,15 +1224,29 @@ error_t netConfigInterface(NetInterface *interface)
    //Start of exception handling block
    do
    {
-      //Receive notifications when the transmitter is ready to send
-      if(!osCreateEvent(&interface->nicTxEvent))
+#if (NET_IF_CONTEXT_SUPPORT == ENABLED)
+      //The per-interface task waits for the transmitter to be ready to send
+      if(!interface->ifContext.running)
+#endif
       {
-         //Failed to create event object
-         error = ERROR_OUT_OF_RESOURCES;
-         //Stop immediately
-         break;
+         //Receive notifications when the transmitter is ready to send
+         if(!osCreateEvent(&interface->nicTxEvent))
+         {
+            //Failed to create event object
+            error = ERROR_OUT_OF_RESOURCES;
+            //Stop immediately
+            break;
+         }
       }
 
+#if (NET_IF_CONTEXT_SUPPORT == ENABLED)
+      //Initialize the processing context of the interface
+      error = netIfContextInit(interface);
+      //Any error to report?
+      if(error)
+         break;
+#endif
+
       //Valid NIC driver?
       if(interface->nicDriver != NULL)
       {
@@ -1364,11 +1387,27 @@ error_t netConfigInterface(NetInterface *interface)
          if(interface->nicDriver != NULL)
             interface->nicDriver->enableIrq(interface);
       }
+
+#if (NET_IF_CONTEXT_SUPPORT == ENABLED)
+      //Release exclusive access to the NIC driver
+      netIfContextUnlock(interface);
+      //Offload the NIC driver to a dedicated task
+      error = netIfContextStart(interface);
+#endif
    }
    else
    {
-      //Clean up side effects before returning
-      osDeleteEvent(&interface->nicTxEvent);
+#if (NET_IF_CONTEXT_SUPPORT == ENABLED)
+      //Release exclusive access to the NIC driver
+      netIfContextUnlock(interface);
+
+      //The event object is still used by the per-interface task
+      if(!interface->ifContext.running)
+#endif
+      {
+         //Clean up side effects before returning
+         osDeleteEvent(&interface->nicTxEvent);
+      }
    }
 
    //Release exclusive access
@@ -1487,6 +1526,11 @@ error_t netStopInterface(NetInterface *interface)
       //Process link state change event
       netProcessLinkChange(interface);
 
+#if (NET_IF_CONTEXT_SUPPORT == ENABLED)
+      //Get exclusive access to the NIC driver
+      netIfContextLock(interface);
+#endif
+
       //Disable hardware interrupts
       if(interface->nicDriver != NULL)
          interface->nicDriver->disableIrq(interface);
@@ -1494,6 +1538,11 @@ error_t netStopInterface(NetInterface *interface)
       //Disable network interface
       interface->configured = FALSE;
 
+#if (NET_IF_CONTEXT_SUPPORT == ENABLED)
+      //Release exclusive access to the NIC driver
+      netIfContextUnlock(interface);
+#endif
+
       //Virtual interface?
       if(interface != physicalInterface)
       {
@@ -1539,6 +1588,9 @@ void netTaskEx(NetContext *context)
    systime_t time;
    systime_t timeout;
    NetInterface *interface;
+#if (NET_LATENCY_SUPPORT == ENABLED)
+   uint32_t timestamp;
+#endif
 
 #if (NET_RTOS_SUPPORT == ENABLED)
    //Task prologue
@@ -1612,12 +1664,32 @@ void netTaskEx(NetContext *context)
                //Valid NIC driver?
                if(interface->nicDriver != NULL)
                {
+#if (NET_IF_CONTEXT_SUPPORT == ENABLED)
+                  //Get exclusive access to the NIC driver
+                  netIfContextLock(interface);
+#endif
+#if (NET_LATENCY_SUPPORT == ENABLED)
+                  //Start measuring the time spent servicing the event
+                  timestamp = netLatencyGetTimestamp();
+#endif
                   //Disable hardware interrupts
                   interface->nicDriver->disableIrq(interface);
+                  //Pull received frames in bursts, if supported by the driver
+                  if(interface->nicDriver->rxBurst != NULL)
+                     nicReceiveBurst(interface);
                   //Handle NIC events
                   interface->nicDriver->eventHandler(interface);
+#if (NET_LATENCY_SUPPORT == ENABLED)
+                  //Record the service time of the NIC event
+                  netLatencyCheckpoint(interface, NET_LATENCY_STAGE_NIC_EVENT,
+                     &timestamp);
+#endif
                   //Re-enable hardware interrupts
                   interface->nicDriver->enableIrq(interface);
+#if (NET_IF_CONTEXT_SUPPORT == ENABLED)
+                  //Release exclusive access to the NIC driver
+                  netIfContextUnlock(interface);
+#endif
                }
             }
 
@@ -1631,6 +1703,10 @@ void netTaskEx(NetContext *context)
                //Valid NIC driver?
                if(interface->nicDriver != NULL)
                {
+#if (NET_IF_CONTEXT_SUPPORT == ENABLED)
+                  //Get exclusive access to the NIC driver
+                  netIfContextLock(interface);
+#endif
                   //Disable hardware interrupts
                   interface->nicDriver->disableIrq(interface);
 
@@ -1652,6 +1728,10 @@ void netTaskEx(NetContext *context)
 
                   //Re-enable hardware interrupts
                   interface->nicDriver->enableIrq(interface);
+#if (NET_IF_CONTEXT_SUPPORT == ENABLED)
+                  //Release exclusive access to the NIC driver
+                  netIfContextUnlock(interface);
+#endif
                }
             }
 #endif
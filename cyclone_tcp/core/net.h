@@ -39,6 +39,8 @@ struct _NetInterface;
 #include "core/net_mem.h"
 #include "core/net_misc.h"
 #include "core/nic.h"
+#include "core/net_if_context.h"
+#include "core/net_latency.h"
 #include "core/ethernet.h"
 #include "ipv4/ipv4.h"
 #include "ipv4/ipv4_frag.h"
@@ -193,6 +195,9 @@ struct _NetInterface
    NicDuplexMode duplexMode;                      ///<Duplex mode
    bool_t configured;                             ///<Configuration done
    systime_t initialRto;                          ///<TCP initial retransmission timeout
+#if (NET_IF_CONTEXT_SUPPORT == ENABLED)
+   NetIfContext ifContext;                        ///<Per-interface processing context
+#endif
 
 #if (ETH_SUPPORT == ENABLED)
    const PhyDriver *phyDriver;                    ///<Ethernet PHY driver
@@ -228,6 +233,11 @@ struct _NetInterface
 #if (ETH_SUPPORT == ENABLED)
    bool_t enableArp;                              ///<Enable address resolution using ARP
    ArpCacheEntry arpCache[ARP_CACHE_SIZE];        ///<ARP cache
+#if (ARP_CACHE_HASH_SUPPORT == ENABLED)
+   ArpCacheEntry *arpHashTable[ARP_HASH_TABLE_SIZE]; ///<Hash table indexing the ARP cache
+   ArpCacheEntry *arpLruHead;                     ///<Most recently used ARP cache entry
+   ArpCacheEntry *arpLruTail;                     ///<Least recently used ARP cache entry
+#endif
 #endif
 #if (IGMP_HOST_SUPPORT == ENABLED)
    IgmpHostContext igmpHostContext;               ///<IGMP host context
@@ -276,6 +286,10 @@ struct _NetInterface
 #if (PPP_SUPPORT == ENABLED)
    PppContext *pppContext;                        ///<PPP context
 #endif
+
+#if (NET_LATENCY_SUPPORT == ENABLED)
+   NetLatencyHistogram latencyStats[NET_LATENCY_STAGE_COUNT]; ///<Packet path latency histograms
+#endif
 };
 
 
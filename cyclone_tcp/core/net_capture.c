@@ -0,0 +1,788 @@
+/**
+ * @file net_capture.c
+ * @brief In-stack packet capture (pcapng ring buffer)
+ *
+ * @section License
+ *
+ * Copyright (C) 2010-2023 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneTCP Eval.
+ *
+ * This software is provided in source form for a short-term evaluation only. The
+ * evaluation license expires 90 days after the date you first download the software.
+ *
+ * If you plan to use this software in a commercial product, you are required to
+ * purchase a commercial license from Oryx Embedded SARL.
+ *
+ * After the 90-day evaluation period, you agree to either purchase a commercial
+ * license or delete all copies of this software. If you wish to extend the
+ * evaluation period, you must contact sales@oryx-embedded.com.
+ *
+ * This evaluation software is provided "as is" without warranty of any kind.
+ * Technical support is available as an option during the evaluation period.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.3.2
+ **/
+
+//Switch to the appropriate trace level
+#define TRACE_LEVEL NIC_TRACE_LEVEL
+
+//Dependencies
+#include "core/net.h"
+#include "core/socket.h"
+#include "core/net_capture.h"
+#include "debug.h"
+
+//Check TCP/IP stack configuration
+#if (NET_CAPTURE_SUPPORT == ENABLED)
+
+//Capture context
+NetCaptureContext netCaptureContext;
+
+
+/**
+ * @brief Store a 32-bit value in host byte order
+ * @param[out] p Destination address
+ * @param[in] value 32-bit value to store
+ **/
+
+static void netCaptureStore32(uint8_t *p, uint32_t value)
+{
+   //pcapng blocks are written in the byte order of the writer
+   osMemcpy(p, &value, sizeof(uint32_t));
+}
+
+
+/**
+ * @brief Store a 16-bit value in host byte order
+ * @param[out] p Destination address
+ * @param[in] value 16-bit value to store
+ **/
+
+static void netCaptureStore16(uint8_t *p, uint16_t value)
+{
+   //pcapng blocks are written in the byte order of the writer
+   osMemcpy(p, &value, sizeof(uint16_t));
+}
+
+
+/**
+ * @brief Format the pcapng file header
+ *
+ * The header is made of a section header block followed by one interface
+ * description block per network interface, so that the interface ID of a
+ * captured frame matches the index of the underlying network interface
+ *
+ * @return Length of the header
+ **/
+
+static size_t netCaptureFormatHeader(void)
+{
+   uint_t i;
+   size_t n;
+   size_t p;
+   size_t length;
+   uint16_t linkType;
+   uint8_t *header;
+   NetInterface *interface;
+
+   //Point to the header buffer
+   header = netCaptureContext.header;
+
+   //Format section header block
+   netCaptureStore32(header, PCAPNG_BLOCK_TYPE_SHB);
+   netCaptureStore32(header + 4, NET_CAPTURE_SHB_SIZE);
+   netCaptureStore32(header + 8, 0x1A2B3C4D);
+   netCaptureStore16(header + 12, 1);
+   netCaptureStore16(header + 14, 0);
+
+   //The section length is not specified
+   osMemset(header + 16, 0xFF, 8);
+   netCaptureStore32(header + 24, NET_CAPTURE_SHB_SIZE);
+
+   //Length of the header
+   length = NET_CAPTURE_SHB_SIZE;
+
+   //Loop through network interfaces
+   for(i = 0; i < NET_INTERFACE_COUNT; i++)
+   {
+      //Point to the current interface
+      interface = &netInterface[i];
+
+      //Select the link type that matches the framing used by the NIC
+      if(interface->nicDriver == NULL)
+      {
+         linkType = PCAPNG_LINK_TYPE_RAW;
+      }
+      else if(interface->nicDriver->type == NIC_TYPE_ETHERNET)
+      {
+         linkType = PCAPNG_LINK_TYPE_ETHERNET;
+      }
+      else if(interface->nicDriver->type == NIC_TYPE_PPP)
+      {
+         linkType = PCAPNG_LINK_TYPE_PPP_HDLC;
+      }
+      else
+      {
+         linkType = PCAPNG_LINK_TYPE_RAW;
+      }
+
+      //Point to the current interface description block
+      p = length;
+
+      //Format the fixed part of the block
+      netCaptureStore32(header + p, PCAPNG_BLOCK_TYPE_IDB);
+      netCaptureStore16(header + p + 8, linkType);
+      netCaptureStore16(header + p + 10, 0);
+      netCaptureStore32(header + p + 12, NET_CAPTURE_SNAP_LEN);
+      p += 16;
+
+      //Retrieve the length of the interface name
+      n = osStrlen(interface->name);
+      n = MIN(n, NET_MAX_IF_NAME_LEN);
+
+      //Add if_name option
+      netCaptureStore16(header + p, 2);
+      netCaptureStore16(header + p + 2, (uint16_t) n);
+      osMemset(header + p + 4, 0, (n + 3) & ~3U);
+      osMemcpy(header + p + 4, interface->name, n);
+      p += 4 + ((n + 3) & ~3U);
+
+      //Add if_tsresol option (time stamps are expressed in microseconds)
+      netCaptureStore16(header + p, 9);
+      netCaptureStore16(header + p + 2, 1);
+      netCaptureStore32(header + p + 4, 0);
+      header[p + 4] = 6;
+      p += 8;
+
+      //Add opt_endofopt option
+      netCaptureStore32(header + p, 0);
+      p += 4;
+
+      //Fix the total length of the block
+      netCaptureStore32(header + length + 4, (uint32_t) (p + 4 - length));
+      netCaptureStore32(header + p, (uint32_t) (p + 4 - length));
+
+      //Next block
+      length = p + 4;
+   }
+
+   //Return the length of the header
+   return length;
+}
+
+
+/**
+ * @brief Start capturing frames
+ *
+ * Any frame left in the ring from a previous capture is discarded. The
+ * capture must not be restarted while the ring is being drained
+ *
+ * @param[in] filter Capture filter (NULL to capture every frame)
+ * @return Error code
+ **/
+
+error_t netCaptureStart(const NetCaptureFilter *filter)
+{
+   //Get exclusive access
+   osAcquireMutex(&netMutex);
+
+   //Suspend the capture while the context is being reinitialized
+   netCaptureContext.running = FALSE;
+
+   //Save the capture filter
+   if(filter != NULL)
+   {
+      netCaptureContext.filter = *filter;
+   }
+   else
+   {
+      osMemset(&netCaptureContext.filter, 0, sizeof(NetCaptureFilter));
+   }
+
+   //Clear statistics
+   osMemset(&netCaptureContext.stats, 0, sizeof(NetCaptureStats));
+
+   //The pcapng file header is returned first by the read function
+   netCaptureContext.headerLen = netCaptureFormatHeader();
+   netCaptureContext.headerPos = 0;
+
+   //Flush the ring
+   netCaptureContext.head = 0;
+   netCaptureContext.tail = 0;
+
+   //Make sure the context is consistent before enabling the tap
+   netCaptureBarrier();
+   netCaptureContext.running = TRUE;
+
+   //Release exclusive access
+   osReleaseMutex(&netMutex);
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Stop capturing frames
+ *
+ * The frames that are still in the ring can be drained afterwards
+ *
+ * @return Error code
+ **/
+
+error_t netCaptureStop(void)
+{
+   //Get exclusive access
+   osAcquireMutex(&netMutex);
+   //Disable the tap
+   netCaptureContext.running = FALSE;
+   //Release exclusive access
+   osReleaseMutex(&netMutex);
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Check whether a frame matches the capture filter
+ * @param[in] interface Underlying network interface
+ * @param[in] frame Captured bytes
+ * @param[in] length Number of captured bytes
+ * @return TRUE if the frame is to be captured, else FALSE
+ **/
+
+static bool_t netCaptureMatchFilter(NetInterface *interface,
+   const uint8_t *frame, size_t length)
+{
+   uint_t version;
+   uint8_t protocol;
+   uint16_t type;
+   size_t offset;
+   bool_t fragment;
+   NetCaptureFilter *filter;
+
+   //Point to the capture filter
+   filter = &netCaptureContext.filter;
+
+   //Filter on the underlying network interface
+   if(filter->interface != NULL && filter->interface != interface)
+      return FALSE;
+
+   //No filtering on the contents of the frame?
+   if(filter->protocol == 0 && filter->port == 0)
+      return TRUE;
+
+   //Ethernet interface?
+   if(interface->nicDriver != NULL &&
+      interface->nicDriver->type == NIC_TYPE_ETHERNET)
+   {
+      //Malformed Ethernet frame?
+      if(length < 14)
+         return FALSE;
+
+      //Retrieve the EtherType
+      type = LOAD16BE(frame + 12);
+      offset = 14;
+
+      //Skip VLAN tags
+      while(type == ETH_TYPE_VLAN && length >= (offset + 4))
+      {
+         type = LOAD16BE(frame + offset + 2);
+         offset += 4;
+      }
+
+      //Check the network protocol
+      if(type == ETH_TYPE_IPV4)
+      {
+         version = 4;
+      }
+      else if(type == ETH_TYPE_IPV6)
+      {
+         version = 6;
+      }
+      else
+      {
+         return FALSE;
+      }
+   }
+   else if(interface->nicDriver != NULL &&
+      interface->nicDriver->type == NIC_TYPE_PPP)
+   {
+      //The contents of PPP frames are not inspected
+      return FALSE;
+   }
+   else
+   {
+      //Raw IP packet
+      offset = 0;
+      //Retrieve the IP version
+      version = (length > 0) ? (frame[0] >> 4) : 0;
+   }
+
+   //Clear flag
+   fragment = FALSE;
+
+   //Check IP version
+   if(version == 4)
+   {
+      //Malformed IPv4 header?
+      if(length < (offset + 20))
+         return FALSE;
+
+      //Retrieve the upper-layer protocol
+      protocol = frame[offset + 9];
+      //Non-initial fragments do not carry the transport header
+      fragment = (LOAD16BE(frame + offset + 6) & 0x1FFF) != 0;
+
+      //Skip the IPv4 header
+      offset += (frame[offset] & 0x0F) * 4;
+   }
+   else if(version == 6)
+   {
+      //Malformed IPv6 header?
+      if(length < (offset + 40))
+         return FALSE;
+
+      //Retrieve the first next header value
+      protocol = frame[offset + 6];
+      //Skip the IPv6 header
+      offset += 40;
+
+      //Skip extension headers
+      while((protocol == IPV6_HOP_BY_HOP_OPT_HEADER ||
+         protocol == IPV6_ROUTING_HEADER ||
+         protocol == IPV6_DEST_OPT_HEADER ||
+         protocol == IPV6_FRAGMENT_HEADER) && length >= (offset + 8))
+      {
+         //Fragment header?
+         if(protocol == IPV6_FRAGMENT_HEADER)
+         {
+            //Non-initial fragments do not carry the transport header
+            if((LOAD16BE(frame + offset + 2) & 0xFFF8) != 0)
+               fragment = TRUE;
+
+            //Next header
+            protocol = frame[offset];
+            offset += 8;
+         }
+         else
+         {
+            //Next header
+            protocol = frame[offset];
+            offset += (frame[offset + 1] + 1) * 8;
+         }
+      }
+   }
+   else
+   {
+      //Unknown network protocol
+      return FALSE;
+   }
+
+   //Filter on the upper-layer protocol
+   if(filter->protocol != 0 && filter->protocol != protocol)
+      return FALSE;
+
+   //Filter on the port number
+   if(filter->port != 0)
+   {
+      //Only TCP and UDP carry port numbers
+      if(protocol != IPV4_PROTOCOL_TCP && protocol != IPV4_PROTOCOL_UDP)
+         return FALSE;
+
+      //The transport header must be present in the captured bytes
+      if(fragment || length < (offset + 4))
+         return FALSE;
+
+      //Check source and destination ports
+      if(LOAD16BE(frame + offset) != filter->port &&
+         LOAD16BE(frame + offset + 2) != filter->port)
+      {
+         return FALSE;
+      }
+   }
+
+   //The frame matches the filter
+   return TRUE;
+}
+
+
+/**
+ * @brief Copy data to the ring
+ * @param[in] pos Write position (free-running index)
+ * @param[in] data Pointer to the data to copy (NULL to write zeroes)
+ * @param[in] length Number of bytes to copy
+ * @return Updated write position
+ **/
+
+static uint32_t netCaptureWriteRing(uint32_t pos, const uint8_t *data,
+   size_t length)
+{
+   size_t i;
+   size_t n;
+
+   //Copy the data, wrapping around the end of the ring if necessary
+   for(i = 0; i < length; i += n)
+   {
+      //Number of contiguous bytes available
+      n = NET_CAPTURE_RING_SIZE - (pos & (NET_CAPTURE_RING_SIZE - 1));
+      n = MIN(n, length - i);
+
+      //Copy data
+      if(data != NULL)
+      {
+         osMemcpy(netCaptureContext.ring + (pos & (NET_CAPTURE_RING_SIZE - 1)),
+            data + i, n);
+      }
+      else
+      {
+         osMemset(netCaptureContext.ring + (pos & (NET_CAPTURE_RING_SIZE - 1)),
+            0, n);
+      }
+
+      //Advance write position
+      pos += (uint32_t) n;
+   }
+
+   //Return the updated write position
+   return pos;
+}
+
+
+/**
+ * @brief Append an enhanced packet block to the ring
+ * @param[in] interface Underlying network interface
+ * @param[in] data Captured bytes
+ * @param[in] length Number of captured bytes
+ * @param[in] origLength Actual length of the frame
+ * @param[in] direction Direction of the frame
+ **/
+
+static void netCaptureWriteRecord(NetInterface *interface, const uint8_t *data,
+   size_t length, size_t origLength, NetCaptureDirection direction)
+{
+   size_t n;
+   uint32_t pos;
+   uint64_t timestamp;
+   uint8_t block[28];
+
+   //Total length of the block (fixed part, padded data, epb_flags option,
+   //opt_endofopt option and trailing length field)
+   n = 28 + ((length + 3) & ~3U) + 8 + 4 + 4;
+
+   //Check whether the ring has enough room for the block
+   if((NET_CAPTURE_RING_SIZE - (netCaptureContext.head -
+      netCaptureContext.tail)) < n)
+   {
+      //The frame is dropped rather than overwriting data not yet drained
+      netCaptureContext.stats.dropped++;
+      return;
+   }
+
+   //Get current time
+   timestamp = NET_CAPTURE_GET_TIMESTAMP();
+
+   //Format the fixed part of the enhanced packet block
+   netCaptureStore32(block, PCAPNG_BLOCK_TYPE_EPB);
+   netCaptureStore32(block + 4, (uint32_t) n);
+   netCaptureStore32(block + 8, interface->index);
+   netCaptureStore32(block + 12, (uint32_t) (timestamp >> 32));
+   netCaptureStore32(block + 16, (uint32_t) timestamp);
+   netCaptureStore32(block + 20, (uint32_t) length);
+   netCaptureStore32(block + 24, (uint32_t) origLength);
+
+   //Current write position
+   pos = netCaptureContext.head;
+
+   //Write the fixed part of the block and the captured bytes
+   pos = netCaptureWriteRing(pos, block, 28);
+   pos = netCaptureWriteRing(pos, data, length);
+   pos = netCaptureWriteRing(pos, NULL, ((length + 3) & ~3U) - length);
+
+   //Format epb_flags and opt_endofopt options, followed by the trailing
+   //length field
+   netCaptureStore16(block, 2);
+   netCaptureStore16(block + 2, 4);
+   netCaptureStore32(block + 4, direction);
+   netCaptureStore32(block + 8, 0);
+   netCaptureStore32(block + 12, (uint32_t) n);
+
+   //Write the end of the block
+   pos = netCaptureWriteRing(pos, block, 16);
+
+   //Make sure the block is complete before it becomes visible to the reader
+   netCaptureBarrier();
+   netCaptureContext.head = pos;
+
+   //Update statistics
+   netCaptureContext.stats.captured++;
+}
+
+
+/**
+ * @brief Capture an incoming frame
+ * @param[in] interface Underlying network interface
+ * @param[in] frame Incoming frame
+ * @param[in] length Length of the frame
+ **/
+
+void netCaptureProcessRxFrame(NetInterface *interface, const uint8_t *frame,
+   size_t length)
+{
+   size_t n;
+
+   //Check whether the capture is active
+   if(netCaptureContext.running)
+   {
+      //Truncate the frame
+      n = MIN(length, NET_CAPTURE_SNAP_LEN);
+
+      //Apply the capture filter
+      if(netCaptureMatchFilter(interface, frame, n))
+      {
+         //Write the frame to the ring
+         netCaptureWriteRecord(interface, frame, n, length,
+            NET_CAPTURE_DIR_INBOUND);
+      }
+      else
+      {
+         //Update statistics
+         netCaptureContext.stats.filtered++;
+      }
+   }
+}
+
+
+/**
+ * @brief Capture an outgoing frame
+ * @param[in] interface Underlying network interface
+ * @param[in] buffer Multi-part buffer containing the frame
+ * @param[in] offset Offset to the first byte of the frame
+ **/
+
+void netCaptureProcessTxFrame(NetInterface *interface, const NetBuffer *buffer,
+   size_t offset)
+{
+   size_t n;
+   size_t length;
+   uint8_t frame[NET_CAPTURE_SNAP_LEN];
+
+   //Check whether the capture is active
+   if(netCaptureContext.running)
+   {
+      //Retrieve the length of the frame
+      length = netBufferGetLength(buffer) - offset;
+
+      //Copy the leading bytes of the frame
+      n = MIN(length, NET_CAPTURE_SNAP_LEN);
+      n = netBufferRead(frame, buffer, offset, n);
+
+      //Apply the capture filter
+      if(netCaptureMatchFilter(interface, frame, n))
+      {
+         //Write the frame to the ring
+         netCaptureWriteRecord(interface, frame, n, length,
+            NET_CAPTURE_DIR_OUTBOUND);
+      }
+      else
+      {
+         //Update statistics
+         netCaptureContext.stats.filtered++;
+      }
+   }
+}
+
+
+/**
+ * @brief Read pcapng data from the capture ring
+ *
+ * The first call after netCaptureStart returns the pcapng file header. This
+ * function does not lock the netMutex and can be called from any task, as
+ * long as there is a single reader
+ *
+ * @param[out] data Buffer where to store the pcapng data
+ * @param[in] size Size of the buffer, in bytes
+ * @return Number of bytes actually read
+ **/
+
+size_t netCaptureRead(uint8_t *data, size_t size)
+{
+   size_t i;
+   size_t n;
+   size_t length;
+   uint32_t head;
+   uint32_t tail;
+
+   //Number of bytes read so far
+   length = 0;
+
+   //The file header comes first
+   if(netCaptureContext.headerPos < netCaptureContext.headerLen)
+   {
+      //Copy the remaining part of the header
+      n = MIN(size, netCaptureContext.headerLen - netCaptureContext.headerPos);
+      osMemcpy(data, netCaptureContext.header + netCaptureContext.headerPos, n);
+
+      //Advance read position
+      netCaptureContext.headerPos += n;
+      length += n;
+   }
+
+   //Only complete blocks are visible to the reader
+   head = netCaptureContext.head;
+   tail = netCaptureContext.tail;
+   netCaptureBarrier();
+
+   //Copy as many bytes as possible from the ring
+   for(i = MIN(size - length, head - tail); i > 0; i -= n)
+   {
+      //Number of contiguous bytes available
+      n = NET_CAPTURE_RING_SIZE - (tail & (NET_CAPTURE_RING_SIZE - 1));
+      n = MIN(n, i);
+
+      //Copy data
+      osMemcpy(data + length, netCaptureContext.ring +
+         (tail & (NET_CAPTURE_RING_SIZE - 1)), n);
+
+      //Advance read position
+      tail += (uint32_t) n;
+      length += n;
+   }
+
+   //Release the space to the producer once the data has been copied
+   netCaptureBarrier();
+   netCaptureContext.tail = tail;
+
+   //Return the number of bytes read
+   return length;
+}
+
+
+/**
+ * @brief Drain the capture ring to a connected socket
+ *
+ * Only the data present in the ring when the function is called is sent.
+ * The segments generated by the transfer are themselves captured, unless
+ * they are excluded by the capture filter
+ *
+ * @param[in] socket Handle to a connected socket
+ * @return Error code
+ **/
+
+error_t netCaptureDrainToSocket(Socket *socket)
+{
+   error_t error;
+   size_t n;
+   size_t pending;
+   uint8_t buffer[NET_CAPTURE_DRAIN_BUFFER_SIZE];
+
+   //Make sure the socket handle is valid
+   if(socket == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Initialize status code
+   error = NO_ERROR;
+
+   //Number of bytes that are waiting to be read
+   pending = (netCaptureContext.headerLen - netCaptureContext.headerPos) +
+      (netCaptureContext.head - netCaptureContext.tail);
+
+   //Send the pending data
+   while(pending > 0 && !error)
+   {
+      //Read data from the ring
+      n = netCaptureRead(buffer, MIN(pending, sizeof(buffer)));
+
+      //Nothing left to send?
+      if(n == 0)
+         break;
+
+      //Send data
+      error = socketSend(socket, buffer, n, NULL, 0);
+
+      //Update the number of bytes left
+      pending -= n;
+   }
+
+   //Return status code
+   return error;
+}
+
+
+#if (NET_CAPTURE_FS_SUPPORT == ENABLED)
+
+/**
+ * @brief Drain the capture ring to a file
+ * @param[in] file Handle that identifies the file to write to
+ * @return Error code
+ **/
+
+error_t netCaptureDrainToFile(FsFile *file)
+{
+   error_t error;
+   size_t n;
+   size_t pending;
+   uint8_t buffer[NET_CAPTURE_DRAIN_BUFFER_SIZE];
+
+   //Make sure the file handle is valid
+   if(file == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Initialize status code
+   error = NO_ERROR;
+
+   //Number of bytes that are waiting to be read
+   pending = (netCaptureContext.headerLen - netCaptureContext.headerPos) +
+      (netCaptureContext.head - netCaptureContext.tail);
+
+   //Write the pending data
+   while(pending > 0 && !error)
+   {
+      //Read data from the ring
+      n = netCaptureRead(buffer, MIN(pending, sizeof(buffer)));
+
+      //Nothing left to write?
+      if(n == 0)
+         break;
+
+      //Write data to the file
+      error = fsWriteFile(file, buffer, n);
+
+      //Update the number of bytes left
+      pending -= n;
+   }
+
+   //Return status code
+   return error;
+}
+
+#endif
+
+
+/**
+ * @brief Retrieve capture statistics
+ * @param[out] stats Capture statistics
+ * @return Error code
+ **/
+
+error_t netCaptureGetStats(NetCaptureStats *stats)
+{
+   //Check parameters
+   if(stats == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Get exclusive access
+   osAcquireMutex(&netMutex);
+   //Copy statistics
+   *stats = netCaptureContext.stats;
+   //Release exclusive access
+   osReleaseMutex(&netMutex);
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+#endif
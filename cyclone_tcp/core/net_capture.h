@@ -0,0 +1,213 @@
+/**
+ * @file net_capture.h
+ * @brief In-stack packet capture (pcapng ring buffer)
+ *
+ * @section License
+ *
+ * Copyright (C) 2010-2023 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneTCP Eval.
+ *
+ * This software is provided in source form for a short-term evaluation only. The
+ * evaluation license expires 90 days after the date you first download the software.
+ *
+ * If you plan to use this software in a commercial product, you are required to
+ * purchase a commercial license from Oryx Embedded SARL.
+ *
+ * After the 90-day evaluation period, you agree to either purchase a commercial
+ * license or delete all copies of this software. If you wish to extend the
+ * evaluation period, you must contact sales@oryx-embedded.com.
+ *
+ * This evaluation software is provided "as is" without warranty of any kind.
+ * Technical support is available as an option during the evaluation period.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.3.2
+ **/
+
+#ifndef _NET_CAPTURE_H
+#define _NET_CAPTURE_H
+
+//Dependencies
+#include "core/net.h"
+#include "core/socket.h"
+
+//Packet capture support
+#ifndef NET_CAPTURE_SUPPORT
+   #define NET_CAPTURE_SUPPORT DISABLED
+#elif (NET_CAPTURE_SUPPORT != ENABLED && NET_CAPTURE_SUPPORT != DISABLED)
+   #error NET_CAPTURE_SUPPORT parameter is not valid
+#endif
+
+//Support for draining the capture ring to a file
+#ifndef NET_CAPTURE_FS_SUPPORT
+   #define NET_CAPTURE_FS_SUPPORT DISABLED
+#elif (NET_CAPTURE_FS_SUPPORT != ENABLED && NET_CAPTURE_FS_SUPPORT != DISABLED)
+   #error NET_CAPTURE_FS_SUPPORT parameter is not valid
+#endif
+
+//Size of the capture ring, in bytes (must be a power of two)
+#ifndef NET_CAPTURE_RING_SIZE
+   #define NET_CAPTURE_RING_SIZE 16384
+#elif (NET_CAPTURE_RING_SIZE < 256 || \
+   (NET_CAPTURE_RING_SIZE & (NET_CAPTURE_RING_SIZE - 1)) != 0)
+   #error NET_CAPTURE_RING_SIZE parameter is not valid
+#endif
+
+//Maximum number of bytes captured per frame
+#ifndef NET_CAPTURE_SNAP_LEN
+   #define NET_CAPTURE_SNAP_LEN 128
+#elif (NET_CAPTURE_SNAP_LEN < 64 || NET_CAPTURE_SNAP_LEN > 1536)
+   #error NET_CAPTURE_SNAP_LEN parameter is not valid
+#endif
+
+//Size of the intermediate buffer used to drain the capture ring
+#ifndef NET_CAPTURE_DRAIN_BUFFER_SIZE
+   #define NET_CAPTURE_DRAIN_BUFFER_SIZE 512
+#elif (NET_CAPTURE_DRAIN_BUFFER_SIZE < 1)
+   #error NET_CAPTURE_DRAIN_BUFFER_SIZE parameter is not valid
+#endif
+
+//Current time, in microseconds
+#ifndef NET_CAPTURE_GET_TIMESTAMP
+   #define NET_CAPTURE_GET_TIMESTAMP() ((uint64_t) osGetSystemTime() * 1000)
+#endif
+
+//Full memory barrier (the ring is shared by two tasks without locking)
+#ifndef netCaptureBarrier
+   #if defined(__GNUC__)
+      #define netCaptureBarrier() __sync_synchronize()
+   #else
+      #define netCaptureBarrier()
+   #endif
+#endif
+
+//Size of the pcapng section header block
+#define NET_CAPTURE_SHB_SIZE 28
+//Maximum size of an interface description block
+#define NET_CAPTURE_IDB_SIZE (36 + ((NET_MAX_IF_NAME_LEN + 3) & ~3U))
+//Size of the pcapng file header (SHB followed by one IDB per interface)
+#define NET_CAPTURE_HEADER_SIZE (NET_CAPTURE_SHB_SIZE + \
+   NET_INTERFACE_COUNT * NET_CAPTURE_IDB_SIZE)
+
+//File system support?
+#if (NET_CAPTURE_FS_SUPPORT == ENABLED)
+   #include "fs_port.h"
+#endif
+
+//C++ guard
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * @brief pcapng block types
+ **/
+
+typedef enum
+{
+   PCAPNG_BLOCK_TYPE_IDB = 0x00000001, ///<Interface Description Block
+   PCAPNG_BLOCK_TYPE_EPB = 0x00000006, ///<Enhanced Packet Block
+   PCAPNG_BLOCK_TYPE_SHB = 0x0A0D0D0A  ///<Section Header Block
+} PcapngBlockType;
+
+
+/**
+ * @brief pcapng link types
+ **/
+
+typedef enum
+{
+   PCAPNG_LINK_TYPE_ETHERNET = 1,   ///<IEEE 802.3 Ethernet
+   PCAPNG_LINK_TYPE_PPP_HDLC = 50,  ///<PPP in HDLC-like framing
+   PCAPNG_LINK_TYPE_RAW      = 101  ///<Raw IPv4 or IPv6 packets
+} PcapngLinkType;
+
+
+/**
+ * @brief Direction of a captured frame
+ **/
+
+typedef enum
+{
+   NET_CAPTURE_DIR_INBOUND  = 1, ///<Frame received by the NIC
+   NET_CAPTURE_DIR_OUTBOUND = 2  ///<Frame handed over to the NIC
+} NetCaptureDirection;
+
+
+/**
+ * @brief Capture filter
+ **/
+
+typedef struct
+{
+   NetInterface *interface; ///<Underlying network interface (NULL for any)
+   uint8_t protocol;        ///<IP protocol number (0 for any)
+   uint16_t port;           ///<TCP or UDP port, source or destination (0 for any)
+} NetCaptureFilter;
+
+
+/**
+ * @brief Capture statistics
+ **/
+
+typedef struct
+{
+   uint32_t captured; ///<Number of frames written to the ring
+   uint32_t dropped;  ///<Number of frames lost because the ring was full
+   uint32_t filtered; ///<Number of frames rejected by the filter
+} NetCaptureStats;
+
+
+/**
+ * @brief Capture context
+ *
+ * The producer side (the TCP/IP stack) is serialized by the netMutex. The
+ * consumer side only touches the tail index, so that the ring can be
+ * drained without holding the mutex
+ *
+ **/
+
+typedef struct
+{
+   volatile bool_t running;                  ///<The capture is active
+   NetCaptureFilter filter;                  ///<Capture filter
+   NetCaptureStats stats;                    ///<Capture statistics
+   uint8_t header[NET_CAPTURE_HEADER_SIZE];  ///<pcapng file header
+   size_t headerLen;                         ///<Length of the file header
+   size_t headerPos;                         ///<Number of header bytes already read
+   volatile uint32_t head;                   ///<Write index (free-running)
+   volatile uint32_t tail;                   ///<Read index (free-running)
+   uint8_t ring[NET_CAPTURE_RING_SIZE];      ///<Ring buffer
+} NetCaptureContext;
+
+
+//Global variables
+extern NetCaptureContext netCaptureContext;
+
+//Packet capture related functions
+error_t netCaptureStart(const NetCaptureFilter *filter);
+error_t netCaptureStop(void);
+
+void netCaptureProcessRxFrame(NetInterface *interface, const uint8_t *frame,
+   size_t length);
+
+void netCaptureProcessTxFrame(NetInterface *interface, const NetBuffer *buffer,
+   size_t offset);
+
+size_t netCaptureRead(uint8_t *data, size_t size);
+error_t netCaptureDrainToSocket(Socket *socket);
+
+#if (NET_CAPTURE_FS_SUPPORT == ENABLED)
+error_t netCaptureDrainToFile(FsFile *file);
+#endif
+
+error_t netCaptureGetStats(NetCaptureStats *stats);
+
+//C++ guard
+#ifdef __cplusplus
+}
+#endif
+
+#endif
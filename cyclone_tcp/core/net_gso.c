@@ -0,0 +1,390 @@
+/**
+ * @file net_gso.c
+ * @brief Generic segmentation offload
+ *
+ * @section License
+ *
+ * Copyright (C) 2010-2023 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneTCP Eval.
+ *
+ * This software is provided in source form for a short-term evaluation only. The
+ * evaluation license expires 90 days after the date you first download the software.
+ *
+ * If you plan to use this software in a commercial product, you are required to
+ * purchase a commercial license from Oryx Embedded SARL.
+ *
+ * After the 90-day evaluation period, you agree to either purchase a commercial
+ * license or delete all copies of this software. If you wish to extend the
+ * evaluation period, you must contact sales@oryx-embedded.com.
+ *
+ * This evaluation software is provided "as is" without warranty of any kind.
+ * Technical support is available as an option during the evaluation period.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.3.2
+ **/
+
+
+
+//Switch to the appropriate trace level
+#define TRACE_LEVEL NIC_TRACE_LEVEL
+
+//Dependencies
+#include "core/net.h"
+#include "core/nic.h"
+#include "core/ethernet.h"
+#include "core/ip.h"
+#include "core/tcp.h"
+#include "core/net_gso.h"
+#include "debug.h"
+
+//Check TCP/IP stack configuration
+#if (NET_GSO_SUPPORT == ENABLED)
+
+
+/**
+ * @brief Check whether super-segments can be sent over a given interface
+ * @param[in] interface Underlying network interface
+ * @return TRUE if super-segments are acceptable, else FALSE
+ **/
+
+bool_t netGsoCheckInterface(NetInterface *interface)
+{
+#if (IPV4_IPSEC_SUPPORT == ENABLED)
+   //IPsec-protected packets cannot be split once they have been processed
+   return FALSE;
+#else
+   bool_t acceptable;
+   NetInterface *physicalInterface;
+
+   //Initialize flag
+   acceptable = FALSE;
+
+   //Valid interface?
+   if(interface != NULL)
+   {
+      //Point to the physical interface
+      physicalInterface = nicGetPhysicalInterface(interface);
+
+      //Super-segments are split at the Ethernet layer
+      if(physicalInterface->nicDriver != NULL &&
+         physicalInterface->nicDriver->type == NIC_TYPE_ETHERNET)
+      {
+         //Frames carrying a switch-specific tag cannot be split since the tag
+         //may be appended to the end of the frame
+         if(nicGetSwitchPort(interface) == 0)
+         {
+            acceptable = TRUE;
+         }
+      }
+   }
+
+   //Return TRUE if super-segments are acceptable
+   return acceptable;
+#endif
+}
+
+
+/**
+ * @brief Split a TCP super-segment into MSS-sized frames
+ *
+ * The headers of the super-segment are used as a template. Only the length,
+ * identification, sequence number, flags and checksum fields are patched
+ * for each frame, and the TCP checksum is updated incrementally
+ *
+ * @param[in] interface Underlying network interface
+ * @param[in] buffer Multi-part buffer containing the Ethernet frame
+ * @param[in] offset Offset to the first byte of the Ethernet frame
+ * @param[in] ancillary Additional options passed to the stack along with
+ *   the packet
+ * @return Error code
+ **/
+
+error_t netGsoSendPacket(NetInterface *interface, const NetBuffer *buffer,
+   size_t offset, NetTxAncillary *ancillary)
+{
+   error_t error;
+   uint_t i;
+   uint_t j;
+   uint_t count;
+   size_t n;
+   size_t pos;
+   size_t length;
+   size_t headerLength;
+   size_t ipHeaderLength;
+   size_t tcpHeaderLength;
+   size_t payloadLength;
+   uint16_t id;
+   uint16_t type;
+   uint8_t flags;
+   uint32_t seqNum;
+   uint32_t checksum;
+   uint32_t templateSum;
+   NetBuffer *frame;
+   TcpHeader *tcpHeader;
+   NetTxAncillary frameAncillary;
+   NicTxFrame burst[NIC_BURST_SIZE];
+#if (IPV4_SUPPORT == ENABLED)
+   Ipv4Header *ipv4Header;
+#endif
+#if (IPV6_SUPPORT == ENABLED)
+   Ipv6Header *ipv6Header;
+#endif
+   uint8_t header[NET_GSO_MAX_HEADER_SIZE];
+
+   //Retrieve the length of the super-segment
+   length = netBufferGetLength(buffer) - offset;
+
+   //Copy the headers that precede the payload
+   n = netBufferRead(header, buffer, offset, MIN(length,
+      NET_GSO_MAX_HEADER_SIZE));
+
+   //Malformed Ethernet frame?
+   if(n < sizeof(EthHeader))
+      return ERROR_INVALID_PACKET;
+
+   //Retrieve the value of the Ethernet type field
+   type = ntohs(((EthHeader *) header)->type);
+   //Point to the first tag or to the IP header
+   pos = sizeof(EthHeader);
+
+   //Skip VLAN and VMAN tags, if any
+   while((type == ETH_TYPE_VLAN || type == ETH_TYPE_VMAN) &&
+      (pos + sizeof(VlanTag)) <= n)
+   {
+      //Retrieve the type of the encapsulated payload
+      type = ntohs(((VlanTag *) (header + pos))->type);
+      //Skip the tag
+      pos += sizeof(VlanTag);
+   }
+
+   //Initialize variables
+   id = 0;
+   ipHeaderLength = 0;
+   payloadLength = 0;
+   templateSum = 0;
+#if (IPV4_SUPPORT == ENABLED)
+   ipv4Header = NULL;
+#endif
+#if (IPV6_SUPPORT == ENABLED)
+   ipv6Header = NULL;
+#endif
+
+#if (IPV4_SUPPORT == ENABLED)
+   //IPv4 packet?
+   if(type == ETH_TYPE_IPV4 && (pos + sizeof(Ipv4Header)) <= n)
+   {
+      //Point to the IPv4 header
+      ipv4Header = (Ipv4Header *) (header + pos);
+
+      //Only TCP super-segments can be split
+      if(ipv4Header->protocol != IPV4_PROTOCOL_TCP)
+         return ERROR_INVALID_PACKET;
+
+      //Retrieve the length of the IPv4 header
+      ipHeaderLength = ipv4Header->headerLength * 4;
+      //Retrieve the length of the IPv4 payload
+      payloadLength = ntohs(ipv4Header->totalLength);
+
+      //Malformed IPv4 header?
+      if(ipHeaderLength < sizeof(Ipv4Header) || payloadLength < ipHeaderLength)
+         return ERROR_INVALID_PACKET;
+
+      //Calculate the length of the TCP segment
+      payloadLength -= ipHeaderLength;
+      //Save the identification value of the first frame
+      id = ntohs(ipv4Header->identification);
+
+      //Sum the fields of the pseudo header that remain unchanged
+      templateSum = ipCalcChecksum(&ipv4Header->srcAddr,
+         2 * sizeof(Ipv4Addr)) ^ 0xFFFF;
+      templateSum += htons(IPV4_PROTOCOL_TCP);
+   }
+   else
+#endif
+#if (IPV6_SUPPORT == ENABLED)
+   //IPv6 packet?
+   if(type == ETH_TYPE_IPV6 && (pos + sizeof(Ipv6Header)) <= n)
+   {
+      //Point to the IPv6 header
+      ipv6Header = (Ipv6Header *) (header + pos);
+
+      //Extension headers are not supported
+      if(ipv6Header->nextHeader != IPV6_TCP_HEADER)
+         return ERROR_INVALID_PACKET;
+
+      //Retrieve the length of the IPv6 header
+      ipHeaderLength = sizeof(Ipv6Header);
+      //Retrieve the length of the TCP segment
+      payloadLength = ntohs(ipv6Header->payloadLen);
+
+      //Sum the fields of the pseudo header that remain unchanged
+      templateSum = ipCalcChecksum(&ipv6Header->srcAddr,
+         2 * sizeof(Ipv6Addr)) ^ 0xFFFF;
+      templateSum += htons(IPV6_TCP_HEADER);
+   }
+   else
+#endif
+   //Unknown protocol?
+   {
+      //The frame cannot be split
+      return ERROR_INVALID_PACKET;
+   }
+
+   //Point to the TCP header
+   pos += ipHeaderLength;
+
+   //Malformed TCP segment?
+   if((pos + sizeof(TcpHeader)) > n || payloadLength < sizeof(TcpHeader))
+      return ERROR_INVALID_PACKET;
+
+   //Point to the TCP header
+   tcpHeader = (TcpHeader *) (header + pos);
+   //Retrieve the length of the TCP header
+   tcpHeaderLength = tcpHeader->dataOffset * 4;
+
+   //Check the length of the TCP header
+   if(tcpHeaderLength < sizeof(TcpHeader) || tcpHeaderLength > payloadLength)
+      return ERROR_INVALID_PACKET;
+
+   //Total length of the headers that precede the payload
+   headerLength = pos + tcpHeaderLength;
+   //Length of the TCP payload
+   payloadLength -= tcpHeaderLength;
+
+   //Make sure the headers and the payload are present
+   if(headerLength > n || (headerLength + payloadLength) > length)
+      return ERROR_INVALID_PACKET;
+
+   //Save the fields of the TCP header that differ from one frame to another
+   seqNum = ntohl(tcpHeader->seqNum);
+   flags = tcpHeader->flags;
+
+   //Clear the variable fields of the header template
+   tcpHeader->seqNum = 0;
+   tcpHeader->flags = 0;
+   tcpHeader->checksum = 0;
+
+   //Sum the fields of the TCP header that remain unchanged
+   templateSum += ipCalcChecksum(tcpHeader, tcpHeaderLength) ^ 0xFFFF;
+
+   //Additional options are passed along with each frame
+   frameAncillary = *ancillary;
+   //The resulting frames must not be segmented again
+   frameAncillary.gsoSize = 0;
+
+   //Initialize status code
+   error = NO_ERROR;
+   //The frames are handed over to the NIC in bursts
+   count = 0;
+
+   //Split the payload into MSS-sized frames
+   for(i = 0, pos = 0; pos < payloadLength && !error; i++, pos += n)
+   {
+      //Calculate the length of the current frame payload
+      n = MIN(payloadLength - pos, ancillary->gsoSize);
+
+#if (IPV4_SUPPORT == ENABLED)
+      //IPv4 packet?
+      if(ipv4Header != NULL)
+      {
+         //Update total length and identification fields
+         ipv4Header->totalLength = htons(ipHeaderLength + tcpHeaderLength + n);
+         ipv4Header->identification = htons(id + i);
+
+         //Recalculate the header checksum
+         ipv4Header->headerChecksum = 0;
+         ipv4Header->headerChecksum = ipCalcChecksum(ipv4Header,
+            ipHeaderLength);
+      }
+#endif
+#if (IPV6_SUPPORT == ENABLED)
+      //IPv6 packet?
+      if(ipv6Header != NULL)
+      {
+         //Update payload length field
+         ipv6Header->payloadLen = htons(tcpHeaderLength + n);
+      }
+#endif
+
+      //Update sequence number
+      tcpHeader->seqNum = htonl(seqNum + pos);
+
+      //The FIN and PSH flags are only set in the last frame
+      if((pos + n) < payloadLength)
+      {
+         tcpHeader->flags = flags & ~(TCP_FLAG_FIN | TCP_FLAG_PSH);
+      }
+      else
+      {
+         tcpHeader->flags = flags;
+      }
+
+      //Add the variable fields to the checksum of the header template
+      checksum = templateSum + htons(tcpHeaderLength + n);
+      checksum += (tcpHeader->seqNum >> 16) + (tcpHeader->seqNum & 0xFFFF);
+      checksum += htons(tcpHeader->flags);
+
+      //Sum the payload of the current frame
+      checksum += ipCalcChecksumEx(buffer, offset + headerLength + pos, n) ^
+         0xFFFF;
+
+      //Fold 32-bit sum to 16 bits
+      checksum = (checksum & 0xFFFF) + (checksum >> 16);
+      checksum = (checksum & 0xFFFF) + (checksum >> 16);
+
+      //Update TCP checksum
+      tcpHeader->checksum = ~checksum & 0xFFFF;
+
+      //Allocate a memory buffer to hold the frame headers
+      frame = netBufferAlloc(headerLength);
+
+      //Successful memory allocation?
+      if(frame != NULL)
+      {
+         //Copy the headers
+         netBufferWrite(frame, 0, header, headerLength);
+
+         //Reference the payload of the super-segment (no data copy)
+         error = netBufferConcat(frame, buffer, offset + headerLength + pos, n);
+
+         //Add the resulting frame to the current burst
+         burst[count].buffer = frame;
+         burst[count].offset = 0;
+         burst[count].ancillary = &frameAncillary;
+         count++;
+      }
+      else
+      {
+         //Failed to allocate memory
+         error = ERROR_OUT_OF_MEMORY;
+      }
+
+      //Send the burst once it is full or once the last frame has been built
+      if(count > 0 && (count == NIC_BURST_SIZE || (pos + n) >= payloadLength ||
+         error))
+      {
+         //Check status code
+         if(!error)
+         {
+            //Send the frames
+            error = nicSendBurst(interface, burst, count);
+         }
+
+         //Free previously allocated memory
+         for(j = 0; j < count; j++)
+         {
+            netBufferFree((NetBuffer *) burst[j].buffer);
+         }
+
+         //Start a new burst
+         count = 0;
+      }
+   }
+
+   //Return status code
+   return error;
+}
+
+#endif
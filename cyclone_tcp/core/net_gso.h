@@ -0,0 +1,56 @@
+/**
+ * @file net_gso.h
+ * @brief Generic segmentation offload
+ *
+ * @section License
+ *
+ * Copyright (C) 2010-2023 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneTCP Eval.
+ *
+ * This software is provided in source form for a short-term evaluation only. The
+ * evaluation license expires 90 days after the date you first download the software.
+ *
+ * If you plan to use this software in a commercial product, you are required to
+ * purchase a commercial license from Oryx Embedded SARL.
+ *
+ * After the 90-day evaluation period, you agree to either purchase a commercial
+ * license or delete all copies of this software. If you wish to extend the
+ * evaluation period, you must contact sales@oryx-embedded.com.
+ *
+ * This evaluation software is provided "as is" without warranty of any kind.
+ * Technical support is available as an option during the evaluation period.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.3.2
+ **/
+
+
+#ifndef _NET_GSO_H
+#define _NET_GSO_H
+
+//Dependencies
+#include "core/net.h"
+#include "core/tcp.h"
+
+//Maximum size of the headers that precede the payload of a super-segment
+#define NET_GSO_MAX_HEADER_SIZE (sizeof(EthHeader) + 2 * sizeof(VlanTag) + \
+   60 + TCP_MAX_HEADER_LENGTH)
+
+//C++ guard
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//GSO related functions
+bool_t netGsoCheckInterface(NetInterface *interface);
+
+error_t netGsoSendPacket(NetInterface *interface, const NetBuffer *buffer,
+   size_t offset, NetTxAncillary *ancillary);
+
+//C++ guard
+#ifdef __cplusplus
+}
+#endif
+
+#endif
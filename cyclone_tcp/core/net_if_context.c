@@ -0,0 +1,395 @@
+/**
+ * @file net_if_context.c
+ * @brief Per-interface processing contexts
+ *
+ * @section License
+ *
+ * Copyright (C) 2010-2023 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneTCP Eval.
+ *
+ * This software is provided in source form for a short-term evaluation only. The
+ * evaluation license expires 90 days after the date you first download the software.
+ *
+ * If you plan to use this software in a commercial product, you are required to
+ * purchase a commercial license from Oryx Embedded SARL.
+ *
+ * After the 90-day evaluation period, you agree to either purchase a commercial
+ * license or delete all copies of this software. If you wish to extend the
+ * evaluation period, you must contact sales@oryx-embedded.com.
+ *
+ * This evaluation software is provided "as is" without warranty of any kind.
+ * Technical support is available as an option during the evaluation period.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.3.2
+ **/
+
+
+//Switch to the appropriate trace level
+#define TRACE_LEVEL NIC_TRACE_LEVEL
+
+//Dependencies
+#include "core/net.h"
+#include "core/nic.h"
+#include "core/net_if_context.h"
+#include "debug.h"
+
+//Check TCP/IP stack configuration
+#if (NET_IF_CONTEXT_SUPPORT == ENABLED)
+
+
+/**
+ * @brief Initialize the processing context of a network interface
+ * @param[in] interface Underlying network interface
+ * @return Error code
+ **/
+
+error_t netIfContextInit(NetInterface *interface)
+{
+   NetIfContext *context;
+
+   //Point to the processing context
+   context = &interface->ifContext;
+
+   //The context is initialized only once
+   if(context->running)
+      return NO_ERROR;
+
+   //Create a mutex to serialize access to the NIC driver
+   if(!osCreateMutex(&context->mutex))
+      return ERROR_OUT_OF_RESOURCES;
+
+   //Create an event object to receive notifications from the TCP/IP stack
+   if(!osCreateEvent(&context->event))
+      return ERROR_OUT_OF_RESOURCES;
+
+   //Create an event object to notify the TCP/IP stack when the TX ring drains
+   if(!osCreateEvent(&context->txSpaceEvent))
+      return ERROR_OUT_OF_RESOURCES;
+
+   //The TX ring is initially empty
+   context->lockCount = 0;
+   context->txWriteIndex = 0;
+   context->txReadIndex = 0;
+   context->txDropCount = 0;
+
+   //Successful initialization
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Start the task that drives the NIC of a network interface
+ * @param[in] interface Underlying network interface
+ * @return Error code
+ **/
+
+error_t netIfContextStart(NetInterface *interface)
+{
+#if (NET_RTOS_SUPPORT == ENABLED)
+   OsTaskParameters taskParams;
+   NetIfContext *context;
+
+   //Point to the processing context
+   context = &interface->ifContext;
+
+   //The task is created only once
+   if(context->running)
+      return NO_ERROR;
+
+   //The loopback interface does not benefit from a dedicated task
+   if(interface->nicDriver == NULL ||
+      interface->nicDriver->type == NIC_TYPE_LOOPBACK)
+   {
+      return NO_ERROR;
+   }
+
+   //Task parameters
+   taskParams = OS_TASK_DEFAULT_PARAMS;
+   taskParams.stackSize = NET_IF_CONTEXT_STACK_SIZE;
+   taskParams.priority = NET_IF_CONTEXT_PRIORITY;
+
+   //The frames pushed by the TCP/IP stack are now handed over to the task
+   context->running = TRUE;
+
+   //Create a task
+   context->taskId = osCreateTask(interface->name,
+      (OsTaskCode) netIfContextTask, interface, &taskParams);
+
+   //Unable to create the task?
+   if(context->taskId == OS_INVALID_TASK_ID)
+   {
+      //Fall back to synchronous transmission
+      context->running = FALSE;
+      //Report an error
+      return ERROR_OUT_OF_RESOURCES;
+   }
+#endif
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Get exclusive access to the NIC driver from the TCP/IP stack
+ *
+ * The caller must hold the TCP/IP stack mutex. Nested calls are allowed, so
+ * that the driver can be re-entered from its own event handler
+ *
+ * @param[in] interface Underlying network interface
+ **/
+
+void netIfContextLock(NetInterface *interface)
+{
+   NetIfContext *context;
+
+   //Point to the processing context
+   context = &interface->ifContext;
+
+   //The NIC driver is shared with the per-interface task only when the task
+   //is running
+   if(context->running)
+   {
+      //Outermost call?
+      if(context->lockCount++ == 0)
+      {
+         osAcquireMutex(&context->mutex);
+      }
+   }
+}
+
+
+/**
+ * @brief Release exclusive access to the NIC driver
+ * @param[in] interface Underlying network interface
+ **/
+
+void netIfContextUnlock(NetInterface *interface)
+{
+   NetIfContext *context;
+
+   //Point to the processing context
+   context = &interface->ifContext;
+
+   //Matching call to netIfContextLock?
+   if(context->lockCount > 0)
+   {
+      //Outermost call?
+      if(--context->lockCount == 0)
+      {
+         osReleaseMutex(&context->mutex);
+      }
+   }
+}
+
+
+/**
+ * @brief Hand a frame over to the per-interface task
+ *
+ * The caller must hold the TCP/IP stack mutex, hence there is a single
+ * producer at any time and the TX ring can be updated without locking. If
+ * the ring is full, the caller is blocked until an entry is released, for
+ * at most NIC_MAX_BLOCKING_TIME. The caller's buffer typically references
+ * socket memory and is released on return, so the frame is copied to a
+ * buffer sized to it
+ *
+ * @param[in] interface Underlying network interface
+ * @param[in] buffer Multi-part buffer containing the data to send
+ * @param[in] offset Offset to the first data byte
+ * @param[in] ancillary Additional options passed to the stack along with
+ *   the packet
+ * @return Error code
+ **/
+
+error_t netIfContextSendPacket(NetInterface *interface,
+   const NetBuffer *buffer, size_t offset, NetTxAncillary *ancillary)
+{
+   size_t length;
+   NetIfContext *context;
+   NetIfTxQueueEntry *entry;
+
+   //Point to the processing context
+   context = &interface->ifContext;
+
+   //Retrieve the length of the frame
+   length = netBufferGetLength(buffer) - offset;
+
+   //Wait for an entry to become available in the TX ring
+   while((context->txWriteIndex - context->txReadIndex) >=
+      NET_IF_CONTEXT_TX_QUEUE_SIZE)
+   {
+      //The per-interface task cannot release any entry while the caller
+      //holds the NIC driver (e.g. frames sent from the driver event handler)
+      if(context->lockCount > 0 ||
+         !osWaitForEvent(&context->txSpaceEvent, NIC_MAX_BLOCKING_TIME))
+      {
+         //Number of frames that could not be sent
+         context->txDropCount++;
+         //Report an error
+         return ERROR_TRANSMITTER_BUSY;
+      }
+   }
+
+   //Point to the next free entry
+   entry = &context->txQueue[context->txWriteIndex &
+      (NET_IF_CONTEXT_TX_QUEUE_SIZE - 1)];
+
+   //Allocate a buffer to hold the frame
+   entry->buffer = netBufferAlloc(length);
+
+   //Failed to allocate memory?
+   if(entry->buffer == NULL)
+   {
+      //Number of frames that could not be sent
+      context->txDropCount++;
+      //Report an error
+      return ERROR_OUT_OF_MEMORY;
+   }
+
+   //Copy the frame
+   netBufferCopy(entry->buffer, 0, buffer, offset, length);
+   entry->ancillary = *ancillary;
+
+   //The contents of the entry must be visible before it is published
+   netIfContextBarrier();
+   context->txWriteIndex++;
+
+   //Notify the per-interface task
+   osSetEvent(&context->event);
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Per-interface task
+ * @param[in] interface Underlying network interface
+ **/
+
+void netIfContextTask(NetInterface *interface)
+{
+   error_t error;
+   uint_t i;
+   uint_t n;
+   bool_t status;
+   NetIfContext *context;
+   NetIfTxQueueEntry *entry;
+   NicTxFrame frames[NIC_BURST_SIZE];
+
+   //Task prologue
+   osEnterTask();
+
+   //Point to the processing context
+   context = &interface->ifContext;
+
+   //Main loop
+   while(1)
+   {
+      //Wait for frames to be queued by the TCP/IP stack
+      osWaitForEvent(&context->event, INFINITE_DELAY);
+
+      //Process all the pending frames
+      while(context->txReadIndex != context->txWriteIndex)
+      {
+         //Do not read the entries before they have been published
+         netIfContextBarrier();
+
+         //Drivers that support bursts are handed all the pending frames at
+         //once, up to the size of a burst
+         if(interface->nicDriver->txBurst != NULL)
+         {
+            n = MIN(context->txWriteIndex - context->txReadIndex, NIC_BURST_SIZE);
+         }
+         else
+         {
+            n = 1;
+         }
+
+         //Describe the pending frames
+         for(i = 0; i < n; i++)
+         {
+            //Point to the current entry
+            entry = &context->txQueue[(context->txReadIndex + i) &
+               (NET_IF_CONTEXT_TX_QUEUE_SIZE - 1)];
+
+            //Fill in the burst descriptor
+            frames[i].buffer = entry->buffer;
+            frames[i].offset = 0;
+            frames[i].ancillary = &entry->ancillary;
+         }
+
+         //Wait for the transmitter to be ready to send. The TCP/IP stack is
+         //not blocked in the meantime
+         status = osWaitForEvent(&interface->nicTxEvent, NIC_MAX_BLOCKING_TIME);
+
+         //The transmitter is still busy?
+         if(!status && interface->configured)
+         {
+            //Keep the frames queued and try again
+            continue;
+         }
+
+         //Get exclusive access to the NIC driver
+         osAcquireMutex(&context->mutex);
+
+         //The interface may have been stopped while the mutex was being
+         //acquired. Check whether it is still enabled for operation
+         if(status && interface->configured)
+         {
+            //Disable interrupts
+            interface->nicDriver->disableIrq(interface);
+
+            //Send the frames
+            if(interface->nicDriver->txBurst != NULL)
+            {
+               error = interface->nicDriver->txBurst(interface, frames, n);
+            }
+            else
+            {
+               error = interface->nicDriver->sendPacket(interface,
+                  frames[0].buffer, 0, frames[0].ancillary);
+            }
+
+            //Re-enable interrupts if necessary
+            if(interface->configured)
+            {
+               interface->nicDriver->enableIrq(interface);
+            }
+         }
+         else
+         {
+            //The frames cannot be sent once the interface has been stopped
+            error = ERROR_INVALID_INTERFACE;
+         }
+
+         //Release exclusive access to the NIC driver
+         osReleaseMutex(&context->mutex);
+
+         //Check status code
+         if(error)
+         {
+            //Number of frames that could not be sent
+            context->txDropCount += n;
+         }
+
+         //Release the buffers holding the frames
+         for(i = 0; i < n; i++)
+         {
+            netBufferFree(context->txQueue[(context->txReadIndex + i) &
+               (NET_IF_CONTEXT_TX_QUEUE_SIZE - 1)].buffer);
+         }
+
+         //The entries can be reused once the frames have been sent
+         netIfContextBarrier();
+         context->txReadIndex += n;
+
+         //Notify the TCP/IP stack that entries have been released
+         osSetEvent(&context->txSpaceEvent);
+      }
+   }
+}
+
+#endif
@@ -0,0 +1,128 @@
+/**
+ * @file net_if_context.h
+ * @brief Per-interface processing contexts
+ *
+ * @section License
+ *
+ * Copyright (C) 2010-2023 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneTCP Eval.
+ *
+ * This software is provided in source form for a short-term evaluation only. The
+ * evaluation license expires 90 days after the date you first download the software.
+ *
+ * If you plan to use this software in a commercial product, you are required to
+ * purchase a commercial license from Oryx Embedded SARL.
+ *
+ * After the 90-day evaluation period, you agree to either purchase a commercial
+ * license or delete all copies of this software. If you wish to extend the
+ * evaluation period, you must contact sales@oryx-embedded.com.
+ *
+ * This evaluation software is provided "as is" without warranty of any kind.
+ * Technical support is available as an option during the evaluation period.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.3.2
+ **/
+
+
+#ifndef _NET_IF_CONTEXT_H
+#define _NET_IF_CONTEXT_H
+
+//Dependencies
+#include "core/net.h"
+
+//Per-interface processing context support
+#ifndef NET_IF_CONTEXT_SUPPORT
+   #define NET_IF_CONTEXT_SUPPORT DISABLED
+#elif (NET_IF_CONTEXT_SUPPORT != ENABLED && NET_IF_CONTEXT_SUPPORT != DISABLED)
+   #error NET_IF_CONTEXT_SUPPORT parameter is not valid
+#endif
+
+//Number of frames that can be queued for transmission (power of two)
+#ifndef NET_IF_CONTEXT_TX_QUEUE_SIZE
+   #define NET_IF_CONTEXT_TX_QUEUE_SIZE 16
+#elif (NET_IF_CONTEXT_TX_QUEUE_SIZE < 2 || \
+   (NET_IF_CONTEXT_TX_QUEUE_SIZE & (NET_IF_CONTEXT_TX_QUEUE_SIZE - 1)) != 0)
+   #error NET_IF_CONTEXT_TX_QUEUE_SIZE parameter is not valid
+#endif
+
+//Stack size required to run the per-interface task
+#ifndef NET_IF_CONTEXT_STACK_SIZE
+   #define NET_IF_CONTEXT_STACK_SIZE 550
+#elif (NET_IF_CONTEXT_STACK_SIZE < 1)
+   #error NET_IF_CONTEXT_STACK_SIZE parameter is not valid
+#endif
+
+//Priority at which the per-interface task should run
+#ifndef NET_IF_CONTEXT_PRIORITY
+   #define NET_IF_CONTEXT_PRIORITY OS_TASK_PRIORITY_HIGH
+#endif
+
+//Full memory barrier (the TX queue is shared by two tasks without locking)
+#ifndef netIfContextBarrier
+   #if defined(__GNUC__)
+      #define netIfContextBarrier() __sync_synchronize()
+   #else
+      #define netIfContextBarrier()
+   #endif
+#endif
+
+//C++ guard
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * @brief Frame queued for transmission
+ **/
+
+typedef struct
+{
+   NetBuffer *buffer;        ///<Buffer holding the frame
+   NetTxAncillary ancillary; ///<Additional options
+} NetIfTxQueueEntry;
+
+
+/**
+ * @brief Per-interface processing context
+ *
+ * The TCP/IP task (or any application task holding the stack mutex) pushes
+ * outgoing frames onto a single-producer single-consumer ring. A dedicated
+ * task drains the ring and drives the NIC without holding the stack mutex
+ **/
+
+typedef struct
+{
+   bool_t running;                               ///<The per-interface task is running
+   OsTaskId taskId;                              ///<Task identifier
+   OsMutex mutex;                                ///<Mutex serializing access to the NIC driver
+   uint_t lockCount;                             ///<Lock nesting level of the TCP/IP stack
+   OsEvent event;                                ///<Event signaled when frames are queued
+   OsEvent txSpaceEvent;                         ///<Event signaled when entries are released
+   volatile uint_t txWriteIndex;                 ///<Producer index (TCP/IP stack)
+   volatile uint_t txReadIndex;                  ///<Consumer index (per-interface task)
+   uint_t txDropCount;                           ///<Frames that could not be sent
+   NetIfTxQueueEntry txQueue[NET_IF_CONTEXT_TX_QUEUE_SIZE]; ///<TX ring
+} NetIfContext;
+
+
+//Per-interface processing context related functions
+error_t netIfContextInit(NetInterface *interface);
+error_t netIfContextStart(NetInterface *interface);
+
+void netIfContextLock(NetInterface *interface);
+void netIfContextUnlock(NetInterface *interface);
+
+error_t netIfContextSendPacket(NetInterface *interface,
+   const NetBuffer *buffer, size_t offset, NetTxAncillary *ancillary);
+
+void netIfContextTask(NetInterface *interface);
+
+//C++ guard
+#ifdef __cplusplus
+}
+#endif
+
+#endif
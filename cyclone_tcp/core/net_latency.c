@@ -0,0 +1,427 @@
+/**
+ * @file net_latency.c
+ * @brief Packet path latency instrumentation
+ *
+ * @section License
+ *
+ * Copyright (C) 2010-2023 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneTCP Eval.
+ *
+ * This software is provided in source form for a short-term evaluation only. The
+ * evaluation license expires 90 days after the date you first download the software.
+ *
+ * If you plan to use this software in a commercial product, you are required to
+ * purchase a commercial license from Oryx Embedded SARL.
+ *
+ * After the 90-day evaluation period, you agree to either purchase a commercial
+ * license or delete all copies of this software. If you wish to extend the
+ * evaluation period, you must contact sales@oryx-embedded.com.
+ *
+ * This evaluation software is provided "as is" without warranty of any kind.
+ * Technical support is available as an option during the evaluation period.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.3.2
+ **/
+
+
+//Switch to the appropriate trace level
+#define TRACE_LEVEL NIC_TRACE_LEVEL
+
+//Dependencies
+#include "core/net.h"
+#include "core/socket.h"
+#include "core/net_latency.h"
+#include "debug.h"
+
+//Check TCP/IP stack configuration
+#if (NET_LATENCY_SUPPORT == ENABLED)
+
+//Names of the per-interface measurement points
+static const char_t *const netLatencyStageNames[NET_LATENCY_STAGE_COUNT] =
+{
+   "nic_event",
+   "link_rx",
+   "ip_rx",
+   "transport_rx",
+   "tx"
+};
+
+
+/**
+ * @brief Get current time stamp
+ * @return Current value of the time stamp counter (never 0)
+ **/
+
+uint32_t netLatencyGetTimestamp(void)
+{
+   uint32_t timestamp;
+
+   //Read the free-running counter
+   timestamp = NET_LATENCY_GET_TIMESTAMP();
+
+   //A null value means that the time stamp is not set
+   if(timestamp == 0)
+   {
+      timestamp = 1;
+   }
+
+   //Return current time stamp
+   return timestamp;
+}
+
+
+/**
+ * @brief Add a sample to a latency histogram
+ * @param[in] histogram Pointer to the histogram
+ * @param[in] delay Measured delay, in time stamp units
+ **/
+
+void netLatencyUpdateHistogram(NetLatencyHistogram *histogram,
+   uint32_t delay)
+{
+   uint_t n;
+   uint32_t value;
+
+   //First sample?
+   if(histogram->count == 0)
+   {
+      histogram->min = delay;
+      histogram->max = delay;
+   }
+   else
+   {
+      //Update the minimum delay
+      if(delay < histogram->min)
+      {
+         histogram->min = delay;
+      }
+
+      //Update the maximum delay
+      if(delay > histogram->max)
+      {
+         histogram->max = delay;
+      }
+   }
+
+   //Update the number of samples
+   histogram->count++;
+   //Update the sum of the delays
+   histogram->total += delay;
+
+   //Bucket n holds the delays whose most significant bit is bit n-1
+   for(n = 0, value = delay; value != 0 && n < (NET_LATENCY_BUCKET_COUNT - 1);
+      n++)
+   {
+      value >>= 1;
+   }
+
+   //Update the distribution
+   histogram->buckets[n]++;
+}
+
+
+/**
+ * @brief Record the time elapsed since the previous measurement point
+ * @param[in] interface Underlying network interface
+ * @param[in] stage Measurement point that has just been reached
+ * @param[in,out] timestamp Time stamp of the previous measurement point
+ **/
+
+void netLatencyCheckpoint(NetInterface *interface, NetLatencyStage stage,
+   uint32_t *timestamp)
+{
+   uint32_t time;
+
+   //Packets that were not time stamped on reception are ignored
+   if(*timestamp != 0)
+   {
+      //Get current time stamp
+      time = netLatencyGetTimestamp();
+
+      //Update the histogram associated with the current stage
+      netLatencyUpdateHistogram(&interface->latencyStats[stage],
+         time - *timestamp);
+
+      //The next stage starts now
+      *timestamp = time;
+   }
+}
+
+
+/**
+ * @brief Record the delivery of incoming data to a socket
+ * @param[in] interface Underlying network interface
+ * @param[in] socket Socket the data has been queued to
+ * @param[in] ancillary Additional options passed to the stack along with
+ *   the packet
+ **/
+
+void netLatencyProcessDelivery(NetInterface *interface, Socket *socket,
+   const NetRxAncillary *ancillary)
+{
+   uint32_t time;
+
+   //Packets that were not time stamped on reception are ignored
+   if(ancillary->latencyStart != 0)
+   {
+      //Get current time stamp
+      time = netLatencyGetTimestamp();
+
+      //Time spent in the transport layer
+      netLatencyUpdateHistogram(
+         &interface->latencyStats[NET_LATENCY_STAGE_TRANSPORT_RX],
+         time - ancillary->latencyMark);
+
+      //Time spent between the NIC and the socket
+      netLatencyUpdateHistogram(
+         &socket->latencyStats[NET_LATENCY_SOCKET_STAGE_RX_PATH],
+         time - ancillary->latencyStart);
+
+      //Keep track of the oldest data not yet consumed by the application
+      if(socket->latencyTimestamp == 0)
+      {
+         socket->latencyTimestamp = time;
+      }
+   }
+}
+
+
+/**
+ * @brief Record the consumption of incoming data by the application
+ * @param[in] socket Handle referencing the socket
+ **/
+
+void netLatencyProcessRead(Socket *socket)
+{
+   //Any pending data time stamp?
+   if(socket->latencyTimestamp != 0)
+   {
+      //Time elapsed between the delivery of the data and the read operation
+      netLatencyUpdateHistogram(
+         &socket->latencyStats[NET_LATENCY_SOCKET_STAGE_WAKEUP],
+         netLatencyGetTimestamp() - socket->latencyTimestamp);
+
+      //The time stamp is re-armed by the next delivery
+      socket->latencyTimestamp = 0;
+   }
+}
+
+
+/**
+ * @brief Retrieve the latency histogram of a given interface
+ * @param[in] interface Underlying network interface
+ * @param[in] stage Measurement point
+ * @param[out] histogram Copy of the histogram
+ * @return Error code
+ **/
+
+error_t netGetLatencyStats(NetInterface *interface, NetLatencyStage stage,
+   NetLatencyHistogram *histogram)
+{
+   //Check parameters
+   if(interface == NULL || histogram == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Make sure the measurement point is valid
+   if(stage >= NET_LATENCY_STAGE_COUNT)
+      return ERROR_INVALID_PARAMETER;
+
+   //Get exclusive access
+   osAcquireMutex(&netMutex);
+   //Copy the histogram
+   *histogram = interface->latencyStats[stage];
+   //Release exclusive access
+   osReleaseMutex(&netMutex);
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Clear the latency histograms of a given interface
+ * @param[in] interface Underlying network interface
+ * @return Error code
+ **/
+
+error_t netResetLatencyStats(NetInterface *interface)
+{
+   //Check parameters
+   if(interface == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Get exclusive access
+   osAcquireMutex(&netMutex);
+   //Clear histograms
+   osMemset(interface->latencyStats, 0, sizeof(interface->latencyStats));
+   //Release exclusive access
+   osReleaseMutex(&netMutex);
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Retrieve the latency histogram of a given socket
+ * @param[in] socket Handle referencing the socket
+ * @param[in] stage Measurement point
+ * @param[out] histogram Copy of the histogram
+ * @return Error code
+ **/
+
+error_t socketGetLatencyStats(Socket *socket, NetLatencySocketStage stage,
+   NetLatencyHistogram *histogram)
+{
+   //Check parameters
+   if(socket == NULL || histogram == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Make sure the measurement point is valid
+   if(stage >= NET_LATENCY_SOCKET_STAGE_COUNT)
+      return ERROR_INVALID_PARAMETER;
+
+   //Get exclusive access
+   osAcquireMutex(&netMutex);
+   //Copy the histogram
+   *histogram = socket->latencyStats[stage];
+   //Release exclusive access
+   osReleaseMutex(&netMutex);
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Format the per-interface latency histograms as a JSON document
+ *
+ * The resulting document can be served by an HTTP server request callback
+ *
+ * @param[out] buffer Output buffer where to store the JSON document
+ * @param[in] size Size of the output buffer
+ * @param[out] length Length of the resulting document
+ * @return Error code
+ **/
+
+error_t netFormatLatencyStats(char_t *buffer, size_t size, size_t *length)
+{
+   error_t error;
+   int_t ret;
+   uint_t i;
+   uint_t j;
+   uint_t k;
+   size_t n;
+   const NetLatencyHistogram *histogram;
+
+   //Check parameters
+   if(buffer == NULL || size == 0 || length == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Initialize status code
+   error = NO_ERROR;
+
+   //Get exclusive access
+   osAcquireMutex(&netMutex);
+
+   //Open the document
+   ret = osSnprintf(buffer, size, "{\"unit\":\"%s\",\"interfaces\":[",
+      NET_LATENCY_TIMESTAMP_UNIT);
+   n = (ret > 0) ? ret : 0;
+
+   //Loop through network interfaces
+   for(i = 0; i < NET_INTERFACE_COUNT && n < size; i++)
+   {
+      //Interface header
+      ret = osSnprintf(buffer + n, size - n, "%s{\"name\":\"%s\",\"stages\":[",
+         (i == 0) ? "" : ",", netInterface[i].name);
+      n += (ret > 0) ? ret : 0;
+
+      //Loop through measurement points
+      for(j = 0; j < NET_LATENCY_STAGE_COUNT && n < size; j++)
+      {
+         //Point to the histogram
+         histogram = &netInterface[i].latencyStats[j];
+
+         //Format summary
+         ret = osSnprintf(buffer + n, size - n, "%s{\"stage\":\"%s\","
+            "\"count\":%" PRIu32 ",\"min\":%" PRIu32 ",\"max\":%" PRIu32 ","
+            "\"total\":%" PRIu64 ",\"buckets\":[", (j == 0) ? "" : ",",
+            netLatencyStageNames[j], histogram->count, histogram->min,
+            histogram->max, histogram->total);
+         n += (ret > 0) ? ret : 0;
+
+         //Format distribution
+         for(k = 0; k < NET_LATENCY_BUCKET_COUNT && n < size; k++)
+         {
+            ret = osSnprintf(buffer + n, size - n, "%s%" PRIu32,
+               (k == 0) ? "" : ",", histogram->buckets[k]);
+            n += (ret > 0) ? ret : 0;
+         }
+
+         //Close the histogram
+         if(n < size)
+         {
+            ret = osSnprintf(buffer + n, size - n, "]}");
+            n += (ret > 0) ? ret : 0;
+         }
+      }
+
+      //Close the interface
+      if(n < size)
+      {
+         ret = osSnprintf(buffer + n, size - n, "]}");
+         n += (ret > 0) ? ret : 0;
+      }
+   }
+
+   //Close the document
+   if(n < size)
+   {
+      ret = osSnprintf(buffer + n, size - n, "]}");
+      n += (ret > 0) ? ret : 0;
+   }
+
+   //Release exclusive access
+   osReleaseMutex(&netMutex);
+
+   //Truncated output?
+   if(n >= size)
+   {
+      //Report an error
+      error = ERROR_BUFFER_OVERFLOW;
+      //Do not return a partial document
+      n = 0;
+      buffer[0] = '\0';
+   }
+
+   //Length of the resulting document
+   *length = n;
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Get the name of a per-interface measurement point
+ * @param[in] stage Measurement point
+ * @return Name of the measurement point
+ **/
+
+const char_t *netLatencyGetStageName(NetLatencyStage stage)
+{
+   //Check parameter
+   if(stage < NET_LATENCY_STAGE_COUNT)
+   {
+      return netLatencyStageNames[stage];
+   }
+   else
+   {
+      return "unknown";
+   }
+}
+
+#endif
@@ -0,0 +1,146 @@
+/**
+ * @file net_latency.h
+ * @brief Packet path latency instrumentation
+ *
+ * @section License
+ *
+ * Copyright (C) 2010-2023 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneTCP Eval.
+ *
+ * This software is provided in source form for a short-term evaluation only. The
+ * evaluation license expires 90 days after the date you first download the software.
+ *
+ * If you plan to use this software in a commercial product, you are required to
+ * purchase a commercial license from Oryx Embedded SARL.
+ *
+ * After the 90-day evaluation period, you agree to either purchase a commercial
+ * license or delete all copies of this software. If you wish to extend the
+ * evaluation period, you must contact sales@oryx-embedded.com.
+ *
+ * This evaluation software is provided "as is" without warranty of any kind.
+ * Technical support is available as an option during the evaluation period.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.3.2
+ **/
+
+
+#ifndef _NET_LATENCY_H
+#define _NET_LATENCY_H
+
+//Forward declaration of Socket structure
+struct _Socket;
+#define Socket struct _Socket
+
+//Dependencies
+#include "core/net.h"
+
+//Latency instrumentation support
+#ifndef NET_LATENCY_SUPPORT
+   #define NET_LATENCY_SUPPORT DISABLED
+#elif (NET_LATENCY_SUPPORT != ENABLED && NET_LATENCY_SUPPORT != DISABLED)
+   #error NET_LATENCY_SUPPORT parameter is not valid
+#endif
+
+//Number of buckets per histogram
+#ifndef NET_LATENCY_BUCKET_COUNT
+   #define NET_LATENCY_BUCKET_COUNT 24
+#elif (NET_LATENCY_BUCKET_COUNT < 2 || NET_LATENCY_BUCKET_COUNT > 33)
+   #error NET_LATENCY_BUCKET_COUNT parameter is not valid
+#endif
+
+//Free-running 32-bit counter used to time stamp packets (for instance the
+//DWT cycle counter on Cortex-M devices)
+#ifndef NET_LATENCY_GET_TIMESTAMP
+   #define NET_LATENCY_GET_TIMESTAMP() ((uint32_t) osGetSystemTime())
+#endif
+
+//Unit of the time stamps (reported by the export functions)
+#ifndef NET_LATENCY_TIMESTAMP_UNIT
+   #define NET_LATENCY_TIMESTAMP_UNIT "ms"
+#endif
+
+//C++ guard
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * @brief Per-interface measurement points
+ **/
+
+typedef enum
+{
+   NET_LATENCY_STAGE_NIC_EVENT    = 0, ///<Time spent servicing a NIC event
+   NET_LATENCY_STAGE_LINK_RX      = 1, ///<From NIC RX to IP input
+   NET_LATENCY_STAGE_IP_RX        = 2, ///<From IP input to transport layer dispatch
+   NET_LATENCY_STAGE_TRANSPORT_RX = 3, ///<From transport layer dispatch to socket delivery
+   NET_LATENCY_STAGE_TX           = 4, ///<From IP output to NIC TX
+   NET_LATENCY_STAGE_COUNT        = 5
+} NetLatencyStage;
+
+
+/**
+ * @brief Per-socket measurement points
+ **/
+
+typedef enum
+{
+   NET_LATENCY_SOCKET_STAGE_RX_PATH = 0, ///<From NIC RX to socket delivery
+   NET_LATENCY_SOCKET_STAGE_WAKEUP  = 1, ///<From socket delivery to application read
+   NET_LATENCY_SOCKET_STAGE_COUNT   = 2
+} NetLatencySocketStage;
+
+
+/**
+ * @brief Latency histogram
+ *
+ * Bucket 0 counts null delays. Bucket n (n > 0) counts the delays in the
+ * range [2^(n-1), 2^n) and the last bucket has no upper bound
+ *
+ **/
+
+typedef struct
+{
+   uint32_t count;                              ///<Number of samples
+   uint32_t min;                                ///<Minimum delay
+   uint32_t max;                                ///<Maximum delay
+   uint64_t total;                              ///<Sum of the delays
+   uint32_t buckets[NET_LATENCY_BUCKET_COUNT]; ///<Distribution of the delays
+} NetLatencyHistogram;
+
+
+//Latency instrumentation related functions
+uint32_t netLatencyGetTimestamp(void);
+
+void netLatencyUpdateHistogram(NetLatencyHistogram *histogram,
+   uint32_t delay);
+
+void netLatencyCheckpoint(NetInterface *interface, NetLatencyStage stage,
+   uint32_t *timestamp);
+
+void netLatencyProcessDelivery(NetInterface *interface, Socket *socket,
+   const NetRxAncillary *ancillary);
+
+void netLatencyProcessRead(Socket *socket);
+
+error_t netGetLatencyStats(NetInterface *interface, NetLatencyStage stage,
+   NetLatencyHistogram *histogram);
+
+error_t netResetLatencyStats(NetInterface *interface);
+
+error_t socketGetLatencyStats(Socket *socket, NetLatencySocketStage stage,
+   NetLatencyHistogram *histogram);
+
+error_t netFormatLatencyStats(char_t *buffer, size_t size, size_t *length);
+
+const char_t *netLatencyGetStageName(NetLatencyStage stage);
+
+//C++ guard
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -31,6 +31,7 @@
 //Dependencies
 #include "core/net.h"
 #include "core/net_mem.h"
+#include "core/ip.h"
 #include "debug.h"
 
 //Maximum number of chunks for dynamically allocated buffers
@@ -659,6 +660,83 @@ size_t netBufferWrite(NetBuffer *dest,
 }
 
 
+/**
+ * @brief Write data to a multi-part buffer and calculate their checksum
+ *
+ * The data are copied and summed in a single pass, so that the caller does
+ * not have to read them again to compute the IP checksum
+ *
+ * @param[out] dest Pointer to a multi-part buffer
+ * @param[in] destOffset Offset from the beginning of the multi-part buffer
+ * @param[in] src User buffer containing the data to be written
+ * @param[in] length Number of bytes to copy
+ * @param[out] checksum IP checksum of the data that have been written
+ * @return Actual number of bytes copied
+ **/
+
+size_t netBufferWriteCsum(NetBuffer *dest, size_t destOffset,
+   const void *src, size_t length, uint16_t *checksum)
+{
+   uint_t i;
+   uint_t n;
+   size_t totalLength;
+   uint32_t sum;
+   uint32_t temp;
+   uint8_t *p;
+
+   //Checksum preset value
+   sum = 0x0000;
+   //Total number of bytes written
+   totalLength = 0;
+
+   //Loop through data chunks
+   for(i = 0; i < dest->chunkCount && totalLength < length; i++)
+   {
+      //Is there any data to copy in the current chunk?
+      if(destOffset < dest->chunk[i].length)
+      {
+         //Point to the first byte to be written
+         p = (uint8_t *) dest->chunk[i].address + destOffset;
+         //Compute the number of bytes to copy at a time
+         n = MIN(length - totalLength, dest->chunk[i].length - destOffset);
+
+         //Copy data and calculate their checksum
+         temp = ipCalcChecksumCopy(p, src, n) ^ 0xFFFF;
+
+         //Take care of alignment issues
+         if((totalLength & 1) != 0)
+         {
+            //Swap checksum value
+            temp = ((temp >> 8) | (temp << 8)) & 0xFFFF;
+         }
+
+         //Update checksum value
+         sum += temp;
+         //Fold 32-bit sum to 16 bits
+         sum = (sum & 0xFFFF) + (sum >> 16);
+
+         //Advance read pointer
+         src = (uint8_t *) src + n;
+         //Total number of bytes written
+         totalLength += n;
+         //Process the next block from the start
+         destOffset = 0;
+      }
+      else
+      {
+         //Skip the current chunk
+         destOffset -= dest->chunk[i].length;
+      }
+   }
+
+   //Return 1's complement value
+   *checksum = (uint16_t) (sum ^ 0xFFFF);
+
+   //Return the actual number of bytes written
+   return totalLength;
+}
+
+
 /**
  * @brief Read data from a multi-part buffer
  * @param[out] dest Pointer to the buffer where to return the data
@@ -123,6 +123,9 @@ error_t netBufferAppend(NetBuffer *dest, const void *src, size_t length);
 size_t netBufferWrite(NetBuffer *dest,
    size_t destOffset, const void *src, size_t length);
 
+size_t netBufferWriteCsum(NetBuffer *dest, size_t destOffset,
+   const void *src, size_t length, uint16_t *checksum);
+
 size_t netBufferRead(void *dest, const NetBuffer *src,
    size_t srcOffset, size_t length);
 
@@ -92,6 +92,12 @@ const NetTxAncillary NET_DEFAULT_TX_ANCILLARY =
 #if (ETH_TIMESTAMP_SUPPORT == ENABLED)
    -1,            //Unique identifier for hardware time stamping
 #endif
+#if (NET_GSO_SUPPORT == ENABLED)
+   0,             //No generic segmentation offload
+#endif
+#if (NET_LATENCY_SUPPORT == ENABLED)
+   0,             //No latency time stamp
+#endif
 };
 
 //Default options passed to the stack (RX path)
@@ -110,6 +116,13 @@ const NetRxAncillary NET_DEFAULT_RX_ANCILLARY =
 #if (ETH_TIMESTAMP_SUPPORT == ENABLED)
    {0},     //Captured time stamp
 #endif
+#if (NET_LOOPBACK_FAST_PATH_SUPPORT == ENABLED)
+   FALSE,   //Not looped back
+#endif
+#if (NET_LATENCY_SUPPORT == ENABLED)
+   0,       //Reception time stamp
+   0,       //Previous measurement point
+#endif
 };
 
 
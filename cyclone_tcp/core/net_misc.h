@@ -40,6 +40,28 @@ struct _NetRxAncillary;
 #include "core/net.h"
 #include "core/ethernet.h"
 #include "core/ip.h"
+#include "core/net_latency.h"
+
+//Generic segmentation offload support
+#ifndef NET_GSO_SUPPORT
+   #define NET_GSO_SUPPORT DISABLED
+#elif (NET_GSO_SUPPORT != ENABLED && NET_GSO_SUPPORT != DISABLED)
+   #error NET_GSO_SUPPORT parameter is not valid
+#endif
+
+//Maximum amount of payload carried by a TCP super-segment
+#ifndef NET_GSO_MAX_SIZE
+   #define NET_GSO_MAX_SIZE 8192
+#elif (NET_GSO_MAX_SIZE < 1024 || NET_GSO_MAX_SIZE > 65000)
+   #error NET_GSO_MAX_SIZE parameter is not valid
+#endif
+
+//Zero-copy delivery of packets sent over the loopback interface
+#ifndef NET_LOOPBACK_FAST_PATH_SUPPORT
+   #define NET_LOOPBACK_FAST_PATH_SUPPORT DISABLED
+#elif (NET_LOOPBACK_FAST_PATH_SUPPORT != ENABLED && NET_LOOPBACK_FAST_PATH_SUPPORT != DISABLED)
+   #error NET_LOOPBACK_FAST_PATH_SUPPORT parameter is not valid
+#endif
 
 //Get a given bit of the PRNG internal state
 #define NET_RAND_GET_BIT(s, n) ((s[(n - 1) / 8] >> ((n - 1) % 8)) & 1)
@@ -136,6 +158,12 @@ struct _NetTxAncillary
 #if (ETH_TIMESTAMP_SUPPORT == ENABLED)
    int32_t timestampId; ///<Unique identifier for hardware time stamping
 #endif
+#if (NET_GSO_SUPPORT == ENABLED)
+   uint16_t gsoSize;    ///<Segment size used to split a super-segment (0 if not used)
+#endif
+#if (NET_LATENCY_SUPPORT == ENABLED)
+   uint32_t latencyMark; ///<Time stamp of the previous measurement point
+#endif
 };
 
 
@@ -158,6 +186,13 @@ struct _NetRxAncillary
 #if (ETH_TIMESTAMP_SUPPORT == ENABLED)
    NetTimestamp timestamp; ///<Captured time stamp
 #endif
+#if (NET_LOOPBACK_FAST_PATH_SUPPORT == ENABLED)
+   bool_t loopback;        ///<Packet delivered by the loopback fast path
+#endif
+#if (NET_LATENCY_SUPPORT == ENABLED)
+   uint32_t latencyStart;  ///<Time stamp taken when the NIC delivered the packet
+   uint32_t latencyMark;   ///<Time stamp of the previous measurement point
+#endif
 };
 
 
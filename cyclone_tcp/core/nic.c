@@ -32,6 +32,8 @@
 #include "core/net.h"
 #include "core/nic.h"
 #include "core/ethernet.h"
+#include "core/net_gso.h"
+#include "core/net_capture.h"
 #include "ipv4/ipv4_misc.h"
 #include "ipv6/ipv6_misc.h"
 #include "debug.h"
@@ -39,6 +41,11 @@
 //Tick counter to handle periodic operations
 systime_t nicTickCounter;
 
+#if (NET_LOOPBACK_IF_SUPPORT == ENABLED && NET_LOOPBACK_FAST_PATH_SUPPORT == ENABLED)
+//Nesting level of the loopback fast path
+static uint_t nicLoopbackDepth = 0;
+#endif
+
 
 /**
  * @brief Retrieve logical interface
@@ -249,6 +256,11 @@ void nicTick(NetInterface *interface)
    //Valid NIC driver?
    if(interface->nicDriver != NULL)
    {
+#if (NET_IF_CONTEXT_SUPPORT == ENABLED)
+      //Get exclusive access to the NIC driver
+      netIfContextLock(interface);
+#endif
+
       //Disable interrupts
       interface->nicDriver->disableIrq(interface);
 
@@ -260,6 +272,11 @@ void nicTick(NetInterface *interface)
       {
          interface->nicDriver->enableIrq(interface);
       }
+
+#if (NET_IF_CONTEXT_SUPPORT == ENABLED)
+      //Release exclusive access to the NIC driver
+      netIfContextUnlock(interface);
+#endif
    }
 }
 
@@ -292,6 +309,42 @@ error_t nicSendPacket(NetInterface *interface, const NetBuffer *buffer,
    //Gather entropy
    netContext.entropy += netGetSystemTickCount();
 
+#if (NET_GSO_SUPPORT == ENABLED)
+   //Super-segment that cannot be handed over to the NIC as is?
+   if(ancillary->gsoSize != 0 && interface->nicDriver != NULL &&
+      !interface->nicDriver->autoTcpSegmentation)
+   {
+      //Split the super-segment into MSS-sized frames
+      return netGsoSendPacket(interface, buffer, offset, ancillary);
+   }
+#endif
+
+   //Capture the outgoing frame and update latency statistics
+   nicTapTxFrame(interface, buffer, offset, ancillary);
+
+#if (NET_IF_CONTEXT_SUPPORT == ENABLED)
+   //The NIC is driven by a dedicated task?
+   if(interface->ifContext.running && interface->configured)
+   {
+      //Hand the frame over to the per-interface task
+      return netIfContextSendPacket(interface, buffer, offset, ancillary);
+   }
+#endif
+
+#if (NET_LOOPBACK_IF_SUPPORT == ENABLED && NET_LOOPBACK_FAST_PATH_SUPPORT == ENABLED)
+   //Packet sent over the loopback interface?
+   if(interface->configured && interface->nicDriver != NULL &&
+      interface->nicDriver->type == NIC_TYPE_LOOPBACK)
+   {
+      //Pass the packet by reference to IP input
+      error = nicProcessLoopbackPacket(interface, buffer, offset, ancillary);
+
+      //Packets that cannot take the fast path are queued by the driver
+      if(error != ERROR_WOULD_BLOCK)
+         return error;
+   }
+#endif
+
    //Check whether the interface is enabled for operation
    if(interface->configured && interface->nicDriver != NULL)
    {
@@ -340,6 +393,98 @@ error_t nicSendPacket(NetInterface *interface, const NetBuffer *buffer,
 }
 
 
+/**
+ * @brief Send a burst of frames to the network controller
+ *
+ * Drivers that implement the txBurst entry point receive the whole burst in
+ * a single call. Otherwise the frames are sent one at a time
+ *
+ * @param[in] interface Underlying network interface
+ * @param[in] frames Array of frames to send
+ * @param[in] count Number of frames in the array
+ * @return Error code
+ **/
+
+error_t nicSendBurst(NetInterface *interface, const NicTxFrame *frames,
+   uint_t count)
+{
+   error_t error;
+   uint_t i;
+   bool_t status;
+
+   //Initialize status code
+   error = NO_ERROR;
+
+   //Drivers without burst support are fed one frame at a time. The same
+   //applies to frames handed over to the per-interface task
+   if(interface->nicDriver == NULL || interface->nicDriver->txBurst == NULL
+#if (NET_IF_CONTEXT_SUPPORT == ENABLED)
+      || interface->ifContext.running
+#endif
+      )
+   {
+      //Send the frames in order
+      for(i = 0; i < count && !error; i++)
+      {
+         error = nicSendPacket(interface, frames[i].buffer, frames[i].offset,
+            frames[i].ancillary);
+      }
+
+      //Return status code
+      return error;
+   }
+
+   //Debug message
+   TRACE_DEBUG("Sending burst (%u frames)...\r\n", count);
+
+   //Gather entropy
+   netContext.entropy += netGetSystemTickCount();
+
+   //Capture the outgoing frames and update latency statistics
+   for(i = 0; i < count; i++)
+   {
+      nicTapTxFrame(interface, frames[i].buffer, frames[i].offset,
+         frames[i].ancillary);
+   }
+
+   //Check whether the interface is enabled for operation
+   if(interface->configured)
+   {
+      //Wait for the transmitter to be ready to send
+      status = osWaitForEvent(&interface->nicTxEvent, NIC_MAX_BLOCKING_TIME);
+
+      //Check whether the specified event is in signaled state
+      if(status)
+      {
+         //Disable interrupts
+         interface->nicDriver->disableIrq(interface);
+
+         //Send the frames
+         error = interface->nicDriver->txBurst(interface, frames, count);
+
+         //Re-enable interrupts if necessary
+         if(interface->configured)
+         {
+            interface->nicDriver->enableIrq(interface);
+         }
+      }
+      else
+      {
+         //If the transmitter is busy, then drop the frames
+         error = NO_ERROR;
+      }
+   }
+   else
+   {
+      //Report an error
+      error = ERROR_INVALID_INTERFACE;
+   }
+
+   //Return status code
+   return error;
+}
+
+
 /**
  * @brief Configure MAC address filtering
  * @param[in] interface Underlying network interface
@@ -353,6 +498,11 @@ error_t nicUpdateMacAddrFilter(NetInterface *interface)
    //Valid NIC driver?
    if(interface->nicDriver != NULL)
    {
+#if (NET_IF_CONTEXT_SUPPORT == ENABLED)
+      //Get exclusive access to the NIC driver
+      netIfContextLock(interface);
+#endif
+
       //Disable interrupts
       interface->nicDriver->disableIrq(interface);
 
@@ -364,6 +514,11 @@ error_t nicUpdateMacAddrFilter(NetInterface *interface)
       {
          interface->nicDriver->enableIrq(interface);
       }
+
+#if (NET_IF_CONTEXT_SUPPORT == ENABLED)
+      //Release exclusive access to the NIC driver
+      netIfContextUnlock(interface);
+#endif
    }
    else
    {
@@ -406,6 +561,9 @@ void nicProcessPacket(NetInterface *interface, uint8_t *packet, size_t length,
       //Retrieve network interface type
       type = interface->nicDriver->type;
 
+      //Time stamp and capture the incoming frame
+      nicTapRxFrame(interface, packet, length, ancillary);
+
 #if (ETH_SUPPORT == ENABLED)
       //Ethernet interface?
       if(type == NIC_TYPE_ETHERNET)
@@ -537,6 +695,318 @@ void nicProcessPacket(NetInterface *interface, uint8_t *packet, size_t length,
 }
 
 
+#if (NET_LOOPBACK_IF_SUPPORT == ENABLED && NET_LOOPBACK_FAST_PATH_SUPPORT == ENABLED)
+
+/**
+ * @brief Deliver a looped back packet without going through the driver queue
+ *
+ * The multi-part buffer is passed by reference to IP input, in the context of
+ * the sender. Only the outermost packet takes the fast path: packets sent
+ * while a looped back packet is being processed (an ACK for instance) are
+ * queued by the driver, since the sender has not yet updated its own state
+ *
+ * @param[in] interface Loopback interface
+ * @param[in] buffer Multi-part buffer containing the IP packet
+ * @param[in] offset Offset to the first byte of the IP header
+ * @param[in] ancillary Additional options passed to the stack along with
+ *   the packet
+ * @return ERROR_WOULD_BLOCK if the packet must be queued by the driver,
+ *   else error code
+ **/
+
+error_t nicProcessLoopbackPacket(NetInterface *interface,
+   const NetBuffer *buffer, size_t offset, NetTxAncillary *ancillary)
+{
+   error_t error;
+   uint_t i;
+   size_t length;
+   uint8_t *packet;
+   NetRxAncillary rxAncillary;
+
+   //A looped back packet is already being processed?
+   if(nicLoopbackDepth > 0)
+      return ERROR_WOULD_BLOCK;
+
+   //Retrieve the length of the packet
+   length = netBufferGetLength(buffer) - offset;
+   //Point to the IP header
+   packet = netBufferAt(buffer, offset);
+
+   //Malformed packet?
+   if(packet == NULL || length == 0)
+      return ERROR_WOULD_BLOCK;
+
+   //Initialize status code
+   error = ERROR_WOULD_BLOCK;
+
+#if (IPV4_SUPPORT == ENABLED)
+   //IPv4 packet?
+   if(length >= sizeof(Ipv4Header) && (packet[0] >> 4) == 4)
+   {
+      Ipv4Header *header;
+
+      //Point to the IPv4 header
+      header = (Ipv4Header *) packet;
+
+      //Fragments are reassembled by the regular path
+      if((ntohs(header->fragmentOffset) & (IPV4_FLAG_MF | IPV4_OFFSET_MASK)) == 0)
+      {
+         //Enter the fast path
+         nicLoopbackDepth++;
+
+         //Loop through network interfaces
+         for(i = 0; i < NET_INTERFACE_COUNT; i++)
+         {
+            //Check destination address
+            if(!ipv4CheckDestAddr(&netInterface[i], header->destAddr))
+            {
+               //Additional options can be passed to the stack along with the
+               //packet
+               rxAncillary = NET_DEFAULT_RX_ANCILLARY;
+               //The packet never left memory
+               rxAncillary.loopback = TRUE;
+
+#if (NET_LATENCY_SUPPORT == ENABLED)
+               //Time stamp the packet as it enters the stack
+               rxAncillary.latencyStart = netLatencyGetTimestamp();
+               rxAncillary.latencyMark = rxAncillary.latencyStart;
+#endif
+               //The IP header was built by the local stack and does not
+               //need to be checked again
+               ipv4UpdateInStats(&netInterface[i], header->destAddr, length);
+
+               //Process the datagram in place
+               ipv4ProcessDatagram(&netInterface[i], buffer, offset,
+                  &rxAncillary);
+            }
+         }
+
+         //Leave the fast path
+         nicLoopbackDepth--;
+
+         //The packet has been consumed
+         error = NO_ERROR;
+      }
+   }
+   else
+#endif
+#if (IPV6_SUPPORT == ENABLED)
+   //IPv6 packet?
+   if(length >= sizeof(Ipv6Header) && (packet[0] >> 4) == 6)
+   {
+      Ipv6Header *header;
+
+      //Point to the IPv6 header
+      header = (Ipv6Header *) packet;
+
+      //Enter the fast path
+      nicLoopbackDepth++;
+
+      //Loop through network interfaces
+      for(i = 0; i < NET_INTERFACE_COUNT; i++)
+      {
+         //Check destination address
+         if(!ipv6CheckDestAddr(&netInterface[i], &header->destAddr))
+         {
+            //Additional options can be passed to the stack along with the
+            //packet
+            rxAncillary = NET_DEFAULT_RX_ANCILLARY;
+            //The packet never left memory
+            rxAncillary.loopback = TRUE;
+
+#if (NET_LATENCY_SUPPORT == ENABLED)
+            //Time stamp the packet as it enters the stack
+            rxAncillary.latencyStart = netLatencyGetTimestamp();
+            rxAncillary.latencyMark = rxAncillary.latencyStart;
+#endif
+            //Process the packet in place
+            ipv6ProcessPacket(&netInterface[i], (NetBuffer *) buffer, offset,
+               &rxAncillary);
+         }
+      }
+
+      //Leave the fast path
+      nicLoopbackDepth--;
+
+      //The packet has been consumed
+      error = NO_ERROR;
+   }
+   else
+#endif
+   //Unknown packet type?
+   {
+      //Let the driver handle the packet
+   }
+
+   //Return status code
+   return error;
+}
+
+#endif
+
+
+/**
+ * @brief Handle a burst of frames received by the network controller
+ *
+ * Interrupts are re-enabled once for the whole burst rather than once per
+ * frame, and Ethernet frames are dispatched without going through the
+ * generic per-frame path
+ *
+ * @param[in] interface Underlying network interface
+ * @param[in] frames Array of received frames
+ * @param[in] count Number of frames in the array
+ **/
+
+void nicProcessBurst(NetInterface *interface, NicRxFrame *frames,
+   uint_t count)
+{
+   uint_t i;
+
+   //Check whether the interface is enabled for operation
+   if(interface->configured && count > 0)
+   {
+#if (ETH_SUPPORT == ENABLED)
+      //Ethernet interface?
+      if(interface->nicDriver->type == NIC_TYPE_ETHERNET)
+      {
+         //Gather entropy
+         netContext.entropy += netGetSystemTickCount();
+
+         //Re-enable interrupts
+         interface->nicDriver->enableIrq(interface);
+
+         //Debug message
+         TRACE_DEBUG("Burst received (%u frames)...\r\n", count);
+
+         //Process incoming Ethernet frames
+         for(i = 0; i < count; i++)
+         {
+            //Time stamp and capture the incoming frame
+            nicTapRxFrame(interface, frames[i].data, frames[i].length,
+               &frames[i].ancillary);
+
+            //Process incoming Ethernet frame
+            ethProcessFrame(interface, frames[i].data, frames[i].length,
+               &frames[i].ancillary);
+         }
+
+         //Disable interrupts
+         interface->nicDriver->disableIrq(interface);
+      }
+      else
+#endif
+      {
+         //Process incoming frames one at a time
+         for(i = 0; i < count; i++)
+         {
+            nicProcessPacket(interface, frames[i].data, frames[i].length,
+               &frames[i].ancillary);
+         }
+      }
+   }
+}
+
+
+/**
+ * @brief Pull received frames from a driver that supports bursts
+ *
+ * The frames returned by the rxBurst entry point remain valid until the
+ * next call. The last call, which returns no frame, lets the driver
+ * release the buffers of the previous burst
+ *
+ * @param[in] interface Underlying network interface
+ **/
+
+void nicReceiveBurst(NetInterface *interface)
+{
+   uint_t n;
+   NicRxFrame frames[NIC_BURST_SIZE];
+
+   //Valid NIC driver with burst support?
+   if(interface->nicDriver != NULL && interface->nicDriver->rxBurst != NULL)
+   {
+      //Drain the receive path
+      do
+      {
+         //Retrieve the next burst of frames
+         n = interface->nicDriver->rxBurst(interface, frames, NIC_BURST_SIZE);
+         //Pass the frames to the upper layer
+         nicProcessBurst(interface, frames, n);
+
+         //Loop until the driver has no more frames to deliver
+      } while(n > 0);
+   }
+}
+
+
+/**
+ * @brief Per-frame processing of incoming frames
+ *
+ * The frame is time stamped as it enters the stack and copied to the capture
+ * ring. This is shared by the single-frame and burst receive paths
+ *
+ * @param[in] interface Underlying network interface
+ * @param[in] frame Incoming frame
+ * @param[in] length Length of the frame
+ * @param[in,out] ancillary Additional options passed to the stack along with
+ *   the frame
+ **/
+
+void nicTapRxFrame(NetInterface *interface, const uint8_t *frame,
+   size_t length, NetRxAncillary *ancillary)
+{
+#if (NET_LATENCY_SUPPORT == ENABLED)
+   //Time stamp the frame as it enters the stack
+   ancillary->latencyStart = netLatencyGetTimestamp();
+   ancillary->latencyMark = ancillary->latencyStart;
+#endif
+
+#if (NET_CAPTURE_SUPPORT == ENABLED)
+   //Packet capture in progress?
+   if(netCaptureContext.running)
+   {
+      //Copy the incoming frame to the capture ring
+      netCaptureProcessRxFrame(interface, frame, length);
+   }
+#endif
+}
+
+
+/**
+ * @brief Per-frame processing of outgoing frames
+ *
+ * The time spent between IP output and the NIC layer is recorded and the
+ * frame is copied to the capture ring. This is shared by the single-frame
+ * and burst transmit paths, whether the frame is then sent by the driver,
+ * looped back or queued to the per-interface task
+ *
+ * @param[in] interface Underlying network interface
+ * @param[in] buffer Multi-part buffer containing the frame
+ * @param[in] offset Offset to the first byte of the frame
+ * @param[in,out] ancillary Additional options passed to the stack along with
+ *   the frame
+ **/
+
+void nicTapTxFrame(NetInterface *interface, const NetBuffer *buffer,
+   size_t offset, NetTxAncillary *ancillary)
+{
+#if (NET_LATENCY_SUPPORT == ENABLED)
+   //Time spent between IP output and the NIC layer
+   netLatencyCheckpoint(interface, NET_LATENCY_STAGE_TX,
+      &ancillary->latencyMark);
+#endif
+
+#if (NET_CAPTURE_SUPPORT == ENABLED)
+   //Packet capture in progress?
+   if(netCaptureContext.running)
+   {
+      //Copy the outgoing frame to the capture ring
+      netCaptureProcessTxFrame(interface, buffer, offset);
+   }
+#endif
+}
+
+
 /**
  * @brief Process link state change notification
  * @param[in] interface Underlying network interface
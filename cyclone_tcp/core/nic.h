@@ -45,6 +45,13 @@
    #error NIC_MAX_BLOCKING_TIME parameter is not valid
 #endif
 
+//Maximum number of frames exchanged with the NIC driver in a single burst
+#ifndef NIC_BURST_SIZE
+   #define NIC_BURST_SIZE 32
+#elif (NIC_BURST_SIZE < 1)
+   #error NIC_BURST_SIZE parameter is not valid
+#endif
+
 //Size of the NIC driver context
 #ifndef NIC_CONTEXT_SIZE
    #define NIC_CONTEXT_SIZE 16
@@ -164,6 +171,30 @@ typedef struct
 } SwitchVlanEntry;
 
 
+/**
+ * @brief Received frame (burst interface)
+ **/
+
+typedef struct
+{
+   uint8_t *data;             ///<Pointer to the frame
+   size_t length;             ///<Length of the frame
+   NetRxAncillary ancillary;  ///<Additional options
+} NicRxFrame;
+
+
+/**
+ * @brief Frame to be transmitted (burst interface)
+ **/
+
+typedef struct
+{
+   const NetBuffer *buffer;   ///<Multi-part buffer containing the frame
+   size_t offset;             ///<Offset to the first byte of the frame
+   NetTxAncillary *ancillary; ///<Additional options
+} NicTxFrame;
+
+
 //NIC driver abstraction layer
 typedef error_t (*NicInit)(NetInterface *interface);
 typedef void (*NicTick)(NetInterface *interface);
@@ -174,6 +205,12 @@ typedef void (*NicEventHandler)(NetInterface *interface);
 typedef error_t (*NicSendPacket)(NetInterface *interface,
    const NetBuffer *buffer, size_t offset, NetTxAncillary *ancillary);
 
+typedef uint_t (*NicRxBurst)(NetInterface *interface, NicRxFrame *frames,
+   uint_t size);
+
+typedef error_t (*NicTxBurst)(NetInterface *interface,
+   const NicTxFrame *frames, uint_t count);
+
 typedef error_t (*NicUpdateMacAddrFilter)(NetInterface *interface);
 typedef error_t (*NicUpdateMacConfig)(NetInterface *interface);
 
@@ -294,6 +331,9 @@ typedef struct
    bool_t autoCrcCalc;
    bool_t autoCrcVerif;
    bool_t autoCrcStrip;
+   bool_t autoTcpSegmentation;
+   NicRxBurst rxBurst;
+   NicTxBurst txBurst;
 } NicDriver;
 
 
@@ -412,11 +452,28 @@ void nicTick(NetInterface *interface);
 error_t nicSendPacket(NetInterface *interface, const NetBuffer *buffer,
    size_t offset, NetTxAncillary *ancillary);
 
+error_t nicSendBurst(NetInterface *interface, const NicTxFrame *frames,
+   uint_t count);
+
 error_t nicUpdateMacAddrFilter(NetInterface *interface);
 
 void nicProcessPacket(NetInterface *interface, uint8_t *packet, size_t length,
    NetRxAncillary *ancillary);
 
+error_t nicProcessLoopbackPacket(NetInterface *interface,
+   const NetBuffer *buffer, size_t offset, NetTxAncillary *ancillary);
+
+void nicProcessBurst(NetInterface *interface, NicRxFrame *frames,
+   uint_t count);
+
+void nicReceiveBurst(NetInterface *interface);
+
+void nicTapRxFrame(NetInterface *interface, const uint8_t *frame,
+   size_t length, NetRxAncillary *ancillary);
+
+void nicTapTxFrame(NetInterface *interface, const NetBuffer *buffer,
+   size_t offset, NetTxAncillary *ancillary);
+
 void nicNotifyLinkChange(NetInterface *interface);
 
 //C++ guard
@@ -31,6 +31,7 @@
 //Dependencies
 #include "core/net.h"
 #include "core/socket.h"
+#include "core/socket_misc.h"
 #include "core/raw_socket.h"
 #include "core/ethernet_misc.h"
 #include "ipv4/ipv4.h"
@@ -1016,6 +1017,11 @@ void rawSocketUpdateEvents(Socket *socket)
       }
    }
 
+#if (SOCKET_EPOLL_SUPPORT == ENABLED)
+   //Notify the epoll instance, if any, before unused events are masked
+   socketEpollNotify(socket, socket->eventFlags);
+#endif
+
    //Mask unused events
    socket->eventFlags &= socket->eventMask;
 
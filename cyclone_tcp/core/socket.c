@@ -45,6 +45,11 @@
 //Socket table
 Socket socketTable[SOCKET_MAX_COUNT];
 
+#if (SOCKET_FREE_LIST_SUPPORT == ENABLED)
+//List of unused sockets
+Socket *socketFreeList;
+#endif
+
 //Default socket message
 const SocketMsg SOCKET_DEFAULT_MSG =
 {
@@ -87,6 +92,11 @@ error_t socketInit(void)
    //Initialize socket descriptors
    osMemset(socketTable, 0, sizeof(socketTable));
 
+#if (SOCKET_FREE_LIST_SUPPORT == ENABLED)
+   //The free list is initially empty
+   socketFreeList = NULL;
+#endif
+
    //Loop through socket descriptors
    for(i = 0; i < SOCKET_MAX_COUNT; i++)
    {
@@ -107,6 +117,14 @@ error_t socketInit(void)
       }
    }
 
+#if (SOCKET_FREE_LIST_SUPPORT == ENABLED)
+   //Add all the sockets to the free list, lowest descriptors first
+   for(i = SOCKET_MAX_COUNT; i > 0; i--)
+   {
+      socketRelease(&socketTable[i - 1]);
+   }
+#endif
+
    //Successful initialization
    return NO_ERROR;
 }
@@ -678,6 +696,12 @@ error_t socketSetTxBufferSize(Socket *socket, size_t size)
 
    //Use the specified buffer size
    socket->txBufferSize = size;
+
+#if (TCP_BUFFER_AUTOTUNE_SUPPORT == ENABLED)
+   //An explicit buffer size disables autotuning
+   socket->bufferAutotune = FALSE;
+#endif
+
    //No error to report
    return NO_ERROR;
 #else
@@ -714,6 +738,62 @@ error_t socketSetRxBufferSize(Socket *socket, size_t size)
 
    //Use the specified buffer size
    socket->rxBufferSize = size;
+
+#if (TCP_BUFFER_AUTOTUNE_SUPPORT == ENABLED)
+   //An explicit buffer size disables autotuning
+   socket->bufferAutotune = FALSE;
+#endif
+
+   //No error to report
+   return NO_ERROR;
+#else
+   return ERROR_NOT_IMPLEMENTED;
+#endif
+}
+
+
+/**
+ * @brief Select the TCP congestion control algorithm
+ * @param[in] socket Handle to a socket
+ * @param[in] name NULL-terminated string identifying the algorithm (for
+ *   instance "newreno" or "cubic")
+ * @return Error code
+ **/
+
+error_t socketSetCongestionAlgo(Socket *socket, const char_t *name)
+{
+#if (TCP_SUPPORT == ENABLED && TCP_CONGEST_CONTROL_SUPPORT == ENABLED)
+   const TcpCongestAlgo *algo;
+
+   //Check parameters
+   if(socket == NULL || name == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //This function shall be used with connection-oriented socket types
+   if(socket->type != SOCKET_TYPE_STREAM)
+      return ERROR_INVALID_SOCKET;
+
+   //Search for the specified algorithm
+   algo = tcpGetCongestAlgo(name);
+   //Unsupported algorithm?
+   if(algo == NULL)
+      return ERROR_UNSUPPORTED_ALGO;
+
+   //Get exclusive access
+   osAcquireMutex(&netMutex);
+
+   //Any change?
+   if(algo != socket->congestAlgo)
+   {
+      //Select the new congestion control algorithm
+      socket->congestAlgo = algo;
+      //Reset the state of the algorithm
+      socket->congestAlgo->cwndEvent(socket, TCP_CONGEST_EVENT_INIT);
+   }
+
+   //Release exclusive access
+   osReleaseMutex(&netMutex);
+
    //No error to report
    return NO_ERROR;
 #else
@@ -1136,6 +1216,245 @@ error_t socketSendMsg(Socket *socket, const SocketMsg *message, uint_t flags)
 }
 
 
+#if (SOCKET_MSG_BATCH_SUPPORT == ENABLED)
+
+/**
+ * @brief Send a batch of messages to a connectionless socket
+ *
+ * The messages are processed under a single lock. For UDP sockets, the source
+ * address selection is performed once for consecutive messages sharing the
+ * same destination. Each datagram still goes through the regular IP output
+ * path, hence the next-hop neighbor is looked up per datagram (in the hashed
+ * ARP/NDP cache) and frames are handed over to the NIC one at a time
+ *
+ * @param[in] socket Handle that identifies a socket
+ * @param[in] messages Array of messages to be transmitted
+ * @param[in] count Number of entries in the array
+ * @param[out] sent Number of messages that have been sent (optional parameter)
+ * @param[in] flags Set of flags that influences the behavior of this function
+ * @return Error code
+ **/
+
+error_t socketSendMsgBatch(Socket *socket, const SocketMsg *messages,
+   uint_t count, uint_t *sent, uint_t flags)
+{
+   error_t error;
+   uint_t i;
+   SocketMsg message;
+#if (UDP_SUPPORT == ENABLED)
+   bool_t valid;
+   IpAddr destIpAddr;
+   IpAddr srcIpAddr;
+   NetInterface *interface;
+   NetInterface *srcInterface;
+#endif
+
+   //No message has been sent yet
+   if(sent != NULL)
+      *sent = 0;
+
+   //Check parameters
+   if(socket == NULL || (messages == NULL && count > 0))
+      return ERROR_INVALID_PARAMETER;
+
+#if (UDP_SUPPORT == ENABLED)
+   //The route cache is initially empty
+   valid = FALSE;
+   interface = NULL;
+   srcInterface = NULL;
+   destIpAddr = IP_ADDR_ANY;
+   srcIpAddr = IP_ADDR_ANY;
+#endif
+
+   //Initialize status code
+   error = NO_ERROR;
+
+   //Get exclusive access
+   osAcquireMutex(&netMutex);
+
+   //Send the messages in order
+   for(i = 0; i < count && !error; i++)
+   {
+      //Point to the current message
+      message = messages[i];
+
+#if (UDP_SUPPORT == ENABLED)
+      //Connectionless socket?
+      if(socket->type == SOCKET_TYPE_DGRAM)
+      {
+         //The source address must be selected by the stack?
+         if(message.srcIpAddr.length == 0)
+         {
+            //Select the relevant network interface
+            if(message.interface == NULL)
+            {
+               message.interface = socket->interface;
+            }
+
+            //Different destination?
+            if(!valid || message.interface != interface ||
+               !ipCompAddr(&message.destIpAddr, &destIpAddr))
+            {
+               //Save the parameters of the lookup
+               interface = message.interface;
+               destIpAddr = message.destIpAddr;
+               srcInterface = message.interface;
+
+               //Select the source address and the outgoing interface
+               valid = !ipSelectSourceAddr(&srcInterface, &destIpAddr,
+                  &srcIpAddr);
+            }
+
+            //Reuse the result of the previous lookup
+            if(valid)
+            {
+               message.interface = srcInterface;
+               message.srcIpAddr = srcIpAddr;
+            }
+         }
+
+         //Send UDP datagram
+         error = udpSendDatagram(socket, &message, flags);
+      }
+      else
+#endif
+#if (RAW_SOCKET_SUPPORT == ENABLED)
+      //Raw socket?
+      if(socket->type == SOCKET_TYPE_RAW_IP)
+      {
+         //Send a raw IP packet
+         error = rawSocketSendIpPacket(socket, &message, flags);
+      }
+      else if(socket->type == SOCKET_TYPE_RAW_ETH)
+      {
+         //Send a raw Ethernet packet
+         error = rawSocketSendEthPacket(socket, &message, flags);
+      }
+      else
+#endif
+      //Invalid socket type?
+      {
+         //Report an error
+         error = ERROR_INVALID_SOCKET;
+      }
+
+      //Check status code
+      if(!error)
+      {
+         //Number of messages that have been sent
+         if(sent != NULL)
+            *sent = i + 1;
+      }
+   }
+
+   //Release exclusive access
+   osReleaseMutex(&netMutex);
+
+   //Return status code
+   return error;
+}
+
+#endif
+
+
+#if (SOCKET_ZERO_COPY_TX_SUPPORT == ENABLED)
+
+/**
+ * @brief Send caller-owned data without copying them
+ *
+ * The data must remain valid until the callback function is invoked. For
+ * connection-oriented sockets, this occurs once the data have been
+ * acknowledged. For connectionless sockets, the datagram is handed over to
+ * the network interface before the function returns
+ *
+ * @param[in] socket Handle that identifies a connected socket
+ * @param[in] data Caller-owned data to be transmitted
+ * @param[in] length Number of data bytes to send
+ * @param[out] written Actual number of bytes written (optional parameter)
+ * @param[in] callback Completion callback (optional parameter)
+ * @param[in] param Callback function parameter
+ * @param[in] flags Set of flags that influences the behavior of this function
+ * @return Error code
+ **/
+
+error_t socketSendZeroCopy(Socket *socket, const void *data, size_t length,
+   size_t *written, SocketTxCallback callback, void *param, uint_t flags)
+{
+   error_t error;
+
+   //No data has been transmitted yet
+   if(written != NULL)
+      *written = 0;
+
+   //Make sure the socket handle is valid
+   if(socket == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Get exclusive access
+   osAcquireMutex(&netMutex);
+
+#if (TCP_SUPPORT == ENABLED)
+   //Connection-oriented socket?
+   if(socket->type == SOCKET_TYPE_STREAM)
+   {
+      //The send buffer references the data until they are acknowledged
+      error = tcpSendZeroCopy(socket, data, length, written, callback, param,
+         flags);
+   }
+   else
+#endif
+#if (UDP_SUPPORT == ENABLED)
+   //Connectionless socket?
+   if(socket->type == SOCKET_TYPE_DGRAM)
+   {
+      SocketMsg message;
+
+      //Initialize structure
+      message = SOCKET_DEFAULT_MSG;
+
+      //Use default remote IP address and port number
+      message.destIpAddr = socket->remoteIpAddr;
+      message.destPort = socket->remotePort;
+
+      //The payload is attached to the datagram as an external chunk
+      message.data = (uint8_t *) data;
+      message.length = length;
+
+      //Send UDP datagram
+      error = udpSendDatagram(socket, &message, flags);
+
+      //Check status code
+      if(!error)
+      {
+         //Total number of data bytes successfully transmitted
+         if(written != NULL)
+            *written = length;
+
+         //The data are no longer referenced by the stack
+         if(callback != NULL)
+         {
+            callback(socket, param, NO_ERROR);
+         }
+      }
+   }
+   else
+#endif
+   //Invalid socket type?
+   {
+      //Report an error
+      error = ERROR_INVALID_SOCKET;
+   }
+
+   //Release exclusive access
+   osReleaseMutex(&netMutex);
+
+   //Return status code
+   return error;
+}
+
+#endif
+
+
 /**
  * @brief Receive data from a connected socket
  * @param[in] socket Handle that identifies a connected socket
@@ -1399,62 +1718,310 @@ error_t socketReceiveMsg(Socket *socket, SocketMsg *message, uint_t flags)
 }
 
 
+#if (SOCKET_MSG_BATCH_SUPPORT == ENABLED)
+
 /**
- * @brief Retrieve the local address for a given socket
+ * @brief Receive a batch of messages from a connectionless socket
+ *
+ * The function waits for the first message only. The messages that are
+ * already queued are then retrieved under the same lock
+ *
  * @param[in] socket Handle that identifies a socket
- * @param[out] localIpAddr Local IP address (optional)
- * @param[out] localPort Local port number (optional)
+ * @param[in,out] messages Array of structures describing the messages
+ * @param[in] count Number of entries in the array
+ * @param[out] received Number of messages that have been received (optional
+ *   parameter)
+ * @param[in] flags Set of flags that influences the behavior of this function
  * @return Error code
  **/
 
-error_t socketGetLocalAddr(Socket *socket, IpAddr *localIpAddr,
-   uint16_t *localPort)
+error_t socketReceiveMsgBatch(Socket *socket, SocketMsg *messages,
+   uint_t count, uint_t *received, uint_t flags)
 {
-   //Make sure the socket handle is valid
-   if(socket == NULL)
-      return ERROR_INVALID_PARAMETER;
-
-   //Retrieve local IP address
-   if(localIpAddr != NULL)
-   {
-      *localIpAddr = socket->localIpAddr;
-   }
-
-   //Retrieve local port number
-   if(localPort != NULL)
-   {
-      *localPort = socket->localPort;
-   }
+   error_t error;
+   uint_t i;
+   uint_t n;
 
-   //Successful processing
-   return NO_ERROR;
-}
+   //No message has been received yet
+   if(received != NULL)
+      *received = 0;
 
+   //Check parameters
+   if(socket == NULL || messages == NULL || count == 0)
+      return ERROR_INVALID_PARAMETER;
 
-/**
- * @brief Retrieve the address of the peer to which a socket is connected
- * @param[in] socket Handle that identifies a socket
- * @param[out] remoteIpAddr IP address of the remote host (optional)
- * @param[out] remotePort Remote port number (optional)
- * @return Error code
- **/
+   //Initialize status code
+   error = NO_ERROR;
+   //Number of messages received so far
+   n = 0;
 
-error_t socketGetRemoteAddr(Socket *socket, IpAddr *remoteIpAddr,
-   uint16_t *remotePort)
-{
-   //Make sure the socket handle is valid
-   if(socket == NULL)
-      return ERROR_INVALID_PARAMETER;
+   //Get exclusive access
+   osAcquireMutex(&netMutex);
 
-   //Retrieve local IP address
-   if(remoteIpAddr != NULL)
+   //Retrieve as many messages as possible
+   for(i = 0; i < count && !error; i++)
    {
-      *remoteIpAddr = socket->remoteIpAddr;
-   }
+      //No data has been received yet
+      messages[i].length = 0;
 
-   //Retrieve local port number
-   if(remotePort != NULL)
-   {
+#if (UDP_SUPPORT == ENABLED)
+      //Connectionless socket?
+      if(socket->type == SOCKET_TYPE_DGRAM)
+      {
+         //Receive UDP datagram
+         error = udpReceiveDatagram(socket, &messages[i], flags);
+      }
+      else
+#endif
+#if (RAW_SOCKET_SUPPORT == ENABLED)
+      //Raw socket?
+      if(socket->type == SOCKET_TYPE_RAW_IP)
+      {
+         //Receive a raw IP packet
+         error = rawSocketReceiveIpPacket(socket, &messages[i], flags);
+      }
+      else if(socket->type == SOCKET_TYPE_RAW_ETH)
+      {
+         //Receive a raw Ethernet packet
+         error = rawSocketReceiveEthPacket(socket, &messages[i], flags);
+      }
+      else
+#endif
+      //Invalid socket type?
+      {
+         //Report an error
+         error = ERROR_INVALID_SOCKET;
+      }
+
+      //Check status code
+      if(!error)
+      {
+         //Number of messages that have been received
+         n = i + 1;
+
+         //Do not wait for subsequent messages
+         flags |= SOCKET_FLAG_DONT_WAIT;
+      }
+   }
+
+   //Release exclusive access
+   osReleaseMutex(&netMutex);
+
+   //The queue was drained after at least one message has been received?
+   if(n > 0)
+   {
+      error = NO_ERROR;
+   }
+
+   //Total number of messages that have been received
+   if(received != NULL)
+      *received = n;
+
+   //Return status code
+   return error;
+}
+
+#endif
+
+
+#if (SOCKET_ZERO_COPY_RX_SUPPORT == ENABLED)
+
+/**
+ * @brief Receive a message without copying its payload
+ *
+ * The application is handed over the multi-part buffer that holds the
+ * message. The buffer is removed from the receive queue and must be returned
+ * to the stack by calling socketReleaseBuffer()
+ *
+ * @param[in] socket Handle that identifies a connectionless socket
+ * @param[out] message Pointer to the structure describing the message
+ * @param[out] buffer Multi-part buffer that holds the payload
+ * @param[out] offset Offset to the first byte of the payload
+ * @param[in] flags Set of flags that influences the behavior of this function
+ * @return Error code
+ **/
+
+error_t socketReceiveBuffer(Socket *socket, SocketMsg *message,
+   NetBuffer **buffer, size_t *offset, uint_t flags)
+{
+   error_t error;
+   SocketQueueItem *queueItem;
+
+   //Check parameters
+   if(socket == NULL || message == NULL || buffer == NULL || offset == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //A loaned buffer cannot be left in the receive queue
+   if((flags & SOCKET_FLAG_PEEK) != 0)
+      return ERROR_INVALID_PARAMETER;
+
+   //No data has been received yet
+   *buffer = NULL;
+   *offset = 0;
+
+   //Only the metadata are copied to the message structure
+   message->data = NULL;
+   message->size = 0;
+   message->length = 0;
+
+   //Get exclusive access
+   osAcquireMutex(&netMutex);
+
+   //Retrieve the metadata of the first message, but leave it in the queue
+   flags |= SOCKET_FLAG_PEEK;
+
+#if (UDP_SUPPORT == ENABLED)
+   //Connectionless socket?
+   if(socket->type == SOCKET_TYPE_DGRAM)
+   {
+      //Wait for a UDP datagram
+      error = udpReceiveDatagram(socket, message, flags);
+   }
+   else
+#endif
+#if (RAW_SOCKET_SUPPORT == ENABLED)
+   //Raw socket?
+   if(socket->type == SOCKET_TYPE_RAW_IP)
+   {
+      //Wait for a raw IP packet
+      error = rawSocketReceiveIpPacket(socket, message, flags);
+   }
+   else if(socket->type == SOCKET_TYPE_RAW_ETH)
+   {
+      //Wait for a raw Ethernet packet
+      error = rawSocketReceiveEthPacket(socket, message, flags);
+   }
+   else
+#endif
+   //Invalid socket type?
+   {
+      //Report an error
+      error = ERROR_INVALID_SOCKET;
+   }
+
+   //Check status code
+   if(!error)
+   {
+      //Point to the first item in the receive queue
+      queueItem = socket->receiveQueue;
+
+      //Remove the item from the receive queue
+      socket->receiveQueue = queueItem->next;
+
+      //The descriptor resides at the beginning of the buffer, the payload
+      //follows it
+      *buffer = queueItem->buffer;
+      *offset = queueItem->offset;
+
+      //Total number of data that have been received
+      message->length = netBufferGetLength(queueItem->buffer) -
+         queueItem->offset;
+
+#if (UDP_SUPPORT == ENABLED)
+      //Connectionless socket?
+      if(socket->type == SOCKET_TYPE_DGRAM)
+      {
+         //Update the state of events
+         udpUpdateEvents(socket);
+      }
+#endif
+#if (RAW_SOCKET_SUPPORT == ENABLED)
+      //Raw socket?
+      if(socket->type == SOCKET_TYPE_RAW_IP ||
+         socket->type == SOCKET_TYPE_RAW_ETH)
+      {
+         //Update the state of events
+         rawSocketUpdateEvents(socket);
+      }
+#endif
+#if (NET_LATENCY_SUPPORT == ENABLED)
+      //Time elapsed since the message was queued
+      netLatencyProcessRead(socket);
+#endif
+   }
+
+   //Release exclusive access
+   osReleaseMutex(&netMutex);
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Return a buffer obtained through socketReceiveBuffer()
+ * @param[in] buffer Multi-part buffer to be released
+ **/
+
+void socketReleaseBuffer(NetBuffer *buffer)
+{
+   //Valid buffer?
+   if(buffer != NULL)
+   {
+      //Deallocate memory buffer
+      netBufferFree(buffer);
+   }
+}
+
+#endif
+
+
+/**
+ * @brief Retrieve the local address for a given socket
+ * @param[in] socket Handle that identifies a socket
+ * @param[out] localIpAddr Local IP address (optional)
+ * @param[out] localPort Local port number (optional)
+ * @return Error code
+ **/
+
+error_t socketGetLocalAddr(Socket *socket, IpAddr *localIpAddr,
+   uint16_t *localPort)
+{
+   //Make sure the socket handle is valid
+   if(socket == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Retrieve local IP address
+   if(localIpAddr != NULL)
+   {
+      *localIpAddr = socket->localIpAddr;
+   }
+
+   //Retrieve local port number
+   if(localPort != NULL)
+   {
+      *localPort = socket->localPort;
+   }
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Retrieve the address of the peer to which a socket is connected
+ * @param[in] socket Handle that identifies a socket
+ * @param[out] remoteIpAddr IP address of the remote host (optional)
+ * @param[out] remotePort Remote port number (optional)
+ * @return Error code
+ **/
+
+error_t socketGetRemoteAddr(Socket *socket, IpAddr *remoteIpAddr,
+   uint16_t *remotePort)
+{
+   //Make sure the socket handle is valid
+   if(socket == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Retrieve local IP address
+   if(remoteIpAddr != NULL)
+   {
+      *remoteIpAddr = socket->remoteIpAddr;
+   }
+
+   //Retrieve local port number
+   if(remotePort != NULL)
+   {
       *remotePort = socket->remotePort;
    }
 
@@ -1522,6 +2089,11 @@ void socketClose(Socket *socket)
    //Get exclusive access
    osAcquireMutex(&netMutex);
 
+#if (SOCKET_EPOLL_SUPPORT == ENABLED)
+   //Remove the socket from its epoll instance, if any
+   socketEpollRemove(socket);
+#endif
+
    //Loop through multicast groups
    for(i = 0; i < SOCKET_MAX_MULTICAST_GROUPS; i++)
    {
@@ -1564,7 +2136,7 @@ void socketClose(Socket *socket)
       }
 
       //Mark the socket as closed
-      socket->type = SOCKET_TYPE_UNUSED;
+      socketRelease(socket);
    }
 #endif
 
@@ -1702,6 +2274,291 @@ error_t socketPoll(SocketEventDesc *eventDesc, uint_t size, OsEvent *extEvent,
 }
 
 
+#if (SOCKET_EPOLL_SUPPORT == ENABLED)
+
+/**
+ * @brief Create an epoll instance
+ *
+ * An epoll instance holds a persistent set of monitored sockets. The sockets
+ *   whose events become signaled are pushed onto a ready list, so that the
+ *   cost of a wait depends on the number of ready sockets only
+ *
+ * @param[out] epoll Pointer to the epoll instance to initialize
+ * @return Error code
+ **/
+
+error_t socketEpollCreate(SocketEpoll *epoll)
+{
+   //Check parameters
+   if(epoll == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Clear the ready list
+   epoll->readyHead = NULL;
+   epoll->readyTail = NULL;
+   epoll->readyCount = 0;
+
+   //Create an event object to get notified of socket events
+   if(!osCreateEvent(&epoll->event))
+   {
+      //Report an error
+      return ERROR_OUT_OF_RESOURCES;
+   }
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Delete an epoll instance
+ * @param[in] epoll Pointer to the epoll instance
+ **/
+
+void socketEpollDelete(SocketEpoll *epoll)
+{
+   uint_t i;
+
+   //Make sure the epoll instance is valid
+   if(epoll == NULL)
+      return;
+
+   //Get exclusive access
+   osAcquireMutex(&netMutex);
+
+   //Loop through socket descriptors
+   for(i = 0; i < SOCKET_MAX_COUNT; i++)
+   {
+      //Socket registered with the epoll instance?
+      if(socketTable[i].epoll == epoll)
+      {
+         //Detach the socket
+         socketEpollRemove(&socketTable[i]);
+      }
+   }
+
+   //Release exclusive access
+   osReleaseMutex(&netMutex);
+
+   //Delete event object
+   osDeleteEvent(&epoll->event);
+}
+
+
+/**
+ * @brief Add, modify or remove a socket from the interest set
+ * @param[in] epoll Pointer to the epoll instance
+ * @param[in] op Operation to be performed (see #SocketEpollOp enumeration)
+ * @param[in] socket Handle that identifies a socket
+ * @param[in] eventMask Logic OR of the requested socket events
+ * @return Error code
+ **/
+
+error_t socketEpollCtl(SocketEpoll *epoll, SocketEpollOp op, Socket *socket,
+   uint_t eventMask)
+{
+   error_t error;
+
+   //Check parameters
+   if(epoll == NULL || socket == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Initialize status code
+   error = NO_ERROR;
+
+   //Get exclusive access
+   osAcquireMutex(&netMutex);
+
+   //Check operation
+   if(op == SOCKET_EPOLL_CTL_ADD)
+   {
+      //A socket can be registered with a single epoll instance
+      if(socket->epoll == NULL)
+      {
+         //Register the socket
+         socket->epoll = epoll;
+         socket->epollEventMask = eventMask;
+         socket->epollEventFlags = 0;
+         socket->epollReady = FALSE;
+         socket->epollNext = NULL;
+
+         //The socket may already be ready to perform I/O
+         socketUpdateEvents(socket);
+      }
+      else
+      {
+         //The socket is already registered
+         error = ERROR_ALREADY_CONNECTED;
+      }
+   }
+   else if(op == SOCKET_EPOLL_CTL_MOD)
+   {
+      //The socket must be registered with the epoll instance
+      if(socket->epoll == epoll)
+      {
+         //Change the set of monitored events
+         socket->epollEventMask = eventMask;
+
+         //Refresh the state of the socket
+         socketUpdateEvents(socket);
+      }
+      else
+      {
+         //The socket is not registered with the epoll instance
+         error = ERROR_NOT_FOUND;
+      }
+   }
+   else if(op == SOCKET_EPOLL_CTL_DEL)
+   {
+      //The socket must be registered with the epoll instance
+      if(socket->epoll == epoll)
+      {
+         //Remove the socket from the interest set
+         socketEpollRemove(socket);
+      }
+      else
+      {
+         //The socket is not registered with the epoll instance
+         error = ERROR_NOT_FOUND;
+      }
+   }
+   else
+   {
+      //Unknown operation
+      error = ERROR_INVALID_PARAMETER;
+   }
+
+   //Release exclusive access
+   osReleaseMutex(&netMutex);
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Wait for sockets of the interest set to become ready
+ *
+ * Sockets are reported in the order they became ready. A socket whose events
+ *   are still signaled is moved back to the end of the ready list (level
+ *   triggered behavior)
+ *
+ * @param[in] epoll Pointer to the epoll instance
+ * @param[out] eventDesc Entries describing the sockets that are ready
+ * @param[in] size Maximum number of entries to return
+ * @param[out] count Number of entries that have been filled
+ * @param[in] timeout Maximum time to wait before returning
+ * @return Error code
+ **/
+
+error_t socketEpollWait(SocketEpoll *epoll, SocketEventDesc *eventDesc,
+   uint_t size, uint_t *count, systime_t timeout)
+{
+   error_t error;
+   uint_t i;
+   uint_t n;
+   Socket *socket;
+   systime_t time;
+   systime_t startTime;
+
+   //Check parameters
+   if(epoll == NULL || eventDesc == NULL || size == 0 || count == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Save current time
+   startTime = osGetSystemTime();
+
+   //Process the ready list until a socket is reported or the timeout elapses
+   while(1)
+   {
+      //Get exclusive access
+      osAcquireMutex(&netMutex);
+
+      //Number of sockets currently in the ready list
+      n = epoll->readyCount;
+
+      //Process the sockets that are in the ready list
+      for(i = 0; n > 0 && i < size; n--)
+      {
+         //Pop the first socket from the ready list
+         socket = epoll->readyHead;
+         epoll->readyHead = socket->epollNext;
+
+         //Update the tail of the ready list if necessary
+         if(epoll->readyHead == NULL)
+         {
+            epoll->readyTail = NULL;
+         }
+
+         //Update the number of sockets in the ready list
+         epoll->readyCount--;
+         socket->epollReady = FALSE;
+         socket->epollNext = NULL;
+
+         //Refresh the state of the socket. The socket is pushed back onto the
+         //ready list if its events are still signaled
+         socketUpdateEvents(socket);
+
+         //Any monitored event in the signaled state?
+         if(socket->epollEventFlags != 0)
+         {
+            //Report the socket
+            eventDesc[i].socket = socket;
+            eventDesc[i].eventMask = socket->epollEventMask;
+            eventDesc[i].eventFlags = socket->epollEventFlags;
+            i++;
+         }
+      }
+
+      //No socket to report?
+      if(i == 0)
+      {
+         //Reset event object
+         osResetEvent(&epoll->event);
+      }
+
+      //Release exclusive access
+      osReleaseMutex(&netMutex);
+
+      //Any socket ready to perform I/O?
+      if(i > 0)
+      {
+         //Return the number of entries that have been filled
+         *count = i;
+         error = NO_ERROR;
+         break;
+      }
+
+      //Get current time
+      time = osGetSystemTime();
+
+      //Check whether the timeout has elapsed
+      if(timeout != INFINITE_DELAY && timeCompare(time, startTime + timeout) >= 0)
+      {
+         //Report a timeout error
+         *count = 0;
+         error = ERROR_TIMEOUT;
+         break;
+      }
+
+      //Block the current task until an event occurs
+      if(timeout == INFINITE_DELAY)
+      {
+         osWaitForEvent(&epoll->event, INFINITE_DELAY);
+      }
+      else
+      {
+         osWaitForEvent(&epoll->event, startTime + timeout - time);
+      }
+   }
+
+   //Return status code
+   return error;
+}
+
+#endif
+
+
 /**
  * @brief Resolve a host name into an IP address
  * @param[in] interface Underlying network interface (optional parameter)
@@ -66,6 +66,41 @@ struct _Socket;
    #error SOCKET_EPHEMERAL_PORT_MAX parameter is not valid
 #endif
 
+//Persistent readiness notification (epoll) support
+#ifndef SOCKET_EPOLL_SUPPORT
+   #define SOCKET_EPOLL_SUPPORT DISABLED
+#elif (SOCKET_EPOLL_SUPPORT != ENABLED && SOCKET_EPOLL_SUPPORT != DISABLED)
+   #error SOCKET_EPOLL_SUPPORT parameter is not valid
+#endif
+
+//Zero-copy receive support
+#ifndef SOCKET_ZERO_COPY_RX_SUPPORT
+   #define SOCKET_ZERO_COPY_RX_SUPPORT DISABLED
+#elif (SOCKET_ZERO_COPY_RX_SUPPORT != ENABLED && SOCKET_ZERO_COPY_RX_SUPPORT != DISABLED)
+   #error SOCKET_ZERO_COPY_RX_SUPPORT parameter is not valid
+#endif
+
+//Zero-copy transmit support
+#ifndef SOCKET_ZERO_COPY_TX_SUPPORT
+   #define SOCKET_ZERO_COPY_TX_SUPPORT DISABLED
+#elif (SOCKET_ZERO_COPY_TX_SUPPORT != ENABLED && SOCKET_ZERO_COPY_TX_SUPPORT != DISABLED)
+   #error SOCKET_ZERO_COPY_TX_SUPPORT parameter is not valid
+#endif
+
+//Batched send and receive operations
+#ifndef SOCKET_MSG_BATCH_SUPPORT
+   #define SOCKET_MSG_BATCH_SUPPORT DISABLED
+#elif (SOCKET_MSG_BATCH_SUPPORT != ENABLED && SOCKET_MSG_BATCH_SUPPORT != DISABLED)
+   #error SOCKET_MSG_BATCH_SUPPORT parameter is not valid
+#endif
+
+//Free list of socket descriptors
+#ifndef SOCKET_FREE_LIST_SUPPORT
+   #define SOCKET_FREE_LIST_SUPPORT DISABLED
+#elif (SOCKET_FREE_LIST_SUPPORT != ENABLED && SOCKET_FREE_LIST_SUPPORT != DISABLED)
+   #error SOCKET_FREE_LIST_SUPPORT parameter is not valid
+#endif
+
 //C++ guard
 #ifdef __cplusplus
 extern "C" {
@@ -251,6 +286,31 @@ typedef struct
 } SocketMsg;
 
 
+/**
+ * @brief Epoll control operations
+ **/
+
+typedef enum
+{
+   SOCKET_EPOLL_CTL_ADD = 1,
+   SOCKET_EPOLL_CTL_DEL = 2,
+   SOCKET_EPOLL_CTL_MOD = 3
+} SocketEpollOp;
+
+
+/**
+ * @brief Epoll instance
+ **/
+
+typedef struct
+{
+   OsEvent event;     ///<Event object used to wake up the waiting task
+   Socket *readyHead; ///<First socket of the ready list
+   Socket *readyTail; ///<Last socket of the ready list
+   uint_t readyCount; ///<Number of sockets in the ready list
+} SocketEpoll;
+
+
 /**
  * @brief Receive queue item
  **/
@@ -297,10 +357,21 @@ struct _Socket
    int8_t vmanDei;                ///<Drop eligible indicator
 #endif
    int_t errnoCode;
+#if (SOCKET_FREE_LIST_SUPPORT == ENABLED)
+   Socket *nextFree;              ///<Next socket in the free list
+   bool_t freeListed;             ///<The socket is in the free list
+#endif
    OsEvent event;
    uint_t eventMask;
    uint_t eventFlags;
    OsEvent *userEvent;
+#if (SOCKET_EPOLL_SUPPORT == ENABLED)
+   SocketEpoll *epoll;            ///<Epoll instance the socket is registered with
+   uint_t epollEventMask;         ///<Events monitored by the epoll instance
+   uint_t epollEventFlags;        ///<Monitored events in the signaled state
+   bool_t epollReady;             ///<The socket is in the ready list
+   Socket *epollNext;             ///<Next socket in the ready list
+#endif
 
 //TCP specific variables
 #if (TCP_SUPPORT == ENABLED)
@@ -335,6 +406,7 @@ struct _Socket
    systime_t rto;                 ///<Retransmission timeout
 
 #if (TCP_CONGEST_CONTROL_SUPPORT == ENABLED)
+   const TcpCongestAlgo *congestAlgo; ///<Congestion control algorithm
    TcpCongestState congestState;  ///<Congestion state
    uint16_t cwnd;                 ///<Congestion window
    uint16_t ssthresh;             ///<Slow start threshold
@@ -343,6 +415,13 @@ struct _Socket
    uint32_t recover;              ///<NewReno modification to TCP's fast recovery algorithm
 #endif
 
+#if (TCP_CONGEST_CONTROL_SUPPORT == ENABLED && TCP_CUBIC_SUPPORT == ENABLED)
+   uint32_t cubicWmax;            ///<Size of the congestion window just before the last reduction
+   uint32_t cubicWest;            ///<Estimate of the congestion window in the Reno-friendly region
+   systime_t cubicK;              ///<Time period to increase the congestion window to Wmax
+   systime_t cubicEpochStart;     ///<Beginning of the current congestion avoidance stage
+#endif
+
 #if (TCP_KEEP_ALIVE_SUPPORT == ENABLED)
    bool_t keepAliveEnabled;       ///<Specifies whether TCP keep-alive mechanism is enabled
    systime_t keepAliveIdle;       ///<Keep-alive idle time
@@ -354,6 +433,7 @@ struct _Socket
 
 #if (TCP_SACK_SUPPORT == ENABLED)
    bool_t sackPermitted;          ///<SACK Permitted option received
+   uint32_t rescueRxt;            ///<Highest sequence number covered by the rescue retransmission
 #endif
 
    TcpSackBlock sackBlock[TCP_MAX_SACK_BLOCKS]; ///<List of non-contiguous blocks that have been received
@@ -361,15 +441,36 @@ struct _Socket
 
    TcpTxBuffer txBuffer;          ///<Send buffer
    size_t txBufferSize;           ///<Size of the send buffer
+#if (TCP_TX_CHECKSUM_CACHE_SUPPORT == ENABLED)
+   uint16_t txBufferChecksum[TCP_TX_CHECKSUM_BLOCK_COUNT]; ///<Partial sums of the send buffer regions
+#endif
+#if (SOCKET_ZERO_COPY_TX_SUPPORT == ENABLED)
+   TcpTxRef txRef[TCP_MAX_TX_REF_COUNT]; ///<Caller-owned data referenced by the send buffer
+   uint_t txRefCount;             ///<Number of caller-owned regions
+#endif
    TcpRxBuffer rxBuffer;          ///<Receive buffer
    size_t rxBufferSize;           ///<Size of the receive buffer
+#if (TCP_BUFFER_AUTOTUNE_SUPPORT == ENABLED)
+   bool_t bufferAutotune;         ///<Buffer sizes are automatically adjusted
+   uint32_t autotuneRcvBytes;     ///<Number of bytes received during the current measurement epoch
+   systime_t autotuneRcvTimestamp; ///<Start of the current measurement epoch
+   systime_t autotuneTimestamp;   ///<Time of the last data transfer
+#endif
 
-   TcpQueueItem *retransmitQueue; ///<Retransmission queue
+   TcpQueueItem retransmitQueue[TCP_MAX_RETRANSMIT_QUEUE_SIZE]; ///<Retransmission queue
+   uint_t retransmitQueueHead;    ///<Index of the oldest segment in the retransmission queue
+   uint_t retransmitQueueLength;  ///<Number of segments in the retransmission queue
    NetTimer retransmitTimer;      ///<Retransmission timer
    uint_t retransmitCount;        ///<Number of retransmissions
 
    TcpSynQueueItem *synQueue;     ///<SYN queue for listening sockets
+   TcpSynQueueItem *synQueueTail; ///<Last item of the SYN queue
+   uint_t synQueueLength;         ///<Number of pending connections for listening sockets
    uint_t synQueueSize;           ///<Maximum number of pending connections for listening sockets
+#if (TCP_SYN_COOKIE_SUPPORT == ENABLED)
+   bool_t synCookieSent;          ///<A SYN cookie has been sent
+   systime_t synCookieTimestamp;  ///<Time at which the last SYN cookie was sent
+#endif
 
    uint_t wndProbeCount;          ///<Zero window probe counter
    systime_t wndProbeInterval;    ///<Interval between successive probes
@@ -384,6 +485,11 @@ struct _Socket
 #if (UDP_SUPPORT == ENABLED || RAW_SOCKET_SUPPORT == ENABLED)
    SocketQueueItem *receiveQueue;
 #endif
+
+#if (NET_LATENCY_SUPPORT == ENABLED)
+   NetLatencyHistogram latencyStats[NET_LATENCY_SOCKET_STAGE_COUNT]; ///<Latency histograms
+   uint32_t latencyTimestamp;     ///<Delivery time of the oldest unread data
+#endif
 };
 
 
@@ -405,6 +511,10 @@ extern const SocketMsg SOCKET_DEFAULT_MSG;
 //Global variables
 extern Socket socketTable[SOCKET_MAX_COUNT];
 
+#if (SOCKET_FREE_LIST_SUPPORT == ENABLED)
+extern Socket *socketFreeList;
+#endif
+
 //Socket related functions
 error_t socketInit(void);
 
@@ -436,6 +546,8 @@ error_t socketSetMaxSegmentSize(Socket *socket, size_t mss);
 error_t socketSetTxBufferSize(Socket *socket, size_t size);
 error_t socketSetRxBufferSize(Socket *socket, size_t size);
 
+error_t socketSetCongestionAlgo(Socket *socket, const char_t *name);
+
 error_t socketSetInterface(Socket *socket, NetInterface *interface);
 NetInterface *socketGetInterface(Socket *socket);
 
@@ -458,6 +570,12 @@ error_t socketSendTo(Socket *socket, const IpAddr *destIpAddr, uint16_t destPort
 
 error_t socketSendMsg(Socket *socket, const SocketMsg *message, uint_t flags);
 
+error_t socketSendMsgBatch(Socket *socket, const SocketMsg *messages,
+   uint_t count, uint_t *sent, uint_t flags);
+
+error_t socketSendZeroCopy(Socket *socket, const void *data, size_t length,
+   size_t *written, SocketTxCallback callback, void *param, uint_t flags);
+
 error_t socketReceive(Socket *socket, void *data,
    size_t size, size_t *received, uint_t flags);
 
@@ -469,6 +587,14 @@ error_t socketReceiveEx(Socket *socket, IpAddr *srcIpAddr, uint16_t *srcPort,
 
 error_t socketReceiveMsg(Socket *socket, SocketMsg *message, uint_t flags);
 
+error_t socketReceiveMsgBatch(Socket *socket, SocketMsg *messages,
+   uint_t count, uint_t *received, uint_t flags);
+
+error_t socketReceiveBuffer(Socket *socket, SocketMsg *message,
+   NetBuffer **buffer, size_t *offset, uint_t flags);
+
+void socketReleaseBuffer(NetBuffer *buffer);
+
 error_t socketGetLocalAddr(Socket *socket, IpAddr *localIpAddr,
    uint16_t *localPort);
 
@@ -481,6 +607,15 @@ void socketClose(Socket *socket);
 error_t socketPoll(SocketEventDesc *eventDesc, uint_t size, OsEvent *extEvent,
    systime_t timeout);
 
+error_t socketEpollCreate(SocketEpoll *epoll);
+void socketEpollDelete(SocketEpoll *epoll);
+
+error_t socketEpollCtl(SocketEpoll *epoll, SocketEpollOp op, Socket *socket,
+   uint_t eventMask);
+
+error_t socketEpollWait(SocketEpoll *epoll, SocketEventDesc *eventDesc,
+   uint_t size, uint_t *count, systime_t timeout);
+
 error_t getHostByName(NetInterface *interface, const char_t *name,
    IpAddr *ipAddr, uint_t flags);
 
@@ -101,16 +101,37 @@ Socket *socketAllocate(uint_t type, uint_t protocol)
    //Check status code
    if(!error)
    {
-      //Loop through socket descriptors
-      for(i = 0; i < SOCKET_MAX_COUNT; i++)
+#if (SOCKET_FREE_LIST_SUPPORT == ENABLED)
+      //Pick the first socket of the free list
+      while(socketFreeList != NULL && socket == NULL)
       {
-         //Unused socket found?
-         if(socketTable[i].type == SOCKET_TYPE_UNUSED)
+         //Remove the socket from the free list
+         socket = socketFreeList;
+         socketFreeList = socket->nextFree;
+         socket->freeListed = FALSE;
+
+         //Skip sockets that have been reused in the meantime
+         if(socket->type != SOCKET_TYPE_UNUSED)
+         {
+            socket = NULL;
+         }
+      }
+
+      //The free list does not track the sockets released by other means
+      if(socket == NULL)
+#endif
+      {
+         //Loop through socket descriptors
+         for(i = 0; i < SOCKET_MAX_COUNT; i++)
          {
-            //Save socket handle
-            socket = &socketTable[i];
-            //We are done
-            break;
+            //Unused socket found?
+            if(socketTable[i].type == SOCKET_TYPE_UNUSED)
+            {
+               //Save socket handle
+               socket = &socketTable[i];
+               //We are done
+               break;
+            }
          }
       }
 
@@ -121,6 +142,16 @@ Socket *socketAllocate(uint_t type, uint_t protocol)
          //Kill the oldest connection in the TIME-WAIT state whenever the
          //socket table runs out of space
          socket = tcpKillOldestConnection();
+
+#if (SOCKET_FREE_LIST_SUPPORT == ENABLED)
+         //The socket has been added at the head of the free list when
+         //released. Take it back before reusing it
+         if(socket != NULL && socketFreeList == socket)
+         {
+            socketFreeList = socket->nextFree;
+            socket->freeListed = FALSE;
+         }
+#endif
       }
 #endif
 
@@ -174,6 +205,22 @@ Socket *socketAllocate(uint_t type, uint_t protocol)
          socket->txBufferSize = MIN(TCP_DEFAULT_TX_BUFFER_SIZE, TCP_MAX_TX_BUFFER_SIZE);
          socket->rxBufferSize = MIN(TCP_DEFAULT_RX_BUFFER_SIZE, TCP_MAX_RX_BUFFER_SIZE);
 #endif
+
+#if (TCP_SUPPORT == ENABLED && TCP_BUFFER_AUTOTUNE_SUPPORT == ENABLED)
+         //Start with the default buffer sizes and let them grow on demand
+         socket->bufferAutotune = TRUE;
+#endif
+
+#if (TCP_SUPPORT == ENABLED && TCP_CONGEST_CONTROL_SUPPORT == ENABLED)
+         //Default congestion control algorithm
+         socket->congestAlgo = tcpGetCongestAlgo(TCP_DEFAULT_CONGEST_ALGO);
+
+         //Fall back to NewReno if the default algorithm is not available
+         if(socket->congestAlgo == NULL)
+         {
+            socket->congestAlgo = &tcpNewRenoAlgo;
+         }
+#endif
       }
    }
 
@@ -182,6 +229,29 @@ Socket *socketAllocate(uint_t type, uint_t protocol)
 }
 
 
+/**
+ * @brief Release a socket
+ * @param[in] socket Handle referencing the socket
+ **/
+
+void socketRelease(Socket *socket)
+{
+   //Mark the socket as closed
+   socket->type = SOCKET_TYPE_UNUSED;
+
+#if (SOCKET_FREE_LIST_SUPPORT == ENABLED)
+   //Make sure the socket is not already in the free list
+   if(!socket->freeListed)
+   {
+      //Add the socket at the head of the free list
+      socket->nextFree = socketFreeList;
+      socket->freeListed = TRUE;
+      socketFreeList = socket;
+   }
+#endif
+}
+
+
 /**
  * @brief Subscribe to the specified socket events
  * @param[in] socket Handle that identifies a socket
@@ -210,28 +280,8 @@ void socketRegisterEvents(Socket *socket, OsEvent *event, uint_t eventMask)
       //Suscribe to get notified of events
       socket->userEvent = event;
 
-#if (TCP_SUPPORT == ENABLED)
-      //Handle TCP specific events
-      if(socket->type == SOCKET_TYPE_STREAM)
-      {
-         tcpUpdateEvents(socket);
-      }
-#endif
-#if (UDP_SUPPORT == ENABLED)
-      //Handle UDP specific events
-      if(socket->type == SOCKET_TYPE_DGRAM)
-      {
-         udpUpdateEvents(socket);
-      }
-#endif
-#if (RAW_SOCKET_SUPPORT == ENABLED)
-      //Handle events that are specific to raw sockets
-      if(socket->type == SOCKET_TYPE_RAW_IP ||
-         socket->type == SOCKET_TYPE_RAW_ETH)
-      {
-         rawSocketUpdateEvents(socket);
-      }
-#endif
+      //Update socket events
+      socketUpdateEvents(socket);
 
       //Release exclusive access
       osReleaseMutex(&netMutex);
@@ -292,3 +342,152 @@ uint_t socketGetEvents(Socket *socket)
    //Return the events in the signaled state
    return eventFlags;
 }
+
+
+/**
+ * @brief Update event flags for a specified socket
+ * @param[in] socket Handle that identifies a socket
+ **/
+
+void socketUpdateEvents(Socket *socket)
+{
+#if (TCP_SUPPORT == ENABLED)
+   //Handle TCP specific events
+   if(socket->type == SOCKET_TYPE_STREAM)
+   {
+      tcpUpdateEvents(socket);
+   }
+#endif
+#if (UDP_SUPPORT == ENABLED)
+   //Handle UDP specific events
+   if(socket->type == SOCKET_TYPE_DGRAM)
+   {
+      udpUpdateEvents(socket);
+   }
+#endif
+#if (RAW_SOCKET_SUPPORT == ENABLED)
+   //Handle events that are specific to raw sockets
+   if(socket->type == SOCKET_TYPE_RAW_IP ||
+      socket->type == SOCKET_TYPE_RAW_ETH)
+   {
+      rawSocketUpdateEvents(socket);
+   }
+#endif
+}
+
+
+#if (SOCKET_EPOLL_SUPPORT == ENABLED)
+
+/**
+ * @brief Notify the epoll instance of the current socket events
+ *
+ * This function is called whenever the event flags of the socket are
+ * updated. A socket with monitored events in the signaled state is pushed
+ * onto the ready list of its epoll instance
+ *
+ * @param[in] socket Handle that identifies a socket
+ * @param[in] eventFlags Logic OR of events in the signaled state
+ **/
+
+void socketEpollNotify(Socket *socket, uint_t eventFlags)
+{
+   SocketEpoll *epoll;
+
+   //Point to the epoll instance the socket is registered with
+   epoll = socket->epoll;
+
+   //Valid epoll instance?
+   if(epoll != NULL)
+   {
+      //Save the monitored events in the signaled state
+      socket->epollEventFlags = eventFlags & socket->epollEventMask;
+
+      //Any monitored event in the signaled state?
+      if(socket->epollEventFlags != 0 && !socket->epollReady)
+      {
+         //Append the socket to the ready list
+         socket->epollNext = NULL;
+
+         if(epoll->readyTail != NULL)
+         {
+            epoll->readyTail->epollNext = socket;
+         }
+         else
+         {
+            epoll->readyHead = socket;
+         }
+
+         //Update the tail of the ready list
+         epoll->readyTail = socket;
+         epoll->readyCount++;
+
+         //The socket is now in the ready list
+         socket->epollReady = TRUE;
+
+         //Wake up the task waiting on the epoll instance
+         osSetEvent(&epoll->event);
+      }
+   }
+}
+
+
+/**
+ * @brief Remove a socket from its epoll instance
+ * @param[in] socket Handle that identifies a socket
+ **/
+
+void socketEpollRemove(Socket *socket)
+{
+   Socket *prev;
+   Socket *cur;
+   SocketEpoll *epoll;
+
+   //Point to the epoll instance the socket is registered with
+   epoll = socket->epoll;
+
+   //Valid epoll instance?
+   if(epoll != NULL)
+   {
+      //Check whether the socket is in the ready list
+      if(socket->epollReady)
+      {
+         //Search the ready list for the socket
+         for(prev = NULL, cur = epoll->readyHead; cur != NULL;
+            prev = cur, cur = cur->epollNext)
+         {
+            //Matching entry?
+            if(cur == socket)
+            {
+               //Unlink the socket from the ready list
+               if(prev != NULL)
+               {
+                  prev->epollNext = cur->epollNext;
+               }
+               else
+               {
+                  epoll->readyHead = cur->epollNext;
+               }
+
+               //Update the tail of the ready list if necessary
+               if(epoll->readyTail == cur)
+               {
+                  epoll->readyTail = prev;
+               }
+
+               //Update the number of sockets in the ready list
+               epoll->readyCount--;
+               break;
+            }
+         }
+      }
+
+      //Detach the socket from the epoll instance
+      socket->epoll = NULL;
+      socket->epollEventMask = 0;
+      socket->epollEventFlags = 0;
+      socket->epollReady = FALSE;
+      socket->epollNext = NULL;
+   }
+}
+
+#endif
@@ -39,10 +39,15 @@ extern "C" {
 
 //Socket related functions
 Socket *socketAllocate(uint_t type, uint_t protocol);
+void socketRelease(Socket *socket);
 
 void socketRegisterEvents(Socket *socket, OsEvent *event, uint_t eventMask);
 void socketUnregisterEvents(Socket *socket);
 uint_t socketGetEvents(Socket *socket);
+void socketUpdateEvents(Socket *socket);
+
+void socketEpollNotify(Socket *socket, uint_t eventFlags);
+void socketEpollRemove(Socket *socket);
 
 //C++ guard
 #ifdef __cplusplus
@@ -35,6 +35,7 @@
 #include "core/tcp.h"
 #include "core/tcp_misc.h"
 #include "core/tcp_timer.h"
+#include "core/tcp_time_wait.h"
 #include "mibs/mib2_module.h"
 #include "mibs/tcp_mib_module.h"
 #include "debug.h"
@@ -59,6 +60,11 @@ error_t tcpInit(void)
    //Reset ephemeral port number
    tcpDynamicPort = 0;
 
+#if (TCP_TIME_WAIT_TABLE_SUPPORT == ENABLED && TCP_2MSL_TIMER > 0)
+   //Clear TIME-WAIT records
+   tcpInitTimeWaitTable();
+#endif
+
    //Successful initialization
    return NO_ERROR;
 }
@@ -236,6 +242,9 @@ error_t tcpConnect(Socket *socket, const IpAddr *remoteIpAddr,
       socket->ssthresh = UINT16_MAX;
       //Recover is set to the initial send sequence number
       socket->recover = socket->iss;
+
+      //Initialize congestion control algorithm
+      socket->congestAlgo->cwndEvent(socket, TCP_CONGEST_EVENT_INIT);
 #endif
 
       //Send a SYN segment
@@ -384,6 +393,11 @@ Socket *tcpAccept(Socket *socket, IpAddr *clientIpAddr, uint16_t *clientPort)
          newSocket->txBufferSize = socket->txBufferSize;
          newSocket->rxBufferSize = socket->rxBufferSize;
 
+#if (TCP_BUFFER_AUTOTUNE_SUPPORT == ENABLED)
+         //Inherit autotuning setting from the listening socket
+         newSocket->bufferAutotune = socket->bufferAutotune;
+#endif
+
 #if (TCP_KEEP_ALIVE_SUPPORT == ENABLED)
          //Inherit keep-alive parameters from the listening socket
          newSocket->keepAliveEnabled = socket->keepAliveEnabled;
@@ -391,6 +405,11 @@ Socket *tcpAccept(Socket *socket, IpAddr *clientIpAddr, uint16_t *clientPort)
          newSocket->keepAliveInterval = socket->keepAliveInterval;
          newSocket->keepAliveMaxProbes = socket->keepAliveMaxProbes;
 #endif
+
+#if (TCP_CONGEST_CONTROL_SUPPORT == ENABLED)
+         //Inherit congestion control algorithm from the listening socket
+         newSocket->congestAlgo = socket->congestAlgo;
+#endif
          //Number of chunks that comprise the TX and the RX buffers
          newSocket->txBuffer.maxChunkCount = arraysize(newSocket->txBuffer.chunk);
          newSocket->rxBuffer.maxChunkCount = arraysize(newSocket->rxBuffer.chunk);
@@ -429,10 +448,21 @@ Socket *tcpAccept(Socket *socket, IpAddr *clientIpAddr, uint16_t *clientPort)
             //willing to accept
             newSocket->rmss = MIN(newSocket->mss, newSocket->rxBufferSize);
 
-            //Generate the initial sequence number
-            newSocket->iss = tcpGenerateInitialSeqNum(&newSocket->localIpAddr,
-               newSocket->localPort, &newSocket->remoteIpAddr,
-               newSocket->remotePort);
+#if (TCP_SYN_COOKIE_SUPPORT == ENABLED)
+            //Connection established by means of a SYN cookie?
+            if(queueItem->synCookie)
+            {
+               //The initial sequence number is the cookie itself
+               newSocket->iss = queueItem->iss;
+            }
+            else
+#endif
+            {
+               //Generate the initial sequence number
+               newSocket->iss = tcpGenerateInitialSeqNum(&newSocket->localIpAddr,
+                  newSocket->localPort, &newSocket->remoteIpAddr,
+                  newSocket->remotePort);
+            }
 
             //Initialize TCP control block
             newSocket->irs = queueItem->isn;
@@ -457,6 +487,10 @@ Socket *tcpAccept(Socket *socket, IpAddr *clientIpAddr, uint16_t *clientPort)
             newSocket->ssthresh = UINT16_MAX;
             //Recover is set to the initial send sequence number
             newSocket->recover = newSocket->iss;
+
+            //Initialize congestion control algorithm
+            newSocket->congestAlgo->cwndEvent(newSocket,
+               TCP_CONGEST_EVENT_INIT);
 #endif
 
 #if (TCP_SACK_SUPPORT == ENABLED)
@@ -473,17 +507,37 @@ Socket *tcpAccept(Socket *socket, IpAddr *clientIpAddr, uint16_t *clientPort)
             MIB2_TCP_INC_COUNTER32(tcpPassiveOpens, 1);
             TCP_MIB_INC_COUNTER32(tcpPassiveOpens, 1);
 
-            //Send a SYN ACK control segment
-            error = tcpSendSegment(newSocket, TCP_FLAG_SYN | TCP_FLAG_ACK,
-               newSocket->iss, newSocket->rcvNxt, 0, TRUE);
+#if (TCP_SYN_COOKIE_SUPPORT == ENABLED)
+            //The three-way handshake has already been completed by means of
+            //a SYN cookie?
+            if(queueItem->synCookie)
+            {
+               //The SYN ACK has been acknowledged by the client
+               newSocket->sndUna = newSocket->iss + 1;
+
+               //Initialize the send window from the final ACK
+               newSocket->sndWnd = queueItem->window;
+               newSocket->sndWl1 = newSocket->irs + 1;
+               newSocket->sndWl2 = newSocket->iss + 1;
+               newSocket->maxSndWnd = queueItem->window;
+
+               //Enter ESTABLISHED state
+               tcpChangeState(newSocket, TCP_STATE_ESTABLISHED);
+               error = NO_ERROR;
+            }
+            else
+#endif
+            {
+               //Send a SYN ACK control segment
+               error = tcpSendSegment(newSocket, TCP_FLAG_SYN | TCP_FLAG_ACK,
+                  newSocket->iss, newSocket->rcvNxt, 0, TRUE);
+            }
 
             //TCP segment successfully sent?
             if(!error)
             {
                //Remove the item from the SYN queue
-               socket->synQueue = queueItem->next;
-               //Deallocate memory buffer
-               memPoolFree(queueItem);
+               tcpRemoveSynQueueItem(socket);
                //Update the state of events
                tcpUpdateEvents(socket);
 
@@ -500,9 +554,7 @@ Socket *tcpAccept(Socket *socket, IpAddr *clientIpAddr, uint16_t *clientPort)
       TRACE_WARNING("Cannot accept TCP connection!\r\n");
 
       //Remove the item from the SYN queue
-      socket->synQueue = queueItem->next;
-      //Deallocate memory buffer
-      memPoolFree(queueItem);
+      tcpRemoveSynQueueItem(socket);
 
       //Wait for the next connection attempt
    }
@@ -542,6 +594,11 @@ error_t tcpSend(Socket *socket, const uint8_t *data, size_t length,
    //Send as much data as possible
    do
    {
+#if (TCP_BUFFER_AUTOTUNE_SUPPORT == ENABLED)
+      //Grow the send buffer if it limits the throughput of the connection
+      tcpAutotuneTxBuffer(socket);
+#endif
+
       //Wait until there is more room in the send buffer
       event = tcpWaitForEvents(socket, SOCKET_EVENT_TX_READY, socket->timeout);
 
@@ -601,6 +658,11 @@ error_t tcpSend(Socket *socket, const uint8_t *data, size_t length,
          if(written != NULL)
             *written = totalLength;
 
+#if (TCP_BUFFER_AUTOTUNE_SUPPORT == ENABLED)
+         //Save the time of the last data transfer
+         socket->autotuneTimestamp = osGetSystemTime();
+#endif
+
          //Update TX events
          tcpUpdateEvents(socket);
 
@@ -642,6 +704,196 @@ error_t tcpSend(Socket *socket, const uint8_t *data, size_t length,
 }
 
 
+#if (SOCKET_ZERO_COPY_TX_SUPPORT == ENABLED)
+
+/**
+ * @brief Send data without copying them to the send buffer
+ *
+ * The send buffer references the caller-owned data until they are
+ * acknowledged by the remote host. The callback function is then invoked to
+ * notify the application that the memory can be reused
+ *
+ * @param[in] socket Handle referencing the socket
+ * @param[in] data Caller-owned data to be transmitted
+ * @param[in] length Number of data bytes to send
+ * @param[out] written Actual number of bytes written (optional parameter)
+ * @param[in] callback Completion callback (optional parameter)
+ * @param[in] param Callback function parameter
+ * @param[in] flags Set of flags that influences the behavior of this function
+ * @return Error code
+ **/
+
+error_t tcpSendZeroCopy(Socket *socket, const uint8_t *data, size_t length,
+   size_t *written, SocketTxCallback callback, void *param, uint_t flags)
+{
+   error_t error;
+   uint_t n;
+   uint_t totalLength;
+   uint_t i;
+   uint_t event;
+   uint32_t seqNum;
+   uint32_t endSeqNum;
+   TcpTxRef *ref;
+
+   //Check whether the socket is in the listening state
+   if(socket->state == TCP_STATE_LISTEN)
+      return ERROR_NOT_CONNECTED;
+
+   //Initialize status code
+   error = NO_ERROR;
+   //Actual number of bytes written
+   totalLength = 0;
+   //Sequence number following the last byte referenced so far
+   endSeqNum = 0;
+
+   //Send as much data as possible
+   while(totalLength < length)
+   {
+      //Wait until there is more room in the send buffer
+      event = tcpWaitForEvents(socket, SOCKET_EVENT_TX_READY, socket->timeout);
+
+      //A timeout exception occurred?
+      if(event != SOCKET_EVENT_TX_READY)
+      {
+         error = ERROR_TIMEOUT;
+         break;
+      }
+
+      //The send buffer is only available in ESTABLISHED or CLOSE-WAIT state
+      if(socket->state != TCP_STATE_ESTABLISHED &&
+         socket->state != TCP_STATE_CLOSE_WAIT)
+      {
+         //Report an error
+         error = (socket->state == TCP_STATE_CLOSED) ? ERROR_NOT_CONNECTED :
+            ERROR_CONNECTION_CLOSING;
+         break;
+      }
+
+      //Determine the actual number of bytes in the send buffer
+      n = socket->sndUser + socket->sndNxt - socket->sndUna;
+      //Number of bytes available for writing
+      n = socket->txBufferSize - n;
+      //Calculate the number of bytes to reference at a time
+      n = MIN(n, length - totalLength);
+
+      //Sequence number of the first byte
+      seqNum = socket->sndNxt + socket->sndUser;
+
+      //Point to the most recent region
+      if(socket->txRefCount > 0)
+      {
+         ref = &socket->txRef[socket->txRefCount - 1];
+      }
+      else
+      {
+         ref = NULL;
+      }
+
+      //Contiguous regions of the same request are merged together
+      if(ref != NULL && ref->callback == NULL &&
+         ref->data + ref->length == data &&
+         ref->seqNum + ref->length == seqNum)
+      {
+         ref->length += n;
+      }
+      else if(socket->txRefCount < TCP_MAX_TX_REF_COUNT)
+      {
+         //Register a new region
+         ref = &socket->txRef[socket->txRefCount++];
+         ref->seqNum = seqNum;
+         ref->data = data;
+         ref->length = n;
+         ref->callback = NULL;
+         ref->param = NULL;
+      }
+      else
+      {
+         //This should never occur since the TX_READY event is not signaled
+         //while the list is full
+         error = ERROR_FAILURE;
+         break;
+      }
+
+      //The data are part of the send buffer, but have not been copied
+      socket->sndUser += n;
+      //Save the sequence number following the last byte
+      endSeqNum = seqNum + n;
+      //Advance data pointer
+      data += n;
+      //Update byte counter
+      totalLength += n;
+
+      //Total number of data that have been written
+      if(written != NULL)
+         *written = totalLength;
+
+      //Update TX events
+      tcpUpdateEvents(socket);
+
+      //To avoid a deadlock, it is necessary to have a timeout to force
+      //transmission of data, overriding the SWS avoidance algorithm
+      if(socket->sndUser == n)
+      {
+         netStartTimer(&socket->overrideTimer, TCP_OVERRIDE_TIMEOUT);
+      }
+
+      //The Nagle algorithm should be implemented to coalesce short segments
+      tcpNagleAlgo(socket, flags);
+   }
+
+   //Any data referenced by the send buffer?
+   if(totalLength > 0 && callback != NULL)
+   {
+      //The list may have been updated while the task was waiting for room
+      for(i = 0; i < socket->txRefCount; i++)
+      {
+         //Search for the region that holds the last byte
+         if(socket->txRef[i].seqNum + socket->txRef[i].length == endSeqNum)
+            break;
+      }
+
+      //Check whether the data are still referenced
+      if(i < socket->txRefCount)
+      {
+         //The application is notified once the region has been acknowledged
+         socket->txRef[i].callback = callback;
+         socket->txRef[i].param = param;
+      }
+      else if(socket->state == TCP_STATE_CLOSED)
+      {
+         //The connection was aborted before the data were acknowledged
+         callback(socket, param, ERROR_NOT_CONNECTED);
+      }
+      else
+      {
+         //The data have already been acknowledged
+         callback(socket, param, NO_ERROR);
+      }
+   }
+
+   //The SOCKET_FLAG_WAIT_ACK flag causes the function to wait for
+   //acknowledgment from the remote side
+   if(!error && (flags & SOCKET_FLAG_WAIT_ACK) != 0)
+   {
+      //Wait for the data to be acknowledged
+      event = tcpWaitForEvents(socket, SOCKET_EVENT_TX_ACKED, socket->timeout);
+
+      //A timeout exception occurred?
+      if(event != SOCKET_EVENT_TX_ACKED)
+         return ERROR_TIMEOUT;
+
+      //The connection closed before an acknowledgment was received?
+      if(socket->state != TCP_STATE_ESTABLISHED && socket->state != TCP_STATE_CLOSE_WAIT)
+         return ERROR_NOT_CONNECTED;
+   }
+
+   //Return status code
+   return error;
+}
+
+#endif
+
+
 /**
  * @brief Receive data from a connected socket
  * @param[in] socket Handle that identifies a connected socket
@@ -772,8 +1024,19 @@ error_t tcpReceive(Socket *socket, uint8_t *data, size_t size,
       //Remaining data still available in the receive buffer
       socket->rcvUser -= n;
 
+#if (NET_LATENCY_SUPPORT == ENABLED)
+      //Time elapsed since the data was queued
+      netLatencyProcessRead(socket);
+#endif
+
       //Update the receive window
       tcpUpdateReceiveWindow(socket);
+
+#if (TCP_BUFFER_AUTOTUNE_SUPPORT == ENABLED)
+      //Grow the receive buffer if it limits the throughput of the connection
+      tcpAutotuneRxBuffer(socket);
+#endif
+
       //Update RX event state
       tcpUpdateEvents(socket);
 
@@ -971,13 +1234,31 @@ error_t tcpAbort(Socket *socket)
       //Delete TCB
       tcpDeleteControlBlock(socket);
       //Mark the socket as closed
-      socket->type = SOCKET_TYPE_UNUSED;
+      socketRelease(socket);
       //Return status code
       return error;
 
    //TIME-WAIT state?
    case TCP_STATE_TIME_WAIT:
 #if (TCP_2MSL_TIMER > 0)
+#if (TCP_TIME_WAIT_TABLE_SUPPORT == ENABLED)
+      //Hand the connection over to a compact TIME-WAIT record so that the
+      //socket can be reused immediately
+      error = tcpCreateTimeWaitEntry(socket);
+
+      //TIME-WAIT record successfully created?
+      if(!error)
+      {
+         //Enter CLOSED state
+         tcpChangeState(socket, TCP_STATE_CLOSED);
+         //Delete TCB
+         tcpDeleteControlBlock(socket);
+         //Mark the socket as closed
+         socketRelease(socket);
+         //No error to report
+         return NO_ERROR;
+      }
+#endif
       //The user doe not own the socket anymore...
       socket->ownedFlag = FALSE;
       //TCB will be deleted and socket will be closed
@@ -989,7 +1270,7 @@ error_t tcpAbort(Socket *socket)
       //Delete TCB
       tcpDeleteControlBlock(socket);
       //Mark the socket as closed
-      socket->type = SOCKET_TYPE_UNUSED;
+      socketRelease(socket);
       //No error to report
       return NO_ERROR;
 #endif
@@ -1001,7 +1282,7 @@ error_t tcpAbort(Socket *socket)
       //Delete TCB
       tcpDeleteControlBlock(socket);
       //Mark the socket as closed
-      socket->type = SOCKET_TYPE_UNUSED;
+      socketRelease(socket);
       //No error to report
       return NO_ERROR;
    }
@@ -1087,7 +1368,7 @@ Socket *tcpKillOldestConnection(void)
       //Delete TCB
       tcpDeleteControlBlock(oldestSocket);
       //Mark the socket as closed
-      oldestSocket->type = SOCKET_TYPE_UNUSED;
+      socketRelease(oldestSocket);
    }
 
    //The oldest connection in the TIME-WAIT state can be reused
@@ -74,6 +74,20 @@
    #error TCP_MAX_TX_BUFFER_SIZE parameter is not valid
 #endif
 
+//Checksum caching for the send buffer
+#ifndef TCP_TX_CHECKSUM_CACHE_SUPPORT
+   #define TCP_TX_CHECKSUM_CACHE_SUPPORT DISABLED
+#elif (TCP_TX_CHECKSUM_CACHE_SUPPORT != ENABLED && TCP_TX_CHECKSUM_CACHE_SUPPORT != DISABLED)
+   #error TCP_TX_CHECKSUM_CACHE_SUPPORT parameter is not valid
+#endif
+
+//Size of the send buffer regions whose checksum is cached
+#ifndef TCP_TX_CHECKSUM_BLOCK_SIZE
+   #define TCP_TX_CHECKSUM_BLOCK_SIZE 128
+#elif (TCP_TX_CHECKSUM_BLOCK_SIZE < 16 || (TCP_TX_CHECKSUM_BLOCK_SIZE % 4) != 0)
+   #error TCP_TX_CHECKSUM_BLOCK_SIZE parameter is not valid
+#endif
+
 //Default buffer size for reception
 #ifndef TCP_DEFAULT_RX_BUFFER_SIZE
    #define TCP_DEFAULT_RX_BUFFER_SIZE 2860
@@ -102,6 +116,48 @@
    #error TCP_MAX_SYN_QUEUE_SIZE parameter is not valid
 #endif
 
+//Hash-indexed SYN queues
+#ifndef TCP_SYN_QUEUE_HASH_SUPPORT
+   #define TCP_SYN_QUEUE_HASH_SUPPORT DISABLED
+#elif (TCP_SYN_QUEUE_HASH_SUPPORT != ENABLED && TCP_SYN_QUEUE_HASH_SUPPORT != DISABLED)
+   #error TCP_SYN_QUEUE_HASH_SUPPORT parameter is not valid
+#endif
+
+//Size of the hash table used to index the SYN queues
+#ifndef TCP_SYN_QUEUE_HASH_SIZE
+   #define TCP_SYN_QUEUE_HASH_SIZE 64
+#elif (TCP_SYN_QUEUE_HASH_SIZE < 1)
+   #error TCP_SYN_QUEUE_HASH_SIZE parameter is not valid
+#endif
+
+//SYN cookies
+#ifndef TCP_SYN_COOKIE_SUPPORT
+   #define TCP_SYN_COOKIE_SUPPORT DISABLED
+#elif (TCP_SYN_COOKIE_SUPPORT != ENABLED && TCP_SYN_COOKIE_SUPPORT != DISABLED)
+   #error TCP_SYN_COOKIE_SUPPORT parameter is not valid
+#endif
+
+//Period of the SYN cookie counter, in milliseconds
+#ifndef TCP_SYN_COOKIE_PERIOD
+   #define TCP_SYN_COOKIE_PERIOD 64000
+#elif (TCP_SYN_COOKIE_PERIOD < 1000)
+   #error TCP_SYN_COOKIE_PERIOD parameter is not valid
+#endif
+
+//Maximum number of segments in the retransmission queue
+#ifndef TCP_MAX_RETRANSMIT_QUEUE_SIZE
+   #define TCP_MAX_RETRANSMIT_QUEUE_SIZE 32
+#elif (TCP_MAX_RETRANSMIT_QUEUE_SIZE < 2)
+   #error TCP_MAX_RETRANSMIT_QUEUE_SIZE parameter is not valid
+#endif
+
+//Maximum number of caller-owned regions referenced by the send buffer
+#ifndef TCP_MAX_TX_REF_COUNT
+   #define TCP_MAX_TX_REF_COUNT 4
+#elif (TCP_MAX_TX_REF_COUNT < 1)
+   #error TCP_MAX_TX_REF_COUNT parameter is not valid
+#endif
+
 //Maximum number of retransmissions
 #ifndef TCP_MAX_RETRIES
    #define TCP_MAX_RETRIES 5
@@ -144,6 +200,18 @@
    #error TCP_CONGEST_CONTROL_SUPPORT parameter is not valid
 #endif
 
+//CUBIC congestion control algorithm
+#ifndef TCP_CUBIC_SUPPORT
+   #define TCP_CUBIC_SUPPORT DISABLED
+#elif (TCP_CUBIC_SUPPORT != ENABLED && TCP_CUBIC_SUPPORT != DISABLED)
+   #error TCP_CUBIC_SUPPORT parameter is not valid
+#endif
+
+//Default congestion control algorithm
+#ifndef TCP_DEFAULT_CONGEST_ALGO
+   #define TCP_DEFAULT_CONGEST_ALGO "newreno"
+#endif
+
 //Number of duplicate ACKs that triggers fast retransmit algorithm
 #ifndef TCP_FAST_RETRANSMIT_THRES
    #define TCP_FAST_RETRANSMIT_THRES 3
@@ -200,6 +268,27 @@
    #error TCP_2MSL_TIMER parameter is not valid
 #endif
 
+//Compact TIME-WAIT records
+#ifndef TCP_TIME_WAIT_TABLE_SUPPORT
+   #define TCP_TIME_WAIT_TABLE_SUPPORT DISABLED
+#elif (TCP_TIME_WAIT_TABLE_SUPPORT != ENABLED && TCP_TIME_WAIT_TABLE_SUPPORT != DISABLED)
+   #error TCP_TIME_WAIT_TABLE_SUPPORT parameter is not valid
+#endif
+
+//Send and receive buffer autotuning
+#ifndef TCP_BUFFER_AUTOTUNE_SUPPORT
+   #define TCP_BUFFER_AUTOTUNE_SUPPORT DISABLED
+#elif (TCP_BUFFER_AUTOTUNE_SUPPORT != ENABLED && TCP_BUFFER_AUTOTUNE_SUPPORT != DISABLED)
+   #error TCP_BUFFER_AUTOTUNE_SUPPORT parameter is not valid
+#endif
+
+//Idle time after which autotuned buffers are shrunk back (in ms)
+#ifndef TCP_BUFFER_AUTOTUNE_IDLE_TIME
+   #define TCP_BUFFER_AUTOTUNE_IDLE_TIME 10000
+#elif (TCP_BUFFER_AUTOTUNE_IDLE_TIME < 1000)
+   #error TCP_BUFFER_AUTOTUNE_IDLE_TIME parameter is not valid
+#endif
+
 //TCP keep-alive support
 #ifndef TCP_KEEP_ALIVE_SUPPORT
    #define TCP_KEEP_ALIVE_SUPPORT DISABLED
@@ -242,6 +331,10 @@
    #error TCP_MAX_SACK_BLOCKS parameter is not valid
 #endif
 
+//Number of cached checksums per send buffer
+#define TCP_TX_CHECKSUM_BLOCK_COUNT ((TCP_MAX_TX_BUFFER_SIZE + \
+   TCP_TX_CHECKSUM_BLOCK_SIZE - 1) / TCP_TX_CHECKSUM_BLOCK_SIZE)
+
 //Maximum TCP header length
 #define TCP_MAX_HEADER_LENGTH 60
 //Default maximum segment size
@@ -250,6 +343,10 @@
 //Sequence number comparison macro
 #define TCP_CMP_SEQ(a, b) ((int32_t) ((a) - (b)))
 
+//Access the n-th segment of the retransmission queue
+#define TCP_RETRANSMIT_QUEUE_ITEM(socket, n) (&(socket)->retransmitQueue[ \
+   ((socket)->retransmitQueueHead + (n)) % TCP_MAX_RETRANSMIT_QUEUE_SIZE])
+
 //C++ guard
 #ifdef __cplusplus
 extern "C" {
@@ -288,6 +385,17 @@ typedef enum
 } TcpCongestState;
 
 
+/**
+ * @brief Congestion control events
+ **/
+
+typedef enum
+{
+   TCP_CONGEST_EVENT_INIT          = 0,
+   TCP_CONGEST_EVENT_RECOVERY_EXIT = 1
+} TcpCongestEvent;
+
+
 /**
  * @brief TCP control flags
  **/
@@ -379,13 +487,13 @@ typedef __packed_struct
  * @brief Retransmission queue item
  **/
 
-typedef struct _TcpQueueItem
+typedef struct
 {
-   struct _TcpQueueItem *next;
-   uint_t length;
-   uint_t sacked;
-   IpPseudoHeader pseudoHeader;
-   uint8_t header[TCP_MAX_HEADER_LENGTH];
+   uint32_t seqNum;
+   uint16_t length;
+   uint8_t flags;
+   bool_t sacked;
+   bool_t retransmitted;
 } TcpQueueItem;
 
 
@@ -405,9 +513,39 @@ typedef struct _TcpSynQueueItem
 #if (TCP_SACK_SUPPORT == ENABLED)
    bool_t sackPermitted;
 #endif
+#if (TCP_SYN_QUEUE_HASH_SUPPORT == ENABLED)
+   struct _TcpSynQueueItem *hashNext;
+   Socket *socket;
+#endif
+#if (TCP_SYN_COOKIE_SUPPORT == ENABLED)
+   bool_t synCookie;
+   uint32_t iss;
+   uint16_t window;
+#endif
 } TcpSynQueueItem;
 
 
+/**
+ * @brief Zero-copy transmission completion callback
+ **/
+
+typedef void (*SocketTxCallback)(Socket *socket, void *param, error_t error);
+
+
+/**
+ * @brief Caller-owned data referenced by the send buffer
+ **/
+
+typedef struct
+{
+   uint32_t seqNum;
+   const uint8_t *data;
+   size_t length;
+   SocketTxCallback callback;
+   void *param;
+} TcpTxRef;
+
+
 /**
  * @brief SACK block
  **/
@@ -419,6 +557,48 @@ typedef struct
 } TcpSackBlock;
 
 
+/**
+ * @brief ACK processing callback
+ **/
+
+typedef void (*TcpCongestOnAck)(Socket *socket, uint_t n, bool_t updateFlag);
+
+
+/**
+ * @brief Loss detection callback (fast retransmit)
+ **/
+
+typedef void (*TcpCongestOnLoss)(Socket *socket);
+
+
+/**
+ * @brief Retransmission timeout callback
+ **/
+
+typedef void (*TcpCongestOnRto)(Socket *socket);
+
+
+/**
+ * @brief Congestion window event callback
+ **/
+
+typedef void (*TcpCongestCwndEvent)(Socket *socket, TcpCongestEvent event);
+
+
+/**
+ * @brief Congestion control algorithm
+ **/
+
+typedef struct
+{
+   const char_t *name;
+   TcpCongestOnAck onAck;
+   TcpCongestOnLoss onLoss;
+   TcpCongestOnRto onRto;
+   TcpCongestCwndEvent cwndEvent;
+} TcpCongestAlgo;
+
+
 /**
  * @brief Transmit buffer
  **/
@@ -462,6 +642,9 @@ Socket *tcpAccept(Socket *socket, IpAddr *clientIpAddr, uint16_t *clientPort);
 error_t tcpSend(Socket *socket, const uint8_t *data, size_t length,
    size_t *written, uint_t flags);
 
+error_t tcpSendZeroCopy(Socket *socket, const uint8_t *data, size_t length,
+   size_t *written, SocketTxCallback callback, void *param, uint_t flags);
+
 error_t tcpReceive(Socket *socket, uint8_t *data, size_t size,
    size_t *received, uint_t flags);
 
@@ -0,0 +1,301 @@
+/**
+ * @file tcp_cubic.c
+ * @brief CUBIC congestion control algorithm
+ *
+ * @section License
+ *
+ * Copyright (C) 2010-2023 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneTCP Eval.
+ *
+ * This software is provided in source form for a short-term evaluation only. The
+ * evaluation license expires 90 days after the date you first download the software.
+ *
+ * If you plan to use this software in a commercial product, you are required to
+ * purchase a commercial license from Oryx Embedded SARL.
+ *
+ * After the 90-day evaluation period, you agree to either purchase a commercial
+ * license or delete all copies of this software. If you wish to extend the
+ * evaluation period, you must contact sales@oryx-embedded.com.
+ *
+ * This evaluation software is provided "as is" without warranty of any kind.
+ * Technical support is available as an option during the evaluation period.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.3.2
+ **/
+
+
+//Switch to the appropriate trace level
+#define TRACE_LEVEL TCP_TRACE_LEVEL
+
+//Dependencies
+#include "core/net.h"
+#include "core/socket.h"
+#include "core/tcp.h"
+#include "core/tcp_misc.h"
+#include "core/tcp_cubic.h"
+#include "debug.h"
+
+//Check TCP/IP stack configuration
+#if (TCP_SUPPORT == ENABLED && TCP_CONGEST_CONTROL_SUPPORT == ENABLED && \
+   TCP_CUBIC_SUPPORT == ENABLED)
+
+
+/**
+ * @brief CUBIC congestion control algorithm
+ **/
+
+const TcpCongestAlgo tcpCubicAlgo =
+{
+   "cubic",
+   tcpCubicOnAck,
+   tcpCubicOnLoss,
+   tcpCubicOnRto,
+   tcpCubicCwndEvent
+};
+
+
+/**
+ * @brief Update the congestion window upon receipt of an ACK
+ * @param[in] socket Handle referencing the current socket
+ * @param[in] n Number of bytes acknowledged by the incoming ACK
+ * @param[in] updateFlag This flag is set once per round-trip time
+ **/
+
+void tcpCubicOnAck(Socket *socket, uint_t n, bool_t updateFlag)
+{
+   uint32_t cwnd;
+   uint32_t target;
+   uint32_t delta;
+   systime_t time;
+
+   //Slow start algorithm is used when cwnd is lower than ssthresh
+   if(socket->cwnd < socket->ssthresh)
+   {
+      //During slow start, TCP increments cwnd by at most SMSS bytes for
+      //each ACK received that cumulatively acknowledges new data
+      socket->cwnd += MIN(n, socket->smss);
+      //We are done
+      return;
+   }
+
+   //Get current time
+   time = osGetSystemTime();
+   //Current value of the congestion window
+   cwnd = socket->cwnd;
+
+   //First ACK received in congestion avoidance stage?
+   if(socket->cubicEpochStart == 0)
+   {
+      //Record the beginning of the current congestion avoidance stage
+      socket->cubicEpochStart = time;
+
+      //Check whether the congestion window is below Wmax
+      if(cwnd < socket->cubicWmax)
+      {
+         //Compute the time period that the cubic function takes to increase
+         //the congestion window to Wmax (refer to RFC 9438, section 4.2)
+         socket->cubicK = tcpCubicRoot((uint64_t) (socket->cubicWmax - cwnd) *
+            1000000000000ULL / ((uint64_t) TCP_CUBIC_C * socket->smss));
+      }
+      else
+      {
+         //The plateau of the cubic function is set to the current window
+         socket->cubicK = 0;
+         socket->cubicWmax = cwnd;
+      }
+
+      //Initialize the estimate of the Reno-friendly window
+      socket->cubicWest = cwnd;
+   }
+
+   //Compute the target window one RTT ahead (refer to RFC 9438, section 4.2)
+   target = tcpCubicComputeWindow(socket, time - socket->cubicEpochStart +
+      socket->srtt);
+
+   //The target window must not exceed 1.5 times the current window
+   target = MIN(target, cwnd + cwnd / 2);
+
+   //Update the estimate of the congestion window in the Reno-friendly region
+   //(refer to RFC 9438, section 4.3)
+   socket->cubicWest += (uint32_t) ((uint64_t) TCP_CUBIC_ALPHA *
+      socket->smss * n / (1000 * cwnd));
+   socket->cubicWest = MIN(socket->cubicWest, UINT16_MAX);
+
+   //Reno-friendly region? (the estimate must exceed the current window,
+   //otherwise the subtraction below would wrap around)
+   if(target < socket->cubicWest && socket->cubicWest > cwnd)
+   {
+      //Set the congestion window to the Reno-friendly estimate
+      delta = socket->cubicWest - cwnd;
+      delta = MIN(delta, socket->smss);
+   }
+   else if(target > cwnd)
+   {
+      //Concave or convex region. The congestion window is increased by
+      //(target - cwnd) / cwnd for each acknowledged segment
+      delta = (target - cwnd) * n / cwnd;
+      delta = MIN(delta, socket->smss);
+   }
+   else
+   {
+      //The congestion window does not need to be increased
+      delta = 0;
+   }
+
+   //Update the congestion window
+   socket->cwnd = (uint16_t) MIN(cwnd + delta, UINT16_MAX);
+}
+
+
+/**
+ * @brief Multiplicative decrease upon fast retransmit
+ * @param[in] socket Handle referencing the current socket
+ **/
+
+void tcpCubicOnLoss(Socket *socket)
+{
+   uint32_t cwnd;
+
+   //Current value of the congestion window
+   cwnd = socket->cwnd;
+
+#if (TCP_CUBIC_FAST_CONVERGENCE_SUPPORT == ENABLED)
+   //With fast convergence, when a congestion event occurs before Wmax has
+   //been reached, Wmax is further reduced to release bandwidth for new flows
+   //(refer to RFC 9438, section 4.7)
+   if(cwnd < socket->cubicWmax)
+   {
+      socket->cubicWmax = cwnd * (1000 + TCP_CUBIC_BETA) / 2000;
+   }
+   else
+#endif
+   {
+      //Remember the size of the congestion window before the reduction
+      socket->cubicWmax = cwnd;
+   }
+
+   //Apply the multiplicative decrease factor (refer to RFC 9438,
+   //section 4.6)
+   socket->ssthresh = MAX(cwnd * TCP_CUBIC_BETA / 1000, 2 * socket->smss);
+
+   //Start a new congestion avoidance stage on the next ACK
+   socket->cubicEpochStart = 0;
+}
+
+
+/**
+ * @brief Multiplicative decrease upon retransmission timeout
+ * @param[in] socket Handle referencing the current socket
+ **/
+
+void tcpCubicOnRto(Socket *socket)
+{
+   //The slow start threshold and Wmax are updated as for a congestion event
+   //detected by duplicate ACKs (refer to RFC 9438, section 4.8)
+   tcpCubicOnLoss(socket);
+}
+
+
+/**
+ * @brief Congestion window event notification
+ * @param[in] socket Handle referencing the current socket
+ * @param[in] event Congestion window event
+ **/
+
+void tcpCubicCwndEvent(Socket *socket, TcpCongestEvent event)
+{
+   //Check event type
+   if(event == TCP_CONGEST_EVENT_INIT)
+   {
+      //Reset CUBIC state variables
+      socket->cubicWmax = 0;
+      socket->cubicWest = 0;
+      socket->cubicK = 0;
+      socket->cubicEpochStart = 0;
+   }
+   else if(event == TCP_CONGEST_EVENT_RECOVERY_EXIT)
+   {
+      //A new congestion avoidance stage starts with the next ACK
+      socket->cubicEpochStart = 0;
+   }
+   else
+   {
+      //Unknown event
+   }
+}
+
+
+/**
+ * @brief Evaluate the cubic window growth function
+ * @param[in] socket Handle referencing the current socket
+ * @param[in] t Time elapsed since the beginning of the current congestion
+ *   avoidance stage, in milliseconds
+ * @return Value of W_cubic(t), in bytes
+ **/
+
+uint32_t tcpCubicComputeWindow(Socket *socket, systime_t t)
+{
+   int64_t d;
+   int64_t delta;
+   int64_t w;
+
+   //Compute (t - K)
+   d = (int64_t) t - (int64_t) socket->cubicK;
+
+   //Limit the time offset to avoid arithmetic overflows
+   d = MIN(d, TCP_CUBIC_MAX_TIME_OFFSET);
+   d = MAX(d, -TCP_CUBIC_MAX_TIME_OFFSET);
+
+   //Evaluate C * (t - K)^3, expressed in bytes (refer to RFC 9438,
+   //section 4.2)
+   delta = (d * d * d) / 1000000;
+   delta = delta * TCP_CUBIC_C * socket->smss / 1000000;
+
+   //W_cubic(t) = C * (t - K)^3 + Wmax
+   w = (int64_t) socket->cubicWmax + delta;
+
+   //The congestion window cannot be smaller than one segment
+   w = MAX(w, socket->smss);
+   w = MIN(w, UINT16_MAX);
+
+   //Return the value of the cubic function
+   return (uint32_t) w;
+}
+
+
+/**
+ * @brief Integer cube root
+ * @param[in] x Input value
+ * @return Largest integer y such that y^3 <= x
+ **/
+
+uint32_t tcpCubicRoot(uint64_t x)
+{
+   int_t s;
+   uint64_t y;
+   uint64_t b;
+
+   //Initialize result
+   y = 0;
+
+   //Compute the cube root one bit at a time
+   for(s = 63; s >= 0; s -= 3)
+   {
+      y <<= 1;
+      b = 3 * y * (y + 1) + 1;
+
+      //Check whether the current bit must be set
+      if((x >> s) >= b)
+      {
+         x -= b << s;
+         y++;
+      }
+   }
+
+   //Return the integer cube root
+   return (uint32_t) y;
+}
+
+#endif
@@ -0,0 +1,85 @@
+/**
+ * @file tcp_cubic.h
+ * @brief CUBIC congestion control algorithm
+ *
+ * @section License
+ *
+ * Copyright (C) 2010-2023 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneTCP Eval.
+ *
+ * This software is provided in source form for a short-term evaluation only. The
+ * evaluation license expires 90 days after the date you first download the software.
+ *
+ * If you plan to use this software in a commercial product, you are required to
+ * purchase a commercial license from Oryx Embedded SARL.
+ *
+ * After the 90-day evaluation period, you agree to either purchase a commercial
+ * license or delete all copies of this software. If you wish to extend the
+ * evaluation period, you must contact sales@oryx-embedded.com.
+ *
+ * This evaluation software is provided "as is" without warranty of any kind.
+ * Technical support is available as an option during the evaluation period.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.3.2
+ **/
+
+
+#ifndef _TCP_CUBIC_H
+#define _TCP_CUBIC_H
+
+//Dependencies
+#include "core/tcp.h"
+
+//Scaling constant that determines the aggressiveness of window increase
+//(expressed in thousandths, 0.4 by default)
+#ifndef TCP_CUBIC_C
+   #define TCP_CUBIC_C 400
+#elif (TCP_CUBIC_C < 1)
+   #error TCP_CUBIC_C parameter is not valid
+#endif
+
+//Multiplicative decrease factor (expressed in thousandths, 0.7 by default)
+#ifndef TCP_CUBIC_BETA
+   #define TCP_CUBIC_BETA 700
+#elif (TCP_CUBIC_BETA < 500 || TCP_CUBIC_BETA > 999)
+   #error TCP_CUBIC_BETA parameter is not valid
+#endif
+
+//Fast convergence
+#ifndef TCP_CUBIC_FAST_CONVERGENCE_SUPPORT
+   #define TCP_CUBIC_FAST_CONVERGENCE_SUPPORT ENABLED
+#elif (TCP_CUBIC_FAST_CONVERGENCE_SUPPORT != ENABLED && TCP_CUBIC_FAST_CONVERGENCE_SUPPORT != DISABLED)
+   #error TCP_CUBIC_FAST_CONVERGENCE_SUPPORT parameter is not valid
+#endif
+
+//Additive increase factor used in the Reno-friendly region
+#define TCP_CUBIC_ALPHA (3 * (1000 - TCP_CUBIC_BETA) * 1000 / (1000 + TCP_CUBIC_BETA))
+
+//Maximum time offset used when evaluating the cubic function (in ms)
+#define TCP_CUBIC_MAX_TIME_OFFSET 100000
+
+//C++ guard
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//CUBIC congestion control algorithm
+extern const TcpCongestAlgo tcpCubicAlgo;
+
+//CUBIC related functions
+void tcpCubicOnAck(Socket *socket, uint_t n, bool_t updateFlag);
+void tcpCubicOnLoss(Socket *socket);
+void tcpCubicOnRto(Socket *socket);
+void tcpCubicCwndEvent(Socket *socket, TcpCongestEvent event);
+
+uint32_t tcpCubicComputeWindow(Socket *socket, systime_t t);
+uint32_t tcpCubicRoot(uint64_t x);
+
+//C++ guard
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -36,6 +36,7 @@
 #include "core/tcp_fsm.h"
 #include "core/tcp_misc.h"
 #include "core/tcp_timer.h"
+#include "core/tcp_time_wait.h"
 #include "ipv4/ipv4.h"
 #include "ipv4/ipv4_misc.h"
 #include "ipv6/ipv6.h"
@@ -67,6 +68,9 @@ void tcpProcessSegment(NetInterface *interface,
    Socket *socket;
    Socket *passiveSocket;
    TcpHeader *segment;
+#if (NET_LATENCY_SUPPORT == ENABLED)
+   uint16_t rcvUser;
+#endif
 
    //Total number of segments received, including those received in error
    MIB2_TCP_INC_COUNTER32(tcpInSegs, 1);
@@ -140,6 +144,14 @@ void tcpProcessSegment(NetInterface *interface,
       return;
    }
 
+#if (NET_LOOPBACK_FAST_PATH_SUPPORT == ENABLED)
+   //Segments delivered by the loopback fast path never left memory
+   if(ancillary->loopback)
+   {
+      //The checksum does not need to be verified
+   }
+   else
+#endif
    //Verify TCP checksum
    if(ipCalcUpperLayerChecksumEx(pseudoHeader->data,
       pseudoHeader->length, buffer, offset, length) != 0x0000)
@@ -304,6 +316,17 @@ void tcpProcessSegment(NetInterface *interface,
    segment->window = ntohs(segment->window);
    segment->urgentPointer = ntohs(segment->urgentPointer);
 
+#if (TCP_TIME_WAIT_TABLE_SUPPORT == ENABLED && TCP_2MSL_TIMER > 0)
+   //Connections whose socket has been released in the TIME-WAIT state are
+   //tracked by compact records
+   if(i >= SOCKET_MAX_COUNT)
+   {
+      //Check whether the segment matches a TIME-WAIT record
+      if(tcpProcessTimeWaitSegment(interface, pseudoHeader, segment, length))
+         return;
+   }
+#endif
+
    //Specified port unreachable?
    if(socket == NULL)
    {
@@ -318,6 +341,11 @@ void tcpProcessSegment(NetInterface *interface,
       return;
    }
 
+#if (NET_LATENCY_SUPPORT == ENABLED)
+   //Save the amount of data not yet consumed by the application
+   rcvUser = socket->rcvUser;
+#endif
+
    //Check current state
    switch(socket->state)
    {
@@ -409,6 +437,14 @@ void tcpProcessSegment(NetInterface *interface,
       //Silently discard incoming packet
       break;
    }
+
+#if (NET_LATENCY_SUPPORT == ENABLED)
+   //New data have been made available to the application?
+   if(socket->rcvUser > rcvUser)
+   {
+      netLatencyProcessDelivery(interface, socket, ancillary);
+   }
+#endif
 }
 
 
@@ -455,7 +491,7 @@ void tcpStateClosed(NetInterface *interface, const IpPseudoHeader *pseudoHeader,
 void tcpStateListen(Socket *socket, NetInterface *interface,
    const IpPseudoHeader *pseudoHeader, const TcpHeader *segment, size_t length)
 {
-   uint_t i;
+   uint16_t mss;
    const TcpOption *option;
    TcpSynQueueItem *queueItem;
 
@@ -470,6 +506,11 @@ void tcpStateListen(Socket *socket, NetInterface *interface,
    //LISTEN state
    if((segment->flags & TCP_FLAG_ACK) != 0)
    {
+#if (TCP_SYN_COOKIE_SUPPORT == ENABLED)
+      //The ACK may complete a handshake that was answered with a SYN cookie
+      if(!tcpProcessSynCookie(socket, interface, pseudoHeader, segment))
+         return;
+#endif
       //A reset segment should be formed for any arriving ACK-bearing segment
       tcpRejectSegment(interface, pseudoHeader, segment, length);
       //Return immediately
@@ -483,122 +524,60 @@ void tcpStateListen(Socket *socket, NetInterface *interface,
       if(tcpIsDuplicateSyn(socket, pseudoHeader, segment))
          return;
 
-      //Check whether the SYN queue is empty or not
-      if(socket->synQueue != NULL)
-      {
-         //Point to the very first item
-         queueItem = socket->synQueue;
+      //Get the Maximum Segment Size option
+      option = tcpGetOption(segment, TCP_OPTION_MAX_SEGMENT_SIZE);
 
-         //Reach the last item in the SYN queue
-         for(i = 1; queueItem->next != NULL; i++)
-         {
-            queueItem = queueItem->next;
-         }
+      //Specified option found?
+      if(option != NULL && option->length == 4)
+      {
+         //Retrieve MSS value
+         mss = LOAD16BE(option->value);
 
-         //Check whether the SYN queue is full
-         if(i >= socket->synQueueSize)
-         {
-            //Remove the first item if the SYN queue runs out of space
-            queueItem = socket->synQueue;
-            socket->synQueue = queueItem->next;
-            //Deallocate memory buffer
-            memPoolFree(queueItem);
-         }
-      }
+         //Debug message
+         TRACE_DEBUG("Remote host MSS = %" PRIu16 "\r\n", mss);
 
-      //Check whether the SYN queue is empty or not
-      if(socket->synQueue == NULL)
-      {
-         //Allocate memory to save incoming data
-         queueItem = memPoolAlloc(sizeof(TcpSynQueueItem));
-         //Add the newly created item to the queue
-         socket->synQueue = queueItem;
+         //Make sure that the MSS advertised by the peer is acceptable
+         mss = MIN(mss, socket->mss);
+         mss = MAX(mss, TCP_MIN_MSS);
       }
       else
       {
-         //Point to the very first item
-         queueItem = socket->synQueue;
-
-         //Reach the last item in the SYN queue
-         for(i = 1; queueItem->next != NULL; i++)
-         {
-            queueItem = queueItem->next;
-         }
-
-         //Allocate memory to save incoming data
-         queueItem->next = memPoolAlloc(sizeof(TcpSynQueueItem));
-         //Point to the newly created item
-         queueItem = queueItem->next;
+         //If the option is not received, TCP must assume the default MSS
+         mss = MIN(socket->mss, TCP_DEFAULT_MSS);
       }
 
-      //Failed to allocate memory?
-      if(queueItem == NULL)
+      //Check whether the SYN queue is full
+      if(socket->synQueueLength >= socket->synQueueSize)
+      {
+#if (TCP_SYN_COOKIE_SUPPORT == ENABLED)
+         //Answer with a SYN cookie rather than dropping a pending request
+         tcpSendSynCookie(socket, interface, pseudoHeader, segment, mss);
+         //We are done
          return;
+#else
+         //Remove the first item if the SYN queue runs out of space
+         tcpRemoveSynQueueItem(socket);
+#endif
+      }
 
-#if (IPV4_SUPPORT == ENABLED)
-      //IPv4 is currently used?
-      if(pseudoHeader->length == sizeof(Ipv4PseudoHeader))
-      {
-         //Save the source IPv4 address
-         queueItem->srcAddr.length = sizeof(Ipv4Addr);
-         queueItem->srcAddr.ipv4Addr = pseudoHeader->ipv4Data.srcAddr;
+      //Allocate a new item
+      queueItem = tcpCreateSynQueueItem(interface, pseudoHeader, segment);
 
-         //Save the destination IPv4 address
-         queueItem->destAddr.length = sizeof(Ipv4Addr);
-         queueItem->destAddr.ipv4Addr = pseudoHeader->ipv4Data.destAddr;
-      }
-      else
-#endif
-#if (IPV6_SUPPORT == ENABLED)
-      //IPv6 is currently used?
-      if(pseudoHeader->length == sizeof(Ipv6PseudoHeader))
+      //Failed to allocate memory?
+      if(queueItem == NULL)
       {
-         //Save the source IPv6 address
-         queueItem->srcAddr.length = sizeof(Ipv6Addr);
-         queueItem->srcAddr.ipv6Addr = pseudoHeader->ipv6Data.srcAddr;
-
-         //Save the destination IPv6 address
-         queueItem->destAddr.length = sizeof(Ipv6Addr);
-         queueItem->destAddr.ipv6Addr = pseudoHeader->ipv6Data.destAddr;
-      }
-      else
+#if (TCP_SYN_COOKIE_SUPPORT == ENABLED)
+         //The connection request can still be answered without any state
+         tcpSendSynCookie(socket, interface, pseudoHeader, segment, mss);
 #endif
-      //Invalid pseudo header?
-      {
-         //This should never occur...
+         //We are done
          return;
       }
 
-      //Initialize next field
-      queueItem->next = NULL;
-      //Underlying network interface
-      queueItem->interface = interface;
-      //Save the port number of the client
-      queueItem->srcPort = segment->srcPort;
       //Save the initial sequence number
       queueItem->isn = segment->seqNum;
-
-      //Get the Maximum Segment Size option
-      option = tcpGetOption(segment, TCP_OPTION_MAX_SEGMENT_SIZE);
-
-      //Specified option found?
-      if(option != NULL && option->length == 4)
-      {
-         //Retrieve MSS value
-         queueItem->mss = LOAD16BE(option->value);
-
-         //Debug message
-         TRACE_DEBUG("Remote host MSS = %" PRIu16 "\r\n", queueItem->mss);
-
-         //Make sure that the MSS advertised by the peer is acceptable
-         queueItem->mss = MIN(queueItem->mss, socket->mss);
-         queueItem->mss = MAX(queueItem->mss, TCP_MIN_MSS);
-      }
-      else
-      {
-         //If the option is not received, TCP must assume the default MSS
-         queueItem->mss = MIN(socket->mss, TCP_DEFAULT_MSS);
-      }
+      //Save the maximum segment size
+      queueItem->mss = mss;
 
 #if (TCP_SACK_SUPPORT == ENABLED)
       //Get the SACK Permitted option
@@ -617,6 +596,9 @@ void tcpStateListen(Socket *socket, NetInterface *interface,
       }
 #endif
 
+      //Add the newly created item to the SYN queue
+      tcpAddSynQueueItem(socket, queueItem);
+
       //Notify user that a connection request is pending
       tcpUpdateEvents(socket);
 
@@ -31,10 +31,12 @@
 //Dependencies
 #include "core/net.h"
 #include "core/socket.h"
+#include "core/socket_misc.h"
 #include "core/tcp.h"
 #include "core/tcp_misc.h"
 #include "core/tcp_timer.h"
 #include "core/ip.h"
+#include "core/net_gso.h"
 #include "ipv4/ipv4.h"
 #include "ipv6/ipv6.h"
 #include "mibs/mib2_module.h"
@@ -42,14 +44,69 @@
 #include "date_time.h"
 #include "debug.h"
 
-//Secure initial sequence number generation?
-#if (TCP_SECURE_ISN_SUPPORT == ENABLED)
+//Secure initial sequence number generation or SYN cookies?
+#if (TCP_SECURE_ISN_SUPPORT == ENABLED || TCP_SYN_COOKIE_SUPPORT == ENABLED)
    #include "hash/md5.h"
 #endif
 
+//CUBIC congestion control algorithm?
+#if (TCP_CUBIC_SUPPORT == ENABLED)
+   #include "core/tcp_cubic.h"
+#endif
+
 //Check TCP/IP stack configuration
 #if (TCP_SUPPORT == ENABLED)
 
+#if (TCP_CONGEST_CONTROL_SUPPORT == ENABLED)
+
+/**
+ * @brief NewReno congestion control algorithm
+ **/
+
+const TcpCongestAlgo tcpNewRenoAlgo =
+{
+   "newreno",
+   tcpNewRenoOnAck,
+   tcpNewRenoOnLoss,
+   tcpNewRenoOnRto,
+   tcpNewRenoCwndEvent
+};
+
+
+/**
+ * @brief List of supported congestion control algorithms
+ **/
+
+static const TcpCongestAlgo *const tcpCongestAlgoList[] =
+{
+   &tcpNewRenoAlgo,
+#if (TCP_CUBIC_SUPPORT == ENABLED)
+   &tcpCubicAlgo,
+#endif
+};
+
+#endif
+
+#if (TCP_SYN_QUEUE_HASH_SUPPORT == ENABLED)
+
+//Hash table indexing the SYN queues of all listening sockets
+static TcpSynQueueItem *tcpSynQueueHashTable[TCP_SYN_QUEUE_HASH_SIZE];
+
+#endif
+
+#if (TCP_SYN_COOKIE_SUPPORT == ENABLED)
+
+/**
+ * @brief MSS values that can be encoded in a SYN cookie
+ **/
+
+static const uint16_t tcpSynCookieMssTable[8] =
+{
+   64, 536, 1024, 1220, 1360, 1400, 1440, 1460
+};
+
+#endif
+
 
 /**
  * @brief Send a TCP segment
@@ -66,17 +123,14 @@ error_t tcpSendSegment(Socket *socket, uint8_t flags, uint32_t seqNum,
    uint32_t ackNum, size_t length, bool_t addToQueue)
 {
    error_t error;
-   uint16_t mss;
    size_t offset;
-   size_t totalLength;
    NetBuffer *buffer;
    TcpHeader *segment;
-   TcpQueueItem *queueItem;
    IpPseudoHeader pseudoHeader;
    NetTxAncillary ancillary;
-
-   //Maximum segment size
-   mss = HTONS(socket->rmss);
+#if (NET_GSO_SUPPORT == ENABLED)
+   size_t i;
+#endif
 
    //Allocate a memory buffer to hold the TCP segment
    buffer = ipAllocBuffer(TCP_MAX_HEADER_LENGTH, &offset);
@@ -84,191 +138,58 @@ error_t tcpSendSegment(Socket *socket, uint8_t flags, uint32_t seqNum,
    if(buffer == NULL)
       return ERROR_OUT_OF_MEMORY;
 
-   //Point to the beginning of the TCP segment
-   segment = netBufferAt(buffer, offset);
-
-   //Format TCP header
-   segment->srcPort = htons(socket->localPort);
-   segment->destPort = htons(socket->remotePort);
-   segment->seqNum = htonl(seqNum);
-   segment->ackNum = (flags & TCP_FLAG_ACK) ? htonl(ackNum) : 0;
-   segment->reserved1 = 0;
-   segment->dataOffset = sizeof(TcpHeader) / 4;
-   segment->flags = flags;
-   segment->reserved2 = 0;
-   segment->window = htons(socket->rcvWnd);
-   segment->checksum = 0;
-   segment->urgentPointer = 0;
-
-   //SYN flag set?
-   if((flags & TCP_FLAG_SYN) != 0)
-   {
-      //Append Maximum Segment Size option
-      tcpAddOption(segment, TCP_OPTION_MAX_SEGMENT_SIZE, &mss, sizeof(mss));
-   }
-
-#if (TCP_SACK_SUPPORT == ENABLED)
-   //SYN flag set?
-   if((flags & TCP_FLAG_SYN) != 0)
-   {
-      //Append SACK Permitted option
-      tcpAddOption(segment, TCP_OPTION_SACK_PERMITTED, NULL, 0);
-   }
+   //Format TCP segment
+   error = tcpFormatSegment(socket, flags, seqNum, ackNum, length, buffer,
+      offset, &pseudoHeader);
 
-   //ACK flag set?
-   if((flags & TCP_FLAG_ACK) != 0)
+   //Check status code
+   if(!error)
    {
-      //If the data receiver has not received a SACK Permitted option for a
-      //given connection, it must not send SACK options on that connection
-      if(socket->sackPermitted)
+      //Add current segment to retransmission queue?
+      if(addToQueue)
       {
-         //SACK options should be included in all ACKs which do not ACK the
-         //highest sequence number in the data receiver's queue. In this
-         //situation the network has lost or mis-ordered data, such that the
-         //receiver holds non-contiguous data in its queue
-         if(socket->sackBlockCount > 0 &&
-            socket->sackBlockCount <= TCP_MAX_SACK_BLOCKS)
+#if (NET_GSO_SUPPORT == ENABLED)
+         //Super-segment?
+         if(length > socket->smss)
          {
-            uint_t i;
-            uint32_t data[TCP_MAX_SACK_BLOCKS * 2];
-
-            //This option contains a list of some of the blocks of contiguous
-            //sequence space occupied by data that has been received and queued
-            //within the window
-            for(i = 0; i < socket->sackBlockCount; i++)
+            //The super-segment is tracked as a series of full-sized segments
+            //so that SACK and retransmission operate at MSS granularity
+            for(i = 0; i < length && !error; i += socket->smss)
             {
-               data[i * 2] = htonl(socket->sackBlock[i].leftEdge);
-               data[i * 2 + 1] = htonl(socket->sackBlock[i].rightEdge);
+               error = tcpAddRetransmitQueueItem(socket, flags, seqNum + i,
+                  MIN(length - i, socket->smss));
             }
-
-            //Append SACK option
-            tcpAddOption(segment, TCP_OPTION_SACK, data, socket->sackBlockCount * 8);
          }
-      }
-   }
+         else
 #endif
-
-   //Adjust the length of the multi-part buffer
-   netBufferSetLength(buffer, offset + segment->dataOffset * 4);
-
-   //Any data to send?
-   if(length > 0)
-   {
-      //Copy data
-      error = tcpReadTxBuffer(socket, seqNum, buffer, length);
-      //Any error to report?
-      if(error)
-      {
-         //Clean up side effects
-         netBufferFree(buffer);
-         //Exit immediately
-         return error;
+         {
+            error = tcpAddRetransmitQueueItem(socket, flags, seqNum, length);
+         }
       }
    }
 
-   //Calculate the length of the complete TCP segment
-   totalLength = segment->dataOffset * 4 + length;
-
-#if (IPV4_SUPPORT == ENABLED)
-   //Destination address is an IPv4 address?
-   if(socket->remoteIpAddr.length == sizeof(Ipv4Addr))
-   {
-      //Format IPv4 pseudo header
-      pseudoHeader.length = sizeof(Ipv4PseudoHeader);
-      pseudoHeader.ipv4Data.srcAddr = socket->localIpAddr.ipv4Addr;
-      pseudoHeader.ipv4Data.destAddr = socket->remoteIpAddr.ipv4Addr;
-      pseudoHeader.ipv4Data.reserved = 0;
-      pseudoHeader.ipv4Data.protocol = IPV4_PROTOCOL_TCP;
-      pseudoHeader.ipv4Data.length = htons(totalLength);
-
-      //Calculate TCP header checksum
-      segment->checksum = ipCalcUpperLayerChecksumEx(&pseudoHeader.ipv4Data,
-         sizeof(Ipv4PseudoHeader), buffer, offset, totalLength);
-   }
-   else
-#endif
-#if (IPV6_SUPPORT == ENABLED)
-   //Destination address is an IPv6 address?
-   if(socket->remoteIpAddr.length == sizeof(Ipv6Addr))
-   {
-      //Format IPv6 pseudo header
-      pseudoHeader.length = sizeof(Ipv6PseudoHeader);
-      pseudoHeader.ipv6Data.srcAddr = socket->localIpAddr.ipv6Addr;
-      pseudoHeader.ipv6Data.destAddr = socket->remoteIpAddr.ipv6Addr;
-      pseudoHeader.ipv6Data.length = htonl(totalLength);
-      pseudoHeader.ipv6Data.reserved[0] = 0;
-      pseudoHeader.ipv6Data.reserved[1] = 0;
-      pseudoHeader.ipv6Data.reserved[2] = 0;
-      pseudoHeader.ipv6Data.nextHeader = IPV6_TCP_HEADER;
-
-      //Calculate TCP header checksum
-      segment->checksum = ipCalcUpperLayerChecksumEx(&pseudoHeader.ipv6Data,
-         sizeof(Ipv6PseudoHeader), buffer, offset, totalLength);
-   }
-   else
-#endif
-   //Destination address is not valid?
+   //Any error to report?
+   if(error)
    {
-      //Free previously allocated memory
+      //Clean up side effects
       netBufferFree(buffer);
-      //This should never occur...
-      return ERROR_INVALID_ADDRESS;
+      //Exit immediately
+      return error;
    }
 
-   //Add current segment to retransmission queue?
+   //Point to the beginning of the TCP segment
+   segment = netBufferAt(buffer, offset);
+
+   //Segment added to the retransmission queue?
    if(addToQueue)
    {
-      //Empty retransmission queue?
-      if(socket->retransmitQueue == NULL)
-      {
-         //Create a new item
-         queueItem = memPoolAlloc(sizeof(TcpQueueItem));
-         //Add the newly created item to the queue
-         socket->retransmitQueue = queueItem;
-      }
-      else
-      {
-         //Point to the very first item
-         queueItem = socket->retransmitQueue;
-
-         //Reach the last item of the retransmission queue
-         while(queueItem->next != NULL)
-         {
-            queueItem = queueItem->next;
-         }
-
-         //Create a new item
-         queueItem->next = memPoolAlloc(sizeof(TcpQueueItem));
-         //Point to the newly created item
-         queueItem = queueItem->next;
-      }
-
-      //Failed to allocate memory?
-      if(queueItem == NULL)
-      {
-         //Free previously allocated memory
-         netBufferFree(buffer);
-         //Return status
-         return ERROR_OUT_OF_MEMORY;
-      }
-
-      //Retransmission mechanism requires additional information
-      queueItem->next = NULL;
-      queueItem->length = length;
-      queueItem->sacked = FALSE;
-
-      //Save TCP header
-      osMemcpy(queueItem->header, segment, segment->dataOffset * 4);
-      //Save pseudo header
-      queueItem->pseudoHeader = pseudoHeader;
-
       //Take one RTT measurement at a time
       if(!socket->rttBusy)
       {
          //Save round-trip start time
          socket->rttStartTime = osGetSystemTime();
          //Record current sequence number
-         socket->rttSeqNum = ntohl(segment->seqNum);
+         socket->rttSeqNum = seqNum;
          //Wait for an acknowledgment that covers that sequence number...
          socket->rttBusy = TRUE;
 
@@ -346,6 +267,14 @@ error_t tcpSendSegment(Socket *socket, uint8_t flags, uint32_t seqNum,
    ancillary.vmanDei = socket->vmanDei;
 #endif
 
+#if (NET_GSO_SUPPORT == ENABLED)
+   //Super-segments are split into MSS-sized frames at the NIC boundary
+   if(length > socket->smss)
+   {
+      ancillary.gsoSize = socket->smss;
+   }
+#endif
+
    //Send TCP segment
    (void) ipSendDatagram(socket->interface, &pseudoHeader, buffer, offset,
       &ancillary);
@@ -359,77 +288,258 @@ error_t tcpSendSegment(Socket *socket, uint8_t flags, uint32_t seqNum,
 
 
 /**
- * @brief Send a TCP reset segment
+ * @brief Format a TCP segment
  * @param[in] socket Handle referencing a socket
+ * @param[in] flags Value that contains bitwise OR of flags (see #TcpFlags enumeration)
  * @param[in] seqNum Sequence number
+ * @param[in] ackNum Acknowledgment number
+ * @param[in] length Length of the segment data
+ * @param[in] buffer Multi-part buffer where to format the segment
+ * @param[in] offset Offset to the first byte of the TCP header
+ * @param[out] pseudoHeader TCP pseudo header
  * @return Error code
  **/
 
-error_t tcpSendResetSegment(Socket *socket, uint32_t seqNum)
+error_t tcpFormatSegment(Socket *socket, uint8_t flags, uint32_t seqNum,
+   uint32_t ackNum, size_t length, NetBuffer *buffer, size_t offset,
+   IpPseudoHeader *pseudoHeader)
 {
    error_t error;
+   uint16_t mss;
+   size_t headerLength;
+   size_t totalLength;
+   uint32_t checksum;
+   TcpHeader *segment;
 
-   //Initialize status code
-   error = NO_ERROR;
-
-   //Check current state
-   if(socket->state == TCP_STATE_SYN_SENT ||
-      socket->state == TCP_STATE_SYN_RECEIVED ||
-      socket->state == TCP_STATE_ESTABLISHED ||
-      socket->state == TCP_STATE_FIN_WAIT_1 ||
-      socket->state == TCP_STATE_FIN_WAIT_2 ||
-      socket->state == TCP_STATE_CLOSE_WAIT)
-   {
-      //Send a reset segment
-      error = tcpSendSegment(socket, TCP_FLAG_RST, seqNum, 0, 0, FALSE);
-   }
-
-   //Return status code
-   return error;
-}
-
+   //Maximum segment size
+   mss = HTONS(socket->rmss);
 
-/**
- * @brief Send a TCP reset in response to an invalid segment
- * @param[in] interface Underlying network interface
- * @param[in] pseudoHeader TCP pseudo header describing the incoming segment
- * @param[in] segment Incoming TCP segment
- * @param[in] length Length of the incoming segment data
- * @return Error code
- **/
+   //Point to the beginning of the TCP segment
+   segment = netBufferAt(buffer, offset);
 
-error_t tcpRejectSegment(NetInterface *interface,
-   const IpPseudoHeader *pseudoHeader, const TcpHeader *segment, size_t length)
-{
-   error_t error;
-   size_t offset;
-   uint8_t flags;
-   uint32_t seqNum;
-   uint32_t ackNum;
-   NetBuffer *buffer;
-   TcpHeader *segment2;
-   IpPseudoHeader pseudoHeader2;
-   NetTxAncillary ancillary;
+   //Format TCP header
+   segment->srcPort = htons(socket->localPort);
+   segment->destPort = htons(socket->remotePort);
+   segment->seqNum = htonl(seqNum);
+   segment->ackNum = (flags & TCP_FLAG_ACK) ? htonl(ackNum) : 0;
+   segment->reserved1 = 0;
+   segment->dataOffset = sizeof(TcpHeader) / 4;
+   segment->flags = flags;
+   segment->reserved2 = 0;
+   segment->window = htons(socket->rcvWnd);
+   segment->checksum = 0;
+   segment->urgentPointer = 0;
 
-   //Check whether the ACK bit is set
-   if((segment->flags & TCP_FLAG_ACK) != 0)
+   //SYN flag set?
+   if((flags & TCP_FLAG_SYN) != 0)
    {
-      //If the incoming segment has an ACK field, the reset takes
-      //its sequence number from the ACK field of the segment
-      flags = TCP_FLAG_RST;
-      seqNum = segment->ackNum;
-      ackNum = 0;
+      //Append Maximum Segment Size option
+      tcpAddOption(segment, TCP_OPTION_MAX_SEGMENT_SIZE, &mss, sizeof(mss));
    }
-   else
+
+#if (TCP_SACK_SUPPORT == ENABLED)
+   //SYN flag set?
+   if((flags & TCP_FLAG_SYN) != 0)
    {
-      //Otherwise the reset has sequence number zero and the ACK field is set to
-      //the sum of the sequence number and segment length of the incoming segment
-      flags = TCP_FLAG_RST | TCP_FLAG_ACK;
-      seqNum = 0;
-      ackNum = segment->seqNum + length;
+      //Append SACK Permitted option
+      tcpAddOption(segment, TCP_OPTION_SACK_PERMITTED, NULL, 0);
+   }
 
-      //Advance the acknowledgment number over the SYN or the FIN
-      if((segment->flags & TCP_FLAG_SYN) != 0)
+   //ACK flag set?
+   if((flags & TCP_FLAG_ACK) != 0)
+   {
+      //If the data receiver has not received a SACK Permitted option for a
+      //given connection, it must not send SACK options on that connection
+      if(socket->sackPermitted)
+      {
+         //SACK options should be included in all ACKs which do not ACK the
+         //highest sequence number in the data receiver's queue. In this
+         //situation the network has lost or mis-ordered data, such that the
+         //receiver holds non-contiguous data in its queue
+         if(socket->sackBlockCount > 0 &&
+            socket->sackBlockCount <= TCP_MAX_SACK_BLOCKS)
+         {
+            uint_t i;
+            uint32_t data[TCP_MAX_SACK_BLOCKS * 2];
+
+            //This option contains a list of some of the blocks of contiguous
+            //sequence space occupied by data that has been received and queued
+            //within the window
+            for(i = 0; i < socket->sackBlockCount; i++)
+            {
+               data[i * 2] = htonl(socket->sackBlock[i].leftEdge);
+               data[i * 2 + 1] = htonl(socket->sackBlock[i].rightEdge);
+            }
+
+            //Append SACK option
+            tcpAddOption(segment, TCP_OPTION_SACK, data, socket->sackBlockCount * 8);
+         }
+      }
+   }
+#endif
+
+   //Adjust the length of the multi-part buffer
+   netBufferSetLength(buffer, offset + segment->dataOffset * 4);
+
+   //Any data to send?
+   if(length > 0)
+   {
+      //Copy data
+      error = tcpReadTxBuffer(socket, seqNum, buffer, length);
+      //Any error to report?
+      if(error)
+         return error;
+   }
+
+   //Calculate the length of the complete TCP segment
+   headerLength = segment->dataOffset * 4;
+   totalLength = headerLength + length;
+
+#if (IPV4_SUPPORT == ENABLED)
+   //Destination address is an IPv4 address?
+   if(socket->remoteIpAddr.length == sizeof(Ipv4Addr))
+   {
+      //Format IPv4 pseudo header
+      pseudoHeader->length = sizeof(Ipv4PseudoHeader);
+      pseudoHeader->ipv4Data.srcAddr = socket->localIpAddr.ipv4Addr;
+      pseudoHeader->ipv4Data.destAddr = socket->remoteIpAddr.ipv4Addr;
+      pseudoHeader->ipv4Data.reserved = 0;
+      pseudoHeader->ipv4Data.protocol = IPV4_PROTOCOL_TCP;
+      pseudoHeader->ipv4Data.length = htons(totalLength);
+   }
+   else
+#endif
+#if (IPV6_SUPPORT == ENABLED)
+   //Destination address is an IPv6 address?
+   if(socket->remoteIpAddr.length == sizeof(Ipv6Addr))
+   {
+      //Format IPv6 pseudo header
+      pseudoHeader->length = sizeof(Ipv6PseudoHeader);
+      pseudoHeader->ipv6Data.srcAddr = socket->localIpAddr.ipv6Addr;
+      pseudoHeader->ipv6Data.destAddr = socket->remoteIpAddr.ipv6Addr;
+      pseudoHeader->ipv6Data.length = htonl(totalLength);
+      pseudoHeader->ipv6Data.reserved[0] = 0;
+      pseudoHeader->ipv6Data.reserved[1] = 0;
+      pseudoHeader->ipv6Data.reserved[2] = 0;
+      pseudoHeader->ipv6Data.nextHeader = IPV6_TCP_HEADER;
+   }
+   else
+#endif
+   //Destination address is not valid?
+   {
+      //This should never occur...
+      return ERROR_INVALID_ADDRESS;
+   }
+
+   //Process pseudo header
+   checksum = ipCalcChecksum(pseudoHeader->data, pseudoHeader->length) ^ 0xFFFF;
+   //Process TCP header
+   checksum += ipCalcChecksum(segment, headerLength) ^ 0xFFFF;
+
+   //Any data to send?
+   if(length > 0)
+   {
+#if (TCP_TX_CHECKSUM_CACHE_SUPPORT == ENABLED)
+#if (SOCKET_ZERO_COPY_TX_SUPPORT == ENABLED)
+      //Caller-owned data are not covered by the partial sums
+      if(socket->txRefCount > 0)
+      {
+         //Process segment data
+         checksum += ipCalcChecksumEx(buffer, offset + headerLength, length) ^
+            0xFFFF;
+      }
+      else
+#endif
+      {
+         //Reuse the partial sums computed when the data were written to the
+         //send buffer
+         checksum += tcpCalcTxBufferChecksum(socket, seqNum, length) ^ 0xFFFF;
+      }
+#else
+      //Process segment data
+      checksum += ipCalcChecksumEx(buffer, offset + headerLength, length) ^
+         0xFFFF;
+#endif
+   }
+
+   //Fold 32-bit sum to 16 bits
+   checksum = (checksum & 0xFFFF) + (checksum >> 16);
+   checksum = (checksum & 0xFFFF) + (checksum >> 16);
+
+   //Calculate TCP header checksum
+   segment->checksum = (uint16_t) (checksum ^ 0xFFFF);
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Send a TCP reset segment
+ * @param[in] socket Handle referencing a socket
+ * @param[in] seqNum Sequence number
+ * @return Error code
+ **/
+
+error_t tcpSendResetSegment(Socket *socket, uint32_t seqNum)
+{
+   error_t error;
+
+   //Initialize status code
+   error = NO_ERROR;
+
+   //Check current state
+   if(socket->state == TCP_STATE_SYN_SENT ||
+      socket->state == TCP_STATE_SYN_RECEIVED ||
+      socket->state == TCP_STATE_ESTABLISHED ||
+      socket->state == TCP_STATE_FIN_WAIT_1 ||
+      socket->state == TCP_STATE_FIN_WAIT_2 ||
+      socket->state == TCP_STATE_CLOSE_WAIT)
+   {
+      //Send a reset segment
+      error = tcpSendSegment(socket, TCP_FLAG_RST, seqNum, 0, 0, FALSE);
+   }
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Send a TCP reset in response to an invalid segment
+ * @param[in] interface Underlying network interface
+ * @param[in] pseudoHeader TCP pseudo header describing the incoming segment
+ * @param[in] segment Incoming TCP segment
+ * @param[in] length Length of the incoming segment data
+ * @return Error code
+ **/
+
+error_t tcpRejectSegment(NetInterface *interface,
+   const IpPseudoHeader *pseudoHeader, const TcpHeader *segment, size_t length)
+{
+   uint8_t flags;
+   uint32_t seqNum;
+   uint32_t ackNum;
+
+   //Check whether the ACK bit is set
+   if((segment->flags & TCP_FLAG_ACK) != 0)
+   {
+      //If the incoming segment has an ACK field, the reset takes
+      //its sequence number from the ACK field of the segment
+      flags = TCP_FLAG_RST;
+      seqNum = segment->ackNum;
+      ackNum = 0;
+   }
+   else
+   {
+      //Otherwise the reset has sequence number zero and the ACK field is set to
+      //the sum of the sequence number and segment length of the incoming segment
+      flags = TCP_FLAG_RST | TCP_FLAG_ACK;
+      seqNum = 0;
+      ackNum = segment->seqNum + length;
+
+      //Advance the acknowledgment number over the SYN or the FIN
+      if((segment->flags & TCP_FLAG_SYN) != 0)
       {
          ackNum++;
       }
@@ -440,8 +550,43 @@ error_t tcpRejectSegment(NetInterface *interface,
       }
    }
 
-   //Allocate a memory buffer to hold the reset segment
-   buffer = ipAllocBuffer(sizeof(TcpHeader), &offset);
+   //Send the reset segment
+   return tcpSendStatelessSegment(interface, pseudoHeader, segment, flags,
+      seqNum, ackNum, 0, 0);
+}
+
+
+/**
+ * @brief Reply to a segment without any connection state
+ * @param[in] interface Underlying network interface
+ * @param[in] pseudoHeader TCP pseudo header describing the incoming segment
+ * @param[in] segment Incoming TCP segment
+ * @param[in] flags Value of the flags field
+ * @param[in] seqNum Sequence number
+ * @param[in] ackNum Acknowledgment number
+ * @param[in] window Value of the window field
+ * @param[in] mss Value of the Maximum Segment Size option (0 if the option
+ *   is not present)
+ * @return Error code
+ **/
+
+error_t tcpSendStatelessSegment(NetInterface *interface,
+   const IpPseudoHeader *pseudoHeader, const TcpHeader *segment, uint8_t flags,
+   uint32_t seqNum, uint32_t ackNum, uint16_t window, uint16_t mss)
+{
+   error_t error;
+   size_t offset;
+   size_t headerLen;
+   NetBuffer *buffer;
+   TcpHeader *segment2;
+   IpPseudoHeader pseudoHeader2;
+   NetTxAncillary ancillary;
+
+   //Length of the TCP header, including the Maximum Segment Size option
+   headerLen = (mss != 0) ? sizeof(TcpHeader) + 4 : sizeof(TcpHeader);
+
+   //Allocate a memory buffer to hold the segment
+   buffer = ipAllocBuffer(headerLen, &offset);
    //Failed to allocate memory?
    if(buffer == NULL)
       return ERROR_OUT_OF_MEMORY;
@@ -458,10 +603,19 @@ error_t tcpRejectSegment(NetInterface *interface,
    segment2->dataOffset = 5;
    segment2->flags = flags;
    segment2->reserved2 = 0;
-   segment2->window = 0;
+   segment2->window = htons(window);
    segment2->checksum = 0;
    segment2->urgentPointer = 0;
 
+   //Any Maximum Segment Size option to add?
+   if(mss != 0)
+   {
+      //Convert the MSS value to network byte order
+      mss = htons(mss);
+      //Append Maximum Segment Size option
+      tcpAddOption(segment2, TCP_OPTION_MAX_SEGMENT_SIZE, &mss, sizeof(mss));
+   }
+
 #if (IPV4_SUPPORT == ENABLED)
    //Destination address is an IPv4 address?
    if(pseudoHeader->length == sizeof(Ipv4PseudoHeader))
@@ -472,11 +626,11 @@ error_t tcpRejectSegment(NetInterface *interface,
       pseudoHeader2.ipv4Data.destAddr = pseudoHeader->ipv4Data.srcAddr;
       pseudoHeader2.ipv4Data.reserved = 0;
       pseudoHeader2.ipv4Data.protocol = IPV4_PROTOCOL_TCP;
-      pseudoHeader2.ipv4Data.length = HTONS(sizeof(TcpHeader));
+      pseudoHeader2.ipv4Data.length = htons(headerLen);
 
       //Calculate TCP header checksum
       segment2->checksum = ipCalcUpperLayerChecksumEx(&pseudoHeader2.ipv4Data,
-         sizeof(Ipv4PseudoHeader), buffer, offset, sizeof(TcpHeader));
+         sizeof(Ipv4PseudoHeader), buffer, offset, headerLen);
    }
    else
 #endif
@@ -488,7 +642,7 @@ error_t tcpRejectSegment(NetInterface *interface,
       pseudoHeader2.length = sizeof(Ipv6PseudoHeader);
       pseudoHeader2.ipv6Data.srcAddr = pseudoHeader->ipv6Data.destAddr;
       pseudoHeader2.ipv6Data.destAddr = pseudoHeader->ipv6Data.srcAddr;
-      pseudoHeader2.ipv6Data.length = HTONL(sizeof(TcpHeader));
+      pseudoHeader2.ipv6Data.length = htonl(headerLen);
       pseudoHeader2.ipv6Data.reserved[0] = 0;
       pseudoHeader2.ipv6Data.reserved[1] = 0;
       pseudoHeader2.ipv6Data.reserved[2] = 0;
@@ -496,7 +650,7 @@ error_t tcpRejectSegment(NetInterface *interface,
 
       //Calculate TCP header checksum
       segment2->checksum = ipCalcUpperLayerChecksumEx(&pseudoHeader2.ipv6Data,
-         sizeof(Ipv6PseudoHeader), buffer, offset, sizeof(TcpHeader));
+         sizeof(Ipv6PseudoHeader), buffer, offset, headerLen);
    }
    else
 #endif
@@ -513,16 +667,26 @@ error_t tcpRejectSegment(NetInterface *interface,
    TCP_MIB_INC_COUNTER32(tcpOutSegs, 1);
    TCP_MIB_INC_COUNTER64(tcpHCOutSegs, 1);
 
-   //Number of TCP segments sent containing the RST flag
-   MIB2_TCP_INC_COUNTER32(tcpOutRsts, 1);
-   TCP_MIB_INC_COUNTER32(tcpOutRsts, 1);
+   //Reset segment?
+   if((flags & TCP_FLAG_RST) != 0)
+   {
+      //Number of TCP segments sent containing the RST flag
+      MIB2_TCP_INC_COUNTER32(tcpOutRsts, 1);
+      TCP_MIB_INC_COUNTER32(tcpOutRsts, 1);
 
-   //Debug message
-   TRACE_DEBUG("%s: Sending TCP reset segment...\r\n",
-      formatSystemTime(osGetSystemTime(), NULL));
+      //Debug message
+      TRACE_DEBUG("%s: Sending TCP reset segment...\r\n",
+         formatSystemTime(osGetSystemTime(), NULL));
+   }
+   else
+   {
+      //Debug message
+      TRACE_DEBUG("%s: Sending TCP segment...\r\n",
+         formatSystemTime(osGetSystemTime(), NULL));
+   }
 
    //Dump TCP header contents for debugging purpose
-   tcpDumpHeader(segment2, length, 0, 0);
+   tcpDumpHeader(segment2, 0, 0, 0);
 
    //Additional options can be passed to the stack along with the packet
    ancillary = NET_DEFAULT_TX_ANCILLARY;
@@ -846,6 +1010,7 @@ error_t tcpCheckAck(Socket *socket, const TcpHeader *segment, size_t length)
    uint_t n;
    uint_t ownd;
    uint_t thresh;
+   bool_t lostFlag;
 #endif
 
    //If the ACK bit is off drop the segment and return
@@ -883,6 +1048,24 @@ error_t tcpCheckAck(Socket *socket, const TcpHeader *segment, size_t length)
    duplicateFlag = tcpIsDuplicateAck(socket, segment, length);
    (void) duplicateFlag;
 
+#if (TCP_SACK_SUPPORT == ENABLED)
+   //SACK option negotiated during connection establishment?
+   if(socket->sackPermitted)
+   {
+      //Update the scoreboard with the SACK blocks carried by the ACK
+      if(tcpUpdateSackScoreboard(socket, segment))
+      {
+         //An ACK that does not advance SND.UNA and that carries a SACK block
+         //identifying previously un-SACKed octets is treated as a duplicate
+         //acknowledgment (refer to RFC 6675, section 2)
+         if(segment->ackNum == socket->sndUna)
+         {
+            duplicateFlag = TRUE;
+         }
+      }
+   }
+#endif
+
    //The send window should be updated
    tcpUpdateSendWindow(socket, segment);
 
@@ -932,23 +1115,8 @@ error_t tcpCheckAck(Socket *socket, const TcpHeader *segment, size_t length)
             tcpFastLossRecovery(socket, segment);
          }
 
-         //Slow start algorithm is used when cwnd is lower than ssthresh
-         if(socket->cwnd < socket->ssthresh)
-         {
-            //During slow start, TCP increments cwnd by at most SMSS bytes
-            //for each ACK received that cumulatively acknowledges new data
-            socket->cwnd += MIN(n, socket->smss);
-         }
-         //Congestion avoidance algorithm is used when cwnd exceeds ssthres
-         else
-         {
-            //Congestion window is updated once per RTT
-            if(updateFlag)
-            {
-               //TCP must not increment cwnd by more than SMSS bytes
-               socket->cwnd += MIN(socket->n, socket->smss);
-            }
-         }
+         //Let the congestion control algorithm update the congestion window
+         socket->congestAlgo->onAck(socket, n, updateFlag);
       }
 
       //Limit the size of the congestion window
@@ -1002,7 +1170,23 @@ error_t tcpCheckAck(Socket *socket, const TcpHeader *segment, size_t length)
          }
 
          //Check the number of duplicate ACKs that have been received
-         if(socket->dupAckCount >= thresh)
+         lostFlag = (socket->dupAckCount >= thresh) ? TRUE : FALSE;
+
+#if (TCP_SACK_SUPPORT == ENABLED)
+         //When SACK is in use, loss recovery is also initiated as soon as
+         //the scoreboard indicates that the first unacknowledged segment
+         //has been lost (refer to RFC 6675, section 5)
+         if(socket->sackPermitted && socket->retransmitQueueLength > 0)
+         {
+            if(tcpIsSegmentLost(socket, 0))
+            {
+               lostFlag = TRUE;
+            }
+         }
+#endif
+
+         //Enter loss recovery?
+         if(lostFlag)
          {
             //The TCP sender first checks the value of recover to see if the
             //cumulative acknowledgment field covers more than recover
@@ -1023,11 +1207,24 @@ error_t tcpCheckAck(Socket *socket, const TcpHeader *segment, size_t length)
          //Duplicate ACK received?
          if(duplicateFlag)
          {
-            //For each additional duplicate ACK received (after the third),
-            //cwnd must be incremented by SMSS. This artificially inflates
-            //the congestion window in order to reflect the additional
-            //segment that has left the network
-            socket->cwnd += socket->smss;
+#if (TCP_SACK_SUPPORT == ENABLED)
+            //SACK-based loss recovery?
+            if(socket->sackPermitted)
+            {
+               //The congestion window is not inflated. Instead the scoreboard
+               //is used to estimate the number of outstanding segments and to
+               //decide which segment to send next
+               tcpSackLossRecovery(socket);
+            }
+            else
+#endif
+            {
+               //For each additional duplicate ACK received (after the third),
+               //cwnd must be incremented by SMSS. This artificially inflates
+               //the congestion window in order to reflect the additional
+               //segment that has left the network
+               socket->cwnd += socket->smss;
+            }
          }
       }
 
@@ -1045,28 +1242,67 @@ error_t tcpCheckAck(Socket *socket, const TcpHeader *segment, size_t length)
 
 
 /**
- * @brief Test whether the incoming SYN segment is a duplicate
+ * @brief Search the SYN queue for a connection request
  * @param[in] socket Handle referencing the current socket
  * @param[in] pseudoHeader TCP pseudo header
- * @param[in] segment Pointer to the TCP segment to check
- * @return TRUE if the SYN segment is duplicate, else FALSE
+ * @param[in] segment Pointer to the incoming TCP segment
+ * @return Pointer to the matching item, if any
  **/
 
-bool_t tcpIsDuplicateSyn(Socket *socket, const IpPseudoHeader *pseudoHeader,
-   const TcpHeader *segment)
+TcpSynQueueItem *tcpFindSynQueueItem(Socket *socket,
+   const IpPseudoHeader *pseudoHeader, const TcpHeader *segment)
 {
-   bool_t flag;
    TcpSynQueueItem *queueItem;
+#if (TCP_SYN_QUEUE_HASH_SUPPORT == ENABLED)
+   IpAddr srcAddr;
+#endif
 
-   //Initialize flag
-   flag = FALSE;
+#if (TCP_SYN_QUEUE_HASH_SUPPORT == ENABLED)
+#if (IPV4_SUPPORT == ENABLED)
+   //IPv4 packet received?
+   if(pseudoHeader->length == sizeof(Ipv4PseudoHeader))
+   {
+      //Retrieve the source IPv4 address
+      srcAddr.length = sizeof(Ipv4Addr);
+      srcAddr.ipv4Addr = pseudoHeader->ipv4Data.srcAddr;
+   }
+   else
+#endif
+#if (IPV6_SUPPORT == ENABLED)
+   //IPv6 packet received?
+   if(pseudoHeader->length == sizeof(Ipv6PseudoHeader))
+   {
+      //Retrieve the source IPv6 address
+      srcAddr.length = sizeof(Ipv6Addr);
+      srcAddr.ipv6Addr = pseudoHeader->ipv6Data.srcAddr;
+   }
+   else
+#endif
+   //Invalid pseudo header?
+   {
+      //This should never occur...
+      return NULL;
+   }
 
+   //Point to the first item of the corresponding hash bucket
+   queueItem = tcpSynQueueHashTable[tcpHashSynQueueKey(&srcAddr,
+      segment->srcPort)];
+#else
    //Point to the very first item
    queueItem = socket->synQueue;
+#endif
 
    //Loop through the SYN queue
    while(queueItem != NULL)
    {
+#if (TCP_SYN_QUEUE_HASH_SUPPORT == ENABLED)
+      //The hash bucket is shared by all the listening sockets
+      if(queueItem->socket != socket)
+      {
+         //The item belongs to another listening socket
+      }
+      else
+#endif
 #if (IPV4_SUPPORT == ENABLED)
       //IPv4 packet received?
       if(queueItem->srcAddr.length == sizeof(Ipv4Addr) &&
@@ -1080,8 +1316,8 @@ bool_t tcpIsDuplicateSyn(Socket *socket, const IpPseudoHeader *pseudoHeader,
             //Check source port
             if(queueItem->srcPort == segment->srcPort)
             {
-               //Duplicate SYN
-               flag = TRUE;
+               //Matching item found
+               break;
             }
          }
       }
@@ -1100,8 +1336,8 @@ bool_t tcpIsDuplicateSyn(Socket *socket, const IpPseudoHeader *pseudoHeader,
             //Check source port
             if(queueItem->srcPort == segment->srcPort)
             {
-               //Duplicate SYN
-               flag = TRUE;
+               //Matching item found
+               break;
             }
          }
       }
@@ -1111,12 +1347,33 @@ bool_t tcpIsDuplicateSyn(Socket *socket, const IpPseudoHeader *pseudoHeader,
          //Just for sanity
       }
 
+#if (TCP_SYN_QUEUE_HASH_SUPPORT == ENABLED)
+      //Next item in the same hash bucket
+      queueItem = queueItem->hashNext;
+#else
       //Next item
       queueItem = queueItem->next;
+#endif
    }
 
-   //Return TRUE if the SYN segment is a duplicate
-   return flag;
+   //Return a pointer to the matching item, if any
+   return queueItem;
+}
+
+
+/**
+ * @brief Test whether the incoming SYN segment is a duplicate
+ * @param[in] socket Handle referencing the current socket
+ * @param[in] pseudoHeader TCP pseudo header
+ * @param[in] segment Pointer to the TCP segment to check
+ * @return TRUE if the SYN segment is duplicate, else FALSE
+ **/
+
+bool_t tcpIsDuplicateSyn(Socket *socket, const IpPseudoHeader *pseudoHeader,
+   const TcpHeader *segment)
+{
+   //The SYN segment is a duplicate if a request is already queued
+   return (tcpFindSynQueueItem(socket, pseudoHeader, segment) != NULL);
 }
 
 
@@ -1137,7 +1394,7 @@ bool_t tcpIsDuplicateAck(Socket *socket, const TcpHeader *segment,
    flag = FALSE;
 
    //The receiver of the ACK has outstanding data
-   if(socket->retransmitQueue != NULL)
+   if(socket->retransmitQueueLength > 0)
    {
       //The incoming acknowledgment carries no data
       if(length == 0)
@@ -1174,12 +1431,9 @@ bool_t tcpIsDuplicateAck(Socket *socket, const TcpHeader *segment,
 void tcpFastRetransmit(Socket *socket)
 {
 #if (TCP_CONGEST_CONTROL_SUPPORT == ENABLED)
-   uint32_t flightSize;
-
-   //Amount of data that has been sent but not yet acknowledged
-   flightSize = socket->sndNxt - socket->sndUna;
-   //After receiving 3 duplicate ACKs, ssthresh must be adjusted
-   socket->ssthresh = MAX(flightSize / 2, 2 * socket->smss);
+   //After receiving 3 duplicate ACKs, ssthresh must be adjusted by the
+   //congestion control algorithm
+   socket->congestAlgo->onLoss(socket);
 
    //The value of recover is incremented to the value of the highest
    //sequence number transmitted by the TCP so far
@@ -1188,17 +1442,70 @@ void tcpFastRetransmit(Socket *socket)
    //Debug message
    TRACE_INFO("TCP fast retransmit...\r\n");
 
-   //TCP performs a retransmission of what appears to be the missing segment,
-   //without waiting for the retransmission timer to expire
-   tcpRetransmitSegment(socket);
+#if (TCP_SACK_SUPPORT == ENABLED)
+   //SACK-based loss recovery?
+   if(socket->sackPermitted)
+   {
+      uint_t i;
+      TcpQueueItem *queueItem;
+
+      //Start a new recovery episode. Segments retransmitted during a previous
+      //episode are eligible for retransmission again
+      for(i = 0; i < socket->retransmitQueueLength; i++)
+      {
+         TCP_RETRANSMIT_QUEUE_ITEM(socket, i)->retransmitted = FALSE;
+      }
+
+      //A single rescue retransmission is allowed per recovery episode
+      socket->rescueRxt = socket->sndUna - 1;
+
+      //Set cwnd to ssthresh (refer to RFC 6675, section 5)
+      socket->cwnd = socket->ssthresh;
+
+      //Retransmit the first data segment presumed dropped, that is to say
+      //the first segment that has not been selectively acknowledged
+      for(i = 0; i < socket->retransmitQueueLength; i++)
+      {
+         //Segment not yet SACKed?
+         if(!TCP_RETRANSMIT_QUEUE_ITEM(socket, i)->sacked)
+            break;
+      }
+
+      //Any segment to retransmit?
+      if(i < socket->retransmitQueueLength)
+      {
+         //Point to the segment
+         queueItem = TCP_RETRANSMIT_QUEUE_ITEM(socket, i);
+
+         //Retransmit the segment without waiting for the retransmission
+         //timer to expire
+         if(!tcpRetransmitQueueItem(socket, queueItem))
+         {
+            queueItem->retransmitted = TRUE;
+         }
+      }
+
+      //Enter the fast recovery procedure
+      socket->congestState = TCP_CONGEST_STATE_RECOVERY;
+
+      //Send more segments if the congestion window permits
+      tcpSackLossRecovery(socket);
+   }
+   else
+#endif
+   {
+      //TCP performs a retransmission of what appears to be the missing
+      //segment, without waiting for the retransmission timer to expire
+      tcpRetransmitSegment(socket);
 
-   //cwnd must set to ssthresh plus 3*SMSS. This artificially inflates the
-   //congestion window by the number of segments (three) that have left the
-   //network and which the receiver has buffered
-   socket->cwnd = socket->ssthresh + TCP_FAST_RETRANSMIT_THRES * socket->smss;
+      //cwnd must set to ssthresh plus 3*SMSS. This artificially inflates the
+      //congestion window by the number of segments (three) that have left the
+      //network and which the receiver has buffered
+      socket->cwnd = socket->ssthresh + TCP_FAST_RETRANSMIT_THRES * socket->smss;
 
-   //Enter the fast recovery procedure
-   socket->congestState = TCP_CONGEST_STATE_RECOVERY;
+      //Enter the fast recovery procedure
+      socket->congestState = TCP_CONGEST_STATE_RECOVERY;
+   }
 #endif
 }
 
@@ -1224,6 +1531,9 @@ void tcpFastRecovery(Socket *socket, const TcpHeader *segment, uint_t n)
       socket->cwnd = socket->ssthresh;
       //Exit the fast recovery procedure
       socket->congestState = TCP_CONGEST_STATE_IDLE;
+
+      //Notify the congestion control algorithm
+      socket->congestAlgo->cwndEvent(socket, TCP_CONGEST_EVENT_RECOVERY_EXIT);
    }
    else
    {
@@ -1231,20 +1541,32 @@ void tcpFastRecovery(Socket *socket, const TcpHeader *segment, uint_t n)
       //recover, then this is a partial ACK
       TRACE_INFO("TCP partial acknowledgment\r\n");
 
-      //Retransmit the first unacknowledged segment
-      tcpRetransmitSegment(socket);
-
-      //Deflate the congestion window by the amount of new data acknowledged
-      //by the cumulative acknowledgment field
-      if(socket->cwnd > n)
-         socket->cwnd -= n;
-
-      //If the partial ACK acknowledges at least one SMSS of new data, then
-      //add back SMSS bytes to the congestion window. This artificially
-      //inflates the congestion window in order to reflect the additional
-      //segment that has left the network
-      if(n >= socket->smss)
-         socket->cwnd += socket->smss;
+#if (TCP_SACK_SUPPORT == ENABLED)
+      //SACK-based loss recovery?
+      if(socket->sackPermitted)
+      {
+         //The congestion window is left unchanged. Retransmit the holes
+         //reported by the scoreboard as long as the pipe permits
+         tcpSackLossRecovery(socket);
+      }
+      else
+#endif
+      {
+         //Retransmit the first unacknowledged segment
+         tcpRetransmitSegment(socket);
+
+         //Deflate the congestion window by the amount of new data
+         //acknowledged by the cumulative acknowledgment field
+         if(socket->cwnd > n)
+            socket->cwnd -= n;
+
+         //If the partial ACK acknowledges at least one SMSS of new data, then
+         //add back SMSS bytes to the congestion window. This artificially
+         //inflates the congestion window in order to reflect the additional
+         //segment that has left the network
+         if(n >= socket->smss)
+            socket->cwnd += socket->smss;
+      }
 
       //Do not exit the fast recovery procedure...
       socket->congestState = TCP_CONGEST_STATE_RECOVERY;
@@ -1271,6 +1593,9 @@ void tcpFastLossRecovery(Socket *socket, const TcpHeader *segment)
 
       //Exit the fast loss recovery procedure
       socket->congestState = TCP_CONGEST_STATE_IDLE;
+
+      //Notify the congestion control algorithm
+      socket->congestAlgo->cwndEvent(socket, TCP_CONGEST_EVENT_RECOVERY_EXIT);
    }
    else
    {
@@ -1289,234 +1614,1387 @@ void tcpFastLossRecovery(Socket *socket, const TcpHeader *segment)
 
 
 /**
- * @brief Process the segment text
+ * @brief Update the SACK scoreboard
  * @param[in] socket Handle referencing the current socket
- * @param[in] segment Pointer to the TCP header
- * @param[in] buffer Multi-part buffer containing the incoming TCP segment
- * @param[in] offset Offset to the first data byte
- * @param[in] length Length of the segment data
+ * @param[in] segment Pointer to the incoming TCP segment
+ * @return TRUE if previously un-SACKed data has been selectively
+ *   acknowledged, else FALSE
  **/
 
-void tcpProcessSegmentData(Socket *socket, const TcpHeader *segment,
-   const NetBuffer *buffer, size_t offset, size_t length)
+bool_t tcpUpdateSackScoreboard(Socket *socket, const TcpHeader *segment)
 {
+   bool_t flag;
+#if (TCP_SACK_SUPPORT == ENABLED)
+   uint_t i;
+   uint_t j;
+   uint_t n;
    uint32_t leftEdge;
    uint32_t rightEdge;
+   const TcpOption *option;
+   TcpQueueItem *queueItem;
+#endif
 
-   //First sequence number occupied by the incoming segment
-   leftEdge = segment->seqNum;
-   //Sequence number immediately following the incoming segment
-   rightEdge = segment->seqNum + length;
+   //Initialize flag
+   flag = FALSE;
 
-   //Check whether some data falls outside the receive window
-   if(TCP_CMP_SEQ(leftEdge, socket->rcvNxt) < 0)
-   {
-      //Position of the first byte to be read
-      offset += socket->rcvNxt - leftEdge;
-      //Ignore the data that falls outside the receive window
-      leftEdge = socket->rcvNxt;
-   }
+#if (TCP_SACK_SUPPORT == ENABLED)
+   //Search the TCP header for a SACK option
+   option = tcpGetOption(segment, TCP_OPTION_SACK);
 
-   if(TCP_CMP_SEQ(rightEdge, socket->rcvNxt + socket->rcvWnd) > 0)
+   //SACK option found?
+   if(option != NULL && option->length >= (sizeof(TcpOption) + 8))
    {
-      //Ignore the data that falls outside the receive window
-      rightEdge = socket->rcvNxt + socket->rcvWnd;
-   }
+      //Each block is represented by two 32-bit unsigned integers (refer to
+      //RFC 2018, section 3)
+      n = (option->length - sizeof(TcpOption)) / 8;
 
-   //Copy the incoming data to the receive buffer
-   tcpWriteRxBuffer(socket, leftEdge, buffer, offset, rightEdge - leftEdge);
+      //Loop through the SACK blocks
+      for(i = 0; i < n; i++)
+      {
+         //Retrieve the left and right edges of the current block
+         leftEdge = LOAD32BE(option->value + i * 8);
+         rightEdge = LOAD32BE(option->value + i * 8 + 4);
+
+         //Discard malformed blocks
+         if(TCP_CMP_SEQ(leftEdge, rightEdge) >= 0)
+            continue;
+
+         //Blocks that lie below the cumulative acknowledgment point (D-SACK)
+         //or beyond the highest sequence number transmitted are ignored
+         if(TCP_CMP_SEQ(leftEdge, segment->ackNum) < 0 ||
+            TCP_CMP_SEQ(rightEdge, socket->sndNxt) > 0)
+         {
+            continue;
+         }
 
-   //Update the list of non-contiguous blocks of data that have been received
-   //and queued
-   tcpUpdateSackBlocks(socket, &leftEdge, &rightEdge);
+         //The retransmission queue is sorted by sequence number. Locate the
+         //first segment that starts at or after the left edge of the block
+         j = tcpFindRetransmitQueueItem(socket, leftEdge);
 
-   //Check whether the segment was received out of order
-   if(TCP_CMP_SEQ(leftEdge, socket->rcvNxt) > 0)
-   {
-      //Out of order data segments should be acknowledged immediately, in order
-      //to accelerate loss recovery
-      tcpSendSegment(socket, TCP_FLAG_ACK, socket->sndNxt, socket->rcvNxt, 0,
-         FALSE);
+         //Loop through the segments covered by the block
+         for(; j < socket->retransmitQueueLength; j++)
+         {
+            //Point to the current segment
+            queueItem = TCP_RETRANSMIT_QUEUE_ITEM(socket, j);
+
+            //End of the block?
+            if(TCP_CMP_SEQ(queueItem->seqNum + queueItem->length,
+               rightEdge) > 0)
+            {
+               break;
+            }
+
+            //Mark the segments that are entirely covered by the block
+            if(!queueItem->sacked && queueItem->length > 0)
+            {
+               //The segment has been selectively acknowledged
+               queueItem->sacked = TRUE;
+               //The scoreboard has been updated
+               flag = TRUE;
+            }
+         }
+      }
    }
-   else
-   {
-      //Number of contiguous bytes that have been received
-      length = rightEdge - leftEdge;
+#endif
 
-      //Next sequence number expected on incoming segments
-      socket->rcvNxt += length;
-      //Number of data available in the receive buffer
-      socket->rcvUser += length;
-      //Update the receive window
-      socket->rcvWnd -= length;
+   //Return TRUE if new data has been selectively acknowledged
+   return flag;
+}
 
-      //Acknowledge the received data (delayed ACK not supported)
-      tcpSendSegment(socket, TCP_FLAG_ACK, socket->sndNxt, socket->rcvNxt, 0,
-         FALSE);
 
-      //Notify user task that data is available
-      tcpUpdateEvents(socket);
+/**
+ * @brief Clear the SACK scoreboard
+ *
+ * Upon a retransmission timeout, the data sender must ignore prior SACK
+ * information in determining which data to retransmit, since the timeout
+ * might indicate that the data receiver has reneged (refer to RFC 2018,
+ * section 8)
+ *
+ * @param[in] socket Handle referencing the current socket
+ **/
+
+void tcpResetSackScoreboard(Socket *socket)
+{
+   uint_t i;
+   TcpQueueItem *queueItem;
+
+   //Loop through the retransmission queue
+   for(i = 0; i < socket->retransmitQueueLength; i++)
+   {
+      //Point to the current segment
+      queueItem = TCP_RETRANSMIT_QUEUE_ITEM(socket, i);
+
+      //Turn off the SACKed bit
+      queueItem->sacked = FALSE;
+      queueItem->retransmitted = FALSE;
    }
 }
 
 
 /**
- * @brief Delete TCB structure
- * @param[in] socket Handle referencing the socket
+ * @brief Determine whether a segment is deemed lost
+ *
+ * A segment is considered lost when either DupThresh discontiguous SACKed
+ * segments or more than (DupThresh - 1) * SMSS bytes with sequence numbers
+ * greater than the segment have been selectively acknowledged (refer to
+ * RFC 6675, section 4)
+ *
+ * @param[in] socket Handle referencing the current socket
+ * @param[in] index Position of the segment in the retransmission queue
+ * @return TRUE if the segment is deemed lost, else FALSE
  **/
 
-void tcpDeleteControlBlock(Socket *socket)
+bool_t tcpIsSegmentLost(Socket *socket, uint_t index)
 {
-   //Delete retransmission queue
-   tcpFlushRetransmitQueue(socket);
+   uint_t i;
+   uint_t sackedCount;
+   uint_t sackedBytes;
+   TcpQueueItem *queueItem;
 
-   //Delete SYN queue
-   tcpFlushSynQueue(socket);
+   //A segment that has been selectively acknowledged is not lost
+   if(TCP_RETRANSMIT_QUEUE_ITEM(socket, index)->sacked)
+      return FALSE;
 
-   //Release transmit buffer
-   netBufferSetLength((NetBuffer *) &socket->txBuffer, 0);
+   //Initialize counters
+   sackedCount = 0;
+   sackedBytes = 0;
 
-   //Release receive buffer
-   netBufferSetLength((NetBuffer *) &socket->rxBuffer, 0);
+   //Loop through the segments that follow the specified one
+   for(i = index + 1; i < socket->retransmitQueueLength; i++)
+   {
+      //Point to the current segment
+      queueItem = TCP_RETRANSMIT_QUEUE_ITEM(socket, i);
+
+      //SACKed segment?
+      if(queueItem->sacked)
+      {
+         sackedCount++;
+         sackedBytes += queueItem->length;
+      }
+   }
+
+   //Check whether the segment is deemed lost
+   if(sackedCount >= TCP_FAST_RETRANSMIT_THRES ||
+      sackedBytes > ((TCP_FAST_RETRANSMIT_THRES - 1) * socket->smss))
+   {
+      return TRUE;
+   }
+   else
+   {
+      return FALSE;
+   }
 }
 
 
 /**
- * @brief Remove acknowledged segments from retransmission queue
- * @param[in] socket Handle referencing the socket
+ * @brief Estimate the number of outstanding bytes in the network
+ *
+ * This routine implements the SetPipe() procedure (refer to RFC 6675,
+ * section 4)
+ *
+ * @param[in] socket Handle referencing the current socket
+ * @return Amount of data that is still in flight
  **/
 
-void tcpUpdateRetransmitQueue(Socket *socket)
+uint_t tcpComputePipe(Socket *socket)
 {
-   size_t length;
-   TcpQueueItem *prevQueueItem;
+   uint_t i;
+   uint_t pipe;
+   uint_t sackedCount;
+   uint_t sackedBytes;
    TcpQueueItem *queueItem;
-   TcpHeader *header;
 
-   //Point to the first item of the retransmission queue
-   prevQueueItem = NULL;
-   queueItem = socket->retransmitQueue;
+   //Initialize variables
+   pipe = 0;
+   sackedCount = 0;
+   sackedBytes = 0;
 
-   //Loop through retransmission queue
-   while(queueItem != NULL)
+   //Compute the amount of data that has been selectively acknowledged
+   for(i = 0; i < socket->retransmitQueueLength; i++)
    {
-      //Point to the TCP header
-      header = (TcpHeader *) queueItem->header;
+      //Point to the current segment
+      queueItem = TCP_RETRANSMIT_QUEUE_ITEM(socket, i);
 
-      //Calculate the length of the TCP segment
-      if(header->flags & TCP_FLAG_SYN)
+      //SACKed segment?
+      if(queueItem->sacked)
       {
-         length = 1;
+         sackedCount++;
+         sackedBytes += queueItem->length;
       }
-      else if(header->flags & TCP_FLAG_FIN)
+   }
+
+   //Loop through the retransmission queue
+   for(i = 0; i < socket->retransmitQueueLength; i++)
+   {
+      //Point to the current segment
+      queueItem = TCP_RETRANSMIT_QUEUE_ITEM(socket, i);
+
+      //SACKed segment?
+      if(queueItem->sacked)
       {
-         length = queueItem->length + 1;
+         //Keep track of the SACKed data above the next segment
+         sackedCount--;
+         sackedBytes -= queueItem->length;
       }
       else
       {
-         length = queueItem->length;
-      }
-
-      //If an acknowledgment is received for a segment before its timer
-      //expires, the segment is removed from the retransmission queue
-      if(TCP_CMP_SEQ(socket->sndUna, ntohl(header->seqNum) + length) >= 0)
-      {
-         //First item of the queue?
-         if(prevQueueItem == NULL)
+         //If the segment is not deemed lost, it is assumed to be in flight
+         if(sackedCount < TCP_FAST_RETRANSMIT_THRES &&
+            sackedBytes <= ((TCP_FAST_RETRANSMIT_THRES - 1) * socket->smss))
          {
-            //Remove the current item from the queue
-            socket->retransmitQueue = queueItem->next;
-            //The item can now be safely deleted
-            memPoolFree(queueItem);
-            //Point to the next item
-            queueItem = socket->retransmitQueue;
+            pipe += queueItem->length;
          }
-         else
+
+         //A retransmitted segment is also assumed to be in flight
+         if(queueItem->retransmitted)
          {
-            //Remove the current item from the queue
-            prevQueueItem->next = queueItem->next;
-            //The item can now be safely deleted
-            memPoolFree(queueItem);
-            //Point to the next item
-            queueItem = prevQueueItem->next;
+            pipe += queueItem->length;
          }
-
-         //When an ACK is received that acknowledges new data, restart the
-         //retransmission timer so that it will expire after RTO seconds
-         netStartTimer(&socket->retransmitTimer, socket->rto);
-         //Reset retransmission counter
-         socket->retransmitCount = 0;
-      }
-      //No acknowledgment received for the current segment...
-      else
-      {
-         //Point to the next item
-         prevQueueItem = queueItem;
-         queueItem = queueItem->next;
       }
    }
 
-   //When all outstanding data has been acknowledged,
-   //turn off the retransmission timer
-   if(socket->retransmitQueue == NULL)
-      netStopTimer(&socket->retransmitTimer);
+   //Return the number of outstanding bytes
+   return pipe;
 }
 
 
 /**
- * @brief Flush retransmission queue
- * @param[in] socket Handle referencing the socket
+ * @brief Select the next segment to be retransmitted
+ *
+ * This routine implements rules (1) and (3) of the NextSeg() procedure
+ * (refer to RFC 6675, section 4)
+ *
+ * @param[in] socket Handle referencing the current socket
+ * @param[in] lost If this flag is set, only segments that are deemed lost
+ *   are considered
+ * @return Segment to be retransmitted (NULL if there is no eligible segment)
  **/
 
-void tcpFlushRetransmitQueue(Socket *socket)
+TcpQueueItem *tcpGetNextSegment(Socket *socket, bool_t lost)
 {
-   //Point to the first item in the retransmission queue
-   TcpQueueItem *queueItem = socket->retransmitQueue;
+   uint_t i;
+   uint_t sackedCount;
+   uint_t sackedBytes;
+   TcpQueueItem *queueItem;
 
-   //Loop through retransmission queue
-   while(queueItem != NULL)
+   //Initialize counters
+   sackedCount = 0;
+   sackedBytes = 0;
+
+   //Compute the amount of data that has been selectively acknowledged
+   for(i = 0; i < socket->retransmitQueueLength; i++)
    {
-      //Keep track of the next item in the queue
-      TcpQueueItem *nextQueueItem = queueItem->next;
-      //Free previously allocated memory
-      memPoolFree(queueItem);
-      //Point to the next item
-      queueItem = nextQueueItem;
+      //Point to the current segment
+      queueItem = TCP_RETRANSMIT_QUEUE_ITEM(socket, i);
+
+      //SACKed segment?
+      if(queueItem->sacked)
+      {
+         sackedCount++;
+         sackedBytes += queueItem->length;
+      }
    }
 
-   //The retransmission queue is now flushed
-   socket->retransmitQueue = NULL;
+   //Loop through the retransmission queue
+   for(i = 0; i < socket->retransmitQueueLength && sackedCount > 0; i++)
+   {
+      //Point to the current segment
+      queueItem = TCP_RETRANSMIT_QUEUE_ITEM(socket, i);
 
-   //Turn off the retransmission timer
-   netStopTimer(&socket->retransmitTimer);
+      //SACKed segment?
+      if(queueItem->sacked)
+      {
+         //Keep track of the SACKed data above the next segment
+         sackedCount--;
+         sackedBytes -= queueItem->length;
+      }
+      else if(!queueItem->retransmitted && queueItem->length > 0)
+      {
+         //Rule (3) selects the first hole, while rule (1) selects the first
+         //hole that is deemed lost
+         if(!lost)
+            return queueItem;
+
+         if(sackedCount >= TCP_FAST_RETRANSMIT_THRES ||
+            sackedBytes > ((TCP_FAST_RETRANSMIT_THRES - 1) * socket->smss))
+         {
+            return queueItem;
+         }
+      }
+      else
+      {
+         //The segment is not eligible for retransmission
+      }
+   }
+
+   //Only holes below the highest SACKed sequence number are eligible
+   return NULL;
 }
 
 
 /**
- * @brief Flush SYN queue
- * @param[in] socket Handle referencing the socket
+ * @brief SACK-based loss recovery
+ *
+ * Transmit as many segments as allowed by the difference between the
+ * congestion window and the estimated number of outstanding bytes. Holes
+ * in the scoreboard are retransmitted first, then new data is sent (refer
+ * to RFC 6675, section 5)
+ *
+ * @param[in] socket Handle referencing the current socket
  **/
 
-void tcpFlushSynQueue(Socket *socket)
+void tcpSackLossRecovery(Socket *socket)
 {
-   //Point to the first item in the SYN queue
-   TcpSynQueueItem *queueItem = socket->synQueue;
+#if (TCP_CONGEST_CONTROL_SUPPORT == ENABLED && TCP_SACK_SUPPORT == ENABLED)
+   error_t error;
+   uint_t i;
+   uint_t n;
+   uint_t pipe;
+   uint32_t u;
+   TcpQueueItem *queueItem;
 
-   //Loop through SYN queue
-   while(queueItem != NULL)
+   //Estimate the number of outstanding bytes in the network
+   pipe = tcpComputePipe(socket);
+
+   //The sender may transmit as long as cwnd - pipe >= 1 SMSS
+   while((pipe + socket->smss) <= socket->cwnd)
+   {
+      //Rule (1): first hole that is deemed lost and that has not yet been
+      //retransmitted
+      queueItem = tcpGetNextSegment(socket, TRUE);
+
+      //No such hole?
+      if(queueItem == NULL)
+      {
+         //Retrieve the size of the usable window
+         u = MIN(socket->sndWnd, socket->txBufferSize) -
+            (socket->sndNxt - socket->sndUna);
+
+         //Rule (2): send new data if the receiver window permits
+         if(socket->sndUser > 0 && (int32_t) u > 0)
+         {
+            //Calculate the number of bytes to send at a time
+            n = MIN(u, socket->sndUser);
+            n = MIN(n, socket->smss);
+
+            //Send TCP segment
+            error = tcpSendSegment(socket, TCP_FLAG_PSH | TCP_FLAG_ACK,
+               socket->sndNxt, socket->rcvNxt, n, TRUE);
+            //Failed to send TCP segment?
+            if(error)
+               break;
+
+            //Advance SND.NXT pointer
+            socket->sndNxt += n;
+            //Update the number of data buffered but not yet sent
+            socket->sndUser -= n;
+            //The new segment is in flight
+            pipe += n;
+
+            //Select the next segment to send
+            continue;
+         }
+
+         //Rule (3): first hole that has not yet been retransmitted
+         queueItem = tcpGetNextSegment(socket, FALSE);
+      }
+
+      //Rule (4): if there is neither a hole nor new data to send, a single
+      //rescue retransmission of the last unSACKed segment is allowed per
+      //recovery episode
+      if(queueItem == NULL &&
+         TCP_CMP_SEQ(socket->sndUna, socket->rescueRxt) > 0)
+      {
+         //Search the retransmission queue for the last unSACKed segment
+         for(i = socket->retransmitQueueLength; i > 0; i--)
+         {
+            queueItem = TCP_RETRANSMIT_QUEUE_ITEM(socket, i - 1);
+
+            //Unsacked data segment?
+            if(!queueItem->sacked && queueItem->length > 0)
+               break;
+
+            //Try the previous segment
+            queueItem = NULL;
+         }
+
+         //Only one rescue retransmission per recovery episode
+         socket->rescueRxt = socket->recover;
+      }
+
+      //No segment to send?
+      if(queueItem == NULL)
+         break;
+
+      //Retransmit the selected segment
+      error = tcpRetransmitQueueItem(socket, queueItem);
+      //Failed to retransmit the segment?
+      if(error)
+         break;
+
+      //The segment has been retransmitted during the current recovery
+      //episode and is now in flight
+      queueItem->retransmitted = TRUE;
+      pipe += queueItem->length;
+   }
+
+   //Check whether the transmitter can accept more data
+   tcpUpdateEvents(socket);
+#endif
+}
+
+
+/**
+ * @brief Get the congestion control algorithm that matches the specified name
+ * @param[in] name NULL-terminated string identifying the algorithm (for
+ *   instance "newreno" or "cubic")
+ * @return Pointer to the congestion control algorithm (NULL if the
+ *   algorithm is not supported)
+ **/
+
+const TcpCongestAlgo *tcpGetCongestAlgo(const char_t *name)
+{
+   const TcpCongestAlgo *algo;
+#if (TCP_CONGEST_CONTROL_SUPPORT == ENABLED)
+   uint_t i;
+#endif
+
+   //Initialize pointer
+   algo = NULL;
+
+#if (TCP_CONGEST_CONTROL_SUPPORT == ENABLED)
+   //Loop through the list of supported algorithms
+   for(i = 0; i < arraysize(tcpCongestAlgoList); i++)
+   {
+      //Compare algorithm names
+      if(!osStrcasecmp(tcpCongestAlgoList[i]->name, name))
+      {
+         algo = tcpCongestAlgoList[i];
+         break;
+      }
+   }
+#endif
+
+   //Return the matching algorithm, if any
+   return algo;
+}
+
+
+/**
+ * @brief Update the congestion window upon receipt of an ACK (NewReno)
+ * @param[in] socket Handle referencing the current socket
+ * @param[in] n Number of bytes acknowledged by the incoming ACK
+ * @param[in] updateFlag This flag is set once per round-trip time
+ **/
+
+void tcpNewRenoOnAck(Socket *socket, uint_t n, bool_t updateFlag)
+{
+#if (TCP_CONGEST_CONTROL_SUPPORT == ENABLED)
+   //Slow start algorithm is used when cwnd is lower than ssthresh
+   if(socket->cwnd < socket->ssthresh)
    {
-      //Keep track of the next item in the queue
-      TcpSynQueueItem *nextQueueItem = queueItem->next;
+      //During slow start, TCP increments cwnd by at most SMSS bytes for
+      //each ACK received that cumulatively acknowledges new data
+      socket->cwnd += MIN(n, socket->smss);
+   }
+   //Congestion avoidance algorithm is used when cwnd exceeds ssthres
+   else
+   {
+      //Congestion window is updated once per RTT
+      if(updateFlag)
+      {
+         //TCP must not increment cwnd by more than SMSS bytes
+         socket->cwnd += MIN(socket->n, socket->smss);
+      }
+   }
+#endif
+}
+
+
+/**
+ * @brief Adjust the slow start threshold upon fast retransmit (NewReno)
+ * @param[in] socket Handle referencing the current socket
+ **/
+
+void tcpNewRenoOnLoss(Socket *socket)
+{
+#if (TCP_CONGEST_CONTROL_SUPPORT == ENABLED)
+   uint32_t flightSize;
+
+   //Amount of data that has been sent but not yet acknowledged
+   flightSize = socket->sndNxt - socket->sndUna;
+   //Set ssthresh to no more than half the amount of outstanding data
+   //(refer to RFC 5681, section 3.2)
+   socket->ssthresh = MAX(flightSize / 2, 2 * socket->smss);
+#endif
+}
+
+
+/**
+ * @brief Adjust the slow start threshold upon retransmission timeout (NewReno)
+ * @param[in] socket Handle referencing the current socket
+ **/
+
+void tcpNewRenoOnRto(Socket *socket)
+{
+#if (TCP_CONGEST_CONTROL_SUPPORT == ENABLED)
+   uint32_t flightSize;
+
+   //Amount of data that has been sent but not yet acknowledged
+   flightSize = socket->sndNxt - socket->sndUna;
+   //Adjust ssthresh value (refer to RFC 5681, section 3.1)
+   socket->ssthresh = MAX(flightSize / 2, 2 * socket->smss);
+#endif
+}
+
+
+/**
+ * @brief Congestion window event notification (NewReno)
+ * @param[in] socket Handle referencing the current socket
+ * @param[in] event Congestion window event
+ **/
+
+void tcpNewRenoCwndEvent(Socket *socket, TcpCongestEvent event)
+{
+   //NewReno does not maintain any additional state
+}
+
+
+/**
+ * @brief Process the segment text
+ * @param[in] socket Handle referencing the current socket
+ * @param[in] segment Pointer to the TCP header
+ * @param[in] buffer Multi-part buffer containing the incoming TCP segment
+ * @param[in] offset Offset to the first data byte
+ * @param[in] length Length of the segment data
+ **/
+
+void tcpProcessSegmentData(Socket *socket, const TcpHeader *segment,
+   const NetBuffer *buffer, size_t offset, size_t length)
+{
+   uint32_t leftEdge;
+   uint32_t rightEdge;
+
+   //First sequence number occupied by the incoming segment
+   leftEdge = segment->seqNum;
+   //Sequence number immediately following the incoming segment
+   rightEdge = segment->seqNum + length;
+
+   //Check whether some data falls outside the receive window
+   if(TCP_CMP_SEQ(leftEdge, socket->rcvNxt) < 0)
+   {
+      //Position of the first byte to be read
+      offset += socket->rcvNxt - leftEdge;
+      //Ignore the data that falls outside the receive window
+      leftEdge = socket->rcvNxt;
+   }
+
+   if(TCP_CMP_SEQ(rightEdge, socket->rcvNxt + socket->rcvWnd) > 0)
+   {
+      //Ignore the data that falls outside the receive window
+      rightEdge = socket->rcvNxt + socket->rcvWnd;
+   }
+
+   //Copy the incoming data to the receive buffer
+   tcpWriteRxBuffer(socket, leftEdge, buffer, offset, rightEdge - leftEdge);
+
+   //Update the list of non-contiguous blocks of data that have been received
+   //and queued
+   tcpUpdateSackBlocks(socket, &leftEdge, &rightEdge);
+
+   //Check whether the segment was received out of order
+   if(TCP_CMP_SEQ(leftEdge, socket->rcvNxt) > 0)
+   {
+      //Out of order data segments should be acknowledged immediately, in order
+      //to accelerate loss recovery
+      tcpSendSegment(socket, TCP_FLAG_ACK, socket->sndNxt, socket->rcvNxt, 0,
+         FALSE);
+   }
+   else
+   {
+      //Number of contiguous bytes that have been received
+      length = rightEdge - leftEdge;
+
+      //Next sequence number expected on incoming segments
+      socket->rcvNxt += length;
+      //Number of data available in the receive buffer
+      socket->rcvUser += length;
+      //Update the receive window
+      socket->rcvWnd -= length;
+
+#if (TCP_BUFFER_AUTOTUNE_SUPPORT == ENABLED)
+      //Number of bytes received during the current measurement epoch
+      socket->autotuneRcvBytes += length;
+      //Save the time of the last data transfer
+      socket->autotuneTimestamp = osGetSystemTime();
+#endif
+
+      //Acknowledge the received data (delayed ACK not supported)
+      tcpSendSegment(socket, TCP_FLAG_ACK, socket->sndNxt, socket->rcvNxt, 0,
+         FALSE);
+
+      //Notify user task that data is available
+      tcpUpdateEvents(socket);
+   }
+}
+
+
+/**
+ * @brief Delete TCB structure
+ * @param[in] socket Handle referencing the socket
+ **/
+
+void tcpDeleteControlBlock(Socket *socket)
+{
+   //Delete retransmission queue
+   tcpFlushRetransmitQueue(socket);
+
+   //Delete SYN queue
+   tcpFlushSynQueue(socket);
+
+#if (SOCKET_ZERO_COPY_TX_SUPPORT == ENABLED)
+   //Release caller-owned data
+   tcpFlushTxRefs(socket);
+#endif
+
+   //Release transmit buffer
+   netBufferSetLength((NetBuffer *) &socket->txBuffer, 0);
+
+   //Release receive buffer
+   netBufferSetLength((NetBuffer *) &socket->rxBuffer, 0);
+}
+
+
+/**
+ * @brief Add a segment to the retransmission queue
+ * @param[in] socket Handle referencing the socket
+ * @param[in] flags TCP flags of the segment
+ * @param[in] seqNum Sequence number of the first data byte
+ * @param[in] length Length of the segment data
+ * @return Error code
+ **/
+
+error_t tcpAddRetransmitQueueItem(Socket *socket, uint8_t flags,
+   uint32_t seqNum, size_t length)
+{
+   TcpQueueItem *queueItem;
+
+   //The retransmission queue only references data held in the send buffer,
+   //hence the TCP header is not saved and is regenerated upon retransmission
+   queueItem = NULL;
+
+   //Any segment in the retransmission queue?
+   if(socket->retransmitQueueLength > 0)
+   {
+      //Point to the most recent segment
+      queueItem = TCP_RETRANSMIT_QUEUE_ITEM(socket,
+         socket->retransmitQueueLength - 1);
+
+      //A SYN ACK sent in response to a simultaneous open supersedes the
+      //initial SYN segment
+      if((flags & TCP_FLAG_SYN) != 0 && queueItem->seqNum == seqNum)
+      {
+         //Update TCP flags
+         queueItem->flags = flags;
+         //We are done
+         return NO_ERROR;
+      }
+
+      //The queue is full?
+      if(socket->retransmitQueueLength >= TCP_MAX_RETRANSMIT_QUEUE_SIZE)
+      {
+         //Contiguous data can be merged with the most recent segment. Large
+         //items are split into SMSS-sized segments upon retransmission
+         if((queueItem->flags & (TCP_FLAG_SYN | TCP_FLAG_FIN)) == 0 &&
+            !queueItem->sacked && !queueItem->retransmitted &&
+            queueItem->seqNum + queueItem->length == seqNum &&
+            (queueItem->length + length) <= UINT16_MAX)
+         {
+            //Merge the new segment with the most recent one
+            queueItem->length += length;
+            queueItem->flags |= flags;
+            //We are done
+            return NO_ERROR;
+         }
+         else
+         {
+            //Report an error
+            return ERROR_OUT_OF_RESOURCES;
+         }
+      }
+   }
+
+   //Append a new item to the tail of the queue
+   queueItem = TCP_RETRANSMIT_QUEUE_ITEM(socket, socket->retransmitQueueLength);
+   socket->retransmitQueueLength++;
+
+   //Retransmission mechanism requires additional information
+   queueItem->seqNum = seqNum;
+   queueItem->length = length;
+   queueItem->flags = flags;
+   queueItem->sacked = FALSE;
+   queueItem->retransmitted = FALSE;
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Search the retransmission queue for a given sequence number
+ * @param[in] socket Handle referencing the socket
+ * @param[in] seqNum Sequence number
+ * @return Position of the first segment whose sequence number is greater
+ *   than or equal to the specified value
+ **/
+
+uint_t tcpFindRetransmitQueueItem(Socket *socket, uint32_t seqNum)
+{
+   uint_t low;
+   uint_t mid;
+   uint_t high;
+
+   //The retransmission queue is sorted by sequence number
+   low = 0;
+   high = socket->retransmitQueueLength;
+
+   //Binary search
+   while(low < high)
+   {
+      mid = low + (high - low) / 2;
+
+      //Compare sequence numbers
+      if(TCP_CMP_SEQ(TCP_RETRANSMIT_QUEUE_ITEM(socket, mid)->seqNum,
+         seqNum) < 0)
+      {
+         low = mid + 1;
+      }
+      else
+      {
+         high = mid;
+      }
+   }
+
+   //Return the position of the matching segment
+   return low;
+}
+
+
+/**
+ * @brief Remove acknowledged segments from retransmission queue
+ * @param[in] socket Handle referencing the socket
+ **/
+
+void tcpUpdateRetransmitQueue(Socket *socket)
+{
+   size_t length;
+   TcpQueueItem *queueItem;
+
+   //Segments are acknowledged in sequence number order, hence only the
+   //head of the queue needs to be examined
+   while(socket->retransmitQueueLength > 0)
+   {
+      //Point to the oldest segment
+      queueItem = TCP_RETRANSMIT_QUEUE_ITEM(socket, 0);
+
+      //Calculate the length of the TCP segment
+      if(queueItem->flags & TCP_FLAG_SYN)
+      {
+         length = 1;
+      }
+      else if(queueItem->flags & TCP_FLAG_FIN)
+      {
+         length = queueItem->length + 1;
+      }
+      else
+      {
+         length = queueItem->length;
+      }
+
+      //If an acknowledgment is received for a segment before its timer
+      //expires, the segment is removed from the retransmission queue
+      if(TCP_CMP_SEQ(socket->sndUna, queueItem->seqNum + length) >= 0)
+      {
+         //Remove the current item from the queue
+         socket->retransmitQueueHead = (socket->retransmitQueueHead + 1) %
+            TCP_MAX_RETRANSMIT_QUEUE_SIZE;
+         socket->retransmitQueueLength--;
+
+         //When an ACK is received that acknowledges new data, restart the
+         //retransmission timer so that it will expire after RTO seconds
+         netStartTimer(&socket->retransmitTimer, socket->rto);
+         //Reset retransmission counter
+         socket->retransmitCount = 0;
+      }
+      else
+      {
+         //Partially acknowledged segment?
+         if((queueItem->flags & TCP_FLAG_SYN) == 0 &&
+            TCP_CMP_SEQ(socket->sndUna, queueItem->seqNum) > 0)
+         {
+            //Trim the acknowledged data so that only the remaining bytes are
+            //retransmitted
+            queueItem->length -= socket->sndUna - queueItem->seqNum;
+            queueItem->seqNum = socket->sndUna;
+         }
+
+         //No acknowledgment received for the current segment...
+         break;
+      }
+   }
+
+   //When all outstanding data has been acknowledged,
+   //turn off the retransmission timer
+   if(socket->retransmitQueueLength == 0)
+      netStopTimer(&socket->retransmitTimer);
+
+#if (SOCKET_ZERO_COPY_TX_SUPPORT == ENABLED)
+   //Release the caller-owned data that have been acknowledged
+   tcpUpdateTxRefs(socket);
+#endif
+}
+
+
+/**
+ * @brief Flush retransmission queue
+ * @param[in] socket Handle referencing the socket
+ **/
+
+void tcpFlushRetransmitQueue(Socket *socket)
+{
+   //Reset the retransmission queue
+   socket->retransmitQueueHead = 0;
+   socket->retransmitQueueLength = 0;
+
+   //Turn off the retransmission timer
+   netStopTimer(&socket->retransmitTimer);
+}
+
+
+/**
+ * @brief Flush SYN queue
+ * @param[in] socket Handle referencing the socket
+ **/
+
+void tcpFlushSynQueue(Socket *socket)
+{
+   //Loop through SYN queue
+   while(socket->synQueue != NULL)
+   {
+      //Remove the first item from the SYN queue
+      tcpRemoveSynQueueItem(socket);
+   }
+}
+
+
+/**
+ * @brief Allocate a SYN queue item for an incoming connection request
+ * @param[in] interface Underlying network interface
+ * @param[in] pseudoHeader TCP pseudo header
+ * @param[in] segment Incoming TCP segment
+ * @return Pointer to the newly created item
+ **/
+
+TcpSynQueueItem *tcpCreateSynQueueItem(NetInterface *interface,
+   const IpPseudoHeader *pseudoHeader, const TcpHeader *segment)
+{
+   TcpSynQueueItem *queueItem;
+
+   //Allocate memory to save incoming data
+   queueItem = memPoolAlloc(sizeof(TcpSynQueueItem));
+   //Failed to allocate memory?
+   if(queueItem == NULL)
+      return NULL;
+
+   //Clear the item
+   osMemset(queueItem, 0, sizeof(TcpSynQueueItem));
+
+#if (IPV4_SUPPORT == ENABLED)
+   //IPv4 is currently used?
+   if(pseudoHeader->length == sizeof(Ipv4PseudoHeader))
+   {
+      //Save the source IPv4 address
+      queueItem->srcAddr.length = sizeof(Ipv4Addr);
+      queueItem->srcAddr.ipv4Addr = pseudoHeader->ipv4Data.srcAddr;
+
+      //Save the destination IPv4 address
+      queueItem->destAddr.length = sizeof(Ipv4Addr);
+      queueItem->destAddr.ipv4Addr = pseudoHeader->ipv4Data.destAddr;
+   }
+   else
+#endif
+#if (IPV6_SUPPORT == ENABLED)
+   //IPv6 is currently used?
+   if(pseudoHeader->length == sizeof(Ipv6PseudoHeader))
+   {
+      //Save the source IPv6 address
+      queueItem->srcAddr.length = sizeof(Ipv6Addr);
+      queueItem->srcAddr.ipv6Addr = pseudoHeader->ipv6Data.srcAddr;
+
+      //Save the destination IPv6 address
+      queueItem->destAddr.length = sizeof(Ipv6Addr);
+      queueItem->destAddr.ipv6Addr = pseudoHeader->ipv6Data.destAddr;
+   }
+   else
+#endif
+   //Invalid pseudo header?
+   {
+      //Free previously allocated memory
+      memPoolFree(queueItem);
+      //This should never occur...
+      return NULL;
+   }
+
+   //Underlying network interface
+   queueItem->interface = interface;
+   //Save the port number of the client
+   queueItem->srcPort = segment->srcPort;
+
+   //Return a pointer to the newly created item
+   return queueItem;
+}
+
+
+/**
+ * @brief Append an item to the SYN queue
+ * @param[in] socket Handle referencing the listening socket
+ * @param[in] queueItem Item to be added
+ **/
+
+void tcpAddSynQueueItem(Socket *socket, TcpSynQueueItem *queueItem)
+{
+#if (TCP_SYN_QUEUE_HASH_SUPPORT == ENABLED)
+   uint_t i;
+#endif
+
+   //The item is added at the tail of the queue
+   queueItem->next = NULL;
+
+   //Check whether the SYN queue is empty or not
+   if(socket->synQueue == NULL)
+   {
+      socket->synQueue = queueItem;
+   }
+   else
+   {
+      socket->synQueueTail->next = queueItem;
+   }
+
+   //Update the tail of the queue
+   socket->synQueueTail = queueItem;
+   //Number of pending connections
+   socket->synQueueLength++;
+
+#if (TCP_SYN_QUEUE_HASH_SUPPORT == ENABLED)
+   //Insert the item in the hash table
+   i = tcpHashSynQueueKey(&queueItem->srcAddr, queueItem->srcPort);
+   queueItem->socket = socket;
+   queueItem->hashNext = tcpSynQueueHashTable[i];
+   tcpSynQueueHashTable[i] = queueItem;
+#endif
+}
+
+
+/**
+ * @brief Remove the first item from the SYN queue
+ * @param[in] socket Handle referencing the listening socket
+ **/
+
+void tcpRemoveSynQueueItem(Socket *socket)
+{
+   TcpSynQueueItem *queueItem;
+#if (TCP_SYN_QUEUE_HASH_SUPPORT == ENABLED)
+   TcpSynQueueItem **p;
+#endif
+
+   //Point to the first item in the SYN queue
+   queueItem = socket->synQueue;
+
+   //Make sure the SYN queue is not empty
+   if(queueItem != NULL)
+   {
+#if (TCP_SYN_QUEUE_HASH_SUPPORT == ENABLED)
+      //Remove the item from its hash bucket
+      for(p = &tcpSynQueueHashTable[tcpHashSynQueueKey(&queueItem->srcAddr,
+         queueItem->srcPort)]; *p != NULL; p = &(*p)->hashNext)
+      {
+         //Matching item?
+         if(*p == queueItem)
+         {
+            *p = queueItem->hashNext;
+            break;
+         }
+      }
+#endif
+
+      //Remove the item from the SYN queue
+      socket->synQueue = queueItem->next;
+
+      //Update the tail of the queue
+      if(socket->synQueue == NULL)
+      {
+         socket->synQueueTail = NULL;
+      }
+
+      //Number of pending connections
+      socket->synQueueLength--;
+
       //Free previously allocated memory
       memPoolFree(queueItem);
-      //Point to the next item
-      queueItem = nextQueueItem;
    }
+}
+
+
+#if (TCP_SYN_QUEUE_HASH_SUPPORT == ENABLED)
+
+/**
+ * @brief Compute the SYN queue hash bucket of a connection request
+ * @param[in] srcAddr IP address of the client
+ * @param[in] srcPort Port number of the client
+ * @return Index of the hash bucket
+ **/
+
+uint_t tcpHashSynQueueKey(const IpAddr *srcAddr, uint16_t srcPort)
+{
+   uint32_t h;
+
+   //The port number of the client is part of the key
+   h = srcPort * 0x9E3779B1U;
+
+#if (IPV4_SUPPORT == ENABLED)
+   //IPv4 address?
+   if(srcAddr->length == sizeof(Ipv4Addr))
+   {
+      //Mix the IPv4 address
+      h ^= srcAddr->ipv4Addr;
+   }
+   else
+#endif
+#if (IPV6_SUPPORT == ENABLED)
+   //IPv6 address?
+   if(srcAddr->length == sizeof(Ipv6Addr))
+   {
+      //Fold the IPv6 address
+      h ^= srcAddr->ipv6Addr.dw[0] ^ srcAddr->ipv6Addr.dw[1] ^
+         srcAddr->ipv6Addr.dw[2] ^ srcAddr->ipv6Addr.dw[3];
+   }
+   else
+#endif
+   //Invalid IP address?
+   {
+      //Just for sanity
+   }
+
+   //Final avalanche
+   h ^= h >> 16;
+   h *= 0x45D9F3BU;
+   h ^= h >> 16;
+
+   //Return the index of the hash bucket
+   return h % TCP_SYN_QUEUE_HASH_SIZE;
+}
+
+#endif
+#if (TCP_SYN_COOKIE_SUPPORT == ENABLED)
+
+/**
+ * @brief Generate a SYN cookie
+ *
+ * The cookie encodes a 5-bit time counter, a 3-bit index into the MSS
+ * table and a 24-bit keyed hash of the connection 4-tuple, the client ISN
+ * and the two other fields
+ *
+ * @param[in] pseudoHeader TCP pseudo header describing the incoming segment
+ * @param[in] segment Incoming TCP segment
+ * @param[in] isn Initial sequence number of the client
+ * @param[in] counter Value of the time counter
+ * @param[in] mssIndex Index of the MSS value in the MSS table
+ * @return SYN cookie
+ **/
+
+uint32_t tcpGenerateSynCookie(const IpPseudoHeader *pseudoHeader,
+   const TcpHeader *segment, uint32_t isn, uint_t counter, uint_t mssIndex)
+{
+   uint32_t value;
+   Md5Context md5Context;
+
+   //Initialize MD5 context
+   md5Init(&md5Context);
+
+#if (IPV4_SUPPORT == ENABLED)
+   //IPv4 segment?
+   if(pseudoHeader->length == sizeof(Ipv4PseudoHeader))
+   {
+      //Digest the source and destination IPv4 addresses
+      md5Update(&md5Context, &pseudoHeader->ipv4Data.srcAddr, sizeof(Ipv4Addr));
+      md5Update(&md5Context, &pseudoHeader->ipv4Data.destAddr, sizeof(Ipv4Addr));
+   }
+   else
+#endif
+#if (IPV6_SUPPORT == ENABLED)
+   //IPv6 segment?
+   if(pseudoHeader->length == sizeof(Ipv6PseudoHeader))
+   {
+      //Digest the source and destination IPv6 addresses
+      md5Update(&md5Context, &pseudoHeader->ipv6Data.srcAddr, sizeof(Ipv6Addr));
+      md5Update(&md5Context, &pseudoHeader->ipv6Data.destAddr, sizeof(Ipv6Addr));
+   }
+   else
+#endif
+   //Invalid pseudo header?
+   {
+      //Just for sanity
+   }
+
+   //Digest the port numbers, the client ISN and the encoded fields
+   md5Update(&md5Context, &segment->srcPort, sizeof(uint16_t));
+   md5Update(&md5Context, &segment->destPort, sizeof(uint16_t));
+   md5Update(&md5Context, &isn, sizeof(uint32_t));
+   md5Update(&md5Context, &counter, sizeof(uint_t));
+   md5Update(&md5Context, &mssIndex, sizeof(uint_t));
+
+   //The secret key is the random seed of the TCP/IP stack
+   md5Update(&md5Context, netContext.randSeed, NET_RAND_SEED_SIZE);
+   md5Final(&md5Context, NULL);
+
+   //Extract the first 24 bits of the digest
+   value = LOAD32BE(md5Context.digest) & 0x00FFFFFF;
+
+   //Format the SYN cookie
+   return ((counter & 0x1F) << 27) | ((mssIndex & 0x07) << 24) | value;
+}
+
+
+/**
+ * @brief Reply to a connection request with a SYN cookie
+ *
+ * No state is kept for the connection request. The SYN ACK carries a
+ * sequence number from which the connection can be rebuilt when the final
+ * ACK of the three-way handshake comes back
+ *
+ * @param[in] socket Handle referencing the listening socket
+ * @param[in] interface Underlying network interface
+ * @param[in] pseudoHeader TCP pseudo header describing the incoming segment
+ * @param[in] segment Incoming SYN segment
+ * @param[in] mss Maximum segment size negotiated with the client
+ * @return Error code
+ **/
+
+error_t tcpSendSynCookie(Socket *socket, NetInterface *interface,
+   const IpPseudoHeader *pseudoHeader, const TcpHeader *segment, uint16_t mss)
+{
+   uint_t i;
+   uint_t counter;
+   uint32_t cookie;
+
+   //Select the largest encodable MSS that does not exceed the negotiated one
+   for(i = arraysize(tcpSynCookieMssTable) - 1; i > 0; i--)
+   {
+      if(tcpSynCookieMssTable[i] <= mss)
+         break;
+   }
+
+   //Current value of the time counter
+   counter = (osGetSystemTime() / TCP_SYN_COOKIE_PERIOD) & 0x1F;
+
+   //Generate the SYN cookie
+   cookie = tcpGenerateSynCookie(pseudoHeader, segment, segment->seqNum,
+      counter, i);
+
+   //Debug message
+   TRACE_DEBUG("SYN queue full, sending SYN cookie...\r\n");
+
+   //Cookie-validated ACKs are only accepted shortly after a cookie was sent
+   socket->synCookieSent = TRUE;
+   socket->synCookieTimestamp = osGetSystemTime();
+
+   //The sequence number of the SYN ACK is the cookie itself
+   return tcpSendStatelessSegment(interface, pseudoHeader, segment,
+      TCP_FLAG_SYN | TCP_FLAG_ACK, cookie, segment->seqNum + 1,
+      MIN(socket->rxBufferSize, UINT16_MAX), tcpSynCookieMssTable[i]);
+}
+
+
+/**
+ * @brief Validate an ACK segment carrying a SYN cookie
+ *
+ * When the cookie is valid, a completed connection is added to the SYN
+ * queue of the listening socket and will be handed over to the application
+ * by the next call to socketAccept(). Further segments received on that
+ * connection before it is accepted are silently discarded
+ *
+ * @param[in] socket Handle referencing the listening socket
+ * @param[in] interface Underlying network interface
+ * @param[in] pseudoHeader TCP pseudo header describing the incoming segment
+ * @param[in] segment Incoming ACK segment
+ * @return Error code (ERROR_INVALID_SEQUENCE_NUMBER if the ACK does not
+ *   match any cookie)
+ **/
+
+error_t tcpProcessSynCookie(Socket *socket, NetInterface *interface,
+   const IpPseudoHeader *pseudoHeader, const TcpHeader *segment)
+{
+   uint_t counter;
+   uint_t mssIndex;
+   uint32_t cookie;
+   uint32_t isn;
+   TcpSynQueueItem *queueItem;
+
+   //The ACK must not carry a SYN
+   if((segment->flags & TCP_FLAG_SYN) != 0)
+      return ERROR_INVALID_SEQUENCE_NUMBER;
+
+   //Search the SYN queue for a connection with the same 4-tuple
+   queueItem = tcpFindSynQueueItem(socket, pseudoHeader, segment);
+
+   //The peer may keep sending (retransmitted ACK, data segments) before the
+   //connection is accepted. Such segments no longer carry the cookie in a
+   //form that can be checked, but they must not be answered with a RST
+   if(queueItem != NULL && queueItem->synCookie)
+      return NO_ERROR;
+
+   //Cookies are only checked while the listening socket is under pressure
+   if(!socket->synCookieSent)
+      return ERROR_INVALID_SEQUENCE_NUMBER;
+
+   //Cookies older than two periods are never accepted
+   if(timeCompare(osGetSystemTime(), socket->synCookieTimestamp +
+      2 * TCP_SYN_COOKIE_PERIOD) >= 0)
+   {
+      socket->synCookieSent = FALSE;
+      return ERROR_INVALID_SEQUENCE_NUMBER;
+   }
+
+   //The acknowledgment number acknowledges the cookie
+   cookie = segment->ackNum - 1;
+   //The sequence number follows the client ISN
+   isn = segment->seqNum - 1;
+
+   //Extract the encoded fields
+   counter = (cookie >> 27) & 0x1F;
+   mssIndex = (cookie >> 24) & 0x07;
+
+   //The cookie must have been issued during the current or previous period
+   if((((osGetSystemTime() / TCP_SYN_COOKIE_PERIOD) - counter) & 0x1F) > 1)
+      return ERROR_INVALID_SEQUENCE_NUMBER;
+
+   //Check the keyed hash
+   if(cookie != tcpGenerateSynCookie(pseudoHeader, segment, isn, counter,
+      mssIndex))
+   {
+      return ERROR_INVALID_SEQUENCE_NUMBER;
+   }
+
+   //A connection request with the same 4-tuple is already pending
+   if(queueItem != NULL)
+      return NO_ERROR;
+
+   //The connection is dropped silently if the SYN queue is still full
+   if(socket->synQueueLength >= socket->synQueueSize)
+      return NO_ERROR;
+
+   //Allocate a new item
+   queueItem = tcpCreateSynQueueItem(interface, pseudoHeader, segment);
+   //Failed to allocate memory?
+   if(queueItem == NULL)
+      return NO_ERROR;
+
+   //The three-way handshake is already complete
+   queueItem->synCookie = TRUE;
+   queueItem->isn = isn;
+   queueItem->iss = cookie;
+   queueItem->window = segment->window;
+
+   //Recover the MSS encoded in the cookie
+   queueItem->mss = MIN(tcpSynCookieMssTable[mssIndex], socket->mss);
+
+#if (TCP_SACK_SUPPORT == ENABLED)
+   //The SACK Permitted option cannot be recovered from the cookie
+   queueItem->sackPermitted = FALSE;
+#endif
+
+   //Add the completed connection to the SYN queue
+   tcpAddSynQueueItem(socket, queueItem);
+
+   //Notify user that a connection request is pending
+   tcpUpdateEvents(socket);
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+#endif
+
+
+#if (SOCKET_ZERO_COPY_TX_SUPPORT == ENABLED)
+
+/**
+ * @brief Release the caller-owned regions that have been acknowledged
+ * @param[in] socket Handle referencing the socket
+ **/
+
+void tcpUpdateTxRefs(Socket *socket)
+{
+   uint_t i;
+   TcpTxRef ref;
+
+   //Regions are acknowledged in sequence number order
+   while(socket->txRefCount > 0)
+   {
+      //Point to the oldest region
+      ref = socket->txRef[0];
+
+      //Check whether the whole region has been acknowledged
+      if(TCP_CMP_SEQ(socket->sndUna, ref.seqNum + ref.length) < 0)
+         break;
+
+      //Remove the region from the list
+      for(i = 1; i < socket->txRefCount; i++)
+      {
+         socket->txRef[i - 1] = socket->txRef[i];
+      }
+
+      //Update the number of regions
+      socket->txRefCount--;
+
+      //The data are no longer referenced by the send buffer
+      if(ref.callback != NULL)
+      {
+         ref.callback(socket, ref.param, NO_ERROR);
+      }
+   }
+}
+
 
-   //SYN queue was successfully flushed
-   socket->synQueue = NULL;
+/**
+ * @brief Release all the caller-owned regions
+ * @param[in] socket Handle referencing the socket
+ **/
+
+void tcpFlushTxRefs(Socket *socket)
+{
+   uint_t i;
+   uint_t n;
+
+   //Get the number of regions
+   n = socket->txRefCount;
+   //Flush the list
+   socket->txRefCount = 0;
+
+   //Loop through the regions
+   for(i = 0; i < n; i++)
+   {
+      //The data will never be acknowledged
+      if(socket->txRef[i].callback != NULL)
+      {
+         socket->txRef[i].callback(socket, socket->txRef[i].param,
+            ERROR_NOT_CONNECTED);
+      }
+   }
 }
 
+#endif
+
 
 /**
  * @brief Update the list of non-contiguous blocks that have been received
@@ -1613,55 +3091,247 @@ void tcpUpdateSendWindow(Socket *socket, const TcpHeader *segment)
          netStartTimer(&socket->persistTimer, socket->wndProbeInterval);
       }
 
-      //Update the send window and record the sequence number and the
-      //acknowledgment number used to update SND.WND
-      socket->sndWnd = segment->window;
-      socket->sndWl1 = segment->seqNum;
-      socket->sndWl2 = segment->ackNum;
+      //Update the send window and record the sequence number and the
+      //acknowledgment number used to update SND.WND
+      socket->sndWnd = segment->window;
+      socket->sndWl1 = segment->seqNum;
+      socket->sndWl2 = segment->ackNum;
+
+      //Maximum send window it has seen so far on the connection
+      socket->maxSndWnd = MAX(socket->maxSndWnd, segment->window);
+   }
+}
+
+
+/**
+ * @brief Update receive window so as to avoid Silly Window Syndrome
+ * @param[in] socket Handle referencing the socket
+ **/
+
+void tcpUpdateReceiveWindow(Socket *socket)
+{
+   uint16_t reduction;
+
+   //Space available but not yet advertised
+   reduction = socket->rxBufferSize - socket->rcvUser - socket->rcvWnd;
+
+   //To avoid SWS, the receiver should not advertise small windows
+   if((socket->rcvWnd + reduction) >= MIN(socket->rmss, socket->rxBufferSize / 2))
+   {
+      //Check whether a window update should be sent
+      if(socket->rcvWnd < MIN(socket->rmss, socket->rxBufferSize / 2))
+      {
+         //Debug message
+         TRACE_INFO("%s: TCP sending window update...\r\n",
+            formatSystemTime(osGetSystemTime(), NULL));
+
+         //Update the receive window
+         socket->rcvWnd += reduction;
+
+         //Send an ACK segment to advertise the new window size
+         tcpSendSegment(socket, TCP_FLAG_ACK, socket->sndNxt, socket->rcvNxt,
+            0, FALSE);
+      }
+      else
+      {
+         //The receive window can be updated
+         socket->rcvWnd += reduction;
+      }
+   }
+}
+
+
+/**
+ * @brief Grow the send buffer when it limits the throughput
+ *
+ * The send buffer is doubled when it is full and both the congestion window
+ * and the peer's receive window are at least as large as the buffer. Since
+ * the size is exactly doubled, each byte either stays at the same offset or
+ * moves to the freshly allocated upper half of the buffer
+ *
+ * @param[in] socket Handle referencing the socket
+ **/
+
+void tcpAutotuneTxBuffer(Socket *socket)
+{
+#if (TCP_BUFFER_AUTOTUNE_SUPPORT == ENABLED)
+   error_t error;
+   size_t i;
+   size_t n;
+   size_t length;
+   size_t offset;
+   size_t oldSize;
+   uint32_t seqNum;
+   uint8_t temp[256];
+
+   //Buffer autotuning disabled?
+   if(!socket->bufferAutotune)
+      return;
+
+   //Check current TCP state
+   if(socket->state != TCP_STATE_ESTABLISHED &&
+      socket->state != TCP_STATE_CLOSE_WAIT)
+   {
+      return;
+   }
+
+   //Current size of the send buffer
+   oldSize = socket->txBufferSize;
+
+   //Make sure the maximum buffer size is not exceeded
+   if((oldSize * 2) > TCP_MAX_TX_BUFFER_SIZE)
+      return;
+
+   //Determine the actual number of bytes in the send buffer
+   length = socket->sndUser + socket->sndNxt - socket->sndUna;
+
+   //The send buffer should be grown only when it is full
+   if(length < oldSize)
+      return;
+
+   //The send window must be large enough to use a bigger buffer
+   if(socket->sndWnd < oldSize)
+      return;
+
+#if (TCP_CONGEST_CONTROL_SUPPORT == ENABLED)
+   //The congestion window must have reached the size of the buffer
+   if(socket->cwnd < oldSize)
+      return;
+#endif
+
+#if (SOCKET_ZERO_COPY_TX_SUPPORT == ENABLED)
+   //Caller-owned data cannot be relocated
+   if(socket->txRefCount > 0)
+      return;
+#endif
+
+   //Allocate additional memory
+   error = netBufferSetLength((NetBuffer *) &socket->txBuffer, oldSize * 2);
+
+   //Failed to allocate memory?
+   if(error)
+   {
+      //Restore the original buffer size
+      netBufferSetLength((NetBuffer *) &socket->txBuffer, oldSize);
+      return;
+   }
+
+   //Debug message
+   TRACE_DEBUG("TCP send buffer grown to %" PRIuSIZE " bytes\r\n", oldSize * 2);
 
-      //Maximum send window it has seen so far on the connection
-      socket->maxSndWnd = MAX(socket->maxSndWnd, segment->window);
+   //Use the new buffer size
+   socket->txBufferSize = oldSize * 2;
+
+   //Relocate the data according to the new buffer size
+   for(i = 0; i < length; i += n)
+   {
+      //Sequence number of the current block
+      seqNum = socket->sndUna + i;
+      //Offset of the current block in the original buffer
+      offset = (seqNum - socket->iss - 1) % oldSize;
+
+      //Limit the number of bytes to copy at a time
+      n = MIN(length - i, sizeof(temp));
+      n = MIN(n, oldSize - offset);
+
+      //Read data from the original location
+      netBufferRead(temp, (NetBuffer *) &socket->txBuffer, offset, n);
+      //Write data to their new location
+      tcpWriteTxBuffer(socket, seqNum, temp, n);
    }
+
+   //Update TX events
+   tcpUpdateEvents(socket);
+#endif
 }
 
 
 /**
- * @brief Update receive window so as to avoid Silly Window Syndrome
+ * @brief Grow the receive buffer when it limits the throughput
+ *
+ * The amount of data received during each round-trip time is measured. The
+ * receive buffer is doubled whenever the peer fills more than half of the
+ * buffer within a single round-trip time
+ *
  * @param[in] socket Handle referencing the socket
  **/
 
-void tcpUpdateReceiveWindow(Socket *socket)
+void tcpAutotuneRxBuffer(Socket *socket)
 {
-   uint16_t reduction;
+#if (TCP_BUFFER_AUTOTUNE_SUPPORT == ENABLED)
+   error_t error;
+   size_t size;
+   uint32_t n;
+   systime_t time;
+   systime_t elapsed;
 
-   //Space available but not yet advertised
-   reduction = socket->rxBufferSize - socket->rcvUser - socket->rcvWnd;
+   //Buffer autotuning disabled?
+   if(!socket->bufferAutotune)
+      return;
 
-   //To avoid SWS, the receiver should not advertise small windows
-   if((socket->rcvWnd + reduction) >= MIN(socket->rmss, socket->rxBufferSize / 2))
+   //Check current TCP state
+   if(socket->state != TCP_STATE_ESTABLISHED &&
+      socket->state != TCP_STATE_FIN_WAIT_1 &&
+      socket->state != TCP_STATE_FIN_WAIT_2)
    {
-      //Check whether a window update should be sent
-      if(socket->rcvWnd < MIN(socket->rmss, socket->rxBufferSize / 2))
-      {
-         //Debug message
-         TRACE_INFO("%s: TCP sending window update...\r\n",
-            formatSystemTime(osGetSystemTime(), NULL));
+      return;
+   }
 
-         //Update the receive window
-         socket->rcvWnd += reduction;
+   //No RTT sample available yet?
+   if(socket->srtt == 0)
+      return;
 
-         //Send an ACK segment to advertise the new window size
-         tcpSendSegment(socket, TCP_FLAG_ACK, socket->sndNxt, socket->rcvNxt,
-            0, FALSE);
-      }
-      else
-      {
-         //The receive window can be updated
-         socket->rcvWnd += reduction;
-      }
+   //The receive buffer can only be resized when it is empty
+   if(socket->rcvUser > 0 || socket->sackBlockCount > 0)
+      return;
+
+   //Get current time
+   time = osGetSystemTime();
+   //Time elapsed since the beginning of the measurement epoch
+   elapsed = time - socket->autotuneRcvTimestamp;
+
+   //Each measurement epoch lasts one round-trip time
+   if(elapsed < socket->srtt)
+      return;
+
+   //Estimate the number of bytes received per round-trip time
+   n = (uint32_t) ((uint64_t) socket->autotuneRcvBytes * socket->srtt / elapsed);
+
+   //Start a new measurement epoch
+   socket->autotuneRcvBytes = 0;
+   socket->autotuneRcvTimestamp = time;
+
+   //The peer is not limited by the receive window?
+   if(n < (socket->rxBufferSize / 2))
+      return;
+
+   //Double the size of the receive buffer
+   size = MIN(socket->rxBufferSize * 2, TCP_MAX_RX_BUFFER_SIZE);
+
+   //Make sure the maximum buffer size is not exceeded
+   if(size <= socket->rxBufferSize)
+      return;
+
+   //Allocate additional memory
+   error = netBufferSetLength((NetBuffer *) &socket->rxBuffer, size);
+
+   //Failed to allocate memory?
+   if(error)
+   {
+      //Restore the original buffer size
+      netBufferSetLength((NetBuffer *) &socket->rxBuffer, socket->rxBufferSize);
+      return;
    }
-}
 
+   //Debug message
+   TRACE_DEBUG("TCP receive buffer grown to %" PRIuSIZE " bytes\r\n", size);
+
+   //Use the new buffer size
+   socket->rxBufferSize = size;
+   //Advertise the additional space
+   tcpUpdateReceiveWindow(socket);
+#endif
+}
 
 /**
  * @brief Compute retransmission timeout
@@ -1741,111 +3411,184 @@ bool_t tcpComputeRto(Socket *socket)
 error_t tcpRetransmitSegment(Socket *socket)
 {
    error_t error;
-   size_t offset;
+   uint_t i;
    size_t length;
-   NetBuffer *buffer;
    TcpQueueItem *queueItem;
-   TcpHeader *header;
-   NetTxAncillary ancillary;
 
    //Initialize error code
    error = NO_ERROR;
    //Total number of bytes that have been retransmitted
    length = 0;
 
-   //Point to the retransmission queue
-   queueItem = socket->retransmitQueue;
-
-   //Any segment in the retransmission queue?
-   while(queueItem != NULL)
+   //Loop through the retransmission queue
+   for(i = 0; i < socket->retransmitQueueLength; i++)
    {
+      //Point to the current segment
+      queueItem = TCP_RETRANSMIT_QUEUE_ITEM(socket, i);
+
+#if (TCP_SACK_SUPPORT == ENABLED)
+      //Segments that have been selectively acknowledged by the receiver
+      //do not need to be retransmitted
+      if(queueItem->sacked)
+         continue;
+#endif
+
       //Total number of bytes that have been retransmitted
       length += queueItem->length;
 
       //The amount of data that can be sent cannot exceed the MSS
       if(length > socket->smss)
       {
-         //We are done
-         error = NO_ERROR;
+         //Items resulting from the merging of contiguous segments may be
+         //larger than the MSS. Retransmit the first SMSS bytes only
+         if(length == queueItem->length)
+         {
+            error = tcpRetransmitData(socket, queueItem->flags &
+               ~(TCP_FLAG_FIN | TCP_FLAG_PSH), queueItem->seqNum, socket->smss);
+         }
+
          //Exit immediately
          break;
       }
 
-      //Point to the TCP header
-      header = (TcpHeader *) queueItem->header;
-
-      //Allocate a memory buffer to hold the TCP segment
-      buffer = ipAllocBuffer(0, &offset);
-      //Failed to allocate memory?
-      if(buffer == NULL)
+      //Retransmit the current segment
+      error = tcpRetransmitQueueItem(socket, queueItem);
+      //Any error to report?
+      if(error)
       {
-         //Report an error
-         error = ERROR_OUT_OF_MEMORY;
          //Exit immediately
          break;
       }
+   }
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Retransmit a segment from the retransmission queue
+ * @param[in] socket Handle referencing the socket
+ * @param[in] queueItem Segment to be retransmitted
+ * @return Error code
+ **/
+
+error_t tcpRetransmitQueueItem(Socket *socket, const TcpQueueItem *queueItem)
+{
+   error_t error;
+   uint8_t flags;
+   uint32_t seqNum;
+   size_t n;
+   size_t length;
+
+   //Sequence number of the first byte to retransmit
+   seqNum = queueItem->seqNum;
+   //Number of bytes to retransmit
+   length = queueItem->length;
 
-      //Start of exception handling block
-      do
+   //Items resulting from the merging of contiguous segments are split into
+   //SMSS-sized segments
+   do
+   {
+      //Calculate the number of bytes to send at a time
+      n = MIN(length, socket->smss);
+
+      //The FIN and PSH flags are only set on the last segment
+      if(n < length)
       {
-         //Copy TCP header
-         error = netBufferAppend(buffer, header, header->dataOffset * 4);
-         //Any error to report?
-         if(error)
-            break;
+         flags = queueItem->flags & ~(TCP_FLAG_FIN | TCP_FLAG_PSH);
+      }
+      else
+      {
+         flags = queueItem->flags;
+      }
 
-         //Copy data from send buffer
-         error = tcpReadTxBuffer(socket, ntohl(header->seqNum), buffer,
-            queueItem->length);
-         //Any error to report?
-         if(error)
-            break;
+      //Retransmit the data
+      error = tcpRetransmitData(socket, flags, seqNum, n);
 
-         //Total number of segments retransmitted
-         MIB2_TCP_INC_COUNTER32(tcpRetransSegs, 1);
-         TCP_MIB_INC_COUNTER32(tcpRetransSegs, 1);
+      //Advance data pointer
+      seqNum += n;
+      length -= n;
 
-         //Dump TCP header contents for debugging purpose
-         tcpDumpHeader(header, queueItem->length, socket->iss, socket->irs);
+      //Loop until all the data has been retransmitted
+   } while(!error && length > 0);
 
-         //Additional options can be passed to the stack along with the packet
-         ancillary = NET_DEFAULT_TX_ANCILLARY;
-         //Set the TTL value to be used
-         ancillary.ttl = socket->ttl;
+   //Return status code
+   return error;
+}
 
-#if (ETH_VLAN_SUPPORT == ENABLED)
-         //Set VLAN PCP and DEI fields
-         ancillary.vlanPcp = socket->vlanPcp;
-         ancillary.vlanDei = socket->vlanDei;
-#endif
 
-#if (ETH_VMAN_SUPPORT == ENABLED)
-         //Set VMAN PCP and DEI fields
-         ancillary.vmanPcp = socket->vmanPcp;
-         ancillary.vmanDei = socket->vmanDei;
-#endif
-         //Retransmit the lost segment without waiting for the retransmission
-         //timer to expire
-         error = ipSendDatagram(socket->interface, &queueItem->pseudoHeader,
-            buffer, offset, &ancillary);
+/**
+ * @brief Retransmit data from the send buffer
+ *
+ * The TCP header is regenerated from the current state of the connection,
+ * hence the retransmitted segment carries up-to-date acknowledgment number
+ * and window fields
+ *
+ * @param[in] socket Handle referencing the socket
+ * @param[in] flags Value that contains bitwise OR of flags (see #TcpFlags enumeration)
+ * @param[in] seqNum Sequence number of the first data byte
+ * @param[in] length Number of data bytes to retransmit
+ * @return Error code
+ **/
 
-         //End of exception handling block
-      } while(0);
+error_t tcpRetransmitData(Socket *socket, uint8_t flags, uint32_t seqNum,
+   size_t length)
+{
+   error_t error;
+   size_t offset;
+   NetBuffer *buffer;
+   IpPseudoHeader pseudoHeader;
+   NetTxAncillary ancillary;
 
-      //Free previously allocated memory
-      netBufferFree(buffer);
+   //Allocate a memory buffer to hold the TCP segment
+   buffer = ipAllocBuffer(TCP_MAX_HEADER_LENGTH, &offset);
+   //Failed to allocate memory?
+   if(buffer == NULL)
+      return ERROR_OUT_OF_MEMORY;
 
-      //Any error to report?
-      if(error)
-      {
-         //Exit immediately
-         break;
-      }
+   //Format TCP segment
+   error = tcpFormatSegment(socket, flags, seqNum, socket->rcvNxt, length,
+      buffer, offset, &pseudoHeader);
 
-      //Point to the next segment in the queue
-      queueItem = queueItem->next;
+   //Check status code
+   if(!error)
+   {
+      //Total number of segments retransmitted
+      MIB2_TCP_INC_COUNTER32(tcpRetransSegs, 1);
+      TCP_MIB_INC_COUNTER32(tcpRetransSegs, 1);
+
+      //Dump TCP header contents for debugging purpose
+      tcpDumpHeader(netBufferAt(buffer, offset), length, socket->iss,
+         socket->irs);
+
+      //Additional options can be passed to the stack along with the packet
+      ancillary = NET_DEFAULT_TX_ANCILLARY;
+      //Set the TTL value to be used
+      ancillary.ttl = socket->ttl;
+      //Set ToS field
+      ancillary.tos = socket->tos;
+
+#if (ETH_VLAN_SUPPORT == ENABLED)
+      //Set VLAN PCP and DEI fields
+      ancillary.vlanPcp = socket->vlanPcp;
+      ancillary.vlanDei = socket->vlanDei;
+#endif
+
+#if (ETH_VMAN_SUPPORT == ENABLED)
+      //Set VMAN PCP and DEI fields
+      ancillary.vmanPcp = socket->vmanPcp;
+      ancillary.vmanDei = socket->vmanDei;
+#endif
+      //Retransmit the lost segment without waiting for the retransmission
+      //timer to expire
+      error = ipSendDatagram(socket->interface, &pseudoHeader, buffer,
+         offset, &ancillary);
    }
 
+   //Free previously allocated memory
+   netBufferFree(buffer);
+
    //Return status code
    return error;
 }
@@ -1892,6 +3635,21 @@ error_t tcpNagleAlgo(Socket *socket, uint_t flags)
       n = MIN(u, socket->sndUser);
       n = MIN(n, socket->smss);
 
+#if (NET_GSO_SUPPORT == ENABLED)
+      //Several full-sized segments can be passed down the stack as a single
+      //super-segment when the interface supports segmentation offload
+      if(n == socket->smss && netGsoCheckInterface(socket->interface))
+      {
+         //Limit the size of the super-segment
+         n = MIN(u, socket->sndUser);
+         n = MIN(n, NET_GSO_MAX_SIZE);
+
+         //The super-segment is made up of full-sized segments only
+         n -= n % socket->smss;
+         n = MAX(n, socket->smss);
+      }
+#endif
+
       //Disable Nagle algorithm?
       if((flags & SOCKET_FLAG_NO_DELAY) != 0)
       {
@@ -2065,7 +3823,14 @@ void tcpUpdateEvents(Socket *socket)
       //Check whether the send buffer is full or not
       if((socket->sndUser + socket->sndNxt - socket->sndUna) < socket->txBufferSize)
       {
-         socket->eventFlags |= SOCKET_EVENT_TX_READY;
+#if (SOCKET_ZERO_COPY_TX_SUPPORT == ENABLED)
+         //Zero-copy transmission also requires a free entry in the list of
+         //caller-owned regions
+         if(socket->txRefCount < TCP_MAX_TX_REF_COUNT)
+#endif
+         {
+            socket->eventFlags |= SOCKET_EVENT_TX_READY;
+         }
       }
 
       //Check whether all the data in the send buffer has been transmitted
@@ -2132,6 +3897,11 @@ void tcpUpdateEvents(Socket *socket)
       }
    }
 
+#if (SOCKET_EPOLL_SUPPORT == ENABLED)
+   //Notify the epoll instance, if any, before unused events are masked
+   socketEpollNotify(socket, socket->eventFlags);
+#endif
+
    //Mask unused events
    socket->eventFlags &= socket->eventMask;
 
@@ -2199,9 +3969,61 @@ uint_t tcpWaitForEvents(Socket *socket, uint_t eventMask, systime_t timeout)
 void tcpWriteTxBuffer(Socket *socket, uint32_t seqNum,
    const uint8_t *data, size_t length)
 {
+#if (TCP_TX_CHECKSUM_CACHE_SUPPORT == ENABLED)
+   uint_t i;
+   size_t n;
+   uint16_t checksum;
+   uint32_t temp;
+#endif
+
    //Offset of the first byte to write in the circular buffer
    size_t offset = (seqNum - socket->iss - 1) % socket->txBufferSize;
 
+#if (TCP_TX_CHECKSUM_CACHE_SUPPORT == ENABLED)
+   //Copy the payload region by region
+   while(length > 0)
+   {
+      //Index of the region the current byte belongs to
+      i = offset / TCP_TX_CHECKSUM_BLOCK_SIZE;
+
+      //Do not cross region or buffer boundaries
+      n = TCP_TX_CHECKSUM_BLOCK_SIZE - (offset % TCP_TX_CHECKSUM_BLOCK_SIZE);
+      n = MIN(n, socket->txBufferSize - offset);
+      n = MIN(n, length);
+
+      //Copy the data and calculate their checksum in a single pass
+      netBufferWriteCsum((NetBuffer *) &socket->txBuffer, offset, data, n,
+         &checksum);
+
+      //Retrieve the sum of the data
+      temp = checksum ^ 0xFFFF;
+
+      //Take care of alignment issues
+      if((offset & 1) != 0)
+      {
+         //Swap checksum value
+         temp = ((temp >> 8) | (temp << 8)) & 0xFFFF;
+      }
+
+      //The send buffer is filled sequentially. The partial sum is reset
+      //whenever the first byte of the region is overwritten
+      if((offset % TCP_TX_CHECKSUM_BLOCK_SIZE) != 0)
+      {
+         temp += socket->txBufferChecksum[i];
+         temp = (temp & 0xFFFF) + (temp >> 16);
+      }
+
+      //Save the partial sum of the region
+      socket->txBufferChecksum[i] = (uint16_t) temp;
+
+      //Advance data pointer
+      data += n;
+      length -= n;
+
+      //Wrap around to the beginning of the circular buffer if necessary
+      offset = (offset + n) % socket->txBufferSize;
+   }
+#else
    //Check whether the specified data crosses buffer boundaries
    if((offset + length) <= socket->txBufferSize)
    {
@@ -2220,6 +4042,7 @@ void tcpWriteTxBuffer(Socket *socket, uint32_t seqNum,
          data + socket->txBufferSize - offset,
          length - socket->txBufferSize + offset);
    }
+#endif
 }
 
 
@@ -2236,30 +4059,84 @@ error_t tcpReadTxBuffer(Socket *socket, uint32_t seqNum,
    NetBuffer *buffer, size_t length)
 {
    error_t error;
+   size_t n;
+   size_t offset;
+#if (SOCKET_ZERO_COPY_TX_SUPPORT == ENABLED)
+   uint_t i;
+   TcpTxRef *ref;
+#endif
 
-   //Offset of the first byte to read in the circular buffer
-   size_t offset = (seqNum - socket->iss - 1) % socket->txBufferSize;
+   //Initialize status code
+   error = NO_ERROR;
 
-   //Check whether the specified data crosses buffer boundaries
-   if((offset + length) <= socket->txBufferSize)
-   {
-      //Copy the payload
-      error = netBufferConcat(buffer, (NetBuffer *) &socket->txBuffer,
-         offset, length);
-   }
-   else
+   //Process the specified range piece by piece
+   while(length > 0 && !error)
    {
-      //Copy the first part of the payload
-      error = netBufferConcat(buffer, (NetBuffer *) &socket->txBuffer,
-         offset, socket->txBufferSize - offset);
+      //Number of bytes to read at a time
+      n = length;
 
-      //Check status code
-      if(!error)
+#if (SOCKET_ZERO_COPY_TX_SUPPORT == ENABLED)
+      //Loop through the caller-owned regions
+      for(i = 0; i < socket->txRefCount; i++)
+      {
+         //Point to the current region
+         ref = &socket->txRef[i];
+
+         //The data at the specified position are held by the application?
+         if(TCP_CMP_SEQ(seqNum, ref->seqNum) >= 0 &&
+            TCP_CMP_SEQ(seqNum, ref->seqNum + ref->length) < 0)
+         {
+            break;
+         }
+
+         //Stop reading the send buffer at the beginning of the region
+         if(TCP_CMP_SEQ(ref->seqNum, seqNum) > 0)
+         {
+            n = MIN(n, ref->seqNum - seqNum);
+         }
+      }
+
+      //Caller-owned data?
+      if(i < socket->txRefCount)
+      {
+         //Do not cross region boundaries
+         n = MIN(length, ref->seqNum + ref->length - seqNum);
+
+         //Reference the data rather than copying them
+         error = netBufferAppend(buffer, ref->data + (seqNum - ref->seqNum), n);
+      }
+      else
+#endif
       {
-         //Wrap around to the beginning of the circular buffer
-         error = netBufferConcat(buffer, (NetBuffer *) &socket->txBuffer,
-            0, length - socket->txBufferSize + offset);
+         //Offset of the first byte to read in the circular buffer
+         offset = (seqNum - socket->iss - 1) % socket->txBufferSize;
+
+         //Check whether the specified data crosses buffer boundaries
+         if((offset + n) <= socket->txBufferSize)
+         {
+            //Copy the payload
+            error = netBufferConcat(buffer, (NetBuffer *) &socket->txBuffer,
+               offset, n);
+         }
+         else
+         {
+            //Copy the first part of the payload
+            error = netBufferConcat(buffer, (NetBuffer *) &socket->txBuffer,
+               offset, socket->txBufferSize - offset);
+
+            //Check status code
+            if(!error)
+            {
+               //Wrap around to the beginning of the circular buffer
+               error = netBufferConcat(buffer, (NetBuffer *) &socket->txBuffer,
+                  0, n - socket->txBufferSize + offset);
+            }
+         }
       }
+
+      //Next piece
+      seqNum += n;
+      length -= n;
    }
 
    //Return status code
@@ -2267,6 +4144,88 @@ error_t tcpReadTxBuffer(Socket *socket, uint32_t seqNum,
 }
 
 
+#if (TCP_TX_CHECKSUM_CACHE_SUPPORT == ENABLED)
+
+/**
+ * @brief Calculate the checksum of data held in the send buffer
+ *
+ * Regions that are entirely covered use the partial sums computed when the
+ * data were written. Only the edges of the range are read again
+ *
+ * @param[in] socket Handle referencing the socket
+ * @param[in] seqNum Sequence number of the first data byte
+ * @param[in] length Number of data bytes
+ * @return Checksum value
+ **/
+
+uint16_t tcpCalcTxBufferChecksum(Socket *socket, uint32_t seqNum,
+   size_t length)
+{
+   uint_t i;
+   size_t n;
+   size_t pos;
+   size_t offset;
+   uint32_t temp;
+   uint32_t checksum;
+
+   //Checksum preset value
+   checksum = 0x0000;
+   //Current position in the range
+   pos = 0;
+
+   //Offset of the first byte to read in the circular buffer
+   offset = (seqNum - socket->iss - 1) % socket->txBufferSize;
+
+   //Process the range region by region
+   while(pos < length)
+   {
+      //Index of the region the current byte belongs to
+      i = offset / TCP_TX_CHECKSUM_BLOCK_SIZE;
+
+      //Do not cross region or buffer boundaries
+      n = TCP_TX_CHECKSUM_BLOCK_SIZE - (offset % TCP_TX_CHECKSUM_BLOCK_SIZE);
+      n = MIN(n, socket->txBufferSize - offset);
+      n = MIN(n, length - pos);
+
+      //Whole region?
+      if((offset % TCP_TX_CHECKSUM_BLOCK_SIZE) == 0 &&
+         (n == TCP_TX_CHECKSUM_BLOCK_SIZE || (offset + n) == socket->txBufferSize))
+      {
+         //Use the cached partial sum
+         temp = socket->txBufferChecksum[i];
+      }
+      else
+      {
+         //Sum the data
+         temp = ipCalcChecksumEx((NetBuffer *) &socket->txBuffer, offset, n) ^
+            0xFFFF;
+      }
+
+      //Take care of alignment issues
+      if((pos & 1) != 0)
+      {
+         //Swap checksum value
+         temp = ((temp >> 8) | (temp << 8)) & 0xFFFF;
+      }
+
+      //Update checksum value
+      checksum += temp;
+      //Fold 32-bit sum to 16 bits
+      checksum = (checksum & 0xFFFF) + (checksum >> 16);
+
+      //Advance current position
+      pos += n;
+      //Wrap around to the beginning of the circular buffer if necessary
+      offset = (offset + n) % socket->txBufferSize;
+   }
+
+   //Return 1's complement value
+   return (uint16_t) (checksum ^ 0xFFFF);
+}
+
+#endif
+
+
 /**
  * @brief Copy incoming data to the receive buffer
  * @param[in] socket Handle referencing the socket
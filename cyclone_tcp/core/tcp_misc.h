@@ -36,15 +36,26 @@
 extern "C" {
 #endif
 
+//NewReno congestion control algorithm
+extern const TcpCongestAlgo tcpNewRenoAlgo;
+
 //TCP related functions
 error_t tcpSendSegment(Socket *socket, uint8_t flags, uint32_t seqNum,
    uint32_t ackNum, size_t length, bool_t addToQueue);
 
+error_t tcpFormatSegment(Socket *socket, uint8_t flags, uint32_t seqNum,
+   uint32_t ackNum, size_t length, NetBuffer *buffer, size_t offset,
+   IpPseudoHeader *pseudoHeader);
+
 error_t tcpSendResetSegment(Socket *socket, uint32_t seqNum);
 
 error_t tcpRejectSegment(NetInterface *interface,
    const IpPseudoHeader *pseudoHeader, const TcpHeader *segment, size_t length);
 
+error_t tcpSendStatelessSegment(NetInterface *interface,
+   const IpPseudoHeader *pseudoHeader, const TcpHeader *segment, uint8_t flags,
+   uint32_t seqNum, uint32_t ackNum, uint16_t window, uint16_t mss);
+
 error_t tcpAddOption(TcpHeader *segment, uint8_t kind, const void *value,
    uint8_t length);
 
@@ -57,6 +68,9 @@ error_t tcpCheckSeqNum(Socket *socket, const TcpHeader *segment, size_t length);
 error_t tcpCheckSyn(Socket *socket, const TcpHeader *segment, size_t length);
 error_t tcpCheckAck(Socket *socket, const TcpHeader *segment, size_t length);
 
+TcpSynQueueItem *tcpFindSynQueueItem(Socket *socket,
+   const IpPseudoHeader *pseudoHeader, const TcpHeader *segment);
+
 bool_t tcpIsDuplicateSyn(Socket *socket, const IpPseudoHeader *pseudoHeader,
    const TcpHeader *segment);
 
@@ -67,22 +81,68 @@ void tcpFastRetransmit(Socket *socket);
 void tcpFastRecovery(Socket *socket, const TcpHeader *segment, uint_t n);
 void tcpFastLossRecovery(Socket *socket, const TcpHeader *segment);
 
+bool_t tcpUpdateSackScoreboard(Socket *socket, const TcpHeader *segment);
+void tcpResetSackScoreboard(Socket *socket);
+bool_t tcpIsSegmentLost(Socket *socket, uint_t index);
+uint_t tcpComputePipe(Socket *socket);
+TcpQueueItem *tcpGetNextSegment(Socket *socket, bool_t lost);
+void tcpSackLossRecovery(Socket *socket);
+
+const TcpCongestAlgo *tcpGetCongestAlgo(const char_t *name);
+
+void tcpNewRenoOnAck(Socket *socket, uint_t n, bool_t updateFlag);
+void tcpNewRenoOnLoss(Socket *socket);
+void tcpNewRenoOnRto(Socket *socket);
+void tcpNewRenoCwndEvent(Socket *socket, TcpCongestEvent event);
+
 void tcpProcessSegmentData(Socket *socket, const TcpHeader *segment,
    const NetBuffer *buffer, size_t offset, size_t length);
 
 void tcpDeleteControlBlock(Socket *socket);
 
+error_t tcpAddRetransmitQueueItem(Socket *socket, uint8_t flags,
+   uint32_t seqNum, size_t length);
+
+uint_t tcpFindRetransmitQueueItem(Socket *socket, uint32_t seqNum);
 void tcpUpdateRetransmitQueue(Socket *socket);
 void tcpFlushRetransmitQueue(Socket *socket);
 
 void tcpFlushSynQueue(Socket *socket);
 
+TcpSynQueueItem *tcpCreateSynQueueItem(NetInterface *interface,
+   const IpPseudoHeader *pseudoHeader, const TcpHeader *segment);
+
+void tcpAddSynQueueItem(Socket *socket, TcpSynQueueItem *queueItem);
+void tcpRemoveSynQueueItem(Socket *socket);
+
+uint_t tcpHashSynQueueKey(const IpAddr *srcAddr, uint16_t srcPort);
+
+uint32_t tcpGenerateSynCookie(const IpPseudoHeader *pseudoHeader,
+   const TcpHeader *segment, uint32_t isn, uint_t counter, uint_t mssIndex);
+
+error_t tcpSendSynCookie(Socket *socket, NetInterface *interface,
+   const IpPseudoHeader *pseudoHeader, const TcpHeader *segment, uint16_t mss);
+
+error_t tcpProcessSynCookie(Socket *socket, NetInterface *interface,
+   const IpPseudoHeader *pseudoHeader, const TcpHeader *segment);
+
+void tcpUpdateTxRefs(Socket *socket);
+void tcpFlushTxRefs(Socket *socket);
+
 void tcpUpdateSackBlocks(Socket *socket, uint32_t *leftEdge, uint32_t *rightEdge);
 void tcpUpdateSendWindow(Socket *socket, const TcpHeader *segment);
 void tcpUpdateReceiveWindow(Socket *socket);
 
+void tcpAutotuneTxBuffer(Socket *socket);
+void tcpAutotuneRxBuffer(Socket *socket);
+
 bool_t tcpComputeRto(Socket *socket);
 error_t tcpRetransmitSegment(Socket *socket);
+error_t tcpRetransmitQueueItem(Socket *socket, const TcpQueueItem *queueItem);
+
+error_t tcpRetransmitData(Socket *socket, uint8_t flags, uint32_t seqNum,
+   size_t length);
+
 error_t tcpNagleAlgo(Socket *socket, uint_t flags);
 
 void tcpChangeState(Socket *socket, TcpState newState);
@@ -96,6 +156,9 @@ void tcpWriteTxBuffer(Socket *socket, uint32_t seqNum,
 error_t tcpReadTxBuffer(Socket *socket, uint32_t seqNum,
    NetBuffer *buffer, size_t length);
 
+uint16_t tcpCalcTxBufferChecksum(Socket *socket, uint32_t seqNum,
+   size_t length);
+
 void tcpWriteRxBuffer(Socket *socket, uint32_t seqNum,
    const NetBuffer *data, size_t dataOffset, size_t length);
 
@@ -0,0 +1,440 @@
+/**
+ * @file tcp_time_wait.c
+ * @brief Compact records for TCP connections in the TIME-WAIT state
+ *
+ * @section License
+ *
+ * Copyright (C) 2010-2023 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneTCP Eval.
+ *
+ * This software is provided in source form for a short-term evaluation only. The
+ * evaluation license expires 90 days after the date you first download the software.
+ *
+ * If you plan to use this software in a commercial product, you are required to
+ * purchase a commercial license from Oryx Embedded SARL.
+ *
+ * After the 90-day evaluation period, you agree to either purchase a commercial
+ * license or delete all copies of this software. If you wish to extend the
+ * evaluation period, you must contact sales@oryx-embedded.com.
+ *
+ * This evaluation software is provided "as is" without warranty of any kind.
+ * Technical support is available as an option during the evaluation period.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.3.2
+ **/
+
+//Switch to the appropriate trace level
+#define TRACE_LEVEL TCP_TRACE_LEVEL
+
+//Dependencies
+#include "core/net.h"
+#include "core/socket.h"
+#include "core/tcp.h"
+#include "core/tcp_misc.h"
+#include "core/tcp_time_wait.h"
+#include "debug.h"
+
+//Check TCP/IP stack configuration
+#if (TCP_SUPPORT == ENABLED && TCP_TIME_WAIT_TABLE_SUPPORT == ENABLED && \
+   TCP_2MSL_TIMER > 0)
+
+//TIME-WAIT records
+static TcpTimeWaitEntry tcpTimeWaitTable[TCP_TIME_WAIT_TABLE_SIZE];
+//Hash table indexing the TIME-WAIT records
+static TcpTimeWaitEntry *tcpTimeWaitHashTable[TCP_TIME_WAIT_HASH_SIZE];
+
+
+/**
+ * @brief Initialize the TIME-WAIT records
+ **/
+
+void tcpInitTimeWaitTable(void)
+{
+   //Clear TIME-WAIT records
+   osMemset(tcpTimeWaitTable, 0, sizeof(tcpTimeWaitTable));
+   osMemset(tcpTimeWaitHashTable, 0, sizeof(tcpTimeWaitHashTable));
+}
+
+
+/**
+ * @brief Move a connection in the TIME-WAIT state to a compact record
+ *
+ * The connection identifiers, the sequence numbers and the 2MSL timer are
+ * saved in a TIME-WAIT record, so that the socket can be released right away.
+ * When the table is full, the record closest to expiry is reused
+ *
+ * @param[in] socket Handle referencing the socket
+ * @return Error code
+ **/
+
+error_t tcpCreateTimeWaitEntry(Socket *socket)
+{
+   uint_t i;
+   systime_t time;
+   TcpTimeWaitEntry *entry;
+
+   //Check current TCP state
+   if(socket->state != TCP_STATE_TIME_WAIT)
+      return ERROR_WRONG_STATE;
+
+   //Check whether the same connection is already tracked
+   entry = tcpFindTimeWaitEntry(socket->interface, &socket->localIpAddr,
+      socket->localPort, &socket->remoteIpAddr, socket->remotePort);
+
+   //Any matching record?
+   if(entry != NULL)
+   {
+      //Discard the stale record
+      tcpDeleteTimeWaitEntry(entry);
+   }
+
+   //Get current time
+   time = osGetSystemTime();
+
+   //Keep track of the record closest to expiry. A retransmitted FIN restarts
+   //the 2MSL timer, so this is not necessarily the oldest record
+   entry = &tcpTimeWaitTable[0];
+
+   //Loop through the TIME-WAIT records
+   for(i = 0; i < TCP_TIME_WAIT_TABLE_SIZE; i++)
+   {
+      //Free record?
+      if(!tcpTimeWaitTable[i].valid)
+      {
+         entry = &tcpTimeWaitTable[i];
+         break;
+      }
+
+      //2MSL timer expired?
+      if(timeCompare(time, tcpTimeWaitTable[i].timestamp + TCP_2MSL_TIMER) >= 0)
+      {
+         entry = &tcpTimeWaitTable[i];
+         break;
+      }
+
+      //Keep track of the record whose 2MSL timer was started first
+      if(timeCompare(tcpTimeWaitTable[i].timestamp, entry->timestamp) < 0)
+      {
+         entry = &tcpTimeWaitTable[i];
+      }
+   }
+
+   //Reuse the selected record if the table runs out of space
+   if(entry->valid)
+   {
+      tcpDeleteTimeWaitEntry(entry);
+   }
+
+   //Save the connection identifiers
+   entry->interface = socket->interface;
+   entry->localIpAddr = socket->localIpAddr;
+   entry->localPort = socket->localPort;
+   entry->remoteIpAddr = socket->remoteIpAddr;
+   entry->remotePort = socket->remotePort;
+
+   //Save the sequence numbers needed to acknowledge a retransmitted FIN
+   entry->sndNxt = socket->sndNxt;
+   entry->rcvNxt = socket->rcvNxt;
+   entry->rcvWnd = socket->rcvWnd;
+
+   //The 2MSL timer keeps running
+   entry->timestamp = socket->timeWaitTimer.startTime;
+
+   //Insert the record in the hash table
+   i = tcpHashTimeWaitKey(&entry->remoteIpAddr, entry->remotePort,
+      entry->localPort);
+
+   entry->next = tcpTimeWaitHashTable[i];
+   tcpTimeWaitHashTable[i] = entry;
+
+   //The record is now valid
+   entry->valid = TRUE;
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Delete a TIME-WAIT record
+ * @param[in] entry Pointer to the record
+ **/
+
+void tcpDeleteTimeWaitEntry(TcpTimeWaitEntry *entry)
+{
+   TcpTimeWaitEntry **p;
+
+   //Remove the record from its hash bucket
+   for(p = &tcpTimeWaitHashTable[tcpHashTimeWaitKey(&entry->remoteIpAddr,
+      entry->remotePort, entry->localPort)]; *p != NULL; p = &(*p)->next)
+   {
+      //Matching record?
+      if(*p == entry)
+      {
+         *p = entry->next;
+         break;
+      }
+   }
+
+   //The record is now free
+   entry->next = NULL;
+   entry->valid = FALSE;
+}
+
+
+/**
+ * @brief Search the TIME-WAIT records for a given connection
+ * @param[in] interface Underlying network interface
+ * @param[in] localIpAddr Local IP address
+ * @param[in] localPort Local port number
+ * @param[in] remoteIpAddr Remote IP address
+ * @param[in] remotePort Remote port number
+ * @return Pointer to the matching record, if any
+ **/
+
+TcpTimeWaitEntry *tcpFindTimeWaitEntry(NetInterface *interface,
+   const IpAddr *localIpAddr, uint16_t localPort, const IpAddr *remoteIpAddr,
+   uint16_t remotePort)
+{
+   systime_t time;
+   TcpTimeWaitEntry *entry;
+   TcpTimeWaitEntry *next;
+
+   //Get current time
+   time = osGetSystemTime();
+
+   //Point to the first record of the corresponding hash bucket
+   entry = tcpTimeWaitHashTable[tcpHashTimeWaitKey(remoteIpAddr, remotePort,
+      localPort)];
+
+   //Loop through the hash bucket
+   while(entry != NULL)
+   {
+      //Save the next record
+      next = entry->next;
+
+      //2MSL timer expired?
+      if(timeCompare(time, entry->timestamp + TCP_2MSL_TIMER) >= 0)
+      {
+         //Expired records are released on the fly
+         tcpDeleteTimeWaitEntry(entry);
+      }
+      else if(entry->localPort == localPort &&
+         entry->remotePort == remotePort &&
+         ipCompAddr(&entry->localIpAddr, localIpAddr) &&
+         ipCompAddr(&entry->remoteIpAddr, remoteIpAddr))
+      {
+         //Check whether the connection is bound to a particular interface
+         if(entry->interface == NULL || interface == NULL ||
+            entry->interface == interface)
+         {
+            //A matching record has been found
+            return entry;
+         }
+      }
+
+      //Next record in the same hash bucket
+      entry = next;
+   }
+
+   //No matching record
+   return NULL;
+}
+
+
+/**
+ * @brief Process an incoming segment that matches a TIME-WAIT record
+ *
+ * The processing mirrors the TIME-WAIT state of the TCP FSM: a retransmitted
+ * FIN is acknowledged and restarts the 2MSL timer, unacceptable segments are
+ * acknowledged and in-window SYNs are answered with a reset
+ *
+ * @param[in] interface Underlying network interface
+ * @param[in] pseudoHeader TCP pseudo header
+ * @param[in] segment Incoming TCP segment
+ * @param[in] length Length of the segment data
+ * @return TRUE if the segment matches a TIME-WAIT record, else FALSE
+ **/
+
+bool_t tcpProcessTimeWaitSegment(NetInterface *interface,
+   const IpPseudoHeader *pseudoHeader, const TcpHeader *segment, size_t length)
+{
+   bool_t acceptable;
+   IpAddr srcIpAddr;
+   IpAddr destIpAddr;
+   TcpTimeWaitEntry *entry;
+
+#if (IPV4_SUPPORT == ENABLED)
+   //IPv4 segment?
+   if(pseudoHeader->length == sizeof(Ipv4PseudoHeader))
+   {
+      //Retrieve the source and destination IPv4 addresses
+      srcIpAddr.length = sizeof(Ipv4Addr);
+      srcIpAddr.ipv4Addr = pseudoHeader->ipv4Data.srcAddr;
+      destIpAddr.length = sizeof(Ipv4Addr);
+      destIpAddr.ipv4Addr = pseudoHeader->ipv4Data.destAddr;
+   }
+   else
+#endif
+#if (IPV6_SUPPORT == ENABLED)
+   //IPv6 segment?
+   if(pseudoHeader->length == sizeof(Ipv6PseudoHeader))
+   {
+      //Retrieve the source and destination IPv6 addresses
+      srcIpAddr.length = sizeof(Ipv6Addr);
+      srcIpAddr.ipv6Addr = pseudoHeader->ipv6Data.srcAddr;
+      destIpAddr.length = sizeof(Ipv6Addr);
+      destIpAddr.ipv6Addr = pseudoHeader->ipv6Data.destAddr;
+   }
+   else
+#endif
+   //Invalid pseudo header?
+   {
+      //This should never occur...
+      return FALSE;
+   }
+
+   //Search the TIME-WAIT records
+   entry = tcpFindTimeWaitEntry(interface, &destIpAddr, segment->destPort,
+      &srcIpAddr, segment->srcPort);
+   //No matching record?
+   if(entry == NULL)
+      return FALSE;
+
+   //Debug message
+   TRACE_DEBUG("TCP FSM: TIME-WAIT state (compact record)\r\n");
+
+   //Ignore RST segments in TIME-WAIT state (refer to RFC 1337, section 3)
+   if((segment->flags & TCP_FLAG_RST) != 0)
+      return TRUE;
+
+   //Check the sequence number (refer to RFC 793, section 3.3)
+   if(length == 0 && entry->rcvWnd == 0)
+   {
+      acceptable = (segment->seqNum == entry->rcvNxt) ? TRUE : FALSE;
+   }
+   else if(entry->rcvWnd == 0)
+   {
+      acceptable = FALSE;
+   }
+   else if(TCP_CMP_SEQ(segment->seqNum, entry->rcvNxt) >= 0 &&
+      TCP_CMP_SEQ(segment->seqNum, entry->rcvNxt + entry->rcvWnd) < 0)
+   {
+      acceptable = TRUE;
+   }
+   else if(length > 0 &&
+      TCP_CMP_SEQ(segment->seqNum + length - 1, entry->rcvNxt) >= 0 &&
+      TCP_CMP_SEQ(segment->seqNum + length - 1, entry->rcvNxt + entry->rcvWnd) < 0)
+   {
+      acceptable = TRUE;
+   }
+   else
+   {
+      acceptable = FALSE;
+   }
+
+   //Non acceptable sequence number?
+   if(!acceptable)
+   {
+      //If an incoming segment is not acceptable, an acknowledgment should
+      //be sent in reply
+      tcpSendStatelessSegment(interface, pseudoHeader, segment, TCP_FLAG_ACK,
+         entry->sndNxt, entry->rcvNxt, entry->rcvWnd, 0);
+
+      //Drop the segment
+      return TRUE;
+   }
+
+   //Check the SYN bit
+   if((segment->flags & TCP_FLAG_SYN) != 0)
+   {
+      //If this step is reached, the SYN is in the window. It is an error
+      //and a reset shall be sent in response
+      if((segment->flags & TCP_FLAG_ACK) != 0)
+      {
+         tcpSendStatelessSegment(interface, pseudoHeader, segment,
+            TCP_FLAG_RST, segment->ackNum, 0, 0, 0);
+      }
+      else
+      {
+         tcpSendStatelessSegment(interface, pseudoHeader, segment,
+            TCP_FLAG_RST | TCP_FLAG_ACK, 0, segment->seqNum + length + 1, 0, 0);
+      }
+
+      //Drop the segment
+      return TRUE;
+   }
+
+   //If the ACK bit is off drop the segment and return
+   if((segment->flags & TCP_FLAG_ACK) == 0)
+      return TRUE;
+
+   //The only thing that can arrive in this state is a retransmission of the
+   //remote FIN. Acknowledge it and restart the 2 MSL timeout
+   if((segment->flags & TCP_FLAG_FIN) != 0)
+   {
+      //Send an acknowledgment for the FIN
+      tcpSendStatelessSegment(interface, pseudoHeader, segment, TCP_FLAG_ACK,
+         entry->sndNxt, entry->rcvNxt, entry->rcvWnd, 0);
+
+      //Restart the 2MSL timer
+      entry->timestamp = osGetSystemTime();
+   }
+
+   //The segment has been processed
+   return TRUE;
+}
+
+
+/**
+ * @brief Compute the hash bucket of a TIME-WAIT record
+ * @param[in] remoteIpAddr Remote IP address
+ * @param[in] remotePort Remote port number
+ * @param[in] localPort Local port number
+ * @return Index of the hash bucket
+ **/
+
+uint_t tcpHashTimeWaitKey(const IpAddr *remoteIpAddr, uint16_t remotePort,
+   uint16_t localPort)
+{
+   uint32_t h;
+
+   //The port numbers are part of the key
+   h = (((uint32_t) localPort << 16) | remotePort) * 0x9E3779B1U;
+
+#if (IPV4_SUPPORT == ENABLED)
+   //IPv4 address?
+   if(remoteIpAddr->length == sizeof(Ipv4Addr))
+   {
+      //Mix the IPv4 address
+      h ^= remoteIpAddr->ipv4Addr;
+   }
+   else
+#endif
+#if (IPV6_SUPPORT == ENABLED)
+   //IPv6 address?
+   if(remoteIpAddr->length == sizeof(Ipv6Addr))
+   {
+      //Fold the IPv6 address
+      h ^= remoteIpAddr->ipv6Addr.dw[0] ^ remoteIpAddr->ipv6Addr.dw[1] ^
+         remoteIpAddr->ipv6Addr.dw[2] ^ remoteIpAddr->ipv6Addr.dw[3];
+   }
+   else
+#endif
+   //Invalid IP address?
+   {
+      //Just for sanity
+   }
+
+   //Final avalanche
+   h ^= h >> 16;
+   h *= 0x45D9F3BU;
+   h ^= h >> 16;
+
+   //Return the index of the hash bucket
+   return h % TCP_TIME_WAIT_HASH_SIZE;
+}
+
+#endif
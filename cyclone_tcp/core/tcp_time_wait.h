@@ -0,0 +1,95 @@
+/**
+ * @file tcp_time_wait.h
+ * @brief Compact records for TCP connections in the TIME-WAIT state
+ *
+ * @section License
+ *
+ * Copyright (C) 2010-2023 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneTCP Eval.
+ *
+ * This software is provided in source form for a short-term evaluation only. The
+ * evaluation license expires 90 days after the date you first download the software.
+ *
+ * If you plan to use this software in a commercial product, you are required to
+ * purchase a commercial license from Oryx Embedded SARL.
+ *
+ * After the 90-day evaluation period, you agree to either purchase a commercial
+ * license or delete all copies of this software. If you wish to extend the
+ * evaluation period, you must contact sales@oryx-embedded.com.
+ *
+ * This evaluation software is provided "as is" without warranty of any kind.
+ * Technical support is available as an option during the evaluation period.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.3.2
+ **/
+
+#ifndef _TCP_TIME_WAIT_H
+#define _TCP_TIME_WAIT_H
+
+//Dependencies
+#include "core/tcp.h"
+
+//Maximum number of TIME-WAIT records
+#ifndef TCP_TIME_WAIT_TABLE_SIZE
+   #define TCP_TIME_WAIT_TABLE_SIZE 64
+#elif (TCP_TIME_WAIT_TABLE_SIZE < 1)
+   #error TCP_TIME_WAIT_TABLE_SIZE parameter is not valid
+#endif
+
+//Size of the hash table used to index the TIME-WAIT records
+#ifndef TCP_TIME_WAIT_HASH_SIZE
+   #define TCP_TIME_WAIT_HASH_SIZE 32
+#elif (TCP_TIME_WAIT_HASH_SIZE < 1)
+   #error TCP_TIME_WAIT_HASH_SIZE parameter is not valid
+#endif
+
+//C++ guard
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * @brief TIME-WAIT record
+ **/
+
+typedef struct _TcpTimeWaitEntry
+{
+   struct _TcpTimeWaitEntry *next; ///<Next record in the same hash bucket
+   bool_t valid;                   ///<Valid record
+   NetInterface *interface;        ///<Underlying network interface
+   IpAddr localIpAddr;             ///<Local IP address
+   uint16_t localPort;             ///<Local port number
+   IpAddr remoteIpAddr;            ///<Remote IP address
+   uint16_t remotePort;            ///<Remote port number
+   uint32_t sndNxt;                ///<Next sequence number to be sent
+   uint32_t rcvNxt;                ///<Next sequence number expected
+   uint16_t rcvWnd;                ///<Receive window
+   systime_t timestamp;            ///<Time at which the 2MSL timer was started
+} TcpTimeWaitEntry;
+
+
+//TIME-WAIT records related functions
+void tcpInitTimeWaitTable(void);
+
+error_t tcpCreateTimeWaitEntry(Socket *socket);
+void tcpDeleteTimeWaitEntry(TcpTimeWaitEntry *entry);
+
+TcpTimeWaitEntry *tcpFindTimeWaitEntry(NetInterface *interface,
+   const IpAddr *localIpAddr, uint16_t localPort, const IpAddr *remoteIpAddr,
+   uint16_t remotePort);
+
+bool_t tcpProcessTimeWaitSegment(NetInterface *interface,
+   const IpPseudoHeader *pseudoHeader, const TcpHeader *segment, size_t length);
+
+uint_t tcpHashTimeWaitKey(const IpAddr *remoteIpAddr, uint16_t remotePort,
+   uint16_t localPort);
+
+//C++ guard
+#ifdef __cplusplus
+}
+#endif
+
+#endif
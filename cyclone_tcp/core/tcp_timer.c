@@ -31,6 +31,7 @@
 //Dependencies
 #include "core/net.h"
 #include "core/socket.h"
+#include "core/socket_misc.h"
 #include "core/tcp.h"
 #include "core/tcp_misc.h"
 #include "core/tcp_timer.h"
@@ -75,6 +76,8 @@ void tcpTick(void)
             tcpCheckKeepAliveTimer(socket);
             //Check override timer
             tcpCheckOverrideTimer(socket);
+            //Check buffer idle timer
+            tcpCheckBufferIdleTimer(socket);
             //Check FIN-WAIT-2 timer
             tcpCheckFinWait2Timer(socket);
             //Check 2MSL timer
@@ -96,7 +99,7 @@ void tcpCheckRetransmitTimer(Socket *socket)
    if(socket->state != TCP_STATE_CLOSED)
    {
       //Any packet in the retransmission queue?
-      if(socket->retransmitQueue != NULL)
+      if(socket->retransmitQueueLength > 0)
       {
          //Retransmission timeout?
          if(netTimerExpired(&socket->retransmitTimer))
@@ -107,12 +110,8 @@ void tcpCheckRetransmitTimer(Socket *socket)
             //the retransmission timer, the value of ssthresh must be updated
             if(socket->retransmitCount == 0)
             {
-               uint32_t flightSize;
-
-               //Amount of data that has been sent but not yet acknowledged
-               flightSize = socket->sndNxt - socket->sndUna;
                //Adjust ssthresh value
-               socket->ssthresh = MAX(flightSize / 2, 2 * socket->smss);
+               socket->congestAlgo->onRto(socket);
             }
 
             //Furthermore, upon a timeout cwnd must be set to no more than the
@@ -126,6 +125,14 @@ void tcpCheckRetransmitTimer(Socket *socket)
 
             //Enter the fast loss recovery procedure
             socket->congestState = TCP_CONGEST_STATE_LOSS_RECOVERY;
+#endif
+#if (TCP_SACK_SUPPORT == ENABLED)
+            //After a retransmission timeout the data sender must ignore prior
+            //SACK information (refer to RFC 2018, section 8)
+            if(socket->sackPermitted)
+            {
+               tcpResetSackScoreboard(socket);
+            }
 #endif
             //Make sure the maximum number of retransmissions has not been
             //reached
@@ -135,7 +142,7 @@ void tcpCheckRetransmitTimer(Socket *socket)
                TRACE_INFO("%s: TCP segment retransmission #%u (%u data bytes)...\r\n",
                   formatSystemTime(osGetSystemTime(), NULL),
                   socket->retransmitCount + 1,
-                  socket->retransmitQueue->length);
+                  TCP_RETRANSMIT_QUEUE_ITEM(socket, 0)->length);
 
                //Retransmit the earliest segment that has not been acknowledged
                //by the TCP receiver
@@ -378,6 +385,82 @@ void tcpCheckOverrideTimer(Socket *socket)
 }
 
 
+/**
+ * @brief Check buffer idle timer
+ *
+ * Autotuned buffers are shrunk back to their default size once the connection
+ * has been idle for a long period of time. Shrinking the receive window is
+ * discouraged by RFC 1122, hence the long idle period
+ *
+ * @param[in] socket Handle referencing the socket
+ **/
+
+void tcpCheckBufferIdleTimer(Socket *socket)
+{
+#if (TCP_BUFFER_AUTOTUNE_SUPPORT == ENABLED)
+   size_t size;
+   systime_t time;
+
+   //Check current TCP state
+   if(socket->state == TCP_STATE_ESTABLISHED)
+   {
+      //Check whether buffer autotuning is enabled
+      if(socket->bufferAutotune)
+      {
+         //Get current time
+         time = osGetSystemTime();
+
+         //Idle condition?
+         if(timeCompare(time, socket->autotuneTimestamp +
+            TCP_BUFFER_AUTOTUNE_IDLE_TIME) >= 0)
+         {
+            //Default size of the send buffer
+            size = MIN(TCP_DEFAULT_TX_BUFFER_SIZE, TCP_MAX_TX_BUFFER_SIZE);
+
+            //The send buffer can only be shrunk when it is empty
+            if(socket->txBufferSize > size && socket->sndUser == 0 &&
+               socket->sndNxt == socket->sndUna)
+            {
+#if (SOCKET_ZERO_COPY_TX_SUPPORT == ENABLED)
+               //Make sure no caller-owned data is referenced
+               if(socket->txRefCount == 0)
+#endif
+               {
+                  //Release unnecessary memory
+                  netBufferSetLength((NetBuffer *) &socket->txBuffer, size);
+                  socket->txBufferSize = size;
+
+#if (TCP_CONGEST_CONTROL_SUPPORT == ENABLED)
+                  //The congestion window cannot exceed the buffer size
+                  socket->cwnd = MIN(socket->cwnd, size);
+#endif
+               }
+            }
+
+            //Default size of the receive buffer
+            size = MIN(TCP_DEFAULT_RX_BUFFER_SIZE, TCP_MAX_RX_BUFFER_SIZE);
+
+            //The receive buffer can only be shrunk when it is empty
+            if(socket->rxBufferSize > size && socket->rcvUser == 0 &&
+               socket->sackBlockCount == 0)
+            {
+               //Release unnecessary memory
+               netBufferSetLength((NetBuffer *) &socket->rxBuffer, size);
+               socket->rxBufferSize = size;
+
+               //Reduce the receive window accordingly
+               socket->rcvWnd = MIN(socket->rcvWnd, size);
+
+               //Send an ACK segment to advertise the new window size
+               tcpSendSegment(socket, TCP_FLAG_ACK, socket->sndNxt,
+                  socket->rcvNxt, 0, FALSE);
+            }
+         }
+      }
+   }
+#endif
+}
+
 /**
  * @brief Check FIN-WAIT-2 timer
  *
@@ -432,7 +515,7 @@ void tcpCheckTimeWaitTimer(Socket *socket)
             //Delete the TCB
             tcpDeleteControlBlock(socket);
             //Mark the socket as closed
-            socket->type = SOCKET_TYPE_UNUSED;
+            socketRelease(socket);
          }
       }
    }
@@ -40,6 +40,7 @@ void tcpCheckRetransmitTimer(Socket *socket);
 void tcpCheckPersistTimer(Socket *socket);
 void tcpCheckKeepAliveTimer(Socket *socket);
 void tcpCheckOverrideTimer(Socket *socket);
+void tcpCheckBufferIdleTimer(Socket *socket);
 void tcpCheckFinWait2Timer(Socket *socket);
 void tcpCheckTimeWaitTimer(Socket *socket);
 
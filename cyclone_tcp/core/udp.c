@@ -33,6 +33,7 @@
 #include "core/ip.h"
 #include "core/udp.h"
 #include "core/socket.h"
+#include "core/socket_misc.h"
 #include "ipv4/ipv4.h"
 #include "ipv4/ipv4_misc.h"
 #include "ipv6/ipv6.h"
@@ -171,6 +172,14 @@ error_t udpProcessDatagram(NetInterface *interface,
    //Convert the length field from network byte order
    length = ntohs(header->length);
 
+#if (NET_LOOPBACK_FAST_PATH_SUPPORT == ENABLED)
+   //Datagrams delivered by the loopback fast path never left memory
+   if(ancillary->loopback)
+   {
+      //The checksum does not need to be verified
+   }
+   else
+#endif
    //When UDP runs over IPv6, the checksum is mandatory
    if(header->checksum != 0x0000 ||
       pseudoHeader->length == sizeof(Ipv6PseudoHeader))
@@ -465,6 +474,11 @@ error_t udpProcessDatagram(NetInterface *interface,
    //Additional options can be passed to the stack along with the packet
    queueItem->ancillary = *ancillary;
 
+#if (NET_LATENCY_SUPPORT == ENABLED)
+   //The datagram is now available to the application
+   netLatencyProcessDelivery(interface, socket, ancillary);
+#endif
+
    //Notify user that data is available
    udpUpdateEvents(socket);
 
@@ -869,6 +883,11 @@ error_t udpReceiveDatagram(Socket *socket, SocketMsg *message, uint_t flags)
 
          //Deallocate memory buffer
          netBufferFree(queueItem->buffer);
+
+#if (NET_LATENCY_SUPPORT == ENABLED)
+         //Time elapsed since the datagram was queued
+         netLatencyProcessRead(socket);
+#endif
       }
 
       //Update the state of events
@@ -945,6 +964,11 @@ void udpUpdateEvents(Socket *socket)
       }
    }
 
+#if (SOCKET_EPOLL_SUPPORT == ENABLED)
+   //Notify the epoll instance, if any, before unused events are masked
+   socketEpollNotify(socket, socket->eventFlags);
+#endif
+
    //Mask unused events
    socket->eventFlags &= socket->eventMask;
 
@@ -78,6 +78,11 @@ void dhcpServerGetDefaultSettings(DhcpServerSettings *settings)
    settings->addOptionsCallback = NULL;
    //Parse DHCP options callback
    settings->parseOptionsCallback = NULL;
+
+#if (DHCP_SERVER_LEASE_PERSISTENCE_SUPPORT == ENABLED)
+   //The committed leases are not saved
+   settings->leaseFileName = NULL;
+#endif
 }
 
 
@@ -104,6 +109,16 @@ error_t dhcpServerInit(DhcpServerContext *context,
    if(settings->interface == NULL)
       return ERROR_INVALID_PARAMETER;
 
+#if (DHCP_SERVER_HASH_SUPPORT == ENABLED)
+   //The pool of addresses must fit in the free-address bitmap
+   if(ntohl(settings->ipAddrRangeMax) < ntohl(settings->ipAddrRangeMin) ||
+      (ntohl(settings->ipAddrRangeMax) - ntohl(settings->ipAddrRangeMin)) >=
+      DHCP_SERVER_MAX_POOL_SIZE)
+   {
+      return ERROR_INVALID_PARAMETER;
+   }
+#endif
+
    //Get exclusive access
    osAcquireMutex(&netMutex);
 
@@ -115,6 +130,9 @@ error_t dhcpServerInit(DhcpServerContext *context,
    //Save user settings
    context->settings = *settings;
 
+   //Initialize the list of bindings
+   dhcpServerInitBindings(context);
+
    //Next IP address that will be assigned by the DHCP server
    context->nextIpAddr = settings->ipAddrRangeMin;
    //DHCP server is currently suspended
@@ -158,6 +176,11 @@ error_t dhcpServerStart(DhcpServerContext *context)
    //Check the operational state of the DHCP client
    if(!context->running)
    {
+#if (DHCP_SERVER_LEASE_PERSISTENCE_SUPPORT == ENABLED)
+      //Restore the leases that were committed before the server was stopped
+      dhcpServerLoadLeases(context);
+#endif
+
       //Register the callback function to be called whenever a UDP datagram
       //is received on port 67
       error = udpAttachRxCallback(interface, DHCP_SERVER_PORT,
@@ -213,6 +236,14 @@ error_t dhcpServerStop(DhcpServerContext *context)
       //Unregister callback function
       udpDetachRxCallback(interface, DHCP_SERVER_PORT);
 
+#if (DHCP_SERVER_LEASE_PERSISTENCE_SUPPORT == ENABLED)
+      //Flush pending lease file updates
+      if(context->leaseFileDirty)
+      {
+         dhcpServerSaveLeases(context);
+      }
+#endif
+
       //Stop DHCP server
       context->running = FALSE;
    }
@@ -52,6 +52,42 @@
    #error DHCP_SERVER_MAX_CLIENTS parameter is not valid
 #endif
 
+//Hash-indexed bindings and free-address bitmap
+#ifndef DHCP_SERVER_HASH_SUPPORT
+   #define DHCP_SERVER_HASH_SUPPORT DISABLED
+#elif (DHCP_SERVER_HASH_SUPPORT != ENABLED && DHCP_SERVER_HASH_SUPPORT != DISABLED)
+   #error DHCP_SERVER_HASH_SUPPORT parameter is not valid
+#endif
+
+//Size of the hash tables used to index the bindings
+#ifndef DHCP_SERVER_HASH_TABLE_SIZE
+   #define DHCP_SERVER_HASH_TABLE_SIZE 64
+#elif (DHCP_SERVER_HASH_TABLE_SIZE < 1)
+   #error DHCP_SERVER_HASH_TABLE_SIZE parameter is not valid
+#endif
+
+//Maximum number of addresses in the pool (size of the free-address bitmap)
+#ifndef DHCP_SERVER_MAX_POOL_SIZE
+   #define DHCP_SERVER_MAX_POOL_SIZE 256
+#elif (DHCP_SERVER_MAX_POOL_SIZE < 1)
+   #error DHCP_SERVER_MAX_POOL_SIZE parameter is not valid
+#endif
+
+//Lease persistence support
+#ifndef DHCP_SERVER_LEASE_PERSISTENCE_SUPPORT
+   #define DHCP_SERVER_LEASE_PERSISTENCE_SUPPORT DISABLED
+#elif (DHCP_SERVER_LEASE_PERSISTENCE_SUPPORT != ENABLED && \
+   DHCP_SERVER_LEASE_PERSISTENCE_SUPPORT != DISABLED)
+   #error DHCP_SERVER_LEASE_PERSISTENCE_SUPPORT parameter is not valid
+#endif
+
+//Minimum interval between two updates of the lease file, in milliseconds
+#ifndef DHCP_SERVER_LEASE_SAVE_INTERVAL
+   #define DHCP_SERVER_LEASE_SAVE_INTERVAL 10000
+#elif (DHCP_SERVER_LEASE_SAVE_INTERVAL < 1000)
+   #error DHCP_SERVER_LEASE_SAVE_INTERVAL parameter is not valid
+#endif
+
 //Default lease time, in seconds
 #ifndef DHCP_SERVER_DEFAULT_LEASE_TIME
    #define DHCP_SERVER_DEFAULT_LEASE_TIME 86400
@@ -71,6 +107,11 @@
    #define DHCP_SERVER_PRIVATE_CONTEXT
 #endif
 
+//File system support?
+#if (DHCP_SERVER_LEASE_PERSISTENCE_SUPPORT == ENABLED)
+   #include "fs_port.h"
+#endif
+
 //Forward declaration of DhcpServerContext structure
 struct _DhcpServerContext;
 #define DhcpServerContext struct _DhcpServerContext
@@ -105,12 +146,16 @@ typedef error_t (*DhcpServerParseOptionsCallback)(DhcpServerContext *context,
  *
  **/
 
-typedef struct
+typedef struct _DhcpServerBinding
 {
-   MacAddr macAddr;     ///<Client's MAC address
-   Ipv4Addr ipAddr;     ///<Client's IPv4 address
-   bool_t validLease;   ///<Valid lease
-   systime_t timestamp; ///<Timestamp
+   MacAddr macAddr;                         ///<Client's MAC address
+   Ipv4Addr ipAddr;                         ///<Client's IPv4 address
+   bool_t validLease;                       ///<Valid lease
+   systime_t timestamp;                     ///<Timestamp
+#if (DHCP_SERVER_HASH_SUPPORT == ENABLED)
+   struct _DhcpServerBinding *macHashNext; ///<Next binding in the same MAC hash bucket (or in the free list)
+   struct _DhcpServerBinding *ipHashNext;  ///<Next binding in the same IP hash bucket
+#endif
 } DhcpServerBinding;
 
 
@@ -131,6 +176,9 @@ typedef struct
    Ipv4Addr dnsServer[DHCP_SERVER_MAX_DNS_SERVERS];     ///<DNS servers
    DhcpServerAddOptionsCallback addOptionsCallback;     ///<Add DHCP options callback
    DhcpServerParseOptionsCallback parseOptionsCallback; ///<Parse DHCP options callback
+#if (DHCP_SERVER_LEASE_PERSISTENCE_SUPPORT == ENABLED)
+   const char_t *leaseFileName;                         ///<File where the committed leases are saved (NULL if not used)
+#endif
 } DhcpServerSettings;
 
 
@@ -144,6 +192,16 @@ struct _DhcpServerContext
    bool_t running;                                           ///<This flag tells whether the DHCP server is running or not
    Ipv4Addr nextIpAddr;                                      ///<Next IP address to be assigned
    DhcpServerBinding clientBinding[DHCP_SERVER_MAX_CLIENTS]; ///<List of bindings
+#if (DHCP_SERVER_HASH_SUPPORT == ENABLED)
+   DhcpServerBinding *macHashTable[DHCP_SERVER_HASH_TABLE_SIZE]; ///<Bindings indexed by MAC address
+   DhcpServerBinding *ipHashTable[DHCP_SERVER_HASH_TABLE_SIZE];  ///<Bindings indexed by IP address
+   DhcpServerBinding *freeBindings;                          ///<List of unused bindings
+   uint32_t poolBitmap[(DHCP_SERVER_MAX_POOL_SIZE + 31) / 32]; ///<Addresses of the pool that are currently allocated
+#endif
+#if (DHCP_SERVER_LEASE_PERSISTENCE_SUPPORT == ENABLED)
+   bool_t leaseFileDirty;                                    ///<The lease file needs to be updated
+   systime_t leaseFileTimestamp;                             ///<Time of the last update of the lease file
+#endif
    DHCP_SERVER_PRIVATE_CONTEXT                               ///<Application specific context
 };
 
@@ -66,16 +66,8 @@ void dhcpServerTick(DhcpServerContext *context)
 
    //Get current time
    time = osGetSystemTime();
-
    //Convert the lease time to milliseconds
-   if(context->settings.leaseTime < (MAX_DELAY / 1000))
-   {
-      leaseTime = context->settings.leaseTime * 1000;
-   }
-   else
-   {
-      leaseTime = MAX_DELAY;
-   }
+   leaseTime = dhcpServerGetLeaseTime(context);
 
    //Loop through the list of bindings
    for(i = 0; i < DHCP_SERVER_MAX_CLIENTS; i++)
@@ -94,10 +86,25 @@ void dhcpServerTick(DhcpServerContext *context)
             {
                //The address lease is not more valid
                binding->validLease = FALSE;
+
+#if (DHCP_SERVER_LEASE_PERSISTENCE_SUPPORT == ENABLED)
+               //The lease file needs to be updated
+               context->leaseFileDirty = TRUE;
+#endif
             }
          }
       }
    }
+
+#if (DHCP_SERVER_LEASE_PERSISTENCE_SUPPORT == ENABLED)
+   //Changes to the lease file are batched to limit the number of writes
+   if(context->leaseFileDirty && timeCompare(time,
+      context->leaseFileTimestamp + DHCP_SERVER_LEASE_SAVE_INTERVAL) >= 0)
+   {
+      //Save the committed leases
+      dhcpServerSaveLeases(context);
+   }
+#endif
 }
 
 
@@ -283,7 +290,7 @@ void dhcpServerParseDiscover(DhcpServerContext *context,
             if(!dhcpServerFindBindingByIpAddr(context, requestedIpAddr))
             {
                //Record IP address
-               binding->ipAddr = requestedIpAddr;
+               dhcpServerSetBindingIpAddr(context, binding, requestedIpAddr);
                //Get current time
                binding->timestamp = osGetSystemTime();
             }
@@ -296,7 +303,7 @@ void dhcpServerParseDiscover(DhcpServerContext *context,
    else
    {
       //Create a new binding
-      binding = dhcpServerCreateBinding(context);
+      binding = dhcpServerCreateBinding(context, &message->chaddr);
 
       //Binding successfully created
       if(binding != NULL)
@@ -308,31 +315,34 @@ void dhcpServerParseDiscover(DhcpServerContext *context,
             //Make sure the IP address is not already allocated
             if(!dhcpServerFindBindingByIpAddr(context, requestedIpAddr))
             {
-               //Record IP address
-               binding->ipAddr = requestedIpAddr;
                //Successful processing
                error = NO_ERROR;
             }
             else
             {
                //Retrieve the next available IP address from the pool of addresses
-               error = dhcpServerGetNextIpAddr(context, &binding->ipAddr);
+               error = dhcpServerGetNextIpAddr(context, &requestedIpAddr);
             }
          }
          else
          {
             //Retrieve the next available IP address from the pool of addresses
-            error = dhcpServerGetNextIpAddr(context, &binding->ipAddr);
+            error = dhcpServerGetNextIpAddr(context, &requestedIpAddr);
          }
 
          //Check status code
          if(!error)
          {
-            //Record MAC address
-            binding->macAddr = message->chaddr;
+            //Record IP address
+            dhcpServerSetBindingIpAddr(context, binding, requestedIpAddr);
             //Get current time
             binding->timestamp = osGetSystemTime();
          }
+         else
+         {
+            //The pool of addresses is exhausted
+            dhcpServerDeleteBinding(context, binding);
+         }
       }
       else
       {
@@ -424,6 +434,11 @@ void dhcpServerParseRequest(DhcpServerContext *context,
             //Save lease start time
             binding->timestamp = osGetSystemTime();
 
+#if (DHCP_SERVER_LEASE_PERSISTENCE_SUPPORT == ENABLED)
+            //The lease file needs to be updated
+            context->leaseFileDirty = TRUE;
+#endif
+
             //The server responds with a DHCPACK message containing the
             //configuration parameters for the requesting client
             dhcpServerSendReply(context, DHCP_MSG_TYPE_ACK,
@@ -443,20 +458,23 @@ void dhcpServerParseRequest(DhcpServerContext *context,
             if(!dhcpServerFindBindingByIpAddr(context, clientIpAddr))
             {
                //Create a new binding
-               binding = dhcpServerCreateBinding(context);
+               binding = dhcpServerCreateBinding(context, &message->chaddr);
 
                //Binding successfully created
                if(binding != NULL)
                {
-                  //Record MAC address
-                  binding->macAddr = message->chaddr;
                   //Record IP address
-                  binding->ipAddr = clientIpAddr;
+                  dhcpServerSetBindingIpAddr(context, binding, clientIpAddr);
                   //Commit network address
                   binding->validLease = TRUE;
                   //Get current time
                   binding->timestamp = osGetSystemTime();
 
+#if (DHCP_SERVER_LEASE_PERSISTENCE_SUPPORT == ENABLED)
+                  //The lease file needs to be updated
+                  context->leaseFileDirty = TRUE;
+#endif
+
                   //The server responds with a DHCPACK message containing the
                   //configuration parameters for the requesting client
                   dhcpServerSendReply(context, DHCP_MSG_TYPE_ACK,
@@ -509,8 +527,15 @@ void dhcpServerParseDecline(DhcpServerContext *context,
          //Check the IP address against the requested IP address
          if(binding->ipAddr == requestedIpAddr)
          {
+#if (DHCP_SERVER_LEASE_PERSISTENCE_SUPPORT == ENABLED)
+            //The lease file needs to be updated
+            if(binding->validLease)
+            {
+               context->leaseFileDirty = TRUE;
+            }
+#endif
             //Remote the binding from the list
-            osMemset(binding, 0, sizeof(DhcpServerBinding));
+            dhcpServerDeleteBinding(context, binding);
          }
       }
    }
@@ -540,6 +565,11 @@ void dhcpServerParseRelease(DhcpServerContext *context,
       {
          //Release the network address and cancel remaining lease
          binding->validLease = FALSE;
+
+#if (DHCP_SERVER_LEASE_PERSISTENCE_SUPPORT == ENABLED)
+         //The lease file needs to be updated
+         context->leaseFileDirty = TRUE;
+#endif
       }
    }
 }
@@ -786,13 +816,50 @@ error_t dhcpServerSendReply(DhcpServerContext *context, uint8_t type,
 }
 
 
+/**
+ * @brief Initialize the list of bindings
+ * @param[in] context Pointer to the DHCP server context
+ **/
+
+void dhcpServerInitBindings(DhcpServerContext *context)
+{
+#if (DHCP_SERVER_HASH_SUPPORT == ENABLED)
+   uint_t i;
+#endif
+
+   //Clear the list of bindings
+   osMemset(context->clientBinding, 0, sizeof(context->clientBinding));
+
+#if (DHCP_SERVER_HASH_SUPPORT == ENABLED)
+   //Clear the hash tables
+   osMemset(context->macHashTable, 0, sizeof(context->macHashTable));
+   osMemset(context->ipHashTable, 0, sizeof(context->ipHashTable));
+
+   //No address of the pool is allocated
+   osMemset(context->poolBitmap, 0, sizeof(context->poolBitmap));
+
+   //All the bindings are initially unused
+   context->freeBindings = NULL;
+
+   //Build the list of unused bindings
+   for(i = DHCP_SERVER_MAX_CLIENTS; i > 0; i--)
+   {
+      context->clientBinding[i - 1].macHashNext = context->freeBindings;
+      context->freeBindings = &context->clientBinding[i - 1];
+   }
+#endif
+}
+
+
 /**
  * @brief Create a new binding
  * @param[in] context Pointer to the DHCP server context
+ * @param[in] macAddr Client's MAC address
  * @return Pointer to the newly created binding
  **/
 
-DhcpServerBinding *dhcpServerCreateBinding(DhcpServerContext *context)
+DhcpServerBinding *dhcpServerCreateBinding(DhcpServerContext *context,
+   const MacAddr *macAddr)
 {
    uint_t i;
    systime_t time;
@@ -802,39 +869,62 @@ DhcpServerBinding *dhcpServerCreateBinding(DhcpServerContext *context)
    //Get current time
    time = osGetSystemTime();
 
-   //Keep track of the oldest binding
-   oldestBinding = NULL;
-
-   //Loop through the list of bindings
-   for(i = 0; i < DHCP_SERVER_MAX_CLIENTS; i++)
+#if (DHCP_SERVER_HASH_SUPPORT == ENABLED)
+   //Any unused binding?
+   if(context->freeBindings != NULL)
    {
-      //Point to the current binding
-      binding = &context->clientBinding[i];
+      //Take the first binding from the list of unused bindings
+      oldestBinding = context->freeBindings;
+      context->freeBindings = oldestBinding->macHashNext;
+   }
+   else
+#endif
+   {
+      //Keep track of the oldest binding
+      oldestBinding = NULL;
 
-      //Check whether the binding is available
-      if(macCompAddr(&binding->macAddr, &MAC_UNSPECIFIED_ADDR))
+      //Loop through the list of bindings
+      for(i = 0; i < DHCP_SERVER_MAX_CLIENTS; i++)
       {
-         //Erase contents
-         osMemset(binding, 0, sizeof(DhcpServerBinding));
-         //Return a pointer to the newly created binding
-         return binding;
-      }
-      else
-      {
-         //Bindings that have been committed cannot be removed
-         if(!binding->validLease)
+         //Point to the current binding
+         binding = &context->clientBinding[i];
+
+         //Check whether the binding is available
+         if(macCompAddr(&binding->macAddr, &MAC_UNSPECIFIED_ADDR))
          {
-            //Keep track of the oldest binding in the list
-            if(oldestBinding == NULL)
-            {
-               oldestBinding = binding;
-            }
-            else if((time - binding->timestamp) > (time - oldestBinding->timestamp))
+            //Use the current binding
+            oldestBinding = binding;
+            break;
+         }
+         else
+         {
+            //Bindings that have been committed cannot be removed
+            if(!binding->validLease)
             {
-               oldestBinding = binding;
+               //Keep track of the oldest binding in the list
+               if(oldestBinding == NULL)
+               {
+                  oldestBinding = binding;
+               }
+               else if((time - binding->timestamp) > (time - oldestBinding->timestamp))
+               {
+                  oldestBinding = binding;
+               }
             }
          }
       }
+
+#if (DHCP_SERVER_HASH_SUPPORT == ENABLED)
+      //Any binding available in the list?
+      if(oldestBinding != NULL)
+      {
+         //Release the binding
+         dhcpServerDeleteBinding(context, oldestBinding);
+
+         //The binding is now at the head of the list of unused bindings
+         context->freeBindings = oldestBinding->macHashNext;
+      }
+#endif
    }
 
    //Any binding available in the list?
@@ -842,13 +932,133 @@ DhcpServerBinding *dhcpServerCreateBinding(DhcpServerContext *context)
    {
       //Erase contents
       osMemset(oldestBinding, 0, sizeof(DhcpServerBinding));
+      //Record MAC address
+      oldestBinding->macAddr = *macAddr;
+      //Get current time
+      oldestBinding->timestamp = time;
+
+#if (DHCP_SERVER_HASH_SUPPORT == ENABLED)
+      //Insert the binding in the MAC hash table
+      i = dhcpServerHashMacAddr(macAddr);
+      oldestBinding->macHashNext = context->macHashTable[i];
+      context->macHashTable[i] = oldestBinding;
+#endif
    }
 
-   //Return a pointer to the oldest binding
+   //Return a pointer to the newly created binding
    return oldestBinding;
 }
 
 
+/**
+ * @brief Delete a binding
+ * @param[in] context Pointer to the DHCP server context
+ * @param[in] binding Pointer to the binding to be deleted
+ **/
+
+void dhcpServerDeleteBinding(DhcpServerContext *context,
+   DhcpServerBinding *binding)
+{
+#if (DHCP_SERVER_HASH_SUPPORT == ENABLED)
+   DhcpServerBinding **p;
+
+   //Release the IP address
+   dhcpServerSetBindingIpAddr(context, binding, IPV4_UNSPECIFIED_ADDR);
+
+   //Remove the binding from its MAC hash bucket
+   for(p = &context->macHashTable[dhcpServerHashMacAddr(&binding->macAddr)];
+      *p != NULL; p = &(*p)->macHashNext)
+   {
+      //Matching binding?
+      if(*p == binding)
+      {
+         *p = binding->macHashNext;
+         break;
+      }
+   }
+#endif
+
+   //Erase contents
+   osMemset(binding, 0, sizeof(DhcpServerBinding));
+
+#if (DHCP_SERVER_HASH_SUPPORT == ENABLED)
+   //Add the binding to the list of unused bindings
+   binding->macHashNext = context->freeBindings;
+   context->freeBindings = binding;
+#endif
+}
+
+
+/**
+ * @brief Set the IP address of a binding
+ * @param[in] context Pointer to the DHCP server context
+ * @param[in] binding Pointer to the binding
+ * @param[in] ipAddr IP address (or the unspecified address to release the
+ *   current IP address)
+ **/
+
+void dhcpServerSetBindingIpAddr(DhcpServerContext *context,
+   DhcpServerBinding *binding, Ipv4Addr ipAddr)
+{
+#if (DHCP_SERVER_HASH_SUPPORT == ENABLED)
+   uint_t i;
+   DhcpServerBinding **p;
+
+   //Release the current IP address
+   if(binding->ipAddr != IPV4_UNSPECIFIED_ADDR)
+   {
+      //Remove the binding from its IP hash bucket
+      for(p = &context->ipHashTable[dhcpServerHashIpAddr(binding->ipAddr)];
+         *p != NULL; p = &(*p)->ipHashNext)
+      {
+         //Matching binding?
+         if(*p == binding)
+         {
+            *p = binding->ipHashNext;
+            break;
+         }
+      }
+
+      //Unlink the binding
+      binding->ipHashNext = NULL;
+
+      //Address belonging to the pool?
+      if(ntohl(binding->ipAddr) >= ntohl(context->settings.ipAddrRangeMin) &&
+         ntohl(binding->ipAddr) <= ntohl(context->settings.ipAddrRangeMax))
+      {
+         //The address is available again
+         i = ntohl(binding->ipAddr) - ntohl(context->settings.ipAddrRangeMin);
+         context->poolBitmap[i / 32] &= ~(1UL << (i % 32));
+      }
+   }
+
+   //Record IP address
+   binding->ipAddr = ipAddr;
+
+   //Allocate the new IP address
+   if(ipAddr != IPV4_UNSPECIFIED_ADDR)
+   {
+      //Insert the binding in the IP hash table
+      i = dhcpServerHashIpAddr(ipAddr);
+      binding->ipHashNext = context->ipHashTable[i];
+      context->ipHashTable[i] = binding;
+
+      //Address belonging to the pool?
+      if(ntohl(ipAddr) >= ntohl(context->settings.ipAddrRangeMin) &&
+         ntohl(ipAddr) <= ntohl(context->settings.ipAddrRangeMax))
+      {
+         //The address is no longer available
+         i = ntohl(ipAddr) - ntohl(context->settings.ipAddrRangeMin);
+         context->poolBitmap[i / 32] |= 1UL << (i % 32);
+      }
+   }
+#else
+   //Record IP address
+   binding->ipAddr = ipAddr;
+#endif
+}
+
+
 /**
  * @brief Search the list of bindings for a given MAC address
  * @param[in] context Pointer to the DHCP server context
@@ -859,6 +1069,21 @@ DhcpServerBinding *dhcpServerCreateBinding(DhcpServerContext *context)
 DhcpServerBinding *dhcpServerFindBindingByMacAddr(DhcpServerContext *context,
    const MacAddr *macAddr)
 {
+#if (DHCP_SERVER_HASH_SUPPORT == ENABLED)
+   DhcpServerBinding *binding;
+
+   //Walk through the corresponding hash bucket
+   for(binding = context->macHashTable[dhcpServerHashMacAddr(macAddr)];
+      binding != NULL; binding = binding->macHashNext)
+   {
+      //Check whether the current binding matches the specified MAC address
+      if(macCompAddr(&binding->macAddr, macAddr))
+      {
+         //Return the pointer to the corresponding binding
+         return binding;
+      }
+   }
+#else
    uint_t i;
    DhcpServerBinding *binding;
 
@@ -879,6 +1104,7 @@ DhcpServerBinding *dhcpServerFindBindingByMacAddr(DhcpServerContext *context,
          }
       }
    }
+#endif
 
    //No matching binding...
    return NULL;
@@ -895,6 +1121,21 @@ DhcpServerBinding *dhcpServerFindBindingByMacAddr(DhcpServerContext *context,
 DhcpServerBinding *dhcpServerFindBindingByIpAddr(DhcpServerContext *context,
    Ipv4Addr ipAddr)
 {
+#if (DHCP_SERVER_HASH_SUPPORT == ENABLED)
+   DhcpServerBinding *binding;
+
+   //Walk through the corresponding hash bucket
+   for(binding = context->ipHashTable[dhcpServerHashIpAddr(ipAddr)];
+      binding != NULL; binding = binding->ipHashNext)
+   {
+      //Check whether the current binding matches the specified IP address
+      if(binding->ipAddr == ipAddr)
+      {
+         //Return the pointer to the corresponding binding
+         return binding;
+      }
+   }
+#else
    uint_t i;
    DhcpServerBinding *binding;
 
@@ -915,6 +1156,7 @@ DhcpServerBinding *dhcpServerFindBindingByIpAddr(DhcpServerContext *context,
          }
       }
    }
+#endif
 
    //No matching binding...
    return NULL;
@@ -930,6 +1172,68 @@ DhcpServerBinding *dhcpServerFindBindingByIpAddr(DhcpServerContext *context,
 
 error_t dhcpServerGetNextIpAddr(DhcpServerContext *context, Ipv4Addr *ipAddr)
 {
+#if (DHCP_SERVER_HASH_SUPPORT == ENABLED)
+   uint32_t i;
+   uint32_t n;
+   uint32_t start;
+   uint32_t poolSize;
+
+   //Number of addresses in the pool
+   poolSize = ntohl(context->settings.ipAddrRangeMax) -
+      ntohl(context->settings.ipAddrRangeMin) + 1;
+
+   //Start the search at the next IP address to be assigned
+   start = ntohl(context->nextIpAddr) - ntohl(context->settings.ipAddrRangeMin);
+
+   //Make sure the starting point lies within the pool
+   if(start >= poolSize)
+   {
+      start = 0;
+   }
+
+   //Search the free-address bitmap for any available IP address
+   for(n = 0; n < poolSize; n++)
+   {
+      //Index of the current address in the pool
+      i = start + n;
+
+      //Wrap around to the beginning of the pool
+      if(i >= poolSize)
+      {
+         i -= poolSize;
+      }
+
+      //Skip blocks of 32 addresses that are all allocated
+      if((i % 32) == 0 && context->poolBitmap[i / 32] == 0xFFFFFFFF)
+      {
+         n += 31;
+      }
+      else if((context->poolBitmap[i / 32] & (1UL << (i % 32))) == 0)
+      {
+         //The IP address is available and can be assigned to a new client
+         *ipAddr = htonl(ntohl(context->settings.ipAddrRangeMin) + i);
+
+         //Compute the next IP address that will be assigned by the DHCP server
+         if((i + 1) >= poolSize)
+         {
+            //Wrap around to the beginning of the pool
+            context->nextIpAddr = context->settings.ipAddrRangeMin;
+         }
+         else
+         {
+            //Increment IP address
+            context->nextIpAddr = htonl(ntohl(*ipAddr) + 1);
+         }
+
+         //We are done
+         return NO_ERROR;
+      }
+      else
+      {
+         //The IP address is already allocated
+      }
+   }
+#else
    uint_t i;
    DhcpServerBinding *binding;
 
@@ -959,9 +1263,266 @@ error_t dhcpServerGetNextIpAddr(DhcpServerContext *context, Ipv4Addr *ipAddr)
       if(binding == NULL)
          return NO_ERROR;
    }
+#endif
 
    //No available addresses in the pool...
    return ERROR_NO_ADDRESS;
 }
 
+
+/**
+ * @brief Get the lease time, in milliseconds
+ * @param[in] context Pointer to the DHCP server context
+ * @return Lease time, in milliseconds
+ **/
+
+systime_t dhcpServerGetLeaseTime(DhcpServerContext *context)
+{
+   systime_t leaseTime;
+
+   //Convert the lease time to milliseconds
+   if(context->settings.leaseTime < (MAX_DELAY / 1000))
+   {
+      leaseTime = context->settings.leaseTime * 1000;
+   }
+   else
+   {
+      leaseTime = MAX_DELAY;
+   }
+
+   //Return the lease time
+   return leaseTime;
+}
+
+#if (DHCP_SERVER_HASH_SUPPORT == ENABLED)
+
+/**
+ * @brief Compute the hash table index of a MAC address
+ * @param[in] macAddr MAC address
+ * @return Index of the hash bucket
+ **/
+
+uint_t dhcpServerHashMacAddr(const MacAddr *macAddr)
+{
+   uint_t i;
+   uint32_t h;
+
+   //FNV-1a hash of the MAC address
+   for(h = 0x811C9DC5, i = 0; i < sizeof(MacAddr); i++)
+   {
+      h ^= macAddr->b[i];
+      h *= 0x01000193;
+   }
+
+   //Return the index of the hash bucket
+   return h % DHCP_SERVER_HASH_TABLE_SIZE;
+}
+
+
+/**
+ * @brief Compute the hash table index of an IPv4 address
+ * @param[in] ipAddr IPv4 address
+ * @return Index of the hash bucket
+ **/
+
+uint_t dhcpServerHashIpAddr(Ipv4Addr ipAddr)
+{
+   uint32_t h;
+
+   //Convert the IPv4 address to host byte order
+   h = ntohl(ipAddr);
+
+   //Mix the bits so that consecutive host addresses are spread evenly
+   h ^= h >> 16;
+   h *= 0x45D9F3BUL;
+   h ^= h >> 16;
+
+   //Return the index of the hash bucket
+   return h % DHCP_SERVER_HASH_TABLE_SIZE;
+}
+
+#endif
+#if (DHCP_SERVER_LEASE_PERSISTENCE_SUPPORT == ENABLED)
+
+/**
+ * @brief Restore the committed leases from the lease file
+ *
+ * Each record of the lease file holds the MAC address of the client, the
+ * IP address assigned to it and the remaining lease time, in seconds
+ *
+ * @param[in] context Pointer to the DHCP server context
+ * @return Error code
+ **/
+
+error_t dhcpServerLoadLeases(DhcpServerContext *context)
+{
+   error_t error;
+   size_t n;
+   systime_t time;
+   systime_t leaseTime;
+   systime_t remaining;
+   MacAddr macAddr;
+   Ipv4Addr ipAddr;
+   FsFile *file;
+   DhcpServerBinding *binding;
+   uint8_t record[DHCP_SERVER_LEASE_RECORD_SIZE];
+
+   //No lease file?
+   if(context->settings.leaseFileName == NULL)
+      return NO_ERROR;
+
+   //Open the lease file
+   file = fsOpenFile(context->settings.leaseFileName, FS_FILE_MODE_READ);
+   //The file does not exist yet?
+   if(file == NULL)
+      return ERROR_FILE_NOT_FOUND;
+
+   //Get current time
+   time = osGetSystemTime();
+   //Convert the lease time to milliseconds
+   leaseTime = dhcpServerGetLeaseTime(context);
+
+   //Read the lease file
+   while(1)
+   {
+      //Read the next record
+      error = fsReadFile(file, record, sizeof(record), &n);
+
+      //End of file?
+      if(error || n != sizeof(record))
+         break;
+
+      //Parse the record
+      osMemcpy(&macAddr, record, sizeof(MacAddr));
+      ipv4CopyAddr(&ipAddr, record + 6);
+      remaining = LOAD32BE(record + 10);
+
+      //Discard expired leases and addresses that no longer belong to the pool
+      if(remaining == 0)
+         continue;
+      if(ntohl(ipAddr) < ntohl(context->settings.ipAddrRangeMin) ||
+         ntohl(ipAddr) > ntohl(context->settings.ipAddrRangeMax))
+      {
+         continue;
+      }
+
+      //Make sure neither the client nor the address is already bound
+      if(dhcpServerFindBindingByMacAddr(context, &macAddr) != NULL)
+         continue;
+      if(dhcpServerFindBindingByIpAddr(context, ipAddr) != NULL)
+         continue;
+
+      //Create a new binding
+      binding = dhcpServerCreateBinding(context, &macAddr);
+      //Failed to create a new binding?
+      if(binding == NULL)
+         break;
+
+      //Record IP address
+      dhcpServerSetBindingIpAddr(context, binding, ipAddr);
+      //The lease is still valid
+      binding->validLease = TRUE;
+
+      //Convert the remaining lease time to milliseconds
+      remaining = MIN(remaining, leaseTime / 1000) * 1000;
+      //Back-date the start of the lease accordingly
+      binding->timestamp = time - (leaseTime - remaining);
+   }
+
+   //Close the lease file
+   fsCloseFile(file);
+
+   //The lease file is up to date
+   context->leaseFileDirty = FALSE;
+   context->leaseFileTimestamp = time;
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Save the committed leases to the lease file
+ * @param[in] context Pointer to the DHCP server context
+ * @return Error code
+ **/
+
+error_t dhcpServerSaveLeases(DhcpServerContext *context)
+{
+   error_t error;
+   uint_t i;
+   systime_t time;
+   systime_t leaseTime;
+   systime_t elapsed;
+   FsFile *file;
+   DhcpServerBinding *binding;
+   uint8_t record[DHCP_SERVER_LEASE_RECORD_SIZE];
+
+   //Get current time
+   time = osGetSystemTime();
+
+   //Postpone the next update, even if this one fails
+   context->leaseFileTimestamp = time;
+
+   //No lease file?
+   if(context->settings.leaseFileName == NULL)
+   {
+      //Nothing to save
+      context->leaseFileDirty = FALSE;
+      return NO_ERROR;
+   }
+
+   //Open the lease file
+   file = fsOpenFile(context->settings.leaseFileName, FS_FILE_MODE_WRITE |
+      FS_FILE_MODE_CREATE | FS_FILE_MODE_TRUNC);
+   //Failed to open the file?
+   if(file == NULL)
+      return ERROR_OPEN_FAILED;
+
+   //Convert the lease time to milliseconds
+   leaseTime = dhcpServerGetLeaseTime(context);
+
+   //Initialize status code
+   error = NO_ERROR;
+
+   //Loop through the list of bindings
+   for(i = 0; i < DHCP_SERVER_MAX_CLIENTS && !error; i++)
+   {
+      //Point to the current binding
+      binding = &context->clientBinding[i];
+
+      //Only committed leases are saved
+      if(!macCompAddr(&binding->macAddr, &MAC_UNSPECIFIED_ADDR) &&
+         binding->validLease)
+      {
+         //Time elapsed since the start of the lease
+         elapsed = time - binding->timestamp;
+
+         //Format the record
+         osMemcpy(record, &binding->macAddr, sizeof(MacAddr));
+         ipv4CopyAddr(record + 6, &binding->ipAddr);
+         STORE32BE((elapsed < leaseTime) ? (leaseTime - elapsed) / 1000 : 0,
+            record + 10);
+
+         //Write the record
+         error = fsWriteFile(file, record, sizeof(record));
+      }
+   }
+
+   //Close the lease file
+   fsCloseFile(file);
+
+   //Check status code
+   if(!error)
+   {
+      //The lease file is up to date
+      context->leaseFileDirty = FALSE;
+   }
+
+   //Return status code
+   return error;
+}
+
+#endif
+
 #endif
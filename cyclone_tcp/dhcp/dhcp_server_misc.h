@@ -32,6 +32,9 @@
 #include "core/net.h"
 #include "dhcp/dhcp_server.h"
 
+//Size of a lease file record (MAC address, IP address and remaining lease time)
+#define DHCP_SERVER_LEASE_RECORD_SIZE 14
+
 //C++ guard
 #ifdef __cplusplus
 extern "C" {
@@ -66,7 +69,16 @@ void dhcpServerParseInform(DhcpServerContext *context,
 error_t dhcpServerSendReply(DhcpServerContext *context, uint8_t type,
    Ipv4Addr yourIpAddr, const DhcpMessage *request, size_t requestLen);
 
-DhcpServerBinding *dhcpServerCreateBinding(DhcpServerContext *context);
+void dhcpServerInitBindings(DhcpServerContext *context);
+
+DhcpServerBinding *dhcpServerCreateBinding(DhcpServerContext *context,
+   const MacAddr *macAddr);
+
+void dhcpServerDeleteBinding(DhcpServerContext *context,
+   DhcpServerBinding *binding);
+
+void dhcpServerSetBindingIpAddr(DhcpServerContext *context,
+   DhcpServerBinding *binding, Ipv4Addr ipAddr);
 
 DhcpServerBinding *dhcpServerFindBindingByMacAddr(DhcpServerContext *context,
    const MacAddr *macAddr);
@@ -76,6 +88,14 @@ DhcpServerBinding *dhcpServerFindBindingByIpAddr(DhcpServerContext *context,
 
 error_t dhcpServerGetNextIpAddr(DhcpServerContext *context, Ipv4Addr *ipAddr);
 
+systime_t dhcpServerGetLeaseTime(DhcpServerContext *context);
+
+uint_t dhcpServerHashMacAddr(const MacAddr *macAddr);
+uint_t dhcpServerHashIpAddr(Ipv4Addr ipAddr);
+
+error_t dhcpServerLoadLeases(DhcpServerContext *context);
+error_t dhcpServerSaveLeases(DhcpServerContext *context);
+
 //C++ guard
 #ifdef __cplusplus
 }
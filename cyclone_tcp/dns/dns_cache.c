@@ -48,6 +48,11 @@ systime_t dnsTickCounter;
 //DNS cache
 DnsCacheEntry dnsCache[DNS_CACHE_SIZE];
 
+#if (DNS_CACHE_HASH_SUPPORT == ENABLED)
+//Hash table used to speed up DNS cache lookups
+static DnsCacheEntry *dnsCacheHashTable[DNS_CACHE_HASH_SIZE];
+#endif
+
 
 /**
  * @brief DNS cache initialization
@@ -59,6 +64,16 @@ error_t dnsInit(void)
    //Initialize DNS cache
    osMemset(dnsCache, 0, sizeof(dnsCache));
 
+#if (DNS_CACHE_HASH_SUPPORT == ENABLED)
+   //Initialize hash table
+   osMemset(dnsCacheHashTable, 0, sizeof(dnsCacheHashTable));
+#endif
+
+#if (DNS_CLIENT_SUPPORT == ENABLED && DNS_CLIENT_ASYNC_SUPPORT == ENABLED)
+   //Initialize the table of pending asynchronous requests
+   osMemset(dnsRequestTable, 0, sizeof(dnsRequestTable));
+#endif
+
    //Successful initialization
    return NO_ERROR;
 }
@@ -120,6 +135,8 @@ DnsCacheEntry *dnsCreateEntry(void)
       //Check whether the entry is currently in use or not
       if(entry->state == DNS_STATE_NONE)
       {
+         //The entry may still be linked in the hash table
+         dnsUnlinkEntry(entry);
          //Erase contents
          osMemset(entry, 0, sizeof(DnsCacheEntry));
          //Return a pointer to the DNS entry
@@ -142,6 +159,71 @@ DnsCacheEntry *dnsCreateEntry(void)
 }
 
 
+/**
+ * @brief Add a DNS cache entry to the hash table
+ *
+ * This function must be called once the domain name of a newly created
+ * entry has been set
+ *
+ * @param[in] entry Pointer to the DNS cache entry
+ **/
+
+void dnsAddEntry(DnsCacheEntry *entry)
+{
+#if (DNS_CACHE_HASH_SUPPORT == ENABLED)
+   uint_t i;
+
+   //Make sure the entry is not already linked
+   if(!entry->hashed)
+   {
+      //Compute the hash of the domain name
+      i = dnsHashName(entry->name);
+
+      //Add the entry at the head of the bucket
+      entry->hashNext = dnsCacheHashTable[i];
+      entry->hashed = TRUE;
+      dnsCacheHashTable[i] = entry;
+   }
+#endif
+}
+
+
+/**
+ * @brief Remove a DNS cache entry from the hash table
+ * @param[in] entry Pointer to the DNS cache entry
+ **/
+
+void dnsUnlinkEntry(DnsCacheEntry *entry)
+{
+#if (DNS_CACHE_HASH_SUPPORT == ENABLED)
+   DnsCacheEntry **p;
+
+   //Check whether the entry is linked in the hash table
+   if(entry->hashed)
+   {
+      //Point to the relevant bucket
+      p = &dnsCacheHashTable[dnsHashName(entry->name)];
+
+      //Search the bucket for the specified entry
+      while(*p != NULL && *p != entry)
+      {
+         p = &(*p)->hashNext;
+      }
+
+      //Remove the entry from the bucket
+      if(*p != NULL)
+      {
+         *p = entry->hashNext;
+      }
+
+      //The entry is no longer linked
+      entry->hashNext = NULL;
+      entry->hashed = FALSE;
+   }
+#endif
+}
+
+
 /**
  * @brief Delete the specified DNS cache entry
  * @param[in] entry Pointer to the DNS cache entry to be deleted
@@ -149,24 +231,58 @@ DnsCacheEntry *dnsCreateEntry(void)
 
 void dnsDeleteEntry(DnsCacheEntry *entry)
 {
+   bool_t pending;
+
    //Make sure the specified entry is valid
    if(entry != NULL)
    {
+      //Check whether a query is outstanding
+      pending = (entry->state == DNS_STATE_IN_PROGRESS);
+
+#if (DNS_PREFETCH_SUPPORT == ENABLED)
+      //The entry may be refreshed in the background
+      if(entry->prefetch)
+      {
+         pending = TRUE;
+      }
+#endif
+
 #if (DNS_CLIENT_SUPPORT == ENABLED || LLMNR_CLIENT_SUPPORT == ENABLED)
       //DNS or LLMNR resolver?
       if(entry->protocol == HOST_NAME_RESOLVER_DNS ||
          entry->protocol == HOST_NAME_RESOLVER_LLMNR)
       {
          //Name resolution in progress?
-         if(entry->state == DNS_STATE_IN_PROGRESS)
+         if(pending)
          {
             //Unregister user callback
             udpDetachRxCallback(entry->interface, entry->port);
          }
       }
 #endif
+
+      //Check whether the name resolution is aborted
+      pending = (entry->state == DNS_STATE_IN_PROGRESS);
+
+      //Remove the entry from the hash table
+      dnsUnlinkEntry(entry);
+
       //Delete DNS cache entry
       entry->state = DNS_STATE_NONE;
+
+#if (DNS_PREFETCH_SUPPORT == ENABLED)
+      //Cancel background refresh
+      entry->prefetch = FALSE;
+#endif
+
+#if (DNS_CLIENT_SUPPORT == ENABLED && DNS_CLIENT_ASYNC_SUPPORT == ENABLED)
+      //DNS resolver?
+      if(entry->protocol == HOST_NAME_RESOLVER_DNS && pending)
+      {
+         //Notify the pending requests that the name resolution failed
+         dnsNotifyRequests(entry, ERROR_FAILURE);
+      }
+#endif
    }
 }
 
@@ -187,6 +303,36 @@ DnsCacheEntry *dnsFindEntry(NetInterface *interface,
    uint_t i;
    DnsCacheEntry *entry;
 
+#if (DNS_CACHE_HASH_SUPPORT == ENABLED)
+   //Any domain name specified?
+   if(name != NULL)
+   {
+      //Walk through the relevant bucket
+      for(entry = dnsCacheHashTable[dnsHashName(name)]; entry != NULL;
+         entry = entry->hashNext)
+      {
+         //Make sure that the entry is currently in use
+         if(entry->state == DNS_STATE_NONE)
+            continue;
+
+         //Filter out entries that do not match the specified criteria
+         if(entry->interface != interface)
+            continue;
+         if(entry->type != type && type != HOST_TYPE_ANY)
+            continue;
+         if(entry->protocol != protocol && protocol != HOST_NAME_RESOLVER_ANY)
+            continue;
+
+         //Does the entry match the specified domain name?
+         if(!osStrcasecmp(entry->name, name))
+            return entry;
+      }
+
+      //No matching entry in the DNS cache
+      return NULL;
+   }
+#endif
+
    //Loop through DNS cache entries
    for(i = 0; i < DNS_CACHE_SIZE; i++)
    {
@@ -321,7 +467,8 @@ void dnsTick(void)
          }
       }
       //Name successfully resolved?
-      else if(entry->state == DNS_STATE_RESOLVED)
+      else if(entry->state == DNS_STATE_RESOLVED ||
+         entry->state == DNS_STATE_NEGATIVE)
       {
          //Check the lifetime of the current DNS cache entry
          if(timeCompare(time, entry->timestamp + entry->timeout) >= 0)
@@ -329,8 +476,48 @@ void dnsTick(void)
             //Periodically time out DNS cache entries
             dnsDeleteEntry(entry);
          }
+#if (DNS_CLIENT_SUPPORT == ENABLED && DNS_PREFETCH_SUPPORT == ENABLED)
+         //Background refresh in progress?
+         else if(entry->prefetch)
+         {
+            //The refresh query timed out?
+            if(timeCompare(time, entry->prefetchTimestamp +
+               DNS_CLIENT_MAX_TIMEOUT) >= 0)
+            {
+               //Unregister user callback
+               udpDetachRxCallback(entry->interface, entry->port);
+               //Keep using the cached address until it expires
+               entry->prefetch = FALSE;
+            }
+         }
+#endif
       }
    }
 }
 
+
+/**
+ * @brief Compute the hash of a domain name
+ * @param[in] name Domain name (case insensitive)
+ * @return Index of the corresponding bucket
+ **/
+
+uint_t dnsHashName(const char_t *name)
+{
+   uint32_t h;
+
+   //Initialize hash value
+   h = 0;
+
+   //Domain names are case insensitive
+   while(*name != '\0')
+   {
+      h = (h * 31) + (uint8_t) osTolower(*name);
+      name++;
+   }
+
+   //Return the index of the bucket
+   return h % DNS_CACHE_HASH_SIZE;
+}
+
 #endif
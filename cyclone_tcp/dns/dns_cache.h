@@ -46,6 +46,48 @@
    #error DNS_CACHE_SIZE parameter is not valid
 #endif
 
+//Hashed DNS cache lookups
+#ifndef DNS_CACHE_HASH_SUPPORT
+   #define DNS_CACHE_HASH_SUPPORT DISABLED
+#elif (DNS_CACHE_HASH_SUPPORT != ENABLED && DNS_CACHE_HASH_SUPPORT != DISABLED)
+   #error DNS_CACHE_HASH_SUPPORT parameter is not valid
+#endif
+
+//Number of buckets of the DNS cache hash table
+#ifndef DNS_CACHE_HASH_SIZE
+   #define DNS_CACHE_HASH_SIZE 16
+#elif (DNS_CACHE_HASH_SIZE < 1)
+   #error DNS_CACHE_HASH_SIZE parameter is not valid
+#endif
+
+//Negative caching of DNS responses
+#ifndef DNS_NEGATIVE_CACHE_SUPPORT
+   #define DNS_NEGATIVE_CACHE_SUPPORT DISABLED
+#elif (DNS_NEGATIVE_CACHE_SUPPORT != ENABLED && DNS_NEGATIVE_CACHE_SUPPORT != DISABLED)
+   #error DNS_NEGATIVE_CACHE_SUPPORT parameter is not valid
+#endif
+
+//Maximum cache lifetime for negative DNS entries
+#ifndef DNS_MAX_NEGATIVE_LIFETIME
+   #define DNS_MAX_NEGATIVE_LIFETIME 300000
+#elif (DNS_MAX_NEGATIVE_LIFETIME < 1000)
+   #error DNS_MAX_NEGATIVE_LIFETIME parameter is not valid
+#endif
+
+//Refresh of popular DNS entries before they expire
+#ifndef DNS_PREFETCH_SUPPORT
+   #define DNS_PREFETCH_SUPPORT DISABLED
+#elif (DNS_PREFETCH_SUPPORT != ENABLED && DNS_PREFETCH_SUPPORT != DISABLED)
+   #error DNS_PREFETCH_SUPPORT parameter is not valid
+#endif
+
+//Remaining lifetime (in percent) below which an entry is refreshed
+#ifndef DNS_PREFETCH_THRESHOLD
+   #define DNS_PREFETCH_THRESHOLD 10
+#elif (DNS_PREFETCH_THRESHOLD < 1 || DNS_PREFETCH_THRESHOLD > 50)
+   #error DNS_PREFETCH_THRESHOLD parameter is not valid
+#endif
+
 //Maximum length of domain names
 #ifndef DNS_MAX_NAME_LEN
    #define DNS_MAX_NAME_LEN 63
@@ -82,7 +124,8 @@ typedef enum
    DNS_STATE_NONE        = 0,
    DNS_STATE_IN_PROGRESS = 1,
    DNS_STATE_RESOLVED    = 2,
-   DNS_STATE_PERMANENT   = 3
+   DNS_STATE_PERMANENT   = 3,
+   DNS_STATE_NEGATIVE    = 4
 } DnsState;
 
 
@@ -90,8 +133,12 @@ typedef enum
  * @brief DNS cache entry
  **/
 
-typedef struct
+typedef struct _DnsCacheEntry
 {
+#if (DNS_CACHE_HASH_SUPPORT == ENABLED)
+   struct _DnsCacheEntry *hashNext;   ///<Next entry in the same hash bucket
+   bool_t hashed;                     ///<The entry is linked in the hash table
+#endif
    DnsState state;                    ///<Entry state
    HostType type;                     ///<IPv4 or IPv6 host?
    HostnameResolver protocol;         ///<Name resolution protocol
@@ -105,6 +152,10 @@ typedef struct
    systime_t timeout;                 ///<Retransmission timeout
    systime_t maxTimeout;              ///<Maximum retransmission timeout
    uint_t retransmitCount;            ///<Retransmission counter
+#if (DNS_PREFETCH_SUPPORT == ENABLED)
+   bool_t prefetch;                   ///<The entry is being refreshed
+   systime_t prefetchTimestamp;       ///<Time at which the refresh query was sent
+#endif
 } DnsCacheEntry;
 
 
@@ -118,6 +169,8 @@ error_t dnsInit(void);
 void dnsFlushCache(NetInterface *interface);
 
 DnsCacheEntry *dnsCreateEntry(void);
+void dnsAddEntry(DnsCacheEntry *entry);
+void dnsUnlinkEntry(DnsCacheEntry *entry);
 void dnsDeleteEntry(DnsCacheEntry *entry);
 
 DnsCacheEntry *dnsFindEntry(NetInterface *interface,
@@ -125,6 +178,8 @@ DnsCacheEntry *dnsFindEntry(NetInterface *interface,
 
 void dnsTick(void);
 
+uint_t dnsHashName(const char_t *name);
+
 //C++ guard
 #ifdef __cplusplus
 }
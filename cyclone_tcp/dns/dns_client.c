@@ -39,6 +39,11 @@
 //Check TCP/IP stack configuration
 #if (DNS_CLIENT_SUPPORT == ENABLED)
 
+#if (DNS_CLIENT_ASYNC_SUPPORT == ENABLED)
+//Pending asynchronous requests
+DnsClientRequest dnsRequestTable[DNS_CLIENT_MAX_ASYNC_REQUESTS];
+#endif
+
 
 /**
  * @brief Resolve a host name using DNS
@@ -79,69 +84,28 @@ error_t dnsResolve(NetInterface *interface, const char_t *name,
          //Successful host name resolution
          error = NO_ERROR;
       }
+#if (DNS_NEGATIVE_CACHE_SUPPORT == ENABLED)
+      else if(entry->state == DNS_STATE_NEGATIVE)
+      {
+         //The host name is known not to exist
+         error = ERROR_NAME_RESOLUTION_FAILED;
+      }
+#endif
       else
       {
          //Host name resolution is in progress
          error = ERROR_IN_PROGRESS;
       }
+
+#if (DNS_PREFETCH_SUPPORT == ENABLED)
+      //Refresh the entry if it is about to expire
+      dnsPrefetchEntry(entry);
+#endif
    }
    else
    {
-      //If no entry exists, then create a new one
-      entry = dnsCreateEntry();
-
-      //Record the host name whose IP address is unknown
-      osStrcpy(entry->name, name);
-
-      //Initialize DNS cache entry
-      entry->type = type;
-      entry->protocol = HOST_NAME_RESOLVER_DNS;
-      entry->interface = interface;
-
-      //Select primary DNS server
-      entry->dnsServerIndex = 0;
-
-      //Get an ephemeral port number
-      entry->port = udpGetDynamicPort();
-
-      //An identifier is used by the DNS client to match replies with
-      //corresponding requests
-      entry->id = (uint16_t) netGenerateRand();
-
-      //Callback function to be called when a DNS response is received
-      error = udpAttachRxCallback(interface, entry->port, dnsProcessResponse,
-         NULL);
-
-      //Check status code
-      if(!error)
-      {
-         //Initialize retransmission counter
-         entry->retransmitCount = DNS_CLIENT_MAX_RETRIES;
-         //Send DNS query
-         error = dnsSendQuery(entry);
-
-         //DNS message successfully sent?
-         if(!error)
-         {
-            //Save the time at which the query message was sent
-            entry->timestamp = osGetSystemTime();
-            //Set timeout value
-            entry->timeout = DNS_CLIENT_INIT_TIMEOUT;
-            entry->maxTimeout = DNS_CLIENT_MAX_TIMEOUT;
-            //Decrement retransmission counter
-            entry->retransmitCount--;
-
-            //Switch state
-            entry->state = DNS_STATE_IN_PROGRESS;
-            //Host name resolution is in progress
-            error = ERROR_IN_PROGRESS;
-         }
-         else
-         {
-            //Unregister callback function
-            udpDetachRxCallback(interface, entry->port);
-         }
-      }
+      //If no entry exists, then send a new query
+      error = dnsStartQuery(interface, name, type);
    }
 
    //Release exclusive access
@@ -174,6 +138,13 @@ error_t dnsResolve(NetInterface *interface, const char_t *name,
             //Successful host name resolution
             error = NO_ERROR;
          }
+#if (DNS_NEGATIVE_CACHE_SUPPORT == ENABLED)
+         else if(entry->state == DNS_STATE_NEGATIVE)
+         {
+            //The host name does not exist
+            error = ERROR_NAME_RESOLUTION_FAILED;
+         }
+#endif
       }
       else
       {
@@ -206,6 +177,332 @@ error_t dnsResolve(NetInterface *interface, const char_t *name,
 }
 
 
+/**
+ * @brief Start resolving a host name using DNS
+ * @param[in] interface Underlying network interface
+ * @param[in] name Name of the host to be resolved
+ * @param[in] type Host type (IPv4 or IPv6)
+ * @return Error code (ERROR_IN_PROGRESS if the query has been sent)
+ **/
+
+error_t dnsStartQuery(NetInterface *interface, const char_t *name,
+   HostType type)
+{
+   error_t error;
+   DnsCacheEntry *entry;
+
+   //Create a new entry in the DNS cache
+   entry = dnsCreateEntry();
+
+   //Record the host name whose IP address is unknown
+   osStrcpy(entry->name, name);
+   //Index the entry by domain name
+   dnsAddEntry(entry);
+
+   //Initialize DNS cache entry
+   entry->type = type;
+   entry->protocol = HOST_NAME_RESOLVER_DNS;
+   entry->interface = interface;
+
+   //Select primary DNS server
+   entry->dnsServerIndex = 0;
+
+   //Get an ephemeral port number
+   entry->port = udpGetDynamicPort();
+
+   //An identifier is used by the DNS client to match replies with
+   //corresponding requests
+   entry->id = (uint16_t) netGenerateRand();
+
+   //Callback function to be called when a DNS response is received
+   error = udpAttachRxCallback(interface, entry->port, dnsProcessResponse,
+      NULL);
+
+   //Check status code
+   if(!error)
+   {
+      //Initialize retransmission counter
+      entry->retransmitCount = DNS_CLIENT_MAX_RETRIES;
+      //Send DNS query
+      error = dnsSendQuery(entry);
+
+      //DNS message successfully sent?
+      if(!error)
+      {
+         //Save the time at which the query message was sent
+         entry->timestamp = osGetSystemTime();
+         //Set timeout value
+         entry->timeout = DNS_CLIENT_INIT_TIMEOUT;
+         entry->maxTimeout = DNS_CLIENT_MAX_TIMEOUT;
+         //Decrement retransmission counter
+         entry->retransmitCount--;
+
+         //Switch state
+         entry->state = DNS_STATE_IN_PROGRESS;
+         //Host name resolution is in progress
+         error = ERROR_IN_PROGRESS;
+      }
+      else
+      {
+         //Unregister callback function
+         udpDetachRxCallback(interface, entry->port);
+      }
+   }
+
+   //Return status code
+   return error;
+}
+
+
+#if (DNS_CLIENT_ASYNC_SUPPORT == ENABLED)
+
+/**
+ * @brief Resolve a host name using DNS without blocking
+ *
+ * If the host name is already in the DNS cache, the IP address is returned
+ * immediately. Otherwise ERROR_IN_PROGRESS is returned and the callback
+ * function is invoked, from the context of the TCP/IP stack, once the name
+ * resolution completes. Concurrent requests for the same host name share a
+ * single DNS query. The callback runs with the stack mutex held and must not
+ * call any resolver API
+ *
+ * @param[in] interface Underlying network interface
+ * @param[in] name Name of the host to be resolved
+ * @param[in] type Host type (IPv4 or IPv6)
+ * @param[out] ipAddr IP address corresponding to the specified host name
+ * @param[in] callback Callback function to be invoked on completion
+ * @param[in] param Callback function parameter
+ * @return Error code
+ **/
+
+error_t dnsResolveAsync(NetInterface *interface, const char_t *name,
+   HostType type, IpAddr *ipAddr, DnsResolveCallback callback, void *param)
+{
+   error_t error;
+   uint_t i;
+   DnsCacheEntry *entry;
+
+   //Check parameters
+   if(interface == NULL || name == NULL || ipAddr == NULL || callback == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Make sure the host name is not too long
+   if(osStrlen(name) > DNS_MAX_NAME_LEN)
+      return ERROR_INVALID_NAME;
+
+   //Get exclusive access
+   osAcquireMutex(&netMutex);
+
+   //Search the DNS cache for the specified host name
+   entry = dnsFindEntry(interface, name, type, HOST_NAME_RESOLVER_DNS);
+
+   //Check whether a matching entry has been found
+   if(entry != NULL)
+   {
+      //Host name already resolved?
+      if(entry->state == DNS_STATE_RESOLVED ||
+         entry->state == DNS_STATE_PERMANENT)
+      {
+         //Return the corresponding IP address
+         *ipAddr = entry->ipAddr;
+         //Successful host name resolution
+         error = NO_ERROR;
+      }
+#if (DNS_NEGATIVE_CACHE_SUPPORT == ENABLED)
+      else if(entry->state == DNS_STATE_NEGATIVE)
+      {
+         //The host name is known not to exist
+         error = ERROR_NAME_RESOLUTION_FAILED;
+      }
+#endif
+      else
+      {
+         //Join the query that is already in progress
+         error = ERROR_IN_PROGRESS;
+      }
+
+#if (DNS_PREFETCH_SUPPORT == ENABLED)
+      //Refresh the entry if it is about to expire
+      dnsPrefetchEntry(entry);
+#endif
+   }
+   else
+   {
+      //If no entry exists, then send a new query
+      error = dnsStartQuery(interface, name, type);
+      //Retrieve the newly created entry
+      entry = dnsFindEntry(interface, name, type, HOST_NAME_RESOLVER_DNS);
+   }
+
+   //Name resolution in progress?
+   if(error == ERROR_IN_PROGRESS && entry != NULL)
+   {
+      //Loop through the pending requests
+      for(i = 0; i < DNS_CLIENT_MAX_ASYNC_REQUESTS; i++)
+      {
+         //Check whether the current slot is free
+         if(dnsRequestTable[i].callback == NULL)
+            break;
+      }
+
+      //Any free slot?
+      if(i < DNS_CLIENT_MAX_ASYNC_REQUESTS)
+      {
+         //Register the callback function
+         dnsRequestTable[i].entry = entry;
+         dnsRequestTable[i].callback = callback;
+         dnsRequestTable[i].param = param;
+      }
+      else
+      {
+         //The query keeps running and will populate the cache
+         error = ERROR_OUT_OF_RESOURCES;
+      }
+   }
+
+   //Release exclusive access
+   osReleaseMutex(&netMutex);
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Cancel pending asynchronous requests
+ * @param[in] callback Callback function that was registered
+ * @param[in] param Callback function parameter that was registered
+ **/
+
+void dnsCancelAsync(DnsResolveCallback callback, void *param)
+{
+   uint_t i;
+
+   //Get exclusive access
+   osAcquireMutex(&netMutex);
+
+   //Loop through the pending requests
+   for(i = 0; i < DNS_CLIENT_MAX_ASYNC_REQUESTS; i++)
+   {
+      //Matching request?
+      if(dnsRequestTable[i].callback == callback &&
+         dnsRequestTable[i].param == param)
+      {
+         //Release the slot
+         osMemset(&dnsRequestTable[i], 0, sizeof(DnsClientRequest));
+      }
+   }
+
+   //Release exclusive access
+   osReleaseMutex(&netMutex);
+}
+
+
+/**
+ * @brief Notify the requests waiting for a DNS cache entry
+ * @param[in] entry Pointer to the DNS cache entry
+ * @param[in] error Outcome of the name resolution
+ **/
+
+void dnsNotifyRequests(DnsCacheEntry *entry, error_t error)
+{
+   uint_t i;
+   IpAddr ipAddr;
+   DnsResolveCallback callback;
+   void *param;
+
+   //Save the resolved address
+   ipAddr = entry->ipAddr;
+
+   //Loop through the pending requests
+   for(i = 0; i < DNS_CLIENT_MAX_ASYNC_REQUESTS; i++)
+   {
+      //Check whether the request is waiting for the specified entry
+      if(dnsRequestTable[i].callback != NULL &&
+         dnsRequestTable[i].entry == entry)
+      {
+         //Retrieve the callback function
+         callback = dnsRequestTable[i].callback;
+         param = dnsRequestTable[i].param;
+
+         //Release the slot
+         osMemset(&dnsRequestTable[i], 0, sizeof(DnsClientRequest));
+
+         //Invoke user callback function
+         callback(error, error ? NULL : &ipAddr, param);
+      }
+   }
+}
+
+#endif
+#if (DNS_PREFETCH_SUPPORT == ENABLED)
+
+/**
+ * @brief Refresh a DNS cache entry before it expires
+ *
+ * Entries that are still in use when less than DNS_PREFETCH_THRESHOLD percent
+ * of their lifetime remains are queried again in the background, while the
+ * cached address keeps being served
+ *
+ * @param[in] entry Pointer to the DNS cache entry
+ **/
+
+void dnsPrefetchEntry(DnsCacheEntry *entry)
+{
+   error_t error;
+   systime_t time;
+
+   //Only resolved entries can be refreshed
+   if(entry->state != DNS_STATE_RESOLVED)
+      return;
+
+   //Refresh already in progress?
+   if(entry->prefetch)
+      return;
+
+   //Get current time
+   time = osGetSystemTime();
+
+   //Check the remaining lifetime of the entry
+   if(timeCompare(time, entry->timestamp + entry->timeout -
+      entry->timeout / 100 * DNS_PREFETCH_THRESHOLD) < 0)
+   {
+      return;
+   }
+
+   //Get an ephemeral port number
+   entry->port = udpGetDynamicPort();
+   //Generate a new identifier
+   entry->id = (uint16_t) netGenerateRand();
+
+   //Callback function to be called when a DNS response is received
+   error = udpAttachRxCallback(entry->interface, entry->port,
+      dnsProcessResponse, NULL);
+
+   //Check status code
+   if(!error)
+   {
+      //Send DNS query to the server that provided the cached address
+      error = dnsSendQuery(entry);
+
+      //DNS message successfully sent?
+      if(!error)
+      {
+         //Save the time at which the query message was sent
+         entry->prefetchTimestamp = time;
+         //The entry is being refreshed
+         entry->prefetch = TRUE;
+      }
+      else
+      {
+         //Unregister callback function
+         udpDetachRxCallback(entry->interface, entry->port);
+      }
+   }
+}
+
+#endif
+
 /**
  * @brief Send a DNS query message
  * @param[in] entry Pointer to a valid DNS cache entry
@@ -385,6 +682,11 @@ void dnsProcessResponse(NetInterface *interface,
    uint_t j;
    size_t pos;
    size_t length;
+#if (DNS_NEGATIVE_CACHE_SUPPORT == ENABLED)
+   size_t n;
+#endif
+   bool_t pending;
+   bool_t resolved;
    DnsHeader *message;
    DnsQuestion *question;
    DnsResourceRecord *record;
@@ -424,9 +726,19 @@ void dnsProcessResponse(NetInterface *interface,
       //Point to the current entry
       entry = &dnsCache[i];
 
+      //Check whether a query is outstanding
+      pending = (entry->state == DNS_STATE_IN_PROGRESS);
+
+#if (DNS_PREFETCH_SUPPORT == ENABLED)
+      //The entry may be refreshed in the background
+      if(entry->prefetch)
+      {
+         pending = TRUE;
+      }
+#endif
+
       //DNS name resolution in progress?
-      if(entry->state == DNS_STATE_IN_PROGRESS &&
-         entry->protocol == HOST_NAME_RESOLVER_DNS)
+      if(pending && entry->protocol == HOST_NAME_RESOLVER_DNS)
       {
          //Check destination port number
          if(entry->port == ntohs(udpHeader->destPort))
@@ -471,17 +783,49 @@ void dnsProcessResponse(NetInterface *interface,
                break;
             }
 
+            //Point to the first answer
+            pos += sizeof(DnsQuestion);
+
+#if (DNS_NEGATIVE_CACHE_SUPPORT == ENABLED)
+            //Save the offset of the answer section
+            n = pos;
+#endif
+
             //Check response code
             if(message->rcode != DNS_RCODE_NOERROR)
             {
+#if (DNS_PREFETCH_SUPPORT == ENABLED)
+               //Background refresh?
+               if(entry->prefetch)
+               {
+                  //Keep using the cached address until it expires
+                  udpDetachRxCallback(interface, entry->port);
+                  entry->prefetch = FALSE;
+                  //Exit immediately
+                  break;
+               }
+#endif
+#if (DNS_NEGATIVE_CACHE_SUPPORT == ENABLED)
+               //The domain name does not exist?
+               if(message->rcode == DNS_RCODE_NXDOMAIN)
+               {
+                  //Cache the negative response
+                  if(!dnsProcessNegativeResponse(interface, entry, message,
+                     length, pos))
+                  {
+                     //Exit immediately
+                     break;
+                  }
+               }
+#endif
                //Select the next DNS server
                dnsSelectNextServer(entry);
                //Exit immediately
                break;
             }
 
-            //Point to the first answer
-            pos += sizeof(DnsQuestion);
+            //No address found yet
+            resolved = FALSE;
 
             //Parse answer resource records
             for(j = 0; j < ntohs(message->ancount); j++)
@@ -530,6 +874,7 @@ void dnsProcessResponse(NetInterface *interface,
                      udpDetachRxCallback(interface, entry->port);
                      //Host name successfully resolved
                      entry->state = DNS_STATE_RESOLVED;
+                     resolved = TRUE;
                      //Exit immediately
                      break;
                   }
@@ -562,6 +907,7 @@ void dnsProcessResponse(NetInterface *interface,
                      udpDetachRxCallback(interface, entry->port);
                      //Host name successfully resolved
                      entry->state = DNS_STATE_RESOLVED;
+                     resolved = TRUE;
                      //Exit immediately
                      break;
                   }
@@ -571,6 +917,36 @@ void dnsProcessResponse(NetInterface *interface,
                pos += ntohs(record->rdlength);
             }
 
+            //Host name successfully resolved?
+            if(resolved)
+            {
+#if (DNS_PREFETCH_SUPPORT == ENABLED)
+               //The entry has been refreshed
+               entry->prefetch = FALSE;
+#endif
+#if (DNS_CLIENT_ASYNC_SUPPORT == ENABLED)
+               //Notify the pending requests
+               dnsNotifyRequests(entry, NO_ERROR);
+#endif
+            }
+#if (DNS_PREFETCH_SUPPORT == ENABLED)
+            else if(entry->prefetch)
+            {
+               //Keep using the cached address until it expires
+               udpDetachRxCallback(interface, entry->port);
+               entry->prefetch = FALSE;
+            }
+#endif
+#if (DNS_NEGATIVE_CACHE_SUPPORT == ENABLED)
+            else
+            {
+               //The name exists but has no address of the requested type
+               //(refer to RFC 2308, section 2.2)
+               dnsProcessNegativeResponse(interface, entry, message, length,
+                  n);
+            }
+#endif
+
             //We are done
             break;
          }
@@ -579,6 +955,99 @@ void dnsProcessResponse(NetInterface *interface,
 }
 
 
+#if (DNS_NEGATIVE_CACHE_SUPPORT == ENABLED)
+
+/**
+ * @brief Cache a negative DNS response
+ *
+ * The lifetime of the negative entry is the minimum of the TTL of the SOA
+ * record found in the authority section and of its MINIMUM field. Negative
+ * responses without SOA record are not cached (refer to RFC 2308, section 5)
+ *
+ * @param[in] interface Underlying network interface
+ * @param[in] entry Pointer to the DNS cache entry
+ * @param[in] message Pointer to the DNS response message
+ * @param[in] length Length of the DNS response message
+ * @param[in] pos Offset of the answer section
+ * @return Error code
+ **/
+
+error_t dnsProcessNegativeResponse(NetInterface *interface,
+   DnsCacheEntry *entry, const DnsHeader *message, size_t length, size_t pos)
+{
+   uint_t i;
+   size_t n;
+   uint32_t ttl;
+   DnsResourceRecord *record;
+
+   //Parse the resource records of the answer and authority sections
+   for(i = 0; i < (uint_t) (ntohs(message->ancount) + ntohs(message->nscount)); i++)
+   {
+      //Parse domain name
+      pos = dnsParseName(message, length, pos, NULL, 0);
+      //Invalid name?
+      if(!pos)
+         return ERROR_INVALID_MESSAGE;
+
+      //Make sure the resource record is valid
+      if((pos + sizeof(DnsResourceRecord)) > length)
+         return ERROR_INVALID_MESSAGE;
+
+      //Point to the associated resource record
+      record = DNS_GET_RESOURCE_RECORD(message, pos);
+      //Point to the resource data
+      pos += sizeof(DnsResourceRecord);
+
+      //Make sure the resource data is valid
+      if((pos + ntohs(record->rdlength)) > length)
+         return ERROR_INVALID_MESSAGE;
+
+      //SOA record found in the authority section?
+      if(i >= ntohs(message->ancount) &&
+         ntohs(record->rtype) == DNS_RR_TYPE_SOA &&
+         ntohs(record->rclass) == DNS_RR_CLASS_IN)
+      {
+         //Skip the MNAME and RNAME fields
+         n = dnsParseName(message, length, pos, NULL, 0);
+         n = (n != 0) ? dnsParseName(message, length, n, NULL, 0) : 0;
+
+         //The SERIAL, REFRESH, RETRY, EXPIRE and MINIMUM fields follow
+         if(n == 0 || (n + 20) > (pos + ntohs(record->rdlength)))
+            return ERROR_INVALID_MESSAGE;
+
+         //Retrieve the TTL of the negative response
+         ttl = MIN(ntohl(record->ttl), LOAD32BE((uint8_t *) message + n + 16));
+         //Limit the lifetime of negative entries
+         ttl = MIN(ttl, DNS_MAX_NEGATIVE_LIFETIME / 1000);
+
+         //Save current time
+         entry->timestamp = osGetSystemTime();
+         //Save TTL value
+         entry->timeout = MAX(ttl * 1000, DNS_MIN_LIFETIME);
+
+         //Unregister UDP callback function
+         udpDetachRxCallback(interface, entry->port);
+         //The host name does not exist
+         entry->state = DNS_STATE_NEGATIVE;
+
+#if (DNS_CLIENT_ASYNC_SUPPORT == ENABLED)
+         //Notify the pending requests
+         dnsNotifyRequests(entry, ERROR_NAME_RESOLUTION_FAILED);
+#endif
+         //Successful processing
+         return NO_ERROR;
+      }
+
+      //Point to the next resource record
+      pos += ntohs(record->rdlength);
+   }
+
+   //No SOA record found
+   return ERROR_NOT_FOUND;
+}
+
+#endif
+
 /**
  * @brief Select the next DNS server
  * @param[in] entry Pointer to a valid DNS cache entry
@@ -33,6 +33,7 @@
 #include "core/socket.h"
 #include "core/udp.h"
 #include "dns/dns_cache.h"
+#include "dns/dns_common.h"
 
 //DNS client support
 #ifndef DNS_CLIENT_SUPPORT
@@ -76,15 +77,68 @@
    #error DNS_MAX_LIFETIME parameter is not valid
 #endif
 
+//Asynchronous name resolution
+#ifndef DNS_CLIENT_ASYNC_SUPPORT
+   #define DNS_CLIENT_ASYNC_SUPPORT DISABLED
+#elif (DNS_CLIENT_ASYNC_SUPPORT != ENABLED && DNS_CLIENT_ASYNC_SUPPORT != DISABLED)
+   #error DNS_CLIENT_ASYNC_SUPPORT parameter is not valid
+#endif
+
+//Maximum number of pending asynchronous requests
+#ifndef DNS_CLIENT_MAX_ASYNC_REQUESTS
+   #define DNS_CLIENT_MAX_ASYNC_REQUESTS 8
+#elif (DNS_CLIENT_MAX_ASYNC_REQUESTS < 1)
+   #error DNS_CLIENT_MAX_ASYNC_REQUESTS parameter is not valid
+#endif
+
 //C++ guard
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+
+/**
+ * @brief Completion callback for asynchronous name resolution
+ *
+ * The callback is invoked with the TCP/IP stack mutex held. It must not call
+ * dnsResolveAsync, dnsCancelAsync or any other resolver API
+ **/
+
+typedef void (*DnsResolveCallback)(error_t error, const IpAddr *ipAddr,
+   void *param);
+
+
+/**
+ * @brief Pending asynchronous request
+ **/
+
+typedef struct
+{
+   DnsCacheEntry *entry;        ///<DNS cache entry the request is waiting for
+   DnsResolveCallback callback; ///<Completion callback
+   void *param;                 ///<Callback function parameter
+} DnsClientRequest;
+
+
+#if (DNS_CLIENT_ASYNC_SUPPORT == ENABLED)
+//Pending asynchronous requests
+extern DnsClientRequest dnsRequestTable[DNS_CLIENT_MAX_ASYNC_REQUESTS];
+#endif
+
 //DNS related functions
 error_t dnsResolve(NetInterface *interface, const char_t *name,
    HostType type, IpAddr *ipAddr);
 
+error_t dnsStartQuery(NetInterface *interface, const char_t *name,
+   HostType type);
+
+error_t dnsResolveAsync(NetInterface *interface, const char_t *name,
+   HostType type, IpAddr *ipAddr, DnsResolveCallback callback, void *param);
+
+void dnsCancelAsync(DnsResolveCallback callback, void *param);
+void dnsNotifyRequests(DnsCacheEntry *entry, error_t error);
+void dnsPrefetchEntry(DnsCacheEntry *entry);
+
 error_t dnsSendQuery(DnsCacheEntry *entry);
 
 void dnsProcessResponse(NetInterface *interface,
@@ -92,6 +146,9 @@ void dnsProcessResponse(NetInterface *interface,
    const NetBuffer *buffer, size_t offset, const NetRxAncillary *ancillary,
    void *param);
 
+error_t dnsProcessNegativeResponse(NetInterface *interface,
+   DnsCacheEntry *entry, const DnsHeader *message, size_t length, size_t pos);
+
 void dnsSelectNextServer(DnsCacheEntry *entry);
 
 //C++ guard
@@ -0,0 +1,838 @@
+/**
+ * @file af_packet_driver.c
+ * @brief Linux AF_PACKET driver (TPACKET_V3 memory-mapped rings)
+ *
+ * @section License
+ *
+ * Copyright (C) 2010-2023 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneTCP Eval.
+ *
+ * This software is provided in source form for a short-term evaluation only. The
+ * evaluation license expires 90 days after the date you first download the software.
+ *
+ * If you plan to use this software in a commercial product, you are required to
+ * purchase a commercial license from Oryx Embedded SARL.
+ *
+ * After the 90-day evaluation period, you agree to either purchase a commercial
+ * license or delete all copies of this software. If you wish to extend the
+ * evaluation period, you must contact sales@oryx-embedded.com.
+ *
+ * This evaluation software is provided "as is" without warranty of any kind.
+ * Technical support is available as an option during the evaluation period.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.3.2
+ **/
+
+
+//Switch to the appropriate trace level
+#define TRACE_LEVEL NIC_TRACE_LEVEL
+
+//Dependencies
+#include "core/net.h"
+#include "drivers/af_packet/af_packet_driver.h"
+#include "debug.h"
+
+//Undefine conflicting definitions
+#undef Socket
+#undef htons
+#undef htonl
+#undef ntohs
+#undef ntohl
+
+//With _GNU_SOURCE, glibc's <errno.h> declares an error_t type that
+//conflicts with the one defined by the TCP/IP stack
+#ifndef __error_t_defined
+   #define __error_t_defined 1
+#endif
+
+//Linux dependencies
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+
+//Undefine conflicting definitions
+#undef interface
+
+//Headroom reserved in front of received frames (room for a VLAN tag)
+#define AF_PACKET_DRIVER_RX_RESERVE 4
+//Offset of the frame data within a transmit slot
+#define AF_PACKET_DRIVER_TX_DATA_OFFSET TPACKET_ALIGN(sizeof(struct tpacket3_hdr))
+//Number of slots in the transmit ring
+#define AF_PACKET_DRIVER_TX_FRAME_COUNT (AF_PACKET_DRIVER_TX_BLOCK_COUNT * \
+   (AF_PACKET_DRIVER_BLOCK_SIZE / AF_PACKET_DRIVER_TX_FRAME_SIZE))
+
+
+/**
+ * @brief AF_PACKET driver context
+ **/
+
+typedef struct
+{
+   int_t fd;                ///<Packet socket
+   char_t name[IFNAMSIZ];   ///<Name of the host network device
+   uint8_t *rxRing;         ///<Receive ring (mapped)
+   uint8_t *txRing;         ///<Transmit ring (mapped)
+   size_t mapSize;          ///<Size of the mapped area
+   uint_t rxBlockIndex;     ///<Next receive block to be processed
+   bool_t rxBlockOpen;      ///<The current receive block is being processed
+   uint8_t *rxFrame;        ///<Next frame of the current receive block
+   uint_t rxFrameCount;     ///<Remaining frames in the current receive block
+   uint_t txFrameIndex;     ///<Next transmit slot to be filled
+   OsEvent rxEvent;         ///<Receive blocks have been released
+} AfPacketDriverContext;
+
+
+/**
+ * @brief AF_PACKET driver
+ **/
+
+const NicDriver afPacketDriver =
+{
+   NIC_TYPE_ETHERNET,
+   ETH_MTU,
+   afPacketDriverInit,
+   afPacketDriverTick,
+   afPacketDriverEnableIrq,
+   afPacketDriverDisableIrq,
+   afPacketDriverEventHandler,
+   afPacketDriverSendPacket,
+   afPacketDriverUpdateMacAddrFilter,
+   NULL,
+   NULL,
+   NULL,
+   TRUE,
+   TRUE,
+   TRUE,
+   TRUE,
+   FALSE,
+   afPacketDriverRxBurst,
+   afPacketDriverTxBurst
+};
+
+
+/**
+ * @brief AF_PACKET driver initialization
+ * @param[in] interface Underlying network interface
+ * @return Error code
+ **/
+
+error_t afPacketDriverInit(NetInterface *interface)
+{
+   error_t error;
+   int_t ret;
+   int_t value;
+   const char_t *name;
+   struct tpacket_req3 req;
+   struct sockaddr_ll addr;
+   struct packet_mreq mreq;
+   AfPacketDriverContext *context;
+#if (NET_RTOS_SUPPORT == ENABLED)
+   OsTaskId taskId;
+#endif
+
+   //Debug message
+   TRACE_INFO("Initializing AF_PACKET driver...\r\n");
+
+   //Allocate AF_PACKET driver context
+   context = (AfPacketDriverContext *) osAllocMem(sizeof(AfPacketDriverContext));
+   //Failed to allocate memory?
+   if(context == NULL)
+      return ERROR_OUT_OF_MEMORY;
+
+   //Attach the AF_PACKET driver context to the network interface
+   *((AfPacketDriverContext **) interface->nicContext) = context;
+   //Clear AF_PACKET driver context
+   osMemset(context, 0, sizeof(AfPacketDriverContext));
+
+   //Select the host network device
+   name = AF_PACKET_DRIVER_DEVICE_NAME;
+
+   //Default to the name of the network interface
+   if(name == NULL)
+   {
+      name = interface->name;
+   }
+
+   //Save the name of the host network device
+   osStrncpy(context->name, name, IFNAMSIZ - 1);
+
+   //The socket has not been opened yet
+   context->fd = -1;
+   //The rings have not been mapped yet
+   context->rxRing = MAP_FAILED;
+
+   //Create an event object to synchronize the receive task
+   if(!osCreateEvent(&context->rxEvent))
+   {
+      osFreeMem(context);
+      return ERROR_OUT_OF_RESOURCES;
+   }
+
+   //Start of exception handling block
+   do
+   {
+      //Open a packet socket
+      context->fd = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
+
+      //Failed to open socket?
+      if(context->fd < 0)
+      {
+         //Debug message
+         TRACE_ERROR("Failed to open packet socket (errno = %d)!\r\n", errno);
+         //Report an error
+         error = ERROR_OPEN_FAILED;
+         break;
+      }
+
+      //Use TPACKET_V3 so that the kernel retires whole blocks of frames
+      value = TPACKET_V3;
+      ret = setsockopt(context->fd, SOL_PACKET, PACKET_VERSION, &value,
+         sizeof(value));
+
+      //Any error to report?
+      if(ret < 0)
+      {
+         //Debug message
+         TRACE_ERROR("TPACKET_V3 is not supported!\r\n");
+         //Report an error
+         error = ERROR_FAILURE;
+         break;
+      }
+
+      //Reserve headroom in front of received frames
+      value = AF_PACKET_DRIVER_RX_RESERVE;
+      setsockopt(context->fd, SOL_PACKET, PACKET_RESERVE, &value,
+         sizeof(value));
+
+#ifdef PACKET_IGNORE_OUTGOING
+      //Frames sent by the host are of no interest
+      value = 1;
+      setsockopt(context->fd, SOL_PACKET, PACKET_IGNORE_OUTGOING, &value,
+         sizeof(value));
+#endif
+
+#ifdef PACKET_QDISC_BYPASS
+      //Hand outgoing frames directly to the device driver
+      value = 1;
+      setsockopt(context->fd, SOL_PACKET, PACKET_QDISC_BYPASS, &value,
+         sizeof(value));
+#endif
+
+      //Receive ring parameters
+      osMemset(&req, 0, sizeof(req));
+      req.tp_block_size = AF_PACKET_DRIVER_BLOCK_SIZE;
+      req.tp_block_nr = AF_PACKET_DRIVER_RX_BLOCK_COUNT;
+      req.tp_frame_size = AF_PACKET_DRIVER_TX_FRAME_SIZE;
+      req.tp_frame_nr = AF_PACKET_DRIVER_RX_BLOCK_COUNT *
+         (AF_PACKET_DRIVER_BLOCK_SIZE / AF_PACKET_DRIVER_TX_FRAME_SIZE);
+      req.tp_retire_blk_tov = AF_PACKET_DRIVER_BLOCK_TIMEOUT;
+
+      //Set up the receive ring
+      ret = setsockopt(context->fd, SOL_PACKET, PACKET_RX_RING, &req,
+         sizeof(req));
+
+      //Any error to report?
+      if(ret < 0)
+      {
+         //Debug message
+         TRACE_ERROR("Failed to set up receive ring (errno = %d)!\r\n", errno);
+         //Report an error
+         error = ERROR_FAILURE;
+         break;
+      }
+
+      //Transmit ring parameters
+      osMemset(&req, 0, sizeof(req));
+      req.tp_block_size = AF_PACKET_DRIVER_BLOCK_SIZE;
+      req.tp_block_nr = AF_PACKET_DRIVER_TX_BLOCK_COUNT;
+      req.tp_frame_size = AF_PACKET_DRIVER_TX_FRAME_SIZE;
+      req.tp_frame_nr = AF_PACKET_DRIVER_TX_FRAME_COUNT;
+
+      //Set up the transmit ring
+      ret = setsockopt(context->fd, SOL_PACKET, PACKET_TX_RING, &req,
+         sizeof(req));
+
+      //Any error to report?
+      if(ret < 0)
+      {
+         //Debug message
+         TRACE_ERROR("Failed to set up transmit ring (errno = %d)!\r\n", errno);
+         //Report an error
+         error = ERROR_FAILURE;
+         break;
+      }
+
+      //The transmit ring immediately follows the receive ring
+      context->mapSize = AF_PACKET_DRIVER_BLOCK_SIZE *
+         (AF_PACKET_DRIVER_RX_BLOCK_COUNT + AF_PACKET_DRIVER_TX_BLOCK_COUNT);
+
+      //Map both rings into the address space of the process
+      context->rxRing = mmap(NULL, context->mapSize, PROT_READ | PROT_WRITE,
+         MAP_SHARED, context->fd, 0);
+
+      //Failed to map the rings?
+      if(context->rxRing == MAP_FAILED)
+      {
+         //Debug message
+         TRACE_ERROR("Failed to map rings (errno = %d)!\r\n", errno);
+         //Report an error
+         error = ERROR_OUT_OF_MEMORY;
+         break;
+      }
+
+      //Point to the transmit ring
+      context->txRing = context->rxRing + AF_PACKET_DRIVER_BLOCK_SIZE *
+         AF_PACKET_DRIVER_RX_BLOCK_COUNT;
+
+      //Bind the socket to the host network device
+      osMemset(&addr, 0, sizeof(addr));
+      addr.sll_family = AF_PACKET;
+      addr.sll_protocol = htons(ETH_P_ALL);
+      addr.sll_ifindex = if_nametoindex(context->name);
+
+      //Unknown network device?
+      if(addr.sll_ifindex == 0)
+      {
+         //Debug message
+         TRACE_ERROR("Network device %s not found!\r\n", context->name);
+         //Report an error
+         error = ERROR_INVALID_INTERFACE;
+         break;
+      }
+
+      //Bind the socket
+      ret = bind(context->fd, (struct sockaddr *) &addr, sizeof(addr));
+
+      //Any error to report?
+      if(ret < 0)
+      {
+         //Debug message
+         TRACE_ERROR("Failed to bind packet socket (errno = %d)!\r\n", errno);
+         //Report an error
+         error = ERROR_FAILURE;
+         break;
+      }
+
+      //The MAC address of the interface differs from that of the host
+      //network device, hence promiscuous mode is required
+      osMemset(&mreq, 0, sizeof(mreq));
+      mreq.mr_ifindex = addr.sll_ifindex;
+      mreq.mr_type = PACKET_MR_PROMISC;
+
+      //Enable promiscuous mode
+      ret = setsockopt(context->fd, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &mreq,
+         sizeof(mreq));
+
+      //Any error to report?
+      if(ret < 0)
+      {
+         //Debug message
+         TRACE_ERROR("Failed to enable promiscuous mode!\r\n");
+         //Report an error
+         error = ERROR_FAILURE;
+         break;
+      }
+
+#if (NET_RTOS_SUPPORT == ENABLED)
+      //Create the receive task
+      taskId = osCreateTask("AF_PACKET", (OsTaskCode) afPacketDriverTask,
+         interface, NULL);
+
+      //Failed to create the task?
+      if(taskId == OS_INVALID_TASK_ID)
+      {
+         //Debug message
+         TRACE_ERROR("Failed to create task!\r\n");
+         //Report an error
+         error = ERROR_OUT_OF_RESOURCES;
+         break;
+      }
+#endif
+
+      //Successful initialization
+      error = NO_ERROR;
+
+      //End of exception handling block
+   } while(0);
+
+   //Check status code
+   if(!error)
+   {
+      //Accept any packets from the upper layer
+      osSetEvent(&interface->nicTxEvent);
+   }
+   else
+   {
+      //Clean up side effects
+      if(context->rxRing != MAP_FAILED)
+      {
+         munmap(context->rxRing, context->mapSize);
+      }
+
+      if(context->fd >= 0)
+      {
+         close(context->fd);
+      }
+
+      osDeleteEvent(&context->rxEvent);
+      osFreeMem(context);
+   }
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief AF_PACKET timer handler
+ *
+ * This routine is periodically called by the TCP/IP stack to track the
+ * operational state of the host network device
+ *
+ * @param[in] interface Underlying network interface
+ **/
+
+void afPacketDriverTick(NetInterface *interface)
+{
+   int_t ret;
+   bool_t linkState;
+   struct ifreq ifr;
+   AfPacketDriverContext *context;
+
+   //Point to the AF_PACKET driver context
+   context = *((AfPacketDriverContext **) interface->nicContext);
+
+   //Retrieve the flags of the host network device
+   osMemset(&ifr, 0, sizeof(ifr));
+   osStrcpy(ifr.ifr_name, context->name);
+   ret = ioctl(context->fd, SIOCGIFFLAGS, &ifr);
+
+   //Check status code
+   if(ret == 0)
+   {
+      //The link is up when the device is administratively and operationally up
+      if((ifr.ifr_flags & IFF_UP) != 0 && (ifr.ifr_flags & IFF_RUNNING) != 0)
+      {
+         linkState = TRUE;
+      }
+      else
+      {
+         linkState = FALSE;
+      }
+
+      //Link state change detected?
+      if(linkState != interface->linkState)
+      {
+         //Update link state
+         interface->linkState = linkState;
+
+         //Link up?
+         if(linkState)
+         {
+            //The actual speed of the host network device is not relevant
+            interface->linkSpeed = NIC_LINK_SPEED_1GBPS;
+            interface->duplexMode = NIC_FULL_DUPLEX_MODE;
+         }
+
+         //Process link state change event
+         nicNotifyLinkChange(interface);
+      }
+   }
+}
+
+
+/**
+ * @brief Enable interrupts
+ * @param[in] interface Underlying network interface
+ **/
+
+void afPacketDriverEnableIrq(NetInterface *interface)
+{
+   //Not implemented
+}
+
+
+/**
+ * @brief Disable interrupts
+ * @param[in] interface Underlying network interface
+ **/
+
+void afPacketDriverDisableIrq(NetInterface *interface)
+{
+   //Not implemented
+}
+
+
+/**
+ * @brief AF_PACKET event handler
+ * @param[in] interface Underlying network interface
+ **/
+
+void afPacketDriverEventHandler(NetInterface *interface)
+{
+   uint_t n;
+   AfPacketDriverContext *context;
+   NicRxFrame frames[NIC_BURST_SIZE];
+
+   //Point to the AF_PACKET driver context
+   context = *((AfPacketDriverContext **) interface->nicContext);
+
+   //Process all the frames that are pending in the receive ring
+   do
+   {
+      //Retrieve the next burst of frames
+      n = afPacketDriverRxBurst(interface, frames, NIC_BURST_SIZE);
+      //Pass the frames to the upper layer
+      nicProcessBurst(interface, frames, n);
+
+      //Loop until the receive ring is empty
+   } while(n > 0);
+
+   //Notify the receive task that the blocks have been released
+   osSetEvent(&context->rxEvent);
+}
+
+
+/**
+ * @brief Retrieve a burst of received frames
+ *
+ * Frames are returned straight out of the receive ring. A block is handed
+ * back to the kernel on the call that follows the delivery of its last frame
+ *
+ * @param[in] interface Underlying network interface
+ * @param[out] frames Array where to store the received frames
+ * @param[in] size Maximum number of frames to return
+ * @return Number of frames returned
+ **/
+
+uint_t afPacketDriverRxBurst(NetInterface *interface, NicRxFrame *frames,
+   uint_t size)
+{
+   uint_t n;
+   uint16_t tpid;
+   size_t length;
+   uint8_t *frame;
+   struct tpacket_block_desc *block;
+   struct tpacket3_hdr *header;
+   struct sockaddr_ll *addr;
+   AfPacketDriverContext *context;
+
+   //Point to the AF_PACKET driver context
+   context = *((AfPacketDriverContext **) interface->nicContext);
+
+   //Number of frames returned
+   n = 0;
+
+   //Loop until a frame is found or the receive ring is empty
+   while(n == 0)
+   {
+      //Point to the current block
+      block = (struct tpacket_block_desc *) (context->rxRing +
+         context->rxBlockIndex * AF_PACKET_DRIVER_BLOCK_SIZE);
+
+      //All the frames of the current block have been delivered?
+      if(context->rxBlockOpen && context->rxFrameCount == 0)
+      {
+         //The frames must be processed before the block is released
+         __sync_synchronize();
+         //Hand the block back to the kernel
+         block->hdr.bh1.block_status = TP_STATUS_KERNEL;
+
+         //Point to the next block
+         context->rxBlockIndex = (context->rxBlockIndex + 1) %
+            AF_PACKET_DRIVER_RX_BLOCK_COUNT;
+         context->rxBlockOpen = FALSE;
+
+         //Point to the next block
+         block = (struct tpacket_block_desc *) (context->rxRing +
+            context->rxBlockIndex * AF_PACKET_DRIVER_BLOCK_SIZE);
+      }
+
+      //No block being processed?
+      if(!context->rxBlockOpen)
+      {
+         //The block is still owned by the kernel?
+         if((block->hdr.bh1.block_status & TP_STATUS_USER) == 0)
+            break;
+
+         //Do not read the frames before the block status
+         __sync_synchronize();
+
+         //Point to the first frame of the block
+         context->rxFrame = (uint8_t *) block +
+            block->hdr.bh1.offset_to_first_pkt;
+         context->rxFrameCount = block->hdr.bh1.num_pkts;
+         context->rxBlockOpen = TRUE;
+      }
+
+      //Loop through the remaining frames of the block
+      while(n < size && context->rxFrameCount > 0)
+      {
+         //Point to the frame header
+         header = (struct tpacket3_hdr *) context->rxFrame;
+
+         //The link-level address information follows the frame header
+         addr = (struct sockaddr_ll *) ((uint8_t *) header +
+            TPACKET_ALIGN(sizeof(struct tpacket3_hdr)));
+
+         //Discard frames sent by the host and frames received while the link
+         //is down
+         if(addr->sll_pkttype != PACKET_OUTGOING && interface->linkState)
+         {
+            //Point to the frame
+            frame = (uint8_t *) header + header->tp_mac;
+            length = header->tp_snaplen;
+
+            //The kernel strips the VLAN tag of incoming frames. Put it back in
+            //place, using the headroom that precedes the frame
+            if((header->tp_status & TP_STATUS_VLAN_VALID) != 0 &&
+               length >= sizeof(EthHeader))
+            {
+#ifdef TP_STATUS_VLAN_TPID_VALID
+               //Retrieve the TPID of the tag
+               if((header->tp_status & TP_STATUS_VLAN_TPID_VALID) != 0)
+               {
+                  tpid = header->hv1.tp_vlan_tpid;
+               }
+               else
+#endif
+               {
+                  tpid = ETH_TYPE_VLAN;
+               }
+
+               //Make room for the tag
+               frame -= sizeof(VlanTag);
+               osMemmove(frame, frame + sizeof(VlanTag), 2 * sizeof(MacAddr));
+
+               //Insert the tag
+               STORE16BE(tpid, frame + 2 * sizeof(MacAddr));
+               STORE16BE(header->hv1.tp_vlan_tci, frame + 2 * sizeof(MacAddr) + 2);
+
+               //Adjust the length of the frame
+               length += sizeof(VlanTag);
+            }
+
+            //Return the frame
+            frames[n].data = frame;
+            frames[n].length = length;
+            frames[n].ancillary = NET_DEFAULT_RX_ANCILLARY;
+            n++;
+         }
+
+         //Point to the next frame
+         context->rxFrame += header->tp_next_offset;
+         context->rxFrameCount--;
+      }
+   }
+
+   //Return the number of frames
+   return n;
+}
+
+
+/**
+ * @brief Send a packet
+ * @param[in] interface Underlying network interface
+ * @param[in] buffer Multi-part buffer containing the data to send
+ * @param[in] offset Offset to the first data byte
+ * @param[in] ancillary Additional options passed to the stack along with
+ *   the packet
+ * @return Error code
+ **/
+
+error_t afPacketDriverSendPacket(NetInterface *interface,
+   const NetBuffer *buffer, size_t offset, NetTxAncillary *ancillary)
+{
+   NicTxFrame frame;
+
+   //Describe the frame
+   frame.buffer = buffer;
+   frame.offset = offset;
+   frame.ancillary = ancillary;
+
+   //Send a burst of one frame
+   return afPacketDriverTxBurst(interface, &frame, 1);
+}
+
+
+/**
+ * @brief Send a burst of frames
+ *
+ * The frames are built directly in slots of the transmit ring, and the kernel
+ * is asked once to process all the pending slots
+ *
+ * @param[in] interface Underlying network interface
+ * @param[in] frames Array of frames to send
+ * @param[in] count Number of frames in the array
+ * @return Error code
+ **/
+
+error_t afPacketDriverTxBurst(NetInterface *interface,
+   const NicTxFrame *frames, uint_t count)
+{
+   error_t error;
+   uint_t i;
+   ssize_t ret;
+   size_t length;
+   struct tpacket3_hdr *header;
+   AfPacketDriverContext *context;
+
+   //Point to the AF_PACKET driver context
+   context = *((AfPacketDriverContext **) interface->nicContext);
+
+   //Initialize status code
+   error = NO_ERROR;
+
+   //Loop through the frames
+   for(i = 0; i < count; i++)
+   {
+      //Retrieve the length of the frame
+      length = netBufferGetLength(frames[i].buffer) - frames[i].offset;
+
+      //Check the frame length
+      if(length > (AF_PACKET_DRIVER_TX_FRAME_SIZE - AF_PACKET_DRIVER_TX_DATA_OFFSET))
+      {
+         //Discard the frame
+         error = ERROR_INVALID_LENGTH;
+         break;
+      }
+
+      //Point to the current slot
+      header = (struct tpacket3_hdr *) (context->txRing +
+         context->txFrameIndex * AF_PACKET_DRIVER_TX_FRAME_SIZE);
+
+      //The slot is still in use by the kernel?
+      if((header->tp_status & (TP_STATUS_SEND_REQUEST | TP_STATUS_SENDING)) != 0)
+      {
+         //Wait for the pending frames to be sent
+         send(context->fd, NULL, 0, 0);
+
+         //The slot could not be reclaimed?
+         if((header->tp_status & (TP_STATUS_SEND_REQUEST | TP_STATUS_SENDING)) != 0)
+         {
+            //Drop the remaining frames
+            error = ERROR_FAILURE;
+            break;
+         }
+      }
+
+      //Copy the frame to the slot
+      netBufferRead((uint8_t *) header + AF_PACKET_DRIVER_TX_DATA_OFFSET,
+         frames[i].buffer, frames[i].offset, length);
+
+      //Fill in the frame header
+      header->tp_len = length;
+      header->tp_snaplen = length;
+      header->tp_next_offset = 0;
+
+      //The frame must be written before the slot is handed to the kernel
+      __sync_synchronize();
+      header->tp_status = TP_STATUS_SEND_REQUEST;
+
+      //Point to the next slot
+      context->txFrameIndex = (context->txFrameIndex + 1) %
+         AF_PACKET_DRIVER_TX_FRAME_COUNT;
+   }
+
+   //Any frame queued?
+   if(i > 0)
+   {
+      //Ask the kernel to process the pending slots
+      ret = send(context->fd, NULL, 0, MSG_DONTWAIT);
+
+      //Check status code
+      if(ret < 0 && errno != EAGAIN && errno != ENOBUFS && !error)
+      {
+         error = ERROR_FAILURE;
+      }
+   }
+
+   //The transmitter can accept another packet
+   osSetEvent(&interface->nicTxEvent);
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Configure MAC address filtering
+ * @param[in] interface Underlying network interface
+ * @return Error code
+ **/
+
+error_t afPacketDriverUpdateMacAddrFilter(NetInterface *interface)
+{
+   //The device operates in promiscuous mode and the Ethernet layer filters
+   //incoming frames against the MAC filter table
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief AF_PACKET receive task
+ *
+ * The task sleeps until the kernel retires a block, then notifies the TCP/IP
+ * stack and waits for the block to be released
+ *
+ * @param[in] interface Underlying network interface
+ **/
+
+void afPacketDriverTask(NetInterface *interface)
+{
+   struct pollfd fds;
+   struct tpacket_block_desc *block;
+   AfPacketDriverContext *context;
+
+   //Point to the AF_PACKET driver context
+   context = *((AfPacketDriverContext **) interface->nicContext);
+
+   //Process events
+   while(1)
+   {
+      //Point to the next block to be processed by the TCP/IP stack
+      block = (struct tpacket_block_desc *) (context->rxRing +
+         context->rxBlockIndex * AF_PACKET_DRIVER_BLOCK_SIZE);
+
+      //Any block retired by the kernel?
+      if((block->hdr.bh1.block_status & TP_STATUS_USER) != 0)
+      {
+         //Set event flag
+         interface->nicEvent = TRUE;
+         //Notify the TCP/IP stack of the event
+         osSetEvent(&netEvent);
+
+#if (NET_RTOS_SUPPORT == ENABLED)
+         //Wait for the TCP/IP stack to release the block
+         osWaitForEvent(&context->rxEvent, AF_PACKET_DRIVER_POLL_TIMEOUT);
+#else
+         //Exit immediately
+         break;
+#endif
+      }
+      else
+      {
+         //Wait for the kernel to retire a block
+         fds.fd = context->fd;
+         fds.events = POLLIN | POLLERR;
+         fds.revents = 0;
+
+#if (NET_RTOS_SUPPORT == ENABLED)
+         poll(&fds, 1, AF_PACKET_DRIVER_POLL_TIMEOUT);
+#else
+         //No block has been retired
+         if(poll(&fds, 1, 0) <= 0)
+            break;
+#endif
+      }
+   }
+}
@@ -0,0 +1,120 @@
+/**
+ * @file af_packet_driver.h
+ * @brief Linux AF_PACKET driver (TPACKET_V3 memory-mapped rings)
+ *
+ * @section License
+ *
+ * Copyright (C) 2010-2023 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneTCP Eval.
+ *
+ * This software is provided in source form for a short-term evaluation only. The
+ * evaluation license expires 90 days after the date you first download the software.
+ *
+ * If you plan to use this software in a commercial product, you are required to
+ * purchase a commercial license from Oryx Embedded SARL.
+ *
+ * After the 90-day evaluation period, you agree to either purchase a commercial
+ * license or delete all copies of this software. If you wish to extend the
+ * evaluation period, you must contact sales@oryx-embedded.com.
+ *
+ * This evaluation software is provided "as is" without warranty of any kind.
+ * Technical support is available as an option during the evaluation period.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.3.2
+ **/
+
+
+#ifndef _AF_PACKET_DRIVER_H
+#define _AF_PACKET_DRIVER_H
+
+//Dependencies
+#include "core/nic.h"
+
+//Name of the host network device (the interface name is used by default)
+#ifndef AF_PACKET_DRIVER_DEVICE_NAME
+   #define AF_PACKET_DRIVER_DEVICE_NAME NULL
+#endif
+
+//Size of ring blocks (multiple of the page size)
+#ifndef AF_PACKET_DRIVER_BLOCK_SIZE
+   #define AF_PACKET_DRIVER_BLOCK_SIZE 65536
+#elif (AF_PACKET_DRIVER_BLOCK_SIZE < 4096 || \
+   (AF_PACKET_DRIVER_BLOCK_SIZE & (AF_PACKET_DRIVER_BLOCK_SIZE - 1)) != 0)
+   #error AF_PACKET_DRIVER_BLOCK_SIZE parameter is not valid
+#endif
+
+//Number of blocks in the receive ring
+#ifndef AF_PACKET_DRIVER_RX_BLOCK_COUNT
+   #define AF_PACKET_DRIVER_RX_BLOCK_COUNT 32
+#elif (AF_PACKET_DRIVER_RX_BLOCK_COUNT < 2)
+   #error AF_PACKET_DRIVER_RX_BLOCK_COUNT parameter is not valid
+#endif
+
+//Number of blocks in the transmit ring
+#ifndef AF_PACKET_DRIVER_TX_BLOCK_COUNT
+   #define AF_PACKET_DRIVER_TX_BLOCK_COUNT 4
+#elif (AF_PACKET_DRIVER_TX_BLOCK_COUNT < 1)
+   #error AF_PACKET_DRIVER_TX_BLOCK_COUNT parameter is not valid
+#endif
+
+//Size of transmit frame slots
+#ifndef AF_PACKET_DRIVER_TX_FRAME_SIZE
+   #define AF_PACKET_DRIVER_TX_FRAME_SIZE 2048
+#elif (AF_PACKET_DRIVER_TX_FRAME_SIZE < 128 || \
+   (AF_PACKET_DRIVER_TX_FRAME_SIZE & (AF_PACKET_DRIVER_TX_FRAME_SIZE - 1)) != 0)
+   #error AF_PACKET_DRIVER_TX_FRAME_SIZE parameter is not valid
+#endif
+
+//Maximum time a partially filled receive block is held by the kernel (ms)
+#ifndef AF_PACKET_DRIVER_BLOCK_TIMEOUT
+   #define AF_PACKET_DRIVER_BLOCK_TIMEOUT 1
+#elif (AF_PACKET_DRIVER_BLOCK_TIMEOUT < 1)
+   #error AF_PACKET_DRIVER_BLOCK_TIMEOUT parameter is not valid
+#endif
+
+//Polling timeout of the receive task (ms)
+#ifndef AF_PACKET_DRIVER_POLL_TIMEOUT
+   #define AF_PACKET_DRIVER_POLL_TIMEOUT 100
+#elif (AF_PACKET_DRIVER_POLL_TIMEOUT < 1)
+   #error AF_PACKET_DRIVER_POLL_TIMEOUT parameter is not valid
+#endif
+
+//C++ guard
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//AF_PACKET driver
+extern const NicDriver afPacketDriver;
+
+//AF_PACKET related functions
+error_t afPacketDriverInit(NetInterface *interface);
+
+void afPacketDriverTick(NetInterface *interface);
+
+void afPacketDriverEnableIrq(NetInterface *interface);
+void afPacketDriverDisableIrq(NetInterface *interface);
+
+void afPacketDriverEventHandler(NetInterface *interface);
+
+uint_t afPacketDriverRxBurst(NetInterface *interface, NicRxFrame *frames,
+   uint_t size);
+
+error_t afPacketDriverSendPacket(NetInterface *interface,
+   const NetBuffer *buffer, size_t offset, NetTxAncillary *ancillary);
+
+error_t afPacketDriverTxBurst(NetInterface *interface,
+   const NicTxFrame *frames, uint_t count);
+
+error_t afPacketDriverUpdateMacAddrFilter(NetInterface *interface);
+
+void afPacketDriverTask(NetInterface *interface);
+
+//C++ guard
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -55,7 +55,7 @@ error_t arpInit(NetInterface *interface)
    interface->enableArp = TRUE;
 
    //Initialize the ARP cache
-   osMemset(interface->arpCache, 0, sizeof(interface->arpCache));
+   arpInitCache(interface);
 
    //Successful initialization
    return NO_ERROR;
@@ -137,7 +137,7 @@ error_t arpAddStaticEntry(NetInterface *interface, Ipv4Addr ipAddr,
    else
    {
       //Create a new entry in the ARP cache
-      entry = arpCreateEntry(interface);
+      entry = arpCreateEntry(interface, ipAddr);
    }
 
    //ARP cache entry successfully created?
@@ -198,7 +198,7 @@ error_t arpRemoveStaticEntry(NetInterface *interface, Ipv4Addr ipAddr)
    if(entry != NULL && entry->state == ARP_STATE_PERMANENT)
    {
       //Delete ARP entry
-      arpChangeState(entry, ARP_STATE_NONE);
+      arpDeleteEntry(interface, entry);
       //Successful processing
       error = NO_ERROR;
    }
@@ -238,8 +238,17 @@ error_t arpResolve(NetInterface *interface, Ipv4Addr ipAddr, MacAddr *macAddr)
       //Check the state of the ARP entry
       if(entry->state == ARP_STATE_INCOMPLETE)
       {
-         //The address resolution is already in progress
-         error = ERROR_IN_PROGRESS;
+         //Check whether address resolution has recently failed
+         if(entry->retransmitCount >= ARP_MAX_REQUESTS)
+         {
+            //Do not flood the link with requests for an unreachable host
+            error = ERROR_ADDRESS_NOT_FOUND;
+         }
+         else
+         {
+            //The address resolution is already in progress
+            error = ERROR_IN_PROGRESS;
+         }
       }
       else if(entry->state == ARP_STATE_STALE)
       {
@@ -269,14 +278,11 @@ error_t arpResolve(NetInterface *interface, Ipv4Addr ipAddr, MacAddr *macAddr)
       if(interface->enableArp)
       {
          //If no entry exists, then create a new one
-         entry = arpCreateEntry(interface);
+         entry = arpCreateEntry(interface, ipAddr);
 
          //ARP cache entry successfully created?
          if(entry != NULL)
          {
-            //Record the IPv4 address whose MAC address is unknown
-            entry->ipAddr = ipAddr;
-
             //Reset retransmission counter
             entry->retransmitCount = 0;
             //No packet are pending in the transmit queue
@@ -439,7 +445,12 @@ void arpTick(NetInterface *interface)
             entry->retransmitCount++;
 
             //Check whether the maximum number of retransmissions has been exceeded
-            if(entry->retransmitCount < ARP_MAX_REQUESTS)
+            if(entry->retransmitCount > ARP_MAX_REQUESTS)
+            {
+               //The negative cache entry has expired
+               arpDeleteEntry(interface, entry);
+            }
+            else if(entry->retransmitCount < ARP_MAX_REQUESTS)
             {
                //Retransmit ARP request
                arpSendRequest(interface, entry->ipAddr, &MAC_BROADCAST_ADDR);
@@ -454,8 +465,16 @@ void arpTick(NetInterface *interface)
                //Drop packets that are waiting for address resolution
                arpFlushQueuedPackets(interface, entry);
 
+#if (ARP_NEGATIVE_CACHE_TIME > 0)
+               //Remember the failure for a while so that subsequent packets
+               //to the same destination are rejected without sending any
+               //further request
+               entry->timestamp = time;
+               entry->timeout = ARP_NEGATIVE_CACHE_TIME;
+#else
                //The entry should be deleted since address resolution has failed
-               arpChangeState(entry, ARP_STATE_NONE);
+               arpDeleteEntry(interface, entry);
+#endif
             }
          }
       }
@@ -515,7 +534,7 @@ void arpTick(NetInterface *interface)
             {
                //The entry should be deleted since the host is not reachable
                //anymore
-               arpChangeState(entry, ARP_STATE_NONE);
+               arpDeleteEntry(interface, entry);
             }
          }
       }
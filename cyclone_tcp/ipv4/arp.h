@@ -45,6 +45,20 @@
    #error ARP_CACHE_SIZE parameter is not valid
 #endif
 
+//Hash-indexed ARP cache
+#ifndef ARP_CACHE_HASH_SUPPORT
+   #define ARP_CACHE_HASH_SUPPORT DISABLED
+#elif (ARP_CACHE_HASH_SUPPORT != ENABLED && ARP_CACHE_HASH_SUPPORT != DISABLED)
+   #error ARP_CACHE_HASH_SUPPORT parameter is not valid
+#endif
+
+//Size of the hash table used to index the ARP cache
+#ifndef ARP_HASH_TABLE_SIZE
+   #define ARP_HASH_TABLE_SIZE 64
+#elif (ARP_HASH_TABLE_SIZE < 1)
+   #error ARP_HASH_TABLE_SIZE parameter is not valid
+#endif
+
 //Maximum number of packets waiting for address resolution to complete
 #ifndef ARP_MAX_PENDING_PACKETS
    #define ARP_MAX_PENDING_PACKETS 2
@@ -94,6 +108,13 @@
    #error ARP_DELAY_FIRST_PROBE_TIME parameter is not valid
 #endif
 
+//Time during which a failed address resolution is remembered (0 to disable)
+#ifndef ARP_NEGATIVE_CACHE_TIME
+   #define ARP_NEGATIVE_CACHE_TIME 0
+#elif (ARP_NEGATIVE_CACHE_TIME < 0)
+   #error ARP_NEGATIVE_CACHE_TIME parameter is not valid
+#endif
+
 //Hardware type
 #define ARP_HARDWARE_TYPE_ETH 0x0001
 //Protocol type
@@ -182,7 +203,7 @@ typedef struct
  * @brief ARP cache entry
  **/
 
-typedef struct
+typedef struct _ArpCacheEntry
 {
    ArpState state;                              ///<Reachability state
    Ipv4Addr ipAddr;                             ///<Unicast IPv4 address
@@ -192,6 +213,11 @@ typedef struct
    uint_t retransmitCount;                      ///<Retransmission counter
    ArpQueueItem queue[ARP_MAX_PENDING_PACKETS]; ///<Packets waiting for address resolution to complete
    uint_t queueSize;                            ///<Number of queued packets
+#if (ARP_CACHE_HASH_SUPPORT == ENABLED)
+   struct _ArpCacheEntry *hashNext;             ///<Next entry in the same hash bucket
+   struct _ArpCacheEntry *lruPrev;              ///<Previous entry in the LRU list
+   struct _ArpCacheEntry *lruNext;              ///<Next entry in the LRU list
+#endif
 } ArpCacheEntry;
 
 
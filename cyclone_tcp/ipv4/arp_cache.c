@@ -57,14 +57,92 @@ void arpChangeState(ArpCacheEntry *entry, ArpState newState)
 }
 
 
+/**
+ * @brief Initialize the ARP cache
+ * @param[in] interface Underlying network interface
+ **/
+
+void arpInitCache(NetInterface *interface)
+{
+#if (ARP_CACHE_HASH_SUPPORT == ENABLED)
+   uint_t i;
+#endif
+
+   //Clear the ARP cache
+   osMemset(interface->arpCache, 0, sizeof(interface->arpCache));
+
+#if (ARP_CACHE_HASH_SUPPORT == ENABLED)
+   //Clear the hash table
+   osMemset(interface->arpHashTable, 0, sizeof(interface->arpHashTable));
+
+   //The LRU list is initially made of free entries only
+   interface->arpLruHead = NULL;
+   interface->arpLruTail = NULL;
+
+   //Link all the entries
+   for(i = 0; i < ARP_CACHE_SIZE; i++)
+   {
+      arpLinkLruEntry(interface, &interface->arpCache[i], FALSE);
+   }
+#endif
+}
+
+
 /**
  * @brief Create a new entry in the ARP cache
  * @param[in] interface Underlying network interface
+ * @param[in] ipAddr IPv4 address
  * @return Pointer to the newly created entry
  **/
 
-ArpCacheEntry *arpCreateEntry(NetInterface *interface)
+ArpCacheEntry *arpCreateEntry(NetInterface *interface, Ipv4Addr ipAddr)
 {
+#if (ARP_CACHE_HASH_SUPPORT == ENABLED)
+   uint_t i;
+   ArpCacheEntry *entry;
+
+   //Free entries are kept at the tail of the LRU list, followed by the least
+   //recently used entries. Static entries are never evicted
+   for(entry = interface->arpLruTail; entry != NULL; entry = entry->lruPrev)
+   {
+      //Dynamic or free entry?
+      if(entry->state != ARP_STATE_PERMANENT)
+         break;
+   }
+
+   //Any entry available in the ARP cache?
+   if(entry != NULL)
+   {
+      //Entry currently in use?
+      if(entry->state != ARP_STATE_NONE)
+      {
+         //Drop any pending packets
+         arpFlushQueuedPackets(interface, entry);
+         //The least recently used entry is removed whenever the table runs
+         //out of space
+         arpDeleteEntry(interface, entry);
+      }
+
+      //Remove the entry from the LRU list
+      arpUnlinkLruEntry(interface, entry);
+
+      //Initialize ARP entry
+      osMemset(entry, 0, sizeof(ArpCacheEntry));
+      //Record the IPv4 address
+      entry->ipAddr = ipAddr;
+
+      //Insert the entry in the hash table
+      i = arpHashAddr(ipAddr);
+      entry->hashNext = interface->arpHashTable[i];
+      interface->arpHashTable[i] = entry;
+
+      //The new entry is the most recently used one
+      arpLinkLruEntry(interface, entry, TRUE);
+   }
+
+   //Return a pointer to the ARP entry
+   return entry;
+#else
    uint_t i;
    systime_t time;
    ArpCacheEntry *entry;
@@ -87,6 +165,8 @@ ArpCacheEntry *arpCreateEntry(NetInterface *interface)
       {
          //Initialize ARP entry
          osMemset(entry, 0, sizeof(ArpCacheEntry));
+         //Record the IPv4 address
+         entry->ipAddr = ipAddr;
 
          //Return a pointer to the ARP entry
          return entry;
@@ -130,10 +210,13 @@ ArpCacheEntry *arpCreateEntry(NetInterface *interface)
       arpChangeState(oldestEntry, ARP_STATE_NONE);
       //Initialize ARP entry
       osMemset(oldestEntry, 0, sizeof(ArpCacheEntry));
+      //Record the IPv4 address
+      oldestEntry->ipAddr = ipAddr;
    }
 
    //Return a pointer to the ARP entry
    return oldestEntry;
+#endif
 }
 
 
@@ -147,6 +230,25 @@ ArpCacheEntry *arpCreateEntry(NetInterface *interface)
 
 ArpCacheEntry *arpFindEntry(NetInterface *interface, Ipv4Addr ipAddr)
 {
+#if (ARP_CACHE_HASH_SUPPORT == ENABLED)
+   ArpCacheEntry *entry;
+
+   //Walk through the corresponding hash bucket
+   for(entry = interface->arpHashTable[arpHashAddr(ipAddr)]; entry != NULL;
+      entry = entry->hashNext)
+   {
+      //Current entry matches the specified address?
+      if(entry->state != ARP_STATE_NONE && entry->ipAddr == ipAddr)
+      {
+         //Move the entry to the head of the LRU list
+         arpUnlinkLruEntry(interface, entry);
+         arpLinkLruEntry(interface, entry, TRUE);
+
+         //Return a pointer to the ARP entry
+         return entry;
+      }
+   }
+#else
    uint_t i;
    ArpCacheEntry *entry;
 
@@ -166,12 +268,50 @@ ArpCacheEntry *arpFindEntry(NetInterface *interface, Ipv4Addr ipAddr)
          }
       }
    }
+#endif
 
    //No matching entry in ARP cache
    return NULL;
 }
 
 
+/**
+ * @brief Delete an entry from the ARP cache
+ * @param[in] interface Underlying network interface
+ * @param[in] entry Pointer to a ARP cache entry
+ **/
+
+void arpDeleteEntry(NetInterface *interface, ArpCacheEntry *entry)
+{
+#if (ARP_CACHE_HASH_SUPPORT == ENABLED)
+   ArpCacheEntry **p;
+
+   //Remove the entry from its hash bucket
+   for(p = &interface->arpHashTable[arpHashAddr(entry->ipAddr)]; *p != NULL;
+      p = &(*p)->hashNext)
+   {
+      //Matching entry?
+      if(*p == entry)
+      {
+         *p = entry->hashNext;
+         break;
+      }
+   }
+
+   //Unlink the entry
+   entry->hashNext = NULL;
+
+   //Free entries are moved to the tail of the LRU list so that they are
+   //reused first
+   arpUnlinkLruEntry(interface, entry);
+   arpLinkLruEntry(interface, entry, FALSE);
+#endif
+
+   //Delete ARP entry
+   arpChangeState(entry, ARP_STATE_NONE);
+}
+
+
 /**
  * @brief Flush ARP cache
  * @param[in] interface Underlying network interface
@@ -199,7 +339,7 @@ void arpFlushCache(NetInterface *interface)
          arpFlushQueuedPackets(interface, entry);
 
          //Delete ARP entry
-         arpChangeState(entry, ARP_STATE_NONE);
+         arpDeleteEntry(interface, entry);
       }
    }
 }
@@ -270,4 +410,114 @@ void arpFlushQueuedPackets(NetInterface *interface, ArpCacheEntry *entry)
    entry->queueSize = 0;
 }
 
+#if (ARP_CACHE_HASH_SUPPORT == ENABLED)
+
+/**
+ * @brief Compute the hash table index of an IPv4 address
+ * @param[in] ipAddr IPv4 address
+ * @return Index of the hash bucket
+ **/
+
+uint_t arpHashAddr(Ipv4Addr ipAddr)
+{
+   uint32_t h;
+
+   //Convert the IPv4 address to host byte order
+   h = ntohl(ipAddr);
+
+   //Mix the bits so that consecutive host addresses are spread evenly
+   h ^= h >> 16;
+   h *= 0x45D9F3BUL;
+   h ^= h >> 16;
+
+   //Return the index of the hash bucket
+   return h % ARP_HASH_TABLE_SIZE;
+}
+
+
+/**
+ * @brief Insert an entry in the LRU list
+ * @param[in] interface Underlying network interface
+ * @param[in] entry Pointer to a ARP cache entry
+ * @param[in] head Insert the entry at the head (TRUE) or at the tail (FALSE)
+ *   of the list
+ **/
+
+void arpLinkLruEntry(NetInterface *interface, ArpCacheEntry *entry, bool_t head)
+{
+   //Insert at the head of the list?
+   if(head)
+   {
+      entry->lruPrev = NULL;
+      entry->lruNext = interface->arpLruHead;
+
+      //Update the link of the former head
+      if(interface->arpLruHead != NULL)
+      {
+         interface->arpLruHead->lruPrev = entry;
+      }
+      else
+      {
+         interface->arpLruTail = entry;
+      }
+
+      //The entry is now the most recently used one
+      interface->arpLruHead = entry;
+   }
+   else
+   {
+      entry->lruPrev = interface->arpLruTail;
+      entry->lruNext = NULL;
+
+      //Update the link of the former tail
+      if(interface->arpLruTail != NULL)
+      {
+         interface->arpLruTail->lruNext = entry;
+      }
+      else
+      {
+         interface->arpLruHead = entry;
+      }
+
+      //The entry is now the least recently used one
+      interface->arpLruTail = entry;
+   }
+}
+
+
+/**
+ * @brief Remove an entry from the LRU list
+ * @param[in] interface Underlying network interface
+ * @param[in] entry Pointer to a ARP cache entry
+ **/
+
+void arpUnlinkLruEntry(NetInterface *interface, ArpCacheEntry *entry)
+{
+   //Update the link of the previous entry
+   if(entry->lruPrev != NULL)
+   {
+      entry->lruPrev->lruNext = entry->lruNext;
+   }
+   else
+   {
+      interface->arpLruHead = entry->lruNext;
+   }
+
+   //Update the link of the next entry
+   if(entry->lruNext != NULL)
+   {
+      entry->lruNext->lruPrev = entry->lruPrev;
+   }
+   else
+   {
+      interface->arpLruTail = entry->lruPrev;
+   }
+
+   //Unlink the entry
+   entry->lruPrev = NULL;
+   entry->lruNext = NULL;
+}
+
+#endif
+
 #endif
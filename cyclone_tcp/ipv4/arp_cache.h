@@ -40,14 +40,23 @@ extern "C" {
 //ARP related functions
 void arpChangeState(ArpCacheEntry *entry, ArpState newState);
 
-ArpCacheEntry *arpCreateEntry(NetInterface *interface);
+void arpInitCache(NetInterface *interface);
+
+ArpCacheEntry *arpCreateEntry(NetInterface *interface, Ipv4Addr ipAddr);
 ArpCacheEntry *arpFindEntry(NetInterface *interface, Ipv4Addr ipAddr);
+void arpDeleteEntry(NetInterface *interface, ArpCacheEntry *entry);
 
 void arpFlushCache(NetInterface *interface);
 
 void arpSendQueuedPackets(NetInterface *interface, ArpCacheEntry *entry);
 void arpFlushQueuedPackets(NetInterface *interface, ArpCacheEntry *entry);
 
+#if (ARP_CACHE_HASH_SUPPORT == ENABLED)
+uint_t arpHashAddr(Ipv4Addr ipAddr);
+void arpLinkLruEntry(NetInterface *interface, ArpCacheEntry *entry, bool_t head);
+void arpUnlinkLruEntry(NetInterface *interface, ArpCacheEntry *entry);
+#endif
+
 //C++ guard
 #ifdef __cplusplus
 }
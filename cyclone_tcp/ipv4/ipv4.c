@@ -101,7 +101,7 @@ error_t ipv4Init(NetInterface *interface)
 
 #if (IPV4_FRAG_SUPPORT == ENABLED)
    //Initialize the reassembly queue
-   osMemset(context->fragQueue, 0, sizeof(context->fragQueue));
+   ipv4InitFragQueue(interface);
 #endif
 
    //Successful initialization
@@ -611,6 +611,12 @@ void ipv4ProcessPacket(NetInterface *interface, Ipv4Header *packet,
    IP_MIB_INC_COUNTER32(ipv4IfStatsTable[interface->index].ipIfStatsInOctets, length);
    IP_MIB_INC_COUNTER64(ipv4IfStatsTable[interface->index].ipIfStatsHCInOctets, length);
 
+#if (NET_LATENCY_SUPPORT == ENABLED)
+   //Time spent between the NIC and IP input
+   netLatencyCheckpoint(interface, NET_LATENCY_STAGE_LINK_RX,
+      &ancillary->latencyMark);
+#endif
+
    //Start of exception handling block
    do
    {
@@ -862,6 +868,12 @@ void ipv4ProcessDatagram(NetInterface *interface, const NetBuffer *buffer,
       return;
 #endif
 
+#if (NET_LATENCY_SUPPORT == ENABLED)
+   //Time spent in the IP layer
+   netLatencyCheckpoint(interface, NET_LATENCY_STAGE_IP_RX,
+      &ancillary->latencyMark);
+#endif
+
    //Check the protocol field
    switch(header->protocol)
    {
@@ -1010,6 +1022,11 @@ error_t ipv4SendDatagram(NetInterface *interface,
    IP_MIB_INC_COUNTER32(ipv4IfStatsTable[interface->index].ipIfStatsOutRequests, 1);
    IP_MIB_INC_COUNTER64(ipv4IfStatsTable[interface->index].ipIfStatsHCOutRequests, 1);
 
+#if (NET_LATENCY_SUPPORT == ENABLED)
+   //Start measuring the time spent on the TX path
+   ancillary->latencyMark = netLatencyGetTimestamp();
+#endif
+
    //Identification field is primarily used to identify fragments of an
    //original IP datagram
    id = interface->ipv4Context.identification++;
@@ -1037,6 +1054,18 @@ error_t ipv4SendDatagram(NetInterface *interface,
       error = ipv4SendPacket(interface, pseudoHeader, id, 0, buffer,
          offset, ancillary);
    }
+#if (NET_GSO_SUPPORT == ENABLED)
+   else if(ancillary->gsoSize != 0)
+   {
+      //The super-segment will be split into MSS-sized frames at the NIC
+      //boundary. Reserve one identification value per resulting frame
+      interface->ipv4Context.identification += (length - 1) / ancillary->gsoSize;
+
+      //Send the super-segment as a single packet
+      error = ipv4SendPacket(interface, pseudoHeader, id, 0, buffer,
+         offset, ancillary);
+   }
+#endif
    else
    {
 #if (IPV4_FRAG_SUPPORT == ENABLED)
@@ -376,7 +376,11 @@ typedef struct
    Ipv4Addr dnsServerList[IPV4_DNS_SERVER_LIST_SIZE];           ///<DNS servers
    Ipv4FilterEntry multicastFilter[IPV4_MULTICAST_FILTER_SIZE]; ///<Multicast filter table
 #if (IPV4_FRAG_SUPPORT == ENABLED)
-   Ipv4FragDesc fragQueue[IPV4_MAX_FRAG_DATAGRAMS];             ///<IPv4 fragment reassembly queue
+   IpReasmQueue fragQueue;                                      ///<IPv4 fragment reassembly queue
+   IpReasmDesc fragDesc[IPV4_MAX_FRAG_DATAGRAMS];               ///<Datagrams being reassembled
+   uint32_t fragBitmap[IPV4_MAX_FRAG_DATAGRAMS][IP_REASM_BITMAP_SIZE(IPV4_MAX_FRAG_DATAGRAM_SIZE)]; ///<Coverage bitmaps
+   uint8_t *fragBlocks[IPV4_MAX_FRAG_DATAGRAMS][IP_REASM_BLOCK_COUNT(IPV4_MAX_FRAG_DATAGRAM_SIZE)]; ///<Memory blocks holding the payloads
+   Ipv4ReassemblyBuffer fragBuffer;                             ///<Buffer describing the reassembled datagram
 #endif
 } Ipv4Context;
 
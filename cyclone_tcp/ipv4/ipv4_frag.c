@@ -176,17 +176,23 @@ void ipv4ReassembleDatagram(NetInterface *interface, const Ipv4Header *packet,
    uint16_t offset;
    uint16_t dataFirst;
    uint16_t dataLast;
-   Ipv4FragDesc *frag;
-   Ipv4HoleDesc *hole;
-   Ipv4HoleDesc *prevHole;
+   size_t headerLength;
+   IpReasmKey key;
+   IpReasmQueue *queue;
+   IpReasmDesc *frag;
+   NetBuffer *datagram;
+   NetBuffer1 buffer;
+   Ipv4Header *header;
 
    //Number of IP fragments received which needed to be reassembled
    MIB2_IP_INC_COUNTER32(ipReasmReqds, 1);
    IP_MIB_INC_COUNTER32(ipv4SystemStats.ipSystemStatsReasmReqds, 1);
    IP_MIB_INC_COUNTER32(ipv4IfStatsTable[interface->index].ipIfStatsReasmReqds, 1);
 
+   //Calculate the length of the IP header including options
+   headerLength = packet->headerLength * 4;
    //Get the length of the payload
-   length -= packet->headerLength * 4;
+   length -= headerLength;
    //Convert the fragment offset from network byte order
    offset = ntohs(packet->fragmentOffset);
 
@@ -219,8 +225,19 @@ void ipv4ReassembleDatagram(NetInterface *interface, const Ipv4Header *packet,
       return;
    }
 
+   //Point to the reassembly queue
+   queue = &interface->ipv4Context.fragQueue;
+
+   //Fragments are identified by the source address, the destination
+   //address, the identification field and the protocol field
+   osMemset(&key, 0, sizeof(IpReasmKey));
+   osMemcpy(key.srcAddr, &packet->srcAddr, sizeof(Ipv4Addr));
+   osMemcpy(key.destAddr, &packet->destAddr, sizeof(Ipv4Addr));
+   key.identification = ntohs(packet->identification);
+   key.protocol = packet->protocol;
+
    //Search for a matching IP datagram being reassembled
-   frag = ipv4SearchFragQueue(interface, packet);
+   frag = ipReasmFindDesc(queue, &key);
 
    //No matching entry in the reassembly queue?
    if(frag == NULL)
@@ -234,204 +251,48 @@ void ipv4ReassembleDatagram(NetInterface *interface, const Ipv4Header *packet,
       return;
    }
 
-   //The very first fragment requires special handling
-   if((offset & IPV4_OFFSET_MASK) == 0)
-   {
-      //Calculate the length of the IP header including options
-      frag->headerLength = packet->headerLength * 4;
-
-      //Enforce the size of the reconstructed datagram
-      if((frag->headerLength + frag->dataLen) > IPV4_MAX_FRAG_DATAGRAM_SIZE)
-      {
-         //Number of failures detected by the IP reassembly algorithm
-         MIB2_IP_INC_COUNTER32(ipReasmFails, 1);
-         IP_MIB_INC_COUNTER32(ipv4SystemStats.ipSystemStatsReasmFails, 1);
-         IP_MIB_INC_COUNTER32(ipv4IfStatsTable[interface->index].ipIfStatsReasmFails, 1);
-
-         //Drop the reconstructed datagram
-         netBufferSetLength((NetBuffer *) &frag->buffer, 0);
-         //Exit immediately
-         return;
-      }
+   //The fragment fits in a single chunk
+   buffer.chunkCount = 1;
+   buffer.maxChunkCount = 1;
+   buffer.chunk[0].address = (void *) packet;
+   buffer.chunk[0].length = (uint16_t) (headerLength + length);
 
-      //Make sure the IP header entirely fits in the first chunk
-      if(frag->headerLength > frag->buffer.chunk[0].size)
-      {
-         //Number of failures detected by the IP reassembly algorithm
-         MIB2_IP_INC_COUNTER32(ipReasmFails, 1);
-         IP_MIB_INC_COUNTER32(ipv4SystemStats.ipSystemStatsReasmFails, 1);
-         IP_MIB_INC_COUNTER32(ipv4IfStatsTable[interface->index].ipIfStatsReasmFails, 1);
-
-         //Drop the reconstructed datagram
-         netBufferSetLength((NetBuffer *) &frag->buffer, 0);
-         //Exit immediately
-         return;
-      }
+   //Always take the IP header from the first fragment
+   error = ipReasmAddFragment(queue, frag, (NetBuffer *) &buffer, 0,
+      (dataFirst == 0) ? headerLength : 0, headerLength, dataFirst, dataLast,
+      (offset & IPV4_FLAG_MF) != 0);
 
-      //Fix the length of the first chunk
-      frag->buffer.chunk[0].length = (uint16_t) frag->headerLength;
-      //Always take the IP header from the first fragment
-      netBufferWrite((NetBuffer *) &frag->buffer, 0, packet, frag->headerLength);
-   }
-
-   //It may be necessary to increase the size of the buffer
-   if(dataLast > frag->dataLen)
+   //Duplicate fragment?
+   if(error == ERROR_MESSAGE_DISCARDED)
    {
-      //Enforce the size of the reconstructed datagram
-      if((frag->headerLength + dataLast) > IPV4_MAX_FRAG_DATAGRAM_SIZE)
-      {
-         //Number of failures detected by the IP reassembly algorithm
-         MIB2_IP_INC_COUNTER32(ipReasmFails, 1);
-         IP_MIB_INC_COUNTER32(ipv4SystemStats.ipSystemStatsReasmFails, 1);
-         IP_MIB_INC_COUNTER32(ipv4IfStatsTable[interface->index].ipIfStatsReasmFails, 1);
-
-         //Drop the reconstructed datagram
-         netBufferSetLength((NetBuffer *) &frag->buffer, 0);
-         //Exit immediately
-         return;
-      }
-
-      //Adjust the size of the reconstructed datagram
-      error = netBufferSetLength((NetBuffer *) &frag->buffer,
-         frag->headerLength + dataLast + sizeof(Ipv4HoleDesc));
-
-      //Any error to report?
-      if(error)
-      {
-         //Number of failures detected by the IP reassembly algorithm
-         MIB2_IP_INC_COUNTER32(ipReasmFails, 1);
-         IP_MIB_INC_COUNTER32(ipv4SystemStats.ipSystemStatsReasmFails, 1);
-         IP_MIB_INC_COUNTER32(ipv4IfStatsTable[interface->index].ipIfStatsReasmFails, 1);
-
-         //Drop the reconstructed datagram
-         netBufferSetLength((NetBuffer *) &frag->buffer, 0);
-         //Exit immediately
-         return;
-      }
-
-      //Actual length of the payload
-      frag->dataLen = dataLast;
+      //Silently discard the incoming fragment
+      return;
    }
-
-   //Select the first hole descriptor from the list
-   hole = ipv4FindHole(frag, frag->firstHole);
-   //Keep track of the previous hole in the list
-   prevHole = NULL;
-
-   //Iterate through the hole descriptors
-   while(hole != NULL)
+   else if(error)
    {
-      //Save lower and upper boundaries for later use
-      uint16_t holeFirst = hole->first;
-      uint16_t holeLast = hole->last;
-
-      //Check whether the newly arrived fragment interacts with this hole in
-      //some way
-      if(dataFirst < holeLast && dataLast > holeFirst)
-      {
-#if (IPV4_OVERLAPPING_FRAG_SUPPORT == DISABLED)
-         //Prevent overlapping fragment attacks (refer to RFC 8900, section 3.7)
-         if(dataFirst < holeFirst || dataLast > holeLast)
-         {
-            //Number of failures detected by the IP reassembly algorithm
-            MIB2_IP_INC_COUNTER32(ipReasmFails, 1);
-            IP_MIB_INC_COUNTER32(ipv4SystemStats.ipSystemStatsReasmFails, 1);
-            IP_MIB_INC_COUNTER32(ipv4IfStatsTable[interface->index].ipIfStatsReasmFails, 1);
-
-            //Drop the reconstructed datagram
-            netBufferSetLength((NetBuffer *) &frag->buffer, 0);
-            //Exit immediately
-            return;
-         }
-#endif
-         //The current descriptor is no longer valid. We will destroy it, and in
-         //the next two steps, we will determine whether or not it is necessary
-         //to create any new hole descriptors
-         if(prevHole != NULL)
-         {
-            prevHole->next = hole->next;
-         }
-         else
-         {
-            frag->firstHole = hole->next;
-         }
-
-         //Is there still a hole at the beginning of the segment?
-         if(dataFirst > holeFirst)
-         {
-            //Create a new entry that describes this hole
-            hole = ipv4FindHole(frag, holeFirst);
-            hole->first = holeFirst;
-            hole->last = dataFirst;
-
-            //Insert the newly created entry into the hole descriptor list
-            if(prevHole != NULL)
-            {
-               hole->next = prevHole->next;
-               prevHole->next = hole->first;
-            }
-            else
-            {
-               hole->next = frag->firstHole;
-               frag->firstHole = hole->first;
-            }
-
-            //Always keep track of the previous hole
-            prevHole = hole;
-         }
-
-         //Is there still a hole at the end of the segment?
-         if(dataLast < holeLast && (offset & IPV4_FLAG_MF) != 0)
-         {
-            //Create a new entry that describes this hole
-            hole = ipv4FindHole(frag, dataLast);
-            hole->first = dataLast;
-            hole->last = holeLast;
-
-            //Insert the newly created entry into the hole descriptor list
-            if(prevHole != NULL)
-            {
-               hole->next = prevHole->next;
-               prevHole->next = hole->first;
-            }
-            else
-            {
-               hole->next = frag->firstHole;
-               frag->firstHole = hole->first;
-            }
-
-            //Always keep track of the previous hole
-            prevHole = hole;
-         }
-      }
-      else
-      {
-         //The newly arrived fragment does not interact with the current hole
-         prevHole = hole;
-      }
+      //Number of failures detected by the IP reassembly algorithm
+      MIB2_IP_INC_COUNTER32(ipReasmFails, 1);
+      IP_MIB_INC_COUNTER32(ipv4SystemStats.ipSystemStatsReasmFails, 1);
+      IP_MIB_INC_COUNTER32(ipv4IfStatsTable[interface->index].ipIfStatsReasmFails, 1);
 
-      //Select the next hole descriptor from the list
-      hole = ipv4FindHole(frag, prevHole ? prevHole->next : frag->firstHole);
+      //Drop the reconstructed datagram
+      ipReasmDeleteDesc(queue, frag);
+      //Exit immediately
+      return;
    }
 
-   //Copy data from the fragment to the reassembly buffer
-   netBufferWrite((NetBuffer *) &frag->buffer,
-      frag->headerLength + dataFirst, IPV4_DATA(packet), length);
+   //Dump the list of fragments
+   ipReasmDumpDesc(frag);
 
-   //Dump hole descriptor list
-   ipv4DumpHoleList(frag);
-
-   //If the hole descriptor list is empty, the reassembly process is now
+   //If all the blocks have been received, the reassembly process is now
    //complete
-   if(ipv4FindHole(frag, frag->firstHole) == NULL)
+   if(ipReasmIsComplete(frag))
    {
-      //Discard the extra hole descriptor that follows the reconstructed
-      //datagram
-      error = netBufferSetLength((NetBuffer *) &frag->buffer,
-         frag->headerLength + frag->dataLen);
+      //Chain the fragments together
+      datagram = ipReasmGetDatagram(queue, frag);
 
-      //Check status code
-      if(error)
+      //Check whether the reassembled datagram is valid
+      if(datagram == NULL)
       {
          //Number of failures detected by the IP reassembly algorithm
          MIB2_IP_INC_COUNTER32(ipReasmFails, 1);
@@ -441,12 +302,12 @@ void ipv4ReassembleDatagram(NetInterface *interface, const Ipv4Header *packet,
       else
       {
          //Point to the IP header
-         Ipv4Header *datagram = netBufferAt((NetBuffer *) &frag->buffer, 0);
+         header = (Ipv4Header *) frag->header;
 
          //Fix IP header
-         datagram->totalLength = htons(frag->headerLength + frag->dataLen);
-         datagram->fragmentOffset = 0;
-         datagram->headerChecksum = 0;
+         header->totalLength = htons(frag->headerLen + frag->dataLen);
+         header->fragmentOffset = 0;
+         header->headerChecksum = 0;
 
          //Number of IP datagrams successfully reassembled
          MIB2_IP_INC_COUNTER32(ipReasmOKs, 1);
@@ -454,12 +315,11 @@ void ipv4ReassembleDatagram(NetInterface *interface, const Ipv4Header *packet,
          IP_MIB_INC_COUNTER32(ipv4IfStatsTable[interface->index].ipIfStatsReasmOKs, 1);
 
          //Pass the original IPv4 datagram to the higher protocol layer
-         ipv4ProcessDatagram(interface, (NetBuffer *) &frag->buffer, 0,
-            ancillary);
+         ipv4ProcessDatagram(interface, datagram, 0, ancillary);
       }
 
       //Release previously allocated memory
-      netBufferSetLength((NetBuffer *) &frag->buffer, 0);
+      ipReasmDeleteDesc(queue, frag);
    }
 }
 
@@ -475,22 +335,26 @@ void ipv4ReassembleDatagram(NetInterface *interface, const Ipv4Header *packet,
 
 void ipv4FragTick(NetInterface *interface)
 {
-   error_t error;
    uint_t i;
    systime_t time;
-   Ipv4HoleDesc *hole;
+   IpReasmQueue *queue;
+   IpReasmDesc *frag;
+   NetBuffer *datagram;
 
    //Get current time
    time = osGetSystemTime();
 
+   //Point to the reassembly queue
+   queue = &interface->ipv4Context.fragQueue;
+
    //Loop through the reassembly queue
-   for(i = 0; i < IPV4_MAX_FRAG_DATAGRAMS; i++)
+   for(i = 0; i < queue->size; i++)
    {
       //Point to the current entry in the reassembly queue
-      Ipv4FragDesc *frag = &interface->ipv4Context.fragQueue[i];
+      frag = &queue->table[i];
 
       //Make sure the entry is currently in use
-      if(frag->buffer.chunkCount > 0)
+      if(frag->used)
       {
          //If the timer runs out, the partially-reassembled datagram must be
          //discarded and ICMP Time Exceeded message sent to the source host
@@ -498,37 +362,29 @@ void ipv4FragTick(NetInterface *interface)
          {
             //Debug message
             TRACE_INFO("IPv4 fragment reassembly timeout...\r\n");
-            //Dump IP header contents for debugging purpose
-            ipv4DumpHeader(frag->buffer.chunk[0].address);
 
             //Number of failures detected by the IP reassembly algorithm
             MIB2_IP_INC_COUNTER32(ipReasmFails, 1);
             IP_MIB_INC_COUNTER32(ipv4SystemStats.ipSystemStatsReasmFails, 1);
             IP_MIB_INC_COUNTER32(ipv4IfStatsTable[interface->index].ipIfStatsReasmFails, 1);
 
-            //Point to the first hole descriptor
-            hole = ipv4FindHole(frag, frag->firstHole);
+            //Retrieve the data received contiguously from offset zero
+            datagram = ipReasmGetDatagram(queue, frag);
 
             //Make sure the fragment zero has been received before sending an
             //ICMP message
-            if(hole != NULL && hole->first > 0)
+            if(datagram != NULL && netBufferGetLength(datagram) > frag->headerLen)
             {
-               //Fix the size of the reconstructed datagram
-               error = netBufferSetLength((NetBuffer *) &frag->buffer,
-                  frag->headerLength + hole->first);
-
-               //Check status code
-               if(!error)
-               {
-                  //Send an ICMP Time Exceeded message
-                  icmpSendErrorMessage(interface, ICMP_TYPE_TIME_EXCEEDED,
-                     ICMP_CODE_REASSEMBLY_TIME_EXCEEDED, 0,
-                     (NetBuffer *) &frag->buffer, 0);
-               }
+               //Dump IP header contents for debugging purpose
+               ipv4DumpHeader((Ipv4Header *) frag->header);
+
+               //Send an ICMP Time Exceeded message
+               icmpSendErrorMessage(interface, ICMP_TYPE_TIME_EXCEEDED,
+                  ICMP_CODE_REASSEMBLY_TIME_EXCEEDED, 0, datagram, 0);
             }
 
             //Drop the partially reconstructed datagram
-            netBufferSetLength((NetBuffer *) &frag->buffer, 0);
+            ipReasmDeleteDesc(queue, frag);
          }
       }
    }
@@ -536,108 +392,23 @@ void ipv4FragTick(NetInterface *interface)
 
 
 /**
- * @brief Search for a matching datagram in the reassembly queue
+ * @brief Initialize IPv4 reassembly queue
  * @param[in] interface Underlying network interface
- * @param[in] packet Incoming IPv4 packet
- * @return Matching fragment descriptor
  **/
 
-Ipv4FragDesc *ipv4SearchFragQueue(NetInterface *interface,
-   const Ipv4Header *packet)
+void ipv4InitFragQueue(NetInterface *interface)
 {
-   error_t error;
-   uint_t i;
-   Ipv4Header *datagram;
-   Ipv4FragDesc *frag;
-   Ipv4HoleDesc *hole;
-
-   //Search for a matching IP datagram being reassembled
-   for(i = 0; i < IPV4_MAX_FRAG_DATAGRAMS; i++)
-   {
-      //Point to the current entry in the reassembly queue
-      frag = &interface->ipv4Context.fragQueue[i];
-
-      //Check whether the current entry is used?
-      if(frag->buffer.chunkCount > 0)
-      {
-         //Point to the corresponding datagram
-         datagram = netBufferAt((NetBuffer *) &frag->buffer, 0);
-
-         //Check source and destination addresses
-         if(datagram->srcAddr != packet->srcAddr)
-            continue;
-         if(datagram->destAddr != packet->destAddr)
-            continue;
-
-         //Compare identification and protocol fields
-         if(datagram->identification != packet->identification)
-            continue;
-         if(datagram->protocol != packet->protocol)
-            continue;
-
-         //A matching entry has been found in the reassembly queue
-         return frag;
-      }
-   }
-
-   //If the current packet does not match an existing entry in the reassembly
-   //queue, then create a new entry
-   for(i = 0; i < IPV4_MAX_FRAG_DATAGRAMS; i++)
-   {
-      //Point to the current entry in the reassembly queue
-      frag = &interface->ipv4Context.fragQueue[i];
-
-      //The current entry is free?
-      if(!frag->buffer.chunkCount)
-      {
-         //Number of chunks that comprise the reassembly buffer
-         frag->buffer.maxChunkCount = arraysize(frag->buffer.chunk);
-
-         //Allocate sufficient memory to hold the IPv4 header and
-         //the first hole descriptor
-         error = netBufferSetLength((NetBuffer *) &frag->buffer,
-            NET_MEM_POOL_BUFFER_SIZE + sizeof(Ipv4HoleDesc));
+   Ipv4Context *context;
 
-         //Failed to allocate memory?
-         if(error)
-         {
-            //Clean up side effects
-            netBufferSetLength((NetBuffer *) &frag->buffer, 0);
-            //Exit immediately
-            return NULL;
-         }
-
-         //Initial length of the reconstructed datagram
-         frag->headerLength = packet->headerLength * 4;
-         frag->dataLen = 0;
-
-         //Fix the length of the first chunk
-         frag->buffer.chunk[0].length = (uint16_t) frag->headerLength;
-         //Copy IPv4 header from the incoming fragment
-         netBufferWrite((NetBuffer *) &frag->buffer, 0, packet, frag->headerLength);
-
-         //Save current time
-         frag->timestamp = osGetSystemTime();
-         //Create a new entry in the hole descriptor list
-         frag->firstHole = 0;
+   //Point to the IPv4 context
+   context = &interface->ipv4Context;
 
-         //Point to first hole descriptor
-         hole = ipv4FindHole(frag, frag->firstHole);
-         //The entry describes the datagram as being completely missing
-         hole->first = 0;
-         hole->last = IPV4_INFINITY;
-         hole->next = IPV4_INFINITY;
-
-         //Dump hole descriptor list
-         ipv4DumpHoleList(frag);
-
-         //Return the matching fragment descriptor
-         return frag;
-      }
-   }
-
-   //The reassembly queue is full
-   return NULL;
+   //Overlapping fragments are accepted unless otherwise specified
+   ipReasmInit(&context->fragQueue, context->fragDesc,
+      &context->fragBitmap[0][0], &context->fragBlocks[0][0],
+      (NetBuffer *) &context->fragBuffer, IPV4_MAX_FRAG_DATAGRAMS,
+      IPV4_MAX_FRAG_DATAGRAM_SIZE, IPV4_FRAG_MAX_MEM_SIZE,
+      (IPV4_OVERLAPPING_FRAG_SUPPORT == ENABLED) ? TRUE : FALSE);
 }
 
 
@@ -648,57 +419,8 @@ Ipv4FragDesc *ipv4SearchFragQueue(NetInterface *interface,
 
 void ipv4FlushFragQueue(NetInterface *interface)
 {
-   uint_t i;
-
-   //Loop through the reassembly queue
-   for(i = 0; i < IPV4_MAX_FRAG_DATAGRAMS; i++)
-   {
-      //Drop any partially reconstructed datagram
-      netBufferSetLength((NetBuffer *) &interface->ipv4Context.fragQueue[i].buffer, 0);
-   }
-}
-
-
-/**
- * @brief Retrieve hole descriptor
- * @param[in] frag IPv4 fragment descriptor
- * @param[in] offset Offset of the hole
- * @return A pointer to the hole descriptor is returned if the specified
- *   offset is valid. Otherwise NULL is returned
- **/
-
-Ipv4HoleDesc *ipv4FindHole(Ipv4FragDesc *frag, uint16_t offset)
-{
-   //Return a pointer to the hole descriptor
-   return netBufferAt((NetBuffer *) &frag->buffer, frag->headerLength + offset);
-}
-
-
-/**
- * @brief Dump hole descriptor list
- * @param[in] frag IPv4 fragment descriptor
- **/
-
-void ipv4DumpHoleList(Ipv4FragDesc *frag)
-{
-//Check debugging level
-#if (TRACE_LEVEL >= TRACE_LEVEL_DEBUG)
-   Ipv4HoleDesc *hole;
-
-   //Debug message
-   TRACE_DEBUG("Hole descriptor list:\r\n");
-   //Select the first hole descriptor from the list
-   hole = ipv4FindHole(frag, frag->firstHole);
-
-   //Loop through the hole descriptor list
-   while(hole != NULL)
-   {
-      //Display current hole
-      TRACE_DEBUG("  %" PRIu16 " - %" PRIu16 "\r\n", hole->first, hole->last);
-      //Select the next hole descriptor from the list
-      hole = ipv4FindHole(frag, hole->next);
-   }
-#endif
+   //Drop any partially reconstructed datagram
+   ipReasmFlush(&interface->ipv4Context.fragQueue);
 }
 
 #endif
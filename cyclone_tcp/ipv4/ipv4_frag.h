@@ -31,6 +31,7 @@
 //Dependencies
 #include "core/net.h"
 #include "ipv4/ipv4.h"
+#include "core/ip_reasm.h"
 
 //IPv4 fragmentation support
 #ifndef IPV4_FRAG_SUPPORT
@@ -56,7 +57,7 @@
 //Maximum number of fragmented packets the host will accept
 //and hold in the reassembly queue simultaneously
 #ifndef IPV4_MAX_FRAG_DATAGRAMS
-   #define IPV4_MAX_FRAG_DATAGRAMS 4
+   #define IPV4_MAX_FRAG_DATAGRAMS 16
 #elif (IPV4_MAX_FRAG_DATAGRAMS < 1)
    #error IPV4_MAX_FRAG_DATAGRAMS parameter is not valid
 #endif
@@ -75,8 +76,12 @@
    #error IPV4_FRAG_TIME_TO_LIVE parameter is not valid
 #endif
 
-//Infinity is implemented by a very large integer
-#define IPV4_INFINITY 0xFFFF
+//Maximum amount of memory the reassembly queue may hold, in bytes
+#ifndef IPV4_FRAG_MAX_MEM_SIZE
+   #define IPV4_FRAG_MAX_MEM_SIZE (IPV4_MAX_FRAG_DATAGRAMS * IPV4_MAX_FRAG_DATAGRAM_SIZE)
+#elif (IPV4_FRAG_MAX_MEM_SIZE < IPV4_MAX_FRAG_DATAGRAM_SIZE)
+   #error IPV4_FRAG_MAX_MEM_SIZE parameter is not valid
+#endif
 
 //C++ guard
 #ifdef __cplusplus
@@ -84,34 +89,6 @@ extern "C" {
 #endif
 
 
-//CC-RX, CodeWarrior or Win32 compiler?
-#if defined(__CCRX__)
-   #pragma pack
-#elif defined(__CWCC__) || defined(_WIN32)
-   #pragma pack(push, 1)
-#endif
-
-
-/**
- * @brief Hole descriptor
- **/
-
-typedef __packed_struct
-{
-   uint16_t first;
-   uint16_t last;
-   uint16_t next;
-} Ipv4HoleDesc;
-
-
-//CC-RX, CodeWarrior or Win32 compiler?
-#if defined(__CCRX__)
-   #pragma unpack
-#elif defined(__CWCC__) || defined(_WIN32)
-   #pragma pack(pop)
-#endif
-
-
 /**
  * @brief Reassembly buffer
  **/
@@ -120,24 +97,10 @@ typedef struct
 {
    uint_t chunkCount;
    uint_t maxChunkCount;
-   ChunkDesc chunk[N(IPV4_MAX_FRAG_DATAGRAM_SIZE) + 1];
+   ChunkDesc chunk[IP_REASM_CHUNK_COUNT(IPV4_MAX_FRAG_DATAGRAM_SIZE)];
 } Ipv4ReassemblyBuffer;
 
 
-/**
- * @brief Fragmented packet descriptor
- **/
-
-typedef struct
-{
-   systime_t timestamp;         ///<Time at which the first fragment was received
-   size_t headerLength;         ///<Length of the header
-   size_t dataLen;              ///<Length of the payload
-   uint16_t firstHole;          ///<Index of the first hole
-   Ipv4ReassemblyBuffer buffer; ///<Buffer containing the reassembled datagram
-} Ipv4FragDesc;
-
-
 //Tick counter to handle periodic operations
 extern systime_t ipv4FragTickCounter;
 
@@ -151,14 +114,9 @@ void ipv4ReassembleDatagram(NetInterface *interface, const Ipv4Header *packet,
 
 void ipv4FragTick(NetInterface *interface);
 
-Ipv4FragDesc *ipv4SearchFragQueue(NetInterface *interface,
-   const Ipv4Header *packet);
-
+void ipv4InitFragQueue(NetInterface *interface);
 void ipv4FlushFragQueue(NetInterface *interface);
 
-Ipv4HoleDesc *ipv4FindHole(Ipv4FragDesc *frag, uint16_t offset);
-void ipv4DumpHoleList(Ipv4FragDesc *frag);
-
 //C++ guard
 #ifdef __cplusplus
 }
@@ -0,0 +1,809 @@
+/**
+ * @file ipv4_routing.c
+ * @brief IPv4 routing
+ *
+ * @section License
+ *
+ * Copyright (C) 2010-2023 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneTCP Eval.
+ *
+ * This software is provided in source form for a short-term evaluation only. The
+ * evaluation license expires 90 days after the date you first download the software.
+ *
+ * If you plan to use this software in a commercial product, you are required to
+ * purchase a commercial license from Oryx Embedded SARL.
+ *
+ * After the 90-day evaluation period, you agree to either purchase a commercial
+ * license or delete all copies of this software. If you wish to extend the
+ * evaluation period, you must contact sales@oryx-embedded.com.
+ *
+ * This evaluation software is provided "as is" without warranty of any kind.
+ * Technical support is available as an option during the evaluation period.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.3.2
+ **/
+
+
+//Switch to the appropriate trace level
+#define TRACE_LEVEL IPV4_TRACE_LEVEL
+
+//Dependencies
+#include "core/net.h"
+#include "core/ip.h"
+#include "core/ip_trie.h"
+#include "ipv4/ipv4.h"
+#include "ipv4/ipv4_misc.h"
+#include "ipv4/ipv4_routing.h"
+#include "ipv4/icmp.h"
+#include "ipv4/arp.h"
+#include "debug.h"
+
+//Check TCP/IP stack configuration
+#if (IPV4_SUPPORT == ENABLED && IPV4_ROUTING_SUPPORT == ENABLED)
+
+//IPv4 routing table
+static Ipv4RoutingTableEntry ipv4RoutingTable[IPV4_ROUTING_TABLE_SIZE];
+//Longest prefix match trie
+static IpTrie ipv4RoutingTrie;
+static IpTrieNode ipv4RoutingTrieNodes[2 * IPV4_ROUTING_TABLE_SIZE];
+//Next-hop cache
+static Ipv4RoutingCacheEntry ipv4RoutingCache[IPV4_ROUTING_CACHE_SIZE];
+
+
+/**
+ * @brief Initialize IPv4 routing table
+ * @return Error code
+ **/
+
+error_t ipv4InitRouting(void)
+{
+   //Clear the routing table
+   osMemset(ipv4RoutingTable, 0, sizeof(ipv4RoutingTable));
+
+   //Initialize the trie that indexes the routing table
+   ipTrieInit(&ipv4RoutingTrie, ipv4RoutingTrieNodes,
+      arraysize(ipv4RoutingTrieNodes));
+
+   //Clear the next-hop cache
+   ipv4FlushRoutingCache();
+
+   //Successful initialization
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Enable routing for the specified interface
+ * @param[in] interface Underlying network interface
+ * @param[in] enable When the flag is set to TRUE, routing is enabled on the
+ *   interface and the router can forward packets to or from the interface
+ * @return Error code
+ **/
+
+error_t ipv4EnableRouting(NetInterface *interface, bool_t enable)
+{
+   //Check parameters
+   if(interface == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Get exclusive access
+   osAcquireMutex(&netMutex);
+
+   //Enable or disable routing
+   interface->ipv4Context.isRouter = enable;
+   //Cached routes may no longer be usable
+   ipv4FlushRoutingCache();
+
+   //Release exclusive access
+   osReleaseMutex(&netMutex);
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Add a new entry in the IPv4 routing table
+ * @param[in] networkDest Network destination
+ * @param[in] networkMask Subnet mask for this route
+ * @param[in] interface Network interface where to forward the packet
+ * @param[in] nextHop IPv4 address of the next hop
+ * @param[in] metric Metric value
+ * @return Error code
+ **/
+
+error_t ipv4AddRoute(Ipv4Addr networkDest, Ipv4Addr networkMask,
+   NetInterface *interface, Ipv4Addr nextHop, uint_t metric)
+{
+   error_t error;
+   uint_t i;
+   uint_t prefixLen;
+   Ipv4RoutingTableEntry *entry;
+   Ipv4RoutingTableEntry *firstFreeEntry;
+
+   //Check parameters
+   if(interface == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Retrieve the length of the prefix
+   prefixLen = ipv4GetPrefixLength(networkMask);
+
+   //The subnet mask must be made of contiguous bits
+   if(prefixLen < 32 && (ntohl(networkMask) & (0xFFFFFFFFUL >> prefixLen)) != 0)
+      return ERROR_INVALID_PARAMETER;
+
+   //Clear the host part of the network destination
+   networkDest &= networkMask;
+
+   //Keep track of the first free entry
+   firstFreeEntry = NULL;
+
+   //Get exclusive access
+   osAcquireMutex(&netMutex);
+
+   //Loop through routing table entries
+   for(i = 0; i < IPV4_ROUTING_TABLE_SIZE; i++)
+   {
+      //Point to the current entry
+      entry = &ipv4RoutingTable[i];
+
+      //Valid entry?
+      if(entry->valid)
+      {
+         //Check whether the current entry matches the specified destination
+         if(entry->networkDest == networkDest &&
+            entry->networkMask == networkMask)
+         {
+            break;
+         }
+      }
+      else
+      {
+         //Keep track of the first free entry
+         if(firstFreeEntry == NULL)
+            firstFreeEntry = entry;
+      }
+   }
+
+   //If the routing table does not contain the specified destination,
+   //then a new entry should be created
+   if(i >= IPV4_ROUTING_TABLE_SIZE)
+   {
+      //Check whether the routing table runs out of space
+      if(firstFreeEntry != NULL)
+      {
+         //Network destination
+         firstFreeEntry->networkDest = networkDest;
+         firstFreeEntry->networkMask = networkMask;
+
+         //Index the new entry
+         error = ipTrieInsert(&ipv4RoutingTrie,
+            (uint8_t *) &firstFreeEntry->networkDest, prefixLen,
+            firstFreeEntry);
+      }
+      else
+      {
+         //The routing table is full
+         error = ERROR_FAILURE;
+      }
+
+      //Point to the new entry
+      entry = firstFreeEntry;
+   }
+   else
+   {
+      //The entry is already indexed
+      error = NO_ERROR;
+   }
+
+   //Check status code
+   if(!error)
+   {
+      //Interface where to forward the packet
+      entry->interface = interface;
+      //Address of the next hop
+      entry->nextHop = nextHop;
+      //Metric value
+      entry->metric = metric;
+      //The entry is now valid
+      entry->valid = TRUE;
+
+      //Cached routes may have been superseded by the new entry
+      ipv4FlushRoutingCache();
+   }
+
+   //Release exclusive access
+   osReleaseMutex(&netMutex);
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Remove an entry from the IPv4 routing table
+ * @param[in] networkDest Network destination
+ * @param[in] networkMask Subnet mask for this route
+ * @return Error code
+ **/
+
+error_t ipv4DeleteRoute(Ipv4Addr networkDest, Ipv4Addr networkMask)
+{
+   error_t error;
+   uint_t i;
+   Ipv4RoutingTableEntry *entry;
+
+   //Initialize status code
+   error = ERROR_NOT_FOUND;
+
+   //Clear the host part of the network destination
+   networkDest &= networkMask;
+
+   //Get exclusive access
+   osAcquireMutex(&netMutex);
+
+   //Loop through routing table entries
+   for(i = 0; i < IPV4_ROUTING_TABLE_SIZE; i++)
+   {
+      //Point to the current entry
+      entry = &ipv4RoutingTable[i];
+
+      //Valid entry?
+      if(entry->valid)
+      {
+         //Check whether the current entry matches the specified destination
+         if(entry->networkDest == networkDest &&
+            entry->networkMask == networkMask)
+         {
+            //Remove the entry from the trie
+            ipTrieDelete(&ipv4RoutingTrie, (uint8_t *) &entry->networkDest,
+               ipv4GetPrefixLength(entry->networkMask));
+
+            //Delete current entry
+            entry->valid = FALSE;
+            //Cached routes may refer to the deleted entry
+            ipv4FlushRoutingCache();
+
+            //The route was successfully deleted from the routing table
+            error = NO_ERROR;
+         }
+      }
+   }
+
+   //Release exclusive access
+   osReleaseMutex(&netMutex);
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Delete all routes from the IPv4 routing table
+ * @return Error code
+ **/
+
+error_t ipv4DeleteAllRoutes(void)
+{
+   //Get exclusive access
+   osAcquireMutex(&netMutex);
+
+   //Clear the routing table
+   osMemset(ipv4RoutingTable, 0, sizeof(ipv4RoutingTable));
+   //Clear the trie
+   ipTrieFlush(&ipv4RoutingTrie);
+   //Clear the next-hop cache
+   ipv4FlushRoutingCache();
+
+   //Release exclusive access
+   osReleaseMutex(&netMutex);
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Forward an IPv4 packet
+ * @param[in] srcInterface Network interface on which the packet was received
+ * @param[in] ipPacket Multi-part buffer that holds the IPv4 packet to forward
+ * @param[in] ipPacketOffset Offset to the first byte of the IPv4 packet
+ * @return Error code
+ **/
+
+error_t ipv4ForwardPacket(NetInterface *srcInterface, const NetBuffer *ipPacket,
+   size_t ipPacketOffset)
+{
+   error_t error;
+   size_t n;
+   size_t length;
+   size_t headerLength;
+   size_t payloadLen;
+   size_t fragmentOffset;
+   size_t maxFragmentSize;
+   NetInterface *destInterface;
+   Ipv4Header *ipHeader;
+   Ipv4RoutingTableEntry *entry;
+   Ipv4Addr nextHop;
+
+   //If routing is not enabled on the interface, then the router cannot
+   //forward packets from the interface
+   if(!srcInterface->ipv4Context.isRouter)
+      return ERROR_FAILURE;
+
+   //Calculate the length of the IPv4 packet
+   length = netBufferGetLength(ipPacket) - ipPacketOffset;
+
+   //Ensure the packet length is greater than 20 bytes
+   if(length < sizeof(Ipv4Header))
+      return ERROR_INVALID_LENGTH;
+
+   //Point to the IPv4 header
+   ipHeader = netBufferAt(ipPacket, ipPacketOffset);
+
+   //Sanity check
+   if(ipHeader == NULL)
+      return ERROR_FAILURE;
+
+   //Retrieve the length of the IPv4 header
+   headerLength = ipHeader->headerLength * 4;
+
+   //Check the length of the IPv4 header
+   if(headerLength < IPV4_MIN_HEADER_LENGTH || headerLength > length)
+      return ERROR_INVALID_HEADER;
+
+   //Any padding after the datagram is not forwarded
+   if(ntohs(ipHeader->totalLength) < headerLength ||
+      ntohs(ipHeader->totalLength) > length)
+   {
+      return ERROR_INVALID_LENGTH;
+   }
+
+   //Retrieve the total length of the datagram
+   length = ntohs(ipHeader->totalLength);
+
+   //A router must not forward a packet whose source address is not a unicast
+   //address (refer to RFC 1812, section 5.3.7)
+   if(ipHeader->srcAddr == IPV4_UNSPECIFIED_ADDR ||
+      ipHeader->srcAddr == IPV4_BROADCAST_ADDR ||
+      ipv4IsMulticastAddr(ipHeader->srcAddr) ||
+      ipv4IsLoopbackAddr(ipHeader->srcAddr))
+   {
+      return ERROR_INVALID_ADDRESS;
+   }
+
+   //Limited broadcasts and packets addressed to the loopback network must
+   //never be forwarded
+   if(ipHeader->destAddr == IPV4_UNSPECIFIED_ADDR ||
+      ipHeader->destAddr == IPV4_BROADCAST_ADDR ||
+      ipv4IsLoopbackAddr(ipHeader->destAddr))
+   {
+      return ERROR_INVALID_ADDRESS;
+   }
+
+   //Multicast routes are managed by the application through the IGMP router
+   //callbacks and are not part of the unicast routing table
+   if(ipv4IsMulticastAddr(ipHeader->destAddr))
+      return ERROR_INVALID_ADDRESS;
+
+   //A router must not forward a packet with a link-local source or
+   //destination address (refer to RFC 3927, section 7)
+   if(ipv4IsLinkLocalAddr(ipHeader->srcAddr) ||
+      ipv4IsLinkLocalAddr(ipHeader->destAddr))
+   {
+      return ERROR_INVALID_ADDRESS;
+   }
+
+   //Route determination process
+   entry = ipv4FindRoute(ipHeader->destAddr);
+
+   //No route to the destination?
+   if(entry == NULL)
+   {
+      //A Destination Unreachable message should be generated by a router
+      //in response to a packet that cannot be delivered
+      icmpSendErrorMessage(srcInterface, ICMP_TYPE_DEST_UNREACHABLE,
+         ICMP_CODE_NET_UNREACHABLE, 0, ipPacket, ipPacketOffset);
+
+      //Exit immediately
+      return ERROR_NO_ROUTE;
+   }
+
+   //Outgoing interface on which to forward the packet
+   destInterface = entry->interface;
+
+   //Next hop
+   if(entry->nextHop != IPV4_UNSPECIFIED_ADDR)
+   {
+      nextHop = entry->nextHop;
+   }
+   else
+   {
+      nextHop = ipHeader->destAddr;
+   }
+
+   //Directed broadcast?
+   if(ipv4IsBroadcastAddr(destInterface, ipHeader->destAddr))
+   {
+#if (IPV4_FORWARD_DIRECTED_BROADCAST == ENABLED)
+      //The packet is broadcast on the destination network
+      nextHop = ipHeader->destAddr;
+#else
+      //Routers must by default not forward directed broadcasts (refer to
+      //RFC 2644, section 3)
+      return ERROR_INVALID_ADDRESS;
+#endif
+   }
+   //Check whether the packet is explicitly addressed to the router itself
+   else if(!ipv4CheckDestAddr(destInterface, ipHeader->destAddr))
+   {
+      //Exit immediately
+      return NO_ERROR;
+   }
+   else
+   {
+      //Unicast packet
+   }
+
+   //Time to live exceeded in transit?
+   if(ipHeader->timeToLive <= 1)
+   {
+      //If the TTL is reduced to zero (or less), the packet must be discarded
+      //and an ICMP Time Exceeded message must be sent to the packet's source
+      //(refer to RFC 1812, section 5.3.1)
+      icmpSendErrorMessage(srcInterface, ICMP_TYPE_TIME_EXCEEDED,
+         ICMP_CODE_TTL_EXCEEDED, 0, ipPacket, ipPacketOffset);
+
+      //Exit immediately
+      return ERROR_FAILURE;
+   }
+
+   //Check whether the length of the IPv4 packet is larger than the link MTU
+   if(length <= destInterface->ipv4Context.linkMtu)
+   {
+      //Forward the packet as a whole
+      error = ipv4ForwardFragment(destInterface, nextHop, ipPacket,
+         ipPacketOffset, headerLength, 0, length - headerLength, TRUE);
+   }
+   else if((ntohs(ipHeader->fragmentOffset) & IPV4_FLAG_DF) != 0)
+   {
+      //The packet cannot be fragmented, so a Destination Unreachable message
+      //must be sent to the packet's source
+      icmpSendErrorMessage(srcInterface, ICMP_TYPE_DEST_UNREACHABLE,
+         ICMP_CODE_FRAG_NEEDED_AND_DF_SET, 0, ipPacket, ipPacketOffset);
+
+      //Report an error
+      error = ERROR_INVALID_LENGTH;
+   }
+   else
+   {
+      //Length of the payload to be fragmented
+      payloadLen = length - headerLength;
+
+      //The size of each fragment must be a multiple of 8 bytes, except for
+      //the last one
+      maxFragmentSize = (destInterface->ipv4Context.linkMtu - headerLength) & ~7;
+
+      //Sanity check
+      if(maxFragmentSize == 0)
+         return ERROR_INVALID_LENGTH;
+
+      //Initialize status code
+      error = NO_ERROR;
+
+      //Split the payload into multiple fragments
+      for(fragmentOffset = 0; fragmentOffset < payloadLen && !error;
+         fragmentOffset += n)
+      {
+         //Calculate the length of the current fragment
+         n = MIN(payloadLen - fragmentOffset, maxFragmentSize);
+
+         //Forward the current fragment
+         error = ipv4ForwardFragment(destInterface, nextHop, ipPacket,
+            ipPacketOffset, headerLength, fragmentOffset, n,
+            (fragmentOffset + n) >= payloadLen);
+      }
+   }
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Search the routing table for the best route to a given destination
+ * @param[in] destAddr Destination IPv4 address
+ * @return Pointer to the routing table entry, if any
+ **/
+
+Ipv4RoutingTableEntry *ipv4FindRoute(Ipv4Addr destAddr)
+{
+   uint_t h;
+   Ipv4RoutingCacheEntry *cacheEntry;
+   Ipv4RoutingTableEntry *entry;
+
+   //Hash the destination address
+   h = (uint_t) (destAddr ^ (destAddr >> 16));
+   h ^= h >> 8;
+
+   //Point to the corresponding next-hop cache entry
+   cacheEntry = &ipv4RoutingCache[h % IPV4_ROUTING_CACHE_SIZE];
+
+   //Cache hit?
+   if(cacheEntry->route != NULL && cacheEntry->destAddr == destAddr)
+   {
+      //The route has already been determined for this destination
+      entry = cacheEntry->route;
+   }
+   else
+   {
+      //The longest matching route is the most specific route to the
+      //destination IPv4 address
+      entry = ipTrieLookup(&ipv4RoutingTrie, (uint8_t *) &destAddr, 32,
+         ipv4CheckRoute);
+
+      //Save the result in the next-hop cache
+      if(entry != NULL)
+      {
+         cacheEntry->destAddr = destAddr;
+         cacheEntry->route = entry;
+      }
+   }
+
+   //Return the matching route, if any
+   return entry;
+}
+
+
+/**
+ * @brief Check whether a route can be used to forward packets
+ * @param[in] route Pointer to the routing table entry
+ * @return TRUE if the route is usable, else FALSE
+ **/
+
+bool_t ipv4CheckRoute(const void *route)
+{
+   const Ipv4RoutingTableEntry *entry;
+
+   //Point to the routing table entry
+   entry = (const Ipv4RoutingTableEntry *) route;
+
+   //If routing is enabled on the interface, then the router can forward
+   //packets to the interface
+   if(entry->valid && entry->interface != NULL &&
+      entry->interface->ipv4Context.isRouter)
+   {
+      return TRUE;
+   }
+   else
+   {
+      return FALSE;
+   }
+}
+
+
+/**
+ * @brief Flush the next-hop cache
+ **/
+
+void ipv4FlushRoutingCache(void)
+{
+   //Clear the next-hop cache
+   osMemset(ipv4RoutingCache, 0, sizeof(ipv4RoutingCache));
+}
+
+
+/**
+ * @brief Forward a fragment of an IPv4 packet
+ * @param[in] destInterface Outgoing network interface
+ * @param[in] nextHop IPv4 address of the next hop
+ * @param[in] ipPacket Multi-part buffer that holds the IPv4 packet to forward
+ * @param[in] ipPacketOffset Offset to the first byte of the IPv4 packet
+ * @param[in] headerLength Length of the IPv4 header
+ * @param[in] fragmentOffset Offset of the fragment within the payload
+ * @param[in] length Length of the fragment
+ * @param[in] lastFragment This flag indicates whether the fragment is the
+ *   last one
+ * @return Error code
+ **/
+
+error_t ipv4ForwardFragment(NetInterface *destInterface, Ipv4Addr nextHop,
+   const NetBuffer *ipPacket, size_t ipPacketOffset, size_t headerLength,
+   size_t fragmentOffset, size_t length, bool_t lastFragment)
+{
+   error_t error;
+   uint32_t temp;
+   uint16_t offset;
+   size_t destOffset;
+   NetBuffer *destBuffer;
+   Ipv4Header *ipHeader;
+
+   //Allocate a buffer to hold the IPv4 header
+   destBuffer = ethAllocBuffer(headerLength, &destOffset);
+   //Failed to allocate memory?
+   if(destBuffer == NULL)
+      return ERROR_OUT_OF_MEMORY;
+
+   //Copy IPv4 header
+   error = netBufferCopy(destBuffer, destOffset, ipPacket, ipPacketOffset,
+      headerLength);
+
+   //Check status code
+   if(!error)
+   {
+      //The payload is referenced rather than copied
+      if(length > 0)
+      {
+         error = netBufferConcat(destBuffer, ipPacket, ipPacketOffset +
+            headerLength + fragmentOffset, length);
+      }
+   }
+
+   //Check status code
+   if(!error)
+   {
+      //Point to the IPv4 header
+      ipHeader = netBufferAt(destBuffer, destOffset);
+
+      //Every time a router forwards a packet, it decrements the TTL field
+      ipHeader->timeToLive--;
+
+      //Forwarding the packet as a whole?
+      if(fragmentOffset == 0 && lastFragment)
+      {
+         //The TTL is the most significant byte of a 16-bit word, so the
+         //header checksum can be incrementally updated (refer to RFC 1624)
+         temp = ntohs(ipHeader->headerChecksum) + 0x0100;
+         temp = (temp & 0xFFFF) + (temp >> 16);
+         ipHeader->headerChecksum = htons(temp);
+      }
+      else
+      {
+         //Retrieve the Fragment Offset field
+         offset = ntohs(ipHeader->fragmentOffset);
+
+         //The MF flag is set on all fragments but the last one. The last
+         //fragment inherits the MF flag of the original packet
+         if(!lastFragment)
+         {
+            offset |= IPV4_FLAG_MF;
+         }
+
+         //Adjust the offset of the fragment, in units of 8 bytes
+         offset += (uint16_t) (fragmentOffset / 8);
+
+         //Format the header of the fragment
+         ipHeader->totalLength = htons(headerLength + length);
+         ipHeader->fragmentOffset = htons(offset);
+
+         //The header checksum must be recomputed
+         ipHeader->headerChecksum = 0;
+         ipHeader->headerChecksum = ipCalcChecksum(ipHeader, headerLength);
+      }
+
+      //Send the packet over the outgoing link
+      error = ipv4SendForwardedPacket(destInterface, nextHop, destBuffer,
+         destOffset);
+   }
+
+   //Free previously allocated memory
+   netBufferFree(destBuffer);
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Send a forwarded IPv4 packet over the outgoing link
+ * @param[in] destInterface Outgoing network interface
+ * @param[in] nextHop IPv4 address of the next hop
+ * @param[in] buffer Multi-part buffer that holds the IPv4 packet
+ * @param[in] offset Offset to the first byte of the IPv4 packet
+ * @return Error code
+ **/
+
+error_t ipv4SendForwardedPacket(NetInterface *destInterface,
+   Ipv4Addr nextHop, NetBuffer *buffer, size_t offset)
+{
+   error_t error;
+   Ipv4Header *ipHeader;
+#if (ETH_SUPPORT == ENABLED)
+   NetInterface *physicalInterface;
+#endif
+
+   //Point to the IPv4 header
+   ipHeader = netBufferAt(buffer, offset);
+
+#if (ETH_SUPPORT == ENABLED)
+   //Point to the physical interface
+   physicalInterface = nicGetPhysicalInterface(destInterface);
+
+   //Ethernet interface?
+   if(physicalInterface->nicDriver != NULL &&
+      physicalInterface->nicDriver->type == NIC_TYPE_ETHERNET)
+   {
+      MacAddr destMacAddr;
+      NetTxAncillary ancillary;
+
+      //Additional options can be passed to the stack along with the packet
+      ancillary = NET_DEFAULT_TX_ANCILLARY;
+
+      //Check whether the next hop is a broadcast address
+      if(ipv4IsBroadcastAddr(destInterface, nextHop))
+      {
+         //Use of the broadcast MAC address to send the packet
+         destMacAddr = MAC_BROADCAST_ADDR;
+         //Successful address resolution
+         error = NO_ERROR;
+      }
+      else
+      {
+         //Resolve host address using ARP protocol
+         error = arpResolve(destInterface, nextHop, &destMacAddr);
+      }
+
+      //Successful address resolution?
+      if(!error)
+      {
+         //Debug message
+         TRACE_INFO("Forwarding IPv4 packet to %s (%" PRIuSIZE " bytes)...\r\n",
+            destInterface->name, netBufferGetLength(buffer) - offset);
+         //Dump IP header contents for debugging purpose
+         ipv4DumpHeader(ipHeader);
+
+         //Send Ethernet frame
+         error = ethSendFrame(destInterface, &destMacAddr, ETH_TYPE_IPV4,
+            buffer, offset, &ancillary);
+      }
+      //Address resolution in progress?
+      else if(error == ERROR_IN_PROGRESS)
+      {
+         //Debug message
+         TRACE_INFO("Enqueuing IPv4 packet (%" PRIuSIZE " bytes)...\r\n",
+            netBufferGetLength(buffer) - offset);
+         //Dump IP header contents for debugging purpose
+         ipv4DumpHeader(ipHeader);
+
+         //Enqueue packets waiting for address resolution
+         error = arpEnqueuePacket(destInterface, nextHop, buffer, offset,
+            &ancillary);
+      }
+      //Address resolution failed?
+      else
+      {
+         //Debug message
+         TRACE_WARNING("Cannot map IPv4 address to Ethernet address!\r\n");
+      }
+   }
+   else
+#endif
+#if (PPP_SUPPORT == ENABLED)
+   //PPP interface?
+   if(destInterface->nicDriver != NULL &&
+      destInterface->nicDriver->type == NIC_TYPE_PPP)
+   {
+      //Debug message
+      TRACE_INFO("Forwarding IPv4 packet to %s (%" PRIuSIZE " bytes)...\r\n",
+         destInterface->name, netBufferGetLength(buffer) - offset);
+      //Dump IP header contents for debugging purpose
+      ipv4DumpHeader(ipHeader);
+
+      //Send PPP frame
+      error = pppSendFrame(destInterface, buffer, offset, PPP_PROTOCOL_IP);
+   }
+   else
+#endif
+   //Unknown interface type?
+   {
+      //Report an error
+      error = ERROR_INVALID_INTERFACE;
+   }
+
+   //Return status code
+   return error;
+}
+
+#endif
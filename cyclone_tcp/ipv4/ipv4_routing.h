@@ -31,6 +31,7 @@
 //Dependencies
 #include "core/net.h"
 #include "ipv4/ipv4.h"
+#include "core/ip_trie.h"
 
 //IPv4 routing support
 #ifndef IPV4_ROUTING_SUPPORT
@@ -46,6 +47,20 @@
    #error IPV4_ROUTING_TABLE_SIZE parameter is not valid
 #endif
 
+//Size of the next-hop cache
+#ifndef IPV4_ROUTING_CACHE_SIZE
+   #define IPV4_ROUTING_CACHE_SIZE 16
+#elif (IPV4_ROUTING_CACHE_SIZE < 1)
+   #error IPV4_ROUTING_CACHE_SIZE parameter is not valid
+#endif
+
+//Forwarding of directed broadcasts (refer to RFC 2644)
+#ifndef IPV4_FORWARD_DIRECTED_BROADCAST
+   #define IPV4_FORWARD_DIRECTED_BROADCAST DISABLED
+#elif (IPV4_FORWARD_DIRECTED_BROADCAST != ENABLED && IPV4_FORWARD_DIRECTED_BROADCAST != DISABLED)
+   #error IPV4_FORWARD_DIRECTED_BROADCAST parameter is not valid
+#endif
+
 //C++ guard
 #ifdef __cplusplus
 extern "C" {
@@ -67,6 +82,17 @@ typedef struct
 } Ipv4RoutingTableEntry;
 
 
+/**
+ * @brief Next-hop cache entry
+ **/
+
+typedef struct
+{
+   Ipv4Addr destAddr;             ///<Destination address
+   Ipv4RoutingTableEntry *route;  ///<Route selected for this destination
+} Ipv4RoutingCacheEntry;
+
+
 //IPv4 routing related functions
 error_t ipv4InitRouting(void);
 error_t ipv4EnableRouting(NetInterface *interface, bool_t enable);
@@ -80,6 +106,17 @@ error_t ipv4DeleteAllRoutes(void);
 error_t ipv4ForwardPacket(NetInterface *srcInterface, const NetBuffer *ipPacket,
    size_t ipPacketOffset);
 
+Ipv4RoutingTableEntry *ipv4FindRoute(Ipv4Addr destAddr);
+bool_t ipv4CheckRoute(const void *route);
+void ipv4FlushRoutingCache(void);
+
+error_t ipv4ForwardFragment(NetInterface *destInterface, Ipv4Addr nextHop,
+   const NetBuffer *ipPacket, size_t ipPacketOffset, size_t headerLength,
+   size_t fragmentOffset, size_t length, bool_t lastFragment);
+
+error_t ipv4SendForwardedPacket(NetInterface *destInterface,
+   Ipv4Addr nextHop, NetBuffer *buffer, size_t offset);
+
 //C++ guard
 #ifdef __cplusplus
 }
@@ -123,7 +123,7 @@ error_t ipv6Init(NetInterface *interface)
    //Identification field is used to identify fragments of an original IP datagram
    context->identification = 0;
    //Initialize the reassembly queue
-   osMemset(context->fragQueue, 0, sizeof(context->fragQueue));
+   ipv6InitFragQueue(interface);
 #endif
 
    //Successful initialization
@@ -983,6 +983,12 @@ void ipv6ProcessPacket(NetInterface *interface, NetBuffer *ipPacket,
    IP_MIB_INC_COUNTER32(ipv6IfStatsTable[interface->index].ipIfStatsInOctets, length);
    IP_MIB_INC_COUNTER64(ipv6IfStatsTable[interface->index].ipIfStatsHCInOctets, length);
 
+#if (NET_LATENCY_SUPPORT == ENABLED)
+   //Time spent between the NIC and IP input
+   netLatencyCheckpoint(interface, NET_LATENCY_STAGE_LINK_RX,
+      &ancillary->latencyMark);
+#endif
+
    //Ensure the packet length is greater than 40 bytes
    if(length < sizeof(Ipv6Header))
    {
@@ -1181,6 +1187,11 @@ void ipv6ProcessPacket(NetInterface *interface, NetBuffer *ipPacket,
          //Packets addressed to the tentative address should be silently discarded
          if(!ipv6IsTentativeAddr(interface, &ipHeader->destAddr))
          {
+#if (NET_LATENCY_SUPPORT == ENABLED)
+            //Time spent in the IP layer
+            netLatencyCheckpoint(interface, NET_LATENCY_STAGE_IP_RX,
+               &ancillary->latencyMark);
+#endif
             //Process incoming TCP segment
             tcpProcessSegment(interface, &pseudoHeader, ipPacket, i, ancillary);
          }
@@ -1202,6 +1213,11 @@ void ipv6ProcessPacket(NetInterface *interface, NetBuffer *ipPacket,
          //Packets addressed to the tentative address should be silently discarded
          if(!ipv6IsTentativeAddr(interface, &ipHeader->destAddr))
          {
+#if (NET_LATENCY_SUPPORT == ENABLED)
+            //Time spent in the IP layer
+            netLatencyCheckpoint(interface, NET_LATENCY_STAGE_IP_RX,
+               &ancillary->latencyMark);
+#endif
             //Process incoming UDP datagram
             error = udpProcessDatagram(interface, &pseudoHeader, ipPacket, i,
                ancillary);
@@ -1671,6 +1687,11 @@ error_t ipv6SendDatagram(NetInterface *interface,
    IP_MIB_INC_COUNTER32(ipv6IfStatsTable[interface->index].ipIfStatsOutRequests, 1);
    IP_MIB_INC_COUNTER64(ipv6IfStatsTable[interface->index].ipIfStatsHCOutRequests, 1);
 
+#if (NET_LATENCY_SUPPORT == ENABLED)
+   //Start measuring the time spent on the TX path
+   ancillary->latencyMark = netLatencyGetTimestamp();
+#endif
+
    //Retrieve the length of payload
    length = netBufferGetLength(buffer) - offset;
 
@@ -1696,6 +1717,15 @@ error_t ipv6SendDatagram(NetInterface *interface,
       error = ipv6SendPacket(interface, pseudoHeader, 0, 0, buffer, offset,
          ancillary);
    }
+#if (NET_GSO_SUPPORT == ENABLED)
+   else if(ancillary->gsoSize != 0)
+   {
+      //The super-segment will be split into MSS-sized frames at the NIC
+      //boundary
+      error = ipv6SendPacket(interface, pseudoHeader, 0, 0, buffer, offset,
+         ancillary);
+   }
+#endif
    else
    {
 #if (IPV6_FRAG_SUPPORT == ENABLED)
@@ -1889,13 +1919,12 @@ error_t ipv6SendPacket(NetInterface *interface,
             if(error == NO_ERROR)
             {
                //Create a new Destination Cache entry
-               entry = ndpCreateDestCacheEntry(interface);
+               entry = ndpCreateDestCacheEntry(interface,
+                  &pseudoHeader->destAddr);
 
                //Destination cache entry successfully created?
                if(entry != NULL)
                {
-                  //Destination address
-                  entry->destAddr = pseudoHeader->destAddr;
                   //Address of the next hop
                   entry->nextHop = destIpAddr;
 
@@ -471,7 +471,11 @@ typedef struct
    Ipv6FilterEntry multicastFilter[IPV6_MULTICAST_FILTER_SIZE]; ///<Multicast filter table
 #if (IPV6_FRAG_SUPPORT == ENABLED)
    uint32_t identification;                                     ///<IPv6 fragment identification field
-   Ipv6FragDesc fragQueue[IPV6_MAX_FRAG_DATAGRAMS];             ///<IPv6 fragment reassembly queue
+   IpReasmQueue fragQueue;                                      ///<IPv6 fragment reassembly queue
+   IpReasmDesc fragDesc[IPV6_MAX_FRAG_DATAGRAMS];               ///<Datagrams being reassembled
+   uint32_t fragBitmap[IPV6_MAX_FRAG_DATAGRAMS][IP_REASM_BITMAP_SIZE(IPV6_MAX_FRAG_DATAGRAM_SIZE)]; ///<Coverage bitmaps
+   uint8_t *fragBlocks[IPV6_MAX_FRAG_DATAGRAMS][IP_REASM_BLOCK_COUNT(IPV6_MAX_FRAG_DATAGRAM_SIZE)]; ///<Memory blocks holding the payloads
+   Ipv6ReassemblyBuffer fragBuffer;                             ///<Buffer describing the reassembled datagram
 #endif
 } Ipv6Context;
 
@@ -183,9 +183,12 @@ void ipv6ParseFragmentHeader(NetInterface *interface, const NetBuffer *ipPacket,
    uint16_t offset;
    uint16_t dataFirst;
    uint16_t dataLast;
-   Ipv6FragDesc *frag;
-   Ipv6HoleDesc *hole;
-   Ipv6HoleDesc *prevHole;
+   uint8_t *p;
+   IpReasmKey key;
+   IpReasmQueue *queue;
+   IpReasmDesc *frag;
+   NetBuffer *datagram;
+   Ipv6Header *header;
    Ipv6Header *ipHeader;
    Ipv6FragmentHeader *fragHeader;
 
@@ -260,8 +263,18 @@ void ipv6ParseFragmentHeader(NetInterface *interface, const NetBuffer *ipPacket,
       return;
    }
 
+   //Point to the reassembly queue
+   queue = &interface->ipv6Context.fragQueue;
+
+   //Fragments are identified by the source address, the destination
+   //address and the identification field
+   osMemset(&key, 0, sizeof(IpReasmKey));
+   osMemcpy(key.srcAddr, &ipHeader->srcAddr, sizeof(Ipv6Addr));
+   osMemcpy(key.destAddr, &ipHeader->destAddr, sizeof(Ipv6Addr));
+   key.identification = ntohl(fragHeader->identification);
+
    //Search for a matching IP datagram being reassembled
-   frag = ipv6SearchFragQueue(interface, ipHeader, fragHeader);
+   frag = ipReasmFindDesc(queue, &key);
 
    //No matching entry in the reassembly queue?
    if(frag == NULL)
@@ -274,21 +287,38 @@ void ipv6ParseFragmentHeader(NetInterface *interface, const NetBuffer *ipPacket,
       return;
    }
 
-   //The very first fragment requires special handling
-   if((offset & IPV6_OFFSET_MASK) == 0)
+   //The unfragmentable part of the reassembled packet consists of all
+   //headers up to, but not including, the Fragment header of the first
+   //fragment packet
+   if(dataFirst == 0 && frag->header == NULL)
+   {
+      n = fragHeaderOffset - ipPacketOffset;
+   }
+   else
    {
-      uint8_t *p;
+      n = 0;
+   }
+
+   //Add the fragment to the datagram
+   error = ipReasmAddFragment(queue, frag, ipPacket, ipPacketOffset, n,
+      fragHeaderOffset + sizeof(Ipv6FragmentHeader), dataFirst, dataLast,
+      (offset & IPV6_FLAG_M) != 0);
 
-      //Calculate the length of the unfragmentable part
-      frag->unfragPartLength = fragHeaderOffset - ipPacketOffset;
+   //Duplicate fragment?
+   if(error == ERROR_MESSAGE_DISCARDED)
+   {
+      //Silently discard the incoming fragment
+      return;
+   }
+   else if(error)
+   {
+      //Number of failures detected by the IP reassembly algorithm
+      IP_MIB_INC_COUNTER32(ipv6SystemStats.ipSystemStatsReasmFails, 1);
+      IP_MIB_INC_COUNTER32(ipv6IfStatsTable[interface->index].ipIfStatsReasmFails, 1);
 
       //The size of the reconstructed datagram exceeds the maximum value?
-      if((frag->unfragPartLength + frag->fragPartLength) > IPV6_MAX_FRAG_DATAGRAM_SIZE)
+      if(error == ERROR_INVALID_LENGTH)
       {
-         //Number of failures detected by the IP reassembly algorithm
-         IP_MIB_INC_COUNTER32(ipv6SystemStats.ipSystemStatsReasmFails, 1);
-         IP_MIB_INC_COUNTER32(ipv6IfStatsTable[interface->index].ipIfStatsReasmFails, 1);
-
          //Retrieve the offset of the Fragment header within the packet
          n = fragHeaderOffset - ipPacketOffset;
          //Compute the exact offset of the Fragment Offset field
@@ -299,38 +329,19 @@ void ipv6ParseFragmentHeader(NetInterface *interface, const NetBuffer *ipPacket,
          //to the Fragment Offset field of the fragment packet
          icmpv6SendErrorMessage(interface, ICMPV6_TYPE_PARAM_PROBLEM,
             ICMPV6_CODE_INVALID_HEADER_FIELD, n, ipPacket, ipPacketOffset);
-
-         //Drop the reconstructed datagram
-         netBufferSetLength((NetBuffer *) &frag->buffer, 0);
-         //Exit immediately
-         return;
       }
 
-      //Make sure the unfragmentable part entirely fits in the first chunk
-      if(frag->unfragPartLength > frag->buffer.chunk[0].size)
-      {
-         //Number of failures detected by the IP reassembly algorithm
-         IP_MIB_INC_COUNTER32(ipv6SystemStats.ipSystemStatsReasmFails, 1);
-         IP_MIB_INC_COUNTER32(ipv6IfStatsTable[interface->index].ipIfStatsReasmFails, 1);
-
-         //Drop the reconstructed datagram
-         netBufferSetLength((NetBuffer *) &frag->buffer, 0);
-         //Exit immediately
-         return;
-      }
-
-      //Fix the length of the first chunk
-      frag->buffer.chunk[0].length = (uint16_t) frag->unfragPartLength;
-
-      //The unfragmentable part of the reassembled packet consists of all
-      //headers up to, but not including, the Fragment header of the first
-      //fragment packet
-      netBufferCopy((NetBuffer *) &frag->buffer, 0, ipPacket,
-         ipPacketOffset, frag->unfragPartLength);
+      //Drop the reconstructed datagram
+      ipReasmDeleteDesc(queue, frag);
+      //Exit immediately
+      return;
+   }
 
+   //The unfragmentable part has just been copied?
+   if(n > 0)
+   {
       //Point to the Next Header field of the last header
-      p = netBufferAt((NetBuffer *) &frag->buffer,
-         nextHeaderOffset - ipPacketOffset);
+      p = frag->header + (nextHeaderOffset - ipPacketOffset);
 
       //The Next Header field of the last header of the unfragmentable part is
       //obtained from the Next Header field of the first fragment's Fragment
@@ -338,174 +349,18 @@ void ipv6ParseFragmentHeader(NetInterface *interface, const NetBuffer *ipPacket,
       *p = fragHeader->nextHeader;
    }
 
-   //It may be necessary to increase the size of the buffer
-   if(dataLast > frag->fragPartLength)
-   {
-      //The size of the reconstructed datagram exceeds the maximum value?
-      if((frag->unfragPartLength + dataLast) > IPV6_MAX_FRAG_DATAGRAM_SIZE)
-      {
-         //Number of failures detected by the IP reassembly algorithm
-         IP_MIB_INC_COUNTER32(ipv6SystemStats.ipSystemStatsReasmFails, 1);
-         IP_MIB_INC_COUNTER32(ipv6IfStatsTable[interface->index].ipIfStatsReasmFails, 1);
-
-         //Retrieve the offset of the Fragment header within the packet
-         n = fragHeaderOffset - ipPacketOffset;
-         //Compute the exact offset of the Fragment Offset field
-         n += (uint8_t *) &fragHeader->fragmentOffset - (uint8_t *) fragHeader;
-
-         //The fragment must be discarded and an ICMP Parameter Problem
-         //message should be sent to the source of the fragment, pointing
-         //to the Fragment Offset field of the fragment packet
-         icmpv6SendErrorMessage(interface, ICMPV6_TYPE_PARAM_PROBLEM,
-            ICMPV6_CODE_INVALID_HEADER_FIELD, n, ipPacket, ipPacketOffset);
-
-         //Drop the reconstructed datagram
-         netBufferSetLength((NetBuffer *) &frag->buffer, 0);
-         //Exit immediately
-         return;
-      }
-
-      //Adjust the size of the reconstructed datagram
-      error = netBufferSetLength((NetBuffer *) &frag->buffer,
-         frag->unfragPartLength + dataLast + sizeof(Ipv6HoleDesc));
-
-      //Any error to report?
-      if(error)
-      {
-         //Number of failures detected by the IP reassembly algorithm
-         IP_MIB_INC_COUNTER32(ipv6SystemStats.ipSystemStatsReasmFails, 1);
-         IP_MIB_INC_COUNTER32(ipv6IfStatsTable[interface->index].ipIfStatsReasmFails, 1);
-
-         //Drop the reconstructed datagram
-         netBufferSetLength((NetBuffer *) &frag->buffer, 0);
-         //Exit immediately
-         return;
-      }
-
-      //Actual length of the fragmentable part
-      frag->fragPartLength = dataLast;
-   }
-
-   //Select the first hole descriptor from the list
-   hole = ipv6FindHole(frag, frag->firstHole);
-   //Keep track of the previous hole in the list
-   prevHole = NULL;
-
-   //Iterate through the hole descriptors
-   while(hole != NULL)
-   {
-      //Save lower and upper boundaries for later use
-      uint16_t holeFirst = hole->first;
-      uint16_t holeLast = hole->last;
-
-      //Check whether the newly arrived fragment interacts with this hole
-      //in some way
-      if(dataFirst < holeLast && dataLast > holeFirst)
-      {
-#if (IPV6_OVERLAPPING_FRAG_SUPPORT == DISABLED)
-         //When reassembling an IPv6 datagram, if one or more its constituent
-         //fragments is determined to be an overlapping fragment, the entire
-         //datagram must be silently discarded (refer to RFC 5722, section 4)
-         if(dataFirst < holeFirst || dataLast > holeLast)
-         {
-            //Number of failures detected by the IP reassembly algorithm
-            IP_MIB_INC_COUNTER32(ipv6SystemStats.ipSystemStatsReasmFails, 1);
-            IP_MIB_INC_COUNTER32(ipv6IfStatsTable[interface->index].ipIfStatsReasmFails, 1);
-
-            //Drop the reconstructed datagram
-            netBufferSetLength((NetBuffer *) &frag->buffer, 0);
-            //Exit immediately
-            return;
-         }
-#endif
-         //The current descriptor is no longer valid. We will destroy it, and in
-         //the next two steps, we will determine whether or not it is necessary
-         //to create any new hole descriptors
-         if(prevHole != NULL)
-         {
-            prevHole->next = hole->next;
-         }
-         else
-         {
-            frag->firstHole = hole->next;
-         }
-
-         //Is there still a hole at the beginning of the segment?
-         if(dataFirst > holeFirst)
-         {
-            //Create a new entry that describes this hole
-            hole = ipv6FindHole(frag, holeFirst);
-            hole->first = holeFirst;
-            hole->last = dataFirst;
-
-            //Insert the newly created entry into the hole descriptor list
-            if(prevHole != NULL)
-            {
-               hole->next = prevHole->next;
-               prevHole->next = hole->first;
-            }
-            else
-            {
-               hole->next = frag->firstHole;
-               frag->firstHole = hole->first;
-            }
-
-            //Always keep track of the previous hole
-            prevHole = hole;
-         }
-
-         //Is there still a hole at the end of the segment?
-         if(dataLast < holeLast && (offset & IPV6_FLAG_M) != 0)
-         {
-            //Create a new entry that describes this hole
-            hole = ipv6FindHole(frag, dataLast);
-            hole->first = dataLast;
-            hole->last = holeLast;
-
-            //Insert the newly created entry into the hole descriptor list
-            if(prevHole != NULL)
-            {
-               hole->next = prevHole->next;
-               prevHole->next = hole->first;
-            }
-            else
-            {
-               hole->next = frag->firstHole;
-               frag->firstHole = hole->first;
-            }
-
-            //Always keep track of the previous hole
-            prevHole = hole;
-         }
-      }
-      else
-      {
-         //The newly arrived fragment does not interact with the current hole
-         prevHole = hole;
-      }
-
-      //Select the next hole descriptor from the list
-      hole = ipv6FindHole(frag, prevHole ? prevHole->next : frag->firstHole);
-   }
-
-   //Copy data from the fragment to the reassembly buffer
-   netBufferCopy((NetBuffer *) &frag->buffer, frag->unfragPartLength + dataFirst,
-      ipPacket, fragHeaderOffset + sizeof(Ipv6FragmentHeader), length);
+   //Dump the list of fragments
+   ipReasmDumpDesc(frag);
 
-   //Dump hole descriptor list
-   ipv6DumpHoleList(frag);
-
-   //If the hole descriptor list is empty, the reassembly process is now
+   //If all the blocks have been received, the reassembly process is now
    //complete
-   if(ipv6FindHole(frag, frag->firstHole) == NULL)
+   if(ipReasmIsComplete(frag))
    {
-      //Discard the extra hole descriptor that follows the reconstructed
-      //datagram
-      error = netBufferSetLength((NetBuffer *) &frag->buffer,
-         frag->unfragPartLength + frag->fragPartLength);
+      //Chain the fragments together
+      datagram = ipReasmGetDatagram(queue, frag);
 
-      //Check status code
-      if(error)
+      //Check whether the reassembled datagram is valid
+      if(datagram == NULL)
       {
          //Number of failures detected by the IP reassembly algorithm
          IP_MIB_INC_COUNTER32(ipv6SystemStats.ipSystemStatsReasmFails, 1);
@@ -514,23 +369,22 @@ void ipv6ParseFragmentHeader(NetInterface *interface, const NetBuffer *ipPacket,
       else
       {
          //Point to the IPv6 header
-         Ipv6Header *datagram = netBufferAt((NetBuffer *) &frag->buffer, 0);
+         header = (Ipv6Header *) frag->header;
 
          //Fix the Payload Length field
-         datagram->payloadLen = htons(frag->unfragPartLength +
-            frag->fragPartLength - sizeof(Ipv6Header));
+         header->payloadLen = htons(frag->headerLen + frag->dataLen -
+            sizeof(Ipv6Header));
 
          //Number of IP datagrams successfully reassembled
          IP_MIB_INC_COUNTER32(ipv6SystemStats.ipSystemStatsReasmOKs, 1);
          IP_MIB_INC_COUNTER32(ipv6IfStatsTable[interface->index].ipIfStatsReasmOKs, 1);
 
          //Pass the original IPv6 datagram to the higher protocol layer
-         ipv6ProcessPacket(interface, (NetBuffer *) &frag->buffer, 0,
-            ancillary);
+         ipv6ProcessPacket(interface, datagram, 0, ancillary);
       }
 
       //Release previously allocated memory
-      netBufferSetLength((NetBuffer *) &frag->buffer, 0);
+      ipReasmDeleteDesc(queue, frag);
    }
 }
 
@@ -546,22 +400,26 @@ void ipv6ParseFragmentHeader(NetInterface *interface, const NetBuffer *ipPacket,
 
 void ipv6FragTick(NetInterface *interface)
 {
-   error_t error;
    uint_t i;
    systime_t time;
-   Ipv6HoleDesc *hole;
+   IpReasmQueue *queue;
+   IpReasmDesc *frag;
+   NetBuffer *datagram;
 
    //Get current time
    time = osGetSystemTime();
 
+   //Point to the reassembly queue
+   queue = &interface->ipv6Context.fragQueue;
+
    //Loop through the reassembly queue
-   for(i = 0; i < IPV6_MAX_FRAG_DATAGRAMS; i++)
+   for(i = 0; i < queue->size; i++)
    {
       //Point to the current entry in the reassembly queue
-      Ipv6FragDesc *frag = &interface->ipv6Context.fragQueue[i];
+      frag = &queue->table[i];
 
       //Make sure the entry is currently in use
-      if(frag->buffer.chunkCount > 0)
+      if(frag->used)
       {
          //If the timer runs out, the partially-reassembled datagram must be
          //discarded and ICMPv6 Time Exceeded message sent to the source host
@@ -569,36 +427,28 @@ void ipv6FragTick(NetInterface *interface)
          {
             //Debug message
             TRACE_INFO("IPv6 fragment reassembly timeout...\r\n");
-            //Dump IP header contents for debugging purpose
-            ipv6DumpHeader(frag->buffer.chunk[0].address);
 
             //Number of failures detected by the IP reassembly algorithm
             IP_MIB_INC_COUNTER32(ipv6SystemStats.ipSystemStatsReasmFails, 1);
             IP_MIB_INC_COUNTER32(ipv6IfStatsTable[interface->index].ipIfStatsReasmFails, 1);
 
-            //Point to the first hole descriptor
-            hole = ipv6FindHole(frag, frag->firstHole);
+            //Retrieve the data received contiguously from offset zero
+            datagram = ipReasmGetDatagram(queue, frag);
 
             //Make sure the fragment zero has been received before sending an
             //ICMPv6 message
-            if(hole != NULL && hole->first > 0)
+            if(datagram != NULL && netBufferGetLength(datagram) > frag->headerLen)
             {
-               //Fix the size of the reconstructed datagram
-               error = netBufferSetLength((NetBuffer *) &frag->buffer,
-                  frag->unfragPartLength + hole->first);
-
-               //Check status code
-               if(!error)
-               {
-                  //Send an ICMPv6 Time Exceeded message
-                  icmpv6SendErrorMessage(interface, ICMPV6_TYPE_TIME_EXCEEDED,
-                     ICMPV6_CODE_REASSEMBLY_TIME_EXCEEDED, 0,
-                     (NetBuffer *) &frag->buffer, 0);
-               }
+               //Dump IP header contents for debugging purpose
+               ipv6DumpHeader((Ipv6Header *) frag->header);
+
+               //Send an ICMPv6 Time Exceeded message
+               icmpv6SendErrorMessage(interface, ICMPV6_TYPE_TIME_EXCEEDED,
+                  ICMPV6_CODE_REASSEMBLY_TIME_EXCEEDED, 0, datagram, 0);
             }
 
             //Drop the partially reconstructed datagram
-            netBufferSetLength((NetBuffer *) &frag->buffer, 0);
+            ipReasmDeleteDesc(queue, frag);
          }
       }
    }
@@ -606,109 +456,24 @@ void ipv6FragTick(NetInterface *interface)
 
 
 /**
- * @brief Search for a matching datagram in the reassembly queue
+ * @brief Initialize IPv6 reassembly queue
  * @param[in] interface Underlying network interface
- * @param[in] packet Incoming IPv6 packet
- * @param[in] header Pointer to the Fragment header
- * @return Matching fragment descriptor
  **/
 
-Ipv6FragDesc *ipv6SearchFragQueue(NetInterface *interface,
-   const Ipv6Header *packet, const Ipv6FragmentHeader *header)
+void ipv6InitFragQueue(NetInterface *interface)
 {
-   error_t error;
-   uint_t i;
-   Ipv6Header *datagram;
-   Ipv6FragDesc *frag;
-   Ipv6HoleDesc *hole;
-
-   //Search for a matching IP datagram being reassembled
-   for(i = 0; i < IPV6_MAX_FRAG_DATAGRAMS; i++)
-   {
-      //Point to the current entry in the reassembly queue
-      frag = &interface->ipv6Context.fragQueue[i];
-
-      //Check whether the current entry is used?
-      if(frag->buffer.chunkCount > 0)
-      {
-         //Point to the corresponding datagram
-         datagram = netBufferAt((NetBuffer *) &frag->buffer, 0);
-
-         //Check source and destination addresses
-         if(!ipv6CompAddr(&datagram->srcAddr, &packet->srcAddr))
-            continue;
-         if(!ipv6CompAddr(&datagram->destAddr, &packet->destAddr))
-            continue;
-
-         //Compare fragment identification fields
-         if(frag->identification != header->identification)
-            continue;
-
-         //A matching entry has been found in the reassembly queue
-         return frag;
-      }
-   }
-
-   //If the current packet does not match an existing entry
-   //in the reassembly queue, then create a new entry
-   for(i = 0; i < IPV6_MAX_FRAG_DATAGRAMS; i++)
-   {
-      //Point to the current entry in the reassembly queue
-      frag = &interface->ipv6Context.fragQueue[i];
-
-      //The current entry is free?
-      if(!frag->buffer.chunkCount)
-      {
-         //Number of chunks that comprise the reassembly buffer
-         frag->buffer.maxChunkCount = arraysize(frag->buffer.chunk);
-
-         //Allocate sufficient memory to hold the IPv6 header and
-         //the first hole descriptor
-         error = netBufferSetLength((NetBuffer *) &frag->buffer,
-            NET_MEM_POOL_BUFFER_SIZE + sizeof(Ipv6HoleDesc));
-
-         //Failed to allocate memory?
-         if(error)
-         {
-            //Clean up side effects
-            netBufferSetLength((NetBuffer *) &frag->buffer, 0);
-            //Exit immediately
-            return NULL;
-         }
-
-         //Initial length of the reconstructed datagram
-         frag->unfragPartLength = sizeof(Ipv6Header);
-         frag->fragPartLength = 0;
-
-         //Fix the length of the first chunk
-         frag->buffer.chunk[0].length = (uint16_t) frag->unfragPartLength;
-         //Copy IPv6 header from the incoming fragment
-         netBufferWrite((NetBuffer *) &frag->buffer, 0, packet, frag->unfragPartLength);
-
-         //Save current time
-         frag->timestamp = osGetSystemTime();
-         //Record fragment identification field
-         frag->identification = header->identification;
-         //Create a new entry in the hole descriptor list
-         frag->firstHole = 0;
-
-         //Point to first hole descriptor
-         hole = ipv6FindHole(frag, frag->firstHole);
-         //The entry describes the datagram as being completely missing
-         hole->first = 0;
-         hole->last = IPV6_INFINITY;
-         hole->next = IPV6_INFINITY;
-
-         //Dump hole descriptor list
-         ipv6DumpHoleList(frag);
-
-         //Return the matching fragment descriptor
-         return frag;
-      }
-   }
-
-   //The reassembly queue is full
-   return NULL;
+   Ipv6Context *context;
+
+   //Point to the IPv6 context
+   context = &interface->ipv6Context;
+
+   //Overlapping fragments are rejected unless otherwise specified (refer to
+   //RFC 5722, section 4)
+   ipReasmInit(&context->fragQueue, context->fragDesc,
+      &context->fragBitmap[0][0], &context->fragBlocks[0][0],
+      (NetBuffer *) &context->fragBuffer, IPV6_MAX_FRAG_DATAGRAMS,
+      IPV6_MAX_FRAG_DATAGRAM_SIZE, IPV6_FRAG_MAX_MEM_SIZE,
+      (IPV6_OVERLAPPING_FRAG_SUPPORT == ENABLED) ? TRUE : FALSE);
 }
 
 
@@ -719,57 +484,8 @@ Ipv6FragDesc *ipv6SearchFragQueue(NetInterface *interface,
 
 void ipv6FlushFragQueue(NetInterface *interface)
 {
-   uint_t i;
-
-   //Loop through the reassembly queue
-   for(i = 0; i < IPV6_MAX_FRAG_DATAGRAMS; i++)
-   {
-      //Drop any partially reconstructed datagram
-      netBufferSetLength((NetBuffer *) &interface->ipv6Context.fragQueue[i].buffer, 0);
-   }
-}
-
-
-/**
- * @brief Retrieve hole descriptor
- * @param[in] frag IPv6 fragment descriptor
- * @param[in] offset Offset of the hole
- * @return A pointer to the hole descriptor is returned if the
- *   specified offset is valid. Otherwise NULL is returned
- **/
-
-Ipv6HoleDesc *ipv6FindHole(Ipv6FragDesc *frag, uint16_t offset)
-{
-   //Return a pointer to the hole descriptor
-   return netBufferAt((NetBuffer *) &frag->buffer, frag->unfragPartLength + offset);
-}
-
-
-/**
- * @brief Dump hole descriptor list
- * @param[in] frag IPv6 fragment descriptor
- **/
-
-void ipv6DumpHoleList(Ipv6FragDesc *frag)
-{
-//Check debugging level
-#if (TRACE_LEVEL >= TRACE_LEVEL_DEBUG)
-   Ipv6HoleDesc *hole;
-
-   //Debug message
-   TRACE_DEBUG("Hole descriptor list:\r\n");
-   //Select the first hole descriptor from the list
-   hole = ipv6FindHole(frag, frag->firstHole);
-
-   //Loop through the hole descriptor list
-   while(hole != NULL)
-   {
-      //Display current hole
-      TRACE_DEBUG("  %" PRIu16 " - %" PRIu16 "\r\n", hole->first, hole->last);
-      //Select the next hole descriptor from the list
-      hole = ipv6FindHole(frag, hole->next);
-   }
-#endif
+   //Drop any partially reconstructed datagram
+   ipReasmFlush(&interface->ipv6Context.fragQueue);
 }
 
 #endif
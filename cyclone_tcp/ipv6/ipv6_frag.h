@@ -31,6 +31,7 @@
 //Dependencies
 #include "core/net.h"
 #include "ipv6/ipv6.h"
+#include "core/ip_reasm.h"
 
 //IPv6 fragmentation support
 #ifndef IPV6_FRAG_SUPPORT
@@ -56,7 +57,7 @@
 //Maximum number of fragmented packets the host will accept
 //and hold in the reassembly queue simultaneously
 #ifndef IPV6_MAX_FRAG_DATAGRAMS
-   #define IPV6_MAX_FRAG_DATAGRAMS 4
+   #define IPV6_MAX_FRAG_DATAGRAMS 16
 #elif (IPV6_MAX_FRAG_DATAGRAMS < 1)
    #error IPV6_MAX_FRAG_DATAGRAMS parameter is not valid
 #endif
@@ -75,8 +76,12 @@
    #error IPV6_FRAG_TIME_TO_LIVE parameter is not valid
 #endif
 
-//Infinity is implemented by a very large integer
-#define IPV6_INFINITY 0xFFFF
+//Maximum amount of memory the reassembly queue may hold, in bytes
+#ifndef IPV6_FRAG_MAX_MEM_SIZE
+   #define IPV6_FRAG_MAX_MEM_SIZE (IPV6_MAX_FRAG_DATAGRAMS * IPV6_MAX_FRAG_DATAGRAM_SIZE)
+#elif (IPV6_FRAG_MAX_MEM_SIZE < IPV6_MAX_FRAG_DATAGRAM_SIZE)
+   #error IPV6_FRAG_MAX_MEM_SIZE parameter is not valid
+#endif
 
 //C++ guard
 #ifdef __cplusplus
@@ -84,34 +89,6 @@ extern "C" {
 #endif
 
 
-//CC-RX, CodeWarrior or Win32 compiler?
-#if defined(__CCRX__)
-   #pragma pack
-#elif defined(__CWCC__) || defined(_WIN32)
-   #pragma pack(push, 1)
-#endif
-
-
-/**
- * @brief Hole descriptor
- **/
-
-typedef __packed_struct
-{
-   uint16_t first;
-   uint16_t last;
-   uint16_t next;
-} Ipv6HoleDesc;
-
-
-//CC-RX, CodeWarrior or Win32 compiler?
-#if defined(__CCRX__)
-   #pragma unpack
-#elif defined(__CWCC__) || defined(_WIN32)
-   #pragma pack(pop)
-#endif
-
-
 /**
  * @brief Reassembly buffer
  **/
@@ -120,25 +97,10 @@ typedef struct
 {
    uint_t chunkCount;
    uint_t maxChunkCount;
-   ChunkDesc chunk[N(IPV6_MAX_FRAG_DATAGRAM_SIZE) + 1];
+   ChunkDesc chunk[IP_REASM_CHUNK_COUNT(IPV6_MAX_FRAG_DATAGRAM_SIZE)];
 } Ipv6ReassemblyBuffer;
 
 
-/**
- * @brief Fragmented packet descriptor
- **/
-
-typedef struct
-{
-   systime_t timestamp;         ///<Time at which the first fragment was received
-   uint32_t identification;     ///<Fragment identification field
-   size_t unfragPartLength;     ///<Length of the unfragmentable part
-   size_t fragPartLength;       ///<Length of the fragmentable part
-   uint16_t firstHole;          ///<Index of the first hole
-   Ipv6ReassemblyBuffer buffer; ///<Buffer containing the reassembled datagram
-} Ipv6FragDesc;
-
-
 //Tick counter to handle periodic operations
 extern systime_t ipv6FragTickCounter;
 
@@ -153,14 +115,9 @@ void ipv6ParseFragmentHeader(NetInterface *interface, const NetBuffer *ipPacket,
 
 void ipv6FragTick(NetInterface *interface);
 
-Ipv6FragDesc *ipv6SearchFragQueue(NetInterface *interface,
-   const Ipv6Header *packet, const Ipv6FragmentHeader *header);
-
+void ipv6InitFragQueue(NetInterface *interface);
 void ipv6FlushFragQueue(NetInterface *interface);
 
-Ipv6HoleDesc *ipv6FindHole(Ipv6FragDesc *frag, uint16_t offset);
-void ipv6DumpHoleList(Ipv6FragDesc *frag);
-
 //C++ guard
 #ifdef __cplusplus
 }
@@ -29,12 +29,12 @@
 #define TRACE_LEVEL IPV6_TRACE_LEVEL
 
 //Dependencies
-#include <limits.h>
 #include "core/net.h"
 #include "core/ip.h"
 #include "ipv6/ipv6.h"
 #include "ipv6/ipv6_misc.h"
 #include "ipv6/ipv6_routing.h"
+#include "core/ip_trie.h"
 #include "ipv6/icmpv6.h"
 #include "ipv6/ndp.h"
 #include "debug.h"
@@ -44,6 +44,9 @@
 
 //IPv6 routing table
 static Ipv6RoutingTableEntry ipv6RoutingTable[IPV6_ROUTING_TABLE_SIZE];
+//Longest prefix match trie
+static IpTrie ipv6RoutingTrie;
+static IpTrieNode ipv6RoutingTrieNodes[2 * IPV6_ROUTING_TABLE_SIZE];
 
 
 /**
@@ -56,6 +59,10 @@ error_t ipv6InitRouting(void)
    //Clear the routing table
    osMemset(ipv6RoutingTable, 0, sizeof(ipv6RoutingTable));
 
+   //Initialize the trie that indexes the routing table
+   ipTrieInit(&ipv6RoutingTrie, ipv6RoutingTrieNodes,
+      arraysize(ipv6RoutingTrieNodes));
+
    //Successful initialization
    return NO_ERROR;
 }
@@ -143,15 +150,36 @@ error_t ipv6AddRoute(const Ipv6Addr *prefix, uint_t prefixLen,
    //If the routing table does not contain the specified destination,
    //then a new entry should be created
    if(i >= IPV6_ROUTING_TABLE_SIZE)
-      entry = firstFreeEntry;
+   {
+      //Check whether the routing table runs out of space
+      if(firstFreeEntry != NULL)
+      {
+         //Network destination
+         firstFreeEntry->prefix = *prefix;
+         firstFreeEntry->prefixLen = prefixLen;
 
-   //Check whether the routing table runs out of space
-   if(entry != NULL)
+         //Index the new entry
+         error = ipTrieInsert(&ipv6RoutingTrie, firstFreeEntry->prefix.b,
+            prefixLen, firstFreeEntry);
+      }
+      else
+      {
+         //The routing table is full
+         error = ERROR_FAILURE;
+      }
+
+      //Point to the new entry
+      entry = firstFreeEntry;
+   }
+   else
    {
-      //Network destination
-      entry->prefix = *prefix;
-      entry->prefixLen = prefixLen;
+      //The entry is already indexed
+      error = NO_ERROR;
+   }
 
+   //Check status code
+   if(!error)
+   {
       //Interface where to forward the packet
       entry->interface = interface;
 
@@ -169,14 +197,6 @@ error_t ipv6AddRoute(const Ipv6Addr *prefix, uint_t prefixLen,
       entry->metric = metric;
       //The entry is now valid
       entry->valid = TRUE;
-
-      //Successful processing
-      error = NO_ERROR;
-   }
-   else
-   {
-      //The routing table is full
-      error = ERROR_FAILURE;
    }
 
    //Release exclusive access
@@ -221,6 +241,10 @@ error_t ipv6DeleteRoute(const Ipv6Addr *prefix, uint_t prefixLen)
             //Check whether the current entry matches the specified destination
             if(ipv6CompPrefix(&entry->prefix, prefix, prefixLen))
             {
+               //Remove the entry from the trie
+               ipTrieDelete(&ipv6RoutingTrie, entry->prefix.b,
+                  entry->prefixLen);
+
                //Delete current entry
                entry->valid = FALSE;
                //The route was successfully deleted from the routing table
@@ -249,6 +273,8 @@ error_t ipv6DeleteAllRoutes(void)
    osAcquireMutex(&netMutex);
    //Clear the routing table
    osMemset(ipv6RoutingTable, 0, sizeof(ipv6RoutingTable));
+   //Clear the trie
+   ipTrieFlush(&ipv6RoutingTrie);
    //Release exclusive access
    osReleaseMutex(&netMutex);
 
@@ -269,10 +295,6 @@ error_t ipv6ForwardPacket(NetInterface *srcInterface, NetBuffer *ipPacket,
    size_t ipPacketOffset)
 {
    error_t error;
-   uint_t i;
-   uint_t metric;
-   uint_t prefixLen;
-   bool_t match;
    size_t length;
    size_t destOffset;
    NetInterface *destInterface;
@@ -333,77 +355,28 @@ error_t ipv6ForwardPacket(NetInterface *srcInterface, NetBuffer *ipPacket,
    }
    else
    {
-      //Lowest metric value
-      metric = UINT_MAX;
-      //Longest prefix length
-      prefixLen = 0;
       //Outgoing network interface
       destInterface = NULL;
 
-      //Route determination process
-      for(i = 0; i < IPV6_ROUTING_TABLE_SIZE; i++)
+      //The longest matching route is the most specific route to the
+      //destination IPv6 address
+      entry = ipTrieLookup(&ipv6RoutingTrie, ipHeader->destAddr.b, 128,
+         ipv6CheckRoute);
+
+      //Matching entry?
+      if(entry != NULL)
       {
-         //Point to the current entry
-         entry = &ipv6RoutingTable[i];
+         //Outgoing interface on which to forward the packet
+         destInterface = entry->interface;
 
-         //Valid entry?
-         if(entry->valid && entry->interface != NULL)
+         //Next hop
+         if(!ipv6CompAddr(&entry->nextHop, &IPV6_UNSPECIFIED_ADDR))
          {
-            //Clear flag
-            match = FALSE;
-
-            //Do not forward any IP packets to an interface that has not
-            //been assigned a valid link-local address...
-            if(ipv6GetLinkLocalAddrState(entry->interface) == IPV6_ADDR_STATE_PREFERRED)
-            {
-               //If routing is enabled on the interface, then the router
-               //can forward packets to the interface
-               if(entry->interface->ipv6Context.isRouter)
-               {
-                  //Compare the destination address with the current entry for a match
-                  if(ipv6CompPrefix(&ipHeader->destAddr, &entry->prefix, entry->prefixLen))
-                  {
-                     //The longest matching route is the most specific route to the
-                     //destination IPv6 address...
-                     if(entry->prefixLen > prefixLen)
-                     {
-                        //Give the current route the higher precedence
-                        match = TRUE;
-                     }
-                     else if(entry->prefixLen == prefixLen)
-                     {
-                        //If multiple entries with the longest match are found, the
-                        //router uses the lowest metric to select the best route
-                        if(entry->metric < metric)
-                        {
-                           //Give the current route the higher precedence
-                           match = TRUE;
-                        }
-                     }
-                  }
-               }
-            }
-
-            //Matching entry?
-            if(match)
-            {
-               //Select the current route
-               metric = entry->metric;
-               prefixLen = entry->prefixLen;
-
-               //Outgoing interface on which to forward the packet
-               destInterface = entry->interface;
-
-               //Next hop
-               if(!ipv6CompAddr(&entry->nextHop, &IPV6_UNSPECIFIED_ADDR))
-               {
-                  destIpAddr = entry->nextHop;
-               }
-               else
-               {
-                  destIpAddr = ipHeader->destAddr;
-               }
-            }
+            destIpAddr = entry->nextHop;
+         }
+         else
+         {
+            destIpAddr = ipHeader->destAddr;
          }
       }
    }
@@ -581,7 +554,7 @@ error_t ipv6ForwardPacket(NetInterface *srcInterface, NetBuffer *ipPacket,
                ipv6DumpHeader(ipHeader);
 
                //Send Ethernet frame
-               error = ethSendFrame(destInterface, NULL, &destMacAddr, ETH_TYPE_IPV6,
+               error = ethSendFrame(destInterface, &destMacAddr, ETH_TYPE_IPV6,
                   destBuffer, destOffset, &ancillary);
             }
             //Address resolution in progress?
@@ -662,4 +635,32 @@ error_t ipv6ForwardPacket(NetInterface *srcInterface, NetBuffer *ipPacket,
    return error;
 }
 
+
+/**
+ * @brief Check whether a route can be used to forward packets
+ * @param[in] route Pointer to the routing table entry
+ * @return TRUE if the route is usable, else FALSE
+ **/
+
+bool_t ipv6CheckRoute(const void *route)
+{
+   const Ipv6RoutingTableEntry *entry;
+
+   //Point to the routing table entry
+   entry = (const Ipv6RoutingTableEntry *) route;
+
+   //Valid entry?
+   if(!entry->valid || entry->interface == NULL)
+      return FALSE;
+
+   //Do not forward any IP packets to an interface that has not been
+   //assigned a valid link-local address
+   if(ipv6GetLinkLocalAddrState(entry->interface) != IPV6_ADDR_STATE_PREFERRED)
+      return FALSE;
+
+   //If routing is enabled on the interface, then the router can forward
+   //packets to the interface
+   return entry->interface->ipv6Context.isRouter;
+}
+
 #endif
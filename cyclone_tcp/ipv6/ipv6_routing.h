@@ -31,6 +31,7 @@
 //Dependencies
 #include "core/net.h"
 #include "ipv6/ipv6.h"
+#include "core/ip_trie.h"
 
 //IPv6 routing support
 #ifndef IPV6_ROUTING_SUPPORT
@@ -80,6 +81,8 @@ error_t ipv6DeleteAllRoutes(void);
 error_t ipv6ForwardPacket(NetInterface *srcInterface, NetBuffer *ipPacket,
    size_t ipPacketOffset);
 
+bool_t ipv6CheckRoute(const void *route);
+
 //C++ guard
 #ifdef __cplusplus
 }
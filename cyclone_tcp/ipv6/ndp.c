@@ -64,6 +64,8 @@ error_t ndpInit(NetInterface *interface)
 
    //Clear the NDP context
    osMemset(context, 0, sizeof(NdpContext));
+   //Initialize the Neighbor and Destination caches
+   ndpInitCache(interface);
 
    //Initialize interface specific variables
    context->reachableTime = NDP_REACHABLE_TIME;
@@ -159,7 +161,7 @@ error_t ndpAddStaticEntry(NetInterface *interface, const Ipv6Addr *ipAddr,
    else
    {
       //Create a new entry in the Neighbor cache
-      entry = ndpCreateNeighborCacheEntry(interface);
+      entry = ndpCreateNeighborCacheEntry(interface, ipAddr);
    }
 
    //Neighbor cache entry successfully created?
@@ -221,7 +223,7 @@ error_t ndpRemoveStaticEntry(NetInterface *interface, const Ipv6Addr *ipAddr)
    if(entry != NULL && entry->state == NDP_STATE_PERMANENT)
    {
       //Delete Neighbor cache entry
-      ndpChangeState(entry, NDP_STATE_NONE);
+      ndpDeleteNeighborCacheEntry(interface, entry);
       //Successful processing
       error = NO_ERROR;
    }
@@ -262,8 +264,18 @@ error_t ndpResolve(NetInterface *interface, const Ipv6Addr *ipAddr,
       //Check the state of the Neighbor cache entry
       if(entry->state == NDP_STATE_INCOMPLETE)
       {
-         //The address resolution is already in progress
-         error = ERROR_IN_PROGRESS;
+         //Check whether address resolution has recently failed
+         if(entry->retransmitCount >= NDP_MAX_MULTICAST_SOLICIT)
+         {
+            //Do not flood the link with solicitations for an unreachable
+            //neighbor
+            error = ERROR_ADDRESS_NOT_FOUND;
+         }
+         else
+         {
+            //The address resolution is already in progress
+            error = ERROR_IN_PROGRESS;
+         }
       }
       else if(entry->state == NDP_STATE_STALE)
       {
@@ -293,14 +305,11 @@ error_t ndpResolve(NetInterface *interface, const Ipv6Addr *ipAddr,
       if(interface->ndpContext.enable)
       {
          //If no entry exists, then create a new one
-         entry = ndpCreateNeighborCacheEntry(interface);
+         entry = ndpCreateNeighborCacheEntry(interface, ipAddr);
 
          //Neighbor cache entry successfully created?
          if(entry != NULL)
          {
-            //Record the IPv6 address whose MAC address is unknown
-            entry->ipAddr = *ipAddr;
-
             //Reset retransmission counter
             entry->retransmitCount = 0;
             //No packet are pending in the transmit queue
@@ -714,13 +723,13 @@ void ndpProcessRouterAdv(NetInterface *interface,
          if(interface->ndpContext.enable)
          {
             //Create an entry for the router
-            entry = ndpCreateNeighborCacheEntry(interface);
+            entry = ndpCreateNeighborCacheEntry(interface,
+               &pseudoHeader->srcAddr);
 
             //Neighbor cache entry successfully created?
             if(entry != NULL)
             {
-               //Record the IPv6 address and the corresponding MAC address
-               entry->ipAddr = pseudoHeader->srcAddr;
+               //Record the corresponding MAC address
                entry->macAddr = linkLayerAddrOption->linkLayerAddr;
 
                //The IsRouter flag must be set to TRUE
@@ -1005,13 +1014,13 @@ void ndpProcessNeighborSol(NetInterface *interface,
          if(interface->ndpContext.enable)
          {
             //Create an entry
-            neighborCacheEntry = ndpCreateNeighborCacheEntry(interface);
+            neighborCacheEntry = ndpCreateNeighborCacheEntry(interface,
+               &pseudoHeader->srcAddr);
 
             //Neighbor cache entry successfully created?
             if(neighborCacheEntry != NULL)
             {
-               //Record the IPv6 and the corresponding MAC address
-               neighborCacheEntry->ipAddr = pseudoHeader->srcAddr;
+               //Record the corresponding MAC address
                neighborCacheEntry->macAddr = option->linkLayerAddr;
 
                //Enter the STALE state
@@ -1435,13 +1444,11 @@ void ndpProcessRedirect(NetInterface *interface,
    {
       //If no Destination Cache entry exists for the destination, an
       //implementation should create such an entry
-      destCacheEntry = ndpCreateDestCacheEntry(interface);
+      destCacheEntry = ndpCreateDestCacheEntry(interface, &message->destAddr);
 
       //Destination cache entry successfully created?
       if(destCacheEntry != NULL)
       {
-         //Destination address
-         destCacheEntry->destAddr = message->destAddr;
          //Address of the next hop
          destCacheEntry->nextHop = message->targetAddr;
 
@@ -1477,13 +1484,12 @@ void ndpProcessRedirect(NetInterface *interface,
          if(interface->ndpContext.enable)
          {
             //Create an entry for the target
-            neighborCacheEntry = ndpCreateNeighborCacheEntry(interface);
+            neighborCacheEntry = ndpCreateNeighborCacheEntry(interface,
+               &message->targetAddr);
 
             //Neighbor cache entry successfully created?
             if(neighborCacheEntry != NULL)
             {
-               //Record the Target address
-               neighborCacheEntry->ipAddr = message->targetAddr;
                //The cached link-layer address is copied from the option
                neighborCacheEntry->macAddr = option->linkLayerAddr;
 
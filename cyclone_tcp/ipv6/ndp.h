@@ -59,6 +59,34 @@
    #error NDP_DEST_CACHE_SIZE parameter is not valid
 #endif
 
+//Hash-indexed Neighbor and Destination caches
+#ifndef NDP_CACHE_HASH_SUPPORT
+   #define NDP_CACHE_HASH_SUPPORT DISABLED
+#elif (NDP_CACHE_HASH_SUPPORT != ENABLED && NDP_CACHE_HASH_SUPPORT != DISABLED)
+   #error NDP_CACHE_HASH_SUPPORT parameter is not valid
+#endif
+
+//Size of the hash table used to index the Neighbor cache
+#ifndef NDP_NEIGHBOR_HASH_TABLE_SIZE
+   #define NDP_NEIGHBOR_HASH_TABLE_SIZE 64
+#elif (NDP_NEIGHBOR_HASH_TABLE_SIZE < 1)
+   #error NDP_NEIGHBOR_HASH_TABLE_SIZE parameter is not valid
+#endif
+
+//Size of the hash table used to index the Destination cache
+#ifndef NDP_DEST_HASH_TABLE_SIZE
+   #define NDP_DEST_HASH_TABLE_SIZE 64
+#elif (NDP_DEST_HASH_TABLE_SIZE < 1)
+   #error NDP_DEST_HASH_TABLE_SIZE parameter is not valid
+#endif
+
+//Time during which a failed address resolution is remembered (0 to disable)
+#ifndef NDP_NEGATIVE_CACHE_TIME
+   #define NDP_NEGATIVE_CACHE_TIME 0
+#elif (NDP_NEGATIVE_CACHE_TIME < 0)
+   #error NDP_NEGATIVE_CACHE_TIME parameter is not valid
+#endif
+
 //Maximum number of packets waiting for address resolution to complete
 #ifndef NDP_MAX_PENDING_PACKETS
    #define NDP_MAX_PENDING_PACKETS 2
@@ -542,7 +570,7 @@ typedef struct
  * @brief Neighbor cache entry
  **/
 
-typedef struct
+typedef struct _NdpNeighborCacheEntry
 {
    NdpState state;                              ///<Reachability state
    Ipv6Addr ipAddr;                             ///<Unicast IPv6 address
@@ -553,6 +581,11 @@ typedef struct
    uint_t retransmitCount;                      ///<Retransmission counter
    NdpQueueItem queue[NDP_MAX_PENDING_PACKETS]; ///<Packets waiting for address resolution to complete
    uint_t queueSize;                            ///<Number of queued packets
+#if (NDP_CACHE_HASH_SUPPORT == ENABLED)
+   struct _NdpNeighborCacheEntry *hashNext;     ///<Next entry in the same hash bucket
+   struct _NdpNeighborCacheEntry *lruPrev;      ///<Previous entry in the LRU list
+   struct _NdpNeighborCacheEntry *lruNext;      ///<Next entry in the LRU list
+#endif
 } NdpNeighborCacheEntry;
 
 
@@ -560,12 +593,17 @@ typedef struct
  * @brief Destination cache entry
  **/
 
-typedef struct
+typedef struct _NdpDestCacheEntry
 {
-   Ipv6Addr destAddr;   ///<Destination IPv6 address
-   Ipv6Addr nextHop;    ///<IPv6 address of the next-hop neighbor
-   size_t pathMtu;      ///<Path MTU
-   systime_t timestamp; ///<Timestamp to manage entry lifetime
+   Ipv6Addr destAddr;                   ///<Destination IPv6 address
+   Ipv6Addr nextHop;                    ///<IPv6 address of the next-hop neighbor
+   size_t pathMtu;                      ///<Path MTU
+   systime_t timestamp;                 ///<Timestamp to manage entry lifetime
+#if (NDP_CACHE_HASH_SUPPORT == ENABLED)
+   struct _NdpDestCacheEntry *hashNext; ///<Next entry in the same hash bucket
+   struct _NdpDestCacheEntry *lruPrev;  ///<Previous entry in the LRU list
+   struct _NdpDestCacheEntry *lruNext;  ///<Next entry in the LRU list
+#endif
 } NdpDestCacheEntry;
 
 
@@ -589,6 +627,14 @@ typedef struct
    bool_t enable;                                                ///<Enable address resolution using Neighbor Discovery protocol
    NdpNeighborCacheEntry neighborCache[NDP_NEIGHBOR_CACHE_SIZE]; ///<Neighbor cache
    NdpDestCacheEntry destCache[NDP_DEST_CACHE_SIZE];             ///<Destination cache
+#if (NDP_CACHE_HASH_SUPPORT == ENABLED)
+   NdpNeighborCacheEntry *neighborHashTable[NDP_NEIGHBOR_HASH_TABLE_SIZE]; ///<Hash table indexing the Neighbor cache
+   NdpNeighborCacheEntry *neighborLruHead;                       ///<Most recently used Neighbor cache entry
+   NdpNeighborCacheEntry *neighborLruTail;                       ///<Least recently used Neighbor cache entry
+   NdpDestCacheEntry *destHashTable[NDP_DEST_HASH_TABLE_SIZE];   ///<Hash table indexing the Destination cache
+   NdpDestCacheEntry *destLruHead;                               ///<Most recently used Destination cache entry
+   NdpDestCacheEntry *destLruTail;                               ///<Least recently used Destination cache entry
+#endif
 } NdpContext;
 
 
@@ -60,14 +60,104 @@ void ndpChangeState(NdpNeighborCacheEntry *entry, NdpState newState)
 }
 
 
+/**
+ * @brief Initialize the Neighbor and Destination caches
+ * @param[in] interface Underlying network interface
+ **/
+
+void ndpInitCache(NetInterface *interface)
+{
+#if (NDP_CACHE_HASH_SUPPORT == ENABLED)
+   uint_t i;
+   NdpContext *context;
+
+   //Point to the NDP context
+   context = &interface->ndpContext;
+
+   //Clear the Neighbor cache
+   osMemset(context->neighborCache, 0, sizeof(context->neighborCache));
+   osMemset(context->neighborHashTable, 0, sizeof(context->neighborHashTable));
+
+   //The LRU list is initially made of free entries only
+   context->neighborLruHead = NULL;
+   context->neighborLruTail = NULL;
+
+   //Link all the entries
+   for(i = 0; i < NDP_NEIGHBOR_CACHE_SIZE; i++)
+   {
+      ndpLinkNeighborLruEntry(interface, &context->neighborCache[i], FALSE);
+   }
+#else
+   //Clear the Neighbor cache
+   osMemset(interface->ndpContext.neighborCache, 0,
+      sizeof(interface->ndpContext.neighborCache));
+#endif
+
+   //Clear the Destination cache
+   ndpFlushDestCache(interface);
+}
+
+
 /**
  * @brief Create a new entry in the Neighbor cache
  * @param[in] interface Underlying network interface
+ * @param[in] ipAddr IPv6 address
  * @return Pointer to the newly created entry
  **/
 
-NdpNeighborCacheEntry *ndpCreateNeighborCacheEntry(NetInterface *interface)
+NdpNeighborCacheEntry *ndpCreateNeighborCacheEntry(NetInterface *interface,
+   const Ipv6Addr *ipAddr)
 {
+#if (NDP_CACHE_HASH_SUPPORT == ENABLED)
+   uint_t i;
+   NdpContext *context;
+   NdpNeighborCacheEntry *entry;
+
+   //Point to the NDP context
+   context = &interface->ndpContext;
+
+   //Free entries are kept at the tail of the LRU list, followed by the least
+   //recently used entries. Static entries are never evicted
+   for(entry = context->neighborLruTail; entry != NULL; entry = entry->lruPrev)
+   {
+      //Dynamic or free entry?
+      if(entry->state != NDP_STATE_PERMANENT)
+         break;
+   }
+
+   //Any entry available in the Neighbor cache?
+   if(entry != NULL)
+   {
+      //Entry currently in use?
+      if(entry->state != NDP_STATE_NONE)
+      {
+         //Drop any pending packets
+         ndpFlushQueuedPackets(interface, entry);
+         //The least recently used entry is removed whenever the table runs
+         //out of space
+         ndpDeleteNeighborCacheEntry(interface, entry);
+      }
+
+      //Remove the entry from the LRU list
+      ndpUnlinkNeighborLruEntry(interface, entry);
+
+      //Initialize Neighbor cache entry
+      osMemset(entry, 0, sizeof(NdpNeighborCacheEntry));
+      //Record the IPv6 address
+      entry->ipAddr = *ipAddr;
+
+      //Insert the entry in the hash table
+      i = ndpHashAddr(ipAddr, NDP_NEIGHBOR_HASH_TABLE_SIZE);
+      entry->hashNext = context->neighborHashTable[i];
+      context->neighborHashTable[i] = entry;
+
+      //The new entry is the most recently used one
+      ndpLinkNeighborLruEntry(interface, entry, TRUE);
+   }
+
+   //Return a pointer to the Neighbor cache entry
+   return entry;
+#else
    uint_t i;
    systime_t time;
    NdpNeighborCacheEntry *entry;
@@ -90,6 +180,8 @@ NdpNeighborCacheEntry *ndpCreateNeighborCacheEntry(NetInterface *interface)
       {
          //Initialize Neighbor cache entry
          osMemset(entry, 0, sizeof(NdpNeighborCacheEntry));
+         //Record the IPv6 address
+         entry->ipAddr = *ipAddr;
 
          //Return a pointer to the Neighbor cache entry
          return entry;
@@ -133,10 +225,13 @@ NdpNeighborCacheEntry *ndpCreateNeighborCacheEntry(NetInterface *interface)
       ndpChangeState(oldestEntry, NDP_STATE_NONE);
       //Initialize Neighbor cache entry
       osMemset(oldestEntry, 0, sizeof(NdpNeighborCacheEntry));
+      //Record the IPv6 address
+      oldestEntry->ipAddr = *ipAddr;
    }
 
    //Return a pointer to the Neighbor cache entry
    return oldestEntry;
+#endif
 }
 
 
@@ -151,6 +246,29 @@ NdpNeighborCacheEntry *ndpCreateNeighborCacheEntry(NetInterface *interface)
 NdpNeighborCacheEntry *ndpFindNeighborCacheEntry(NetInterface *interface,
    const Ipv6Addr *ipAddr)
 {
+#if (NDP_CACHE_HASH_SUPPORT == ENABLED)
+   uint_t i;
+   NdpNeighborCacheEntry *entry;
+
+   //Index of the corresponding hash bucket
+   i = ndpHashAddr(ipAddr, NDP_NEIGHBOR_HASH_TABLE_SIZE);
+
+   //Walk through the hash bucket
+   for(entry = interface->ndpContext.neighborHashTable[i]; entry != NULL;
+      entry = entry->hashNext)
+   {
+      //Current entry matches the specified address?
+      if(entry->state != NDP_STATE_NONE && ipv6CompAddr(&entry->ipAddr, ipAddr))
+      {
+         //Move the entry to the head of the LRU list
+         ndpUnlinkNeighborLruEntry(interface, entry);
+         ndpLinkNeighborLruEntry(interface, entry, TRUE);
+
+         //Return a pointer to the Neighbor cache entry
+         return entry;
+      }
+   }
+#else
    uint_t i;
    NdpNeighborCacheEntry *entry;
 
@@ -170,12 +288,55 @@ NdpNeighborCacheEntry *ndpFindNeighborCacheEntry(NetInterface *interface,
          }
       }
    }
+#endif
 
    //No matching entry in Neighbor cache
    return NULL;
 }
 
 
+/**
+ * @brief Delete an entry from the Neighbor cache
+ * @param[in] interface Underlying network interface
+ * @param[in] entry Pointer to a Neighbor cache entry
+ **/
+
+void ndpDeleteNeighborCacheEntry(NetInterface *interface,
+   NdpNeighborCacheEntry *entry)
+{
+#if (NDP_CACHE_HASH_SUPPORT == ENABLED)
+   uint_t i;
+   NdpNeighborCacheEntry **p;
+
+   //Index of the corresponding hash bucket
+   i = ndpHashAddr(&entry->ipAddr, NDP_NEIGHBOR_HASH_TABLE_SIZE);
+
+   //Remove the entry from its hash bucket
+   for(p = &interface->ndpContext.neighborHashTable[i]; *p != NULL;
+      p = &(*p)->hashNext)
+   {
+      //Matching entry?
+      if(*p == entry)
+      {
+         *p = entry->hashNext;
+         break;
+      }
+   }
+
+   //Unlink the entry
+   entry->hashNext = NULL;
+
+   //Free entries are moved to the tail of the LRU list so that they are
+   //reused first
+   ndpUnlinkNeighborLruEntry(interface, entry);
+   ndpLinkNeighborLruEntry(interface, entry, FALSE);
+#endif
+
+   //Delete Neighbor cache entry
+   ndpChangeState(entry, NDP_STATE_NONE);
+}
+
+
 /**
  * @brief Periodically update Neighbor cache
  * @param[in] interface Underlying network interface
@@ -210,7 +371,12 @@ void ndpUpdateNeighborCache(NetInterface *interface)
             entry->retransmitCount++;
 
             //Check whether the maximum number of retransmissions has been exceeded
-            if(entry->retransmitCount < NDP_MAX_MULTICAST_SOLICIT)
+            if(entry->retransmitCount > NDP_MAX_MULTICAST_SOLICIT)
+            {
+               //The negative cache entry has expired
+               ndpDeleteNeighborCacheEntry(interface, entry);
+            }
+            else if(entry->retransmitCount < NDP_MAX_MULTICAST_SOLICIT)
             {
                //Retransmit the multicast Neighbor Solicitation message
                ndpSendNeighborSol(interface, &entry->ipAddr, TRUE);
@@ -225,8 +391,16 @@ void ndpUpdateNeighborCache(NetInterface *interface)
                //Drop packets that are waiting for address resolution
                ndpFlushQueuedPackets(interface, entry);
 
+#if (NDP_NEGATIVE_CACHE_TIME > 0)
+               //Remember the failure for a while so that subsequent packets
+               //to the same destination are rejected without sending any
+               //further solicitation
+               entry->timestamp = time;
+               entry->timeout = NDP_NEGATIVE_CACHE_TIME;
+#else
                //The entry should be deleted since address resolution has failed
-               ndpChangeState(entry, NDP_STATE_NONE);
+               ndpDeleteNeighborCacheEntry(interface, entry);
+#endif
             }
          }
       }
@@ -286,7 +460,7 @@ void ndpUpdateNeighborCache(NetInterface *interface)
             {
                //The entry should be deleted since the host is not reachable
                //anymore
-               ndpChangeState(entry, NDP_STATE_NONE);
+               ndpDeleteNeighborCacheEntry(interface, entry);
 
                //If at some point communication ceases to proceed, as determined
                //by the Neighbor Unreachability Detection algorithm, next-hop
@@ -331,7 +505,7 @@ void ndpFlushNeighborCache(NetInterface *interface)
          ndpFlushQueuedPackets(interface, entry);
 
          //Delete Neighbor cache entry
-         ndpChangeState(entry, NDP_STATE_NONE);
+         ndpDeleteNeighborCacheEntry(interface, entry);
       }
    }
 }
@@ -443,11 +617,51 @@ void ndpFlushQueuedPackets(NetInterface *interface, NdpNeighborCacheEntry *entry
 /**
  * @brief Create a new entry in the Destination Cache
  * @param[in] interface Underlying network interface
+ * @param[in] destAddr Destination IPv6 address
  * @return Pointer to the newly created entry
  **/
 
-NdpDestCacheEntry *ndpCreateDestCacheEntry(NetInterface *interface)
+NdpDestCacheEntry *ndpCreateDestCacheEntry(NetInterface *interface,
+   const Ipv6Addr *destAddr)
 {
+#if (NDP_CACHE_HASH_SUPPORT == ENABLED)
+   uint_t i;
+   NdpContext *context;
+   NdpDestCacheEntry *entry;
+
+   //Point to the NDP context
+   context = &interface->ndpContext;
+
+   //Free entries are kept at the tail of the LRU list, followed by the least
+   //recently used entries
+   entry = context->destLruTail;
+
+   //The least recently used entry is removed whenever the table runs out
+   //of space
+   if(!ipv6CompAddr(&entry->destAddr, &IPV6_UNSPECIFIED_ADDR))
+   {
+      ndpDeleteDestCacheEntry(interface, entry);
+   }
+
+   //Remove the entry from the LRU list
+   ndpUnlinkDestLruEntry(interface, entry);
+
+   //Erase contents
+   osMemset(entry, 0, sizeof(NdpDestCacheEntry));
+   //Record the destination address
+   entry->destAddr = *destAddr;
+
+   //Insert the entry in the hash table
+   i = ndpHashAddr(destAddr, NDP_DEST_HASH_TABLE_SIZE);
+   entry->hashNext = context->destHashTable[i];
+   context->destHashTable[i] = entry;
+
+   //The new entry is the most recently used one
+   ndpLinkDestLruEntry(interface, entry, TRUE);
+
+   //Return a pointer to the Destination cache entry
+   return entry;
+#else
    uint_t i;
    systime_t time;
    NdpDestCacheEntry *entry;
@@ -470,6 +684,9 @@ NdpDestCacheEntry *ndpCreateDestCacheEntry(NetInterface *interface)
       {
          //Erase contents
          osMemset(entry, 0, sizeof(NdpDestCacheEntry));
+         //Record the destination address
+         entry->destAddr = *destAddr;
+
          //Return a pointer to the Destination cache entry
          return entry;
       }
@@ -483,9 +700,12 @@ NdpDestCacheEntry *ndpCreateDestCacheEntry(NetInterface *interface)
 
    //The oldest entry is removed whenever the table runs out of space
    osMemset(oldestEntry, 0, sizeof(NdpDestCacheEntry));
+   //Record the destination address
+   oldestEntry->destAddr = *destAddr;
 
    //Return a pointer to the Destination cache entry
    return oldestEntry;
+#endif
 }
 
 
@@ -500,6 +720,29 @@ NdpDestCacheEntry *ndpCreateDestCacheEntry(NetInterface *interface)
 NdpDestCacheEntry *ndpFindDestCacheEntry(NetInterface *interface,
    const Ipv6Addr *destAddr)
 {
+#if (NDP_CACHE_HASH_SUPPORT == ENABLED)
+   uint_t i;
+   NdpDestCacheEntry *entry;
+
+   //Index of the corresponding hash bucket
+   i = ndpHashAddr(destAddr, NDP_DEST_HASH_TABLE_SIZE);
+
+   //Walk through the hash bucket
+   for(entry = interface->ndpContext.destHashTable[i]; entry != NULL;
+      entry = entry->hashNext)
+   {
+      //Current entry matches the specified destination address?
+      if(ipv6CompAddr(&entry->destAddr, destAddr))
+      {
+         //Move the entry to the head of the LRU list
+         ndpUnlinkDestLruEntry(interface, entry);
+         ndpLinkDestLruEntry(interface, entry, TRUE);
+
+         //Return a pointer to the Destination cache entry
+         return entry;
+      }
+   }
+#else
    uint_t i;
    NdpDestCacheEntry *entry;
 
@@ -515,12 +758,54 @@ NdpDestCacheEntry *ndpFindDestCacheEntry(NetInterface *interface,
          return entry;
       }
    }
+#endif
 
    //No matching entry in Destination Cache
    return NULL;
 }
 
 
+/**
+ * @brief Delete an entry from the Destination Cache
+ * @param[in] interface Underlying network interface
+ * @param[in] entry Pointer to a Destination cache entry
+ **/
+
+void ndpDeleteDestCacheEntry(NetInterface *interface, NdpDestCacheEntry *entry)
+{
+#if (NDP_CACHE_HASH_SUPPORT == ENABLED)
+   uint_t i;
+   NdpDestCacheEntry **p;
+
+   //Index of the corresponding hash bucket
+   i = ndpHashAddr(&entry->destAddr, NDP_DEST_HASH_TABLE_SIZE);
+
+   //Remove the entry from its hash bucket
+   for(p = &interface->ndpContext.destHashTable[i]; *p != NULL;
+      p = &(*p)->hashNext)
+   {
+      //Matching entry?
+      if(*p == entry)
+      {
+         *p = entry->hashNext;
+         break;
+      }
+   }
+
+   //Unlink the entry
+   entry->hashNext = NULL;
+
+   //Free entries are moved to the tail of the LRU list so that they are
+   //reused first
+   ndpUnlinkDestLruEntry(interface, entry);
+   ndpLinkDestLruEntry(interface, entry, FALSE);
+#endif
+
+   //Remove the current entry from the Destination Cache
+   entry->destAddr = IPV6_UNSPECIFIED_ADDR;
+}
+
+
 /**
  * @brief Flush Destination Cache
  * @param[in] interface Underlying network interface
@@ -528,9 +813,248 @@ NdpDestCacheEntry *ndpFindDestCacheEntry(NetInterface *interface,
 
 void ndpFlushDestCache(NetInterface *interface)
 {
+#if (NDP_CACHE_HASH_SUPPORT == ENABLED)
+   uint_t i;
+   NdpContext *context;
+
+   //Point to the NDP context
+   context = &interface->ndpContext;
+
+   //Clear the Destination Cache
+   osMemset(context->destCache, 0, sizeof(context->destCache));
+   osMemset(context->destHashTable, 0, sizeof(context->destHashTable));
+
+   //The LRU list is now made of free entries only
+   context->destLruHead = NULL;
+   context->destLruTail = NULL;
+
+   //Link all the entries
+   for(i = 0; i < NDP_DEST_CACHE_SIZE; i++)
+   {
+      ndpLinkDestLruEntry(interface, &context->destCache[i], FALSE);
+   }
+#else
    //Clear the Destination Cache
    osMemset(interface->ndpContext.destCache, 0,
       sizeof(interface->ndpContext.destCache));
+#endif
+}
+
+#if (NDP_CACHE_HASH_SUPPORT == ENABLED)
+
+/**
+ * @brief Compute the hash table index of an IPv6 address
+ * @param[in] ipAddr IPv6 address
+ * @param[in] size Number of buckets in the hash table
+ * @return Index of the hash bucket
+ **/
+
+uint_t ndpHashAddr(const Ipv6Addr *ipAddr, uint_t size)
+{
+   uint32_t h;
+
+   //Fold the 128-bit address into a 32-bit value
+   h = ntohl(ipAddr->dw[0] ^ ipAddr->dw[1] ^ ipAddr->dw[2] ^ ipAddr->dw[3]);
+
+   //Mix the bits so that consecutive addresses are spread evenly
+   h ^= h >> 16;
+   h *= 0x45D9F3BUL;
+   h ^= h >> 16;
+
+   //Return the index of the hash bucket
+   return h % size;
+}
+
+
+/**
+ * @brief Insert an entry in the LRU list of the Neighbor cache
+ * @param[in] interface Underlying network interface
+ * @param[in] entry Pointer to a Neighbor cache entry
+ * @param[in] head Insert the entry at the head (TRUE) or at the tail (FALSE)
+ *   of the list
+ **/
+
+void ndpLinkNeighborLruEntry(NetInterface *interface,
+   NdpNeighborCacheEntry *entry, bool_t head)
+{
+   NdpContext *context;
+
+   //Point to the NDP context
+   context = &interface->ndpContext;
+
+   //Insert at the head of the list?
+   if(head)
+   {
+      entry->lruPrev = NULL;
+      entry->lruNext = context->neighborLruHead;
+
+      //Update the link of the former head
+      if(context->neighborLruHead != NULL)
+      {
+         context->neighborLruHead->lruPrev = entry;
+      }
+      else
+      {
+         context->neighborLruTail = entry;
+      }
+
+      //The entry is now the most recently used one
+      context->neighborLruHead = entry;
+   }
+   else
+   {
+      entry->lruPrev = context->neighborLruTail;
+      entry->lruNext = NULL;
+
+      //Update the link of the former tail
+      if(context->neighborLruTail != NULL)
+      {
+         context->neighborLruTail->lruNext = entry;
+      }
+      else
+      {
+         context->neighborLruHead = entry;
+      }
+
+      //The entry is now the least recently used one
+      context->neighborLruTail = entry;
+   }
+}
+
+
+/**
+ * @brief Remove an entry from the LRU list of the Neighbor cache
+ * @param[in] interface Underlying network interface
+ * @param[in] entry Pointer to a Neighbor cache entry
+ **/
+
+void ndpUnlinkNeighborLruEntry(NetInterface *interface,
+   NdpNeighborCacheEntry *entry)
+{
+   NdpContext *context;
+
+   //Point to the NDP context
+   context = &interface->ndpContext;
+
+   //Update the link of the previous entry
+   if(entry->lruPrev != NULL)
+   {
+      entry->lruPrev->lruNext = entry->lruNext;
+   }
+   else
+   {
+      context->neighborLruHead = entry->lruNext;
+   }
+
+   //Update the link of the next entry
+   if(entry->lruNext != NULL)
+   {
+      entry->lruNext->lruPrev = entry->lruPrev;
+   }
+   else
+   {
+      context->neighborLruTail = entry->lruPrev;
+   }
+
+   //Unlink the entry
+   entry->lruPrev = NULL;
+   entry->lruNext = NULL;
+}
+
+
+/**
+ * @brief Insert an entry in the LRU list of the Destination cache
+ * @param[in] interface Underlying network interface
+ * @param[in] entry Pointer to a Destination cache entry
+ * @param[in] head Insert the entry at the head (TRUE) or at the tail (FALSE)
+ *   of the list
+ **/
+
+void ndpLinkDestLruEntry(NetInterface *interface, NdpDestCacheEntry *entry,
+   bool_t head)
+{
+   NdpContext *context;
+
+   //Point to the NDP context
+   context = &interface->ndpContext;
+
+   //Insert at the head of the list?
+   if(head)
+   {
+      entry->lruPrev = NULL;
+      entry->lruNext = context->destLruHead;
+
+      //Update the link of the former head
+      if(context->destLruHead != NULL)
+      {
+         context->destLruHead->lruPrev = entry;
+      }
+      else
+      {
+         context->destLruTail = entry;
+      }
+
+      //The entry is now the most recently used one
+      context->destLruHead = entry;
+   }
+   else
+   {
+      entry->lruPrev = context->destLruTail;
+      entry->lruNext = NULL;
+
+      //Update the link of the former tail
+      if(context->destLruTail != NULL)
+      {
+         context->destLruTail->lruNext = entry;
+      }
+      else
+      {
+         context->destLruHead = entry;
+      }
+
+      //The entry is now the least recently used one
+      context->destLruTail = entry;
+   }
 }
 
+
+/**
+ * @brief Remove an entry from the LRU list of the Destination cache
+ * @param[in] interface Underlying network interface
+ * @param[in] entry Pointer to a Destination cache entry
+ **/
+
+void ndpUnlinkDestLruEntry(NetInterface *interface, NdpDestCacheEntry *entry)
+{
+   NdpContext *context;
+
+   //Point to the NDP context
+   context = &interface->ndpContext;
+
+   //Update the link of the previous entry
+   if(entry->lruPrev != NULL)
+   {
+      entry->lruPrev->lruNext = entry->lruNext;
+   }
+   else
+   {
+      context->destLruHead = entry->lruNext;
+   }
+
+   //Update the link of the next entry
+   if(entry->lruNext != NULL)
+   {
+      entry->lruNext->lruPrev = entry->lruPrev;
+   }
+   else
+   {
+      context->destLruTail = entry->lruPrev;
+   }
+
+   //Unlink the entry
+   entry->lruPrev = NULL;
+   entry->lruNext = NULL;
+}
+
+#endif
 #endif
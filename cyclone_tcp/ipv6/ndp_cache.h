@@ -40,24 +40,47 @@ extern "C" {
 //NDP related functions
 void ndpChangeState(NdpNeighborCacheEntry *entry, NdpState newState);
 
-NdpNeighborCacheEntry *ndpCreateNeighborCacheEntry(NetInterface *interface);
+void ndpInitCache(NetInterface *interface);
+
+NdpNeighborCacheEntry *ndpCreateNeighborCacheEntry(NetInterface *interface,
+   const Ipv6Addr *ipAddr);
 
 NdpNeighborCacheEntry *ndpFindNeighborCacheEntry(NetInterface *interface,
    const Ipv6Addr *ipAddr);
 
+void ndpDeleteNeighborCacheEntry(NetInterface *interface,
+   NdpNeighborCacheEntry *entry);
+
 void ndpUpdateNeighborCache(NetInterface *interface);
 void ndpFlushNeighborCache(NetInterface *interface);
 
 uint_t ndpSendQueuedPackets(NetInterface *interface, NdpNeighborCacheEntry *entry);
 void ndpFlushQueuedPackets(NetInterface *interface, NdpNeighborCacheEntry *entry);
 
-NdpDestCacheEntry *ndpCreateDestCacheEntry(NetInterface *interface);
+NdpDestCacheEntry *ndpCreateDestCacheEntry(NetInterface *interface,
+   const Ipv6Addr *destAddr);
 
 NdpDestCacheEntry *ndpFindDestCacheEntry(NetInterface *interface,
    const Ipv6Addr *destAddr);
 
+void ndpDeleteDestCacheEntry(NetInterface *interface, NdpDestCacheEntry *entry);
 void ndpFlushDestCache(NetInterface *interface);
 
+#if (NDP_CACHE_HASH_SUPPORT == ENABLED)
+uint_t ndpHashAddr(const Ipv6Addr *ipAddr, uint_t size);
+
+void ndpLinkNeighborLruEntry(NetInterface *interface,
+   NdpNeighborCacheEntry *entry, bool_t head);
+
+void ndpUnlinkNeighborLruEntry(NetInterface *interface,
+   NdpNeighborCacheEntry *entry);
+
+void ndpLinkDestLruEntry(NetInterface *interface, NdpDestCacheEntry *entry,
+   bool_t head);
+
+void ndpUnlinkDestLruEntry(NetInterface *interface, NdpDestCacheEntry *entry);
+#endif
+
 //C++ guard
 #ifdef __cplusplus
 }
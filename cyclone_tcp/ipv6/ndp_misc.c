@@ -571,7 +571,7 @@ void ndpUpdateNextHop(NetInterface *interface, const Ipv6Addr *unreachableNextHo
          if(error)
          {
             //Remove the current entry from the Destination Cache
-            entry->destAddr = IPV6_UNSPECIFIED_ADDR;
+            ndpDeleteDestCacheEntry(interface, entry);
          }
       }
    }
@@ -249,13 +249,13 @@ void ndpProcessRouterSol(NetInterface *interface,
          if(interface->ndpContext.enable)
          {
             //Create an entry
-            entry = ndpCreateNeighborCacheEntry(interface);
+            entry = ndpCreateNeighborCacheEntry(interface,
+               &pseudoHeader->srcAddr);
 
             //Neighbor Cache entry successfully created?
             if(entry != NULL)
             {
-               //Record the IPv6 and the corresponding MAC address
-               entry->ipAddr = pseudoHeader->srcAddr;
+               //Record the corresponding MAC address
                entry->macAddr = option->linkLayerAddr;
 
                //The IsRouter flag must be set to FALSE
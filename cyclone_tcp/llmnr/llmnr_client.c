@@ -91,6 +91,8 @@ error_t llmnrResolve(NetInterface *interface, const char_t *name,
 
       //Record the host name whose IP address is unknown
       osStrcpy(entry->name, name);
+      //Index the entry by domain name
+      dnsAddEntry(entry);
 
       //Initialize DNS cache entry
       entry->type = type;
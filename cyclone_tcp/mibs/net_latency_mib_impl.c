@@ -0,0 +1,358 @@
+/**
+ * @file net_latency_mib_impl.c
+ * @brief Latency instrumentation MIB module implementation
+ *
+ * @section License
+ *
+ * Copyright (C) 2010-2023 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneTCP Eval.
+ *
+ * This software is provided in source form for a short-term evaluation only. The
+ * evaluation license expires 90 days after the date you first download the software.
+ *
+ * If you plan to use this software in a commercial product, you are required to
+ * purchase a commercial license from Oryx Embedded SARL.
+ *
+ * After the 90-day evaluation period, you agree to either purchase a commercial
+ * license or delete all copies of this software. If you wish to extend the
+ * evaluation period, you must contact sales@oryx-embedded.com.
+ *
+ * This evaluation software is provided "as is" without warranty of any kind.
+ * Technical support is available as an option during the evaluation period.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.3.2
+ **/
+
+//Switch to the appropriate trace level
+#define TRACE_LEVEL SNMP_TRACE_LEVEL
+
+//Dependencies
+#include "core/net.h"
+#include "mibs/mib_common.h"
+#include "mibs/net_latency_mib_module.h"
+#include "mibs/net_latency_mib_impl.h"
+#include "core/crypto.h"
+#include "encoding/asn1.h"
+#include "encoding/oid.h"
+#include "debug.h"
+
+//Check TCP/IP stack configuration
+#if (NET_LATENCY_MIB_SUPPORT == ENABLED && NET_LATENCY_SUPPORT == ENABLED)
+
+
+/**
+ * @brief Latency instrumentation MIB module initialization
+ * @return Error code
+ **/
+
+error_t netLatencyMibInit(void)
+{
+   //Debug message
+   TRACE_INFO("Initializing NET-LATENCY-MIB base...\r\n");
+
+   //The histograms are maintained by the TCP/IP stack
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Get netLatencyEntry object value
+ * @param[in] object Pointer to the MIB object descriptor
+ * @param[in] oid Object identifier (object name and instance identifier)
+ * @param[in] oidLen Length of the OID, in bytes
+ * @param[out] value Object value
+ * @param[in,out] valueLen Length of the object value, in bytes
+ * @return Error code
+ **/
+
+error_t netLatencyMibGetLatencyEntry(const MibObject *object,
+   const uint8_t *oid, size_t oidLen, MibVariant *value, size_t *valueLen)
+{
+   error_t error;
+   size_t n;
+   uint_t index;
+   uint_t stage;
+   const NetLatencyHistogram *histogram;
+
+   //Point to the instance identifier
+   n = object->oidLen;
+
+   //ifIndex is used as 1st instance identifier
+   error = mibDecodeIndex(oid, oidLen, &n, &index);
+   //Invalid instance identifier?
+   if(error)
+      return error;
+
+   //netLatencyStage is used as 2nd instance identifier
+   error = mibDecodeIndex(oid, oidLen, &n, &stage);
+   //Invalid instance identifier?
+   if(error)
+      return error;
+
+   //Sanity check
+   if(n != oidLen)
+      return ERROR_INSTANCE_NOT_FOUND;
+
+   //Check index range
+   if(index < 1 || index > NET_INTERFACE_COUNT)
+      return ERROR_INSTANCE_NOT_FOUND;
+
+   //Check measurement point
+   if(stage < 1 || stage > NET_LATENCY_STAGE_COUNT)
+      return ERROR_INSTANCE_NOT_FOUND;
+
+   //Point to the histogram
+   histogram = &netInterface[index - 1].latencyStats[stage - 1];
+
+   //netLatencyCount object?
+   if(!osStrcmp(object->name, "netLatencyCount"))
+   {
+      //Number of samples
+      value->counter32 = histogram->count;
+   }
+   //netLatencyMin object?
+   else if(!osStrcmp(object->name, "netLatencyMin"))
+   {
+      //Minimum delay
+      value->gauge32 = histogram->min;
+   }
+   //netLatencyMax object?
+   else if(!osStrcmp(object->name, "netLatencyMax"))
+   {
+      //Maximum delay
+      value->gauge32 = histogram->max;
+   }
+   //netLatencyTotal object?
+   else if(!osStrcmp(object->name, "netLatencyTotal"))
+   {
+      //Sum of the delays
+      value->counter64 = histogram->total;
+   }
+   //Unknown object?
+   else
+   {
+      //The specified object does not exist
+      error = ERROR_OBJECT_NOT_FOUND;
+   }
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Get next netLatencyEntry object
+ * @param[in] object Pointer to the MIB object descriptor
+ * @param[in] oid Object identifier
+ * @param[in] oidLen Length of the OID, in bytes
+ * @param[out] nextOid OID of the next object in the MIB
+ * @param[out] nextOidLen Length of the next object identifier, in bytes
+ * @return Error code
+ **/
+
+error_t netLatencyMibGetNextLatencyEntry(const MibObject *object,
+   const uint8_t *oid, size_t oidLen, uint8_t *nextOid, size_t *nextOidLen)
+{
+   error_t error;
+   size_t n;
+   uint_t index;
+   uint_t stage;
+
+   //Make sure the buffer is large enough to hold the OID prefix
+   if(*nextOidLen < object->oidLen)
+      return ERROR_BUFFER_OVERFLOW;
+
+   //Copy OID prefix
+   osMemcpy(nextOid, object->oid, object->oidLen);
+
+   //Loop through network interfaces
+   for(index = 1; index <= NET_INTERFACE_COUNT; index++)
+   {
+      //Loop through measurement points
+      for(stage = 1; stage <= NET_LATENCY_STAGE_COUNT; stage++)
+      {
+         //Append the instance identifier to the OID prefix
+         n = object->oidLen;
+
+         //ifIndex is used as 1st instance identifier
+         error = mibEncodeIndex(nextOid, *nextOidLen, &n, index);
+         //Any error to report?
+         if(error)
+            return error;
+
+         //netLatencyStage is used as 2nd instance identifier
+         error = mibEncodeIndex(nextOid, *nextOidLen, &n, stage);
+         //Any error to report?
+         if(error)
+            return error;
+
+         //Check whether the resulting object identifier lexicographically
+         //follows the specified OID
+         if(oidComp(nextOid, n, oid, oidLen) > 0)
+         {
+            //Save the length of the resulting object identifier
+            *nextOidLen = n;
+            //Next object found
+            return NO_ERROR;
+         }
+      }
+   }
+
+   //The specified OID does not lexicographically precede the name
+   //of some object
+   return ERROR_OBJECT_NOT_FOUND;
+}
+
+
+/**
+ * @brief Get netLatencyBucketEntry object value
+ * @param[in] object Pointer to the MIB object descriptor
+ * @param[in] oid Object identifier (object name and instance identifier)
+ * @param[in] oidLen Length of the OID, in bytes
+ * @param[out] value Object value
+ * @param[in,out] valueLen Length of the object value, in bytes
+ * @return Error code
+ **/
+
+error_t netLatencyMibGetBucketEntry(const MibObject *object,
+   const uint8_t *oid, size_t oidLen, MibVariant *value, size_t *valueLen)
+{
+   error_t error;
+   size_t n;
+   uint_t index;
+   uint_t stage;
+   uint_t bucket;
+
+   //Point to the instance identifier
+   n = object->oidLen;
+
+   //ifIndex is used as 1st instance identifier
+   error = mibDecodeIndex(oid, oidLen, &n, &index);
+   //Invalid instance identifier?
+   if(error)
+      return error;
+
+   //netLatencyStage is used as 2nd instance identifier
+   error = mibDecodeIndex(oid, oidLen, &n, &stage);
+   //Invalid instance identifier?
+   if(error)
+      return error;
+
+   //netLatencyBucket is used as 3rd instance identifier
+   error = mibDecodeIndex(oid, oidLen, &n, &bucket);
+   //Invalid instance identifier?
+   if(error)
+      return error;
+
+   //Sanity check
+   if(n != oidLen)
+      return ERROR_INSTANCE_NOT_FOUND;
+
+   //Check index range
+   if(index < 1 || index > NET_INTERFACE_COUNT)
+      return ERROR_INSTANCE_NOT_FOUND;
+
+   //Check measurement point
+   if(stage < 1 || stage > NET_LATENCY_STAGE_COUNT)
+      return ERROR_INSTANCE_NOT_FOUND;
+
+   //Check bucket number
+   if(bucket < 1 || bucket > NET_LATENCY_BUCKET_COUNT)
+      return ERROR_INSTANCE_NOT_FOUND;
+
+   //netLatencyBucketCount object?
+   if(!osStrcmp(object->name, "netLatencyBucketCount"))
+   {
+      //Number of samples that fall into the bucket
+      value->counter32 =
+         netInterface[index - 1].latencyStats[stage - 1].buckets[bucket - 1];
+   }
+   //Unknown object?
+   else
+   {
+      //The specified object does not exist
+      error = ERROR_OBJECT_NOT_FOUND;
+   }
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Get next netLatencyBucketEntry object
+ * @param[in] object Pointer to the MIB object descriptor
+ * @param[in] oid Object identifier
+ * @param[in] oidLen Length of the OID, in bytes
+ * @param[out] nextOid OID of the next object in the MIB
+ * @param[out] nextOidLen Length of the next object identifier, in bytes
+ * @return Error code
+ **/
+
+error_t netLatencyMibGetNextBucketEntry(const MibObject *object,
+   const uint8_t *oid, size_t oidLen, uint8_t *nextOid, size_t *nextOidLen)
+{
+   error_t error;
+   size_t n;
+   uint_t index;
+   uint_t stage;
+   uint_t bucket;
+
+   //Make sure the buffer is large enough to hold the OID prefix
+   if(*nextOidLen < object->oidLen)
+      return ERROR_BUFFER_OVERFLOW;
+
+   //Copy OID prefix
+   osMemcpy(nextOid, object->oid, object->oidLen);
+
+   //Loop through network interfaces
+   for(index = 1; index <= NET_INTERFACE_COUNT; index++)
+   {
+      //Loop through measurement points
+      for(stage = 1; stage <= NET_LATENCY_STAGE_COUNT; stage++)
+      {
+         //Loop through buckets
+         for(bucket = 1; bucket <= NET_LATENCY_BUCKET_COUNT; bucket++)
+         {
+            //Append the instance identifier to the OID prefix
+            n = object->oidLen;
+
+            //ifIndex is used as 1st instance identifier
+            error = mibEncodeIndex(nextOid, *nextOidLen, &n, index);
+            //Any error to report?
+            if(error)
+               return error;
+
+            //netLatencyStage is used as 2nd instance identifier
+            error = mibEncodeIndex(nextOid, *nextOidLen, &n, stage);
+            //Any error to report?
+            if(error)
+               return error;
+
+            //netLatencyBucket is used as 3rd instance identifier
+            error = mibEncodeIndex(nextOid, *nextOidLen, &n, bucket);
+            //Any error to report?
+            if(error)
+               return error;
+
+            //Check whether the resulting object identifier lexicographically
+            //follows the specified OID
+            if(oidComp(nextOid, n, oid, oidLen) > 0)
+            {
+               //Save the length of the resulting object identifier
+               *nextOidLen = n;
+               //Next object found
+               return NO_ERROR;
+            }
+         }
+      }
+   }
+
+   //The specified OID does not lexicographically precede the name
+   //of some object
+   return ERROR_OBJECT_NOT_FOUND;
+}
+
+#endif
@@ -0,0 +1,59 @@
+/**
+ * @file net_latency_mib_impl.h
+ * @brief Latency instrumentation MIB module implementation
+ *
+ * @section License
+ *
+ * Copyright (C) 2010-2023 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneTCP Eval.
+ *
+ * This software is provided in source form for a short-term evaluation only. The
+ * evaluation license expires 90 days after the date you first download the software.
+ *
+ * If you plan to use this software in a commercial product, you are required to
+ * purchase a commercial license from Oryx Embedded SARL.
+ *
+ * After the 90-day evaluation period, you agree to either purchase a commercial
+ * license or delete all copies of this software. If you wish to extend the
+ * evaluation period, you must contact sales@oryx-embedded.com.
+ *
+ * This evaluation software is provided "as is" without warranty of any kind.
+ * Technical support is available as an option during the evaluation period.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.3.2
+ **/
+
+#ifndef _NET_LATENCY_MIB_IMPL_H
+#define _NET_LATENCY_MIB_IMPL_H
+
+//Dependencies
+#include "mibs/mib_common.h"
+
+//C++ guard
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//Latency instrumentation MIB related functions
+error_t netLatencyMibInit(void);
+
+error_t netLatencyMibGetLatencyEntry(const MibObject *object,
+   const uint8_t *oid, size_t oidLen, MibVariant *value, size_t *valueLen);
+
+error_t netLatencyMibGetNextLatencyEntry(const MibObject *object,
+   const uint8_t *oid, size_t oidLen, uint8_t *nextOid, size_t *nextOidLen);
+
+error_t netLatencyMibGetBucketEntry(const MibObject *object,
+   const uint8_t *oid, size_t oidLen, MibVariant *value, size_t *valueLen);
+
+error_t netLatencyMibGetNextBucketEntry(const MibObject *object,
+   const uint8_t *oid, size_t oidLen, uint8_t *nextOid, size_t *nextOidLen);
+
+//C++ guard
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,153 @@
+/**
+ * @file net_latency_mib_module.c
+ * @brief Latency instrumentation MIB module
+ *
+ * @section License
+ *
+ * Copyright (C) 2010-2023 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneTCP Eval.
+ *
+ * This software is provided in source form for a short-term evaluation only. The
+ * evaluation license expires 90 days after the date you first download the software.
+ *
+ * If you plan to use this software in a commercial product, you are required to
+ * purchase a commercial license from Oryx Embedded SARL.
+ *
+ * After the 90-day evaluation period, you agree to either purchase a commercial
+ * license or delete all copies of this software. If you wish to extend the
+ * evaluation period, you must contact sales@oryx-embedded.com.
+ *
+ * This evaluation software is provided "as is" without warranty of any kind.
+ * Technical support is available as an option during the evaluation period.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.3.2
+ **/
+
+//Switch to the appropriate trace level
+#define TRACE_LEVEL SNMP_TRACE_LEVEL
+
+//Dependencies
+#include "core/net.h"
+#include "mibs/mib_common.h"
+#include "mibs/net_latency_mib_module.h"
+#include "mibs/net_latency_mib_impl.h"
+#include "core/crypto.h"
+#include "encoding/asn1.h"
+#include "encoding/oid.h"
+#include "debug.h"
+
+//Check TCP/IP stack configuration
+#if (NET_LATENCY_MIB_SUPPORT == ENABLED && NET_LATENCY_SUPPORT == ENABLED)
+
+
+/**
+ * @brief Latency instrumentation MIB objects
+ **/
+
+const MibObject netLatencyMibObjects[] =
+{
+   //netLatencyCount object (1.3.6.1.4.1.8072.9999.9999.1.1.1.2)
+   {
+      "netLatencyCount",
+      {43, 6, 1, 4, 1, 191, 8, 206, 15, 206, 15, 1, 1, 1, 2},
+      15,
+      ASN1_CLASS_APPLICATION,
+      MIB_TYPE_COUNTER32,
+      MIB_ACCESS_READ_ONLY,
+      NULL,
+      NULL,
+      sizeof(uint32_t),
+      NULL,
+      netLatencyMibGetLatencyEntry,
+      netLatencyMibGetNextLatencyEntry
+   },
+   //netLatencyMin object (1.3.6.1.4.1.8072.9999.9999.1.1.1.3)
+   {
+      "netLatencyMin",
+      {43, 6, 1, 4, 1, 191, 8, 206, 15, 206, 15, 1, 1, 1, 3},
+      15,
+      ASN1_CLASS_APPLICATION,
+      MIB_TYPE_GAUGE32,
+      MIB_ACCESS_READ_ONLY,
+      NULL,
+      NULL,
+      sizeof(uint32_t),
+      NULL,
+      netLatencyMibGetLatencyEntry,
+      netLatencyMibGetNextLatencyEntry
+   },
+   //netLatencyMax object (1.3.6.1.4.1.8072.9999.9999.1.1.1.4)
+   {
+      "netLatencyMax",
+      {43, 6, 1, 4, 1, 191, 8, 206, 15, 206, 15, 1, 1, 1, 4},
+      15,
+      ASN1_CLASS_APPLICATION,
+      MIB_TYPE_GAUGE32,
+      MIB_ACCESS_READ_ONLY,
+      NULL,
+      NULL,
+      sizeof(uint32_t),
+      NULL,
+      netLatencyMibGetLatencyEntry,
+      netLatencyMibGetNextLatencyEntry
+   },
+   //netLatencyTotal object (1.3.6.1.4.1.8072.9999.9999.1.1.1.5)
+   {
+      "netLatencyTotal",
+      {43, 6, 1, 4, 1, 191, 8, 206, 15, 206, 15, 1, 1, 1, 5},
+      15,
+      ASN1_CLASS_APPLICATION,
+      MIB_TYPE_COUNTER64,
+      MIB_ACCESS_READ_ONLY,
+      NULL,
+      NULL,
+      sizeof(uint64_t),
+      NULL,
+      netLatencyMibGetLatencyEntry,
+      netLatencyMibGetNextLatencyEntry
+   },
+   //netLatencyBucketCount object (1.3.6.1.4.1.8072.9999.9999.1.2.1.2)
+   {
+      "netLatencyBucketCount",
+      {43, 6, 1, 4, 1, 191, 8, 206, 15, 206, 15, 1, 2, 1, 2},
+      15,
+      ASN1_CLASS_APPLICATION,
+      MIB_TYPE_COUNTER32,
+      MIB_ACCESS_READ_ONLY,
+      NULL,
+      NULL,
+      sizeof(uint32_t),
+      NULL,
+      netLatencyMibGetBucketEntry,
+      netLatencyMibGetNextBucketEntry
+   }
+};
+
+
+/**
+ * @brief Latency instrumentation MIB module
+ *
+ * The module is a private MIB rooted under the netSnmpPlaypen arc
+ * (1.3.6.1.4.1.8072.9999.9999). Both tables are indexed by ifIndex and by
+ * the measurement point (1-based). The bucket table adds the 1-based bucket
+ * number as third index
+ *
+ **/
+
+const MibModule netLatencyMibModule =
+{
+   "NET-LATENCY-MIB",
+   {43, 6, 1, 4, 1, 191, 8, 206, 15, 206, 15, 1},
+   12,
+   netLatencyMibObjects,
+   arraysize(netLatencyMibObjects),
+   netLatencyMibInit,
+   NULL,
+   NULL,
+   NULL,
+   NULL
+};
+
+#endif
@@ -0,0 +1,55 @@
+/**
+ * @file net_latency_mib_module.h
+ * @brief Latency instrumentation MIB module
+ *
+ * @section License
+ *
+ * Copyright (C) 2010-2023 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneTCP Eval.
+ *
+ * This software is provided in source form for a short-term evaluation only. The
+ * evaluation license expires 90 days after the date you first download the software.
+ *
+ * If you plan to use this software in a commercial product, you are required to
+ * purchase a commercial license from Oryx Embedded SARL.
+ *
+ * After the 90-day evaluation period, you agree to either purchase a commercial
+ * license or delete all copies of this software. If you wish to extend the
+ * evaluation period, you must contact sales@oryx-embedded.com.
+ *
+ * This evaluation software is provided "as is" without warranty of any kind.
+ * Technical support is available as an option during the evaluation period.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.3.2
+ **/
+
+#ifndef _NET_LATENCY_MIB_MODULE_H
+#define _NET_LATENCY_MIB_MODULE_H
+
+//Dependencies
+#include "mibs/mib_common.h"
+
+//Latency instrumentation MIB module support
+#ifndef NET_LATENCY_MIB_SUPPORT
+   #define NET_LATENCY_MIB_SUPPORT DISABLED
+#elif (NET_LATENCY_MIB_SUPPORT != ENABLED && NET_LATENCY_MIB_SUPPORT != DISABLED)
+   #error NET_LATENCY_MIB_SUPPORT parameter is not valid
+#endif
+
+//C++ guard
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//Latency instrumentation MIB related constants
+extern const MibObject netLatencyMibObjects[];
+extern const MibModule netLatencyMibModule;
+
+//C++ guard
+#ifdef __cplusplus
+}
+#endif
+
+#endif
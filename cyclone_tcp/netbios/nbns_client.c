@@ -91,6 +91,8 @@ error_t nbnsResolve(NetInterface *interface, const char_t *name, IpAddr *ipAddr)
 
       //Record the host name whose IP address is unknown
       osStrcpy(entry->name, name);
+      //Index the entry by domain name
+      dnsAddEntry(entry);
 
       //Initialize DNS cache entry
       entry->type = HOST_TYPE_IPV4;
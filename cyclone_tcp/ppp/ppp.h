@@ -60,6 +60,20 @@ struct _PppContext;
    #error PPP_RX_BUFFER_SIZE parameter is not valid
 #endif
 
+//Block-oriented HDLC framing
+#ifndef PPP_HDLC_BLOCK_SUPPORT
+   #define PPP_HDLC_BLOCK_SUPPORT DISABLED
+#elif (PPP_HDLC_BLOCK_SUPPORT != ENABLED && PPP_HDLC_BLOCK_SUPPORT != DISABLED)
+   #error PPP_HDLC_BLOCK_SUPPORT parameter is not valid
+#endif
+
+//Slice-by-4 FCS calculation
+#ifndef PPP_FAST_FCS_SUPPORT
+   #define PPP_FAST_FCS_SUPPORT DISABLED
+#elif (PPP_FAST_FCS_SUPPORT != ENABLED && PPP_FAST_FCS_SUPPORT != DISABLED)
+   #error PPP_FAST_FCS_SUPPORT parameter is not valid
+#endif
+
 //Maximum user name length
 #ifndef PPP_MAX_USERNAME_LEN
    #define PPP_MAX_USERNAME_LEN 31
@@ -519,6 +533,7 @@ error_t pppSendFrame(NetInterface *interface, NetBuffer *buffer, size_t offset,
 size_t pppParseFrameHeader(const uint8_t *frame, size_t length, uint16_t *protocol);
 
 uint16_t pppCalcFcs(const uint8_t *data, size_t length);
+uint16_t pppUpdateFcs(uint16_t fcs, const uint8_t *data, size_t length);
 uint16_t pppCalcFcsEx(const NetBuffer *buffer, size_t offset, size_t length);
 
 NetBuffer *pppAllocBuffer(size_t length, size_t *offset);
@@ -189,6 +189,12 @@ error_t pppHdlcDriverSendPacket(NetInterface *interface,
    uint16_t protocol;
    uint32_t accm;
    PppContext *context;
+#if (PPP_HDLC_BLOCK_SUPPORT == ENABLED)
+   uint_t k;
+   size_t length;
+   uint8_t escape[2];
+   const uint8_t flag = PPP_FLAG_CHAR;
+#endif
 
    //Point to the PPP context
    context = interface->pppContext;
@@ -211,6 +217,81 @@ error_t pppHdlcDriverSendPacket(NetInterface *interface,
       accm = PPP_DEFAULT_ACCM;
    }
 
+#if (PPP_HDLC_BLOCK_SUPPORT == ENABLED)
+   //Point to the current position in the TX queue
+   k = context->txWriteIndex;
+   //Send flag
+   k = pppHdlcDriverCopyTxBlock(context, k, &flag, 1);
+   //Number of characters written to the TX queue
+   length = 1;
+
+   //Loop through data chunks
+   for(i = 0; i < buffer->chunkCount; i++)
+   {
+      //Is there any data to copy from the current chunk?
+      if(offset < buffer->chunk[i].length)
+      {
+         //Point to the first byte to be read
+         p = (uint8_t *) buffer->chunk[i].address + offset;
+         //Compute the number of bytes to copy at a time
+         n = buffer->chunk[i].length - offset;
+
+         //Process current chunk
+         while(n > 0)
+         {
+            //Determine the length of the run of characters that do not need
+            //to be escaped
+            j = pppHdlcDriverScanBlock(p, n, accm);
+
+            //Copy the whole run to the TX queue at once
+            k = pppHdlcDriverCopyTxBlock(context, k, p, j);
+            length += j;
+
+            //Advance data pointer
+            p += j;
+            n -= j;
+
+            //The run is terminated by a character that must be escaped
+            if(n > 0)
+            {
+               //Format escape sequence
+               escape[0] = PPP_ESC_CHAR;
+               escape[1] = *p ^ PPP_MASK_CHAR;
+
+               //Copy the escape sequence to the TX queue
+               k = pppHdlcDriverCopyTxBlock(context, k, escape, 2);
+               length += 2;
+
+               //Next character
+               p++;
+               n--;
+            }
+         }
+
+         //Process the next block from the start
+         offset = 0;
+      }
+      else
+      {
+         //Skip the current chunk
+         offset -= buffer->chunk[i].length;
+      }
+   }
+
+   //Send flag
+   k = pppHdlcDriverCopyTxBlock(context, k, &flag, 1);
+   length++;
+
+   //Update write index
+   context->txWriteIndex = k;
+
+   //Enter critical section
+   __disable_irq();
+   //The whole frame is committed to the TX queue at once
+   context->txBufferLen += length;
+   //Exit critical section
+   __enable_irq();
+#else
    //Send flag
    pppHdlcDriverWriteTxQueue(context, PPP_FLAG_CHAR);
 
@@ -266,6 +347,7 @@ error_t pppHdlcDriverSendPacket(NetInterface *interface,
 
    //Send flag
    pppHdlcDriverWriteTxQueue(context, PPP_FLAG_CHAR);
+#endif
 
    //Start transferring data
    interface->uartDriver->startTx();
@@ -295,6 +377,12 @@ error_t pppHdlcDriverReceivePacket(NetInterface *interface)
    bool_t escFlag;
    uint32_t accm;
    PppContext *context;
+#if (PPP_HDLC_BLOCK_SUPPORT == ENABLED)
+   uint_t i;
+   uint_t k;
+   uint_t m;
+   size_t j;
+#endif
 
    //Point to the PPP context
    context = interface->pppContext;
@@ -306,6 +394,98 @@ error_t pppHdlcDriverReceivePacket(NetInterface *interface)
    //This flag tells whether the next character is escaped
    escFlag = FALSE;
 
+#if (PPP_HDLC_BLOCK_SUPPORT == ENABLED)
+   //Point to the first byte of the receive buffer
+   k = context->rxReadIndex;
+   //Number of characters pending in the receive buffer
+   m = context->rxBufferLen;
+
+   //The receiver must reverse the octet stuffing procedure
+   for(i = 0; n < PPP_MAX_FRAME_SIZE && i < m; )
+   {
+      //The character following an escape must be processed individually
+      if(!escFlag)
+      {
+         //Limit the run to the contiguous part of the receive buffer
+         j = MIN(m - i, PPP_RX_BUFFER_SIZE - k);
+         j = MIN(j, PPP_MAX_FRAME_SIZE - n);
+
+         //Determine the length of the run of characters that can be copied
+         //as is
+         j = pppHdlcDriverScanBlock(context->rxBuffer + k, j, accm);
+
+         //Any characters to copy?
+         if(j > 0)
+         {
+            //Copy the whole run at once
+            osMemcpy(context->frame + n, context->rxBuffer + k, j);
+            n += j;
+            i += j;
+
+            //Advance index and wrap around if necessary
+            k += j;
+            if(k >= PPP_RX_BUFFER_SIZE)
+               k = 0;
+
+            //Check whether the frame is complete
+            continue;
+         }
+      }
+
+      //Read a single character
+      c = context->rxBuffer[k];
+      i++;
+
+      //Increment index and wrap around if necessary
+      if(++k >= PPP_RX_BUFFER_SIZE)
+         k = 0;
+
+      if(c < PPP_MASK_CHAR)
+      {
+         //Check whether the character is flagged
+         if(accm & (1 << c))
+         {
+            //The extra characters must be removed from the incoming data stream
+         }
+         else
+         {
+            //Copy current character
+            context->frame[n++] = c;
+         }
+      }
+      else if(c == PPP_ESC_CHAR)
+      {
+         //All occurrences of 0x7D indicate that the next character is escaped
+         escFlag = TRUE;
+      }
+      else if(c == PPP_FLAG_CHAR)
+      {
+         //0x7E flag found
+         break;
+      }
+      else if(escFlag)
+      {
+         //The character is XOR'ed with 0x20
+         context->frame[n++] = c ^ PPP_MASK_CHAR;
+         escFlag = FALSE;
+      }
+      else
+      {
+         //Copy current character
+         context->frame[n++] = c;
+      }
+   }
+
+   //Update read index
+   context->rxReadIndex = k;
+
+   //Enter critical section
+   __disable_irq();
+   //The consumed characters are released at once
+   context->rxBufferLen -= i;
+   //Exit critical section
+   __enable_irq();
+#else
    //The receiver must reverse the octet stuffing procedure
    while(n < PPP_MAX_FRAME_SIZE && context->rxBufferLen > 0)
    {
@@ -347,6 +527,7 @@ error_t pppHdlcDriverReceivePacket(NetInterface *interface)
          context->frame[n++] = c;
       }
    }
+#endif
 
    //Check whether a valid PPP frame has been received
    if(n > 0)
@@ -713,5 +894,252 @@ bool_t pppHdlcDriverWriteRxQueue(NetInterface *interface, uint8_t c)
    return flag;
 }
 
+
+/**
+ * @brief Search a block of data for characters that require special handling
+ *
+ * Flag and escape characters, as well as the control characters that are
+ * flagged in the ACCM, cannot be transferred as is. The data is examined one
+ * 32-bit word at a time so that long runs of regular characters can be
+ * processed at once
+ *
+ * @param[in] data Pointer to the data to be scanned
+ * @param[in] length Number of bytes to scan
+ * @param[in] accm Async control character map
+ * @return Length of the leading run of characters that can be copied as is
+ **/
+
+size_t pppHdlcDriverScanBlock(const uint8_t *data, size_t length,
+   uint32_t accm)
+{
+   size_t i;
+   uint8_t c;
+   uint32_t w;
+
+   //Initialize index
+   i = 0;
+
+   //Loop through the data
+   while(i < length)
+   {
+      //At least 4 bytes left to scan?
+      if((i + 4) <= length)
+      {
+         //Load the next 32-bit word
+         w = LOAD32LE(data + i);
+
+         //Make sure the word contains neither flag nor escape characters
+         if(!PPP_HDLC_HAS_VALUE(w, PPP_FLAG_CHAR) &&
+            !PPP_HDLC_HAS_VALUE(w, PPP_ESC_CHAR))
+         {
+            //Control characters only matter when they are flagged
+            if(accm == 0 || !PPP_HDLC_HAS_LESS(w, PPP_MASK_CHAR))
+            {
+               //Skip the whole word
+               i += 4;
+               continue;
+            }
+         }
+      }
+
+      //Read current character
+      c = data[i];
+
+      //Flag and escape characters must always be escaped
+      if(c == PPP_FLAG_CHAR || c == PPP_ESC_CHAR)
+         break;
+
+      //Check whether the control character is flagged
+      if(c < PPP_MASK_CHAR && (accm & (1 << c)) != 0)
+         break;
+
+      //Next character
+      i++;
+   }
+
+   //Return the length of the run
+   return i;
+}
+
+
+/**
+ * @brief Copy a block of data to the TX queue
+ *
+ * The length of the queue is not updated, so that the data remains invisible
+ * to the UART driver until the caller commits it
+ *
+ * @param[in] context Pointer to the PPP context
+ * @param[in] index Current write position in the TX queue
+ * @param[in] data Pointer to the data to be written
+ * @param[in] length Number of bytes to write
+ * @return Updated write position
+ **/
+
+uint_t pppHdlcDriverCopyTxBlock(PppContext *context, uint_t index,
+   const uint8_t *data, size_t length)
+{
+   size_t n;
+
+   //Number of bytes that can be written before wrapping around
+   n = MIN(length, PPP_TX_BUFFER_SIZE - index);
+
+   //Copy the first part of the data
+   osMemcpy(context->txBuffer + index, data, n);
+   //Wrap around if necessary
+   osMemcpy(context->txBuffer, data + n, length - n);
+
+   //Advance index and wrap around if necessary
+   index += length;
+   if(index >= PPP_TX_BUFFER_SIZE)
+      index -= PPP_TX_BUFFER_SIZE;
+
+   //Return the updated write position
+   return index;
+}
+
+
+/**
+ * @brief Get the next contiguous block of data pending in the TX queue
+ *
+ * This function is intended for DMA-capable UART drivers. The block remains
+ * in the queue until pppHdlcDriverReleaseTxBlock is called
+ *
+ * @param[in] interface Underlying network interface
+ * @param[out] data Pointer to the first byte of the block
+ * @return Length of the block, in bytes
+ **/
+
+size_t pppHdlcDriverGetTxBlock(NetInterface *interface, const uint8_t **data)
+{
+   PppContext *context;
+
+   //Point to the PPP context
+   context = interface->pppContext;
+
+   //Point to the first byte pending in the TX queue
+   *data = context->txBuffer + context->txReadIndex;
+
+   //The block cannot extend past the end of the buffer
+   return MIN(context->txBufferLen, PPP_TX_BUFFER_SIZE - context->txReadIndex);
+}
+
+
+/**
+ * @brief Release a block of data that has been sent
+ * @param[in] interface Underlying network interface
+ * @param[in] length Number of bytes that have been sent
+ * @return TRUE if a context switch is required
+ **/
+
+bool_t pppHdlcDriverReleaseTxBlock(NetInterface *interface, size_t length)
+{
+   bool_t flag;
+   size_t n;
+   PppContext *context;
+
+   //Point to the PPP context
+   context = interface->pppContext;
+   //This flag will be set if a higher priority task must be woken
+   flag = FALSE;
+
+   //Save the current length of the queue
+   n = context->txBufferLen;
+   //Limit the number of bytes to release
+   length = MIN(length, n);
+
+   //Advance read index and wrap around if necessary
+   context->txReadIndex += length;
+   if(context->txReadIndex >= PPP_TX_BUFFER_SIZE)
+      context->txReadIndex -= PPP_TX_BUFFER_SIZE;
+
+   //Update the length of the queue
+   context->txBufferLen -= length;
+
+   //Check whether the TX queue has become available for writing
+   if(n > (PPP_TX_BUFFER_SIZE - 3006) &&
+      context->txBufferLen <= (PPP_TX_BUFFER_SIZE - 3006))
+   {
+      flag = osSetEventFromIsr(&interface->nicTxEvent);
+   }
+
+   //The return value tells whether a context switch is required
+   return flag;
+}
+
+
+/**
+ * @brief Write a block of received data to the RX queue
+ *
+ * This function is intended for DMA-capable UART drivers. Characters that
+ * do not fit in the RX queue are discarded
+ *
+ * @param[in] interface Underlying network interface
+ * @param[in] data Pointer to the received data
+ * @param[in] length Number of bytes received
+ * @return TRUE if a context switch is required
+ **/
+
+bool_t pppHdlcDriverWriteRxBlock(NetInterface *interface, const uint8_t *data,
+   size_t length)
+{
+   bool_t flag;
+   size_t n;
+   uint_t count;
+   const uint8_t *p;
+   PppContext *context;
+
+   //Point to the PPP context
+   context = interface->pppContext;
+   //This flag will be set if a higher priority task must be woken
+   flag = FALSE;
+
+   //Limit the number of bytes to the free space in the RX queue
+   length = MIN(length, PPP_RX_BUFFER_SIZE - context->rxBufferLen);
+
+   //Number of bytes that can be written before wrapping around
+   n = MIN(length, PPP_RX_BUFFER_SIZE - context->rxWriteIndex);
+
+   //Copy the data to the RX queue
+   osMemcpy(context->rxBuffer + context->rxWriteIndex, data, n);
+   osMemcpy(context->rxBuffer, data + n, length - n);
+
+   //Advance write index and wrap around if necessary
+   context->rxWriteIndex += length;
+   if(context->rxWriteIndex >= PPP_RX_BUFFER_SIZE)
+      context->rxWriteIndex -= PPP_RX_BUFFER_SIZE;
+
+   //Update the length of the queue
+   context->rxBufferLen += length;
+
+   //Count the number of 0x7E flags in the block
+   for(count = 0; length > 0; count++)
+   {
+      //Search for the next flag
+      p = osMemchr(data, PPP_FLAG_CHAR, length);
+      //No more flags?
+      if(p == NULL)
+         break;
+
+      //Skip the flag
+      length -= p - data + 1;
+      data = p + 1;
+   }
+
+   //Any complete HDLC frame received?
+   if(count > 0)
+   {
+      //Update frame counter
+      context->rxFrameCount += count;
+
+      //A complete HDLC frame has been received
+      interface->nicEvent = TRUE;
+      //Notify the TCP/IP stack of the event
+      flag = osSetEventFromIsr(&netEvent);
+   }
+
+   //The return value tells whether a context switch is required
+   return flag;
+}
+
 #endif
 
@@ -36,6 +36,11 @@
 extern "C" {
 #endif
 
+//Check whether a 32-bit word contains a byte lower than n
+#define PPP_HDLC_HAS_LESS(w, n) (((w) - 0x01010101U * (n)) & ~(w) & 0x80808080U)
+//Check whether a 32-bit word contains a byte equal to n
+#define PPP_HDLC_HAS_VALUE(w, n) PPP_HDLC_HAS_LESS((w) ^ (0x01010101U * (n)), 1)
+
 //PPP HDLC driver
 extern const NicDriver pppHdlcDriver;
 
@@ -69,6 +74,18 @@ uint8_t pppHdlcDriverReadRxQueue(PppContext *context);
 bool_t pppHdlcDriverReadTxQueue(NetInterface *interface, int_t *c);
 bool_t pppHdlcDriverWriteRxQueue(NetInterface *interface, uint8_t c);
 
+size_t pppHdlcDriverScanBlock(const uint8_t *data, size_t length,
+   uint32_t accm);
+
+uint_t pppHdlcDriverCopyTxBlock(PppContext *context, uint_t index,
+   const uint8_t *data, size_t length);
+
+size_t pppHdlcDriverGetTxBlock(NetInterface *interface, const uint8_t **data);
+bool_t pppHdlcDriverReleaseTxBlock(NetInterface *interface, size_t length);
+
+bool_t pppHdlcDriverWriteRxBlock(NetInterface *interface, const uint8_t *data,
+   size_t length);
+
 //C++ guard
 #ifdef __cplusplus
 }
@@ -0,0 +1,1737 @@
+/**
+ * @file main.c
+ * @brief Host-side TCP/IP stack benchmark
+ *
+ * @section License
+ *
+ * Copyright (C) 2010-2023 Oryx Embedded SARL. All rights reserved.
+ *
+ * This software is provided in source form for a short-term evaluation only. The
+ * evaluation license expires 90 days after the date you first download the software.
+ *
+ * If you plan to use this software in a commercial product, you are required to
+ * purchase a commercial license from Oryx Embedded SARL.
+ *
+ * After the 90-day evaluation period, you agree to either purchase a commercial
+ * license or delete all copies of this software. If you wish to extend the
+ * evaluation period, you must contact sales@oryx-embedded.com.
+ *
+ * This evaluation software is provided "as is" without warranty of any kind.
+ * Technical support is available as an option during the evaluation period.
+ *
+ * @section Description
+ *
+ * The benchmark runs the whole stack in a single Linux process on top of the
+ * loopback driver, so that both ends of every connection are served by the
+ * CycloneTCP code under test. Each result is printed on stdout as a single
+ * JSON object per line:
+ *
+ * {"tag":"...","bench":"tcp_bulk","param":"buffer_size","param_value":8192,
+ *  "metric":"throughput","value":123.456,"unit":"Mbit/s"}
+ *
+ * Usage: net_benchmark [-d duration_ms] [-t tag] [-b bench]
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.3.2
+ **/
+
+//Dependencies
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "core/net.h"
+#include "drivers/loopback/loopback_driver.h"
+#include "http/http_server.h"
+#include "http/http_client.h"
+#include "mqtt/mqtt_client.h"
+#include "coap/coap_server.h"
+#include "coap/coap_server_request.h"
+#include "coap/coap_client.h"
+#include "debug.h"
+
+//Loopback interface configuration
+#define APP_IF_NAME "lo"
+#define APP_HOST_NAME "net-benchmark"
+#define APP_IPV4_HOST_ADDR "127.0.0.1"
+#define APP_IPV4_SUBNET_MASK "255.0.0.0"
+
+//Application configuration
+#define APP_DEFAULT_DURATION 2000
+#define APP_SERVER_TIMEOUT 5000
+#define APP_TCP_BULK_PORT 5001
+#define APP_TCP_CONN_PORT 5002
+#define APP_TCP_RR_PORT 5003
+#define APP_UDP_PORT 5004
+#define APP_HTTP_PORT 8080
+#define APP_MQTT_PORT 1883
+#define APP_COAP_PORT 5683
+#define APP_RR_MESSAGE_SIZE 64
+#define APP_HTTP_BODY_SIZE 1024
+#define APP_MQTT_PAYLOAD_SIZE 64
+#define APP_MQTT_MAX_PACKET_SIZE 256
+#define APP_COAP_PAYLOAD_SIZE 64
+#define APP_HTTP_MAX_CONNECTIONS 2
+#define APP_MAX_SAMPLES 100000
+#define APP_BUFFER_SIZE 4096
+
+
+/**
+ * @brief TCP bulk transfer sink
+ **/
+
+typedef struct
+{
+   Socket *listener;
+   uint64_t received;
+   OsEvent doneEvent;
+} BenchTcpSink;
+
+
+/**
+ * @brief UDP sink
+ **/
+
+typedef struct
+{
+   Socket *socket;
+   volatile bool_t stop;
+   uint64_t received;
+   OsEvent doneEvent;
+} BenchUdpSink;
+
+
+//Global variables
+const char_t *benchTag = "";
+const char_t *benchFilter = NULL;
+systime_t benchDuration = APP_DEFAULT_DURATION;
+NetInterface *benchInterface;
+IpAddr benchServerIpAddr;
+uint64_t benchSamples[APP_MAX_SAMPLES];
+uint_t benchSampleCount;
+HttpServerSettings httpServerSettings;
+HttpServerContext httpServerContext;
+HttpConnection httpConnections[APP_HTTP_MAX_CONNECTIONS];
+HttpClientContext httpClientContext;
+MqttClientContext mqttClientContext;
+CoapServerSettings coapServerSettings;
+CoapServerContext coapServerContext;
+CoapClientContext coapClientContext;
+
+//Data buffers
+static uint8_t benchTxBuffer[APP_BUFFER_SIZE];
+static uint8_t benchRxBuffer[APP_BUFFER_SIZE];
+
+//TCP bulk transfer buffer sizes
+static const size_t benchBufferSizes[] =
+{
+   2860,
+   5720,
+   11440,
+   22880
+};
+
+//UDP payload sizes
+static const size_t benchPayloadSizes[] =
+{
+   64,
+   512,
+   1472
+};
+
+//Forward declaration of functions
+error_t httpServerRequestCallback(HttpConnection *connection,
+   const char_t *uri);
+
+error_t httpServerUriNotFoundCallback(HttpConnection *connection,
+   const char_t *uri);
+
+error_t coapServerRequestCallback(CoapServerContext *context,
+   CoapCode method, const char_t *uri);
+
+
+/**
+ * @brief Get monotonic time
+ * @return Current time, in nanoseconds
+ **/
+
+uint64_t benchGetTime(void)
+{
+   struct timespec ts;
+
+   //Read the monotonic clock
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+
+   //Convert the value to nanoseconds
+   return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+
+/**
+ * @brief Check whether a given benchmark is selected
+ * @param[in] bench Name of the benchmark
+ * @return TRUE if the benchmark is to be run, else FALSE
+ **/
+
+bool_t benchIsSelected(const char_t *bench)
+{
+   //Run all benchmarks when no filter is specified
+   return (benchFilter == NULL || strstr(bench, benchFilter) != NULL);
+}
+
+
+/**
+ * @brief Print a benchmark result
+ * @param[in] bench Name of the benchmark
+ * @param[in] param Name of the varied parameter
+ * @param[in] paramValue Value of the varied parameter
+ * @param[in] metric Name of the metric
+ * @param[in] value Measured value
+ * @param[in] unit Unit of the measured value
+ **/
+
+void benchReport(const char_t *bench, const char_t *param, uint_t paramValue,
+   const char_t *metric, double value, const char_t *unit)
+{
+   //Results are written on stdout, while debug messages go to stderr
+   printf("{\"tag\":\"%s\",\"bench\":\"%s\",\"param\":\"%s\","
+      "\"param_value\":%u,\"metric\":\"%s\",\"value\":%.3f,\"unit\":\"%s\"}\n",
+      benchTag, bench, param, paramValue, metric, value, unit);
+
+   //Flush the stream so that partial results survive a crash
+   fflush(stdout);
+}
+
+
+/**
+ * @brief Compare two latency samples
+ * @param[in] a Pointer to the first sample
+ * @param[in] b Pointer to the second sample
+ * @return Comparison result
+ **/
+
+int benchCompareSamples(const void *a, const void *b)
+{
+   uint64_t x;
+   uint64_t y;
+
+   //Retrieve sample values
+   x = *((const uint64_t *) a);
+   y = *((const uint64_t *) b);
+
+   //Compare sample values
+   return (x > y) - (x < y);
+}
+
+
+/**
+ * @brief Record a latency sample
+ * @param[in] duration Duration of the transaction, in nanoseconds
+ **/
+
+void benchAddSample(uint64_t duration)
+{
+   //Samples in excess are silently dropped
+   if(benchSampleCount < APP_MAX_SAMPLES)
+   {
+      benchSamples[benchSampleCount++] = duration;
+   }
+}
+
+
+/**
+ * @brief Print transaction rate and latency percentiles
+ * @param[in] bench Name of the benchmark
+ * @param[in] param Name of the varied parameter
+ * @param[in] paramValue Value of the varied parameter
+ * @param[in] count Number of completed transactions
+ * @param[in] elapsed Duration of the test, in nanoseconds
+ **/
+
+void benchReportLatency(const char_t *bench, const char_t *param,
+   uint_t paramValue, uint_t count, uint64_t elapsed)
+{
+   uint_t n;
+
+   //Report the transaction rate
+   benchReport(bench, param, paramValue, "rate",
+      elapsed ? count * 1e9 / elapsed : 0, "trans/s");
+
+   //Retrieve the number of recorded samples
+   n = benchSampleCount;
+
+   //Any sample available?
+   if(n > 0)
+   {
+      //Sort samples in ascending order
+      qsort(benchSamples, n, sizeof(uint64_t), benchCompareSamples);
+
+      //Report latency percentiles
+      benchReport(bench, param, paramValue, "latency_p50",
+         benchSamples[(n * 50) / 100] / 1e3, "us");
+      benchReport(bench, param, paramValue, "latency_p90",
+         benchSamples[(n * 90) / 100] / 1e3, "us");
+      benchReport(bench, param, paramValue, "latency_p99",
+         benchSamples[(n * 99) / 100] / 1e3, "us");
+      benchReport(bench, param, paramValue, "latency_max",
+         benchSamples[n - 1] / 1e3, "us");
+   }
+
+   //Reset samples
+   benchSampleCount = 0;
+}
+
+
+/**
+ * @brief Create a listening TCP socket
+ * @param[in] port Port number
+ * @param[in] bufferSize Size of the TX and RX buffers (0 for default)
+ * @return Handle referencing the socket
+ **/
+
+Socket *benchListen(uint16_t port, size_t bufferSize)
+{
+   error_t error;
+   Socket *socket;
+
+   //Open a TCP socket
+   socket = socketOpen(SOCKET_TYPE_STREAM, SOCKET_IP_PROTO_TCP);
+
+   //Valid socket handle?
+   if(socket != NULL)
+   {
+      //Start of exception handling block
+      do
+      {
+         //Set timeout
+         error = socketSetTimeout(socket, APP_SERVER_TIMEOUT);
+         //Any error to report?
+         if(error)
+            break;
+
+         //Custom buffer size?
+         if(bufferSize != 0)
+         {
+            //Accepted sockets inherit the buffer sizes of the listener
+            error = socketSetTxBufferSize(socket, bufferSize);
+            //Any error to report?
+            if(error)
+               break;
+
+            error = socketSetRxBufferSize(socket, bufferSize);
+            //Any error to report?
+            if(error)
+               break;
+         }
+
+         //Bind the socket to the relevant port number
+         error = socketBind(socket, &IP_ADDR_ANY, port);
+         //Any error to report?
+         if(error)
+            break;
+
+         //Place the socket in listening state
+         error = socketListen(socket, 0);
+         //Any error to report?
+         if(error)
+            break;
+
+         //End of exception handling block
+      } while(0);
+
+      //Any error to report?
+      if(error)
+      {
+         //Clean up side effects
+         socketClose(socket);
+         socket = NULL;
+      }
+   }
+
+   //Return socket handle
+   return socket;
+}
+
+
+/**
+ * @brief Open a TCP connection to the local server
+ * @param[in] port Port number
+ * @param[in] bufferSize Size of the TX and RX buffers (0 for default)
+ * @return Handle referencing the socket
+ **/
+
+Socket *benchConnect(uint16_t port, size_t bufferSize)
+{
+   error_t error;
+   Socket *socket;
+
+   //Open a TCP socket
+   socket = socketOpen(SOCKET_TYPE_STREAM, SOCKET_IP_PROTO_TCP);
+
+   //Valid socket handle?
+   if(socket != NULL)
+   {
+      //Start of exception handling block
+      do
+      {
+         //Set timeout
+         error = socketSetTimeout(socket, APP_SERVER_TIMEOUT);
+         //Any error to report?
+         if(error)
+            break;
+
+         //Custom buffer size?
+         if(bufferSize != 0)
+         {
+            //Set TX and RX buffer sizes
+            error = socketSetTxBufferSize(socket, bufferSize);
+            //Any error to report?
+            if(error)
+               break;
+
+            error = socketSetRxBufferSize(socket, bufferSize);
+            //Any error to report?
+            if(error)
+               break;
+         }
+
+         //Establish connection
+         error = socketConnect(socket, &benchServerIpAddr, port);
+         //Any error to report?
+         if(error)
+            break;
+
+         //End of exception handling block
+      } while(0);
+
+      //Any error to report?
+      if(error)
+      {
+         //Clean up side effects
+         socketClose(socket);
+         socket = NULL;
+      }
+   }
+
+   //Return socket handle
+   return socket;
+}
+
+
+/**
+ * @brief TCP bulk transfer sink task
+ * @param[in] param Pointer to the sink context
+ **/
+
+void benchTcpSinkTask(void *param)
+{
+   error_t error;
+   size_t n;
+   Socket *socket;
+   BenchTcpSink *sink;
+
+   //Point to the sink context
+   sink = (BenchTcpSink *) param;
+
+   //Accept the incoming connection
+   socket = socketAccept(sink->listener, NULL, NULL);
+
+   //Successful connection?
+   if(socket != NULL)
+   {
+      //Read data until the peer closes the connection
+      do
+      {
+         //Receive data
+         error = socketReceive(socket, benchRxBuffer, APP_BUFFER_SIZE, &n, 0);
+
+         //Count the number of bytes received
+         if(!error)
+         {
+            sink->received += n;
+         }
+      } while(!error);
+
+      //Close the connection
+      socketClose(socket);
+   }
+
+   //Notify the client
+   osSetEvent(&sink->doneEvent);
+   //Kill ourselves
+   osDeleteTask(OS_SELF_TASK_ID);
+}
+
+
+/**
+ * @brief TCP bulk throughput versus buffer size
+ **/
+
+void benchTcpBulk(void)
+{
+   error_t error;
+   uint_t i;
+   size_t n;
+   uint64_t t0;
+   uint64_t elapsed;
+   systime_t deadline;
+   Socket *socket;
+   BenchTcpSink sink;
+   OsTaskParameters taskParams;
+
+   //Loop through the buffer sizes to be tested
+   for(i = 0; i < arraysize(benchBufferSizes); i++)
+   {
+      //Initialize sink context
+      osMemset(&sink, 0, sizeof(BenchTcpSink));
+      osCreateEvent(&sink.doneEvent);
+
+      //Create the listening socket
+      sink.listener = benchListen(APP_TCP_BULK_PORT, benchBufferSizes[i]);
+
+      //Start the sink task
+      taskParams = OS_TASK_DEFAULT_PARAMS;
+      osCreateTask("TCP sink", benchTcpSinkTask, &sink, &taskParams);
+
+      //Connect to the sink
+      socket = benchConnect(APP_TCP_BULK_PORT, benchBufferSizes[i]);
+
+      //Successful connection?
+      if(socket != NULL)
+      {
+         //Start of the measurement
+         t0 = benchGetTime();
+         deadline = osGetSystemTime() + benchDuration;
+
+         //Send data until the test duration has elapsed
+         do
+         {
+            error = socketSend(socket, benchTxBuffer, APP_BUFFER_SIZE, &n, 0);
+         } while(!error && timeCompare(osGetSystemTime(), deadline) < 0);
+
+         //Gracefully close the connection
+         socketShutdown(socket, SOCKET_SD_BOTH);
+         //Wait for the sink to drain the connection
+         osWaitForEvent(&sink.doneEvent, APP_SERVER_TIMEOUT);
+
+         //End of the measurement
+         elapsed = benchGetTime() - t0;
+
+         //Report throughput
+         benchReport("tcp_bulk", "buffer_size", benchBufferSizes[i],
+            "throughput", sink.received * 8e3 / elapsed, "Mbit/s");
+
+         //Release the socket
+         socketClose(socket);
+      }
+      else
+      {
+         //Debug message
+         TRACE_ERROR("tcp_bulk: failed to connect!\r\n");
+         //Unblock the sink task
+         socketClose(sink.listener);
+         sink.listener = NULL;
+         osWaitForEvent(&sink.doneEvent, APP_SERVER_TIMEOUT);
+      }
+
+      //Release resources
+      socketClose(sink.listener);
+      osDeleteEvent(&sink.doneEvent);
+   }
+}
+
+
+/**
+ * @brief Accept-and-close server task
+ * @param[in] param Pointer to the listening socket
+ **/
+
+void benchTcpConnServerTask(void *param)
+{
+   error_t error;
+   size_t n;
+   Socket *listener;
+   Socket *socket;
+   uint8_t buffer[16];
+
+   //Point to the listening socket
+   listener = (Socket *) param;
+
+   //Process incoming connections
+   while(1)
+   {
+      //Accept an incoming connection
+      socket = socketAccept(listener, NULL, NULL);
+
+      //Successful connection?
+      if(socket != NULL)
+      {
+         //Wait for the client to close its side of the connection
+         do
+         {
+            error = socketReceive(socket, buffer, sizeof(buffer), &n, 0);
+         } while(!error);
+
+         //Close the connection
+         socketShutdown(socket, SOCKET_SD_BOTH);
+         socketClose(socket);
+      }
+   }
+}
+
+
+/**
+ * @brief TCP connection setup/teardown rate
+ **/
+
+void benchTcpConn(void)
+{
+   uint_t count;
+   uint64_t t0;
+   uint64_t t1;
+   systime_t deadline;
+   Socket *socket;
+
+   //Initialize variables
+   count = 0;
+
+   //Start of the measurement
+   t0 = benchGetTime();
+   deadline = osGetSystemTime() + benchDuration;
+
+   //Open and close connections until the test duration has elapsed
+   while(timeCompare(osGetSystemTime(), deadline) < 0)
+   {
+      //Start of the transaction
+      t1 = benchGetTime();
+
+      //Establish connection
+      socket = benchConnect(APP_TCP_CONN_PORT, 0);
+      //Failed to connect?
+      if(socket == NULL)
+         break;
+
+      //Gracefully close the connection
+      socketShutdown(socket, SOCKET_SD_BOTH);
+      socketClose(socket);
+
+      //Record the duration of the transaction
+      benchAddSample(benchGetTime() - t1);
+      count++;
+   }
+
+   //Report connection rate and latency
+   benchReportLatency("tcp_conn", "none", 0, count, benchGetTime() - t0);
+}
+
+
+/**
+ * @brief Echo server task
+ * @param[in] param Pointer to the listening socket
+ **/
+
+void benchTcpEchoServerTask(void *param)
+{
+   error_t error;
+   size_t n;
+   Socket *listener;
+   Socket *socket;
+   uint8_t buffer[APP_RR_MESSAGE_SIZE];
+
+   //Point to the listening socket
+   listener = (Socket *) param;
+
+   //Process incoming connections
+   while(1)
+   {
+      //Accept an incoming connection
+      socket = socketAccept(listener, NULL, NULL);
+
+      //Successful connection?
+      if(socket != NULL)
+      {
+         //Echo requests until the client closes the connection
+         do
+         {
+            //Wait for a complete request
+            error = socketReceive(socket, buffer, APP_RR_MESSAGE_SIZE, &n,
+               SOCKET_FLAG_WAIT_ALL);
+
+            //Check status code
+            if(!error)
+            {
+               //Send the response immediately
+               error = socketSend(socket, buffer, n, NULL,
+                  SOCKET_FLAG_NO_DELAY);
+            }
+         } while(!error);
+
+         //Close the connection
+         socketShutdown(socket, SOCKET_SD_BOTH);
+         socketClose(socket);
+      }
+   }
+}
+
+
+/**
+ * @brief TCP request/response latency
+ **/
+
+void benchTcpRr(void)
+{
+   error_t error;
+   uint_t count;
+   size_t n;
+   uint64_t t0;
+   uint64_t t1;
+   systime_t deadline;
+   Socket *socket;
+
+   //Initialize variables
+   count = 0;
+
+   //Establish connection
+   socket = benchConnect(APP_TCP_RR_PORT, 0);
+
+   //Successful connection?
+   if(socket != NULL)
+   {
+      //Start of the measurement
+      t0 = benchGetTime();
+      deadline = osGetSystemTime() + benchDuration;
+
+      //Exchange messages until the test duration has elapsed
+      while(timeCompare(osGetSystemTime(), deadline) < 0)
+      {
+         //Start of the transaction
+         t1 = benchGetTime();
+
+         //Send request
+         error = socketSend(socket, benchTxBuffer, APP_RR_MESSAGE_SIZE, NULL,
+            SOCKET_FLAG_NO_DELAY);
+         //Any error to report?
+         if(error)
+            break;
+
+         //Wait for the response
+         error = socketReceive(socket, benchRxBuffer, APP_RR_MESSAGE_SIZE,
+            &n, SOCKET_FLAG_WAIT_ALL);
+         //Any error to report?
+         if(error)
+            break;
+
+         //Record the duration of the transaction
+         benchAddSample(benchGetTime() - t1);
+         count++;
+      }
+
+      //Report transaction rate and latency
+      benchReportLatency("tcp_rr", "message_size", APP_RR_MESSAGE_SIZE, count,
+         benchGetTime() - t0);
+
+      //Gracefully close the connection
+      socketShutdown(socket, SOCKET_SD_BOTH);
+      socketClose(socket);
+   }
+   else
+   {
+      //Debug message
+      TRACE_ERROR("tcp_rr: failed to connect!\r\n");
+   }
+}
+
+
+/**
+ * @brief UDP sink task
+ * @param[in] param Pointer to the sink context
+ **/
+
+void benchUdpSinkTask(void *param)
+{
+   error_t error;
+   size_t n;
+   BenchUdpSink *sink;
+
+   //Point to the sink context
+   sink = (BenchUdpSink *) param;
+
+   //Count incoming datagrams until the client asks us to stop
+   while(!sink->stop)
+   {
+      //Receive datagram
+      error = socketReceive(sink->socket, benchRxBuffer, APP_BUFFER_SIZE,
+         &n, 0);
+
+      //Count the number of datagrams received
+      if(!error)
+      {
+         sink->received++;
+      }
+   }
+
+   //Notify the client
+   osSetEvent(&sink->doneEvent);
+   //Kill ourselves
+   osDeleteTask(OS_SELF_TASK_ID);
+}
+
+
+/**
+ * @brief UDP packet rate versus payload size
+ **/
+
+void benchUdp(void)
+{
+   error_t error;
+   uint_t i;
+   uint64_t sent;
+   uint64_t t0;
+   uint64_t elapsed;
+   systime_t deadline;
+   Socket *socket;
+   BenchUdpSink sink;
+   OsTaskParameters taskParams;
+
+   //Loop through the payload sizes to be tested
+   for(i = 0; i < arraysize(benchPayloadSizes); i++)
+   {
+      //Initialize sink context
+      osMemset(&sink, 0, sizeof(BenchUdpSink));
+      osCreateEvent(&sink.doneEvent);
+
+      //Open the receiving socket
+      sink.socket = socketOpen(SOCKET_TYPE_DGRAM, SOCKET_IP_PROTO_UDP);
+      //Open the sending socket
+      socket = socketOpen(SOCKET_TYPE_DGRAM, SOCKET_IP_PROTO_UDP);
+
+      //Failed to open sockets?
+      if(sink.socket == NULL || socket == NULL)
+      {
+         //Debug message
+         TRACE_ERROR("udp: failed to open sockets!\r\n");
+
+         //Clean up side effects
+         socketClose(sink.socket);
+         socketClose(socket);
+         osDeleteEvent(&sink.doneEvent);
+         break;
+      }
+
+      //Bind the receiving socket
+      socketBind(sink.socket, &IP_ADDR_ANY, APP_UDP_PORT);
+      //Poll the stop flag periodically
+      socketSetTimeout(sink.socket, 100);
+
+      //Start the sink task
+      taskParams = OS_TASK_DEFAULT_PARAMS;
+      osCreateTask("UDP sink", benchUdpSinkTask, &sink, &taskParams);
+
+      //Initialize variables
+      sent = 0;
+
+      //Start of the measurement
+      t0 = benchGetTime();
+      deadline = osGetSystemTime() + benchDuration;
+
+      //Send datagrams until the test duration has elapsed
+      while(timeCompare(osGetSystemTime(), deadline) < 0)
+      {
+         //Send datagram
+         error = socketSendTo(socket, &benchServerIpAddr, APP_UDP_PORT,
+            benchTxBuffer, benchPayloadSizes[i], NULL, 0);
+
+         //Count the number of datagrams sent
+         if(!error)
+         {
+            sent++;
+         }
+      }
+
+      //End of the measurement
+      elapsed = benchGetTime() - t0;
+
+      //Let the sink drain the receive queue
+      osDelayTask(100);
+      sink.stop = TRUE;
+      osWaitForEvent(&sink.doneEvent, APP_SERVER_TIMEOUT);
+
+      //Report transmit and receive rates
+      benchReport("udp", "payload_size", benchPayloadSizes[i], "tx_rate",
+         sent * 1e9 / elapsed, "pkt/s");
+      benchReport("udp", "payload_size", benchPayloadSizes[i], "rx_rate",
+         sink.received * 1e9 / elapsed, "pkt/s");
+
+      //Release resources
+      socketClose(sink.socket);
+      socketClose(socket);
+      osDeleteEvent(&sink.doneEvent);
+   }
+}
+
+
+/**
+ * @brief HTTP request callback
+ * @param[in] connection Handle referencing a client connection
+ * @param[in] uri NULL-terminated string containing the path to the requested resource
+ * @return Error code
+ **/
+
+error_t httpServerRequestCallback(HttpConnection *connection,
+   const char_t *uri)
+{
+   error_t error;
+
+   //Benchmark resource?
+   if(!osStrcmp(uri, "/bench"))
+   {
+      //Format HTTP response header
+      connection->response.version = connection->request.version;
+      connection->response.statusCode = 200;
+      connection->response.keepAlive = connection->request.keepAlive;
+      connection->response.noCache = TRUE;
+      connection->response.contentType = "application/octet-stream";
+      connection->response.contentLength = APP_HTTP_BODY_SIZE;
+
+      //Send response header
+      error = httpWriteHeader(connection);
+      //Any error to report?
+      if(error)
+         return error;
+
+      //Send response body
+      error = httpWriteStream(connection, benchTxBuffer, APP_HTTP_BODY_SIZE);
+      //Any error to report?
+      if(error)
+         return error;
+
+      //Properly close output stream
+      error = httpCloseStream(connection);
+   }
+   else
+   {
+      //Not implemented
+      error = ERROR_NOT_FOUND;
+   }
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief URI not found callback
+ * @param[in] connection Handle referencing a client connection
+ * @param[in] uri NULL-terminated string containing the path to the requested resource
+ * @return Error code
+ **/
+
+error_t httpServerUriNotFoundCallback(HttpConnection *connection,
+   const char_t *uri)
+{
+   //Not implemented
+   return ERROR_NOT_FOUND;
+}
+
+
+/**
+ * @brief Perform a single HTTP GET transaction
+ * @return Error code
+ **/
+
+error_t benchHttpGet(void)
+{
+   error_t error;
+   size_t n;
+
+   //The connection is closed when the server did not keep it alive
+   if(httpClientContext.state == HTTP_CLIENT_STATE_DISCONNECTED)
+   {
+      //Reconnect to the same HTTP server
+      error = httpClientConnect(&httpClientContext, NULL, 0);
+      //Any error to report?
+      if(error)
+         return error;
+   }
+
+   //Create a new HTTP request
+   error = httpClientCreateRequest(&httpClientContext);
+   //Any error to report?
+   if(error)
+      return error;
+
+   //Set request method and URI
+   error = httpClientSetMethod(&httpClientContext, "GET");
+   //Any error to report?
+   if(error)
+      return error;
+
+   error = httpClientSetUri(&httpClientContext, "/bench");
+   //Any error to report?
+   if(error)
+      return error;
+
+   //Set the hostname and port number of the resource being requested
+   error = httpClientSetHost(&httpClientContext, APP_IPV4_HOST_ADDR,
+      APP_HTTP_PORT);
+   //Any error to report?
+   if(error)
+      return error;
+
+   //Send HTTP request header
+   error = httpClientWriteHeader(&httpClientContext);
+   //Any error to report?
+   if(error)
+      return error;
+
+   //Receive HTTP response header
+   error = httpClientReadHeader(&httpClientContext);
+   //Any error to report?
+   if(error)
+      return error;
+
+   //Unexpected status code?
+   if(httpClientGetStatus(&httpClientContext) != 200)
+      return ERROR_UNEXPECTED_RESPONSE;
+
+   //Receive HTTP response body
+   do
+   {
+      error = httpClientReadBody(&httpClientContext, benchRxBuffer,
+         APP_BUFFER_SIZE, &n, 0);
+   } while(!error);
+
+   //The end of the response body has been reached?
+   if(error != ERROR_END_OF_STREAM)
+      return error;
+
+   //Close HTTP response body
+   return httpClientCloseBody(&httpClientContext);
+}
+
+
+/**
+ * @brief HTTP GET transactions over a persistent connection
+ **/
+
+void benchHttp(void)
+{
+   error_t error;
+   uint_t count;
+   uint64_t t0;
+   uint64_t t1;
+   systime_t deadline;
+
+   //Initialize variables
+   count = 0;
+
+   //Initialize HTTP client context
+   httpClientInit(&httpClientContext);
+
+   //Start of exception handling block
+   do
+   {
+      //Select HTTP/1.1 so that the connection is kept alive
+      error = httpClientSetVersion(&httpClientContext, HTTP_VERSION_1_1);
+      //Any error to report?
+      if(error)
+         break;
+
+      //Set timeout value for blocking operations
+      error = httpClientSetTimeout(&httpClientContext, APP_SERVER_TIMEOUT);
+      //Any error to report?
+      if(error)
+         break;
+
+      //Connect to the HTTP server
+      error = httpClientConnect(&httpClientContext, &benchServerIpAddr,
+         APP_HTTP_PORT);
+      //Any error to report?
+      if(error)
+         break;
+
+      //Start of the measurement
+      t0 = benchGetTime();
+      deadline = osGetSystemTime() + benchDuration;
+
+      //Issue requests until the test duration has elapsed
+      while(timeCompare(osGetSystemTime(), deadline) < 0)
+      {
+         //Start of the transaction
+         t1 = benchGetTime();
+
+         //Send request and receive response
+         error = benchHttpGet();
+
+         //The server silently closes persistent connections after a given
+         //number of requests
+         if(error == ERROR_END_OF_STREAM)
+         {
+            //Close the connection and retry the request
+            httpClientClose(&httpClientContext);
+            error = benchHttpGet();
+         }
+
+         //Any error to report?
+         if(error)
+            break;
+
+         //Record the duration of the transaction
+         benchAddSample(benchGetTime() - t1);
+         count++;
+      }
+
+      //Report transaction rate and latency
+      benchReportLatency("http_get", "body_size", APP_HTTP_BODY_SIZE, count,
+         benchGetTime() - t0);
+
+      //Gracefully disconnect from the HTTP server
+      httpClientDisconnect(&httpClientContext);
+
+      //End of exception handling block
+   } while(0);
+
+   //Any error to report?
+   if(error)
+   {
+      //Debug message
+      TRACE_ERROR("http_get: failed with error %d!\r\n", error);
+   }
+
+   //Release HTTP client context
+   httpClientDeinit(&httpClientContext);
+}
+
+
+/**
+ * @brief Minimal MQTT broker task
+ *
+ * The broker acknowledges CONNECT, PUBLISH (QoS 1) and PINGREQ packets
+ * without forwarding any message, which is enough to exercise the MQTT
+ * client end to end
+ *
+ * @param[in] param Pointer to the listening socket
+ **/
+
+void benchMqttBrokerTask(void *param)
+{
+   error_t error;
+   uint_t i;
+   uint_t type;
+   size_t n;
+   size_t length;
+   size_t topicLen;
+   Socket *listener;
+   Socket *socket;
+   uint8_t buffer[4];
+   uint8_t packet[APP_MQTT_MAX_PACKET_SIZE];
+
+   //Point to the listening socket
+   listener = (Socket *) param;
+
+   //Process incoming connections
+   while(1)
+   {
+      //Accept an incoming connection
+      socket = socketAccept(listener, NULL, NULL);
+
+      //Successful connection?
+      if(socket != NULL)
+      {
+         //Process incoming packets
+         do
+         {
+            //Read the first byte of the fixed header
+            error = socketReceive(socket, buffer, 1, &n, SOCKET_FLAG_WAIT_ALL);
+            //Any error to report?
+            if(error)
+               break;
+
+            //Retrieve packet type
+            type = buffer[0] >> 4;
+
+            //Decode the remaining length field
+            for(length = 0, i = 0; i < 4 && !error; i++)
+            {
+               //Read the next byte
+               error = socketReceive(socket, buffer + 1, 1, &n,
+                  SOCKET_FLAG_WAIT_ALL);
+
+               //Check status code
+               if(!error)
+               {
+                  //Update remaining length
+                  length |= (buffer[1] & 0x7F) << (7 * i);
+
+                  //Last byte of the remaining length field?
+                  if((buffer[1] & 0x80) == 0)
+                     break;
+               }
+            }
+
+            //Any error to report?
+            if(error || length > APP_MQTT_MAX_PACKET_SIZE)
+               break;
+
+            //Read the rest of the packet
+            if(length > 0)
+            {
+               error = socketReceive(socket, packet, length, &n,
+                  SOCKET_FLAG_WAIT_ALL);
+               //Any error to report?
+               if(error)
+                  break;
+            }
+
+            //Check packet type
+            if(type == MQTT_PACKET_TYPE_CONNECT)
+            {
+               //Send CONNACK packet
+               buffer[0] = MQTT_PACKET_TYPE_CONNACK << 4;
+               buffer[1] = 2;
+               buffer[2] = 0;
+               buffer[3] = MQTT_CONNECT_RET_CODE_ACCEPTED;
+
+               error = socketSend(socket, buffer, 4, NULL,
+                  SOCKET_FLAG_NO_DELAY);
+            }
+            else if(type == MQTT_PACKET_TYPE_PUBLISH)
+            {
+               //QoS 1 packets carry a packet identifier after the topic
+               if(((buffer[0] >> 1) & 0x03) == MQTT_QOS_LEVEL_1 && length >= 4)
+               {
+                  //Retrieve the length of the topic name
+                  topicLen = LOAD16BE(packet);
+
+                  //Malformed packet?
+                  if((topicLen + 4) > length)
+                     break;
+
+                  //Send PUBACK packet
+                  buffer[0] = MQTT_PACKET_TYPE_PUBACK << 4;
+                  buffer[1] = 2;
+                  buffer[2] = packet[topicLen + 2];
+                  buffer[3] = packet[topicLen + 3];
+
+                  error = socketSend(socket, buffer, 4, NULL,
+                     SOCKET_FLAG_NO_DELAY);
+               }
+            }
+            else if(type == MQTT_PACKET_TYPE_PINGREQ)
+            {
+               //Send PINGRESP packet
+               buffer[0] = MQTT_PACKET_TYPE_PINGRESP << 4;
+               buffer[1] = 0;
+
+               error = socketSend(socket, buffer, 2, NULL,
+                  SOCKET_FLAG_NO_DELAY);
+            }
+            else if(type == MQTT_PACKET_TYPE_DISCONNECT)
+            {
+               //The client is closing the connection
+               error = ERROR_END_OF_STREAM;
+            }
+            else
+            {
+               //Other packets are silently ignored
+            }
+         } while(!error);
+
+         //Close the connection
+         socketShutdown(socket, SOCKET_SD_BOTH);
+         socketClose(socket);
+      }
+   }
+}
+
+
+/**
+ * @brief MQTT QoS 1 publish transactions
+ **/
+
+void benchMqtt(void)
+{
+   error_t error;
+   uint_t count;
+   uint64_t t0;
+   uint64_t t1;
+   systime_t deadline;
+
+   //Initialize variables
+   count = 0;
+
+   //Initialize MQTT client context
+   mqttClientInit(&mqttClientContext);
+
+   //Start of exception handling block
+   do
+   {
+      //Set the MQTT version to be used
+      error = mqttClientSetVersion(&mqttClientContext,
+         MQTT_VERSION_3_1_1);
+      //Any error to report?
+      if(error)
+         break;
+
+      //Set communication timeout
+      error = mqttClientSetTimeout(&mqttClientContext, APP_SERVER_TIMEOUT);
+      //Any error to report?
+      if(error)
+         break;
+
+      //Set client identifier
+      error = mqttClientSetIdentifier(&mqttClientContext, APP_HOST_NAME);
+      //Any error to report?
+      if(error)
+         break;
+
+      //Establish connection with the MQTT server
+      error = mqttClientConnect(&mqttClientContext, &benchServerIpAddr,
+         APP_MQTT_PORT, TRUE);
+      //Any error to report?
+      if(error)
+         break;
+
+      //Start of the measurement
+      t0 = benchGetTime();
+      deadline = osGetSystemTime() + benchDuration;
+
+      //Publish messages until the test duration has elapsed
+      while(timeCompare(osGetSystemTime(), deadline) < 0)
+      {
+         //Start of the transaction
+         t1 = benchGetTime();
+
+         //Publish a message and wait for the PUBACK packet
+         error = mqttClientPublish(&mqttClientContext, "bench/topic",
+            benchTxBuffer, APP_MQTT_PAYLOAD_SIZE, MQTT_QOS_LEVEL_1, FALSE,
+            NULL);
+         //Any error to report?
+         if(error)
+            break;
+
+         //Record the duration of the transaction
+         benchAddSample(benchGetTime() - t1);
+         count++;
+      }
+
+      //Report transaction rate and latency
+      benchReportLatency("mqtt_publish", "payload_size", APP_MQTT_PAYLOAD_SIZE,
+         count, benchGetTime() - t0);
+
+      //Gracefully disconnect from the MQTT server
+      mqttClientDisconnect(&mqttClientContext);
+
+      //End of exception handling block
+   } while(0);
+
+   //Any error to report?
+   if(error)
+   {
+      //Debug message
+      TRACE_ERROR("mqtt_publish: failed with error %d!\r\n", error);
+   }
+
+   //Close the connection
+   mqttClientClose(&mqttClientContext);
+   //Release MQTT client context
+   mqttClientDeinit(&mqttClientContext);
+}
+
+
+/**
+ * @brief CoAP request callback
+ * @param[in] context Pointer to the CoAP server context
+ * @param[in] method CoAP method code
+ * @param[in] uri NULL-terminated string that contains the resource identifier
+ * @return Error code
+ **/
+
+error_t coapServerRequestCallback(CoapServerContext *context,
+   CoapCode method, const char_t *uri)
+{
+   error_t error;
+
+   //Benchmark resource?
+   if(method == COAP_CODE_GET && !osStrcmp(uri, "/bench"))
+   {
+      //Set response code
+      error = coapServerSetResponseCode(context, COAP_CODE_CONTENT);
+
+      //Check status code
+      if(!error)
+      {
+         //Set the payload of the response message
+         error = coapServerSetPayload(context, benchTxBuffer,
+            APP_COAP_PAYLOAD_SIZE);
+      }
+   }
+   else
+   {
+      //The requested resource does not exist
+      error = coapServerSetResponseCode(context, COAP_CODE_NOT_FOUND);
+   }
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief CoAP confirmable GET transactions
+ **/
+
+void benchCoap(void)
+{
+   error_t error;
+   uint_t count;
+   uint64_t t0;
+   uint64_t t1;
+   systime_t deadline;
+   CoapCode code;
+   CoapMessage *message;
+   CoapClientRequest *request;
+
+   //Initialize variables
+   count = 0;
+
+   //Initialize CoAP client context
+   coapClientInit(&coapClientContext);
+
+   //Start of exception handling block
+   do
+   {
+      //Use UDP as transport protocol
+      error = coapClientSetTransportProtocol(&coapClientContext,
+         COAP_TRANSPORT_PROTOCOL_UDP);
+      //Any error to report?
+      if(error)
+         break;
+
+      //Connect to the CoAP server
+      error = coapClientConnect(&coapClientContext, &benchServerIpAddr,
+         APP_COAP_PORT);
+      //Any error to report?
+      if(error)
+         break;
+
+      //Start of the measurement
+      t0 = benchGetTime();
+      deadline = osGetSystemTime() + benchDuration;
+
+      //Issue requests until the test duration has elapsed
+      while(timeCompare(osGetSystemTime(), deadline) < 0)
+      {
+         //Start of the transaction
+         t1 = benchGetTime();
+
+         //Create a new CoAP request
+         request = coapClientCreateRequest(&coapClientContext);
+         //Failed to create request?
+         if(request == NULL)
+         {
+            error = ERROR_OUT_OF_RESOURCES;
+            break;
+         }
+
+         //Format the request message
+         message = coapClientGetRequestMessage(request);
+         coapClientSetType(message, COAP_TYPE_CON);
+         coapClientSetMethodCode(message, COAP_CODE_GET);
+         coapClientSetUriPath(message, "/bench");
+
+         //Send the request and wait for the response
+         error = coapClientSendRequest(request, NULL, NULL);
+
+         //Check status code
+         if(!error)
+         {
+            //Retrieve the response code
+            message = coapClientGetResponseMessage(request);
+            error = coapClientGetResponseCode(message, &code);
+
+            //Unexpected response code?
+            if(!error && code != COAP_CODE_CONTENT)
+            {
+               error = ERROR_UNEXPECTED_RESPONSE;
+            }
+         }
+
+         //Release the request
+         coapClientDeleteRequest(request);
+
+         //Any error to report?
+         if(error)
+            break;
+
+         //Record the duration of the transaction
+         benchAddSample(benchGetTime() - t1);
+         count++;
+      }
+
+      //Report transaction rate and latency
+      benchReportLatency("coap_get", "payload_size", APP_COAP_PAYLOAD_SIZE,
+         count, benchGetTime() - t0);
+
+      //Disconnect from the CoAP server
+      coapClientDisconnect(&coapClientContext);
+
+      //End of exception handling block
+   } while(0);
+
+   //Any error to report?
+   if(error)
+   {
+      //Debug message
+      TRACE_ERROR("coap_get: failed with error %d!\r\n", error);
+   }
+
+   //Release CoAP client context
+   coapClientDeinit(&coapClientContext);
+}
+
+
+/**
+ * @brief Start the server side of the benchmarks
+ * @return Error code
+ **/
+
+error_t benchStartServers(void)
+{
+   error_t error;
+   Socket *socket;
+   OsTaskParameters taskParams;
+
+   //Default task parameters
+   taskParams = OS_TASK_DEFAULT_PARAMS;
+
+   //Start the accept-and-close server
+   socket = benchListen(APP_TCP_CONN_PORT, 0);
+   //Failed to create the listening socket?
+   if(socket == NULL)
+      return ERROR_OPEN_FAILED;
+
+   //Disable timeout on the listening socket
+   socketSetTimeout(socket, INFINITE_DELAY);
+   osCreateTask("TCP conn", benchTcpConnServerTask, socket, &taskParams);
+
+   //Start the echo server
+   socket = benchListen(APP_TCP_RR_PORT, 0);
+   //Failed to create the listening socket?
+   if(socket == NULL)
+      return ERROR_OPEN_FAILED;
+
+   //Disable timeout on the listening socket
+   socketSetTimeout(socket, INFINITE_DELAY);
+   osCreateTask("TCP echo", benchTcpEchoServerTask, socket, &taskParams);
+
+   //Start the MQTT broker
+   socket = benchListen(APP_MQTT_PORT, 0);
+   //Failed to create the listening socket?
+   if(socket == NULL)
+      return ERROR_OPEN_FAILED;
+
+   //Disable timeout on the listening socket
+   socketSetTimeout(socket, INFINITE_DELAY);
+   osCreateTask("MQTT broker", benchMqttBrokerTask, socket, &taskParams);
+
+   //Get default settings
+   httpServerGetDefaultSettings(&httpServerSettings);
+   //Bind HTTP server to the loopback interface
+   httpServerSettings.interface = benchInterface;
+   //Listen to a non-privileged port
+   httpServerSettings.port = APP_HTTP_PORT;
+   //Client connections
+   httpServerSettings.maxConnections = APP_HTTP_MAX_CONNECTIONS;
+   httpServerSettings.connections = httpConnections;
+   //Specify the server's root directory
+   osStrcpy(httpServerSettings.rootDirectory, "/");
+   //Callback functions
+   httpServerSettings.requestCallback = httpServerRequestCallback;
+   httpServerSettings.uriNotFoundCallback = httpServerUriNotFoundCallback;
+
+   //HTTP server initialization
+   error = httpServerInit(&httpServerContext, &httpServerSettings);
+   //Any error to report?
+   if(error)
+      return error;
+
+   //Start HTTP server
+   error = httpServerStart(&httpServerContext);
+   //Any error to report?
+   if(error)
+      return error;
+
+   //Get default settings
+   coapServerGetDefaultSettings(&coapServerSettings);
+   //Bind CoAP server to the loopback interface
+   coapServerSettings.interface = benchInterface;
+   //Listen to port 5683
+   coapServerSettings.port = APP_COAP_PORT;
+   //Callback function
+   coapServerSettings.requestCallback = coapServerRequestCallback;
+
+   //CoAP server initialization
+   error = coapServerInit(&coapServerContext, &coapServerSettings);
+   //Any error to report?
+   if(error)
+      return error;
+
+   //Start CoAP server
+   error = coapServerStart(&coapServerContext);
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Main entry point
+ * @param[in] argc Number of command line arguments
+ * @param[in] argv Command line arguments
+ * @return Exit status
+ **/
+
+int_t main(int_t argc, char_t *argv[])
+{
+   error_t error;
+   int_t opt;
+   uint_t i;
+   Ipv4Addr ipv4Addr;
+   uint8_t seed[32];
+
+   //Parse command line options
+   while((opt = getopt(argc, argv, "d:t:b:")) != -1)
+   {
+      //Check option
+      if(opt == 'd')
+      {
+         //Duration of each test, in milliseconds
+         benchDuration = strtoul(optarg, NULL, 10);
+      }
+      else if(opt == 't')
+      {
+         //Tag identifying the run (e.g. commit hash)
+         benchTag = optarg;
+      }
+      else if(opt == 'b')
+      {
+         //Run only the benchmarks whose name contains the specified string
+         benchFilter = optarg;
+      }
+      else
+      {
+         //Print usage
+         fprintf(stderr, "Usage: %s [-d duration_ms] [-t tag] [-b bench]\n",
+            argv[0]);
+
+         //Invalid command line
+         return EXIT_FAILURE;
+      }
+   }
+
+   //Initialize kernel
+   osInitKernel();
+
+   //Generate a random seed
+   for(i = 0; i < sizeof(seed); i++)
+   {
+      seed[i] = rand() ^ (uint8_t) benchGetTime();
+   }
+
+   //Fill the transmit buffer with a recognizable pattern
+   for(i = 0; i < APP_BUFFER_SIZE; i++)
+   {
+      benchTxBuffer[i] = (uint8_t) i;
+   }
+
+   //TCP/IP stack initialization
+   error = netInit();
+   //Any error to report?
+   if(error)
+   {
+      //Debug message
+      TRACE_ERROR("Failed to initialize TCP/IP stack!\r\n");
+      return EXIT_FAILURE;
+   }
+
+   //Seed the pseudo-random number generator
+   netSeedRand(seed, sizeof(seed));
+
+   //Configure the loopback interface
+   benchInterface = &netInterface[0];
+
+   //Set interface name
+   netSetInterfaceName(benchInterface, APP_IF_NAME);
+   //Set host name
+   netSetHostname(benchInterface, APP_HOST_NAME);
+   //Select the relevant network adapter
+   netSetDriver(benchInterface, &loopbackDriver);
+
+   //Initialize network interface
+   error = netConfigInterface(benchInterface);
+   //Any error to report?
+   if(error)
+   {
+      //Debug message
+      TRACE_ERROR("Failed to configure interface %s!\r\n",
+         benchInterface->name);
+      return EXIT_FAILURE;
+   }
+
+   //Set IPv4 host address
+   ipv4StringToAddr(APP_IPV4_HOST_ADDR, &ipv4Addr);
+   ipv4SetHostAddr(benchInterface, ipv4Addr);
+
+   //Set subnet mask
+   ipv4StringToAddr(APP_IPV4_SUBNET_MASK, &ipv4Addr);
+   ipv4SetSubnetMask(benchInterface, ipv4Addr);
+
+   //All the traffic is sent to the local host
+   ipStringToAddr(APP_IPV4_HOST_ADDR, &benchServerIpAddr);
+
+   //Wait for the link to come up
+   osDelayTask(100);
+
+   //Start the server side of the benchmarks
+   error = benchStartServers();
+   //Any error to report?
+   if(error)
+   {
+      //Debug message
+      TRACE_ERROR("Failed to start servers!\r\n");
+      return EXIT_FAILURE;
+   }
+
+   //TCP bulk throughput versus buffer size
+   if(benchIsSelected("tcp_bulk"))
+      benchTcpBulk();
+
+   //TCP connection setup/teardown rate
+   if(benchIsSelected("tcp_conn"))
+      benchTcpConn();
+
+   //TCP request/response latency
+   if(benchIsSelected("tcp_rr"))
+      benchTcpRr();
+
+   //UDP packet rate versus payload size
+   if(benchIsSelected("udp"))
+      benchUdp();
+
+   //HTTP transactions
+   if(benchIsSelected("http_get"))
+      benchHttp();
+
+   //MQTT transactions
+   if(benchIsSelected("mqtt_publish"))
+      benchMqtt();
+
+   //CoAP transactions
+   if(benchIsSelected("coap_get"))
+      benchCoap();
+
+   //Successful processing
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,157 @@
+/**
+ * @file net_config.h
+ * @brief CycloneTCP configuration file
+ *
+ * @section License
+ *
+ * Copyright (C) 2010-2023 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneTCP Eval.
+ *
+ * This software is provided in source form for a short-term evaluation only. The
+ * evaluation license expires 90 days after the date you first download the software.
+ *
+ * If you plan to use this software in a commercial product, you are required to
+ * purchase a commercial license from Oryx Embedded SARL.
+ *
+ * After the 90-day evaluation period, you agree to either purchase a commercial
+ * license or delete all copies of this software. If you wish to extend the
+ * evaluation period, you must contact sales@oryx-embedded.com.
+ *
+ * This evaluation software is provided "as is" without warranty of any kind.
+ * Technical support is available as an option during the evaluation period.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.3.2
+ **/
+
+
+#ifndef _NET_CONFIG_H
+#define _NET_CONFIG_H
+
+//Trace level for TCP/IP stack debugging
+#define MEM_TRACE_LEVEL          4
+#define NIC_TRACE_LEVEL          2
+#define ETH_TRACE_LEVEL          2
+#define ARP_TRACE_LEVEL          2
+#define IP_TRACE_LEVEL           2
+#define IPV4_TRACE_LEVEL         2
+#define IPV6_TRACE_LEVEL         2
+#define ICMP_TRACE_LEVEL         2
+#define IGMP_TRACE_LEVEL         2
+#define ICMPV6_TRACE_LEVEL       2
+#define MLD_TRACE_LEVEL          2
+#define NDP_TRACE_LEVEL          2
+#define UDP_TRACE_LEVEL          2
+#define TCP_TRACE_LEVEL          2
+#define SOCKET_TRACE_LEVEL       2
+#define RAW_SOCKET_TRACE_LEVEL   2
+#define BSD_SOCKET_TRACE_LEVEL   2
+#define WEB_SOCKET_TRACE_LEVEL   2
+#define AUTO_IP_TRACE_LEVEL      2
+#define SLAAC_TRACE_LEVEL        2
+#define DHCP_TRACE_LEVEL         2
+#define DHCPV6_TRACE_LEVEL       2
+#define DNS_TRACE_LEVEL          2
+#define MDNS_TRACE_LEVEL         2
+#define NBNS_TRACE_LEVEL         2
+#define LLMNR_TRACE_LEVEL        2
+#define COAP_TRACE_LEVEL         2
+#define FTP_TRACE_LEVEL          2
+#define HTTP_TRACE_LEVEL         2
+#define MQTT_TRACE_LEVEL         2
+#define MQTT_SN_TRACE_LEVEL      2
+#define SMTP_TRACE_LEVEL         2
+#define SNMP_TRACE_LEVEL         2
+#define SNTP_TRACE_LEVEL         2
+#define TFTP_TRACE_LEVEL         2
+#define MODBUS_TRACE_LEVEL       2
+
+//Number of network adapters
+#define NET_INTERFACE_COUNT 1
+
+//Size of the MAC address filter
+#define MAC_ADDR_FILTER_SIZE 12
+
+//Loopback interface support
+#define NET_LOOPBACK_IF_SUPPORT ENABLED
+//Depth of the loopback interface queue
+#define LOOPBACK_DRIVER_QUEUE_SIZE 64
+
+//IPv4 support
+#define IPV4_SUPPORT ENABLED
+//Size of the IPv4 multicast filter
+#define IPV4_MULTICAST_FILTER_SIZE 4
+
+//IPv4 fragmentation support
+#define IPV4_FRAG_SUPPORT ENABLED
+//Maximum number of fragmented packets the host will accept
+//and hold in the reassembly queue simultaneously
+#define IPV4_MAX_FRAG_DATAGRAMS 4
+//Maximum datagram size the host will accept when reassembling fragments
+#define IPV4_MAX_FRAG_DATAGRAM_SIZE 8192
+
+//IGMP support
+#define IGMP_SUPPORT DISABLED
+
+//IPv6 support
+#define IPV6_SUPPORT DISABLED
+
+//TCP support
+#define TCP_SUPPORT ENABLED
+//Default buffer size for transmission
+#define TCP_DEFAULT_TX_BUFFER_SIZE (1430*6)
+//Default buffer size for reception
+#define TCP_DEFAULT_RX_BUFFER_SIZE (1430*6)
+//Default SYN queue size for listening sockets
+#define TCP_DEFAULT_SYN_QUEUE_SIZE 16
+//Maximum number of retransmissions
+#define TCP_MAX_RETRIES 5
+//Selective acknowledgment support
+#define TCP_SACK_SUPPORT ENABLED
+//TCP keep-alive support
+#define TCP_KEEP_ALIVE_SUPPORT DISABLED
+//Secure initial sequence number generation (relies on MD5)
+#define TCP_SECURE_ISN_SUPPORT DISABLED
+//SYN cookies (relies on MD5)
+#define TCP_SYN_COOKIE_SUPPORT DISABLED
+
+//UDP support
+#define UDP_SUPPORT ENABLED
+//Receive queue depth for connectionless sockets
+#define UDP_RX_QUEUE_SIZE 16
+
+//Raw socket support
+#define RAW_SOCKET_SUPPORT DISABLED
+
+//BSD socket layer is not used (conflicts with the host C library)
+#define BSD_SOCKET_SUPPORT DISABLED
+
+//Number of sockets that can be opened simultaneously
+#define SOCKET_MAX_COUNT 32
+
+//HTTP client support
+#define HTTP_CLIENT_SUPPORT ENABLED
+#define HTTP_CLIENT_TLS_SUPPORT DISABLED
+#define HTTP_CLIENT_BASIC_AUTH_SUPPORT DISABLED
+#define HTTP_CLIENT_DIGEST_AUTH_SUPPORT DISABLED
+
+//HTTP server support
+#define HTTP_SERVER_SUPPORT ENABLED
+#define HTTP_SERVER_FS_SUPPORT ENABLED
+#define HTTP_SERVER_MAX_CONNECTIONS 2
+
+//MQTT client support
+#define MQTT_CLIENT_SUPPORT ENABLED
+#define MQTT_CLIENT_TLS_SUPPORT DISABLED
+#define MQTT_CLIENT_WS_SUPPORT DISABLED
+
+//CoAP client support
+#define COAP_CLIENT_SUPPORT ENABLED
+#define COAP_CLIENT_DTLS_SUPPORT DISABLED
+
+//CoAP server support
+#define COAP_SERVER_SUPPORT ENABLED
+#define COAP_SERVER_DTLS_SUPPORT DISABLED
+
+#endif